@@ -76,7 +76,14 @@ extern uint32_t SystemCoreClock;
 /* Memory allocation related definitions. */
 #define configSUPPORT_STATIC_ALLOCATION         1
 #define configSUPPORT_DYNAMIC_ALLOCATION        1
+#if defined(PASCO2_STATIC_ALLOCATION) && (PASCO2_STATIC_ALLOCATION != 0)
+/* The application places its kernel objects in static memory. The heap only
+ * holds the objects the libraries create, such as the retarget-io mutex, and
+ * is itself a static array that shows up in the linker map. */
+#define configTOTAL_HEAP_SIZE                   ( ( size_t ) 1024 )
+#else
 #define configTOTAL_HEAP_SIZE                   ( ( size_t ) ( CY_SRAM_SIZE - (64 * 1024)))
+#endif
 #define configAPPLICATION_ALLOCATED_HEAP        0
 
 /* Hook function related definitions. */
@@ -172,7 +179,7 @@ to exclude the API function. */
 #define INCLUDE_vTaskDelay                      1
 #define INCLUDE_xTaskGetSchedulerState          1
 #define INCLUDE_xTaskGetCurrentTaskHandle       1
-#define INCLUDE_uxTaskGetStackHighWaterMark     0
+#define INCLUDE_uxTaskGetStackHighWaterMark     1
 #define INCLUDE_xTaskGetIdleTaskHandle          0
 #define INCLUDE_eTaskGetState                   0
 #define INCLUDE_xEventGroupSetBitFromISR        1
@@ -203,7 +210,11 @@ standard names - or at least those used in the unmodified vector table. */
 #define HEAP_ALLOCATION_TYPE5                   (5)     /* heap_5.c*/
 #define NO_HEAP_ALLOCATION                      (0)
 
+#if defined(PASCO2_STATIC_ALLOCATION) && (PASCO2_STATIC_ALLOCATION != 0)
+#define configHEAP_ALLOCATION_SCHEME            (HEAP_ALLOCATION_TYPE4)
+#else
 #define configHEAP_ALLOCATION_SCHEME            (HEAP_ALLOCATION_TYPE3)
+#endif
 
 /* Check if the ModusToolbox Device Configurator Power personality parameter
  * "System Idle Power Mode" is set to either "CPU Sleep" or "System Deep Sleep".
@@ -48,6 +48,9 @@
 #include "cyhal.h"
 
 /* Header file for local task */
+#include "pasco2_board.h"
+#include "pasco2_console.h"
+#include "pasco2_rtos.h"
 #include "pasco2_task.h"
 
 /*******************************************************************************
@@ -73,6 +76,9 @@ static void isr_timer(void *callback_arg, cyhal_timer_event_t event);
 /* Timer object used for blinking the LED */
 cyhal_timer_t led_blink_timer;
 
+/* PAS CO2 sensor task */
+PASCO2_RTOS_THREAD_DEFINE(pasco2_thread, PASCO2_TASK_STACK_SIZE);
+
 /*******************************************************************************
  * Function Name: main
  ********************************************************************************
@@ -110,6 +116,13 @@ int main(void)
         CY_ASSERT(0);
     }
 
+    /* Send the console output from a ring buffer instead of waiting for the UART */
+    result = pasco2_console_init(&cy_retarget_io_uart_obj);
+    if (result != CY_RSLT_SUCCESS)
+    {
+        CY_ASSERT(0);
+    }
+
     /* \x1b[2J\x1b[;H - ANSI ESC sequence for clear screen */
     printf("\x1b[2J\x1b[;H");
 
@@ -123,14 +136,9 @@ int main(void)
     printf("https://github.com/Infineon/"
             "Code-Examples-for-ModusToolbox-Software\r\n\r\n");
 
-#if defined(CYSBSYSKIT_DEV_01)
-    /* Initialize the User LED */
-    result = cyhal_gpio_init(CYBSP_USER_LED, CYHAL_GPIO_DIR_OUTPUT,
-                             CYHAL_GPIO_DRIVE_STRONG, CYBSP_LED_STATE_OFF);
-#else
-    result = cyhal_gpio_init(CYBSP_USER_LED2, CYHAL_GPIO_DIR_OUTPUT,
-                             CYHAL_GPIO_DRIVE_STRONG, CYBSP_LED_STATE_OFF);
-#endif
+    /* Initialize the status LED */
+    result = cyhal_gpio_init(PASCO2_BOARD_LED_STATUS, CYHAL_GPIO_DIR_OUTPUT,
+                             CYHAL_GPIO_DRIVE_STRONG, PASCO2_BOARD_LED_STATUS_OFF);
     if (result != CY_RSLT_SUCCESS)
     {
         CY_ASSERT(0);
@@ -140,14 +148,11 @@ int main(void)
     timer_init();
 
     /* Create PAS CO2 task */
-    cy_thread_t ifx_pasco2_task;
-    result = cy_rtos_create_thread(&ifx_pasco2_task,
-                                   pasco2_task,
-                                   PASCO2_TASK_NAME,
-                                   NULL,
-                                   PASCO2_TASK_STACK_SIZE,
-                                   PASCO2_TASK_PRIORITY,
-                                   (cy_thread_arg_t)NULL);
+    result = pasco2_rtos_create_thread(&pasco2_thread,
+                                       pasco2_task,
+                                       PASCO2_TASK_NAME,
+                                       PASCO2_TASK_PRIORITY,
+                                       (cy_thread_arg_t)NULL);
     if (result != CY_RSLT_SUCCESS)
     {
         CY_ASSERT(0);
@@ -244,12 +249,8 @@ static void isr_timer(void *callback_arg, cyhal_timer_event_t event)
     (void) callback_arg;
     (void) event;
 
-    /* Invert the USER LED state */
-#if defined(CYSBSYSKIT_DEV_01)
-     cyhal_gpio_toggle(CYBSP_USER_LED);
-#else
-     cyhal_gpio_toggle(CYBSP_USER_LED2);
-#endif
+    /* Invert the status LED state */
+    cyhal_gpio_toggle(PASCO2_BOARD_LED_STATUS);
 }
 
 /* [] END OF FILE */
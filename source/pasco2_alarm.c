@@ -0,0 +1,261 @@
+/*****************************************************************************
+** File name: pasco2_alarm.c
+**
+** Description: This file contains the CO2 alarm levels. A sensor node
+**   changes its level only after the CO2 has crossed a threshold, or fallen
+**   below it by the hysteresis, for the dwell time, and notifies its
+**   subscribers of the change.
+**
+** ===========================================================================
+** Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+** ===========================================================================
+**
+** ===========================================================================
+** Infineon Technologies AG (INFINEON) is supplying this file for use
+** exclusively with Infineon's sensor products. This file can be freely
+** distributed within development tools and software supporting such
+** products.
+**
+** THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+** OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+** MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+** INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+** WHATSOEVER.
+** ===========================================================================
+*/
+
+/* Header file includes */
+#include "cy_pdl.h"
+
+/* Header file for local module */
+#include "pasco2_alarm.h"
+
+/*******************************************************************************
+ * Function Name: pasco2_alarm_default_config
+ *******************************************************************************
+ * Summary:
+ *   Returns the default thresholds: one level above
+ *   PASCO2_ALARM_THRESHOLD_PPM.
+ *
+ * Parameters:
+ *   config: thresholds to fill
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+void pasco2_alarm_default_config(pasco2_alarm_config_t *config)
+{
+    *config = (pasco2_alarm_config_t)
+    {
+        .thresholds = { PASCO2_ALARM_THRESHOLD_PPM },
+        .count = 1U,
+        .hysteresis_ppm = PASCO2_ALARM_HYSTERESIS_PPM,
+        .dwell_s = PASCO2_ALARM_DWELL_S
+    };
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_alarm_config_valid
+ *******************************************************************************
+ * Summary:
+ *   Checks that the thresholds ascend by more than the hysteresis, so that
+ *   every level can be left downwards.
+ *
+ * Parameters:
+ *   config: thresholds to check
+ *
+ * Return:
+ *   true if the thresholds can be used
+ ******************************************************************************/
+bool pasco2_alarm_config_valid(const pasco2_alarm_config_t *config)
+{
+    if (config->count > PASCO2_ALARM_MAX_LEVELS)
+    {
+        return false;
+    }
+
+    uint32_t lowest = config->hysteresis_ppm;
+    for (uint8_t i = 0U; i < config->count; i++)
+    {
+        if (config->thresholds[i] <= lowest)
+        {
+            return false;
+        }
+        lowest = (uint32_t)config->thresholds[i] + config->hysteresis_ppm;
+    }
+
+    return true;
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_alarm_init
+ *******************************************************************************
+ * Summary:
+ *   Initializes the alarm of a sensor node without subscribers. The first
+ *   value sets the level without waiting for the dwell time.
+ *
+ * Parameters:
+ *   alarm: alarm object
+ *   sensor: index of the sensor node
+ *   config: thresholds, must be valid
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+void pasco2_alarm_init(pasco2_alarm_t *alarm, uint8_t sensor, const pasco2_alarm_config_t *config)
+{
+    *alarm = (pasco2_alarm_t) { .sensor = sensor };
+    pasco2_alarm_set_config(alarm, config);
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_alarm_set_config
+ *******************************************************************************
+ * Summary:
+ *   Replaces the thresholds. The level is unknown until the next value, which
+ *   sets it without waiting for the dwell time. Subscribers and counters are
+ *   kept.
+ *
+ * Parameters:
+ *   alarm: alarm object
+ *   config: thresholds, must be valid
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+void pasco2_alarm_set_config(pasco2_alarm_t *alarm, const pasco2_alarm_config_t *config)
+{
+    CY_ASSERT(pasco2_alarm_config_valid(config));
+
+    alarm->config = *config;
+    alarm->level = PASCO2_ALARM_LEVEL_UNKNOWN;
+    alarm->pending = PASCO2_ALARM_LEVEL_UNKNOWN;
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_alarm_subscribe
+ *******************************************************************************
+ * Summary:
+ *   Adds a callback that is executed on every level change.
+ *
+ * Parameters:
+ *   alarm: alarm object
+ *   callback: function to call
+ *   callback_arg: first argument of the callback
+ *
+ * Return:
+ *   false if PASCO2_ALARM_MAX_SUBSCRIBERS callbacks are already registered
+ ******************************************************************************/
+bool pasco2_alarm_subscribe(pasco2_alarm_t *alarm, pasco2_alarm_callback_t callback, void *callback_arg)
+{
+    if (alarm->subscriber_count >= PASCO2_ALARM_MAX_SUBSCRIBERS)
+    {
+        return false;
+    }
+
+    alarm->subscribers[alarm->subscriber_count].callback = callback;
+    alarm->subscribers[alarm->subscriber_count].callback_arg = callback_arg;
+    alarm->subscriber_count++;
+    return true;
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_alarm_target
+ *******************************************************************************
+ * Summary:
+ *   Returns the level a value points to from the current level: up past
+ *   every threshold below the value, down past every threshold the value is
+ *   below by the hysteresis. Takes at most one step per threshold.
+ *
+ * Parameters:
+ *   alarm: alarm object
+ *   ppm: CO2 value
+ *
+ * Return:
+ *   level
+ ******************************************************************************/
+static uint8_t pasco2_alarm_target(const pasco2_alarm_t *alarm, uint16_t ppm)
+{
+    const pasco2_alarm_config_t *config = &alarm->config;
+    uint8_t level = (alarm->level == PASCO2_ALARM_LEVEL_UNKNOWN) ? 0U : alarm->level;
+
+    while ((level < config->count) && (ppm > config->thresholds[level]))
+    {
+        level++;
+    }
+    while ((level > 0U) && (((uint32_t)ppm + config->hysteresis_ppm) <= config->thresholds[level - 1U]))
+    {
+        level--;
+    }
+
+    return level;
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_alarm_update
+ *******************************************************************************
+ * Summary:
+ *   Evaluates a CO2 value. The level changes once the values have pointed
+ *   away from it in the same direction for the dwell time, and the
+ *   subscribers are notified. Nothing else happens while the level stays.
+ *
+ * Parameters:
+ *   alarm: alarm object
+ *   tick: time of the value in ms
+ *   ppm: CO2 value
+ *
+ * Return:
+ *   true if the level changed
+ ******************************************************************************/
+bool pasco2_alarm_update(pasco2_alarm_t *alarm, uint32_t tick, uint16_t ppm)
+{
+    uint8_t previous = alarm->level;
+    uint8_t target = pasco2_alarm_target(alarm, ppm);
+
+    alarm->stats.values++;
+    if (target == previous)
+    {
+        if (alarm->pending != previous)
+        {
+            alarm->stats.suppressed++;
+            alarm->pending = previous;
+        }
+        return false;
+    }
+
+    if (previous != PASCO2_ALARM_LEVEL_UNKNOWN)
+    {
+        /* A change of direction starts the dwell time over */
+        if ((alarm->pending == previous) || ((alarm->pending > previous) != (target > previous)))
+        {
+            alarm->pending_tick = tick;
+        }
+        alarm->pending = target;
+        if ((tick - alarm->pending_tick) < ((uint32_t)alarm->config.dwell_s * 1000U))
+        {
+            return false;
+        }
+
+        if (target > previous)
+        {
+            alarm->stats.raises++;
+        }
+        else
+        {
+            alarm->stats.clears++;
+        }
+    }
+
+    alarm->level = target;
+    alarm->pending = target;
+    alarm->stats.level_tick = tick;
+    for (uint8_t i = 0U; i < alarm->subscriber_count; i++)
+    {
+        alarm->subscribers[i].callback(alarm->subscribers[i].callback_arg, alarm, previous, ppm);
+    }
+
+    return true;
+}
+
+/* [] END OF FILE */
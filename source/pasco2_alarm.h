@@ -0,0 +1,119 @@
+/******************************************************************************
+** File name: pasco2_alarm.h
+**
+** Description: This file contains the types and function prototypes of the
+**   CO2 alarm levels.
+**
+** ===========================================================================
+** Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+** ===========================================================================
+**
+** ===========================================================================
+** Infineon Technologies AG (INFINEON) is supplying this file for use
+** exclusively with Infineon's sensor products. This file can be freely
+** distributed within development tools and software supporting such
+** products.
+**
+** THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+** OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+** MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+** INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+** WHATSOEVER.
+** ===========================================================================
+*/
+
+#pragma once
+
+/* Header file includes */
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "cy_result.h"
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+/* Highest number of thresholds, a sensor node is at one of up to
+ * PASCO2_ALARM_MAX_LEVELS + 1 levels */
+#define PASCO2_ALARM_MAX_LEVELS (4U)
+
+/* Default threshold in ppm: above it the CO2 is high */
+#define PASCO2_ALARM_THRESHOLD_PPM (1000U)
+
+/* Default distance below a threshold in ppm that the CO2 must fall to leave
+ * the level above it */
+#define PASCO2_ALARM_HYSTERESIS_PPM (50U)
+
+/* Default time in seconds a new level must hold before it is entered. The
+ * time counts from the first value at the new level, a value back at the
+ * current level starts it over. */
+#define PASCO2_ALARM_DWELL_S (30U)
+
+/* Subscribers notified of the level changes of a sensor node */
+#define PASCO2_ALARM_MAX_SUBSCRIBERS (2U)
+
+/* Level of a sensor node before its first value */
+#define PASCO2_ALARM_LEVEL_UNKNOWN (0xFFU)
+
+/* Result codes */
+#define PASCO2_ALARM_RSLT_ERR_CONFIG \
+    CY_RSLT_CREATE(CY_RSLT_TYPE_ERROR, CY_RSLT_MODULE_MIDDLEWARE_BASE, 0x151U)
+
+/*******************************************************************************
+ * Types
+ ******************************************************************************/
+/* Thresholds of the levels */
+typedef struct
+{
+    uint16_t thresholds[PASCO2_ALARM_MAX_LEVELS]; /* Ascending, in ppm */
+    uint8_t count;              /* Thresholds in use, 0 turns the alarm off */
+    uint16_t hysteresis_ppm;
+    uint16_t dwell_s;
+} pasco2_alarm_config_t;
+
+/* Alarm counters */
+typedef struct
+{
+    uint32_t values;            /* CO2 values evaluated */
+    uint32_t raises;            /* Changes to a higher level */
+    uint32_t clears;            /* Changes to a lower level */
+    uint32_t suppressed;        /* Level changes that did not hold for the dwell time */
+    uint32_t level_tick;        /* Time of the last level change in ms */
+} pasco2_alarm_stats_t;
+
+struct pasco2_alarm;
+
+/* Level change callback, executed in the context of the caller of
+ * pasco2_alarm_update. The alarm holds the new level. */
+typedef void (*pasco2_alarm_callback_t)(void *callback_arg, const struct pasco2_alarm *alarm, uint8_t previous,
+                                        uint16_t ppm);
+
+/* Alarm object of a sensor node */
+typedef struct pasco2_alarm
+{
+    pasco2_alarm_config_t config;
+    uint8_t sensor;             /* Index of the sensor node */
+    uint8_t level;              /* Number of thresholds exceeded, PASCO2_ALARM_LEVEL_UNKNOWN before the first value */
+    uint8_t pending;            /* Level the values point to, equal to level if none */
+    uint32_t pending_tick;      /* First value towards the pending level in ms */
+    struct
+    {
+        pasco2_alarm_callback_t callback;
+        void *callback_arg;
+    } subscribers[PASCO2_ALARM_MAX_SUBSCRIBERS];
+    uint8_t subscriber_count;
+    pasco2_alarm_stats_t stats;
+} pasco2_alarm_t;
+
+/*******************************************************************************
+ * Functions
+ ******************************************************************************/
+void pasco2_alarm_default_config(pasco2_alarm_config_t *config);
+bool pasco2_alarm_config_valid(const pasco2_alarm_config_t *config);
+void pasco2_alarm_init(pasco2_alarm_t *alarm, uint8_t sensor, const pasco2_alarm_config_t *config);
+void pasco2_alarm_set_config(pasco2_alarm_t *alarm, const pasco2_alarm_config_t *config);
+bool pasco2_alarm_subscribe(pasco2_alarm_t *alarm, pasco2_alarm_callback_t callback, void *callback_arg);
+bool pasco2_alarm_update(pasco2_alarm_t *alarm, uint32_t tick, uint16_t ppm);
+
+/* [] END OF FILE */
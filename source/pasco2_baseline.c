@@ -0,0 +1,412 @@
+/*****************************************************************************
+** File name: pasco2_baseline.c
+**
+** Description: This file contains the CO2 baseline compensation. It keeps
+**   the lowest CO2 value of every day of measuring time, takes the lowest
+**   of the last days for fresh air, and corrects the values by the
+**   difference to the reference concentration. Its state is kept in
+**   snapshots in the work flash, so it survives a reset.
+**
+** ===========================================================================
+** Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+** ===========================================================================
+**
+** ===========================================================================
+** Infineon Technologies AG (INFINEON) is supplying this file for use
+** exclusively with Infineon's sensor products. This file can be freely
+** distributed within development tools and software supporting such
+** products.
+**
+** THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+** OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+** MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+** INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+** WHATSOEVER.
+** ===========================================================================
+*/
+
+/* Header file from system */
+#include <string.h>
+
+/* Header file includes */
+#include "cy_pdl.h"
+
+/* Header file for local module */
+#include "pasco2_baseline.h"
+#include "pasco2_telemetry.h"
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+/* Format identifier of the snapshots */
+#define PASCO2_BASELINE_MAGIC (0xBA5EU)
+
+/* Day minimum before the first value of the day */
+#define PASCO2_BASELINE_NO_VALUE (UINT16_MAX)
+
+/*******************************************************************************
+ * Function Name: pasco2_baseline_update_offset
+ *******************************************************************************
+ * Summary:
+ *   Takes the lowest of the day minima for fresh air and derives the
+ *   correction of the values from it, limited to
+ *   PASCO2_BASELINE_MAX_OFFSET_PPM. The correction applies once
+ *   PASCO2_BASELINE_MIN_DAYS days are finished.
+ *
+ * Parameters:
+ *   baseline: compensation object
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+static void pasco2_baseline_update_offset(pasco2_baseline_t *baseline)
+{
+    const pasco2_baseline_state_t *state = &baseline->state;
+    uint16_t lowest = PASCO2_BASELINE_NO_VALUE;
+
+    for (uint8_t i = 0U; i < state->days; i++)
+    {
+        if (state->minima[i] < lowest)
+        {
+            lowest = state->minima[i];
+        }
+    }
+
+    int32_t offset = (state->days > 0U) ? ((int32_t)PASCO2_BASELINE_REFERENCE_PPM - (int32_t)lowest) : 0;
+    baseline->stats.limited = ((offset > PASCO2_BASELINE_MAX_OFFSET_PPM) || (offset < -PASCO2_BASELINE_MAX_OFFSET_PPM));
+    if (offset > PASCO2_BASELINE_MAX_OFFSET_PPM)
+    {
+        offset = PASCO2_BASELINE_MAX_OFFSET_PPM;
+    }
+    else if (offset < -PASCO2_BASELINE_MAX_OFFSET_PPM)
+    {
+        offset = -PASCO2_BASELINE_MAX_OFFSET_PPM;
+    }
+
+    baseline->offset = (int16_t)offset;
+    baseline->stats.offset = baseline->offset;
+    baseline->stats.days = state->days;
+    baseline->stats.valid = (state->days >= PASCO2_BASELINE_MIN_DAYS);
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_baseline_average
+ *******************************************************************************
+ * Summary:
+ *   Adds a value to the moving average of the last
+ *   PASCO2_BASELINE_AVERAGE_VALUES values.
+ *
+ * Parameters:
+ *   baseline: compensation object
+ *   ppm: CO2 value as read from the sensor
+ *
+ * Return:
+ *   average, PASCO2_BASELINE_NO_VALUE until the window is full
+ ******************************************************************************/
+static uint16_t pasco2_baseline_average(pasco2_baseline_t *baseline, uint16_t ppm)
+{
+    if (baseline->window_count == PASCO2_BASELINE_AVERAGE_VALUES)
+    {
+        baseline->window_sum -= baseline->window[baseline->window_next];
+    }
+    else
+    {
+        baseline->window_count++;
+    }
+    baseline->window[baseline->window_next] = ppm;
+    baseline->window_sum += ppm;
+    baseline->window_next = (uint8_t)((baseline->window_next + 1U) % PASCO2_BASELINE_AVERAGE_VALUES);
+
+    if (baseline->window_count < PASCO2_BASELINE_AVERAGE_VALUES)
+    {
+        return PASCO2_BASELINE_NO_VALUE;
+    }
+
+    return (uint16_t)((baseline->window_sum + (PASCO2_BASELINE_AVERAGE_VALUES / 2U)) / PASCO2_BASELINE_AVERAGE_VALUES);
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_baseline_finish_day
+ *******************************************************************************
+ * Summary:
+ *   Keeps the minimum of the day that has just ended, dropping the oldest
+ *   one if all are in use, and starts the next day. A day without values is
+ *   not kept.
+ *
+ * Parameters:
+ *   baseline: compensation object
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+static void pasco2_baseline_finish_day(pasco2_baseline_t *baseline)
+{
+    pasco2_baseline_state_t *state = &baseline->state;
+
+    if (state->day_min != PASCO2_BASELINE_NO_VALUE)
+    {
+        if (state->days == PASCO2_BASELINE_DAYS)
+        {
+            memmove(&state->minima[0], &state->minima[1], (PASCO2_BASELINE_DAYS - 1U) * sizeof(state->minima[0]));
+            state->days--;
+        }
+        state->minima[state->days++] = state->day_min;
+    }
+
+    state->day_min = PASCO2_BASELINE_NO_VALUE;
+    state->day_ms = (state->day_ms >= (2U * PASCO2_BASELINE_DAY_MS)) ? 0U : (state->day_ms - PASCO2_BASELINE_DAY_MS);
+    pasco2_baseline_update_offset(baseline);
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_baseline_init
+ *******************************************************************************
+ * Summary:
+ *   Initializes the compensation of a sensor node, either from scratch or
+ *   from the state of a snapshot. A restored baseline applies to the first
+ *   value at once.
+ *
+ * Parameters:
+ *   baseline: compensation object
+ *   state: state restored from a snapshot, NULL to start learning
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+void pasco2_baseline_init(pasco2_baseline_t *baseline, const pasco2_baseline_state_t *state)
+{
+    memset(baseline, 0, sizeof(*baseline));
+
+    if ((state != NULL) && (state->days <= PASCO2_BASELINE_DAYS) && (state->day_ms < PASCO2_BASELINE_DAY_MS))
+    {
+        baseline->state = *state;
+        baseline->stats.restored = true;
+    }
+    else
+    {
+        baseline->state.day_min = PASCO2_BASELINE_NO_VALUE;
+    }
+
+    pasco2_baseline_update_offset(baseline);
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_baseline_apply
+ *******************************************************************************
+ * Summary:
+ *   Adds a CO2 value to the moving average, the average to the minimum of
+ *   the day, and returns the value compensated. Until
+ *   PASCO2_BASELINE_MIN_DAYS days are finished, the value is returned
+ *   unchanged. The time between two values counts as measuring time.
+ *
+ * Parameters:
+ *   baseline: compensation object
+ *   tick: time of the value in ms
+ *   ppm: CO2 value as read from the sensor
+ *
+ * Return:
+ *   compensated CO2 value in ppm
+ ******************************************************************************/
+uint16_t pasco2_baseline_apply(pasco2_baseline_t *baseline, uint32_t tick, uint16_t ppm)
+{
+    pasco2_baseline_state_t *state = &baseline->state;
+
+    if (baseline->started)
+    {
+        state->day_ms += tick - baseline->last_tick;
+    }
+    baseline->started = true;
+    baseline->last_tick = tick;
+
+    uint16_t average = pasco2_baseline_average(baseline, ppm);
+    if (average < state->day_min)
+    {
+        state->day_min = average;
+    }
+    if (state->day_ms >= PASCO2_BASELINE_DAY_MS)
+    {
+        pasco2_baseline_finish_day(baseline);
+    }
+    baseline->stats.day_s = state->day_ms / 1000U;
+
+    if (!baseline->stats.valid)
+    {
+        return ppm;
+    }
+
+    baseline->stats.values++;
+    if (baseline->stats.accurate_ms == 0U)
+    {
+        baseline->stats.accurate_ms = tick;
+    }
+
+    int32_t value = (int32_t)ppm + baseline->offset;
+
+    return (value < 0) ? 0U : (value > (int32_t)UINT16_MAX) ? UINT16_MAX : (uint16_t)value;
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_baseline_get_stats
+ *******************************************************************************
+ * Summary:
+ *   Returns the counters of the compensation.
+ *
+ * Parameters:
+ *   baseline: compensation object
+ *   stats: receives the counters
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+void pasco2_baseline_get_stats(const pasco2_baseline_t *baseline, pasco2_baseline_stats_t *stats)
+{
+    *stats = baseline->stats;
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_baseline_record_crc
+ *******************************************************************************
+ * Summary:
+ *   Computes the CRC-16 of a snapshot, from the field after the CRC to the
+ *   end of the record.
+ *
+ * Parameters:
+ *   record: snapshot
+ *
+ * Return:
+ *   CRC value
+ ******************************************************************************/
+static uint16_t pasco2_baseline_record_crc(const pasco2_baseline_record_t *record)
+{
+    return pasco2_telemetry_crc16((const uint8_t *)record + sizeof(record->crc), sizeof(*record) - sizeof(record->crc));
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_baseline_store_open
+ *******************************************************************************
+ * Summary:
+ *   Opens the snapshot store and returns the states of the latest complete
+ *   snapshot. A snapshot torn by a reset fails its CRC, and the one before
+ *   it in the other row is used.
+ *
+ * Parameters:
+ *   store: store object
+ *   flash: flash driver, initialized
+ *   address: first of PASCO2_BASELINE_ROWS rows, aligned to a row
+ *   states: receives the states of the sensor nodes
+ *   count: number of entries in states, receives the number restored
+ *
+ * Return:
+ *   CY_RSLT_SUCCESS, PASCO2_BASELINE_RSLT_ERR_EMPTY if there is no snapshot,
+ *   PASCO2_BASELINE_RSLT_ERR_FLASH if the rows are not part of one flash
+ *   block with pages of PASCO2_BASELINE_ROW_SIZE bytes, or the result of a
+ *   flash read
+ ******************************************************************************/
+cy_rslt_t pasco2_baseline_store_open(pasco2_baseline_store_t *store, cyhal_flash_t *flash, uint32_t address,
+                                     pasco2_baseline_state_t *states, uint8_t *count)
+{
+    CY_ASSERT(sizeof(pasco2_baseline_record_t) <= PASCO2_BASELINE_ROW_SIZE);
+    CY_ASSERT(*count <= PASCO2_BASELINE_MAX_NODES);
+
+    uint8_t capacity = *count;
+    *count = 0U;
+    memset(store, 0, sizeof(*store));
+    store->flash = flash;
+    store->address = address;
+
+    cyhal_flash_info_t info;
+    const cyhal_flash_block_info_t *block = NULL;
+    cyhal_flash_get_info(flash, &info);
+    for (uint8_t i = 0U; i < info.block_count; i++)
+    {
+        const cyhal_flash_block_info_t *candidate = &info.blocks[i];
+        if ((address >= candidate->start_address) &&
+            (((address - candidate->start_address) + (PASCO2_BASELINE_ROWS * PASCO2_BASELINE_ROW_SIZE)) <= candidate->size))
+        {
+            block = candidate;
+        }
+    }
+    if ((block == NULL) || (block->page_size != PASCO2_BASELINE_ROW_SIZE) ||
+        (((address - block->start_address) % PASCO2_BASELINE_ROW_SIZE) != 0U))
+    {
+        return PASCO2_BASELINE_RSLT_ERR_FLASH;
+    }
+
+    /* Keep the valid snapshot with the highest number */
+    const pasco2_baseline_record_t *record = &store->row.record;
+    bool found = false;
+    for (uint32_t row = 0U; row < PASCO2_BASELINE_ROWS; row++)
+    {
+        cy_rslt_t result = cyhal_flash_read(flash, address + (row * PASCO2_BASELINE_ROW_SIZE),
+                                            (uint8_t *)store->row.words, PASCO2_BASELINE_ROW_SIZE);
+        if (result != CY_RSLT_SUCCESS)
+        {
+            return result;
+        }
+
+        if ((record->magic == PASCO2_BASELINE_MAGIC) && (record->count <= PASCO2_BASELINE_MAX_NODES) &&
+            (record->crc == pasco2_baseline_record_crc(record)) &&
+            (!found || ((int32_t)(record->sequence - store->sequence) >= 0)))
+        {
+            found = true;
+            store->sequence = record->sequence;
+            *count = (record->count < capacity) ? (uint8_t)record->count : capacity;
+            memcpy(states, record->states, (size_t)*count * sizeof(states[0]));
+        }
+    }
+
+    if (!found)
+    {
+        return PASCO2_BASELINE_RSLT_ERR_EMPTY;
+    }
+
+    store->sequence++;
+    return CY_RSLT_SUCCESS;
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_baseline_store_write
+ *******************************************************************************
+ * Summary:
+ *   Writes a snapshot of the states into the row that does not hold the
+ *   latest one.
+ *
+ * Parameters:
+ *   store: store object, opened
+ *   states: states of the sensor nodes
+ *   count: number of sensor nodes
+ *
+ * Return:
+ *   CY_RSLT_SUCCESS or the result of the flash write
+ ******************************************************************************/
+cy_rslt_t pasco2_baseline_store_write(pasco2_baseline_store_t *store, const pasco2_baseline_state_t *states,
+                                      uint8_t count)
+{
+    CY_ASSERT(count <= PASCO2_BASELINE_MAX_NODES);
+
+    pasco2_baseline_record_t *record = &store->row.record;
+    uint32_t row = store->sequence % PASCO2_BASELINE_ROWS;
+
+    memset(store->row.words, 0, sizeof(store->row.words));
+    record->magic = PASCO2_BASELINE_MAGIC;
+    record->sequence = store->sequence;
+    record->count = count;
+    memcpy(record->states, states, (size_t)count * sizeof(states[0]));
+    record->crc = pasco2_baseline_record_crc(record);
+
+    cy_rslt_t result = cyhal_flash_write(store->flash, store->address + (row * PASCO2_BASELINE_ROW_SIZE),
+                                         store->row.words);
+    if (result != CY_RSLT_SUCCESS)
+    {
+        /* The next snapshot goes to the same row */
+        store->write_errors++;
+        return result;
+    }
+
+    store->sequence++;
+    store->writes++;
+    return CY_RSLT_SUCCESS;
+}
+
+/* [] END OF FILE */
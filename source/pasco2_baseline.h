@@ -0,0 +1,157 @@
+/******************************************************************************
+** File name: pasco2_baseline.h
+**
+** Description: This file contains the types and function prototypes of the
+**   CO2 baseline compensation and of its snapshot in the work flash.
+**
+** ===========================================================================
+** Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+** ===========================================================================
+**
+** ===========================================================================
+** Infineon Technologies AG (INFINEON) is supplying this file for use
+** exclusively with Infineon's sensor products. This file can be freely
+** distributed within development tools and software supporting such
+** products.
+**
+** THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+** OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+** MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+** INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+** WHATSOEVER.
+** ===========================================================================
+*/
+
+#pragma once
+
+/* Header file includes */
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "cyhal.h"
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+/* Build with PASCO2_BASELINE_ENABLE=0 to leave the baseline compensation to
+ * the automatic baseline offset compensation (ABOC) of the PAS CO2, which
+ * starts over after every power-up or reset */
+#ifndef PASCO2_BASELINE_ENABLE
+#define PASCO2_BASELINE_ENABLE (1U)
+#endif
+
+/* Concentration of fresh air that the lowest values are taken for, the
+ * calibration reference of the PAS CO2 after reset */
+#define PASCO2_BASELINE_REFERENCE_PPM (400U)
+
+/* The lowest value is kept for every day of measuring time, and the
+ * baseline is the lowest of the last PASCO2_BASELINE_DAYS days. The values
+ * are compensated once PASCO2_BASELINE_MIN_DAYS days are finished. */
+#define PASCO2_BASELINE_DAY_MS (86400000UL)
+#define PASCO2_BASELINE_DAYS (7U)
+#define PASCO2_BASELINE_MIN_DAYS (2U)
+
+/* The lowest value of a day is taken from the moving average of this many
+ * values, so that a single outlier does not set the baseline for a week */
+#define PASCO2_BASELINE_AVERAGE_VALUES (16U)
+
+/* Largest correction in ppm. A larger one is more likely a fault of the
+ * sensor than drift and is limited to this value. */
+#define PASCO2_BASELINE_MAX_OFFSET_PPM (250)
+
+/* Interval of the snapshots in the work flash in seconds. Measuring time
+ * since the last snapshot is lost on a reset. */
+#define PASCO2_BASELINE_SNAPSHOT_S (3600U)
+
+/* Sensor nodes a snapshot holds */
+#define PASCO2_BASELINE_MAX_NODES (8U)
+
+/* Flash rows of the snapshots, written in turn, and their size */
+#define PASCO2_BASELINE_ROWS (2U)
+#define PASCO2_BASELINE_ROW_SIZE (512U)
+
+/* Result codes */
+#define PASCO2_BASELINE_RSLT_ERR_FLASH \
+    CY_RSLT_CREATE(CY_RSLT_TYPE_ERROR, CY_RSLT_MODULE_MIDDLEWARE_BASE, 0x141U)
+#define PASCO2_BASELINE_RSLT_ERR_EMPTY \
+    CY_RSLT_CREATE(CY_RSLT_TYPE_ERROR, CY_RSLT_MODULE_MIDDLEWARE_BASE, 0x142U)
+
+/*******************************************************************************
+ * Types
+ ******************************************************************************/
+/* Learned state of a sensor node, the content of a snapshot */
+typedef struct
+{
+    uint16_t minima[PASCO2_BASELINE_DAYS]; /* Lowest average of each finished day, newest last */
+    uint16_t day_min;           /* Lowest average of the current day */
+    uint8_t days;               /* Finished days in minima */
+    uint8_t reserved;
+    uint32_t day_ms;            /* Measuring time of the current day */
+} pasco2_baseline_state_t;
+
+/* Counters of the compensation */
+typedef struct
+{
+    int16_t offset;             /* Correction added to the values in ppm */
+    uint8_t days;               /* Finished days the baseline is taken from */
+    bool valid;                 /* Baseline known, learned or restored */
+    bool limited;               /* Offset limited to PASCO2_BASELINE_MAX_OFFSET_PPM */
+    bool restored;              /* State taken from the snapshot at start-up */
+    uint32_t day_s;             /* Measuring time of the current day in seconds */
+    uint32_t values;            /* Values compensated since start-up */
+    uint32_t accurate_ms;       /* Time of the first value compensated with a known baseline, 0 until then */
+} pasco2_baseline_stats_t;
+
+/* Baseline compensation of a sensor node */
+typedef struct
+{
+    pasco2_baseline_state_t state;
+    int16_t offset;
+    bool started;
+    uint32_t last_tick;         /* Time of the previous value in ms */
+    uint16_t window[PASCO2_BASELINE_AVERAGE_VALUES]; /* Last values for the moving average */
+    uint8_t window_count;       /* Values in window */
+    uint8_t window_next;        /* Position of the next value in window */
+    uint32_t window_sum;        /* Sum of the values in window */
+    pasco2_baseline_stats_t stats;
+} pasco2_baseline_t;
+
+/* Snapshot as stored in a flash row */
+typedef struct
+{
+    uint16_t crc;               /* CRC-16 of the rest of the record */
+    uint16_t magic;             /* Format identifier */
+    uint32_t sequence;          /* Snapshot number, the highest one is current */
+    uint16_t count;             /* Sensor nodes in states */
+    uint16_t reserved;
+    pasco2_baseline_state_t states[PASCO2_BASELINE_MAX_NODES];
+} pasco2_baseline_record_t;
+
+/* Snapshot store in PASCO2_BASELINE_ROWS rows of the work flash */
+typedef struct
+{
+    cyhal_flash_t *flash;
+    uint32_t address;
+    uint32_t sequence;          /* Number of the next snapshot */
+    uint32_t writes;            /* Snapshots written since start-up */
+    uint32_t write_errors;      /* Snapshot writes that failed */
+    union
+    {
+        pasco2_baseline_record_t record;
+        uint32_t words[PASCO2_BASELINE_ROW_SIZE / sizeof(uint32_t)];
+    } row;
+} pasco2_baseline_store_t;
+
+/*******************************************************************************
+ * Functions
+ ******************************************************************************/
+void pasco2_baseline_init(pasco2_baseline_t *baseline, const pasco2_baseline_state_t *state);
+uint16_t pasco2_baseline_apply(pasco2_baseline_t *baseline, uint32_t tick, uint16_t ppm);
+void pasco2_baseline_get_stats(const pasco2_baseline_t *baseline, pasco2_baseline_stats_t *stats);
+cy_rslt_t pasco2_baseline_store_open(pasco2_baseline_store_t *store, cyhal_flash_t *flash, uint32_t address,
+                                     pasco2_baseline_state_t *states, uint8_t *count);
+cy_rslt_t pasco2_baseline_store_write(pasco2_baseline_store_t *store, const pasco2_baseline_state_t *states,
+                                      uint8_t count);
+
+/* [] END OF FILE */
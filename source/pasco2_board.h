@@ -0,0 +1,146 @@
+/******************************************************************************
+** File name: pasco2_board.h
+**
+** Description: This file contains the pin map and the capabilities of the
+**   supported kits. Adding a kit takes one more block of definitions.
+**
+** ===========================================================================
+** Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+** ===========================================================================
+**
+** ===========================================================================
+** Infineon Technologies AG (INFINEON) is supplying this file for use
+** exclusively with Infineon's sensor products. This file can be freely
+** distributed within development tools and software supporting such
+** products.
+**
+** THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+** OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+** MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+** INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+** WHATSOEVER.
+** ===========================================================================
+*/
+
+#pragma once
+
+/* Header file includes */
+#include <stdbool.h>
+
+#include "cybsp.h"
+#include "cyhal.h"
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+/* Every kit defines all of the values below. A pin the kit does not have is
+ * NC; code that uses it tests it against NC, which the compiler resolves, so
+ * no board choice remains at run time. Every LED comes with the pin states
+ * that turn it on and off. */
+#if defined(CYSBSYSKIT_DEV_01)
+/* CYSBSYSKIT-DEV-01 with the PAS CO2 Wing Board */
+/* LED blinking during start-up and lit afterwards */
+#define PASCO2_BOARD_LED_STATUS     (CYBSP_USER_LED)
+#define PASCO2_BOARD_LED_STATUS_ON  (CYBSP_LED_STATE_ON)
+#define PASCO2_BOARD_LED_STATUS_OFF (CYBSP_LED_STATE_OFF)
+/* LEDs of the Wing Board showing normal operation and a sensor error,
+ * active high */
+#define PASCO2_BOARD_LED_OK         (P9_0)
+#define PASCO2_BOARD_LED_OK_ON      (1U)
+#define PASCO2_BOARD_LED_OK_OFF     (0U)
+#define PASCO2_BOARD_LED_WARNING    (P9_1)
+#define PASCO2_BOARD_LED_WARNING_ON (1U)
+#define PASCO2_BOARD_LED_WARNING_OFF (0U)
+/* The kit has no LEDs for the CO2 alarm level */
+#define PASCO2_BOARD_LED_CO2_GOOD   (NC)
+#define PASCO2_BOARD_LED_CO2_HIGH   (NC)
+#define PASCO2_BOARD_LED_CO2_ON     (CYBSP_LED_STATE_ON)
+#define PASCO2_BOARD_LED_CO2_OFF    (CYBSP_LED_STATE_OFF)
+/* Sensor interface select and its state selecting I2C */
+#define PASCO2_BOARD_PSEL           (P5_3)
+#define PASCO2_BOARD_PSEL_I2C       (0U)
+/* Switch of the sensor supplies and its states */
+#define PASCO2_BOARD_POWER_SWITCH   (P10_5)
+#define PASCO2_BOARD_POWER_ON       (1U)
+#define PASCO2_BOARD_POWER_OFF      (0U)
+/* Enable of the 12V emitter supply, which the Wing Board drives from INT */
+#define PASCO2_BOARD_EMITTER_ENABLE (NC)
+/* Data-ready interrupt input. The INT line of the sensor drives the 12V
+ * boost converter enable on the Wing Board, so it is not available. */
+#define PASCO2_BOARD_INT            (NC)
+
+#else
+/* CY8CKIT-062S2-43012 and other kits with the XENSIV sensor shield */
+/* The LEDs of the kit are active low */
+#define PASCO2_BOARD_LED_STATUS     (CYBSP_USER_LED2)
+#define PASCO2_BOARD_LED_STATUS_ON  (CYBSP_LED_STATE_ON)
+#define PASCO2_BOARD_LED_STATUS_OFF (CYBSP_LED_STATE_OFF)
+#define PASCO2_BOARD_LED_OK         (CYBSP_USER_LED2)
+#define PASCO2_BOARD_LED_OK_ON      (CYBSP_LED_STATE_ON)
+#define PASCO2_BOARD_LED_OK_OFF     (CYBSP_LED_STATE_OFF)
+#define PASCO2_BOARD_LED_WARNING    (CYBSP_USER_LED)
+#define PASCO2_BOARD_LED_WARNING_ON (CYBSP_LED_STATE_ON)
+#define PASCO2_BOARD_LED_WARNING_OFF (CYBSP_LED_STATE_OFF)
+/* RGB LED showing the CO2 alarm level */
+#define PASCO2_BOARD_LED_CO2_GOOD   (CYBSP_LED_RGB_GREEN)
+#define PASCO2_BOARD_LED_CO2_HIGH   (CYBSP_LED_RGB_RED)
+#define PASCO2_BOARD_LED_CO2_ON     (CYBSP_LED_STATE_ON)
+#define PASCO2_BOARD_LED_CO2_OFF    (CYBSP_LED_STATE_OFF)
+#define PASCO2_BOARD_PSEL           (NC)
+#define PASCO2_BOARD_PSEL_I2C       (0U)
+/* The sensor logic supply cannot be switched */
+#define PASCO2_BOARD_POWER_SWITCH   (NC)
+#define PASCO2_BOARD_POWER_ON       (1U)
+#define PASCO2_BOARD_POWER_OFF      (0U)
+/* PWR_EN_ALT of the shield */
+#define PASCO2_BOARD_EMITTER_ENABLE (CYBSP_A3)
+#define PASCO2_BOARD_INT            (CYBSP_D9)
+#endif
+
+/*******************************************************************************
+ * Functions
+ ******************************************************************************/
+/*******************************************************************************
+ * Function Name: pasco2_board_output_init
+ *******************************************************************************
+ * Summary:
+ *   Initializes a push-pull output of the board. A pin the kit does not have
+ *   is skipped; with a constant pin the call compiles to nothing.
+ *
+ * Parameters:
+ *   pin: PASCO2_BOARD_xxx pin or NC
+ *   level: initial pin state
+ *
+ * Return:
+ *   cy_rslt_t: result of cyhal_gpio_init, CY_RSLT_SUCCESS for NC
+ ******************************************************************************/
+static inline cy_rslt_t pasco2_board_output_init(cyhal_gpio_t pin, bool level)
+{
+    return (pin == NC) ? CY_RSLT_SUCCESS :
+           cyhal_gpio_init(pin, CYHAL_GPIO_DIR_OUTPUT, CYHAL_GPIO_DRIVE_STRONG, level);
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_board_write
+ *******************************************************************************
+ * Summary:
+ *   Sets an output of the board. A pin the kit does not have is skipped;
+ *   with a constant pin the call compiles to a plain pin write or nothing.
+ *
+ * Parameters:
+ *   pin: PASCO2_BOARD_xxx pin or NC
+ *   level: pin state
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+static inline void pasco2_board_write(cyhal_gpio_t pin, bool level)
+{
+    if (pin != NC)
+    {
+        cyhal_gpio_write(pin, level);
+    }
+}
+
+/* [] END OF FILE */
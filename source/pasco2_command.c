@@ -0,0 +1,293 @@
+/*****************************************************************************
+** File name: pasco2_command.c
+**
+** Description: This file implements the command queue of the sensor task.
+** Other tasks never touch the sensors or their buses; they queue a command,
+** the sensor task executes it between two acquisition passes and reports
+** the result through a completion callback.
+**
+** ===========================================================================
+** Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+** ===========================================================================
+**
+** ===========================================================================
+** Infineon Technologies AG (INFINEON) is supplying this file for use
+** exclusively with Infineon's sensor products. This file can be freely
+** distributed within development tools and software supporting such
+** products.
+**
+** THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+** OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+** MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+** INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+** WHATSOEVER.
+** ===========================================================================
+*/
+
+/* Header file for local module */
+#include "pasco2_command.h"
+
+/*******************************************************************************
+ * Function Name: command_execute_done
+ *******************************************************************************
+ * Summary:
+ *   Completion callback of pasco2_command_execute, wakes up the waiting task.
+ *
+ * Parameters:
+ *   callback_arg: command queue object
+ *   result: result of the command
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+static void command_execute_done(void *callback_arg, cy_rslt_t result)
+{
+    pasco2_command_queue_t *queue = (pasco2_command_queue_t *)callback_arg;
+
+    (void)result;
+    (void)cy_rtos_set_semaphore(&queue->done, false);
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_command_queue_init
+ *******************************************************************************
+ * Summary:
+ *   Initializes an empty command queue.
+ *
+ * Parameters:
+ *   queue: command queue object
+ *   owner: task that executes the commands, notified on every submission
+ *
+ * Return:
+ *   Status of the initialization
+ ******************************************************************************/
+cy_rslt_t pasco2_command_queue_init(pasco2_command_queue_t *queue, TaskHandle_t owner)
+{
+    *queue = (pasco2_command_queue_t){ .owner = owner };
+
+    return pasco2_rtos_init_semaphore(&queue->done, &queue->done_storage, 1U, 0U);
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_command_submit
+ *******************************************************************************
+ * Summary:
+ *   Queues a command, wakes up the owner, and returns immediately. The
+ *   command must stay valid until its completion callback has run.
+ *
+ * Parameters:
+ *   queue: command queue object
+ *   command: command to execute
+ *
+ * Return:
+ *   PASCO2_COMMAND_RSLT_ERR_QUEUE_FULL if the command was not queued
+ ******************************************************************************/
+cy_rslt_t pasco2_command_submit(pasco2_command_queue_t *queue, pasco2_command_t *command)
+{
+    cy_rslt_t result = CY_RSLT_SUCCESS;
+
+    command->submit_tick = xTaskGetTickCount();
+
+    taskENTER_CRITICAL();
+    if (queue->queue_count >= PASCO2_COMMAND_QUEUE_LENGTH)
+    {
+        queue->stats.rejected++;
+        result = PASCO2_COMMAND_RSLT_ERR_QUEUE_FULL;
+    }
+    else
+    {
+        uint8_t tail = (uint8_t)((queue->queue_head + queue->queue_count) % PASCO2_COMMAND_QUEUE_LENGTH);
+        queue->queue[tail] = command;
+        queue->queue_count++;
+        if (queue->queue_count > queue->stats.queue_high_water)
+        {
+            queue->stats.queue_high_water = queue->queue_count;
+        }
+    }
+    taskEXIT_CRITICAL();
+
+    if (result == CY_RSLT_SUCCESS)
+    {
+        xTaskNotifyGive(queue->owner);
+    }
+
+    return result;
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_command_cancel
+ *******************************************************************************
+ * Summary:
+ *   Withdraws a command that the owner has not taken yet. It ends with
+ *   PASCO2_COMMAND_RSLT_ERR_TIMEOUT and its callback is not called.
+ *
+ * Parameters:
+ *   queue: command queue object
+ *   command: submitted command
+ *
+ * Return:
+ *   true if the command was withdrawn, false if it is being executed or has
+ *   completed already
+ ******************************************************************************/
+bool pasco2_command_cancel(pasco2_command_queue_t *queue, pasco2_command_t *command)
+{
+    bool cancelled = false;
+
+    taskENTER_CRITICAL();
+    for (uint8_t i = 0U; i < queue->queue_count; i++)
+    {
+        uint8_t index = (uint8_t)((queue->queue_head + i) % PASCO2_COMMAND_QUEUE_LENGTH);
+        if (queue->queue[index] == command)
+        {
+            /* Close the gap left by the command */
+            for (uint8_t j = i; (j + 1U) < queue->queue_count; j++)
+            {
+                uint8_t next = (uint8_t)((index + 1U) % PASCO2_COMMAND_QUEUE_LENGTH);
+                queue->queue[index] = queue->queue[next];
+                index = next;
+            }
+            queue->queue_count--;
+            queue->stats.errors++;
+            command->result = PASCO2_COMMAND_RSLT_ERR_TIMEOUT;
+            cancelled = true;
+            break;
+        }
+    }
+    taskEXIT_CRITICAL();
+
+    return cancelled;
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_command_execute
+ *******************************************************************************
+ * Summary:
+ *   Queues a command and sleeps until the owner has executed it. Only one
+ *   task may use this function at a time. A command that the owner has not
+ *   taken within the timeout is withdrawn; once taken, it is always waited
+ *   for, because the owner executes it without blocking on other tasks.
+ *
+ * Parameters:
+ *   queue: command queue object
+ *   command: command to execute, its callback is overwritten
+ *   timeout_ms: maximum time to wait for the owner to take the command
+ *
+ * Return:
+ *   Result of the command
+ ******************************************************************************/
+cy_rslt_t pasco2_command_execute(pasco2_command_queue_t *queue, pasco2_command_t *command, cy_time_t timeout_ms)
+{
+    command->callback = command_execute_done;
+    command->callback_arg = queue;
+
+    cy_rslt_t result = pasco2_command_submit(queue, command);
+    if (result != CY_RSLT_SUCCESS)
+    {
+        return result;
+    }
+
+    if ((cy_rtos_get_semaphore(&queue->done, timeout_ms, false) != CY_RSLT_SUCCESS) &&
+        !pasco2_command_cancel(queue, command))
+    {
+        /* Taken by the owner, or completed between the timeout and the
+         * cancellation */
+        (void)cy_rtos_get_semaphore(&queue->done, CY_RTOS_NEVER_TIMEOUT, false);
+    }
+
+    return command->result;
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_command_take
+ *******************************************************************************
+ * Summary:
+ *   Removes the oldest command from the queue for execution. Called by the
+ *   owner only, which completes the command before it takes the next one.
+ *
+ * Parameters:
+ *   queue: command queue object
+ *
+ * Return:
+ *   Command to execute, NULL if the queue is empty
+ ******************************************************************************/
+pasco2_command_t *pasco2_command_take(pasco2_command_queue_t *queue)
+{
+    pasco2_command_t *command = NULL;
+
+    taskENTER_CRITICAL();
+    if (queue->queue_count > 0U)
+    {
+        command = queue->queue[queue->queue_head];
+        queue->queue_head = (uint8_t)((queue->queue_head + 1U) % PASCO2_COMMAND_QUEUE_LENGTH);
+        queue->queue_count--;
+        queue->active = command;
+    }
+    taskEXIT_CRITICAL();
+
+    return command;
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_command_complete
+ *******************************************************************************
+ * Summary:
+ *   Finishes the command taken by the owner, records its latency, and
+ *   reports its result.
+ *
+ * Parameters:
+ *   queue: command queue object
+ *   command: command taken with pasco2_command_take
+ *   result: result of the command
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+void pasco2_command_complete(pasco2_command_queue_t *queue, pasco2_command_t *command, cy_rslt_t result)
+{
+    uint32_t latency_ms = (uint32_t)((xTaskGetTickCount() - command->submit_tick) * portTICK_PERIOD_MS);
+
+    CY_ASSERT(queue->active == command);
+
+    taskENTER_CRITICAL();
+    queue->active = NULL;
+    queue->stats.completed++;
+    if (result != CY_RSLT_SUCCESS)
+    {
+        queue->stats.errors++;
+    }
+    queue->stats.last_latency_ms = latency_ms;
+    if (latency_ms > queue->stats.max_latency_ms)
+    {
+        queue->stats.max_latency_ms = latency_ms;
+    }
+    taskEXIT_CRITICAL();
+
+    command->result = result;
+    if (command->callback != NULL)
+    {
+        command->callback(command->callback_arg, result);
+    }
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_command_get_stats
+ *******************************************************************************
+ * Summary:
+ *   Returns a copy of the command queue counters.
+ *
+ * Parameters:
+ *   queue: command queue object
+ *   stats: destination of the counters
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+void pasco2_command_get_stats(const pasco2_command_queue_t *queue, pasco2_command_stats_t *stats)
+{
+    taskENTER_CRITICAL();
+    *stats = queue->stats;
+    taskEXIT_CRITICAL();
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,115 @@
+/******************************************************************************
+** File name: pasco2_command.h
+**
+** Description: This file contains the types and function prototypes of the
+**   command queue through which other tasks request sensor operations from
+**   the sensor task.
+**
+** ===========================================================================
+** Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+** ===========================================================================
+**
+** ===========================================================================
+** Infineon Technologies AG (INFINEON) is supplying this file for use
+** exclusively with Infineon's sensor products. This file can be freely
+** distributed within development tools and software supporting such
+** products.
+**
+** THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+** OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+** MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+** INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+** WHATSOEVER.
+** ===========================================================================
+*/
+
+#pragma once
+
+/* Header file includes */
+#include "cyabs_rtos.h"
+
+#include "pasco2_rtos.h"
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+/* Maximum number of commands waiting for the sensor task */
+#define PASCO2_COMMAND_QUEUE_LENGTH (4U)
+
+/* Result codes of the command queue */
+#define PASCO2_COMMAND_RSLT_ERR_QUEUE_FULL \
+    CY_RSLT_CREATE(CY_RSLT_TYPE_ERROR, CY_RSLT_MODULE_MIDDLEWARE_BASE, 0x131U)
+#define PASCO2_COMMAND_RSLT_ERR_TIMEOUT \
+    CY_RSLT_CREATE(CY_RSLT_TYPE_ERROR, CY_RSLT_MODULE_MIDDLEWARE_BASE, 0x132U)
+
+/*******************************************************************************
+ * Types
+ ******************************************************************************/
+/* Operations the sensor task performs on request */
+typedef enum
+{
+    PASCO2_COMMAND_SET_PERIOD,          /* Program the measurement period */
+    PASCO2_COMMAND_SET_SINGLE_SHOT,     /* Select single-shot or continuous measurements */
+    PASCO2_COMMAND_SET_ADAPTIVE         /* Let the rate controller choose the period */
+} pasco2_command_type_t;
+
+/* Completion callback, executed in the context of the sensor task */
+typedef void (*pasco2_command_done_callback_t)(void *callback_arg, cy_rslt_t result);
+
+/* A request to the sensor task */
+typedef struct
+{
+    pasco2_command_type_t type;
+    union
+    {
+        uint16_t period_s;              /* PASCO2_COMMAND_SET_PERIOD */
+        bool single_shot;               /* PASCO2_COMMAND_SET_SINGLE_SHOT */
+        struct
+        {
+            uint16_t period_fast_s;     /* 0 turns the controller off */
+            uint16_t period_slow_s;
+        } adaptive;                     /* PASCO2_COMMAND_SET_ADAPTIVE */
+    } arg;
+    pasco2_command_done_callback_t callback;
+    void *callback_arg;
+    TickType_t submit_tick;             /* Set on submission */
+    volatile cy_rslt_t result;          /* Result of the command, valid after completion */
+} pasco2_command_t;
+
+/* Command queue counters */
+typedef struct
+{
+    uint32_t completed;                 /* Commands executed by the sensor task */
+    uint32_t errors;                    /* Commands that ended with an error or were withdrawn */
+    uint32_t rejected;                  /* Commands refused because the queue was full */
+    uint32_t queue_high_water;          /* Largest number of queued commands */
+    uint32_t last_latency_ms;           /* Time from submission to completion of the last command */
+    uint32_t max_latency_ms;            /* Longest time from submission to completion */
+} pasco2_command_stats_t;
+
+/* Command queue object */
+typedef struct
+{
+    TaskHandle_t owner;                 /* Task that executes the commands */
+    pasco2_command_t *queue[PASCO2_COMMAND_QUEUE_LENGTH];
+    uint8_t queue_head;
+    uint8_t queue_count;
+    pasco2_command_t *volatile active;  /* Command being executed by the owner */
+    cy_semaphore_t done;
+    pasco2_rtos_semaphore_storage_t done_storage;
+    pasco2_command_stats_t stats;
+} pasco2_command_queue_t;
+
+/*******************************************************************************
+ * Functions
+ ******************************************************************************/
+cy_rslt_t pasco2_command_queue_init(pasco2_command_queue_t *queue, TaskHandle_t owner);
+cy_rslt_t pasco2_command_submit(pasco2_command_queue_t *queue, pasco2_command_t *command);
+bool pasco2_command_cancel(pasco2_command_queue_t *queue, pasco2_command_t *command);
+cy_rslt_t pasco2_command_execute(pasco2_command_queue_t *queue, pasco2_command_t *command, cy_time_t timeout_ms);
+pasco2_command_t *pasco2_command_take(pasco2_command_queue_t *queue);
+void pasco2_command_complete(pasco2_command_queue_t *queue, pasco2_command_t *command, cy_rslt_t result);
+void pasco2_command_get_stats(const pasco2_command_queue_t *queue, pasco2_command_stats_t *stats);
+
+/* [] END OF FILE */
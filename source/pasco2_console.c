@@ -0,0 +1,503 @@
+/*****************************************************************************
+** File name: pasco2_console.c
+**
+** Description: This file contains the non-blocking console output. Writers
+**   copy into a ring buffer that the UART drains in asynchronous transfers.
+**
+** ===========================================================================
+** Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+** ===========================================================================
+**
+** ===========================================================================
+** Infineon Technologies AG (INFINEON) is supplying this file for use
+** exclusively with Infineon's sensor products. This file can be freely
+** distributed within development tools and software supporting such
+** products.
+**
+** THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+** OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+** MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+** INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+** WHATSOEVER.
+** ===========================================================================
+*/
+
+/* Header file from system */
+#include <string.h>
+
+/* Header file includes */
+#include "cy_pdl.h"
+#include "cyabs_rtos.h"
+#include "FreeRTOS.h"
+#include "task.h"
+
+/* Header file for local module */
+#include "pasco2_console.h"
+#include "pasco2_rtos.h"
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+#define PASCO2_CONSOLE_RING_MASK (PASCO2_CONSOLE_RING_SIZE - 1U)
+
+#if ((PASCO2_CONSOLE_RING_SIZE & PASCO2_CONSOLE_RING_MASK) != 0U)
+#error "PASCO2_CONSOLE_RING_SIZE must be a power of two"
+#endif
+
+/*******************************************************************************
+ * Global Variables
+ ******************************************************************************/
+static cyhal_uart_t *console_uart;
+static pasco2_console_stats_t console_stats;
+
+/* Held for a whole write or printf call, so that the output of one task is
+ * not split by that of another */
+static SemaphoreHandle_t console_lock;
+static pasco2_rtos_semaphore_storage_t console_lock_storage;
+
+#if (PASCO2_CONSOLE_ENABLE != 0U)
+/* The ring is filled by the tasks at head and sent by the UART from tail.
+ * Writers reserve their space at reserve and copy outside the critical
+ * section; head moves up to reserve once no copy is in progress. The indices
+ * run freely and are masked on access. The critical sections mask the
+ * interrupts with the FROM_ISR variants: main() prints before the scheduler
+ * starts, when taskEXIT_CRITICAL would leave the transmit-done interrupt
+ * masked. */
+static uint8_t console_ring[PASCO2_CONSOLE_RING_SIZE];
+static volatile uint32_t console_head;
+static volatile uint32_t console_reserve;
+static volatile uint32_t console_copying;       /* Writers copying into reserved space */
+static volatile uint32_t console_tail;
+static volatile uint32_t console_sending;       /* Bytes of the running transfer, 0 if idle */
+static cyhal_uart_event_callback_t console_rx_callback;
+static void *console_rx_arg;
+#endif
+
+/*******************************************************************************
+ * Function Name: pasco2_console_wait
+ *******************************************************************************
+ * Summary:
+ *   Waits for the UART to make progress. Sleeps once the scheduler runs and
+ *   spins before, while main() prints the banner.
+ *
+ * Parameters:
+ *   none
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+static void pasco2_console_wait(void)
+{
+    if (xTaskGetSchedulerState() == taskSCHEDULER_RUNNING)
+    {
+        (void)cy_rtos_delay_milliseconds(PASCO2_CONSOLE_WAIT_MS);
+    }
+    else
+    {
+        cyhal_system_delay_us((uint16_t)(PASCO2_CONSOLE_WAIT_MS * 1000U));
+    }
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_console_lock
+ *******************************************************************************
+ * Summary:
+ *   Waits until no other task writes to the console. Before the scheduler
+ *   starts only main() writes and the lock is not taken.
+ *
+ * Parameters:
+ *   none
+ *
+ * Return:
+ *   bool: true if the lock was taken and must be released
+ ******************************************************************************/
+static bool pasco2_console_lock(void)
+{
+    if (xTaskGetSchedulerState() != taskSCHEDULER_RUNNING)
+    {
+        return false;
+    }
+
+    (void)xSemaphoreTake(console_lock, portMAX_DELAY);
+    return true;
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_console_unlock
+ *******************************************************************************
+ * Summary:
+ *   Releases the lock taken by pasco2_console_lock.
+ *
+ * Parameters:
+ *   locked: result of pasco2_console_lock
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+static void pasco2_console_unlock(bool locked)
+{
+    if (locked)
+    {
+        (void)xSemaphoreGive(console_lock);
+    }
+}
+
+#if (PASCO2_CONSOLE_ENABLE != 0U)
+/*******************************************************************************
+ * Function Name: pasco2_console_start
+ *******************************************************************************
+ * Summary:
+ *   Starts a transfer of the queued bytes up to the end of the ring. Called
+ *   with interrupts disabled or from the transmit-done interrupt, and only
+ *   while no transfer runs.
+ *
+ * Parameters:
+ *   none
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+static void pasco2_console_start(void)
+{
+    uint32_t offset = console_tail & PASCO2_CONSOLE_RING_MASK;
+    uint32_t length = console_head - console_tail;
+
+    if (length > (PASCO2_CONSOLE_RING_SIZE - offset))
+    {
+        length = PASCO2_CONSOLE_RING_SIZE - offset;
+    }
+    if ((length > 0U) &&
+        (cyhal_uart_write_async(console_uart, &console_ring[offset], length) == CY_RSLT_SUCCESS))
+    {
+        console_sending = length;
+        console_stats.transfers++;
+    }
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_console_isr
+ *******************************************************************************
+ * Summary:
+ *   Handler of the UART interrupt. Releases the bytes of a finished transfer
+ *   and starts the next one. Receive events are passed on to the handler
+ *   registered by the terminal.
+ *
+ * Parameters:
+ *   callback_arg: unused
+ *   event: UART events that triggered the interrupt
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+static void pasco2_console_isr(void *callback_arg, cyhal_uart_event_t event)
+{
+    (void)callback_arg;
+
+    if ((event & CYHAL_UART_IRQ_TX_DONE) != 0U)
+    {
+        console_tail += console_sending;
+        console_sending = 0U;
+        pasco2_console_start();
+    }
+
+    cyhal_uart_event_t rx_event = (cyhal_uart_event_t)(event & ~CYHAL_UART_IRQ_TX_DONE);
+    if ((rx_event != CYHAL_UART_IRQ_NONE) && (console_rx_callback != NULL))
+    {
+        console_rx_callback(console_rx_arg, rx_event);
+    }
+}
+#endif /* PASCO2_CONSOLE_ENABLE */
+
+/*******************************************************************************
+ * Function Name: pasco2_console_init
+ *******************************************************************************
+ * Summary:
+ *   Takes over the transmit side of the console UART. Transfers use DMA
+ *   where the HAL provides it and the transmit interrupt otherwise.
+ *
+ * Parameters:
+ *   uart: UART initialized by retarget-io
+ *
+ * Return:
+ *   cy_rslt_t: CY_RSLT_SUCCESS, or the error of the HAL or RTOS
+ ******************************************************************************/
+cy_rslt_t pasco2_console_init(cyhal_uart_t *uart)
+{
+    console_uart = uart;
+
+    cy_rslt_t result = pasco2_rtos_init_mutex(&console_lock, &console_lock_storage);
+    if (result != CY_RSLT_SUCCESS)
+    {
+        return result;
+    }
+
+#if (PASCO2_CONSOLE_ENABLE != 0U)
+    if (cyhal_uart_set_async_mode(uart, CYHAL_ASYNC_DMA, CYHAL_DMA_PRIORITY_DEFAULT) != CY_RSLT_SUCCESS)
+    {
+        result = cyhal_uart_set_async_mode(uart, CYHAL_ASYNC_SW, CYHAL_DMA_PRIORITY_DEFAULT);
+        if (result != CY_RSLT_SUCCESS)
+        {
+            return result;
+        }
+    }
+    cyhal_uart_register_callback(uart, pasco2_console_isr, NULL);
+    cyhal_uart_enable_event(uart, CYHAL_UART_IRQ_TX_DONE, PASCO2_CONSOLE_INTR_PRIORITY, true);
+#endif
+
+    return CY_RSLT_SUCCESS;
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_console_register_rx
+ *******************************************************************************
+ * Summary:
+ *   Registers the handler of the UART receive events. The console owns the
+ *   UART callback, so the terminal registers here instead of with the HAL.
+ *
+ * Parameters:
+ *   callback: receive handler, called in interrupt context
+ *   callback_arg: argument of the handler
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+void pasco2_console_register_rx(cyhal_uart_event_callback_t callback, void *callback_arg)
+{
+#if (PASCO2_CONSOLE_ENABLE != 0U)
+    UBaseType_t mask = taskENTER_CRITICAL_FROM_ISR();
+    console_rx_callback = callback;
+    console_rx_arg = callback_arg;
+    taskEXIT_CRITICAL_FROM_ISR(mask);
+#else
+    cyhal_uart_register_callback(console_uart, callback, callback_arg);
+#endif
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_console_queue
+ *******************************************************************************
+ * Summary:
+ *   Queues bytes for the console UART and returns once they are copied. A
+ *   write that does not fit waits for the UART or is dropped as a whole,
+ *   depending on the policy. The space is reserved with interrupts masked
+ *   and the bytes are copied with interrupts enabled. A waiting write is
+ *   queued in parts, so the caller holds the console lock.
+ *
+ * Parameters:
+ *   data: bytes to send
+ *   size: number of bytes
+ *   policy: behavior when the ring is full
+ *
+ * Return:
+ *   size_t: number of bytes queued, 0 if the write was dropped
+ ******************************************************************************/
+static size_t pasco2_console_queue(const void *data, size_t size, pasco2_console_policy_t policy)
+{
+    const uint8_t *bytes = data;
+    size_t queued = 0U;
+    bool blocked = false;
+
+#if (PASCO2_CONSOLE_ENABLE != 0U)
+    while (queued < size)
+    {
+        UBaseType_t mask = taskENTER_CRITICAL_FROM_ISR();
+        uint32_t space = PASCO2_CONSOLE_RING_SIZE - (console_reserve - console_tail);
+        if ((policy == PASCO2_CONSOLE_DROP) && (space < size))
+        {
+            console_stats.dropped_writes++;
+            console_stats.dropped_bytes += (uint32_t)size;
+            taskEXIT_CRITICAL_FROM_ISR(mask);
+            return 0U;
+        }
+
+        uint32_t length = ((size - queued) < space) ? (uint32_t)(size - queued) : space;
+        uint32_t offset = console_reserve & PASCO2_CONSOLE_RING_MASK;
+        console_reserve += length;
+        console_copying++;
+        if ((console_reserve - console_tail) > console_stats.high_water)
+        {
+            console_stats.high_water = console_reserve - console_tail;
+        }
+        taskEXIT_CRITICAL_FROM_ISR(mask);
+
+        /* The UART does not read the reserved space before head passes it */
+        uint32_t first = ((PASCO2_CONSOLE_RING_SIZE - offset) < length) ? (PASCO2_CONSOLE_RING_SIZE - offset) : length;
+        memcpy(&console_ring[offset], &bytes[queued], first);
+        memcpy(console_ring, &bytes[queued + first], length - first);
+
+        /* The copy is complete before head covers it. The last writer to
+         * finish publishes the space of all of them. */
+        __DMB();
+        mask = taskENTER_CRITICAL_FROM_ISR();
+        console_copying--;
+        if (console_copying == 0U)
+        {
+            console_head = console_reserve;
+            if (console_sending == 0U)
+            {
+                pasco2_console_start();
+            }
+        }
+        taskEXIT_CRITICAL_FROM_ISR(mask);
+
+        queued += length;
+        if (queued < size)
+        {
+            blocked = true;
+            pasco2_console_wait();
+        }
+    }
+#else
+    (void)policy;
+    while (queued < size)
+    {
+        size_t length = size - queued;
+
+        if (cyhal_uart_write(console_uart, (void *)&bytes[queued], &length) != CY_RSLT_SUCCESS)
+        {
+            CY_ASSERT(0);
+        }
+        queued += length;
+        if (queued < size)
+        {
+            blocked = true;
+            pasco2_console_wait();
+        }
+    }
+#endif
+
+    UBaseType_t mask = taskENTER_CRITICAL_FROM_ISR();
+    console_stats.writes++;
+    console_stats.bytes += (uint32_t)size;
+    console_stats.blocked_writes += blocked ? 1U : 0U;
+    taskEXIT_CRITICAL_FROM_ISR(mask);
+
+    return queued;
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_console_write
+ *******************************************************************************
+ * Summary:
+ *   Queues bytes for the console UART and returns once they are copied. A
+ *   write that does not fit waits for the UART or is dropped as a whole,
+ *   depending on the policy. The bytes reach the ring in one piece, without
+ *   the output of other tasks in between. Must not be called from an
+ *   interrupt.
+ *
+ * Parameters:
+ *   data: bytes to send
+ *   size: number of bytes
+ *   policy: behavior when the ring is full
+ *
+ * Return:
+ *   size_t: number of bytes queued, 0 if the write was dropped
+ ******************************************************************************/
+size_t pasco2_console_write(const void *data, size_t size, pasco2_console_policy_t policy)
+{
+    bool locked = pasco2_console_lock();
+    size_t queued = pasco2_console_queue(data, size, policy);
+    pasco2_console_unlock(locked);
+
+    return queued;
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_console_flush
+ *******************************************************************************
+ * Summary:
+ *   Waits until all queued bytes have left the UART.
+ *
+ * Parameters:
+ *   none
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+void pasco2_console_flush(void)
+{
+#if (PASCO2_CONSOLE_ENABLE != 0U)
+    while (console_head != console_tail)
+    {
+        pasco2_console_wait();
+    }
+#endif
+    while (cyhal_uart_is_tx_active(console_uart))
+    {
+        pasco2_console_wait();
+    }
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_console_get_stats
+ *******************************************************************************
+ * Summary:
+ *   Returns the counters of the console output.
+ *
+ * Parameters:
+ *   stats: receives the counters
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+void pasco2_console_get_stats(pasco2_console_stats_t *stats)
+{
+    UBaseType_t mask = taskENTER_CRITICAL_FROM_ISR();
+    *stats = console_stats;
+    taskEXIT_CRITICAL_FROM_ISR(mask);
+}
+
+#if (PASCO2_CONSOLE_ENABLE != 0U)
+/*******************************************************************************
+ * Function Name: _write
+ *******************************************************************************
+ * Summary:
+ *   stdout hook of newlib, replacing the weak one of retarget-io. Converts
+ *   LF to CRLF like retarget-io when CY_RETARGET_IO_CONVERT_LF_TO_CRLF is
+ *   defined, and queues the text with PASCO2_CONSOLE_POLICY. The lock is
+ *   held for the whole call, like the mutex of retarget-io, so that no other
+ *   output lands between a line and its CRLF.
+ *
+ * Parameters:
+ *   fd: file descriptor, stdout or stderr
+ *   ptr: characters to write
+ *   len: number of characters
+ *
+ * Return:
+ *   int: len, characters dropped by the policy count as written
+ ******************************************************************************/
+int _write(int fd, const char *ptr, int len)
+{
+    (void)fd;
+
+    bool locked = pasco2_console_lock();
+#if defined(CY_RETARGET_IO_CONVERT_LF_TO_CRLF)
+    const char *end = ptr + len;
+
+    while (ptr < end)
+    {
+        const char *lf = memchr(ptr, '\n', (size_t)(end - ptr));
+        size_t length = (lf != NULL) ? (size_t)(lf - ptr) : (size_t)(end - ptr);
+
+        if (length > 0U)
+        {
+            (void)pasco2_console_queue(ptr, length, PASCO2_CONSOLE_POLICY);
+        }
+        if (lf != NULL)
+        {
+            (void)pasco2_console_queue("\r\n", 2U, PASCO2_CONSOLE_POLICY);
+            length++;
+        }
+        ptr += length;
+    }
+#else
+    (void)pasco2_console_queue(ptr, (size_t)len, PASCO2_CONSOLE_POLICY);
+#endif
+    pasco2_console_unlock(locked);
+
+    return len;
+}
+#endif /* PASCO2_CONSOLE_ENABLE */
+
+/* [] END OF FILE */
@@ -0,0 +1,94 @@
+/******************************************************************************
+** File name: pasco2_console.h
+**
+** Description: This file contains the types and function prototypes of the
+**   non-blocking console output.
+**
+** ===========================================================================
+** Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+** ===========================================================================
+**
+** ===========================================================================
+** Infineon Technologies AG (INFINEON) is supplying this file for use
+** exclusively with Infineon's sensor products. This file can be freely
+** distributed within development tools and software supporting such
+** products.
+**
+** THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+** OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+** MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+** INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+** WHATSOEVER.
+** ===========================================================================
+*/
+
+#pragma once
+
+/* Header file includes */
+#include <stddef.h>
+#include <stdint.h>
+
+#include "cyhal.h"
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+/* Set to 0 to send console output with the blocking retarget-io driver. The
+ * stdout hook is only replaced for GCC, other toolchains keep retarget-io. */
+#ifndef PASCO2_CONSOLE_ENABLE
+#if defined(__GNUC__) && !defined(__ARMCC_VERSION)
+#define PASCO2_CONSOLE_ENABLE (1U)
+#else
+#define PASCO2_CONSOLE_ENABLE (0U)
+#endif
+#endif
+
+/* Size of the transmit ring in bytes, must be a power of two. About 90 ms of
+ * output at 115200 baud. */
+#define PASCO2_CONSOLE_RING_SIZE (1024U)
+
+/* Priority of the transmit-done interrupt */
+#define PASCO2_CONSOLE_INTR_PRIORITY (7U)
+
+/* Sleep of a blocking writer while the ring is full */
+#define PASCO2_CONSOLE_WAIT_MS (1U)
+
+/* Policy of stdout and the telemetry frames when the ring is full. Build
+ * with PASCO2_CONSOLE_POLICY=PASCO2_CONSOLE_DROP to never wait for the UART. */
+#ifndef PASCO2_CONSOLE_POLICY
+#define PASCO2_CONSOLE_POLICY (PASCO2_CONSOLE_BLOCK)
+#endif
+
+/*******************************************************************************
+ * Types
+ ******************************************************************************/
+/* Behavior of a write that does not fit into the ring */
+typedef enum
+{
+    PASCO2_CONSOLE_BLOCK,       /* Wait until the UART has made room */
+    PASCO2_CONSOLE_DROP         /* Discard the whole write and count it */
+} pasco2_console_policy_t;
+
+/* Counters of the console output */
+typedef struct
+{
+    uint32_t writes;            /* Write calls */
+    uint32_t bytes;             /* Bytes queued for the UART */
+    uint32_t transfers;         /* Asynchronous UART transfers started */
+    uint32_t blocked_writes;    /* Writes that waited for room in the ring */
+    uint32_t dropped_writes;    /* Writes discarded because the ring was full */
+    uint32_t dropped_bytes;     /* Bytes of the discarded writes */
+    uint32_t high_water;        /* Most bytes queued at once */
+} pasco2_console_stats_t;
+
+/*******************************************************************************
+ * Functions
+ ******************************************************************************/
+cy_rslt_t pasco2_console_init(cyhal_uart_t *uart);
+void pasco2_console_register_rx(cyhal_uart_event_callback_t callback, void *callback_arg);
+size_t pasco2_console_write(const void *data, size_t size, pasco2_console_policy_t policy);
+void pasco2_console_flush(void);
+void pasco2_console_get_stats(pasco2_console_stats_t *stats);
+
+/* [] END OF FILE */
@@ -0,0 +1,350 @@
+/*****************************************************************************
+** File name: pasco2_dps_fifo.c
+**
+** Description: This file runs the DPS3xx in continuous background mode with
+** its result FIFO enabled. The FIFO is drained with one I2C engine request and
+** the batch is compensated and averaged in a single pass, which lowers both
+** the I2C round trips per pressure value and the noise of the compensation
+** input of the PAS CO2 sensor.
+**
+** ===========================================================================
+** Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+** ===========================================================================
+**
+** ===========================================================================
+** Infineon Technologies AG (INFINEON) is supplying this file for use
+** exclusively with Infineon's sensor products. This file can be freely
+** distributed within development tools and software supporting such
+** products.
+**
+** THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+** OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+** MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+** INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+** WHATSOEVER.
+** ===========================================================================
+*/
+
+/* Header file from system */
+#include <string.h>
+
+/* Header file includes */
+#include "pasco2_probe.h"
+
+/* Header file for local module */
+#include "pasco2_dps_fifo.h"
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+/* DPS3xx registers */
+#define DPS3XX_REG_PSR_B2       (0x00U)
+#define DPS3XX_REG_PRS_CFG      (0x06U)
+#define DPS3XX_REG_TMP_CFG      (0x07U)
+#define DPS3XX_REG_MEAS_CFG     (0x08U)
+#define DPS3XX_REG_CFG_REG      (0x09U)
+#define DPS3XX_REG_RESET        (0x0CU)
+#define DPS3XX_REG_COEF         (0x10U)
+#define DPS3XX_REG_COEF_SRCE    (0x28U)
+
+#define DPS3XX_COEF_SIZE        (18U)
+#define DPS3XX_TMP_EXT_MSK      (0x80U)
+#define DPS3XX_MEAS_CTRL_CONT_ALL (0x07U)
+#define DPS3XX_CFG_FIFO_EN_MSK  (0x02U)
+#define DPS3XX_CFG_P_SHIFT_MSK  (0x04U)
+#define DPS3XX_RESET_FIFO_FLUSH (0x80U)
+
+/* Value read from an empty FIFO */
+#define DPS3XX_FIFO_EMPTY       (0x800000L)
+
+/* Oversampling of more than 8 times needs the result shift bit */
+#define PASCO2_DPS_FIFO_CFG_REG (DPS3XX_CFG_FIFO_EN_MSK | \
+                                 ((PASCO2_DPS_FIFO_PRESSURE_OVERSAMPLE > 3U) ? DPS3XX_CFG_P_SHIFT_MSK : 0U))
+
+/* Maximum time for an I2C request to the DPS3xx */
+#define PASCO2_DPS_FIFO_TIMEOUT_MS (50U)
+
+/* Fraction bits of the scaled raw values and of the results while the
+ * polynomial is evaluated. With scaled values below 16 and 20-bit
+ * coefficients all products stay below 2^61. */
+#define DPS3XX_SCALED_FRACTION_BITS (24U)
+#define DPS3XX_RESULT_FRACTION_BITS (8U)
+#define DPS3XX_SCALED_ONE           ((int64_t)1 << DPS3XX_SCALED_FRACTION_BITS)
+#define DPS3XX_RESULT_ONE           ((int64_t)1 << DPS3XX_RESULT_FRACTION_BITS)
+
+/*******************************************************************************
+ * Constants
+ ******************************************************************************/
+/* Compensation scale factors indexed by the oversampling exponent */
+static const int32_t dps3xx_scale_factor[] =
+{
+    524288L, 1572864L, 3670016L, 7864320L,
+    253952L, 516096L, 1040384L, 2088960L
+};
+
+/*******************************************************************************
+ * Function Name: dps3xx_sign_extend
+ *******************************************************************************
+ * Summary:
+ *   Converts a two's complement value of the given width to int32_t.
+ *
+ * Parameters:
+ *   value: raw value
+ *   bits: width of the value
+ *
+ * Return:
+ *   signed value
+ ******************************************************************************/
+static int32_t dps3xx_sign_extend(uint32_t value, uint8_t bits)
+{
+    uint32_t sign = 1UL << (bits - 1U);
+    return (int32_t)((value ^ sign) - sign);
+}
+
+/*******************************************************************************
+ * Function Name: dps3xx_shift_down
+ *******************************************************************************
+ * Summary:
+ *   Removes fraction bits from a fixed-point value, rounding down also for
+ *   negative values.
+ *
+ * Parameters:
+ *   value: fixed-point value
+ *   bits: number of fraction bits to remove
+ *
+ * Return:
+ *   value / 2^bits, rounded towards minus infinity
+ ******************************************************************************/
+static int64_t dps3xx_shift_down(int64_t value, uint8_t bits)
+{
+    int64_t one = (int64_t)1 << bits;
+
+    return (value >= 0) ? (value / one) : (((value + 1) / one) - 1);
+}
+
+/*******************************************************************************
+ * Function Name: dps3xx_mul_scaled
+ *******************************************************************************
+ * Summary:
+ *   Multiplies a fixed-point value by a scaled raw value.
+ *
+ * Parameters:
+ *   value: fixed-point value
+ *   scaled: scaled raw value with DPS3XX_SCALED_FRACTION_BITS fraction bits
+ *
+ * Return:
+ *   product with the fraction bits of value
+ ******************************************************************************/
+static int64_t dps3xx_mul_scaled(int64_t value, int64_t scaled)
+{
+    return dps3xx_shift_down(value * scaled, DPS3XX_SCALED_FRACTION_BITS);
+}
+
+/*******************************************************************************
+ * Function Name: dps3xx_round_result
+ *******************************************************************************
+ * Summary:
+ *   Rounds a result of the polynomial to an integer.
+ *
+ * Parameters:
+ *   value: result with DPS3XX_RESULT_FRACTION_BITS fraction bits
+ *
+ * Return:
+ *   nearest integer
+ ******************************************************************************/
+static int64_t dps3xx_round_result(int64_t value)
+{
+    return dps3xx_shift_down(value + (DPS3XX_RESULT_ONE / 2), DPS3XX_RESULT_FRACTION_BITS);
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_dps_fifo_init
+ *******************************************************************************
+ * Summary:
+ *   Reads the calibration coefficients of a DPS3xx that has already been
+ *   brought up by the dps3xx library, then switches it to continuous
+ *   background measurement of pressure and temperature with the FIFO
+ *   enabled.
+ *
+ * Parameters:
+ *   dps: FIFO readout object
+ *   engine: I2C engine of the bus the DPS3xx is connected to
+ *   route: mux channel of the DPS3xx
+ *   address: I2C address of the DPS3xx
+ *
+ * Return:
+ *   Result of the I2C requests
+ ******************************************************************************/
+cy_rslt_t pasco2_dps_fifo_init(pasco2_dps_fifo_t *dps, pasco2_i2c_engine_t *engine, const pasco2_i2c_route_t *route,
+                               uint16_t address)
+{
+    static const uint8_t reg_coef = DPS3XX_REG_COEF;
+    static const uint8_t reg_coef_srce = DPS3XX_REG_COEF_SRCE;
+    static const uint8_t reg_psr = DPS3XX_REG_PSR_B2;
+
+    memset(dps, 0, sizeof(*dps));
+    dps->engine = engine;
+    dps->route = *route;
+    dps->address = address;
+
+    /* Read the coefficients and the temperature sensor they belong to */
+    uint8_t coef[DPS3XX_COEF_SIZE];
+    uint8_t coef_srce = 0U;
+    const pasco2_i2c_txn_t read_txns[] =
+    {
+        { address, &reg_coef, 1U, coef, sizeof(coef) },
+        { address, &reg_coef_srce, 1U, &coef_srce, 1U }
+    };
+    pasco2_i2c_request_t request = { .txns = read_txns, .count = 2U, .route = *route };
+
+    cy_rslt_t result = pasco2_i2c_engine_transfer(engine, &request, PASCO2_DPS_FIFO_TIMEOUT_MS);
+    if (result != CY_RSLT_SUCCESS)
+    {
+        return result;
+    }
+
+    dps->c0 = dps3xx_sign_extend(((uint32_t)coef[0] << 4) | ((uint32_t)coef[1] >> 4), 12U);
+    dps->c1 = dps3xx_sign_extend((((uint32_t)coef[1] & 0x0FU) << 8) | coef[2], 12U);
+    dps->c00 = dps3xx_sign_extend(((uint32_t)coef[3] << 12) | ((uint32_t)coef[4] << 4) | ((uint32_t)coef[5] >> 4), 20U);
+    dps->c10 = dps3xx_sign_extend((((uint32_t)coef[5] & 0x0FU) << 16) | ((uint32_t)coef[6] << 8) | coef[7], 20U);
+    dps->c01 = dps3xx_sign_extend(((uint32_t)coef[8] << 8) | coef[9], 16U);
+    dps->c11 = dps3xx_sign_extend(((uint32_t)coef[10] << 8) | coef[11], 16U);
+    dps->c20 = dps3xx_sign_extend(((uint32_t)coef[12] << 8) | coef[13], 16U);
+    dps->c21 = dps3xx_sign_extend(((uint32_t)coef[14] << 8) | coef[15], 16U);
+    dps->c30 = dps3xx_sign_extend(((uint32_t)coef[16] << 8) | coef[17], 16U);
+
+    /* Stop, flush the FIFO, configure and restart in background mode */
+    const uint8_t stop[] = { DPS3XX_REG_MEAS_CFG, 0x00U };
+    const uint8_t flush[] = { DPS3XX_REG_RESET, DPS3XX_RESET_FIFO_FLUSH };
+    const uint8_t prs_cfg[] = { DPS3XX_REG_PRS_CFG, (uint8_t)((PASCO2_DPS_FIFO_RATE << 4) | PASCO2_DPS_FIFO_PRESSURE_OVERSAMPLE) };
+    const uint8_t tmp_cfg[] = { DPS3XX_REG_TMP_CFG, (uint8_t)((coef_srce & DPS3XX_TMP_EXT_MSK) | (PASCO2_DPS_FIFO_RATE << 4)) };
+    const uint8_t cfg_reg[] = { DPS3XX_REG_CFG_REG, (uint8_t)PASCO2_DPS_FIFO_CFG_REG };
+    const uint8_t start[] = { DPS3XX_REG_MEAS_CFG, DPS3XX_MEAS_CTRL_CONT_ALL };
+    const pasco2_i2c_txn_t config_txns[] =
+    {
+        { address, stop, sizeof(stop), NULL, 0U },
+        { address, flush, sizeof(flush), NULL, 0U },
+        { address, prs_cfg, sizeof(prs_cfg), NULL, 0U },
+        { address, tmp_cfg, sizeof(tmp_cfg), NULL, 0U },
+        { address, cfg_reg, sizeof(cfg_reg), NULL, 0U },
+        { address, start, sizeof(start), NULL, 0U }
+    };
+    request = (pasco2_i2c_request_t)
+    {
+        .txns = config_txns,
+        .count = (uint8_t)(sizeof(config_txns) / sizeof(config_txns[0])),
+        .route = *route
+    };
+
+    result = pasco2_i2c_engine_transfer(engine, &request, PASCO2_DPS_FIFO_TIMEOUT_MS);
+
+    /* Every FIFO read pops one result from the PSR_B2..PSR_B0 registers */
+    for (uint8_t i = 0U; i < PASCO2_DPS_FIFO_BATCH; i++)
+    {
+        dps->txns[i] = (pasco2_i2c_txn_t){ address, &reg_psr, 1U, dps->entries[i], sizeof(dps->entries[i]) };
+    }
+
+    return result;
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_dps_fifo_drain
+ *******************************************************************************
+ * Summary:
+ *   Reads up to PASCO2_DPS_FIFO_BATCH results from the FIFO in one I2C engine
+ *   request and returns the compensated pressure and temperature of the
+ *   batch. The calculation uses integers only.
+ *
+ * Parameters:
+ *   dps: FIFO readout object
+ *   pressure: receives the mean pressure in Pa
+ *   temperature: receives the mean temperature in 0.01 degree Celsius
+ *
+ * Return:
+ *   PASCO2_DPS_FIFO_RSLT_ERR_EMPTY if the batch held no pressure or no
+ *   temperature result, otherwise the result of the I2C request
+ ******************************************************************************/
+cy_rslt_t pasco2_dps_fifo_drain(pasco2_dps_fifo_t *dps, int32_t *pressure, int16_t *temperature)
+{
+    pasco2_i2c_request_t request = { .txns = dps->txns, .count = PASCO2_DPS_FIFO_BATCH, .route = dps->route };
+
+    cy_rslt_t result = pasco2_i2c_engine_transfer(dps->engine, &request, PASCO2_DPS_FIFO_TIMEOUT_MS);
+    if (result != CY_RSLT_SUCCESS)
+    {
+        return result;
+    }
+    dps->stats.batches++;
+
+    PASCO2_PROBE_BEGIN(PASCO2_PROBE_DPS_COMPENSATE);
+
+    /* The least significant bit of a FIFO entry tells pressure (1) from
+     * temperature (0). 24-bit values of a batch cannot overflow the sums. */
+    int32_t p_sum = 0;
+    int32_t t_sum = 0;
+    uint32_t p_count = 0U;
+    uint32_t t_count = 0U;
+
+    for (uint8_t i = 0U; i < PASCO2_DPS_FIFO_BATCH; i++)
+    {
+        uint32_t raw = ((uint32_t)dps->entries[i][0] << 16) | ((uint32_t)dps->entries[i][1] << 8) | dps->entries[i][2];
+        if (raw == (uint32_t)DPS3XX_FIFO_EMPTY)
+        {
+            continue;
+        }
+
+        if ((raw & 1U) != 0U)
+        {
+            p_sum += dps3xx_sign_extend(raw & ~1UL, 24U);
+            p_count++;
+        }
+        else
+        {
+            t_sum += dps3xx_sign_extend(raw, 24U);
+            t_count++;
+        }
+    }
+
+    if ((p_count == 0U) || (t_count == 0U))
+    {
+        PASCO2_PROBE_END(PASCO2_PROBE_DPS_COMPENSATE);
+        return PASCO2_DPS_FIFO_RSLT_ERR_EMPTY;
+    }
+
+    /* Scaled means of the raw values. The polynomial is evaluated once at
+     * the means; the pressure moves by a few Pa within a batch, so the
+     * means of its powers differ from the powers of its mean by far less
+     * than 0.01 Pa. */
+    const int64_t p = ((int64_t)p_sum * DPS3XX_SCALED_ONE) /
+                      ((int64_t)p_count * dps3xx_scale_factor[PASCO2_DPS_FIFO_PRESSURE_OVERSAMPLE]);
+    const int64_t t = ((int64_t)t_sum * DPS3XX_SCALED_ONE) /
+                      ((int64_t)t_count * dps3xx_scale_factor[0]);
+
+    /* Horner scheme, pressure in Pa with DPS3XX_RESULT_FRACTION_BITS:
+     * c00 + p * (c10 + p * (c20 + p * c30)) + t * (c01 + p * (c11 + p * c21)) */
+    int64_t pa = (int64_t)dps->c30 * DPS3XX_RESULT_ONE;
+    pa = ((int64_t)dps->c20 * DPS3XX_RESULT_ONE) + dps3xx_mul_scaled(pa, p);
+    pa = ((int64_t)dps->c10 * DPS3XX_RESULT_ONE) + dps3xx_mul_scaled(pa, p);
+    pa = ((int64_t)dps->c00 * DPS3XX_RESULT_ONE) + dps3xx_mul_scaled(pa, p);
+
+    int64_t pa_t = (int64_t)dps->c21 * DPS3XX_RESULT_ONE;
+    pa_t = ((int64_t)dps->c11 * DPS3XX_RESULT_ONE) + dps3xx_mul_scaled(pa_t, p);
+    pa_t = ((int64_t)dps->c01 * DPS3XX_RESULT_ONE) + dps3xx_mul_scaled(pa_t, p);
+    pa += dps3xx_mul_scaled(pa_t, t);
+
+    /* Temperature c0 / 2 + c1 * t, in 0.01 degree Celsius */
+    int64_t centi = (int64_t)dps->c0 * 50 * DPS3XX_RESULT_ONE;
+    centi += dps3xx_mul_scaled((int64_t)dps->c1 * 100 * DPS3XX_RESULT_ONE, t);
+
+    *pressure = (int32_t)dps3xx_round_result(pa);
+    *temperature = (int16_t)dps3xx_round_result(centi);
+
+    PASCO2_PROBE_END(PASCO2_PROBE_DPS_COMPENSATE);
+
+    dps->stats.pressure_entries += p_count;
+    dps->stats.temperature_entries += t_count;
+
+    return CY_RSLT_SUCCESS;
+}
+
+/* [] END OF FILE */
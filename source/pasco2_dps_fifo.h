@@ -0,0 +1,91 @@
+/******************************************************************************
+** File name: pasco2_dps_fifo.h
+**
+** Description: This file contains the types and function prototypes of the
+**   DPS3xx background-mode FIFO readout.
+**
+** ===========================================================================
+** Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+** ===========================================================================
+**
+** ===========================================================================
+** Infineon Technologies AG (INFINEON) is supplying this file for use
+** exclusively with Infineon's sensor products. This file can be freely
+** distributed within development tools and software supporting such
+** products.
+**
+** THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+** OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+** MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+** INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+** WHATSOEVER.
+** ===========================================================================
+*/
+
+#pragma once
+
+/* Header file includes */
+#include "pasco2_i2c_engine.h"
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+/* Pressure and temperature measurement rate in background mode, 2^n per second */
+#define PASCO2_DPS_FIFO_RATE (0U)
+
+/* Pressure oversampling, 2^n. Temperature is not oversampled. */
+#define PASCO2_DPS_FIFO_PRESSURE_OVERSAMPLE (3U)
+
+/* Size of the DPS3xx result FIFO */
+#define PASCO2_DPS_FIFO_DEPTH (32U)
+
+/* Number of FIFO entries read per batch. Entries beyond the FIFO level read
+ * back as empty and are skipped. */
+#define PASCO2_DPS_FIFO_BATCH (24U)
+
+/* Result codes */
+#define PASCO2_DPS_FIFO_RSLT_ERR_EMPTY \
+    CY_RSLT_CREATE(CY_RSLT_TYPE_ERROR, CY_RSLT_MODULE_MIDDLEWARE_BASE, 0x111U)
+
+/*******************************************************************************
+ * Types
+ ******************************************************************************/
+/* Counters of the FIFO readout */
+typedef struct
+{
+    uint32_t batches;           /* FIFO drain requests */
+    uint32_t pressure_entries;  /* Pressure results averaged */
+    uint32_t temperature_entries; /* Temperature results averaged */
+} pasco2_dps_fifo_stats_t;
+
+/* DPS3xx FIFO readout object */
+typedef struct
+{
+    pasco2_i2c_engine_t *engine;
+    pasco2_i2c_route_t route;
+    uint16_t address;
+    /* Calibration coefficients */
+    int32_t c0;
+    int32_t c1;
+    int32_t c00;
+    int32_t c10;
+    int32_t c01;
+    int32_t c11;
+    int32_t c20;
+    int32_t c21;
+    int32_t c30;
+    /* Drain request, built once at initialization */
+    pasco2_i2c_txn_t txns[PASCO2_DPS_FIFO_BATCH];
+    uint8_t entries[PASCO2_DPS_FIFO_BATCH][3];
+    pasco2_dps_fifo_stats_t stats;
+} pasco2_dps_fifo_t;
+
+/*******************************************************************************
+ * Functions
+ ******************************************************************************/
+cy_rslt_t pasco2_dps_fifo_init(pasco2_dps_fifo_t *dps, pasco2_i2c_engine_t *engine, const pasco2_i2c_route_t *route,
+                               uint16_t address);
+cy_rslt_t pasco2_dps_fifo_drain(pasco2_dps_fifo_t *dps, int32_t *pressure, int16_t *temperature);
+
+/* [] END OF FILE */
@@ -0,0 +1,817 @@
+/*****************************************************************************
+** File name: pasco2_history.c
+**
+** Description: This file implements the CO2 history log: samples of one
+**   sensor node delta-coded in nibbles, in pages that rotate through the rows
+**   of a flash region and survive a reset or power loss during a write. The
+**   page decoder is in pasco2_history_cursor.c.
+**
+** ===========================================================================
+** Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+** ===========================================================================
+**
+** ===========================================================================
+** Infineon Technologies AG (INFINEON) is supplying this file for use
+** exclusively with Infineon's sensor products. This file can be freely
+** distributed within development tools and software supporting such
+** products.
+**
+** THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+** OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+** MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+** INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+** WHATSOEVER.
+** ===========================================================================
+*/
+
+/* Header file from system */
+#include <stddef.h>
+#include <string.h>
+
+/* Header file includes */
+#include "cy_pdl.h"
+
+/* Header file for local module */
+#include "pasco2_history.h"
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+/* Format identifier of the pages */
+#define PASCO2_HISTORY_MAGIC (0xC02AU)
+
+/* Nibbles of the payload */
+#define PASCO2_HISTORY_CAPACITY (PASCO2_HISTORY_PAYLOAD_SIZE * 2U)
+
+/* CRC-32 as used by IEEE 802.3 */
+#define PASCO2_HISTORY_CRC_INIT (0xFFFFFFFFUL)
+#define PASCO2_HISTORY_CRC_POLY (0xEDB88320UL)
+
+/*******************************************************************************
+ * Function Name: pasco2_history_page_crc
+ *******************************************************************************
+ * Summary:
+ *   Computes the CRC-32 of a page, from the field after the CRC to the end
+ *   of the payload.
+ *
+ * Parameters:
+ *   page: page
+ *
+ * Return:
+ *   CRC value
+ ******************************************************************************/
+static uint32_t pasco2_history_page_crc(const pasco2_history_page_t *page)
+{
+    const uint8_t *data = (const uint8_t *)page + sizeof(page->header.crc);
+    uint32_t crc = PASCO2_HISTORY_CRC_INIT;
+
+    for (size_t i = sizeof(page->header.crc); i < PASCO2_HISTORY_PAGE_SIZE; i++)
+    {
+        crc ^= *data++;
+        for (uint32_t bit = 0U; bit < 8U; bit++)
+        {
+            crc = ((crc & 1U) != 0U) ? ((crc >> 1) ^ PASCO2_HISTORY_CRC_POLY) : (crc >> 1);
+        }
+    }
+
+    return ~crc;
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_history_page_valid
+ *******************************************************************************
+ * Summary:
+ *   Checks that a page read from flash was written completely by this
+ *   format.
+ *
+ * Parameters:
+ *   page: page
+ *
+ * Return:
+ *   true if the page can be decoded
+ ******************************************************************************/
+static bool pasco2_history_page_valid(const pasco2_history_page_t *page)
+{
+    return (page->header.magic == PASCO2_HISTORY_MAGIC) && (page->header.period_s != 0U) &&
+           (page->header.nibbles <= PASCO2_HISTORY_CAPACITY) && (page->header.samples <= page->header.nibbles) &&
+           (page->header.crc == pasco2_history_page_crc(page));
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_history_row_blank
+ *******************************************************************************
+ * Summary:
+ *   Checks whether a row is erased.
+ *
+ * Parameters:
+ *   page: content of the row
+ *   erase_value: value of an erased byte
+ *
+ * Return:
+ *   true if every byte is erased
+ ******************************************************************************/
+static bool pasco2_history_row_blank(const pasco2_history_page_t *page, uint8_t erase_value)
+{
+    const uint8_t *data = (const uint8_t *)page;
+
+    for (size_t i = 0U; i < PASCO2_HISTORY_PAGE_SIZE; i++)
+    {
+        if (data[i] != erase_value)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_history_put
+ *******************************************************************************
+ * Summary:
+ *   Appends nibbles to the payload of the open page, low nibble first.
+ *
+ * Parameters:
+ *   page: open page with room for the nibbles
+ *   value: value to append
+ *   nibbles: number of nibbles
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+static void pasco2_history_put(pasco2_history_page_t *page, uint32_t value, uint32_t nibbles)
+{
+    for (uint32_t i = 0U; i < nibbles; i++)
+    {
+        uint8_t *byte = &page->payload[page->header.nibbles / 2U];
+        uint8_t nibble = (uint8_t)((value >> (4U * i)) & 0x0FU);
+
+        if ((page->header.nibbles & 1U) == 0U)
+        {
+            *byte = nibble;
+        }
+        else
+        {
+            *byte |= (uint8_t)(nibble << 4);
+        }
+        page->header.nibbles++;
+    }
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_history_varint_nibbles
+ *******************************************************************************
+ * Summary:
+ *   Returns the length of a value coded as varint of 3-bit groups.
+ *
+ * Parameters:
+ *   value: value
+ *
+ * Return:
+ *   number of nibbles
+ ******************************************************************************/
+static uint32_t pasco2_history_varint_nibbles(uint32_t value)
+{
+    uint32_t nibbles = 1U;
+
+    while (value >= 8U)
+    {
+        value >>= 3;
+        nibbles++;
+    }
+
+    return nibbles;
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_history_update_stats
+ *******************************************************************************
+ * Summary:
+ *   Refreshes the counters that describe the content of the log.
+ *
+ * Parameters:
+ *   history: history log
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+static void pasco2_history_update_stats(pasco2_history_t *history)
+{
+    history->stats.samples = history->slot_samples + history->page.header.samples;
+    history->stats.pending = history->pending;
+    history->stats.bytes = (history->slot_nibbles + history->page.header.nibbles + 1U) / 2U;
+    history->stats.pages = pasco2_history_page_count(history);
+    history->stats.boot = history->boot;
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_history_drop_slot
+ *******************************************************************************
+ * Summary:
+ *   Removes a finished page from the log.
+ *
+ * Parameters:
+ *   history: history log
+ *   index: index of the slot
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+static void pasco2_history_drop_slot(pasco2_history_t *history, uint16_t index)
+{
+    history->slot_samples -= history->slots[index].samples;
+    history->slot_nibbles -= history->slots[index].nibbles;
+    history->slot_count--;
+    memmove(&history->slots[index], &history->slots[index + 1U],
+            (size_t)(history->slot_count - index) * sizeof(history->slots[0]));
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_history_start_page
+ *******************************************************************************
+ * Summary:
+ *   Opens an empty page. The next sample starts with a keyframe.
+ *
+ * Parameters:
+ *   history: history log
+ *   home: row of the first commit
+ *   sequence: page number
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+static void pasco2_history_start_page(pasco2_history_t *history, uint16_t home, uint32_t sequence)
+{
+    memset(&history->page, 0, sizeof(history->page));
+    history->page.header.sequence = sequence;
+    history->page.header.magic = PASCO2_HISTORY_MAGIC;
+    history->page.header.period_s = PASCO2_HISTORY_PERIOD_S;
+    history->page.header.boot = history->boot;
+    history->home = home;
+    history->pending = 0U;
+    history->anchored = false;
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_history_commit
+ *******************************************************************************
+ * Summary:
+ *   Writes the open page to flash. Commits alternate between the home row
+ *   and the row after it, the previous commit stays intact until this one
+ *   has completed. A finished page in the target row leaves the log.
+ *
+ * Parameters:
+ *   history: history log
+ *
+ * Return:
+ *   result of the flash write
+ ******************************************************************************/
+static cy_rslt_t pasco2_history_commit(pasco2_history_t *history)
+{
+    pasco2_history_page_t *page = &history->page;
+    uint16_t row = (uint16_t)((history->home + (page->header.commit & 1U)) % history->rows);
+
+    for (uint16_t i = 0U; i < history->slot_count; i++)
+    {
+        if (history->slots[i].row == row)
+        {
+            pasco2_history_drop_slot(history, i);
+            break;
+        }
+    }
+
+    page->header.boot = history->boot;
+    page->header.crc = pasco2_history_page_crc(page);
+    cy_rslt_t result = cyhal_flash_write(history->flash, history->address + ((uint32_t)row * PASCO2_HISTORY_PAGE_SIZE),
+                                         (const uint32_t *)page);
+    if (result != CY_RSLT_SUCCESS)
+    {
+        /* The commit is repeated into the same row */
+        history->stats.write_errors++;
+        pasco2_history_update_stats(history);
+        return result;
+    }
+
+    history->last_row = row;
+    page->header.commit++;
+    history->pending = 0U;
+    history->stats.commits++;
+    pasco2_history_update_stats(history);
+
+    return CY_RSLT_SUCCESS;
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_history_finish_page
+ *******************************************************************************
+ * Summary:
+ *   Commits the open page for the last time, keeps it in the slots, and opens
+ *   the next page in the row after it. Every page thus takes one row.
+ *
+ * Parameters:
+ *   history: history log
+ *
+ * Return:
+ *   result of the flash write
+ ******************************************************************************/
+static cy_rslt_t pasco2_history_finish_page(pasco2_history_t *history)
+{
+    /* The last commit goes to the home row, so the next page can start in
+     * the row after it. A commit into the other row is repeated for that. */
+    while ((history->pending > 0U) || (history->last_row != history->home))
+    {
+        cy_rslt_t result = pasco2_history_commit(history);
+        if (result != CY_RSLT_SUCCESS)
+        {
+            return result;
+        }
+    }
+
+    CY_ASSERT(history->slot_count < PASCO2_HISTORY_MAX_ROWS);
+    pasco2_history_slot_t *slot = &history->slots[history->slot_count++];
+    slot->sequence = history->page.header.sequence;
+    slot->row = history->last_row;
+    slot->commit = (uint16_t)(history->page.header.commit - 1U);
+    slot->nibbles = history->page.header.nibbles;
+    slot->samples = history->page.header.samples;
+    history->slot_samples += slot->samples;
+    history->slot_nibbles += slot->nibbles;
+
+    pasco2_history_start_page(history, (uint16_t)((history->last_row + 1U) % history->rows), slot->sequence + 1U);
+    pasco2_history_update_stats(history);
+
+    return CY_RSLT_SUCCESS;
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_history_append
+ *******************************************************************************
+ * Summary:
+ *   Appends a sample to the open page. A keyframe is written at the start of
+ *   a page, after a gap, and at the keyframe interval; otherwise the
+ *   difference to the previous sample. A page that has no room left is
+ *   finished first. The page is committed every PASCO2_HISTORY_COMMIT_SAMPLES
+ *   samples.
+ *
+ * Parameters:
+ *   history: history log
+ *   index: interval of the sample since start-up
+ *   ppm: mean CO2 concentration over the interval
+ *
+ * Return:
+ *   result of the flash write, the sample is dropped if the full page could
+ *   not be written
+ ******************************************************************************/
+static cy_rslt_t pasco2_history_append(pasco2_history_t *history, uint32_t index, uint16_t ppm)
+{
+    pasco2_history_page_t *page = &history->page;
+    int32_t delta = (int32_t)ppm - (int32_t)history->last_ppm;
+    uint32_t zigzag = (delta >= 0) ? ((uint32_t)delta * 2U) : (((uint32_t)(-(delta + 1)) * 2U) + 1U);
+    bool keyframe = !history->anchored || (index != (history->last_index + 1U)) ||
+                    (history->since_keyframe >= PASCO2_HISTORY_KEYFRAME_SAMPLES);
+    uint32_t nibbles = keyframe ? PASCO2_HISTORY_KEYFRAME_NIBBLES :
+                       (zigzag < PASCO2_HISTORY_SYMBOL_ESCAPE) ? 1U :
+                       (1U + pasco2_history_varint_nibbles(zigzag - PASCO2_HISTORY_SYMBOL_ESCAPE));
+
+    if ((page->header.nibbles + nibbles) > PASCO2_HISTORY_CAPACITY)
+    {
+        cy_rslt_t result = pasco2_history_finish_page(history);
+        if (result != CY_RSLT_SUCCESS)
+        {
+            return result;
+        }
+        keyframe = true;
+    }
+
+    if (keyframe)
+    {
+        pasco2_history_put(page, PASCO2_HISTORY_SYMBOL_KEYFRAME, 1U);
+        pasco2_history_put(page, history->boot, PASCO2_HISTORY_BOOT_NIBBLES);
+        pasco2_history_put(page, index * PASCO2_HISTORY_PERIOD_S, PASCO2_HISTORY_TIME_NIBBLES);
+        pasco2_history_put(page, ppm, PASCO2_HISTORY_PPM_NIBBLES);
+        history->anchored = true;
+        history->since_keyframe = 0U;
+    }
+    else if (zigzag < PASCO2_HISTORY_SYMBOL_ESCAPE)
+    {
+        pasco2_history_put(page, zigzag, 1U);
+    }
+    else
+    {
+        uint32_t value = zigzag - PASCO2_HISTORY_SYMBOL_ESCAPE;
+
+        pasco2_history_put(page, PASCO2_HISTORY_SYMBOL_ESCAPE, 1U);
+        while (value >= 8U)
+        {
+            pasco2_history_put(page, (value & 0x07U) | 0x08U, 1U);
+            value >>= 3;
+        }
+        pasco2_history_put(page, value, 1U);
+    }
+
+    page->header.samples++;
+    history->since_keyframe++;
+    history->last_ppm = ppm;
+    history->last_index = index;
+    history->pending++;
+
+    if (history->pending >= PASCO2_HISTORY_COMMIT_SAMPLES)
+    {
+        return pasco2_history_commit(history);
+    }
+    pasco2_history_update_stats(history);
+
+    return CY_RSLT_SUCCESS;
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_history_open
+ *******************************************************************************
+ * Summary:
+ *   Scans the rows of the log and rebuilds its state. Of every page the copy
+ *   with the highest commit count is kept, rows with a bad checksum are
+ *   skipped. The newest page is continued if it has room for a keyframe,
+ *   otherwise a new page follows it. The boot count is increased by one.
+ *
+ * Parameters:
+ *   history: history log
+ *   flash: initialized flash object
+ *   address: start of the log, aligned to a row
+ *   rows: number of rows of the log, at least three
+ *
+ * Return:
+ *   CY_RSLT_SUCCESS, PASCO2_HISTORY_RSLT_ERR_FLASH if the rows are not part
+ *   of one flash block with pages of PASCO2_HISTORY_PAGE_SIZE bytes, or the
+ *   result of a flash read
+ ******************************************************************************/
+cy_rslt_t pasco2_history_open(pasco2_history_t *history, cyhal_flash_t *flash, uint32_t address, uint16_t rows)
+{
+    CY_ASSERT((rows >= 3U) && (rows <= PASCO2_HISTORY_MAX_ROWS));
+
+    memset(history, 0, sizeof(*history));
+    history->flash = flash;
+    history->address = address;
+    history->rows = rows;
+    history->stats.rows = rows;
+
+    cyhal_flash_info_t info;
+    const cyhal_flash_block_info_t *block = NULL;
+    cyhal_flash_get_info(flash, &info);
+    for (uint8_t i = 0U; i < info.block_count; i++)
+    {
+        const cyhal_flash_block_info_t *candidate = &info.blocks[i];
+        if ((address >= candidate->start_address) &&
+            (((address - candidate->start_address) + ((uint32_t)rows * PASCO2_HISTORY_PAGE_SIZE)) <= candidate->size))
+        {
+            block = candidate;
+        }
+    }
+    if ((block == NULL) || (block->page_size != PASCO2_HISTORY_PAGE_SIZE) ||
+        (((address - block->start_address) % PASCO2_HISTORY_PAGE_SIZE) != 0U))
+    {
+        return PASCO2_HISTORY_RSLT_ERR_FLASH;
+    }
+
+    /* Keep the latest copy of every page */
+    uint16_t boot = 0U;
+    for (uint16_t row = 0U; row < rows; row++)
+    {
+        const pasco2_history_header_t *header = &history->page.header;
+        cy_rslt_t result = cyhal_flash_read(flash, address + ((uint32_t)row * PASCO2_HISTORY_PAGE_SIZE),
+                                            (uint8_t *)&history->page, PASCO2_HISTORY_PAGE_SIZE);
+        if (result != CY_RSLT_SUCCESS)
+        {
+            return result;
+        }
+        if (!pasco2_history_page_valid(&history->page))
+        {
+            if (!pasco2_history_row_blank(&history->page, block->erase_value))
+            {
+                history->stats.rejected_rows++;
+            }
+            continue;
+        }
+        if (header->boot > boot)
+        {
+            boot = header->boot;
+        }
+
+        uint16_t index = 0U;
+        while ((index < history->slot_count) && (history->slots[index].sequence != header->sequence))
+        {
+            index++;
+        }
+        if ((index < history->slot_count) && (history->slots[index].commit >= header->commit))
+        {
+            continue;
+        }
+        history->slots[index] = (pasco2_history_slot_t)
+        {
+            .sequence = header->sequence,
+            .row = row,
+            .commit = header->commit,
+            .nibbles = header->nibbles,
+            .samples = header->samples
+        };
+        if (index == history->slot_count)
+        {
+            history->slot_count++;
+        }
+    }
+
+    /* Oldest page first */
+    for (uint16_t i = 1U; i < history->slot_count; i++)
+    {
+        pasco2_history_slot_t slot = history->slots[i];
+        uint16_t j = i;
+        while ((j > 0U) && (history->slots[j - 1U].sequence > slot.sequence))
+        {
+            history->slots[j] = history->slots[j - 1U];
+            j--;
+        }
+        history->slots[j] = slot;
+    }
+    for (uint16_t i = 0U; i < history->slot_count; i++)
+    {
+        history->slot_samples += history->slots[i].samples;
+        history->slot_nibbles += history->slots[i].nibbles;
+    }
+
+    if (history->slot_count == 0U)
+    {
+        pasco2_history_start_page(history, 0U, 0U);
+    }
+    else
+    {
+        history->boot = (uint16_t)(boot + 1U);
+
+        const pasco2_history_slot_t *latest = &history->slots[history->slot_count - 1U];
+        cy_rslt_t result = cyhal_flash_read(flash, address + ((uint32_t)latest->row * PASCO2_HISTORY_PAGE_SIZE),
+                                            (uint8_t *)&history->page, PASCO2_HISTORY_PAGE_SIZE);
+        if (result != CY_RSLT_SUCCESS)
+        {
+            return result;
+        }
+
+        if ((history->page.header.period_s == PASCO2_HISTORY_PERIOD_S) &&
+            ((PASCO2_HISTORY_CAPACITY - history->page.header.nibbles) >= PASCO2_HISTORY_KEYFRAME_NIBBLES))
+        {
+            /* Continue the page, the next commit goes to the other row of its pair */
+            history->home = (uint16_t)((latest->row + rows - (latest->commit & 1U)) % rows);
+            history->last_row = latest->row;
+            history->page.header.commit = (uint16_t)(latest->commit + 1U);
+            history->anchored = false;
+            pasco2_history_drop_slot(history, (uint16_t)(history->slot_count - 1U));
+        }
+        else
+        {
+            pasco2_history_start_page(history, (uint16_t)((latest->row + 1U) % rows), latest->sequence + 1U);
+        }
+    }
+    pasco2_history_update_stats(history);
+
+    return CY_RSLT_SUCCESS;
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_history_add
+ *******************************************************************************
+ * Summary:
+ *   Accumulates a reading into the current interval. When a reading falls
+ *   into a later interval, the mean of the finished one is appended to the
+ *   log; intervals without readings leave a gap.
+ *
+ * Parameters:
+ *   history: history log
+ *   tick: time of the reading in ms
+ *   ppm: CO2 concentration
+ *
+ * Return:
+ *   result of the flash write, if one was due
+ ******************************************************************************/
+cy_rslt_t pasco2_history_add(pasco2_history_t *history, uint32_t tick, uint16_t ppm)
+{
+    const uint32_t period_ms = PASCO2_HISTORY_PERIOD_S * 1000U;
+    cy_rslt_t result = CY_RSLT_SUCCESS;
+
+    /* Readers retry while the version is odd or has changed */
+    history->version++;
+    __DMB();
+
+    if (!history->started)
+    {
+        history->started = true;
+        history->period_index = tick / period_ms;
+        history->period_tick = tick - (tick % period_ms);
+    }
+
+    uint32_t elapsed = tick - history->period_tick;
+    if (elapsed >= period_ms)
+    {
+        if (history->count > 0U)
+        {
+            result = pasco2_history_append(history, history->period_index,
+                                           (uint16_t)((history->sum + (history->count / 2U)) / history->count));
+        }
+
+        uint32_t periods = elapsed / period_ms;
+        history->period_index += periods;
+        history->period_tick += periods * period_ms;
+        history->sum = 0U;
+        history->count = 0U;
+    }
+
+    history->sum += ppm;
+    history->count++;
+
+    __DMB();
+    history->version++;
+
+    return result;
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_history_flush
+ *******************************************************************************
+ * Summary:
+ *   Writes the samples appended since the last commit to flash. The interval
+ *   in progress is not part of them.
+ *
+ * Parameters:
+ *   history: history log
+ *
+ * Return:
+ *   result of the flash write
+ ******************************************************************************/
+cy_rslt_t pasco2_history_flush(pasco2_history_t *history)
+{
+    cy_rslt_t result = CY_RSLT_SUCCESS;
+
+    if (history->pending > 0U)
+    {
+        history->version++;
+        __DMB();
+        result = pasco2_history_commit(history);
+        __DMB();
+        history->version++;
+    }
+
+    return result;
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_history_get_stats
+ *******************************************************************************
+ * Summary:
+ *   Returns a copy of the counters of the log.
+ *
+ * Parameters:
+ *   history: history log
+ *   stats: destination of the counters
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+void pasco2_history_get_stats(const pasco2_history_t *history, pasco2_history_stats_t *stats)
+{
+    *stats = history->stats;
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_history_page_count
+ *******************************************************************************
+ * Summary:
+ *   Returns the number of pages holding samples, including the open page.
+ *
+ * Parameters:
+ *   history: history log
+ *
+ * Return:
+ *   number of pages
+ ******************************************************************************/
+uint16_t pasco2_history_page_count(const pasco2_history_t *history)
+{
+    return (uint16_t)(history->slot_count + ((history->page.header.samples > 0U) ? 1U : 0U));
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_history_read_slot
+ *******************************************************************************
+ * Summary:
+ *   Reads a finished page from its row and checks that the row still holds
+ *   it.
+ *
+ * Parameters:
+ *   history: history log
+ *   slot: slot of the page
+ *   page: destination of the page
+ *
+ * Return:
+ *   CY_RSLT_SUCCESS, PASCO2_HISTORY_RSLT_ERR_PAGE if the row does not hold the
+ *   page anymore, or the result of the flash read
+ ******************************************************************************/
+static cy_rslt_t pasco2_history_read_slot(const pasco2_history_t *history, pasco2_history_slot_t slot,
+                                          pasco2_history_page_t *page)
+{
+    cy_rslt_t result = cyhal_flash_read(history->flash,
+                                        history->address + ((uint32_t)slot.row * PASCO2_HISTORY_PAGE_SIZE),
+                                        (uint8_t *)page, PASCO2_HISTORY_PAGE_SIZE);
+    if ((result == CY_RSLT_SUCCESS) &&
+        (!pasco2_history_page_valid(page) || (page->header.sequence != slot.sequence)))
+    {
+        result = PASCO2_HISTORY_RSLT_ERR_PAGE;
+    }
+
+    return result;
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_history_read_page
+ *******************************************************************************
+ * Summary:
+ *   Reads a page of the log. Finished pages are read from flash and checked,
+ *   the open page is copied including the samples not yet committed.
+ *
+ * Parameters:
+ *   history: history log
+ *   index: index of the page, 0 is the oldest
+ *   page: destination of the page
+ *
+ * Return:
+ *   CY_RSLT_SUCCESS, PASCO2_HISTORY_RSLT_ERR_PAGE if the row does not hold the
+ *   page anymore, or the result of the flash read
+ ******************************************************************************/
+cy_rslt_t pasco2_history_read_page(const pasco2_history_t *history, uint16_t index, pasco2_history_page_t *page)
+{
+    CY_ASSERT(index < pasco2_history_page_count(history));
+
+    if (index == history->slot_count)
+    {
+        *page = history->page;
+        return CY_RSLT_SUCCESS;
+    }
+
+    return pasco2_history_read_slot(history, history->slots[index], page);
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_history_read_next
+ *******************************************************************************
+ * Summary:
+ *   Reads the oldest page whose sequence number is not below the given one.
+ *   May be called from another task while the owner keeps adding samples;
+ *   it never blocks the owner.
+ *
+ * Parameters:
+ *   history: history log
+ *   sequence: smallest sequence number on entry, sequence number of the page
+ *             on return
+ *   page: destination of the page
+ *
+ * Return:
+ *   CY_RSLT_SUCCESS, PASCO2_HISTORY_RSLT_ERR_END if there is no such page,
+ *   PASCO2_HISTORY_RSLT_ERR_BUSY if the owner changed the log meanwhile and
+ *   the read has to be repeated, PASCO2_HISTORY_RSLT_ERR_PAGE if the row of
+ *   the page is corrupt, or the result of the flash read
+ ******************************************************************************/
+cy_rslt_t pasco2_history_read_next(const pasco2_history_t *history, uint32_t *sequence, pasco2_history_page_t *page)
+{
+    uint32_t version = history->version;
+    cy_rslt_t result = PASCO2_HISTORY_RSLT_ERR_END;
+
+    if ((version & 1U) != 0U)
+    {
+        return PASCO2_HISTORY_RSLT_ERR_BUSY;
+    }
+    __DMB();
+
+    /* The slot table may change under the reader, so its bounds are checked
+     * here instead of asserted; the version check below discards the result */
+    uint16_t slot_count = history->slot_count;
+    uint16_t index = 0U;
+    while ((index < slot_count) && (index < PASCO2_HISTORY_MAX_ROWS) && (history->slots[index].sequence < *sequence))
+    {
+        index++;
+    }
+
+    if ((index < slot_count) && (index < PASCO2_HISTORY_MAX_ROWS))
+    {
+        pasco2_history_slot_t slot = history->slots[index];
+
+        *sequence = slot.sequence;
+        result = (slot.row < history->rows) ? pasco2_history_read_slot(history, slot, page)
+                                            : PASCO2_HISTORY_RSLT_ERR_BUSY;
+    }
+    else if ((history->page.header.samples > 0U) && (history->page.header.sequence >= *sequence))
+    {
+        *sequence = history->page.header.sequence;
+        *page = history->page;
+        result = CY_RSLT_SUCCESS;
+    }
+
+    __DMB();
+    return (history->version == version) ? result : PASCO2_HISTORY_RSLT_ERR_BUSY;
+}
+
+/* [] END OF FILE */
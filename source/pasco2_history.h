@@ -0,0 +1,195 @@
+/******************************************************************************
+** File name: pasco2_history.h
+**
+** Description: This file contains the types and function prototypes of the
+**   CO2 history log in internal flash.
+**
+** ===========================================================================
+** Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+** ===========================================================================
+**
+** ===========================================================================
+** Infineon Technologies AG (INFINEON) is supplying this file for use
+** exclusively with Infineon's sensor products. This file can be freely
+** distributed within development tools and software supporting such
+** products.
+**
+** THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+** OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+** MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+** INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+** WHATSOEVER.
+** ===========================================================================
+*/
+
+#pragma once
+
+/* Header file includes */
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "cyhal.h"
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+/* Interval of the history samples in seconds. A sample is the mean of the
+ * readings within its interval. */
+#define PASCO2_HISTORY_PERIOD_S (60U)
+
+/* Samples appended to the open page before it is written to flash. Samples
+ * that are not written yet are lost on a reset. */
+#define PASCO2_HISTORY_COMMIT_SAMPLES (10U)
+
+/* Samples after which a keyframe is inserted even without a gap */
+#define PASCO2_HISTORY_KEYFRAME_SAMPLES (240U)
+
+/* Size of a page, one flash row */
+#define PASCO2_HISTORY_PAGE_SIZE (512U)
+
+/* Largest number of rows the log can use */
+#define PASCO2_HISTORY_MAX_ROWS (64U)
+
+/* Page header and payload sizes, the payload holds nibbles */
+#define PASCO2_HISTORY_HEADER_SIZE  (20U)
+#define PASCO2_HISTORY_PAYLOAD_SIZE (PASCO2_HISTORY_PAGE_SIZE - PASCO2_HISTORY_HEADER_SIZE)
+
+/* Payload symbols. A nibble below the escape symbol is the zigzag-coded
+ * difference to the previous sample, one interval later. The escape symbol
+ * is followed by the zigzag-coded difference minus the escape value as a
+ * varint of 3-bit groups, low group first, with bit 3 set on all groups but
+ * the last. The keyframe symbol is followed by the boot count, the time in
+ * seconds and the value, each in fixed width with the low nibble first. */
+#define PASCO2_HISTORY_SYMBOL_ESCAPE    (14U)
+#define PASCO2_HISTORY_SYMBOL_KEYFRAME  (15U)
+#define PASCO2_HISTORY_BOOT_NIBBLES     (4U)
+#define PASCO2_HISTORY_TIME_NIBBLES     (8U)
+#define PASCO2_HISTORY_PPM_NIBBLES      (4U)
+#define PASCO2_HISTORY_KEYFRAME_NIBBLES (1U + PASCO2_HISTORY_BOOT_NIBBLES + PASCO2_HISTORY_TIME_NIBBLES + \
+                                         PASCO2_HISTORY_PPM_NIBBLES)
+
+/* Result codes */
+#define PASCO2_HISTORY_RSLT_ERR_FLASH \
+    CY_RSLT_CREATE(CY_RSLT_TYPE_ERROR, CY_RSLT_MODULE_MIDDLEWARE_BASE, 0x121U)
+#define PASCO2_HISTORY_RSLT_ERR_PAGE \
+    CY_RSLT_CREATE(CY_RSLT_TYPE_ERROR, CY_RSLT_MODULE_MIDDLEWARE_BASE, 0x122U)
+#define PASCO2_HISTORY_RSLT_ERR_END \
+    CY_RSLT_CREATE(CY_RSLT_TYPE_ERROR, CY_RSLT_MODULE_MIDDLEWARE_BASE, 0x123U)
+#define PASCO2_HISTORY_RSLT_ERR_BUSY \
+    CY_RSLT_CREATE(CY_RSLT_TYPE_ERROR, CY_RSLT_MODULE_MIDDLEWARE_BASE, 0x124U)
+
+/*******************************************************************************
+ * Types
+ ******************************************************************************/
+/* Page header, written with every commit of the page */
+typedef struct
+{
+    uint32_t crc;               /* CRC-32 of the rest of the page */
+    uint32_t sequence;          /* Page number, counts up over the life of the log */
+    uint16_t magic;             /* Format identifier */
+    uint16_t period_s;          /* Interval of the samples in seconds */
+    uint16_t boot;              /* Start-up count at the time of the commit */
+    uint16_t commit;            /* Commit count of the page, selects its row */
+    uint16_t nibbles;           /* Payload nibbles in use */
+    uint16_t samples;           /* Samples in the payload */
+} pasco2_history_header_t;
+
+/* Page as stored in a flash row */
+typedef struct
+{
+    pasco2_history_header_t header;
+    uint8_t payload[PASCO2_HISTORY_PAYLOAD_SIZE];
+} pasco2_history_page_t;
+
+/* Page held in a row of the log */
+typedef struct
+{
+    uint32_t sequence;
+    uint16_t row;
+    uint16_t commit;
+    uint16_t nibbles;
+    uint16_t samples;
+} pasco2_history_slot_t;
+
+/* Counters of the log */
+typedef struct
+{
+    uint32_t samples;           /* Samples in the log */
+    uint32_t pending;           /* Samples not yet written to flash */
+    uint32_t bytes;             /* Payload bytes in use */
+    uint16_t pages;             /* Pages in use, including the open one */
+    uint16_t rows;              /* Rows of the log */
+    uint16_t boot;              /* Start-up count */
+    uint16_t rejected_rows;     /* Rows discarded at start-up, torn or corrupt */
+    uint32_t commits;           /* Page writes since start-up */
+    uint32_t write_errors;      /* Page writes that failed */
+} pasco2_history_stats_t;
+
+/* History log. Finished pages are kept in the slots, oldest first; the open
+ * page alternates between its home row and the next one, so a torn write
+ * never destroys the previous commit. */
+typedef struct
+{
+    volatile uint32_t version;  /* Odd while an update is in progress */
+    cyhal_flash_t *flash;
+    uint32_t address;
+    uint16_t rows;
+    uint16_t boot;
+    pasco2_history_slot_t slots[PASCO2_HISTORY_MAX_ROWS];
+    uint16_t slot_count;
+    uint32_t slot_samples;      /* Samples of the finished pages */
+    uint32_t slot_nibbles;      /* Payload nibbles of the finished pages */
+    /* Open page */
+    pasco2_history_page_t page;
+    uint16_t home;              /* Row of the even commits */
+    uint16_t last_row;          /* Row of the latest commit */
+    uint16_t pending;           /* Samples appended since the latest commit */
+    /* Encoder state */
+    bool anchored;              /* A keyframe precedes the next sample */
+    uint16_t last_ppm;
+    uint32_t last_index;
+    uint16_t since_keyframe;
+    /* Interval accumulator */
+    bool started;
+    uint32_t period_tick;       /* Start of the current interval in ms */
+    uint32_t period_index;      /* Intervals since start-up */
+    uint32_t sum;
+    uint16_t count;
+    pasco2_history_stats_t stats;
+} pasco2_history_t;
+
+/* Decoded sample. The time counts from the start-up given by the boot count. */
+typedef struct
+{
+    uint16_t boot;              /* Start-up count */
+    uint32_t time_s;            /* Start of the interval in seconds since start-up */
+    uint16_t ppm;               /* Mean CO2 concentration over the interval */
+} pasco2_history_record_t;
+
+/* Position within a page */
+typedef struct
+{
+    const pasco2_history_page_t *page;
+    uint16_t position;
+    bool anchored;
+    pasco2_history_record_t record;
+} pasco2_history_cursor_t;
+
+/*******************************************************************************
+ * Functions
+ ******************************************************************************/
+cy_rslt_t pasco2_history_open(pasco2_history_t *history, cyhal_flash_t *flash, uint32_t address, uint16_t rows);
+cy_rslt_t pasco2_history_add(pasco2_history_t *history, uint32_t tick, uint16_t ppm);
+cy_rslt_t pasco2_history_flush(pasco2_history_t *history);
+void pasco2_history_get_stats(const pasco2_history_t *history, pasco2_history_stats_t *stats);
+uint16_t pasco2_history_page_count(const pasco2_history_t *history);
+cy_rslt_t pasco2_history_read_page(const pasco2_history_t *history, uint16_t index, pasco2_history_page_t *page);
+cy_rslt_t pasco2_history_read_next(const pasco2_history_t *history, uint32_t *sequence, pasco2_history_page_t *page);
+void pasco2_history_cursor_init(pasco2_history_cursor_t *cursor, const pasco2_history_page_t *page);
+bool pasco2_history_cursor_next(pasco2_history_cursor_t *cursor, pasco2_history_record_t *record);
+bool pasco2_history_page_span(const pasco2_history_page_t *page, pasco2_history_record_t *first,
+                              pasco2_history_record_t *last);
+int32_t pasco2_history_record_compare(const pasco2_history_record_t *a, const pasco2_history_record_t *b);
+
+/* [] END OF FILE */
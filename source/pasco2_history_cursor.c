@@ -0,0 +1,221 @@
+/*****************************************************************************
+** File name: pasco2_history_cursor.c
+**
+** Description: This file implements the decoder of the CO2 history pages. It
+**   has no hardware dependencies and is shared with the host tools.
+**
+** ===========================================================================
+** Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+** ===========================================================================
+**
+** ===========================================================================
+** Infineon Technologies AG (INFINEON) is supplying this file for use
+** exclusively with Infineon's sensor products. This file can be freely
+** distributed within development tools and software supporting such
+** products.
+**
+** THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+** OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+** MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+** INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+** WHATSOEVER.
+** ===========================================================================
+*/
+
+/* Header file from system */
+#include <string.h>
+
+/* Header file for local module */
+#include "pasco2_history.h"
+
+/*******************************************************************************
+ * Function Name: pasco2_history_cursor_init
+ *******************************************************************************
+ * Summary:
+ *   Positions a cursor at the first sample of a page.
+ *
+ * Parameters:
+ *   cursor: cursor
+ *   page: page to decode, must stay valid while the cursor is used
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+void pasco2_history_cursor_init(pasco2_history_cursor_t *cursor, const pasco2_history_page_t *page)
+{
+    memset(cursor, 0, sizeof(*cursor));
+    cursor->page = page;
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_history_cursor_take
+ *******************************************************************************
+ * Summary:
+ *   Reads nibbles from the payload, low nibble first.
+ *
+ * Parameters:
+ *   cursor: cursor
+ *   nibbles: number of nibbles
+ *   value: destination of the value
+ *
+ * Return:
+ *   false if the payload ends before
+ ******************************************************************************/
+static bool pasco2_history_cursor_take(pasco2_history_cursor_t *cursor, uint32_t nibbles, uint32_t *value)
+{
+    const pasco2_history_page_t *page = cursor->page;
+
+    if ((cursor->position + nibbles) > page->header.nibbles)
+    {
+        return false;
+    }
+
+    *value = 0U;
+    for (uint32_t i = 0U; i < nibbles; i++)
+    {
+        uint8_t byte = page->payload[cursor->position / 2U];
+        uint32_t nibble = ((cursor->position & 1U) == 0U) ? (byte & 0x0FU) : (uint32_t)(byte >> 4);
+
+        *value |= nibble << (4U * i);
+        cursor->position++;
+    }
+
+    return true;
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_history_cursor_next
+ *******************************************************************************
+ * Summary:
+ *   Decodes the next sample of a page.
+ *
+ * Parameters:
+ *   cursor: cursor
+ *   record: destination of the sample
+ *
+ * Return:
+ *   false at the end of the page or if the payload is malformed
+ ******************************************************************************/
+bool pasco2_history_cursor_next(pasco2_history_cursor_t *cursor, pasco2_history_record_t *record)
+{
+    uint32_t symbol;
+
+    if (!pasco2_history_cursor_take(cursor, 1U, &symbol))
+    {
+        return false;
+    }
+
+    if (symbol == PASCO2_HISTORY_SYMBOL_KEYFRAME)
+    {
+        uint32_t boot;
+        uint32_t time_s;
+        uint32_t ppm;
+
+        if (!pasco2_history_cursor_take(cursor, PASCO2_HISTORY_BOOT_NIBBLES, &boot) ||
+            !pasco2_history_cursor_take(cursor, PASCO2_HISTORY_TIME_NIBBLES, &time_s) ||
+            !pasco2_history_cursor_take(cursor, PASCO2_HISTORY_PPM_NIBBLES, &ppm))
+        {
+            return false;
+        }
+        cursor->record.boot = (uint16_t)boot;
+        cursor->record.time_s = time_s;
+        cursor->record.ppm = (uint16_t)ppm;
+        cursor->anchored = true;
+    }
+    else
+    {
+        uint32_t zigzag = symbol;
+
+        if (!cursor->anchored)
+        {
+            return false;
+        }
+        if (symbol == PASCO2_HISTORY_SYMBOL_ESCAPE)
+        {
+            uint32_t group;
+            uint32_t shift = 0U;
+
+            zigzag = 0U;
+            do
+            {
+                if ((shift > 15U) || !pasco2_history_cursor_take(cursor, 1U, &group))
+                {
+                    return false;
+                }
+                zigzag |= (group & 0x07U) << shift;
+                shift += 3U;
+            } while ((group & 0x08U) != 0U);
+            zigzag += PASCO2_HISTORY_SYMBOL_ESCAPE;
+        }
+
+        int32_t delta = ((zigzag & 1U) != 0U) ? (-(int32_t)(zigzag / 2U) - 1) : (int32_t)(zigzag / 2U);
+        cursor->record.ppm = (uint16_t)((int32_t)cursor->record.ppm + delta);
+        cursor->record.time_s += cursor->page->header.period_s;
+    }
+
+    *record = cursor->record;
+    return true;
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_history_page_span
+ *******************************************************************************
+ * Summary:
+ *   Decodes a page and returns its first and last sample.
+ *
+ * Parameters:
+ *   page: page
+ *   first: destination of the first sample
+ *   last: destination of the last sample
+ *
+ * Return:
+ *   false if the page holds no samples or is malformed
+ ******************************************************************************/
+bool pasco2_history_page_span(const pasco2_history_page_t *page, pasco2_history_record_t *first,
+                              pasco2_history_record_t *last)
+{
+    pasco2_history_cursor_t cursor;
+    uint32_t samples = 0U;
+
+    pasco2_history_cursor_init(&cursor, page);
+    while (pasco2_history_cursor_next(&cursor, last))
+    {
+        if (samples++ == 0U)
+        {
+            *first = *last;
+        }
+    }
+
+    return (samples > 0U) && (samples == page->header.samples) && (cursor.position == page->header.nibbles);
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_history_record_compare
+ *******************************************************************************
+ * Summary:
+ *   Orders two samples by start-up count and time.
+ *
+ * Parameters:
+ *   a: first sample
+ *   b: second sample
+ *
+ * Return:
+ *   negative if a is older than b, 0 if both have the same time, positive
+ *   otherwise
+ ******************************************************************************/
+int32_t pasco2_history_record_compare(const pasco2_history_record_t *a, const pasco2_history_record_t *b)
+{
+    if (a->boot != b->boot)
+    {
+        return (a->boot < b->boot) ? -1 : 1;
+    }
+    if (a->time_s != b->time_s)
+    {
+        return (a->time_s < b->time_s) ? -1 : 1;
+    }
+
+    return 0;
+}
+
+/* [] END OF FILE */
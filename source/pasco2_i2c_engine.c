@@ -0,0 +1,525 @@
+/*****************************************************************************
+** File name: pasco2_i2c_engine.c
+**
+** Description: This file implements a queued asynchronous I2C transaction
+** engine on top of the HAL asynchronous transfer API. A request chains several
+** transactions that are started back-to-back from the completion interrupt, so
+** the submitting task sleeps while the bus is busy.
+**
+** ===========================================================================
+** Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+** ===========================================================================
+**
+** ===========================================================================
+** Infineon Technologies AG (INFINEON) is supplying this file for use
+** exclusively with Infineon's sensor products. This file can be freely
+** distributed within development tools and software supporting such
+** products.
+**
+** THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+** OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+** MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+** INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+** WHATSOEVER.
+** ===========================================================================
+*/
+
+/* Header file for local module */
+#include "pasco2_i2c_engine.h"
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+#define PASCO2_I2C_ENGINE_EVENTS ((cyhal_i2c_event_t)(CYHAL_I2C_MASTER_WR_CMPLT_EVENT | \
+                                                      CYHAL_I2C_MASTER_RD_CMPLT_EVENT | \
+                                                      CYHAL_I2C_MASTER_ERR_EVENT))
+
+/*******************************************************************************
+ * Function Name: engine_complete
+ *******************************************************************************
+ * Summary:
+ *   Finishes the active request and reports its result.
+ *
+ * Parameters:
+ *   engine: engine object
+ *   result: result of the request
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+static void engine_complete(pasco2_i2c_engine_t *engine, cy_rslt_t result)
+{
+    pasco2_i2c_request_t *request = engine->active;
+
+    engine->active = NULL;
+    engine->selecting = false;
+    engine->stats.requests++;
+    if (result != CY_RSLT_SUCCESS)
+    {
+        engine->stats.errors++;
+        /* The state of the mux is unknown after a failure */
+        engine->selected.mux_address = 0U;
+    }
+
+    request->result = result;
+    if (request->callback != NULL)
+    {
+        request->callback(request->callback_arg, result);
+    }
+}
+
+/*******************************************************************************
+ * Function Name: engine_start_txn
+ *******************************************************************************
+ * Summary:
+ *   Starts the current transaction of the active request.
+ *
+ * Parameters:
+ *   engine: engine object
+ *
+ * Return:
+ *   Status of the HAL transfer request
+ ******************************************************************************/
+static cy_rslt_t engine_start_txn(pasco2_i2c_engine_t *engine)
+{
+    const pasco2_i2c_txn_t *txn = &engine->active->txns[engine->active_index];
+
+    return cyhal_i2c_master_transfer_async(engine->i2c, txn->address,
+                                           txn->tx, txn->tx_size,
+                                           txn->rx, txn->rx_size);
+}
+
+/*******************************************************************************
+ * Function Name: engine_advance
+ *******************************************************************************
+ * Summary:
+ *   Starts the next step of the active request: the mux channel switch if the
+ *   route of the request is not selected yet, the current transaction, or
+ *   the completion after the last transaction.
+ *
+ * Parameters:
+ *   engine: engine object
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+static void engine_advance(pasco2_i2c_engine_t *engine)
+{
+    const pasco2_i2c_request_t *request = engine->active;
+    cy_rslt_t result;
+
+    if ((request->route.mux_address != 0U) &&
+        ((request->route.mux_address != engine->selected.mux_address) ||
+         (request->route.mux_channel != engine->selected.mux_channel)))
+    {
+        engine->selecting = true;
+        engine->select_byte = (uint8_t)(1U << request->route.mux_channel);
+        result = cyhal_i2c_master_transfer_async(engine->i2c, request->route.mux_address,
+                                                 &engine->select_byte, 1U, NULL, 0U);
+    }
+    else if (engine->active_index >= request->count)
+    {
+        engine_complete(engine, CY_RSLT_SUCCESS);
+        return;
+    }
+    else
+    {
+        result = engine_start_txn(engine);
+    }
+
+    if (result != CY_RSLT_SUCCESS)
+    {
+        engine_complete(engine, PASCO2_I2C_ENGINE_RSLT_ERR_BUS);
+    }
+}
+
+/*******************************************************************************
+ * Function Name: engine_start_next
+ *******************************************************************************
+ * Summary:
+ *   Takes the next queued request and starts it. Requests that cannot be
+ *   started are completed with an error. Must be called with the engine idle,
+ *   from the interrupt or inside a critical section.
+ *
+ * Parameters:
+ *   engine: engine object
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+static void engine_start_next(pasco2_i2c_engine_t *engine)
+{
+    while ((engine->active == NULL) && (engine->queue_count > 0U))
+    {
+        engine->active = engine->queue[engine->queue_head];
+        engine->active_index = 0U;
+        engine->queue_head = (uint8_t)((engine->queue_head + 1U) % PASCO2_I2C_ENGINE_QUEUE_LENGTH);
+        engine->queue_count--;
+
+        engine_advance(engine);
+    }
+}
+
+/*******************************************************************************
+ * Function Name: engine_isr
+ *******************************************************************************
+ * Summary:
+ *   I2C event handler. Advances the active request to its next transaction or
+ *   completes it. Events of blocking transfers issued outside the engine are
+ *   ignored since no request is active then.
+ *
+ * Parameters:
+ *   callback_arg: engine object
+ *   event: I2C events that occurred
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+static void engine_isr(void *callback_arg, cyhal_i2c_event_t event)
+{
+    pasco2_i2c_engine_t *engine = (pasco2_i2c_engine_t *)callback_arg;
+
+    if (engine->active == NULL)
+    {
+        return;
+    }
+
+    if ((event & CYHAL_I2C_MASTER_ERR_EVENT) != 0U)
+    {
+        engine_complete(engine, PASCO2_I2C_ENGINE_RSLT_ERR_BUS);
+    }
+    else if (engine->selecting)
+    {
+        if ((event & CYHAL_I2C_MASTER_WR_CMPLT_EVENT) == 0U)
+        {
+            return;
+        }
+
+        engine->selecting = false;
+        engine->selected = engine->active->route;
+        engine->stats.mux_selects++;
+        engine_advance(engine);
+    }
+    else
+    {
+        /* A write-then-read transaction is finished by its read phase */
+        const pasco2_i2c_txn_t *txn = &engine->active->txns[engine->active_index];
+        cyhal_i2c_event_t done_event = (txn->rx_size > 0U) ? CYHAL_I2C_MASTER_RD_CMPLT_EVENT
+                                                           : CYHAL_I2C_MASTER_WR_CMPLT_EVENT;
+        if ((event & done_event) == 0U)
+        {
+            return;
+        }
+
+        engine->stats.transactions++;
+        engine->stats.bytes += (uint32_t)(txn->tx_size + txn->rx_size);
+        engine->active_index++;
+        engine_advance(engine);
+    }
+
+    engine_start_next(engine);
+}
+
+/*******************************************************************************
+ * Function Name: engine_transfer_done
+ *******************************************************************************
+ * Summary:
+ *   Completion callback of pasco2_i2c_engine_transfer, wakes up the waiting
+ *   task.
+ *
+ * Parameters:
+ *   callback_arg: engine object
+ *   result: result of the request
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+static void engine_transfer_done(void *callback_arg, cy_rslt_t result)
+{
+    pasco2_i2c_engine_t *engine = (pasco2_i2c_engine_t *)callback_arg;
+
+    (void)result;
+    (void)cy_rtos_set_semaphore(&engine->done, true);
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_i2c_engine_init
+ *******************************************************************************
+ * Summary:
+ *   Initializes the engine on an already configured I2C master and enables
+ *   the completion interrupt.
+ *
+ * Parameters:
+ *   engine: engine object
+ *   i2c: I2C master object
+ *
+ * Return:
+ *   Status of the initialization
+ ******************************************************************************/
+cy_rslt_t pasco2_i2c_engine_init(pasco2_i2c_engine_t *engine, cyhal_i2c_t *i2c)
+{
+    *engine = (pasco2_i2c_engine_t){ .i2c = i2c };
+
+    cy_rslt_t result = pasco2_rtos_init_semaphore(&engine->done, &engine->done_storage, 1U, 0U);
+    if (result == CY_RSLT_SUCCESS)
+    {
+        cyhal_i2c_register_callback(i2c, engine_isr, engine);
+        cyhal_i2c_enable_event(i2c, PASCO2_I2C_ENGINE_EVENTS, PASCO2_I2C_ENGINE_INTR_PRIORITY, true);
+    }
+
+    return result;
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_i2c_engine_submit
+ *******************************************************************************
+ * Summary:
+ *   Queues a request and returns immediately. The request and its
+ *   transactions must stay valid until the completion callback has run. The
+ *   callback runs in interrupt context, or in the caller's context when the
+ *   bus refuses to start the transfer.
+ *
+ * Parameters:
+ *   engine: engine object
+ *   request: chain of transactions
+ *
+ * Return:
+ *   PASCO2_I2C_ENGINE_RSLT_ERR_QUEUE_FULL if the request was not queued
+ ******************************************************************************/
+cy_rslt_t pasco2_i2c_engine_submit(pasco2_i2c_engine_t *engine, pasco2_i2c_request_t *request)
+{
+    cy_rslt_t result = CY_RSLT_SUCCESS;
+
+    taskENTER_CRITICAL();
+    if (engine->queue_count >= PASCO2_I2C_ENGINE_QUEUE_LENGTH)
+    {
+        result = PASCO2_I2C_ENGINE_RSLT_ERR_QUEUE_FULL;
+    }
+    else
+    {
+        uint8_t tail = (uint8_t)((engine->queue_head + engine->queue_count) % PASCO2_I2C_ENGINE_QUEUE_LENGTH);
+        engine->queue[tail] = request;
+        engine->queue_count++;
+        if (engine->queue_count > engine->stats.queue_high_water)
+        {
+            engine->stats.queue_high_water = engine->queue_count;
+        }
+
+        engine_start_next(engine);
+    }
+    taskEXIT_CRITICAL();
+
+    return result;
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_i2c_engine_cancel
+ *******************************************************************************
+ * Summary:
+ *   Withdraws a submitted request. A queued request is removed, an active
+ *   request is aborted on the bus. Either way it ends with
+ *   PASCO2_I2C_ENGINE_RSLT_ERR_TIMEOUT and its callback is not called.
+ *
+ * Parameters:
+ *   engine: engine object
+ *   request: submitted request
+ *
+ * Return:
+ *   true if the request was withdrawn, false if it had completed already
+ ******************************************************************************/
+bool pasco2_i2c_engine_cancel(pasco2_i2c_engine_t *engine, pasco2_i2c_request_t *request)
+{
+    bool cancelled = false;
+
+    taskENTER_CRITICAL();
+    request->callback = NULL;
+    if (engine->active == request)
+    {
+        (void)cyhal_i2c_abort_async(engine->i2c);
+        engine_complete(engine, PASCO2_I2C_ENGINE_RSLT_ERR_TIMEOUT);
+        engine_start_next(engine);
+        cancelled = true;
+    }
+    else
+    {
+        for (uint8_t i = 0U; i < engine->queue_count; i++)
+        {
+            uint8_t index = (uint8_t)((engine->queue_head + i) % PASCO2_I2C_ENGINE_QUEUE_LENGTH);
+            if (engine->queue[index] == request)
+            {
+                /* Close the gap left by the request */
+                for (uint8_t j = i; (j + 1U) < engine->queue_count; j++)
+                {
+                    uint8_t next = (uint8_t)((index + 1U) % PASCO2_I2C_ENGINE_QUEUE_LENGTH);
+                    engine->queue[index] = engine->queue[next];
+                    index = next;
+                }
+                engine->queue_count--;
+                engine->stats.errors++;
+                request->result = PASCO2_I2C_ENGINE_RSLT_ERR_TIMEOUT;
+                cancelled = true;
+                break;
+            }
+        }
+    }
+    taskEXIT_CRITICAL();
+
+    return cancelled;
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_i2c_engine_transfer
+ *******************************************************************************
+ * Summary:
+ *   Queues a request and sleeps until it has completed. Only one task may use
+ *   this function at a time. A request that does not complete in time is
+ *   aborted.
+ *
+ * Parameters:
+ *   engine: engine object
+ *   request: chain of transactions, its callback is overwritten
+ *   timeout_ms: maximum time to wait for completion
+ *
+ * Return:
+ *   Result of the request
+ ******************************************************************************/
+cy_rslt_t pasco2_i2c_engine_transfer(pasco2_i2c_engine_t *engine, pasco2_i2c_request_t *request, cy_time_t timeout_ms)
+{
+    request->callback = engine_transfer_done;
+    request->callback_arg = engine;
+
+    cy_rslt_t result = pasco2_i2c_engine_submit(engine, request);
+    if (result != CY_RSLT_SUCCESS)
+    {
+        return result;
+    }
+
+    if (cy_rtos_get_semaphore(&engine->done, timeout_ms, false) == CY_RSLT_SUCCESS)
+    {
+        return request->result;
+    }
+
+    if (!pasco2_i2c_engine_cancel(engine, request))
+    {
+        /* Completed between the timeout and the cancellation */
+        (void)cy_rtos_get_semaphore(&engine->done, 0U, false);
+    }
+
+    return request->result;
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_i2c_engine_select
+ *******************************************************************************
+ * Summary:
+ *   Switches the mux to the channel of a route, so that blocking driver calls
+ *   outside the engine reach the device behind it.
+ *
+ * Parameters:
+ *   engine: engine object
+ *   route: route to select
+ *   timeout_ms: maximum time to wait for completion
+ *
+ * Return:
+ *   Result of the channel switch
+ ******************************************************************************/
+cy_rslt_t pasco2_i2c_engine_select(pasco2_i2c_engine_t *engine, const pasco2_i2c_route_t *route, cy_time_t timeout_ms)
+{
+    pasco2_i2c_request_t request = { .txns = NULL, .count = 0U, .route = *route };
+
+    return pasco2_i2c_engine_transfer(engine, &request, timeout_ms);
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_i2c_engine_recover
+ *******************************************************************************
+ * Summary:
+ *   Clears a hung bus and initializes the I2C master again. The pins are
+ *   taken over as open-drain outputs: SCL is pulsed until a device that holds
+ *   SDA low in the middle of a byte has shifted it out, then a STOP condition
+ *   resets the bus state of all devices. The engine must be idle, no request
+ *   may be queued.
+ *
+ * Parameters:
+ *   engine: engine object
+ *   sda: SDA pin of the bus
+ *   scl: SCL pin of the bus
+ *   cfg: configuration of the I2C master
+ *
+ * Return:
+ *   Result of the re-initialization of the I2C master
+ ******************************************************************************/
+cy_rslt_t pasco2_i2c_engine_recover(pasco2_i2c_engine_t *engine, cyhal_gpio_t sda, cyhal_gpio_t scl,
+                                    const cyhal_i2c_cfg_t *cfg)
+{
+    cyhal_i2c_free(engine->i2c);
+
+    cy_rslt_t result = cyhal_gpio_init(scl, CYHAL_GPIO_DIR_BIDIRECTIONAL, CYHAL_GPIO_DRIVE_OPENDRAINDRIVESLOW, true);
+    if (result == CY_RSLT_SUCCESS)
+    {
+        result = cyhal_gpio_init(sda, CYHAL_GPIO_DIR_BIDIRECTIONAL, CYHAL_GPIO_DRIVE_OPENDRAINDRIVESLOW, true);
+        if (result == CY_RSLT_SUCCESS)
+        {
+            for (uint8_t pulse = 0U; (pulse < PASCO2_I2C_ENGINE_CLEAR_PULSES) && !cyhal_gpio_read(sda); pulse++)
+            {
+                cyhal_gpio_write(scl, false);
+                cyhal_system_delay_us(PASCO2_I2C_ENGINE_CLEAR_HALF_PERIOD_US);
+                cyhal_gpio_write(scl, true);
+                cyhal_system_delay_us(PASCO2_I2C_ENGINE_CLEAR_HALF_PERIOD_US);
+            }
+
+            /* STOP: SDA rises while SCL is high */
+            cyhal_gpio_write(scl, false);
+            cyhal_gpio_write(sda, false);
+            cyhal_system_delay_us(PASCO2_I2C_ENGINE_CLEAR_HALF_PERIOD_US);
+            cyhal_gpio_write(scl, true);
+            cyhal_system_delay_us(PASCO2_I2C_ENGINE_CLEAR_HALF_PERIOD_US);
+            cyhal_gpio_write(sda, true);
+            cyhal_system_delay_us(PASCO2_I2C_ENGINE_CLEAR_HALF_PERIOD_US);
+            cyhal_gpio_free(sda);
+        }
+        cyhal_gpio_free(scl);
+    }
+
+    /* The I2C master is initialized again even if the pins could not be
+     * driven, it may still recover the bus by itself */
+    result = cyhal_i2c_init(engine->i2c, sda, scl, NULL);
+    if (result == CY_RSLT_SUCCESS)
+    {
+        result = cyhal_i2c_configure(engine->i2c, cfg);
+    }
+    if (result == CY_RSLT_SUCCESS)
+    {
+        cyhal_i2c_register_callback(engine->i2c, engine_isr, engine);
+        cyhal_i2c_enable_event(engine->i2c, PASCO2_I2C_ENGINE_EVENTS, PASCO2_I2C_ENGINE_INTR_PRIORITY, true);
+    }
+
+    /* The state of the mux is unknown after the bus clear */
+    engine->selected.mux_address = 0U;
+    engine->stats.bus_clears++;
+
+    return result;
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_i2c_engine_get_stats
+ *******************************************************************************
+ * Summary:
+ *   Returns a copy of the engine counters.
+ *
+ * Parameters:
+ *   engine: engine object
+ *   stats: destination of the counters
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+void pasco2_i2c_engine_get_stats(const pasco2_i2c_engine_t *engine, pasco2_i2c_engine_stats_t *stats)
+{
+    taskENTER_CRITICAL();
+    *stats = engine->stats;
+    taskEXIT_CRITICAL();
+}
+
+/* [] END OF FILE */
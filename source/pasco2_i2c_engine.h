@@ -0,0 +1,133 @@
+/******************************************************************************
+** File name: pasco2_i2c_engine.h
+**
+** Description: This file contains the types and function prototypes of the
+**   queued asynchronous I2C transaction engine.
+**
+** ===========================================================================
+** Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+** ===========================================================================
+**
+** ===========================================================================
+** Infineon Technologies AG (INFINEON) is supplying this file for use
+** exclusively with Infineon's sensor products. This file can be freely
+** distributed within development tools and software supporting such
+** products.
+**
+** THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+** OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+** MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+** INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+** WHATSOEVER.
+** ===========================================================================
+*/
+
+#pragma once
+
+/* Header file includes */
+#include "cyabs_rtos.h"
+#include "cyhal.h"
+
+#include "pasco2_rtos.h"
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+/* Maximum number of requests waiting for the bus */
+#define PASCO2_I2C_ENGINE_QUEUE_LENGTH (4U)
+
+/* Priority of the I2C completion interrupt */
+#define PASCO2_I2C_ENGINE_INTR_PRIORITY (7U)
+
+/* Bus clear: SCL pulses that release a device holding SDA low in the middle
+ * of a byte, and half the period of one pulse (100 kHz) */
+#define PASCO2_I2C_ENGINE_CLEAR_PULSES (9U)
+#define PASCO2_I2C_ENGINE_CLEAR_HALF_PERIOD_US (5U)
+
+/* Result codes of the engine */
+#define PASCO2_I2C_ENGINE_RSLT_ERR_QUEUE_FULL \
+    CY_RSLT_CREATE(CY_RSLT_TYPE_ERROR, CY_RSLT_MODULE_MIDDLEWARE_BASE, 0x101U)
+#define PASCO2_I2C_ENGINE_RSLT_ERR_BUS \
+    CY_RSLT_CREATE(CY_RSLT_TYPE_ERROR, CY_RSLT_MODULE_MIDDLEWARE_BASE, 0x102U)
+#define PASCO2_I2C_ENGINE_RSLT_ERR_TIMEOUT \
+    CY_RSLT_CREATE(CY_RSLT_TYPE_ERROR, CY_RSLT_MODULE_MIDDLEWARE_BASE, 0x103U)
+
+/*******************************************************************************
+ * Types
+ ******************************************************************************/
+/* One bus transaction: an optional write followed by an optional read with a
+ * repeated start */
+typedef struct
+{
+    uint16_t address;           /* 7-bit device address */
+    const uint8_t *tx;          /* Bytes to write, NULL for a pure read */
+    size_t tx_size;
+    uint8_t *rx;                /* Destination of the read, NULL for a pure write */
+    size_t rx_size;
+} pasco2_i2c_txn_t;
+
+/* Route to a device behind an I2C mux such as the PCA9548A. Devices with a
+ * zero mux address are connected to the bus directly. */
+typedef struct
+{
+    uint8_t mux_address;        /* 7-bit mux address, 0 without mux */
+    uint8_t mux_channel;        /* Mux channel of the device */
+} pasco2_i2c_route_t;
+
+/* Completion callback, executed in interrupt context */
+typedef void (*pasco2_i2c_done_callback_t)(void *callback_arg, cy_rslt_t result);
+
+/* A chain of transactions executed back-to-back on the bus */
+typedef struct
+{
+    const pasco2_i2c_txn_t *txns;
+    uint8_t count;
+    pasco2_i2c_route_t route;   /* Mux channel selected before the chain */
+    pasco2_i2c_done_callback_t callback;
+    void *callback_arg;
+    volatile cy_rslt_t result;  /* Result of the chain, valid after completion */
+} pasco2_i2c_request_t;
+
+/* Engine counters */
+typedef struct
+{
+    uint32_t requests;          /* Completed requests */
+    uint32_t transactions;      /* Completed bus transactions */
+    uint32_t bytes;             /* Payload bytes written and read by completed transactions */
+    uint32_t errors;            /* Requests that ended with a bus error or timeout */
+    uint32_t mux_selects;       /* Mux channel switches */
+    uint32_t queue_high_water;  /* Largest number of queued requests */
+    uint32_t bus_clears;        /* Bus clears with re-initialization of the I2C master */
+} pasco2_i2c_engine_stats_t;
+
+/* Engine object */
+typedef struct
+{
+    cyhal_i2c_t *i2c;
+    pasco2_i2c_request_t *queue[PASCO2_I2C_ENGINE_QUEUE_LENGTH];
+    uint8_t queue_head;
+    uint8_t queue_count;
+    pasco2_i2c_request_t *volatile active;
+    uint8_t active_index;
+    bool selecting;             /* Mux channel switch of the active request in progress */
+    uint8_t select_byte;
+    pasco2_i2c_route_t selected; /* Mux channel known to be selected */
+    cy_semaphore_t done;
+    pasco2_rtos_semaphore_storage_t done_storage;
+    pasco2_i2c_engine_stats_t stats;
+} pasco2_i2c_engine_t;
+
+/*******************************************************************************
+ * Functions
+ ******************************************************************************/
+cy_rslt_t pasco2_i2c_engine_init(pasco2_i2c_engine_t *engine, cyhal_i2c_t *i2c);
+cy_rslt_t pasco2_i2c_engine_submit(pasco2_i2c_engine_t *engine, pasco2_i2c_request_t *request);
+bool pasco2_i2c_engine_cancel(pasco2_i2c_engine_t *engine, pasco2_i2c_request_t *request);
+cy_rslt_t pasco2_i2c_engine_transfer(pasco2_i2c_engine_t *engine, pasco2_i2c_request_t *request, cy_time_t timeout_ms);
+cy_rslt_t pasco2_i2c_engine_select(pasco2_i2c_engine_t *engine, const pasco2_i2c_route_t *route, cy_time_t timeout_ms);
+cy_rslt_t pasco2_i2c_engine_recover(pasco2_i2c_engine_t *engine, cyhal_gpio_t sda, cyhal_gpio_t scl,
+                                    const cyhal_i2c_cfg_t *cfg);
+void pasco2_i2c_engine_get_stats(const pasco2_i2c_engine_t *engine, pasco2_i2c_engine_stats_t *stats);
+
+/* [] END OF FILE */
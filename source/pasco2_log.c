@@ -0,0 +1,195 @@
+/*****************************************************************************
+** File name: pasco2_log.c
+**
+** Description: This file implements the deferred logger. Call sites store a
+** message identifier and raw arguments in a RAM buffer; formatting happens
+** later in the output task, or on the host when binary telemetry is enabled.
+**
+** ===========================================================================
+** Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+** ===========================================================================
+**
+** ===========================================================================
+** Infineon Technologies AG (INFINEON) is supplying this file for use
+** exclusively with Infineon's sensor products. This file can be freely
+** distributed within development tools and software supporting such
+** products.
+**
+** THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+** OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+** MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+** INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+** WHATSOEVER.
+** ===========================================================================
+*/
+
+/* Header file from system */
+#include <inttypes.h>
+#include <stdio.h>
+
+/* Header file includes */
+#include "cyabs_rtos.h"
+
+/* Header file for local module */
+#include "pasco2_log.h"
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+#define PASCO2_LOG_BUFFER_MASK (PASCO2_LOG_BUFFER_LENGTH - 1U)
+
+#if ((PASCO2_LOG_BUFFER_LENGTH & PASCO2_LOG_BUFFER_MASK) != 0U)
+#error "PASCO2_LOG_BUFFER_LENGTH must be a power of two"
+#endif
+
+/*******************************************************************************
+ * Global Variables
+ ******************************************************************************/
+#define PASCO2_LOG_FORMAT(id, format) format,
+static const char *const log_formats[PASCO2_LOG_MESSAGE_COUNT] =
+{
+    PASCO2_LOG_MESSAGES(PASCO2_LOG_FORMAT)
+};
+#undef PASCO2_LOG_FORMAT
+
+static pasco2_log_record_t log_buffer[PASCO2_LOG_BUFFER_LENGTH];
+static volatile uint32_t log_head;
+static volatile uint32_t log_tail;
+static volatile uint32_t log_dropped;
+static volatile uint8_t log_level = PASCO2_LOG_LEVEL_INFO;
+
+/*******************************************************************************
+ * Function Name: pasco2_log_set_level
+ *******************************************************************************
+ * Summary:
+ *   Sets the highest level that is recorded at runtime. Levels above
+ *   PASCO2_LOG_LEVEL are never recorded.
+ *
+ * Parameters:
+ *   level: PASCO2_LOG_LEVEL_xxx
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+void pasco2_log_set_level(uint8_t level)
+{
+    log_level = level;
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_log_record
+ *******************************************************************************
+ * Summary:
+ *   Stores a log record without formatting it. Use the PASCO2_LOG_xxx macros
+ *   instead of calling this function directly. Must be called from task
+ *   context. The record is dropped and counted when the buffer is full.
+ *
+ * Parameters:
+ *   level: level of the message
+ *   id: message identifier
+ *   arg0: first format argument
+ *   arg1: second format argument
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+void pasco2_log_record(uint8_t level, uint16_t id, uint32_t arg0, uint32_t arg1)
+{
+    if (level > log_level)
+    {
+        return;
+    }
+
+    uint32_t tick = (uint32_t)(xTaskGetTickCount() * portTICK_PERIOD_MS);
+
+    taskENTER_CRITICAL();
+    uint32_t head = log_head;
+    if ((head - log_tail) >= PASCO2_LOG_BUFFER_LENGTH)
+    {
+        log_dropped++;
+    }
+    else
+    {
+        pasco2_log_record_t *record = &log_buffer[head & PASCO2_LOG_BUFFER_MASK];
+        record->tick = tick;
+        record->id = id;
+        record->level = level;
+        record->args[0] = arg0;
+        record->args[1] = arg1;
+        log_head = head + 1U;
+    }
+    taskEXIT_CRITICAL();
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_log_pop
+ *******************************************************************************
+ * Summary:
+ *   Removes the oldest record from the buffer. Must only be called by the
+ *   single consumer task.
+ *
+ * Parameters:
+ *   record: destination of the record
+ *
+ * Return:
+ *   true if a record was removed, false if the buffer was empty
+ ******************************************************************************/
+bool pasco2_log_pop(pasco2_log_record_t *record)
+{
+    bool available = false;
+
+    taskENTER_CRITICAL();
+    uint32_t tail = log_tail;
+    if (tail != log_head)
+    {
+        *record = log_buffer[tail & PASCO2_LOG_BUFFER_MASK];
+        log_tail = tail + 1U;
+        available = true;
+    }
+    taskEXIT_CRITICAL();
+
+    return available;
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_log_get_dropped
+ *******************************************************************************
+ * Summary:
+ *   Returns the number of records dropped because the buffer was full.
+ *
+ * Parameters:
+ *   none
+ *
+ * Return:
+ *   number of dropped records
+ ******************************************************************************/
+uint32_t pasco2_log_get_dropped(void)
+{
+    return log_dropped;
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_log_print
+ *******************************************************************************
+ * Summary:
+ *   Formats a record and prints it to the console.
+ *
+ * Parameters:
+ *   record: record to print
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+void pasco2_log_print(const pasco2_log_record_t *record)
+{
+    if (record->id >= (uint16_t)PASCO2_LOG_MESSAGE_COUNT)
+    {
+        return;
+    }
+
+    printf(log_formats[record->id], record->args[0], record->args[1]);
+    printf("\r\n");
+}
+
+/* [] END OF FILE */
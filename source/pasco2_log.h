@@ -0,0 +1,142 @@
+/******************************************************************************
+** File name: pasco2_log.h
+**
+** Description: This file contains the message table, macros and function
+**   prototypes of the deferred logger. The message table has no platform
+**   dependencies and is shared with the host-side telemetry decoder.
+**
+** ===========================================================================
+** Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+** ===========================================================================
+**
+** ===========================================================================
+** Infineon Technologies AG (INFINEON) is supplying this file for use
+** exclusively with Infineon's sensor products. This file can be freely
+** distributed within development tools and software supporting such
+** products.
+**
+** THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+** OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+** MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+** INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+** WHATSOEVER.
+** ===========================================================================
+*/
+
+#pragma once
+
+/* Header file from system */
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+/* Log levels */
+#define PASCO2_LOG_LEVEL_NONE  (0U)
+#define PASCO2_LOG_LEVEL_ERROR (1U)
+#define PASCO2_LOG_LEVEL_WARN  (2U)
+#define PASCO2_LOG_LEVEL_INFO  (3U)
+#define PASCO2_LOG_LEVEL_DEBUG (4U)
+
+/* Highest level compiled into the firmware. Call sites of higher levels are
+ * removed by the preprocessor and cost nothing. */
+#ifndef PASCO2_LOG_LEVEL
+#define PASCO2_LOG_LEVEL PASCO2_LOG_LEVEL_DEBUG
+#endif
+
+/* Number of records buffered until the output task formats them */
+#define PASCO2_LOG_BUFFER_LENGTH (32U)
+
+/* Message table: identifier and format. A format takes up to two uint32_t
+ * arguments, messages about a sensor node take its index first. Only append to the table, the identifiers are part of the
+ * binary telemetry stream. */
+#define PASCO2_LOG_MESSAGES(X)                                                  \
+    X(PASCO2_LOG_CO2_NOT_READY,      "Sensor %" PRIu32 ": CO2 PPM value is not ready") \
+    X(PASCO2_LOG_CO2_COMM_ERROR,     "Sensor %" PRIu32 ": I2C communication error") \
+    X(PASCO2_LOG_CO2_UNEXPECTED,     "Unexpected error 0x%08" PRIx32)           \
+    X(PASCO2_LOG_SENSOR_ICCER,       "Sensor %" PRIu32 ": CO2 Sensor Communication Error") \
+    X(PASCO2_LOG_SENSOR_ORVS,        "Sensor %" PRIu32 ": CO2 Sensor Over-Voltage Error") \
+    X(PASCO2_LOG_SENSOR_ORTMP,       "Sensor %" PRIu32 ": CO2 Sensor Temperature Error") \
+    X(PASCO2_LOG_SENSOR_CONFIG_ERROR, "Sensor %" PRIu32 ": measurement mode not applied") \
+    X(PASCO2_LOG_HISTORY_WRITE_ERROR, "History: flash write error 0x%08" PRIx32) \
+    X(PASCO2_LOG_RATE_STEP,          "Adaptive rate: period %" PRIu32 " s, CO2 step of %" PRIu32 " ppm") \
+    X(PASCO2_LOG_RATE_TREND,         "Adaptive rate: period %" PRIu32 " s, CO2 changing %" PRIu32 " ppm/min") \
+    X(PASCO2_LOG_RATE_STABLE,        "Adaptive rate: period %" PRIu32 " s, CO2 stable") \
+    X(PASCO2_LOG_BOOT_READY,         "Boot: sensors ready at %" PRIu32 " ms after %" PRIu32 " status polls") \
+    X(PASCO2_LOG_BOOT_FIRST_PPM,     "Boot: sensor %" PRIu32 ": first CO2 value at %" PRIu32 " ms") \
+    X(PASCO2_LOG_PRESSURE_ERROR,     "Sensor %" PRIu32 ": pressure sensor read error") \
+    X(PASCO2_LOG_RECOVERY_FAULT,     "Sensor %" PRIu32 ": fault detected, readouts suspended") \
+    X(PASCO2_LOG_RECOVERY_BUS_CLEAR, "Sensor %" PRIu32 ": recovery by I2C bus clear") \
+    X(PASCO2_LOG_RECOVERY_RESET,     "Sensor %" PRIu32 ": recovery by sensor reset") \
+    X(PASCO2_LOG_RECOVERY_POWER_CYCLE, "Sensor %" PRIu32 ": recovery by power cycle") \
+    X(PASCO2_LOG_RECOVERY_FAILED,    "Sensor %" PRIu32 ": recovery failed, next action in %" PRIu32 " ms") \
+    X(PASCO2_LOG_RECOVERY_DONE,      "Sensor %" PRIu32 ": recovered after %" PRIu32 " ms") \
+    X(PASCO2_LOG_BASELINE_RESTORED,  "Sensor %" PRIu32 ": CO2 baseline restored, offset %" PRId32 " ppm") \
+    X(PASCO2_LOG_BASELINE_LEARNED,   "Sensor %" PRIu32 ": CO2 baseline learned, offset %" PRId32 " ppm") \
+    X(PASCO2_LOG_BASELINE_WRITE_ERROR, "Baseline: flash write error 0x%08" PRIx32) \
+    X(PASCO2_LOG_ALARM_RAISED,       "Sensor %" PRIu32 ": CO2 alarm raised to level %" PRIu32) \
+    X(PASCO2_LOG_ALARM_LOWERED,      "Sensor %" PRIu32 ": CO2 alarm lowered to level %" PRIu32)
+
+/* Record a message, arguments are converted to uint32_t. Missing arguments
+ * are padded with zeros by the level macros. */
+#define PASCO2_LOG_RECORD_(level, id, arg0, arg1, ...) \
+    pasco2_log_record((level), (id), (uint32_t)(arg0), (uint32_t)(arg1))
+
+#if (PASCO2_LOG_LEVEL >= PASCO2_LOG_LEVEL_ERROR)
+#define PASCO2_LOG_ERROR(...) PASCO2_LOG_RECORD_(PASCO2_LOG_LEVEL_ERROR, __VA_ARGS__, 0U, 0U, 0U)
+#else
+#define PASCO2_LOG_ERROR(...) ((void)0)
+#endif
+
+#if (PASCO2_LOG_LEVEL >= PASCO2_LOG_LEVEL_WARN)
+#define PASCO2_LOG_WARN(...) PASCO2_LOG_RECORD_(PASCO2_LOG_LEVEL_WARN, __VA_ARGS__, 0U, 0U, 0U)
+#else
+#define PASCO2_LOG_WARN(...) ((void)0)
+#endif
+
+#if (PASCO2_LOG_LEVEL >= PASCO2_LOG_LEVEL_INFO)
+#define PASCO2_LOG_INFO(...) PASCO2_LOG_RECORD_(PASCO2_LOG_LEVEL_INFO, __VA_ARGS__, 0U, 0U, 0U)
+#else
+#define PASCO2_LOG_INFO(...) ((void)0)
+#endif
+
+#if (PASCO2_LOG_LEVEL >= PASCO2_LOG_LEVEL_DEBUG)
+#define PASCO2_LOG_DEBUG(...) PASCO2_LOG_RECORD_(PASCO2_LOG_LEVEL_DEBUG, __VA_ARGS__, 0U, 0U, 0U)
+#else
+#define PASCO2_LOG_DEBUG(...) ((void)0)
+#endif
+
+/*******************************************************************************
+ * Types
+ ******************************************************************************/
+#define PASCO2_LOG_ID(id, format) id,
+/* Message identifiers */
+typedef enum
+{
+    PASCO2_LOG_MESSAGES(PASCO2_LOG_ID)
+    PASCO2_LOG_MESSAGE_COUNT
+} pasco2_log_id_t;
+#undef PASCO2_LOG_ID
+
+/* Deferred log record */
+typedef struct
+{
+    uint32_t tick;              /* RTOS time of the call in ms */
+    uint16_t id;                /* pasco2_log_id_t */
+    uint8_t level;
+    uint32_t args[2];
+} pasco2_log_record_t;
+
+/*******************************************************************************
+ * Functions
+ ******************************************************************************/
+void pasco2_log_set_level(uint8_t level);
+void pasco2_log_record(uint8_t level, uint16_t id, uint32_t arg0, uint32_t arg1);
+bool pasco2_log_pop(pasco2_log_record_t *record);
+uint32_t pasco2_log_get_dropped(void);
+void pasco2_log_print(const pasco2_log_record_t *record);
+
+/* [] END OF FILE */
@@ -0,0 +1,165 @@
+/*****************************************************************************
+** File name: pasco2_pressure.c
+**
+** Description: This file implements the pressure compensation filter of the
+** PAS CO2 sensor. DPS3xx readings are low-pass filtered and a new pressure
+** reference is only written to the sensor when the filtered value has moved
+** beyond a hysteresis, since ambient pressure barely changes.
+**
+** ===========================================================================
+** Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+** ===========================================================================
+**
+** ===========================================================================
+** Infineon Technologies AG (INFINEON) is supplying this file for use
+** exclusively with Infineon's sensor products. This file can be freely
+** distributed within development tools and software supporting such
+** products.
+**
+** THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+** OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+** MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+** INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+** WHATSOEVER.
+** ===========================================================================
+*/
+
+/* Header file from system */
+#include <string.h>
+
+/* Header file for local module */
+#include "pasco2_pressure.h"
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+/* Pressure assumed until the first value has been filtered, in Pa */
+#define PASCO2_PRESSURE_DEFAULT ((int32_t)101500)
+
+/* One Pa in the fixed-point format of the filter */
+#define PASCO2_PRESSURE_ONE     ((int32_t)1 << PASCO2_PRESSURE_FRACTION_BITS)
+
+/*******************************************************************************
+ * Function Name: pasco2_pressure_init
+ *******************************************************************************
+ * Summary:
+ *   Resets the filter and its counters.
+ *
+ * Parameters:
+ *   pressure: filter object
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+void pasco2_pressure_init(pasco2_pressure_t *pressure)
+{
+    memset(pressure, 0, sizeof(*pressure));
+    pressure->filtered = PASCO2_PRESSURE_DEFAULT * PASCO2_PRESSURE_ONE;
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_pressure_update
+ *******************************************************************************
+ * Summary:
+ *   Feeds a new pressure reading into the low-pass filter. The first reading
+ *   initializes the filter directly.
+ *
+ * Parameters:
+ *   pressure: filter object
+ *   value: pressure reading in Pa
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+void pasco2_pressure_update(pasco2_pressure_t *pressure, int32_t value)
+{
+    if (pressure->filtered_valid)
+    {
+        pressure->filtered += ((value * PASCO2_PRESSURE_ONE) - pressure->filtered) /
+                              ((int32_t)1 << PASCO2_PRESSURE_FILTER_SHIFT);
+    }
+    else
+    {
+        pressure->filtered = value * PASCO2_PRESSURE_ONE;
+        pressure->filtered_valid = true;
+    }
+    pressure->stats.samples++;
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_pressure_get
+ *******************************************************************************
+ * Summary:
+ *   Returns the filtered pressure.
+ *
+ * Parameters:
+ *   pressure: filter object
+ *
+ * Return:
+ *   filtered pressure in Pa
+ ******************************************************************************/
+int32_t pasco2_pressure_get(const pasco2_pressure_t *pressure)
+{
+    return (pressure->filtered + (PASCO2_PRESSURE_ONE / 2)) / PASCO2_PRESSURE_ONE;
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_pressure_reference_due
+ *******************************************************************************
+ * Summary:
+ *   Decides whether the pressure reference of the sensor has to be written.
+ *   This is the case when no reference was written yet, when the filtered
+ *   pressure moved by PASCO2_PRESSURE_HYSTERESIS_HPA or more, or when forced
+ *   because a new measurement is about to start. A reference reported as due
+ *   is considered written; call pasco2_pressure_reference_lost if the write
+ *   fails.
+ *
+ * Parameters:
+ *   pressure: filter object
+ *   force: write the reference regardless of the hysteresis
+ *   reference: receives the reference to write in hPa
+ *
+ * Return:
+ *   true if the reference has to be written
+ ******************************************************************************/
+bool pasco2_pressure_reference_due(pasco2_pressure_t *pressure, bool force, uint16_t *reference)
+{
+    /* Rounded to hPa */
+    uint16_t value = (uint16_t)((pressure->filtered + (50 * PASCO2_PRESSURE_ONE)) / (100 * PASCO2_PRESSURE_ONE));
+    uint16_t delta = (value > pressure->reference) ? (uint16_t)(value - pressure->reference)
+                                                   : (uint16_t)(pressure->reference - value);
+
+    if (!force && pressure->reference_valid && (delta < PASCO2_PRESSURE_HYSTERESIS_HPA))
+    {
+        pressure->stats.writes_skipped++;
+        return false;
+    }
+
+    pressure->reference = value;
+    pressure->reference_valid = true;
+    pressure->stats.writes_issued++;
+    *reference = value;
+
+    return true;
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_pressure_reference_lost
+ *******************************************************************************
+ * Summary:
+ *   Marks the sensor reference as unknown, so that it is written again with
+ *   the next readout. Used after failed writes and sensor resets.
+ *
+ * Parameters:
+ *   pressure: filter object
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+void pasco2_pressure_reference_lost(pasco2_pressure_t *pressure)
+{
+    pressure->reference_valid = false;
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,82 @@
+/******************************************************************************
+** File name: pasco2_pressure.h
+**
+** Description: This file contains the types and function prototypes of the
+**   pressure compensation filter of the PAS CO2 sensor.
+**
+** ===========================================================================
+** Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+** ===========================================================================
+**
+** ===========================================================================
+** Infineon Technologies AG (INFINEON) is supplying this file for use
+** exclusively with Infineon's sensor products. This file can be freely
+** distributed within development tools and software supporting such
+** products.
+**
+** THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+** OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+** MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+** INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+** WHATSOEVER.
+** ===========================================================================
+*/
+
+#pragma once
+
+/* Header file includes */
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "cy_pdl.h"
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+/* Period of the DPS3xx FIFO readout in ms. The FIFO holds 32 results and
+ * collects two per second, so the period must stay well below 16 s. */
+#define PASCO2_PRESSURE_SAMPLE_PERIOD_MS (8000U)
+
+/* Weight of a new pressure value in the low-pass filter, as a power of two.
+ * Each value is already the mean of a FIFO batch. */
+#define PASCO2_PRESSURE_FILTER_SHIFT (2U)
+
+/* Fraction bits of the filtered pressure, so that the filter settles on the
+ * input instead of stalling within 2^PASCO2_PRESSURE_FILTER_SHIFT Pa */
+#define PASCO2_PRESSURE_FRACTION_BITS (8U)
+
+/* Change of the filtered pressure in hPa that triggers a new sensor reference */
+#define PASCO2_PRESSURE_HYSTERESIS_HPA (2U)
+
+/*******************************************************************************
+ * Types
+ ******************************************************************************/
+/* Counters of the pressure reference updates */
+typedef struct
+{
+    uint32_t samples;           /* Pressure values fed into the filter */
+    uint32_t writes_issued;     /* Pressure reference writes sent to the sensor */
+    uint32_t writes_skipped;    /* Readouts that did not need a reference write */
+} pasco2_pressure_stats_t;
+
+/* Pressure compensation filter object */
+typedef struct
+{
+    int32_t filtered;           /* Low-pass filtered pressure in Pa, PASCO2_PRESSURE_FRACTION_BITS fraction bits */
+    uint16_t reference;         /* Reference last written to the sensor in hPa */
+    bool filtered_valid;
+    bool reference_valid;
+    pasco2_pressure_stats_t stats;
+} pasco2_pressure_t;
+
+/*******************************************************************************
+ * Functions
+ ******************************************************************************/
+void pasco2_pressure_init(pasco2_pressure_t *pressure);
+void pasco2_pressure_update(pasco2_pressure_t *pressure, int32_t value);
+int32_t pasco2_pressure_get(const pasco2_pressure_t *pressure);
+bool pasco2_pressure_reference_due(pasco2_pressure_t *pressure, bool force, uint16_t *reference);
+void pasco2_pressure_reference_lost(pasco2_pressure_t *pressure);
+
+/* [] END OF FILE */
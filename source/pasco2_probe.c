@@ -0,0 +1,297 @@
+/*****************************************************************************
+** File name: pasco2_probe.c
+**
+** Description: This file implements the latency histograms of the hot-path
+** probes. Durations are sorted into logarithmic buckets so that recording is
+** constant time and the percentiles can be read back at any time.
+**
+** ===========================================================================
+** Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+** ===========================================================================
+**
+** ===========================================================================
+** Infineon Technologies AG (INFINEON) is supplying this file for use
+** exclusively with Infineon's sensor products. This file can be freely
+** distributed within development tools and software supporting such
+** products.
+**
+** THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+** OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+** MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+** INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+** WHATSOEVER.
+** ===========================================================================
+*/
+
+/* Header file includes */
+#include "FreeRTOS.h"
+#include "task.h"
+
+/* Header file for local module */
+#include "pasco2_probe.h"
+
+#if (PASCO2_PROBE_ENABLE != 0U)
+
+/*******************************************************************************
+ * Types
+ ******************************************************************************/
+typedef struct
+{
+    uint32_t count;
+    uint32_t min;
+    uint32_t max;
+    uint32_t buckets[PASCO2_PROBE_BUCKETS];
+} pasco2_probe_histogram_t;
+
+/*******************************************************************************
+ * Global Variables
+ ******************************************************************************/
+#define PASCO2_PROBE_NAME(id, name) name,
+static const char *const probe_names[PASCO2_PROBE_COUNT] =
+{
+    PASCO2_PROBES(PASCO2_PROBE_NAME)
+};
+#undef PASCO2_PROBE_NAME
+
+static pasco2_probe_histogram_t probe_histograms[PASCO2_PROBE_COUNT];
+
+/*******************************************************************************
+ * Function Name: pasco2_probe_bucket
+ *******************************************************************************
+ * Summary:
+ *   Maps a duration to its histogram bucket.
+ *
+ * Parameters:
+ *   ticks: duration in clock ticks
+ *
+ * Return:
+ *   index of the bucket
+ ******************************************************************************/
+static uint32_t pasco2_probe_bucket(uint32_t ticks)
+{
+    if (ticks < PASCO2_PROBE_SUB_BUCKETS)
+    {
+        return ticks;
+    }
+
+    /* Octave from the leading bit, sub-bucket from the two bits below it */
+    uint32_t msb = 31U - (uint32_t)__CLZ(ticks);
+    return ((msb - 1U) * PASCO2_PROBE_SUB_BUCKETS) + ((ticks >> (msb - 2U)) & (PASCO2_PROBE_SUB_BUCKETS - 1U));
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_probe_bucket_limit
+ *******************************************************************************
+ * Summary:
+ *   Returns the largest duration that falls into a bucket.
+ *
+ * Parameters:
+ *   bucket: index of the bucket
+ *
+ * Return:
+ *   upper bound of the bucket in clock ticks
+ ******************************************************************************/
+static uint32_t pasco2_probe_bucket_limit(uint32_t bucket)
+{
+    if (bucket < PASCO2_PROBE_SUB_BUCKETS)
+    {
+        return bucket;
+    }
+
+    uint32_t shift = (bucket / PASCO2_PROBE_SUB_BUCKETS) - 1U;
+    uint32_t lower = (PASCO2_PROBE_SUB_BUCKETS + (bucket % PASCO2_PROBE_SUB_BUCKETS)) << shift;
+    return lower + ((1UL << shift) - 1U);
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_probe_percentile
+ *******************************************************************************
+ * Summary:
+ *   Finds the bucket holding a percentile of a histogram. Called with
+ *   interrupts disabled.
+ *
+ * Parameters:
+ *   histogram: histogram to evaluate, must not be empty
+ *   percent: percentile [1-100]
+ *
+ * Return:
+ *   upper bound of the bucket, clipped to the recorded range
+ ******************************************************************************/
+static uint32_t pasco2_probe_percentile(const pasco2_probe_histogram_t *histogram, uint32_t percent)
+{
+    /* Rank of the percentile, rounded up */
+    uint32_t rank = (uint32_t)((((uint64_t)histogram->count * percent) + 99U) / 100U);
+    uint32_t seen = 0U;
+    uint32_t bucket = 0U;
+
+    for (; bucket < (PASCO2_PROBE_BUCKETS - 1U); bucket++)
+    {
+        seen += histogram->buckets[bucket];
+        if (seen >= rank)
+        {
+            break;
+        }
+    }
+
+    uint32_t limit = pasco2_probe_bucket_limit(bucket);
+    if (limit > histogram->max)
+    {
+        limit = histogram->max;
+    }
+    if (limit < histogram->min)
+    {
+        limit = histogram->min;
+    }
+    return limit;
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_probe_init
+ *******************************************************************************
+ * Summary:
+ *   Starts the cycle counter and clears the histograms.
+ *
+ * Parameters:
+ *   none
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+void pasco2_probe_init(void)
+{
+#if defined(DWT)
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0U;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+#endif
+    pasco2_probe_reset();
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_probe_record
+ *******************************************************************************
+ * Summary:
+ *   Adds a duration to the histogram of a probe.
+ *
+ * Parameters:
+ *   id: probe
+ *   ticks: duration in clock ticks
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+void pasco2_probe_record(pasco2_probe_id_t id, uint32_t ticks)
+{
+    CY_ASSERT(id < PASCO2_PROBE_COUNT);
+    pasco2_probe_histogram_t *histogram = &probe_histograms[id];
+    uint32_t bucket = pasco2_probe_bucket(ticks);
+
+    taskENTER_CRITICAL();
+    if ((histogram->count == 0U) || (ticks < histogram->min))
+    {
+        histogram->min = ticks;
+    }
+    if (ticks > histogram->max)
+    {
+        histogram->max = ticks;
+    }
+    histogram->count++;
+    histogram->buckets[bucket]++;
+    taskEXIT_CRITICAL();
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_probe_get_summary
+ *******************************************************************************
+ * Summary:
+ *   Returns the count, range and percentiles recorded by a probe.
+ *
+ * Parameters:
+ *   id: probe
+ *   summary: summary of the histogram, all zero if nothing was recorded
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+void pasco2_probe_get_summary(pasco2_probe_id_t id, pasco2_probe_summary_t *summary)
+{
+    CY_ASSERT(id < PASCO2_PROBE_COUNT);
+    const pasco2_probe_histogram_t *histogram = &probe_histograms[id];
+
+    *summary = (pasco2_probe_summary_t){ .count = 0U };
+
+    taskENTER_CRITICAL();
+    if (histogram->count != 0U)
+    {
+        summary->count = histogram->count;
+        summary->min = histogram->min;
+        summary->max = histogram->max;
+        summary->p50 = pasco2_probe_percentile(histogram, 50U);
+        summary->p99 = pasco2_probe_percentile(histogram, 99U);
+    }
+    taskEXIT_CRITICAL();
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_probe_name
+ *******************************************************************************
+ * Summary:
+ *   Returns the printable name of a probe.
+ *
+ * Parameters:
+ *   id: probe
+ *
+ * Return:
+ *   name of the probe
+ ******************************************************************************/
+const char *pasco2_probe_name(pasco2_probe_id_t id)
+{
+    CY_ASSERT(id < PASCO2_PROBE_COUNT);
+    return probe_names[id];
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_probe_ticks_to_ns
+ *******************************************************************************
+ * Summary:
+ *   Converts a duration to nanoseconds.
+ *
+ * Parameters:
+ *   ticks: duration in clock ticks
+ *
+ * Return:
+ *   duration in ns, saturated at UINT32_MAX
+ ******************************************************************************/
+uint32_t pasco2_probe_ticks_to_ns(uint32_t ticks)
+{
+    uint64_t ns = ((uint64_t)ticks * 1000000000U) / PASCO2_PROBE_CLOCK_HZ;
+    return (ns > UINT32_MAX) ? UINT32_MAX : (uint32_t)ns;
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_probe_reset
+ *******************************************************************************
+ * Summary:
+ *   Clears the histograms of all probes.
+ *
+ * Parameters:
+ *   none
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+void pasco2_probe_reset(void)
+{
+    for (uint32_t i = 0U; i < PASCO2_PROBE_COUNT; i++)
+    {
+        /* One probe at a time keeps the critical sections short */
+        taskENTER_CRITICAL();
+        probe_histograms[i] = (pasco2_probe_histogram_t){ .count = 0U };
+        taskEXIT_CRITICAL();
+    }
+}
+
+#endif /* PASCO2_PROBE_ENABLE */
+
+/* [] END OF FILE */
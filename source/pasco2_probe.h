@@ -0,0 +1,118 @@
+/******************************************************************************
+** File name: pasco2_probe.h
+**
+** Description: This file contains the hot-path latency probes and their
+**   histograms.
+**
+** ===========================================================================
+** Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+** ===========================================================================
+**
+** ===========================================================================
+** Infineon Technologies AG (INFINEON) is supplying this file for use
+** exclusively with Infineon's sensor products. This file can be freely
+** distributed within development tools and software supporting such
+** products.
+**
+** THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+** OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+** MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+** INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+** WHATSOEVER.
+** ===========================================================================
+*/
+
+#pragma once
+
+/* Header file includes */
+#include <stdint.h>
+
+#include "cy_pdl.h"
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+/* Set to 0 to remove all probes from the firmware. Probe sites then compile
+ * to nothing and the histogram tables are not linked. */
+#ifndef PASCO2_PROBE_ENABLE
+#define PASCO2_PROBE_ENABLE (1U)
+#endif
+
+/* Probe table: identifier and name. Each probe measures one stage of the
+ * acquisition or output path. Probes may only be used from task context. */
+#define PASCO2_PROBES(X)                                        \
+    X(PASCO2_PROBE_DPS_DRAIN,     "dps-drain")                  \
+    X(PASCO2_PROBE_DPS_COMPENSATE, "dps-compensate")            \
+    X(PASCO2_PROBE_CO2_PASS,      "co2-pass")                   \
+    X(PASCO2_PROBE_CO2_RESULT,    "co2-result")                 \
+    X(PASCO2_PROBE_STATS_ADD,     "stats-add")                  \
+    X(PASCO2_PROBE_RING_PUSH,     "ring-push")                  \
+    X(PASCO2_PROBE_OUTPUT_WRITE,  "output-write")               \
+    X(PASCO2_PROBE_OUTPUT_LED,    "output-led")                 \
+    X(PASCO2_PROBE_HISTORY_ADD,   "history-add")                \
+    X(PASCO2_PROBE_LOG_FORMAT,    "log-format")
+
+/* Histogram buckets: the values 0 to 3 get one bucket each, every further
+ * power of two is split into four buckets. This covers 32-bit durations
+ * with a relative error of at most 25%. */
+#define PASCO2_PROBE_SUB_BUCKETS (4U)
+#define PASCO2_PROBE_BUCKETS     (PASCO2_PROBE_SUB_BUCKETS * 31U)
+
+/* Time base of the probes. On target the DWT cycle counter runs at the CPU
+ * clock; it halts in deep sleep, so stages that block are measured in
+ * awake time. Host builds provide a monotonic clock in nanoseconds. */
+#if defined(DWT)
+#define PASCO2_PROBE_CLOCK()    (DWT->CYCCNT)
+#define PASCO2_PROBE_CLOCK_HZ   (SystemCoreClock)
+#else
+#define PASCO2_PROBE_CLOCK()    pasco2_probe_host_clock()
+#define PASCO2_PROBE_CLOCK_HZ   (1000000000U)
+#endif
+
+/* Measure the code between a BEGIN and the END of the same probe. Both must
+ * be in the same block; the clock is read once at each end. */
+#if (PASCO2_PROBE_ENABLE != 0U)
+#define PASCO2_PROBE_BEGIN(id)  const uint32_t id##_start = PASCO2_PROBE_CLOCK()
+#define PASCO2_PROBE_END(id)    pasco2_probe_record((id), PASCO2_PROBE_CLOCK() - id##_start)
+#else
+#define PASCO2_PROBE_BEGIN(id)
+#define PASCO2_PROBE_END(id)    ((void)0)
+#endif
+
+/*******************************************************************************
+ * Types
+ ******************************************************************************/
+#define PASCO2_PROBE_ID(id, name) id,
+typedef enum
+{
+    PASCO2_PROBES(PASCO2_PROBE_ID)
+    PASCO2_PROBE_COUNT
+} pasco2_probe_id_t;
+#undef PASCO2_PROBE_ID
+
+/* Summary of one histogram, durations in clock ticks */
+typedef struct
+{
+    uint32_t count;             /* Number of recorded durations */
+    uint32_t min;               /* Shortest duration */
+    uint32_t max;               /* Longest duration */
+    uint32_t p50;               /* Median, upper bound of its bucket */
+    uint32_t p99;               /* 99th percentile, upper bound of its bucket */
+} pasco2_probe_summary_t;
+
+/*******************************************************************************
+ * Functions
+ ******************************************************************************/
+void pasco2_probe_init(void);
+void pasco2_probe_record(pasco2_probe_id_t id, uint32_t ticks);
+void pasco2_probe_get_summary(pasco2_probe_id_t id, pasco2_probe_summary_t *summary);
+const char *pasco2_probe_name(pasco2_probe_id_t id);
+uint32_t pasco2_probe_ticks_to_ns(uint32_t ticks);
+void pasco2_probe_reset(void);
+
+#if !defined(DWT)
+uint32_t pasco2_probe_host_clock(void);
+#endif
+
+/* [] END OF FILE */
@@ -0,0 +1,357 @@
+/*****************************************************************************
+** File name: pasco2_rate.c
+**
+** Description: This file contains the adaptive measurement rate controller.
+**   It fits a trend line to the recent CO2 values and asks for the fast
+**   measurement period while the CO2 concentration changes, and for a
+**   longer period while CO2 and pressure are stable.
+**
+** ===========================================================================
+** Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+** ===========================================================================
+**
+** ===========================================================================
+** Infineon Technologies AG (INFINEON) is supplying this file for use
+** exclusively with Infineon's sensor products. This file can be freely
+** distributed within development tools and software supporting such
+** products.
+**
+** THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+** OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+** MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+** INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+** WHATSOEVER.
+** ===========================================================================
+*/
+
+/* Header file from system */
+#include <string.h>
+
+/* Header file includes */
+#include "cy_pdl.h"
+
+/* Header file for local module */
+#include "pasco2_rate.h"
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+/* The trend is fitted in units of 100 ms to keep the sums within 64 bits */
+#define PASCO2_RATE_TICKS_PER_UNIT (100U)
+#define PASCO2_RATE_UNITS_PER_MIN (600)
+
+/* Values needed for a trend */
+#define PASCO2_RATE_MIN_POINTS (3U)
+
+/*******************************************************************************
+ * Types
+ ******************************************************************************/
+/* Sums of the least-squares fit */
+typedef struct
+{
+    int64_t n;
+    int64_t sx;
+    int64_t sy;
+    int64_t sxx;
+    int64_t sxy;
+} pasco2_rate_fit_t;
+
+/*******************************************************************************
+ * Function Name: pasco2_rate_point
+ *******************************************************************************
+ * Summary:
+ *   Returns a point of the trend window.
+ *
+ * Parameters:
+ *   rate: controller object
+ *   index: 0 for the oldest point
+ *
+ * Return:
+ *   point
+ ******************************************************************************/
+static const pasco2_rate_point_t *pasco2_rate_point(const pasco2_rate_t *rate, uint32_t index)
+{
+    return &rate->points[(rate->head + index) % PASCO2_RATE_WINDOW_LENGTH];
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_rate_fit
+ *******************************************************************************
+ * Summary:
+ *   Sums the points of the trend window for the least-squares fit. The time
+ *   axis starts at the oldest point.
+ *
+ * Parameters:
+ *   rate: controller object
+ *   fit: sums to fill
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+static void pasco2_rate_fit(const pasco2_rate_t *rate, pasco2_rate_fit_t *fit)
+{
+    uint32_t origin = pasco2_rate_point(rate, 0U)->tick;
+
+    memset(fit, 0, sizeof(*fit));
+    for (uint32_t i = 0U; i < rate->count; i++)
+    {
+        const pasco2_rate_point_t *point = pasco2_rate_point(rate, i);
+        int64_t x = (int64_t)((point->tick - origin) / PASCO2_RATE_TICKS_PER_UNIT);
+        int64_t y = (int64_t)point->ppm;
+
+        fit->n++;
+        fit->sx += x;
+        fit->sy += y;
+        fit->sxx += x * x;
+        fit->sxy += x * y;
+    }
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_rate_slope
+ *******************************************************************************
+ * Summary:
+ *   Returns the slope of the trend line.
+ *
+ * Parameters:
+ *   fit: sums of the window
+ *
+ * Return:
+ *   slope in ppm per minute, 0 if all points share one time
+ ******************************************************************************/
+static int32_t pasco2_rate_slope(const pasco2_rate_fit_t *fit)
+{
+    int64_t den = (fit->n * fit->sxx) - (fit->sx * fit->sx);
+    int64_t num = (fit->n * fit->sxy) - (fit->sx * fit->sy);
+
+    if (den <= 0)
+    {
+        return 0;
+    }
+    return (int32_t)((num * PASCO2_RATE_UNITS_PER_MIN) / den);
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_rate_predict
+ *******************************************************************************
+ * Summary:
+ *   Extrapolates the trend line of the window to a time.
+ *
+ * Parameters:
+ *   rate: controller object with at least PASCO2_RATE_MIN_POINTS points
+ *   fit: sums of the window
+ *   tick: time in ms
+ *
+ * Return:
+ *   CO2 value on the trend line in ppm
+ ******************************************************************************/
+static int32_t pasco2_rate_predict(const pasco2_rate_t *rate, const pasco2_rate_fit_t *fit, uint32_t tick)
+{
+    int64_t x = (int64_t)((tick - pasco2_rate_point(rate, 0U)->tick) / PASCO2_RATE_TICKS_PER_UNIT);
+    int64_t den = (fit->n * fit->sxx) - (fit->sx * fit->sx);
+    int64_t num = (fit->n * fit->sxy) - (fit->sx * fit->sy);
+
+    if (den <= 0)
+    {
+        return (int32_t)(fit->sy / fit->n);
+    }
+    return (int32_t)(((fit->sy * den) + (num * ((fit->n * x) - fit->sx))) / (fit->n * den));
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_rate_pressure_span
+ *******************************************************************************
+ * Summary:
+ *   Returns the pressure range of the trend window.
+ *
+ * Parameters:
+ *   rate: controller object
+ *
+ * Return:
+ *   difference of the highest and lowest pressure in Pa, 0 without pressure
+ ******************************************************************************/
+static uint32_t pasco2_rate_pressure_span(const pasco2_rate_t *rate)
+{
+    int32_t low = INT32_MAX;
+    int32_t high = INT32_MIN;
+
+    for (uint32_t i = 0U; i < rate->count; i++)
+    {
+        const pasco2_rate_point_t *point = pasco2_rate_point(rate, i);
+        if (point->pressure_valid)
+        {
+            low = (point->pressure < low) ? point->pressure : low;
+            high = (point->pressure > high) ? point->pressure : high;
+        }
+    }
+
+    return (high >= low) ? (uint32_t)(high - low) : 0U;
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_rate_default_config
+ *******************************************************************************
+ * Summary:
+ *   Fills a configuration with the default bounds and thresholds.
+ *
+ * Parameters:
+ *   config: configuration to fill
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+void pasco2_rate_default_config(pasco2_rate_config_t *config)
+{
+    CY_ASSERT(config != NULL);
+
+    config->period_fast_s = PASCO2_RATE_PERIOD_FAST_S;
+    config->period_slow_s = PASCO2_RATE_PERIOD_SLOW_S;
+    config->slope_fast_ppm_min = PASCO2_RATE_SLOPE_FAST_PPM_MIN;
+    config->slope_slow_ppm_min = PASCO2_RATE_SLOPE_SLOW_PPM_MIN;
+    config->step_ppm = PASCO2_RATE_STEP_PPM;
+    config->pressure_stable_pa = PASCO2_RATE_PRESSURE_STABLE_PA;
+    config->hold_s = PASCO2_RATE_HOLD_S;
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_rate_init
+ *******************************************************************************
+ * Summary:
+ *   Initializes the controller. It starts at the fast period.
+ *
+ * Parameters:
+ *   rate: controller object
+ *   config: bounds and thresholds, NULL for the defaults
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+void pasco2_rate_init(pasco2_rate_t *rate, const pasco2_rate_config_t *config)
+{
+    CY_ASSERT(rate != NULL);
+
+    memset(rate, 0, sizeof(*rate));
+    if (config != NULL)
+    {
+        rate->config = *config;
+    }
+    else
+    {
+        pasco2_rate_default_config(&rate->config);
+    }
+    CY_ASSERT((rate->config.period_fast_s > 0U) && (rate->config.period_fast_s <= rate->config.period_slow_s));
+    CY_ASSERT(rate->config.slope_slow_ppm_min <= rate->config.slope_fast_ppm_min);
+
+    rate->period_s = rate->config.period_fast_s;
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_rate_update
+ *******************************************************************************
+ * Summary:
+ *   Evaluates a new CO2 value. A value that leaves the trend line of the
+ *   previous values by step_ppm, or a trend of slope_fast_ppm_min, selects the
+ *   fast period at once. The period doubles, up to the slow period, each time
+ *   the trend stays below slope_slow_ppm_min and the pressure range below
+ *   pressure_stable_pa for hold_s. The gap between the two slope thresholds
+ *   keeps noise from toggling the period.
+ *
+ * Parameters:
+ *   rate: controller object
+ *   tick: time of the value in ms
+ *   ppm: CO2 value
+ *   pressure: ambient pressure in Pa
+ *   pressure_valid: false if the pressure is not known
+ *
+ * Return:
+ *   true if rate->period_s changed
+ ******************************************************************************/
+bool pasco2_rate_update(pasco2_rate_t *rate, uint32_t tick, uint16_t ppm, int32_t pressure, bool pressure_valid)
+{
+    const pasco2_rate_config_t *config = &rate->config;
+    pasco2_rate_fit_t fit;
+    bool fast = false;
+    bool stable = false;
+
+    if (rate->stats.values++ == 0U)
+    {
+        rate->stable_tick = tick;
+    }
+
+    /* Distance from the trend line of the previous values */
+    rate->deviation_ppm = 0;
+    if (rate->count >= PASCO2_RATE_MIN_POINTS)
+    {
+        pasco2_rate_fit(rate, &fit);
+        rate->deviation_ppm = (int32_t)ppm - pasco2_rate_predict(rate, &fit, tick);
+    }
+
+    if ((uint32_t)((rate->deviation_ppm < 0) ? -rate->deviation_ppm : rate->deviation_ppm) >= config->step_ppm)
+    {
+        /* The values before the step would bend the new trend */
+        rate->count = 0U;
+        rate->reason = PASCO2_RATE_REASON_STEP;
+        fast = true;
+    }
+
+    if (rate->count == PASCO2_RATE_WINDOW_LENGTH)
+    {
+        rate->head = (uint8_t)((rate->head + 1U) % PASCO2_RATE_WINDOW_LENGTH);
+        rate->count--;
+    }
+    rate->points[(rate->head + rate->count) % PASCO2_RATE_WINDOW_LENGTH] = (pasco2_rate_point_t)
+    {
+        .tick = tick, .pressure = pressure, .ppm = ppm, .pressure_valid = pressure_valid
+    };
+    rate->count++;
+    while ((rate->count > PASCO2_RATE_MIN_POINTS) &&
+           ((tick - pasco2_rate_point(rate, 0U)->tick) > (PASCO2_RATE_WINDOW_S * 1000U)))
+    {
+        rate->head = (uint8_t)((rate->head + 1U) % PASCO2_RATE_WINDOW_LENGTH);
+        rate->count--;
+    }
+
+    rate->slope_ppm_min = 0;
+    if (rate->count >= PASCO2_RATE_MIN_POINTS)
+    {
+        pasco2_rate_fit(rate, &fit);
+        rate->slope_ppm_min = pasco2_rate_slope(&fit);
+        uint32_t slope = (uint32_t)((rate->slope_ppm_min < 0) ? -rate->slope_ppm_min : rate->slope_ppm_min);
+
+        if (!fast && (slope >= config->slope_fast_ppm_min))
+        {
+            rate->reason = PASCO2_RATE_REASON_TREND;
+            fast = true;
+        }
+        stable = (slope < config->slope_slow_ppm_min) &&
+                 (pasco2_rate_pressure_span(rate) < config->pressure_stable_pa);
+    }
+
+    if (fast || !stable)
+    {
+        rate->stable_tick = tick;
+        if (fast && (rate->period_s != config->period_fast_s))
+        {
+            rate->period_s = config->period_fast_s;
+            rate->stats.speedups++;
+            return true;
+        }
+        return false;
+    }
+
+    if (((tick - rate->stable_tick) >= ((uint32_t)config->hold_s * 1000U)) &&
+        (rate->period_s < config->period_slow_s))
+    {
+        uint32_t period = (uint32_t)rate->period_s * 2U;
+        rate->period_s = (uint16_t)((period < config->period_slow_s) ? period : config->period_slow_s);
+        rate->stable_tick = tick;
+        rate->reason = PASCO2_RATE_REASON_STABLE;
+        rate->stats.slowdowns++;
+        return true;
+    }
+
+    return false;
+}
+
+/* [] END OF FILE */
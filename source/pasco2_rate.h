@@ -0,0 +1,125 @@
+/******************************************************************************
+** File name: pasco2_rate.h
+**
+** Description: This file contains the types and function prototypes of the
+**   adaptive measurement rate controller.
+**
+** ===========================================================================
+** Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+** ===========================================================================
+**
+** ===========================================================================
+** Infineon Technologies AG (INFINEON) is supplying this file for use
+** exclusively with Infineon's sensor products. This file can be freely
+** distributed within development tools and software supporting such
+** products.
+**
+** THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+** OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+** MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+** INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+** WHATSOEVER.
+** ===========================================================================
+*/
+
+#pragma once
+
+/* Header file includes */
+#include <stdbool.h>
+#include <stdint.h>
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+/* Default bounds of the measurement period in seconds. The fast period is
+ * the default of the sensor task; the slow period matches the interval of the
+ * history log, which has a gap for every interval without a sample. */
+#define PASCO2_RATE_PERIOD_FAST_S (10U)
+#define PASCO2_RATE_PERIOD_SLOW_S (60U)
+
+/* CO2 trend in ppm per minute that switches to the fast period, and below
+ * which the period may grow again */
+#define PASCO2_RATE_SLOPE_FAST_PPM_MIN (10U)
+#define PASCO2_RATE_SLOPE_SLOW_PPM_MIN (4U)
+
+/* Deviation of a new value from the trend line in ppm that switches to the
+ * fast period at once */
+#define PASCO2_RATE_STEP_PPM (25U)
+
+/* Pressure span within the window in Pa above which the period stays */
+#define PASCO2_RATE_PRESSURE_STABLE_PA (50U)
+
+/* Time the trend must stay below PASCO2_RATE_SLOPE_SLOW_PPM_MIN before each
+ * doubling of the period */
+#define PASCO2_RATE_HOLD_S (300U)
+
+/* The trend is fitted to the newest values within this time, at most
+ * PASCO2_RATE_WINDOW_LENGTH of them, and at least three */
+#define PASCO2_RATE_WINDOW_S (300U)
+#define PASCO2_RATE_WINDOW_LENGTH (32U)
+
+/*******************************************************************************
+ * Types
+ ******************************************************************************/
+/* Bounds and thresholds of the controller */
+typedef struct
+{
+    uint16_t period_fast_s;     /* Period during CO2 changes */
+    uint16_t period_slow_s;     /* Longest period while CO2 is stable */
+    uint16_t slope_fast_ppm_min;
+    uint16_t slope_slow_ppm_min;
+    uint16_t step_ppm;
+    uint16_t pressure_stable_pa;
+    uint16_t hold_s;
+} pasco2_rate_config_t;
+
+/* Reason of a period change */
+typedef enum
+{
+    PASCO2_RATE_REASON_NONE,
+    PASCO2_RATE_REASON_STEP,    /* Value left the trend line */
+    PASCO2_RATE_REASON_TREND,   /* Trend above PASCO2_RATE_SLOPE_FAST_PPM_MIN */
+    PASCO2_RATE_REASON_STABLE   /* Trend and pressure stable for the hold time */
+} pasco2_rate_reason_t;
+
+/* Value of the trend window */
+typedef struct
+{
+    uint32_t tick;              /* Time of the value in ms */
+    int32_t pressure;           /* Ambient pressure in Pa */
+    uint16_t ppm;
+    bool pressure_valid;
+} pasco2_rate_point_t;
+
+/* Controller counters */
+typedef struct
+{
+    uint32_t values;            /* CO2 values evaluated */
+    uint32_t speedups;          /* Changes to the fast period */
+    uint32_t slowdowns;         /* Doublings of the period */
+} pasco2_rate_stats_t;
+
+/* Controller object */
+typedef struct
+{
+    pasco2_rate_config_t config;
+    uint16_t period_s;          /* Period the controller asks for */
+    pasco2_rate_reason_t reason; /* Reason of the last change */
+    int32_t slope_ppm_min;      /* Trend at the last value */
+    int32_t deviation_ppm;      /* Distance of the last value from the trend line */
+    uint32_t stable_tick;       /* Start of the current stable time in ms */
+    pasco2_rate_point_t points[PASCO2_RATE_WINDOW_LENGTH];
+    uint8_t head;               /* Index of the oldest point */
+    uint8_t count;
+    pasco2_rate_stats_t stats;
+} pasco2_rate_t;
+
+/*******************************************************************************
+ * Functions
+ ******************************************************************************/
+void pasco2_rate_default_config(pasco2_rate_config_t *config);
+void pasco2_rate_init(pasco2_rate_t *rate, const pasco2_rate_config_t *config);
+bool pasco2_rate_update(pasco2_rate_t *rate, uint32_t tick, uint16_t ppm, int32_t pressure, bool pressure_valid);
+
+/* [] END OF FILE */
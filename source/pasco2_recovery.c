@@ -0,0 +1,336 @@
+/*****************************************************************************
+** File name: pasco2_recovery.c
+**
+** Description: This file contains the fault detection and recovery of a
+**   sensor node. Failed readouts and missing CO2 values declare a fault; the
+**   recovery actions escalate from a bus clear to a sensor reset and a power
+**   cycle, and are repeated with exponential backoff until a new CO2 value
+**   arrives.
+**
+** ===========================================================================
+** Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+** ===========================================================================
+**
+** ===========================================================================
+** Infineon Technologies AG (INFINEON) is supplying this file for use
+** exclusively with Infineon's sensor products. This file can be freely
+** distributed within development tools and software supporting such
+** products.
+**
+** THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+** OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+** MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+** INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+** WHATSOEVER.
+** ===========================================================================
+*/
+
+/* Header file from system */
+#include <string.h>
+
+/* Header file for local module */
+#include "pasco2_recovery.h"
+
+/*******************************************************************************
+ * Function Name: pasco2_recovery_expired
+ *******************************************************************************
+ * Summary:
+ *   Tells whether a point in time has been reached, also across the
+ *   wrap-around of the millisecond counter.
+ *
+ * Parameters:
+ *   now_ms: current time
+ *   time_ms: point in time
+ *
+ * Return:
+ *   true if now_ms is at or after time_ms
+ ******************************************************************************/
+static bool pasco2_recovery_expired(uint32_t now_ms, uint32_t time_ms)
+{
+    return (int32_t)(now_ms - time_ms) >= 0;
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_recovery_fault
+ *******************************************************************************
+ * Summary:
+ *   Declares a fault of a healthy node. The first action is due at once.
+ *
+ * Parameters:
+ *   recovery: recovery object
+ *   now_ms: current time
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+static void pasco2_recovery_fault(pasco2_recovery_t *recovery, uint32_t now_ms)
+{
+    recovery->state = PASCO2_RECOVERY_STATE_FAULT;
+    recovery->action = PASCO2_RECOVERY_ACTION_NONE;
+    recovery->errors = 0U;
+    recovery->fault_ms = now_ms;
+    recovery->due_ms = now_ms;
+    recovery->backoff_ms = PASCO2_RECOVERY_BACKOFF_MIN_MS;
+    recovery->stats.faults++;
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_recovery_escalate
+ *******************************************************************************
+ * Summary:
+ *   Records a failed action and schedules the next one after the backoff
+ *   time, which doubles for the action after it.
+ *
+ * Parameters:
+ *   recovery: recovery object
+ *   now_ms: current time
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+static void pasco2_recovery_escalate(pasco2_recovery_t *recovery, uint32_t now_ms)
+{
+    recovery->state = PASCO2_RECOVERY_STATE_FAULT;
+    recovery->errors = 0U;
+    recovery->due_ms = now_ms + recovery->backoff_ms;
+    recovery->backoff_ms = (recovery->backoff_ms < (PASCO2_RECOVERY_BACKOFF_MAX_MS / 2U)) ?
+                           (recovery->backoff_ms * 2U) : PASCO2_RECOVERY_BACKOFF_MAX_MS;
+    recovery->stats.failed_actions++;
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_recovery_init
+ *******************************************************************************
+ * Summary:
+ *   Initializes the recovery object of a healthy node that has just been
+ *   configured.
+ *
+ * Parameters:
+ *   recovery: recovery object
+ *   max_action: last action of the escalation, the board may not be able to
+ *     switch the sensor supply
+ *   now_ms: current time
+ *   period_ms: measurement period
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+void pasco2_recovery_init(pasco2_recovery_t *recovery, pasco2_recovery_action_t max_action, uint32_t now_ms,
+                          uint32_t period_ms)
+{
+    memset(recovery, 0, sizeof(*recovery));
+    recovery->max_action = max_action;
+    recovery->state = PASCO2_RECOVERY_STATE_HEALTHY;
+    recovery->value_ms = now_ms;
+    recovery->deadline_ms = now_ms + (PASCO2_RECOVERY_STALE_PERIODS * period_ms);
+    recovery->backoff_ms = PASCO2_RECOVERY_BACKOFF_MIN_MS;
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_recovery_restart
+ *******************************************************************************
+ * Summary:
+ *   Restarts the value clock after the measurement mode or period of the node
+ *   has been changed, which restarts its measurements. The time without
+ *   values before the change is not counted as dropped. A node in the fault
+ *   state is left alone, its next action configures it anyway.
+ *
+ * Parameters:
+ *   recovery: recovery object
+ *   now_ms: current time
+ *   period_ms: new measurement period
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+void pasco2_recovery_restart(pasco2_recovery_t *recovery, uint32_t now_ms, uint32_t period_ms)
+{
+    if (recovery->state == PASCO2_RECOVERY_STATE_FAULT)
+    {
+        return;
+    }
+
+    if (recovery->state == PASCO2_RECOVERY_STATE_HEALTHY)
+    {
+        recovery->value_ms = now_ms;
+    }
+    recovery->deadline_ms = now_ms + (PASCO2_RECOVERY_STALE_PERIODS * period_ms);
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_recovery_error
+ *******************************************************************************
+ * Summary:
+ *   Records a failed pass of the node: a bus error or a sensor status error.
+ *   Repeated errors declare a fault, or fail the action being verified.
+ *
+ * Parameters:
+ *   recovery: recovery object
+ *   now_ms: current time
+ *
+ * Return:
+ *   true if the node has entered the fault state
+ ******************************************************************************/
+bool pasco2_recovery_error(pasco2_recovery_t *recovery, uint32_t now_ms)
+{
+    if (recovery->state == PASCO2_RECOVERY_STATE_FAULT)
+    {
+        return false;
+    }
+
+    recovery->errors++;
+    if (recovery->errors < PASCO2_RECOVERY_ERROR_THRESHOLD)
+    {
+        return false;
+    }
+
+    if (recovery->state == PASCO2_RECOVERY_STATE_HEALTHY)
+    {
+        pasco2_recovery_fault(recovery, now_ms);
+    }
+    else
+    {
+        pasco2_recovery_escalate(recovery, now_ms);
+    }
+
+    return true;
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_recovery_value
+ *******************************************************************************
+ * Summary:
+ *   Records a new CO2 value of the node. Measurement periods since the last
+ *   value that passed without one are counted as dropped samples. A value
+ *   after a recovery action ends the fault.
+ *
+ * Parameters:
+ *   recovery: recovery object
+ *   now_ms: current time
+ *   period_ms: measurement period
+ *
+ * Return:
+ *   true if the value has ended a fault
+ ******************************************************************************/
+bool pasco2_recovery_value(pasco2_recovery_t *recovery, uint32_t now_ms, uint32_t period_ms)
+{
+    uint32_t periods = ((now_ms - recovery->value_ms) + (period_ms / 2U)) / period_ms;
+    if (periods > 1U)
+    {
+        recovery->stats.dropped_samples += periods - 1U;
+    }
+
+    recovery->value_ms = now_ms;
+    recovery->deadline_ms = now_ms + (PASCO2_RECOVERY_STALE_PERIODS * period_ms);
+    recovery->errors = 0U;
+    if (recovery->state == PASCO2_RECOVERY_STATE_HEALTHY)
+    {
+        return false;
+    }
+
+    uint32_t recovery_ms = now_ms - recovery->fault_ms;
+    recovery->stats.recoveries++;
+    recovery->stats.recovery_ms_total += recovery_ms;
+    if (recovery_ms > recovery->stats.recovery_ms_max)
+    {
+        recovery->stats.recovery_ms_max = recovery_ms;
+    }
+    recovery->state = PASCO2_RECOVERY_STATE_HEALTHY;
+
+    return true;
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_recovery_check
+ *******************************************************************************
+ * Summary:
+ *   Declares a fault when the node has not delivered a CO2 value for
+ *   PASCO2_RECOVERY_STALE_PERIODS measurement periods, or fails the action
+ *   being verified.
+ *
+ * Parameters:
+ *   recovery: recovery object
+ *   now_ms: current time
+ *
+ * Return:
+ *   true if the node has entered the fault state
+ ******************************************************************************/
+bool pasco2_recovery_check(pasco2_recovery_t *recovery, uint32_t now_ms)
+{
+    if ((recovery->state == PASCO2_RECOVERY_STATE_FAULT) || !pasco2_recovery_expired(now_ms, recovery->deadline_ms))
+    {
+        return false;
+    }
+
+    if (recovery->state == PASCO2_RECOVERY_STATE_HEALTHY)
+    {
+        pasco2_recovery_fault(recovery, now_ms);
+    }
+    else
+    {
+        pasco2_recovery_escalate(recovery, now_ms);
+    }
+
+    return true;
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_recovery_due
+ *******************************************************************************
+ * Summary:
+ *   Returns the action to take now. Every action follows the one that failed
+ *   before it, the last one of the escalation is repeated.
+ *
+ * Parameters:
+ *   recovery: recovery object
+ *   now_ms: current time
+ *
+ * Return:
+ *   PASCO2_RECOVERY_ACTION_NONE if no action is due
+ ******************************************************************************/
+pasco2_recovery_action_t pasco2_recovery_due(const pasco2_recovery_t *recovery, uint32_t now_ms)
+{
+    if ((recovery->state != PASCO2_RECOVERY_STATE_FAULT) || !pasco2_recovery_expired(now_ms, recovery->due_ms))
+    {
+        return PASCO2_RECOVERY_ACTION_NONE;
+    }
+
+    return (recovery->action < recovery->max_action) ?
+           (pasco2_recovery_action_t)(recovery->action + 1) : recovery->max_action;
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_recovery_done
+ *******************************************************************************
+ * Summary:
+ *   Records the outcome of an action. After a successful action the node is
+ *   read again and the action is verified by the next CO2 value.
+ *
+ * Parameters:
+ *   recovery: recovery object
+ *   action: action taken
+ *   success: true if the action and the configuration of the node succeeded
+ *   now_ms: current time
+ *   period_ms: measurement period
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+void pasco2_recovery_done(pasco2_recovery_t *recovery, pasco2_recovery_action_t action, bool success,
+                          uint32_t now_ms, uint32_t period_ms)
+{
+    recovery->action = action;
+    recovery->stats.actions[action]++;
+    if (!success)
+    {
+        pasco2_recovery_escalate(recovery, now_ms);
+        return;
+    }
+
+    recovery->state = PASCO2_RECOVERY_STATE_VERIFY;
+    recovery->errors = 0U;
+    recovery->deadline_ms = now_ms + (PASCO2_RECOVERY_STALE_PERIODS * period_ms);
+}
+
+/* [] END OF FILE */
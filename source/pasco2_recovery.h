@@ -0,0 +1,108 @@
+/******************************************************************************
+** File name: pasco2_recovery.h
+**
+** Description: This file contains the types and function prototypes of the
+**   fault detection and recovery of a sensor node.
+**
+** ===========================================================================
+** Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+** ===========================================================================
+**
+** ===========================================================================
+** Infineon Technologies AG (INFINEON) is supplying this file for use
+** exclusively with Infineon's sensor products. This file can be freely
+** distributed within development tools and software supporting such
+** products.
+**
+** THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+** OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+** MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+** INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+** WHATSOEVER.
+** ===========================================================================
+*/
+
+#pragma once
+
+/* Header file includes */
+#include <stdbool.h>
+#include <stdint.h>
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+/* Consecutive failed passes of a node that declare a fault */
+#define PASCO2_RECOVERY_ERROR_THRESHOLD (3U)
+
+/* Measurement periods without a new CO2 value that declare a fault, also the
+ * time a recovery action is given to produce a value */
+#define PASCO2_RECOVERY_STALE_PERIODS (3U)
+
+/* Wait before the repetition of a failed recovery action. It doubles with
+ * every further failure up to the maximum. */
+#define PASCO2_RECOVERY_BACKOFF_MIN_MS (1000U)
+#define PASCO2_RECOVERY_BACKOFF_MAX_MS (60000U)
+
+/*******************************************************************************
+ * Types
+ ******************************************************************************/
+/* Recovery actions in the order of escalation */
+typedef enum
+{
+    PASCO2_RECOVERY_ACTION_NONE,
+    PASCO2_RECOVERY_ACTION_BUS_CLEAR,   /* Clock out the bus and initialize the I2C master again */
+    PASCO2_RECOVERY_ACTION_SENSOR_RESET, /* Soft reset and configure the sensors of the node again */
+    PASCO2_RECOVERY_ACTION_POWER_CYCLE, /* Switch the sensor supply off and on */
+    PASCO2_RECOVERY_ACTION_COUNT
+} pasco2_recovery_action_t;
+
+/* State of a node */
+typedef enum
+{
+    PASCO2_RECOVERY_STATE_HEALTHY,
+    PASCO2_RECOVERY_STATE_FAULT,        /* Readouts suspended until the next action is due */
+    PASCO2_RECOVERY_STATE_VERIFY        /* Action taken, waiting for a new CO2 value */
+} pasco2_recovery_state_t;
+
+/* Recovery counters of a node */
+typedef struct
+{
+    uint32_t faults;            /* Faults declared */
+    uint32_t recoveries;        /* Faults ended by a new CO2 value */
+    uint32_t actions[PASCO2_RECOVERY_ACTION_COUNT]; /* Actions taken, by action */
+    uint32_t failed_actions;    /* Actions that failed or produced no value */
+    uint32_t dropped_samples;   /* Measurement periods without a CO2 value */
+    uint32_t recovery_ms_total; /* Sum of the times from fault to recovery */
+    uint32_t recovery_ms_max;   /* Longest time from fault to recovery */
+} pasco2_recovery_stats_t;
+
+/* Recovery object of a node */
+typedef struct
+{
+    pasco2_recovery_action_t max_action; /* Last action of the escalation */
+    pasco2_recovery_state_t state;
+    pasco2_recovery_action_t action; /* Last action taken */
+    uint8_t errors;             /* Consecutive failed passes */
+    uint32_t value_ms;          /* Time of the last CO2 value */
+    uint32_t deadline_ms;       /* Time by which the next CO2 value is expected */
+    uint32_t fault_ms;          /* Time the current fault was declared */
+    uint32_t due_ms;            /* Time the next action is due in the fault state */
+    uint32_t backoff_ms;        /* Wait after the next failed action */
+    pasco2_recovery_stats_t stats;
+} pasco2_recovery_t;
+
+/*******************************************************************************
+ * Functions
+ ******************************************************************************/
+void pasco2_recovery_init(pasco2_recovery_t *recovery, pasco2_recovery_action_t max_action, uint32_t now_ms,
+                          uint32_t period_ms);
+void pasco2_recovery_restart(pasco2_recovery_t *recovery, uint32_t now_ms, uint32_t period_ms);
+bool pasco2_recovery_error(pasco2_recovery_t *recovery, uint32_t now_ms);
+bool pasco2_recovery_value(pasco2_recovery_t *recovery, uint32_t now_ms, uint32_t period_ms);
+bool pasco2_recovery_check(pasco2_recovery_t *recovery, uint32_t now_ms);
+pasco2_recovery_action_t pasco2_recovery_due(const pasco2_recovery_t *recovery, uint32_t now_ms);
+void pasco2_recovery_done(pasco2_recovery_t *recovery, pasco2_recovery_action_t action, bool success,
+                          uint32_t now_ms, uint32_t period_ms);
+
+/* [] END OF FILE */
@@ -0,0 +1,213 @@
+/*****************************************************************************
+** File name: pasco2_rtos.c
+**
+** Description: This file creates the tasks and semaphores of the application,
+**   on the FreeRTOS heap or, with PASCO2_STATIC_ALLOCATION, in static memory,
+**   and reports the stack high-water marks of the tasks.
+**
+** ===========================================================================
+** Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+** ===========================================================================
+**
+** ===========================================================================
+** Infineon Technologies AG (INFINEON) is supplying this file for use
+** exclusively with Infineon's sensor products. This file can be freely
+** distributed within development tools and software supporting such
+** products.
+**
+** THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+** OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+** MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+** INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+** WHATSOEVER.
+** ===========================================================================
+*/
+
+/* Header file includes */
+#include "cy_pdl.h"
+#include "task.h"
+
+/* Header file for local module */
+#include "pasco2_rtos.h"
+
+/*******************************************************************************
+ * Global Variables
+ ******************************************************************************/
+/* Running tasks of the application, in creation order */
+static pasco2_rtos_thread_t *threads[PASCO2_RTOS_MAX_THREADS];
+static uint8_t thread_count;
+
+/*******************************************************************************
+ * Function Name: pasco2_rtos_create_thread
+ *******************************************************************************
+ * Summary:
+ *   Creates a task on the stack of its thread object and registers it for the
+ *   stack usage report. In the static allocation mode the task control block
+ *   is part of the thread object and nothing is taken from the heap.
+ *
+ * Parameters:
+ *   thread: thread object defined with PASCO2_RTOS_THREAD_DEFINE
+ *   entry_function: task function
+ *   name: task name
+ *   priority: task priority
+ *   arg: argument of the task function
+ *
+ * Return:
+ *   CY_RSLT_SUCCESS, or the error of the RTOS abstraction
+ ******************************************************************************/
+cy_rslt_t pasco2_rtos_create_thread(pasco2_rtos_thread_t *thread, cy_thread_entry_fn_t entry_function,
+                                    const char *name, cy_thread_priority_t priority, cy_thread_arg_t arg)
+{
+    cy_rslt_t result;
+
+    CY_ASSERT(thread_count < PASCO2_RTOS_MAX_THREADS);
+
+    thread->name = name;
+#if (PASCO2_STATIC_ALLOCATION != 0U)
+    thread->handle = xTaskCreateStatic((TaskFunction_t)entry_function, name,
+                                       thread->stack_size / sizeof(StackType_t), arg, (UBaseType_t)priority,
+                                       thread->stack, &thread->tcb);
+    result = (thread->handle != NULL) ? CY_RSLT_SUCCESS : CY_RTOS_GENERAL_ERROR;
+#else
+    result = cy_rtos_create_thread(&thread->handle, entry_function, name, NULL, thread->stack_size, priority, arg);
+#endif
+
+    if (result == CY_RSLT_SUCCESS)
+    {
+        taskENTER_CRITICAL();
+        threads[thread_count++] = thread;
+        taskEXIT_CRITICAL();
+    }
+
+    return result;
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_rtos_exit_thread
+ *******************************************************************************
+ * Summary:
+ *   Ends the calling task and removes it from the stack usage report. The
+ *   RTOS abstraction only ends tasks it has created itself.
+ *
+ * Parameters:
+ *   none
+ *
+ * Return:
+ *   none, does not return
+ ******************************************************************************/
+void pasco2_rtos_exit_thread(void)
+{
+    TaskHandle_t self = xTaskGetCurrentTaskHandle();
+
+    taskENTER_CRITICAL();
+    for (uint8_t i = 0U; i < thread_count; i++)
+    {
+        if ((TaskHandle_t)threads[i]->handle == self)
+        {
+            threads[i] = threads[--thread_count];
+            break;
+        }
+    }
+    taskEXIT_CRITICAL();
+
+#if (PASCO2_STATIC_ALLOCATION != 0U)
+    vTaskDelete(NULL);
+#else
+    (void)cy_rtos_exit_thread();
+#endif
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_rtos_init_semaphore
+ *******************************************************************************
+ * Summary:
+ *   Creates a counting semaphore. In the static allocation mode it is placed
+ *   in the given storage; the RTOS abstraction keeps using the handle, which
+ *   is the FreeRTOS semaphore handle.
+ *
+ * Parameters:
+ *   semaphore: receives the semaphore
+ *   storage: memory of the semaphore in the static allocation mode
+ *   maxcount: maximum count
+ *   initcount: initial count
+ *
+ * Return:
+ *   CY_RSLT_SUCCESS, or the error of the RTOS abstraction
+ ******************************************************************************/
+cy_rslt_t pasco2_rtos_init_semaphore(cy_semaphore_t *semaphore, pasco2_rtos_semaphore_storage_t *storage,
+                                     uint32_t maxcount, uint32_t initcount)
+{
+#if (PASCO2_STATIC_ALLOCATION != 0U)
+    if ((maxcount == 0U) || (initcount > maxcount))
+    {
+        return CY_RTOS_BAD_PARAM;
+    }
+
+    *semaphore = xSemaphoreCreateCountingStatic((UBaseType_t)maxcount, (UBaseType_t)initcount, storage);
+    return (*semaphore != NULL) ? CY_RSLT_SUCCESS : CY_RTOS_GENERAL_ERROR;
+#else
+    (void)storage;
+    return cy_rtos_init_semaphore(semaphore, maxcount, initcount);
+#endif
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_rtos_init_mutex
+ *******************************************************************************
+ * Summary:
+ *   Creates a mutex with priority inheritance. In the static allocation mode
+ *   it is placed in the given storage. The mutex is used with the FreeRTOS
+ *   API, the RTOS abstraction has no handle type for it.
+ *
+ * Parameters:
+ *   mutex: receives the mutex
+ *   storage: memory of the mutex in the static allocation mode
+ *
+ * Return:
+ *   CY_RSLT_SUCCESS, or CY_RTOS_NO_MEMORY
+ ******************************************************************************/
+cy_rslt_t pasco2_rtos_init_mutex(SemaphoreHandle_t *mutex, pasco2_rtos_semaphore_storage_t *storage)
+{
+#if (PASCO2_STATIC_ALLOCATION != 0U)
+    *mutex = xSemaphoreCreateMutexStatic(storage);
+#else
+    (void)storage;
+    *mutex = xSemaphoreCreateMutex();
+#endif
+    return (*mutex != NULL) ? CY_RSLT_SUCCESS : CY_RTOS_NO_MEMORY;
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_rtos_get_stack_stats
+ *******************************************************************************
+ * Summary:
+ *   Returns the stack size of a task and the smallest amount of its stack
+ *   that has been free so far. FreeRTOS fills the stack with a known value
+ *   when the task is created, so the high-water mark covers the deepest call
+ *   the task has made, including the exception frames that interrupts
+ *   stacked on it.
+ *
+ * Parameters:
+ *   index: task index, counting the running tasks in creation order
+ *   stats: destination of the stack usage
+ *
+ * Return:
+ *   true if the task exists
+ ******************************************************************************/
+bool pasco2_rtos_get_stack_stats(uint32_t index, pasco2_rtos_stack_stats_t *stats)
+{
+    if (index >= thread_count)
+    {
+        return false;
+    }
+
+    const pasco2_rtos_thread_t *thread = threads[index];
+    stats->name = thread->name;
+    stats->stack_size = thread->stack_size;
+    stats->stack_free_min = (uint32_t)uxTaskGetStackHighWaterMark((TaskHandle_t)thread->handle) *
+                            (uint32_t)sizeof(StackType_t);
+    return true;
+}
+
+/* [] END OF FILE */
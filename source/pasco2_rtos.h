@@ -0,0 +1,101 @@
+/******************************************************************************
+** File name: pasco2_rtos.h
+**
+** Description: This file contains the types and function prototypes of the
+**   kernel objects of the application: tasks and semaphores placed on the
+**   FreeRTOS heap or in static memory, and the stack usage of the tasks.
+**
+** ===========================================================================
+** Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+** ===========================================================================
+**
+** ===========================================================================
+** Infineon Technologies AG (INFINEON) is supplying this file for use
+** exclusively with Infineon's sensor products. This file can be freely
+** distributed within development tools and software supporting such
+** products.
+**
+** THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+** OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+** MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+** INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+** WHATSOEVER.
+** ===========================================================================
+*/
+
+#pragma once
+
+/* Header file from system */
+#include <stdbool.h>
+
+/* Header file includes */
+#include "cyabs_rtos.h"
+#include "semphr.h"
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+/* Set to 1 to place the stacks, task control blocks, and semaphores of the
+ * application in static memory. The FreeRTOS heap then only holds the
+ * objects of the libraries, see FreeRTOSConfig.h. */
+#ifndef PASCO2_STATIC_ALLOCATION
+#define PASCO2_STATIC_ALLOCATION (0U)
+#endif
+
+/* Tasks of the application whose stack usage is reported */
+#define PASCO2_RTOS_MAX_THREADS (4U)
+
+/* Defines a thread object and, in the static allocation mode, its stack.
+ * size is the stack size in bytes. */
+#if (PASCO2_STATIC_ALLOCATION != 0U)
+#define PASCO2_RTOS_THREAD_DEFINE(name, size)                                   \
+    static StackType_t name##_stack[(size) / sizeof(StackType_t)];             \
+    static pasco2_rtos_thread_t name = { .stack = name##_stack, .stack_size = (size) }
+#else
+#define PASCO2_RTOS_THREAD_DEFINE(name, size)                                   \
+    static pasco2_rtos_thread_t name = { .stack = NULL, .stack_size = (size) }
+#endif
+
+/*******************************************************************************
+ * Types
+ ******************************************************************************/
+/* Thread object, defined with PASCO2_RTOS_THREAD_DEFINE */
+typedef struct
+{
+    cy_thread_t handle;
+    const char *name;
+    StackType_t *stack;         /* NULL for a stack on the heap */
+    uint32_t stack_size;        /* Bytes */
+#if (PASCO2_STATIC_ALLOCATION != 0U)
+    StaticTask_t tcb;
+#endif
+} pasco2_rtos_thread_t;
+
+/* Memory of a semaphore or mutex, only used in the static allocation mode */
+#if (PASCO2_STATIC_ALLOCATION != 0U)
+typedef StaticSemaphore_t pasco2_rtos_semaphore_storage_t;
+#else
+typedef uint8_t pasco2_rtos_semaphore_storage_t;
+#endif
+
+/* Stack usage of a task */
+typedef struct
+{
+    const char *name;
+    uint32_t stack_size;        /* Bytes */
+    uint32_t stack_free_min;    /* Smallest free stack since the start of the task in bytes */
+} pasco2_rtos_stack_stats_t;
+
+/*******************************************************************************
+ * Functions
+ ******************************************************************************/
+cy_rslt_t pasco2_rtos_create_thread(pasco2_rtos_thread_t *thread, cy_thread_entry_fn_t entry_function,
+                                    const char *name, cy_thread_priority_t priority, cy_thread_arg_t arg);
+void pasco2_rtos_exit_thread(void);
+cy_rslt_t pasco2_rtos_init_semaphore(cy_semaphore_t *semaphore, pasco2_rtos_semaphore_storage_t *storage,
+                                     uint32_t maxcount, uint32_t initcount);
+cy_rslt_t pasco2_rtos_init_mutex(SemaphoreHandle_t *mutex, pasco2_rtos_semaphore_storage_t *storage);
+bool pasco2_rtos_get_stack_stats(uint32_t index, pasco2_rtos_stack_stats_t *stats);
+
+/* [] END OF FILE */
@@ -0,0 +1,170 @@
+/*****************************************************************************
+** File name: pasco2_sample_ring.c
+**
+** Description: This file implements a lock-free single-producer/single-consumer
+** ring of CO2 sample records. The sensor task produces records and the output
+** task consumes them, so a slow consumer never stalls the acquisition loop.
+**
+** ===========================================================================
+** Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+** ===========================================================================
+**
+** ===========================================================================
+** Infineon Technologies AG (INFINEON) is supplying this file for use
+** exclusively with Infineon's sensor products. This file can be freely
+** distributed within development tools and software supporting such
+** products.
+**
+** THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+** OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+** MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+** INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+** WHATSOEVER.
+** ===========================================================================
+*/
+
+/* Header file from system */
+#include <string.h>
+
+/* Header file for local module */
+#include "pasco2_sample_ring.h"
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+#define PASCO2_SAMPLE_RING_MASK (PASCO2_SAMPLE_RING_CAPACITY - 1U)
+
+#if ((PASCO2_SAMPLE_RING_CAPACITY & PASCO2_SAMPLE_RING_MASK) != 0U)
+#error "PASCO2_SAMPLE_RING_CAPACITY must be a power of two"
+#endif
+
+/*******************************************************************************
+ * Function Name: pasco2_sample_ring_init
+ *******************************************************************************
+ * Summary:
+ *   Empties the ring and clears its counters. Must be called before the
+ *   producer and consumer start.
+ *
+ * Parameters:
+ *   ring: ring object
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+void pasco2_sample_ring_init(pasco2_sample_ring_t *ring)
+{
+    memset(ring, 0, sizeof(*ring));
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_sample_ring_push
+ *******************************************************************************
+ * Summary:
+ *   Appends a record to the ring. Called by the producer only. The record is
+ *   dropped and counted as overflow when the ring is full.
+ *
+ * Parameters:
+ *   ring: ring object
+ *   sample: record to append
+ *
+ * Return:
+ *   true if the record was stored, false on overflow
+ ******************************************************************************/
+bool pasco2_sample_ring_push(pasco2_sample_ring_t *ring, const pasco2_sample_t *sample)
+{
+    uint32_t head = ring->head;
+    uint32_t used = head - ring->tail;
+
+    if (used >= PASCO2_SAMPLE_RING_CAPACITY)
+    {
+        ring->stats.overflows++;
+        return false;
+    }
+
+    ring->records[head & PASCO2_SAMPLE_RING_MASK] = *sample;
+
+    /* Record contents must be visible before the consumer sees the new head */
+    __DMB();
+    ring->head = head + 1U;
+
+    ring->stats.pushed++;
+    if ((used + 1U) > ring->stats.high_water)
+    {
+        ring->stats.high_water = used + 1U;
+    }
+
+    return true;
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_sample_ring_pop
+ *******************************************************************************
+ * Summary:
+ *   Removes the oldest record from the ring. Called by the consumer only.
+ *
+ * Parameters:
+ *   ring: ring object
+ *   sample: destination of the record
+ *
+ * Return:
+ *   true if a record was removed, false if the ring was empty
+ ******************************************************************************/
+bool pasco2_sample_ring_pop(pasco2_sample_ring_t *ring, pasco2_sample_t *sample)
+{
+    uint32_t tail = ring->tail;
+
+    if (tail == ring->head)
+    {
+        return false;
+    }
+
+    /* Do not read the record before the head update has been observed */
+    __DMB();
+    *sample = ring->records[tail & PASCO2_SAMPLE_RING_MASK];
+
+    /* Record must be copied out before the producer may overwrite the slot */
+    __DMB();
+    ring->tail = tail + 1U;
+
+    return true;
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_sample_ring_count
+ *******************************************************************************
+ * Summary:
+ *   Returns the number of records currently held by the ring.
+ *
+ * Parameters:
+ *   ring: ring object
+ *
+ * Return:
+ *   number of records
+ ******************************************************************************/
+uint32_t pasco2_sample_ring_count(const pasco2_sample_ring_t *ring)
+{
+    return ring->head - ring->tail;
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_sample_ring_get_stats
+ *******************************************************************************
+ * Summary:
+ *   Returns a copy of the occupancy counters. The counters are written by the
+ *   producer, so a reader in another task may observe a torn snapshot across
+ *   fields, but never a torn field.
+ *
+ * Parameters:
+ *   ring: ring object
+ *   stats: destination of the counters
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+void pasco2_sample_ring_get_stats(const pasco2_sample_ring_t *ring, pasco2_sample_ring_stats_t *stats)
+{
+    *stats = ring->stats;
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,86 @@
+/******************************************************************************
+** File name: pasco2_sample_ring.h
+**
+** Description: This file contains the types and function prototypes of the
+**   single-producer/single-consumer ring of CO2 sample records.
+**
+** ===========================================================================
+** Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+** ===========================================================================
+**
+** ===========================================================================
+** Infineon Technologies AG (INFINEON) is supplying this file for use
+** exclusively with Infineon's sensor products. This file can be freely
+** distributed within development tools and software supporting such
+** products.
+**
+** THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+** OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+** MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+** INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+** WHATSOEVER.
+** ===========================================================================
+*/
+
+#pragma once
+
+/* Header file includes */
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "cy_pdl.h"
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+/* Number of records in the sample ring, must be a power of two */
+#define PASCO2_SAMPLE_RING_CAPACITY (16U)
+
+/* Sample record flags */
+#define PASCO2_SAMPLE_PPM_VALID      (1U << 0)   /* ppm holds a new CO2 value */
+#define PASCO2_SAMPLE_PRESSURE_VALID (1U << 1)   /* pressure and temperature come from the DPS3xx */
+#define PASCO2_SAMPLE_STATUS_VALID   (1U << 2)   /* status holds the sensor status register */
+
+/*******************************************************************************
+ * Types
+ ******************************************************************************/
+/* Timestamped record of one pass of the acquisition loop */
+typedef struct
+{
+    uint32_t tick;              /* RTOS time of the readout in ms */
+    int32_t pressure;           /* Ambient pressure in Pa */
+    int16_t temperature;        /* Ambient temperature in 0.01 degree Celsius */
+    uint16_t ppm;               /* CO2 concentration in ppm */
+    uint8_t status;             /* PAS CO2 sensor status register */
+    uint8_t flags;              /* PASCO2_SAMPLE_xxx flags */
+    uint8_t sensor;             /* Index of the sensor node */
+} pasco2_sample_t;
+
+/* Occupancy counters of the sample ring */
+typedef struct
+{
+    uint32_t pushed;            /* Number of records accepted by the ring */
+    uint32_t overflows;         /* Number of records dropped because the ring was full */
+    uint32_t high_water;        /* Largest number of records held at once */
+} pasco2_sample_ring_stats_t;
+
+/* Ring object. head is only written by the producer, tail only by the consumer. */
+typedef struct
+{
+    volatile uint32_t head;
+    volatile uint32_t tail;
+    pasco2_sample_ring_stats_t stats;
+    pasco2_sample_t records[PASCO2_SAMPLE_RING_CAPACITY];
+} pasco2_sample_ring_t;
+
+/*******************************************************************************
+ * Functions
+ ******************************************************************************/
+void pasco2_sample_ring_init(pasco2_sample_ring_t *ring);
+bool pasco2_sample_ring_push(pasco2_sample_ring_t *ring, const pasco2_sample_t *sample);
+bool pasco2_sample_ring_pop(pasco2_sample_ring_t *ring, pasco2_sample_t *sample);
+uint32_t pasco2_sample_ring_count(const pasco2_sample_ring_t *ring);
+void pasco2_sample_ring_get_stats(const pasco2_sample_ring_t *ring, pasco2_sample_ring_stats_t *stats);
+
+/* [] END OF FILE */
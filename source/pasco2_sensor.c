@@ -0,0 +1,525 @@
+/*****************************************************************************
+** File name: pasco2_sensor.c
+**
+** Description: This file implements a sensor node: bring-up of a PAS CO2 and
+**   an optional DPS3xx behind one bus route, and the I2C engine requests of
+**   a CO2 readout or single-shot trigger.
+**
+** ===========================================================================
+** Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+** ===========================================================================
+**
+** ===========================================================================
+** Infineon Technologies AG (INFINEON) is supplying this file for use
+** exclusively with Infineon's sensor products. This file can be freely
+** distributed within development tools and software supporting such
+** products.
+**
+** THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+** OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+** MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+** INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+** WHATSOEVER.
+** ===========================================================================
+*/
+
+/* Header file from system */
+#include <string.h>
+
+/* Header file for library */
+#include "xensiv_dps3xx_mtb.h"
+
+/* Header file for local module */
+#include "pasco2_sensor.h"
+
+/*******************************************************************************
+ * Function Name: pasco2_sensor_drdy_isr
+ *******************************************************************************
+ * Summary:
+ *   Handler of the sensor data-ready interrupt. Records the time of the event
+ *   and wakes up the sensor task, which performs the actual readout.
+ *
+ * Parameters:
+ *   callback_arg: sensor node object
+ *   event: GPIO event that triggered the interrupt
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+static void pasco2_sensor_drdy_isr(void *callback_arg, cyhal_gpio_event_t event)
+{
+    (void)event;
+    pasco2_sensor_t *sensor = (pasco2_sensor_t *)callback_arg;
+    BaseType_t higher_priority_task_woken = pdFALSE;
+
+    sensor->drdy_tick = xTaskGetTickCountFromISR();
+    sensor->drdy = true;
+    vTaskNotifyGiveFromISR(sensor->task, &higher_priority_task_woken);
+    portYIELD_FROM_ISR(higher_priority_task_woken);
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_sensor_init_dps
+ *******************************************************************************
+ * Summary:
+ *   Brings up the DPS3xx of a node with the driver library and takes it over
+ *   in background mode with its FIFO enabled. The FIFO counters are kept.
+ *
+ * Parameters:
+ *   sensor: sensor node object, its mux channel selected
+ *
+ * Return:
+ *   Result of the bring-up
+ ******************************************************************************/
+static cy_rslt_t pasco2_sensor_init_dps(pasco2_sensor_t *sensor)
+{
+    const pasco2_sensor_config_t *config = sensor->config;
+    pasco2_dps_fifo_stats_t stats = sensor->dps.stats;
+    xensiv_dps3xx_t xensiv_dps3xx;
+
+    cy_rslt_t result = xensiv_dps3xx_mtb_init_i2c(&xensiv_dps3xx, sensor->engine->i2c,
+                                                  (xensiv_dps3xx_i2c_addr_t)config->dps_address);
+    if (result == CY_RSLT_SUCCESS)
+    {
+        result = pasco2_dps_fifo_init(&sensor->dps, sensor->engine, &config->route, config->dps_address);
+        sensor->dps.stats = stats;
+    }
+    sensor->use_dps = (result == CY_RSLT_SUCCESS);
+
+    return result;
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_sensor_init
+ *******************************************************************************
+ * Summary:
+ *   Brings up the DPS3xx of a sensor node with the driver library and takes
+ *   it over in background mode with its FIFO enabled. The DPS3xx is ready
+ *   long before the PAS CO2, so this runs while the PAS CO2 powers up;
+ *   pasco2_sensor_start completes the node.
+ *
+ * Parameters:
+ *   sensor: sensor node object
+ *   config: board description of the node
+ *   engine: I2C engine of the bus of the node
+ *   task: task woken up by the data-ready interrupt
+ *
+ * Return:
+ *   CY_RSLT_SUCCESS if the mux channel of the node was selected, a missing
+ *   DPS3xx only clears use_dps
+ ******************************************************************************/
+cy_rslt_t pasco2_sensor_init(pasco2_sensor_t *sensor, const pasco2_sensor_config_t *config,
+                             pasco2_i2c_engine_t *engine, TaskHandle_t task)
+{
+    memset(sensor, 0, sizeof(*sensor));
+    sensor->config = config;
+    sensor->engine = engine;
+    sensor->task = task;
+    pasco2_pressure_init(&sensor->pressure);
+
+    /* The blocking driver calls below reach the node through the mux */
+    cy_rslt_t result = pasco2_i2c_engine_select(engine, &config->route, PASCO2_SENSOR_I2C_TIMEOUT_MS);
+    if (result != CY_RSLT_SUCCESS)
+    {
+        return result;
+    }
+
+    if (config->dps_address != 0U)
+    {
+        (void)pasco2_sensor_init_dps(sensor);
+    }
+
+    return CY_RSLT_SUCCESS;
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_sensor_wait_ready
+ *******************************************************************************
+ * Summary:
+ *   Polls the PAS CO2 status until the sensor reports ready. The sensor does
+ *   not acknowledge its address while it powers up; afterwards the SEN_RDY
+ *   bit tells that it accepts a configuration.
+ *
+ * Parameters:
+ *   sensor: sensor node object, initialized with pasco2_sensor_init
+ *   deadline: tick after which the sensor is given up
+ *   polls: incremented for every status read
+ *
+ * Return:
+ *   CY_RSLT_SUCCESS once the sensor is ready, PASCO2_RSLT_ERR_NOT_READY or
+ *   the last I2C error at the deadline
+ ******************************************************************************/
+cy_rslt_t pasco2_sensor_wait_ready(pasco2_sensor_t *sensor, TickType_t deadline, uint32_t *polls)
+{
+    cy_rslt_t result = pasco2_i2c_engine_select(sensor->engine, &sensor->config->route, PASCO2_SENSOR_I2C_TIMEOUT_MS);
+    if (result != CY_RSLT_SUCCESS)
+    {
+        return result;
+    }
+
+    for (;;)
+    {
+        uint8_t status = 0U;
+
+        (*polls)++;
+        result = cyhal_i2c_master_mem_read(sensor->engine->i2c, XENSIV_PASCO2_I2C_ADDR, XENSIV_PASCO2_REG_SENS_STS, 1U,
+                                           &status, 1U, PASCO2_SENSOR_I2C_TIMEOUT_MS);
+        if ((result == CY_RSLT_SUCCESS) && ((status & XENSIV_PASCO2_REG_SENS_STS_SEN_RDY_MSK) != 0U))
+        {
+            return CY_RSLT_SUCCESS;
+        }
+        if ((int32_t)(xTaskGetTickCount() - deadline) >= 0)
+        {
+            return (result == CY_RSLT_SUCCESS) ? PASCO2_RSLT_ERR_NOT_READY : result;
+        }
+
+        vTaskDelay(pdMS_TO_TICKS(PASCO2_SENSOR_READY_POLL_MS));
+    }
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_sensor_start
+ *******************************************************************************
+ * Summary:
+ *   Configures a ready PAS CO2 with default parameters, lets it signal data
+ *   ready to the sensor task if its INT line is routed, and applies the
+ *   measurement mode with PASCO2_SENSOR_BOC_CFG. The library leaves the ABOC
+ *   of the sensor as it comes out of reset, which is enabled. The data-ready
+ *   input is set up once, a restart of the node only configures the sensor.
+ *
+ * Parameters:
+ *   sensor: sensor node object, ready after pasco2_sensor_wait_ready
+ *   single_shot: true for single-shot mode, false for continuous mode
+ *   period: measurement period in seconds for continuous mode
+ *
+ * Return:
+ *   CY_RSLT_SUCCESS if the PAS CO2 is operational
+ ******************************************************************************/
+cy_rslt_t pasco2_sensor_start(pasco2_sensor_t *sensor, bool single_shot, uint16_t period)
+{
+    const pasco2_sensor_config_t *config = sensor->config;
+
+    cy_rslt_t result = pasco2_i2c_engine_select(sensor->engine, &config->route, PASCO2_SENSOR_I2C_TIMEOUT_MS);
+    if (result != CY_RSLT_SUCCESS)
+    {
+        return result;
+    }
+
+    /* Initialize PAS CO2 sensor with default parameter values */
+    result = xensiv_pasco2_mtb_init_i2c(&sensor->pasco2, sensor->engine->i2c);
+    if (result != CY_RSLT_SUCCESS)
+    {
+        return result;
+    }
+
+    /* Without a routed INT line the interrupt function stays disabled. On the
+     * PAS CO2 Wing Board the line then enables the 12V boost converter. */
+    xensiv_pasco2_interrupt_config_t int_config =
+    {
+        .b.int_func = XENSIV_PASCO2_INTERRUPT_FUNCTION_NONE,
+        .b.int_typ = (uint32_t)XENSIV_PASCO2_INTERRUPT_TYPE_LOW_ACTIVE
+    };
+
+    if (config->int_pin != NC)
+    {
+        /* Signal data ready on a falling edge */
+        int_config.b.int_func = XENSIV_PASCO2_INTERRUPT_FUNCTION_DRDY;
+    }
+
+    if ((config->int_pin != NC) && (sensor->drdy_callback_data.callback == NULL))
+    {
+        result = cyhal_gpio_init(config->int_pin, CYHAL_GPIO_DIR_INPUT, CYHAL_GPIO_DRIVE_PULLUP, true);
+        if (result != CY_RSLT_SUCCESS)
+        {
+            return result;
+        }
+
+        sensor->drdy_callback_data.callback = pasco2_sensor_drdy_isr;
+        sensor->drdy_callback_data.callback_arg = sensor;
+        cyhal_gpio_register_callback(config->int_pin, &sensor->drdy_callback_data);
+        cyhal_gpio_enable_event(config->int_pin, CYHAL_GPIO_IRQ_FALL, PASCO2_SENSOR_DRDY_INTR_PRIORITY, true);
+    }
+
+    result = xensiv_pasco2_set_interrupt_config(&sensor->pasco2, int_config);
+    if (result != CY_RSLT_SUCCESS)
+    {
+        return result;
+    }
+
+    return pasco2_sensor_configure_mode(sensor, single_shot, period);
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_sensor_reset
+ *******************************************************************************
+ * Summary:
+ *   Soft resets the PAS CO2 and the DPS3xx of a node. Both sensors return to
+ *   their power-up state; pasco2_sensor_restart brings them up again.
+ *
+ * Parameters:
+ *   sensor: sensor node object
+ *
+ * Return:
+ *   Result of the reset commands, an error if a sensor did not acknowledge
+ ******************************************************************************/
+cy_rslt_t pasco2_sensor_reset(pasco2_sensor_t *sensor)
+{
+    static const uint8_t pasco2_reset[] = { XENSIV_PASCO2_REG_SENS_RST, (uint8_t)XENSIV_PASCO2_CMD_SOFT_RESET };
+    static const uint8_t dps_reset[] = { PASCO2_SENSOR_DPS_REG_RESET, PASCO2_SENSOR_DPS_SOFT_RESET };
+    const pasco2_i2c_txn_t txns[] =
+    {
+        { XENSIV_PASCO2_I2C_ADDR, pasco2_reset, sizeof(pasco2_reset), NULL, 0U },
+        { sensor->config->dps_address, dps_reset, sizeof(dps_reset), NULL, 0U }
+    };
+    pasco2_i2c_request_t request =
+    {
+        .txns = txns,
+        .count = (sensor->config->dps_address != 0U) ? 2U : 1U,
+        .route = sensor->config->route
+    };
+
+    return pasco2_i2c_engine_transfer(sensor->engine, &request, PASCO2_SENSOR_I2C_TIMEOUT_MS);
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_sensor_restart
+ *******************************************************************************
+ * Summary:
+ *   Brings up a node again after a bus clear, a reset or a power cycle: waits
+ *   until the PAS CO2 is ready, takes over the DPS3xx in background mode and
+ *   configures the PAS CO2 as pasco2_sensor_start does. As at start-up, a
+ *   DPS3xx that does not come up only clears use_dps. The pressure reference
+ *   of the PAS CO2 is written again with the next readout.
+ *
+ * Parameters:
+ *   sensor: sensor node object
+ *   single_shot: true for single-shot mode, false for continuous mode
+ *   period: measurement period in seconds for continuous mode
+ *   deadline: tick after which the PAS CO2 is given up
+ *   polls: incremented for every status read
+ *
+ * Return:
+ *   CY_RSLT_SUCCESS if the PAS CO2 is operational
+ ******************************************************************************/
+cy_rslt_t pasco2_sensor_restart(pasco2_sensor_t *sensor, bool single_shot, uint16_t period, TickType_t deadline,
+                                uint32_t *polls)
+{
+    cy_rslt_t result = pasco2_sensor_wait_ready(sensor, deadline, polls);
+    if (result == CY_RSLT_SUCCESS)
+    {
+        if (sensor->config->dps_address != 0U)
+        {
+            (void)pasco2_sensor_init_dps(sensor);
+        }
+        result = pasco2_sensor_start(sensor, single_shot, period);
+    }
+    pasco2_pressure_reference_lost(&sensor->pressure);
+
+    return result;
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_sensor_configure_mode
+ *******************************************************************************
+ * Summary:
+ *   Puts the PAS CO2 into idle mode for single-shot measurements, or restarts
+ *   continuous measurements with the given measurement period. A result of
+ *   the previous mode that was not read yet is discarded, which releases the
+ *   INT line for the data ready of the restarted measurements.
+ *
+ * Parameters:
+ *   sensor: sensor node object
+ *   single_shot: true for single-shot mode, false for continuous mode
+ *   period: measurement period in seconds for continuous mode
+ *
+ * Return:
+ *   CY_RSLT_SUCCESS if the sensor was configured, an error of the pasco2
+ *   library or the I2C engine otherwise
+ ******************************************************************************/
+cy_rslt_t pasco2_sensor_configure_mode(pasco2_sensor_t *sensor, bool single_shot, uint16_t period)
+{
+    cy_rslt_t result = pasco2_i2c_engine_select(sensor->engine, &sensor->config->route, PASCO2_SENSOR_I2C_TIMEOUT_MS);
+    if (result != CY_RSLT_SUCCESS)
+    {
+        return result;
+    }
+
+    xensiv_pasco2_measurement_config_t meas_config =
+    {
+        .b.op_mode = XENSIV_PASCO2_OP_MODE_IDLE,
+        .b.boc_cfg = PASCO2_SENSOR_BOC_CFG
+    };
+    result = xensiv_pasco2_set_measurement_config(&sensor->pasco2, meas_config);
+
+    if (result == CY_RSLT_SUCCESS)
+    {
+        /* Reading the CO2 value clears the data ready flag */
+        uint8_t stale[2];
+        result = xensiv_pasco2_get_reg(&sensor->pasco2, XENSIV_PASCO2_REG_CO2PPM_H, stale, sizeof(stale));
+    }
+
+    if ((result == CY_RSLT_SUCCESS) && !single_shot)
+    {
+        result = xensiv_pasco2_set_measurement_rate(&sensor->pasco2, period);
+        if (result == CY_RSLT_SUCCESS)
+        {
+            meas_config.b.op_mode = XENSIV_PASCO2_OP_MODE_CONTINUOUS;
+            result = xensiv_pasco2_set_measurement_config(&sensor->pasco2, meas_config);
+        }
+    }
+
+    return result;
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_sensor_drain_pressure
+ *******************************************************************************
+ * Summary:
+ *   Drains the DPS3xx FIFO of the node and feeds the averaged pressure into
+ *   the compensation filter.
+ *
+ * Parameters:
+ *   sensor: sensor node object
+ *
+ * Return:
+ *   Result of the FIFO readout, PASCO2_DPS_FIFO_RSLT_ERR_EMPTY if the FIFO
+ *   held no complete result yet
+ ******************************************************************************/
+cy_rslt_t pasco2_sensor_drain_pressure(pasco2_sensor_t *sensor)
+{
+    int32_t pressure;
+
+    cy_rslt_t result = pasco2_dps_fifo_drain(&sensor->dps, &pressure, &sensor->temperature);
+    if (result == CY_RSLT_SUCCESS)
+    {
+        pasco2_pressure_update(&sensor->pressure, pressure);
+    }
+
+    return result;
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_sensor_prepare_read
+ *******************************************************************************
+ * Summary:
+ *   Builds the request of one acquisition pass: the measurement status, the
+ *   CO2 result and the sensor status are read and, if requested, the pressure
+ *   reference is written. The CO2 result is read unconditionally to keep the
+ *   chain static; it is only used when the status read before it reported
+ *   data ready. Error flags found by the previous pass are cleared before
+ *   the sensor status is read, so that every pass reports the flags raised
+ *   since the one before.
+ *
+ * Parameters:
+ *   sensor: sensor node object
+ *   reference: pressure reference in hPa to write, NULL to skip the write
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+void pasco2_sensor_prepare_read(pasco2_sensor_t *sensor, const uint16_t *reference)
+{
+    static const uint8_t reg_meas_sts = XENSIV_PASCO2_REG_MEAS_STS;
+    static const uint8_t reg_co2ppm = XENSIV_PASCO2_REG_CO2PPM_H;
+    static const uint8_t reg_sens_sts = XENSIV_PASCO2_REG_SENS_STS;
+
+    sensor->txns[0] = (pasco2_i2c_txn_t){ XENSIV_PASCO2_I2C_ADDR, &reg_meas_sts, 1U, &sensor->meas_sts, 1U };
+    sensor->txns[1] = (pasco2_i2c_txn_t){ XENSIV_PASCO2_I2C_ADDR, &reg_co2ppm, 1U, sensor->co2ppm, sizeof(sensor->co2ppm) };
+    sensor->request = (pasco2_i2c_request_t){ .txns = sensor->txns, .count = 2U, .route = sensor->config->route };
+
+    if ((sensor->sens_sts & PASCO2_SENSOR_STS_ERROR_MSK) != 0U)
+    {
+        sensor->sts_clr[0] = XENSIV_PASCO2_REG_SENS_STS;
+        sensor->sts_clr[1] = XENSIV_PASCO2_REG_SENS_STS_ICCER_CLR_MSK | XENSIV_PASCO2_REG_SENS_STS_ORVS_CLR_MSK |
+                             XENSIV_PASCO2_REG_SENS_STS_ORTMP_CLR_MSK;
+        sensor->txns[sensor->request.count++] =
+            (pasco2_i2c_txn_t){ XENSIV_PASCO2_I2C_ADDR, sensor->sts_clr, sizeof(sensor->sts_clr), NULL, 0U };
+    }
+    sensor->txns[sensor->request.count++] =
+        (pasco2_i2c_txn_t){ XENSIV_PASCO2_I2C_ADDR, &reg_sens_sts, 1U, &sensor->sens_sts, 1U };
+
+    if (reference != NULL)
+    {
+        sensor->press_ref[0] = XENSIV_PASCO2_REG_PRESS_REF_H;
+        sensor->press_ref[1] = (uint8_t)(*reference >> 8);
+        sensor->press_ref[2] = (uint8_t)*reference;
+        sensor->txns[sensor->request.count++] =
+            (pasco2_i2c_txn_t){ XENSIV_PASCO2_I2C_ADDR, sensor->press_ref, sizeof(sensor->press_ref), NULL, 0U };
+    }
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_sensor_prepare_trigger
+ *******************************************************************************
+ * Summary:
+ *   Builds the request that starts a single-shot measurement. The pressure
+ *   reference is written first, so that the measurement already uses it. The
+ *   sensor returns to idle mode when the measurement is done.
+ *
+ * Parameters:
+ *   sensor: sensor node object
+ *   reference: pressure reference in hPa to write, NULL to skip the write
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+void pasco2_sensor_prepare_trigger(pasco2_sensor_t *sensor, const uint16_t *reference)
+{
+    const xensiv_pasco2_measurement_config_t meas_config =
+    {
+        .b.op_mode = XENSIV_PASCO2_OP_MODE_SINGLE,
+        .b.boc_cfg = PASCO2_SENSOR_BOC_CFG
+    };
+    uint8_t count = 0U;
+
+    if (reference != NULL)
+    {
+        sensor->press_ref[0] = XENSIV_PASCO2_REG_PRESS_REF_H;
+        sensor->press_ref[1] = (uint8_t)(*reference >> 8);
+        sensor->press_ref[2] = (uint8_t)*reference;
+        sensor->txns[count++] = (pasco2_i2c_txn_t){ XENSIV_PASCO2_I2C_ADDR, sensor->press_ref, sizeof(sensor->press_ref), NULL, 0U };
+    }
+
+    sensor->meas_cfg[0] = XENSIV_PASCO2_REG_MEAS_CFG;
+    sensor->meas_cfg[1] = meas_config.u;
+    sensor->txns[count++] = (pasco2_i2c_txn_t){ XENSIV_PASCO2_I2C_ADDR, sensor->meas_cfg, sizeof(sensor->meas_cfg), NULL, 0U };
+
+    sensor->request = (pasco2_i2c_request_t){ .txns = sensor->txns, .count = count, .route = sensor->config->route };
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_sensor_get_result
+ *******************************************************************************
+ * Summary:
+ *   Evaluates a completed readout request.
+ *
+ * Parameters:
+ *   sensor: sensor node object
+ *   sample: record that receives ppm and status
+ *
+ * Return:
+ *   CY_RSLT_SUCCESS if a new CO2 value was read, PASCO2_RSLT_READ_NRDY if no
+ *   new value is available, PASCO2_RSLT_ERR_COMM on bus errors
+ ******************************************************************************/
+cy_rslt_t pasco2_sensor_get_result(pasco2_sensor_t *sensor, pasco2_sample_t *sample)
+{
+    if (sensor->request.result != CY_RSLT_SUCCESS)
+    {
+        return PASCO2_RSLT_ERR_COMM;
+    }
+
+    sample->status = sensor->sens_sts;
+    sample->flags |= PASCO2_SAMPLE_STATUS_VALID;
+    if ((sensor->meas_sts & XENSIV_PASCO2_REG_MEAS_STS_DRDY_MSK) == 0U)
+    {
+        return PASCO2_RSLT_READ_NRDY;
+    }
+
+    sample->ppm = (uint16_t)(((uint16_t)sensor->co2ppm[0] << 8) | sensor->co2ppm[1]);
+    sample->flags |= PASCO2_SAMPLE_PPM_VALID;
+
+    return CY_RSLT_SUCCESS;
+}
+
+/* [] END OF FILE */
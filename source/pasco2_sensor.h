@@ -0,0 +1,151 @@
+/******************************************************************************
+** File name: pasco2_sensor.h
+**
+** Description: This file contains the types and function prototypes of a
+**   sensor node: a PAS CO2 and an optional DPS3xx behind one bus route.
+**
+** ===========================================================================
+** Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+** ===========================================================================
+**
+** ===========================================================================
+** Infineon Technologies AG (INFINEON) is supplying this file for use
+** exclusively with Infineon's sensor products. This file can be freely
+** distributed within development tools and software supporting such
+** products.
+**
+** THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+** OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+** MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+** INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+** WHATSOEVER.
+** ===========================================================================
+*/
+
+#pragma once
+
+/* Header file includes */
+#include "cyabs_rtos.h"
+#include "cyhal.h"
+
+/* Header file for library */
+#include "xensiv_pasco2_mtb.h"
+
+/* Header file for local module */
+#include "pasco2_baseline.h"
+#include "pasco2_dps_fifo.h"
+#include "pasco2_i2c_engine.h"
+#include "pasco2_pressure.h"
+#include "pasco2_sample_ring.h"
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+/* Maximum time for the I2C transactions of one acquisition pass */
+#define PASCO2_SENSOR_I2C_TIMEOUT_MS (50U)
+
+/* Interval of the PAS CO2 status reads while the sensor powers up */
+#define PASCO2_SENSOR_READY_POLL_MS (10U)
+
+/* Results of an asynchronous PAS CO2 readout, coded like the pasco2 library */
+#define PASCO2_RSLT_READ_NRDY \
+    CY_RSLT_CREATE(CY_RSLT_TYPE_ERROR, CY_RSLT_MODULE_MIDDLEWARE_BASE, XENSIV_PASCO2_READ_NRDY)
+#define PASCO2_RSLT_ERR_COMM \
+    CY_RSLT_CREATE(CY_RSLT_TYPE_ERROR, CY_RSLT_MODULE_MIDDLEWARE_BASE, XENSIV_PASCO2_ERR_COMM)
+#define PASCO2_RSLT_ERR_NOT_READY \
+    CY_RSLT_CREATE(CY_RSLT_TYPE_ERROR, CY_RSLT_MODULE_MIDDLEWARE_BASE, XENSIV_PASCO2_ERR_NOT_READY)
+
+/* Error flags of the PAS CO2 sensor status */
+#define PASCO2_SENSOR_STS_ERROR_MSK (XENSIV_PASCO2_REG_SENS_STS_ICCER_MSK | \
+                                     XENSIV_PASCO2_REG_SENS_STS_ORVS_MSK | \
+                                     XENSIV_PASCO2_REG_SENS_STS_ORTMP_MSK)
+
+/* Baseline offset compensation of the PAS CO2. The ABOC of the sensor is
+ * turned off while the firmware compensates the baseline itself. */
+#define PASCO2_SENSOR_BOC_CFG ((PASCO2_BASELINE_ENABLE != 0U) ? XENSIV_PASCO2_BOC_CFG_DISABLE : \
+                               XENSIV_PASCO2_BOC_CFG_AUTOMATIC)
+
+/* DPS3xx soft reset command */
+#define PASCO2_SENSOR_DPS_REG_RESET (0x0CU)
+#define PASCO2_SENSOR_DPS_SOFT_RESET (0x09U)
+
+/* Priority of the sensor data-ready interrupt */
+#define PASCO2_SENSOR_DRDY_INTR_PRIORITY (7U)
+
+/*******************************************************************************
+ * Types
+ ******************************************************************************/
+/* Counters describing the efficiency of the CO2 acquisition loop */
+typedef struct
+{
+    uint32_t reads;             /* Number of CO2 result readouts issued */
+    uint32_t samples;           /* Number of readouts that returned a new value */
+    uint32_t not_ready;         /* Number of readouts that found no new value */
+    uint32_t last_latency_ms;   /* Data-ready to readout latency of the last sample */
+    uint32_t max_latency_ms;    /* Worst data-ready to readout latency */
+} pasco2_acquisition_stats_t;
+
+/* Board description of a sensor node */
+typedef struct
+{
+    uint8_t bus;                /* Index of the I2C bus of the node */
+    pasco2_i2c_route_t route;   /* Mux channel of the node */
+    uint16_t dps_address;       /* DPS3xx address, 0 if the node has no pressure sensor */
+    cyhal_gpio_t int_pin;       /* Input connected to the PAS CO2 INT line, NC if not routed */
+} pasco2_sensor_config_t;
+
+/* Sensor node object */
+typedef struct
+{
+    const pasco2_sensor_config_t *config;
+    pasco2_i2c_engine_t *engine;
+    xensiv_pasco2_t pasco2;
+    pasco2_dps_fifo_t dps;
+    bool use_dps;
+    pasco2_pressure_t pressure;
+    int16_t temperature;        /* Temperature in 0.01 degree Celsius */
+
+    /* Schedule, owned by the sensor task */
+    TickType_t co2_due;
+    TickType_t pressure_due;
+    bool single_shot_pending;
+    TickType_t single_shot_start;
+    bool reference_pending;     /* Write the pressure reference with the next readout */
+
+    /* Data-ready interrupt */
+    TaskHandle_t task;
+    volatile bool drdy;
+    volatile TickType_t drdy_tick;
+    cyhal_gpio_callback_data_t drdy_callback_data;
+
+    /* Readout or trigger request and its buffers, valid until it completes */
+    pasco2_i2c_txn_t txns[5];
+    pasco2_i2c_request_t request;
+    uint8_t meas_sts;
+    uint8_t co2ppm[2];
+    uint8_t sens_sts;
+    uint8_t sts_clr[2];
+    uint8_t press_ref[3];
+    uint8_t meas_cfg[2];
+
+    pasco2_acquisition_stats_t stats;
+} pasco2_sensor_t;
+
+/*******************************************************************************
+ * Functions
+ ******************************************************************************/
+cy_rslt_t pasco2_sensor_init(pasco2_sensor_t *sensor, const pasco2_sensor_config_t *config,
+                             pasco2_i2c_engine_t *engine, TaskHandle_t task);
+cy_rslt_t pasco2_sensor_wait_ready(pasco2_sensor_t *sensor, TickType_t deadline, uint32_t *polls);
+cy_rslt_t pasco2_sensor_start(pasco2_sensor_t *sensor, bool single_shot, uint16_t period);
+cy_rslt_t pasco2_sensor_reset(pasco2_sensor_t *sensor);
+cy_rslt_t pasco2_sensor_restart(pasco2_sensor_t *sensor, bool single_shot, uint16_t period, TickType_t deadline,
+                                uint32_t *polls);
+cy_rslt_t pasco2_sensor_configure_mode(pasco2_sensor_t *sensor, bool single_shot, uint16_t period);
+cy_rslt_t pasco2_sensor_drain_pressure(pasco2_sensor_t *sensor);
+void pasco2_sensor_prepare_read(pasco2_sensor_t *sensor, const uint16_t *reference);
+void pasco2_sensor_prepare_trigger(pasco2_sensor_t *sensor, const uint16_t *reference);
+cy_rslt_t pasco2_sensor_get_result(pasco2_sensor_t *sensor, pasco2_sample_t *sample);
+
+/* [] END OF FILE */
@@ -0,0 +1,412 @@
+/*****************************************************************************
+** File name: pasco2_stats.c
+**
+** Description: This file implements the windowed CO2 statistics. Every window
+** is a ring of time slots with integer aggregates and a quantile sketch;
+** running sums and monotonic deques of the slots keep the update constant
+** time. Readers in other tasks use a sequence counter instead of a lock.
+**
+** ===========================================================================
+** Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+** ===========================================================================
+**
+** ===========================================================================
+** Infineon Technologies AG (INFINEON) is supplying this file for use
+** exclusively with Infineon's sensor products. This file can be freely
+** distributed within development tools and software supporting such
+** products.
+**
+** THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+** OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+** MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+** INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+** WHATSOEVER.
+** ===========================================================================
+*/
+
+/* Header file from system */
+#include <string.h>
+
+/* Header file includes */
+#include "cy_pdl.h"
+
+/* Header file for local module */
+#include "pasco2_stats.h"
+
+/*******************************************************************************
+ * Global Variables
+ ******************************************************************************/
+#define PASCO2_STATS_WINDOW_NAME(id, name, length_s, slots) name,
+static const char *const window_names[PASCO2_STATS_WINDOW_COUNT] =
+{
+    PASCO2_STATS_WINDOWS(PASCO2_STATS_WINDOW_NAME)
+};
+#undef PASCO2_STATS_WINDOW_NAME
+
+/*******************************************************************************
+ * Function Name: pasco2_stats_bucket
+ *******************************************************************************
+ * Summary:
+ *   Maps a CO2 value to its bucket of the quantile sketch.
+ *
+ * Parameters:
+ *   ppm: CO2 value
+ *
+ * Return:
+ *   index of the bucket
+ ******************************************************************************/
+static uint32_t pasco2_stats_bucket(uint16_t ppm)
+{
+    uint32_t base = PASCO2_STATS_MIN_PPM;
+    uint32_t octave = 0U;
+
+    if (ppm < PASCO2_STATS_MIN_PPM)
+    {
+        return 0U;
+    }
+
+    while ((octave < PASCO2_STATS_OCTAVES) && (ppm >= (base * 2U)))
+    {
+        base *= 2U;
+        octave++;
+    }
+    if (octave == PASCO2_STATS_OCTAVES)
+    {
+        return PASCO2_STATS_BUCKETS - 1U;
+    }
+
+    return 1U + (octave * PASCO2_STATS_SUB_BUCKETS) + ((ppm - base) / (base / PASCO2_STATS_SUB_BUCKETS));
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_stats_bucket_lower
+ *******************************************************************************
+ * Summary:
+ *   Returns the smallest value of a bucket of the quantile sketch.
+ *
+ * Parameters:
+ *   bucket: index of the bucket, PASCO2_STATS_BUCKETS for the end of the range
+ *
+ * Return:
+ *   lower bound of the bucket in ppm
+ ******************************************************************************/
+static uint32_t pasco2_stats_bucket_lower(uint32_t bucket)
+{
+    if (bucket == 0U)
+    {
+        return 0U;
+    }
+    if (bucket == PASCO2_STATS_BUCKETS)
+    {
+        return (uint32_t)UINT16_MAX + 1U;
+    }
+
+    uint32_t base = PASCO2_STATS_MIN_PPM << ((bucket - 1U) / PASCO2_STATS_SUB_BUCKETS);
+    return base + (((bucket - 1U) % PASCO2_STATS_SUB_BUCKETS) * (base / PASCO2_STATS_SUB_BUCKETS));
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_stats_deque_front
+ *******************************************************************************
+ * Summary:
+ *   Returns the oldest slot of a deque.
+ *
+ * Parameters:
+ *   window: window owning the deque
+ *   deque: non-empty deque
+ *
+ * Return:
+ *   slot
+ ******************************************************************************/
+static const pasco2_stats_slot_t *pasco2_stats_deque_front(const pasco2_stats_window_t *window,
+                                                           const pasco2_stats_deque_t *deque)
+{
+    return &window->slots[deque->entries[deque->head] % window->slot_count];
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_stats_deque_push
+ *******************************************************************************
+ * Summary:
+ *   Appends the current slot to a monotonic deque after dropping the newer
+ *   slots it dominates, so that the front always holds the extreme of the
+ *   window. Each slot is pushed and dropped at most once per value.
+ *
+ * Parameters:
+ *   window: window owning the deque
+ *   deque: deque to update
+ *   use_max: true for the maximum deque, false for the minimum deque
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+static void pasco2_stats_deque_push(pasco2_stats_window_t *window, pasco2_stats_deque_t *deque, bool use_max)
+{
+    const pasco2_stats_slot_t *current = &window->slots[window->seq % window->slot_count];
+    uint16_t value = use_max ? current->max : current->min;
+
+    while (deque->length > 0U)
+    {
+        uint32_t back = deque->entries[(deque->head + deque->length - 1U) % window->slot_count];
+        const pasco2_stats_slot_t *slot = &window->slots[back % window->slot_count];
+        if (use_max ? (slot->max > value) : (slot->min < value))
+        {
+            break;
+        }
+        deque->length--;
+    }
+
+    deque->entries[(deque->head + deque->length) % window->slot_count] = window->seq;
+    deque->length++;
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_stats_deque_expire
+ *******************************************************************************
+ * Summary:
+ *   Drops the slots that left the window from the front of a deque.
+ *
+ * Parameters:
+ *   window: window owning the deque
+ *   deque: deque to update
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+static void pasco2_stats_deque_expire(const pasco2_stats_window_t *window, pasco2_stats_deque_t *deque)
+{
+    while ((deque->length > 0U) && ((window->seq - deque->entries[deque->head]) >= window->slot_count))
+    {
+        deque->head = (uint16_t)((deque->head + 1U) % window->slot_count);
+        deque->length--;
+    }
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_stats_window_add
+ *******************************************************************************
+ * Summary:
+ *   Advances a window to the slot of a value and adds the value.
+ *
+ * Parameters:
+ *   window: window to update
+ *   tick: time of the value in ms
+ *   ppm: CO2 value
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+static void pasco2_stats_window_add(pasco2_stats_window_t *window, uint32_t tick, uint16_t ppm)
+{
+    uint32_t elapsed = tick - window->slot_start;
+
+    if (elapsed >= window->slot_ms)
+    {
+        /* Start a new slot, the slots it skips over and the oldest ones
+         * leave the window */
+        uint32_t steps = elapsed / window->slot_ms;
+        uint32_t expired = (steps < window->slot_count) ? steps : window->slot_count;
+
+        for (uint32_t i = 1U; i <= expired; i++)
+        {
+            pasco2_stats_slot_t *slot = &window->slots[(window->seq + i) % window->slot_count];
+            window->sum -= slot->sum;
+            window->count -= slot->count;
+            memset(slot, 0, sizeof(*slot));
+        }
+
+        window->seq += steps;
+        window->slot_start += steps * window->slot_ms;
+        pasco2_stats_deque_expire(window, &window->min_deque);
+        pasco2_stats_deque_expire(window, &window->max_deque);
+    }
+
+    pasco2_stats_slot_t *slot = &window->slots[window->seq % window->slot_count];
+    if ((slot->count == 0U) || (ppm < slot->min))
+    {
+        slot->min = ppm;
+    }
+    if (ppm > slot->max)
+    {
+        slot->max = ppm;
+    }
+    slot->sum += ppm;
+    slot->count++;
+    slot->buckets[pasco2_stats_bucket(ppm)]++;
+
+    window->sum += ppm;
+    window->count++;
+    pasco2_stats_deque_push(window, &window->min_deque, false);
+    pasco2_stats_deque_push(window, &window->max_deque, true);
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_stats_init
+ *******************************************************************************
+ * Summary:
+ *   Empties all windows of a statistics object.
+ *
+ * Parameters:
+ *   stats: statistics object
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+void pasco2_stats_init(pasco2_stats_t *stats)
+{
+    memset(stats, 0, sizeof(*stats));
+
+#define PASCO2_STATS_WINDOW_SETUP(id, name, length_s, count)                        \
+    stats->windows[id].slots = stats->id##_slots;                                   \
+    stats->windows[id].slot_count = (count);                                        \
+    stats->windows[id].slot_ms = ((length_s) * 1000U) / (count);                    \
+    stats->windows[id].min_deque.entries = stats->id##_min_entries;                 \
+    stats->windows[id].max_deque.entries = stats->id##_max_entries;
+    PASCO2_STATS_WINDOWS(PASCO2_STATS_WINDOW_SETUP)
+#undef PASCO2_STATS_WINDOW_SETUP
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_stats_add
+ *******************************************************************************
+ * Summary:
+ *   Adds a CO2 value to all windows. Called by a single writer; the cost does
+ *   not depend on the length of the windows.
+ *
+ * Parameters:
+ *   stats: statistics object
+ *   tick: time of the value in ms, not older than the previous value
+ *   ppm: CO2 value
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+void pasco2_stats_add(pasco2_stats_t *stats, uint32_t tick, uint16_t ppm)
+{
+    /* Readers retry while the sequence is odd or has changed */
+    stats->sequence++;
+    __DMB();
+
+    if (!stats->started)
+    {
+        for (uint32_t i = 0U; i < PASCO2_STATS_WINDOW_COUNT; i++)
+        {
+            stats->windows[i].slot_start = tick;
+        }
+        stats->started = true;
+    }
+
+    for (uint32_t i = 0U; i < PASCO2_STATS_WINDOW_COUNT; i++)
+    {
+        pasco2_stats_window_add(&stats->windows[i], tick, ppm);
+    }
+    stats->last_tick = tick;
+
+    __DMB();
+    stats->sequence++;
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_stats_query
+ *******************************************************************************
+ * Summary:
+ *   Summarizes the window that ends with the newest value. May be called from
+ *   any task while the writer keeps adding values; it never blocks the writer.
+ *
+ * Parameters:
+ *   stats: statistics object
+ *   window: window to summarize
+ *   now: current time in ms, only used for the age of the newest value
+ *   summary: summary of the window
+ *
+ * Return:
+ *   true if the summary is consistent, false if the writer updated the
+ *   statistics meanwhile and the query has to be repeated
+ ******************************************************************************/
+bool pasco2_stats_query(const pasco2_stats_t *stats, pasco2_stats_window_id_t window, uint32_t now,
+                        pasco2_stats_summary_t *summary)
+{
+    CY_ASSERT(window < PASCO2_STATS_WINDOW_COUNT);
+    const pasco2_stats_window_t *w = &stats->windows[window];
+    uint32_t sequence = stats->sequence;
+
+    *summary = (pasco2_stats_summary_t){ .count = 0U };
+    if ((sequence & 1U) != 0U)
+    {
+        return false;
+    }
+    __DMB();
+
+    if (stats->started && (w->count > 0U) && (w->min_deque.length > 0U) && (w->max_deque.length > 0U))
+    {
+        summary->count = w->count;
+        summary->age_ms = now - stats->last_tick;
+        summary->mean_x10 = (uint32_t)((((uint64_t)w->sum * 10U) + (w->count / 2U)) / w->count);
+        summary->min = pasco2_stats_deque_front(w, &w->min_deque)->min;
+        summary->max = pasco2_stats_deque_front(w, &w->max_deque)->max;
+
+        /* Merge the sketches of all slots */
+        uint32_t buckets[PASCO2_STATS_BUCKETS] = { 0U };
+        for (uint32_t slot = 0U; slot < w->slot_count; slot++)
+        {
+            for (uint32_t bucket = 0U; bucket < PASCO2_STATS_BUCKETS; bucket++)
+            {
+                buckets[bucket] += w->slots[slot].buckets[bucket];
+            }
+        }
+
+        static const uint8_t percents[] = { 50U, 95U };
+        uint16_t *const results[] = { &summary->p50, &summary->p95 };
+        for (uint32_t i = 0U; i < (sizeof(percents) / sizeof(percents[0])); i++)
+        {
+            /* Rank of the percentile, rounded up */
+            uint32_t rank = ((summary->count * percents[i]) + 99U) / 100U;
+            uint32_t seen = 0U;
+            uint32_t bucket = 0U;
+            for (; bucket < (PASCO2_STATS_BUCKETS - 1U); bucket++)
+            {
+                if ((seen + buckets[bucket]) >= rank)
+                {
+                    break;
+                }
+                seen += buckets[bucket];
+            }
+
+            /* Interpolate within the bucket, assuming its values are spread evenly */
+            uint32_t value = summary->max;
+            if (buckets[bucket] > 0U)
+            {
+                uint32_t lower = pasco2_stats_bucket_lower(bucket);
+                uint32_t width = pasco2_stats_bucket_lower(bucket + 1U) - lower;
+                value = lower + (uint32_t)(((uint64_t)width * (((rank - seen) * 2U) - 1U)) / (buckets[bucket] * 2U));
+            }
+            value = (value < summary->min) ? summary->min : value;
+            value = (value > summary->max) ? summary->max : value;
+            *results[i] = (uint16_t)value;
+        }
+    }
+
+    __DMB();
+    return stats->sequence == sequence;
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_stats_window_name
+ *******************************************************************************
+ * Summary:
+ *   Returns the printable name of a window.
+ *
+ * Parameters:
+ *   window: window
+ *
+ * Return:
+ *   name of the window
+ ******************************************************************************/
+const char *pasco2_stats_window_name(pasco2_stats_window_id_t window)
+{
+    CY_ASSERT(window < PASCO2_STATS_WINDOW_COUNT);
+    return window_names[window];
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,130 @@
+/******************************************************************************
+** File name: pasco2_stats.h
+**
+** Description: This file contains the types and function prototypes of the
+**   windowed CO2 statistics.
+**
+** ===========================================================================
+** Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+** ===========================================================================
+**
+** ===========================================================================
+** Infineon Technologies AG (INFINEON) is supplying this file for use
+** exclusively with Infineon's sensor products. This file can be freely
+** distributed within development tools and software supporting such
+** products.
+**
+** THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+** OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+** MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+** INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+** WHATSOEVER.
+** ===========================================================================
+*/
+
+#pragma once
+
+/* Header file includes */
+#include <stdbool.h>
+#include <stdint.h>
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+/* Window table: identifier, name, length in seconds, and number of slots.
+ * A window slides by one slot, so it covers between length - length / slots
+ * and length seconds of history. The length must be a multiple of the slots. */
+#define PASCO2_STATS_WINDOWS(X)                                 \
+    X(PASCO2_STATS_WINDOW_1MIN,  "1 min",    60U, 12U)          \
+    X(PASCO2_STATS_WINDOW_1H,    "1 h",    3600U, 60U)          \
+    X(PASCO2_STATS_WINDOW_24H,   "24 h",  86400U, 48U)
+
+/* Quantile sketch: values below 256 ppm and from 8192 ppm on get one bucket
+ * each, every power of two in between is split into eight buckets of 6 to
+ * 12% width. Percentiles are interpolated within their bucket. */
+#define PASCO2_STATS_SUB_BUCKETS (8U)
+#define PASCO2_STATS_MIN_PPM     (256U)
+#define PASCO2_STATS_OCTAVES     (5U)
+#define PASCO2_STATS_BUCKETS     ((PASCO2_STATS_OCTAVES * PASCO2_STATS_SUB_BUCKETS) + 2U)
+
+/*******************************************************************************
+ * Types
+ ******************************************************************************/
+#define PASCO2_STATS_WINDOW_ID(id, name, length_s, slots) id,
+typedef enum
+{
+    PASCO2_STATS_WINDOWS(PASCO2_STATS_WINDOW_ID)
+    PASCO2_STATS_WINDOW_COUNT
+} pasco2_stats_window_id_t;
+#undef PASCO2_STATS_WINDOW_ID
+
+/* Aggregate of the samples that fell into one slot of a window */
+typedef struct
+{
+    uint32_t sum;               /* Sum of the values in ppm */
+    uint16_t count;             /* Number of values */
+    uint16_t min;               /* Smallest value */
+    uint16_t max;               /* Largest value */
+    uint16_t buckets[PASCO2_STATS_BUCKETS]; /* Quantile sketch */
+} pasco2_stats_slot_t;
+
+/* Monotonic deque of slot sequence numbers, a ring of the window's slots */
+typedef struct
+{
+    uint32_t *entries;
+    uint16_t head;
+    uint16_t length;
+} pasco2_stats_deque_t;
+
+/* Sliding window made of a ring of slots */
+typedef struct
+{
+    pasco2_stats_slot_t *slots;
+    uint32_t slot_count;
+    uint32_t slot_ms;
+    uint32_t seq;               /* Sequence number of the current slot */
+    uint32_t slot_start;        /* Time the current slot started in ms */
+    uint32_t sum;               /* Running sum over all slots */
+    uint32_t count;             /* Running count over all slots */
+    pasco2_stats_deque_t min_deque; /* Slots with increasing minimum */
+    pasco2_stats_deque_t max_deque; /* Slots with decreasing maximum */
+} pasco2_stats_window_t;
+
+/* Statistics of one value stream. All memory is part of the object. */
+#define PASCO2_STATS_STORAGE(id, name, length_s, slots)         \
+    pasco2_stats_slot_t id##_slots[slots];                      \
+    uint32_t id##_min_entries[slots];                           \
+    uint32_t id##_max_entries[slots];
+typedef struct
+{
+    volatile uint32_t sequence; /* Odd while an update is in progress */
+    bool started;
+    uint32_t last_tick;         /* Time of the newest value in ms */
+    pasco2_stats_window_t windows[PASCO2_STATS_WINDOW_COUNT];
+    PASCO2_STATS_WINDOWS(PASCO2_STATS_STORAGE)
+} pasco2_stats_t;
+#undef PASCO2_STATS_STORAGE
+
+/* Summary of a window, all zero while it holds no value */
+typedef struct
+{
+    uint32_t count;             /* Number of values in the window */
+    uint32_t age_ms;            /* Time since the newest value */
+    uint32_t mean_x10;          /* Mean in 0.1 ppm */
+    uint16_t min;               /* Smallest value in ppm */
+    uint16_t max;               /* Largest value in ppm */
+    uint16_t p50;               /* Median in ppm, from the sketch */
+    uint16_t p95;               /* 95th percentile in ppm, from the sketch */
+} pasco2_stats_summary_t;
+
+/*******************************************************************************
+ * Functions
+ ******************************************************************************/
+void pasco2_stats_init(pasco2_stats_t *stats);
+void pasco2_stats_add(pasco2_stats_t *stats, uint32_t tick, uint16_t ppm);
+bool pasco2_stats_query(const pasco2_stats_t *stats, pasco2_stats_window_id_t window, uint32_t now,
+                        pasco2_stats_summary_t *summary);
+const char *pasco2_stats_window_name(pasco2_stats_window_id_t window);
+
+/* [] END OF FILE */
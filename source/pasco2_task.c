@@ -28,69 +28,234 @@
 #include <stdio.h>
 
 /* Header file includes */
+#include "cy_retarget_io.h"
 #include "cybsp.h"
 #include "cyhal.h"
 
+#include "pasco2_alarm.h"
+#include "pasco2_baseline.h"
+#include "pasco2_board.h"
+#include "pasco2_console.h"
+#include "pasco2_dps_fifo.h"
+#include "pasco2_history.h"
+#include "pasco2_i2c_engine.h"
+#include "pasco2_log.h"
+#include "pasco2_pressure.h"
+#include "pasco2_probe.h"
+#include "pasco2_rate.h"
+#include "pasco2_recovery.h"
+#include "pasco2_rtos.h"
+#include "pasco2_sample_ring.h"
+#include "pasco2_stats.h"
 #include "pasco2_task.h"
+#include "pasco2_telemetry.h"
 #include "pasco2_terminal_ui_task.h"
 
 /* Header file for local task */
 #include "xensiv_dps3xx_mtb.h"
 
-#if defined(CYSBSYSKIT_DEV_01)
-/* Output pin for sensor PSEL line */
-#define MTB_PASCO2_PSEL (P5_3)
-/* Output pin for PAS CO2 Wing Board power switch */
-#define MTB_PASCO2_POWER_SWITCH (P10_5)
-/* Output pin for PAS CO2 Wing Board LED OK */
-#define MTB_PASCO2_LED_OK (P9_0)
-/* Output pin for PAS CO2 Wing Board LED WARNING  */
-#define MTB_PASCO2_LED_WARNING (P9_1)
-/* Pin state to enable I2C channel of sensor */
-#define MTB_PASCO2_PSEL_I2C_ENABLE (0U)
-/* Pin state to enable power to sensor on PAS CO2 Wing Board*/
-#define MTB_PASCO2_POWER_ON (1U)
-/* Pin state for PAS CO2 Wing Board LED off. */
-#define MTB_PASCO_LED_STATE_OFF (0U)
-/* Pin state for PAS CO2 Wing Board LED on. */
-#define MTB_PASCO_LED_STATE_ON (1U)
-
-#else
-#define MTB_PASCO2_LED_WARNING  (CYBSP_USER_LED)
-#define MTB_PASCO2_LED_OK       (CYBSP_USER_LED2)
-#define PASCO2_PWR_EN_ALT       (CYBSP_A3)
-/* Pin state for PSoC 62 baseboard LED off. */
-#define MTB_PASCO_LED_STATE_OFF (1U)
-/* Pin state for PSoC 62 baseboard LED on. */
-#define MTB_PASCO_LED_STATE_ON (0U)
-#endif
+/* A power cycle ends the escalation of a recovery on kits that can switch
+ * the sensor supplies, a sensor reset on the others */
+#define PASCO2_RECOVERY_MAX_ACTION ((PASCO2_BOARD_POWER_SWITCH != NC) ? PASCO2_RECOVERY_ACTION_POWER_CYCLE : \
+                                    PASCO2_RECOVERY_ACTION_SENSOR_RESET)
 
 /* I2C bus frequency */
 #define I2C_MASTER_FREQUENCY (100000U)
 
-#define DEFAULT_PRESSURE_VALUE (1015.0F)
+/* Time from switching on the sensor supplies until a PAS CO2 that has not
+ * reported ready is given up */
+#define PASCO2_READY_TIMEOUT_MS (3000U)
 
-/* Delay time after hardware initialization */
-#define PASCO2_INITIALIZATION_DELAY (2000)
+/* Time the sensor supply stays off during a power cycle */
+#define PASCO2_POWER_OFF_MS (500U)
 
-/* Delay time after each PAS CO2 readout */
+/* Delay time before retrying a PAS CO2 readout that was not ready */
 #define PASCO2_PROCESS_DELAY (1100)
 
-#define conditional_log(...)                                                   \
-    if (log_internal && display_ppm)                                           \
-    {                                                                          \
-        printf(__VA_ARGS__);                                                   \
+/* Default measurement period configured by xensiv_pasco2_mtb_init_i2c in seconds */
+#define PASCO2_DEFAULT_MEAS_PERIOD (10U)
+
+/* Time subtracted from the measurement period when predicting the next result */
+#define PASCO2_DRDY_MARGIN_MS (200U)
+
+/* Time added to the measurement period before a missed data-ready interrupt
+ * is recovered by polling the sensor */
+#define PASCO2_DRDY_TIMEOUT_MS (1000U)
+
+/* Time from the trigger until the result of a single-shot measurement is expected */
+#define PASCO2_SINGLE_SHOT_DURATION_MS (1150U)
+
+/* Delay before a single-shot result that was not ready is read again */
+#define PASCO2_SINGLE_SHOT_RETRY_MS (100U)
+
+/* Time after which an unfinished single-shot measurement is triggered again */
+#define PASCO2_SINGLE_SHOT_TIMEOUT_MS (3000U)
+
+/* Time a command of the terminal UI may wait for the sensor task to take it.
+ * The sensor task takes commands between two acquisition passes. */
+#define PASCO2_COMMAND_TIMEOUT_MS (1000U)
+
+/* Work flash: the history log, holding the readings of the first sensor
+ * node, followed by the baseline snapshots */
+#define PASCO2_WORK_FLASH_ROWS ((uint16_t)(CY_EM_EEPROM_SIZE / CY_FLASH_SIZEOF_ROW))
+#define PASCO2_HISTORY_ADDRESS (CY_EM_EEPROM_BASE)
+#define PASCO2_HISTORY_ROWS ((uint16_t)(PASCO2_WORK_FLASH_ROWS - \
+                                        ((PASCO2_BASELINE_ENABLE != 0U) ? PASCO2_BASELINE_ROWS : 0U)))
+#define PASCO2_HISTORY_SENSOR (0U)
+#define PASCO2_BASELINE_ADDRESS (PASCO2_HISTORY_ADDRESS + ((uint32_t)PASCO2_HISTORY_ROWS * CY_FLASH_SIZEOF_ROW))
+
+/* Sensor node whose CO2 values drive the adaptive measurement rate */
+#define PASCO2_RATE_SENSOR (0U)
+
+/*******************************************************************************
+ * Types
+ ******************************************************************************/
+/* Pins of an I2C bus */
+typedef struct
+{
+    cyhal_gpio_t sda;
+    cyhal_gpio_t scl;
+} pasco2_bus_config_t;
+
+/*******************************************************************************
+ * Constants
+ ******************************************************************************/
+/* Configuration of the I2C masters */
+static const cyhal_i2c_cfg_t i2c_master_config =
+{
+    CYHAL_I2C_MODE_MASTER,
+    0 /* address is not used for master mode */,
+    I2C_MASTER_FREQUENCY
+};
+
+#if defined(PASCO2_NODE_TABLE)
+/* A build can supply bus_configs and sensor_configs in a header of its own,
+ * as the host simulation does to serve a number of nodes */
+#include PASCO2_NODE_TABLE
+#else
+/* I2C buses of the sensor nodes */
+static const pasco2_bus_config_t bus_configs[] =
+{
+    { CYBSP_I2C_SDA, CYBSP_I2C_SCL }
+};
+
+/* Sensor nodes serviced by the sensor task. A node is a PAS CO2 and an
+ * optional DPS3xx on one bus, either connected directly or behind a channel
+ * of an I2C mux. Further nodes are added here, for example behind a PCA9548A
+ * at address 0x70:
+ *   { .bus = 0U, .route = { 0x70U, 1U }, .dps_address = 0U, .int_pin = NC } */
+static const pasco2_sensor_config_t sensor_configs[] =
+{
+    {
+        .bus = 0U,
+        .route = { 0U, 0U },
+        .dps_address = (uint16_t)XENSIV_DPS3XX_I2C_ADDR_ALT,
+        .int_pin = PASCO2_BOARD_INT
     }
+};
+#endif /* PASCO2_NODE_TABLE */
+
+/* CO2 LEDs lit for an alarm level */
+#define PASCO2_ALARM_LED_GOOD (1U << 0)
+#define PASCO2_ALARM_LED_HIGH (1U << 1)
+
+#define PASCO2_BUS_COUNT    ((uint8_t)(sizeof(bus_configs) / sizeof(bus_configs[0])))
+#define PASCO2_SENSOR_COUNT ((uint8_t)(sizeof(sensor_configs) / sizeof(sensor_configs[0])))
+
+/* Sensor nodes whose baseline is kept in the snapshots, the others learn it
+ * again after a reset */
+#define PASCO2_BASELINE_NODES ((PASCO2_SENSOR_COUNT < PASCO2_BASELINE_MAX_NODES) ? PASCO2_SENSOR_COUNT : \
+                               (uint8_t)PASCO2_BASELINE_MAX_NODES)
 
 /*******************************************************************************
  * Global Variables
  ******************************************************************************/
-xensiv_pasco2_t xensiv_pasco2;
-
-static volatile bool log_internal = false;
 static volatile bool display_ppm = true;
+static volatile bool binary_telemetry = false;
 extern cyhal_timer_t led_blink_timer;
 
+/* Measurement period programmed in the sensors in seconds and the
+ * measurement mode, written by the sensor task only */
+static uint16_t measurement_period = PASCO2_DEFAULT_MEAS_PERIOD;
+static volatile bool single_shot_mode = false;
+static cy_thread_t pasco2_task_handle;
+
+/* Commands of other tasks, executed by the sensor task, which is the only
+ * one accessing the sensors and their buses */
+static pasco2_command_queue_t command_queue;
+
+/* Adaptive measurement rate controller, written by the sensor task only. A
+ * fixed period set with pasco2_set_measurement_period turns it off. */
+static pasco2_rate_t rate_controller;
+static volatile bool adaptive_rate = true;
+
+/* Time budget of the current measurement mode, written by the sensor task only */
+static pasco2_power_stats_t power_stats;
+static TickType_t power_stats_start;
+
+/* Boot phases, written by the sensor task only */
+static pasco2_boot_stats_t boot_stats;
+
+/* I2C buses and their asynchronous transaction engines */
+static cyhal_i2c_t i2c_buses[sizeof(bus_configs) / sizeof(bus_configs[0])];
+static pasco2_i2c_engine_t i2c_engines[sizeof(bus_configs) / sizeof(bus_configs[0])];
+
+/* Sensor nodes, nodes that failed to initialize are skipped */
+static pasco2_sensor_t sensors[sizeof(sensor_configs) / sizeof(sensor_configs[0])];
+static bool sensor_present[sizeof(sensor_configs) / sizeof(sensor_configs[0])];
+
+/* Windowed CO2 statistics of each sensor node, written by the sensor task */
+static pasco2_stats_t co2_stats[sizeof(sensor_configs) / sizeof(sensor_configs[0])];
+
+/* Fault detection and recovery of the sensor nodes */
+static pasco2_recovery_t recovery[sizeof(sensor_configs) / sizeof(sensor_configs[0])];
+
+/* Completions of the requests started in one acquisition pass */
+static cy_semaphore_t batch_done;
+static pasco2_rtos_semaphore_storage_t batch_done_storage;
+
+/* Samples handed over from the sensor task to the output task */
+static pasco2_sample_ring_t sample_ring;
+PASCO2_RTOS_THREAD_DEFINE(output_thread, PASCO2_OUTPUT_TASK_STACK_SIZE);
+
+/* Terminal UI task, started once the sensors are up */
+PASCO2_RTOS_THREAD_DEFINE(terminal_thread, PASCO2_TERMINAL_UI_TASK_STACK_SIZE);
+
+/* Work flash, initialized by the sensor task and written by the output task */
+static cyhal_flash_t work_flash;
+static cy_rslt_t work_flash_result;
+
+/* History log in flash, written by the output task */
+static pasco2_history_t history;
+static volatile bool history_ready = false;
+
+/* Baseline compensation of the sensor nodes, applied by the sensor task. Its
+ * snapshots are handed to the output task, which writes them to flash. */
+static pasco2_baseline_t baselines[sizeof(sensor_configs) / sizeof(sensor_configs[0])];
+static pasco2_baseline_state_t baseline_snapshot[sizeof(sensor_configs) / sizeof(sensor_configs[0])];
+static volatile bool baseline_snapshot_pending = false;
+static TickType_t baseline_snapshot_tick;
+static pasco2_baseline_store_t baseline_store;
+static bool baseline_store_ready = false;
+
+/* CO2 alarm of every sensor node, evaluated by the output task. Thresholds
+ * set by the terminal UI wait in alarm_config_next until the output task
+ * applies them. The output task publishes a copy of every alarm it changed
+ * in alarm_snapshots, which the other tasks read. */
+static pasco2_alarm_t alarms[sizeof(sensor_configs) / sizeof(sensor_configs[0])];
+static pasco2_alarm_t alarm_snapshots[sizeof(sensor_configs) / sizeof(sensor_configs[0])];
+static pasco2_alarm_config_t alarm_config_next;
+static volatile bool alarm_config_pending = false;
+
+/* Pins of the CO2 LEDs that are lit, PASCO2_ALARM_LED_xxx, written by the
+ * output task */
+static uint8_t alarm_leds = 0U;
+
+/*******************************************************************************
+ * Function Prototypes
+ ******************************************************************************/
+static void pasco2_output_task(cy_thread_arg_t arg);
+
 /*******************************************************************************
  * Function Name: pasco2_enable_internal_logging
  *******************************************************************************
@@ -114,24 +279,1251 @@ void pasco2_enable_internal_logging(bool enable_logging)
     {
         printf("Disabled additional diagnostic logging\r\n\r\n");
     }
-    log_internal = enable_logging;
+    pasco2_log_set_level(enable_logging ? PASCO2_LOG_LEVEL_DEBUG : PASCO2_LOG_LEVEL_INFO);
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_display_ppm
+ *******************************************************************************
+ * Summary:
+ *   Enables serial printing of CO2 PPM value
+ *
+ * Parameters:
+ *   enable_output: enables printing of CO2 value
+ *
+ * Return:
+ *   system time in ms
+ ******************************************************************************/
+void pasco2_display_ppm(bool enable_output)
+{
+    display_ppm = enable_output;
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_enable_binary_telemetry
+ *******************************************************************************
+ * Summary:
+ *   Selects the output format of the samples: text lines or binary telemetry
+ *   frames.
+ *
+ * Parameters:
+ *   enable_binary: true to stream binary frames, false for text output
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+void pasco2_enable_binary_telemetry(bool enable_binary)
+{
+    binary_telemetry = enable_binary;
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_set_measurement_period
+ *******************************************************************************
+ * Summary:
+ *   Sets a new measurement period and waits until the sensor task has
+ *   programmed it into all sensors in continuous mode, or taken it as
+ *   trigger interval in single-shot mode.
+ *
+ * Parameters:
+ *   period: measurement period in seconds
+ *
+ * Return:
+ *   Result of the command, an error of the command queue or of the sensor
+ *   that could not be configured
+ ******************************************************************************/
+cy_rslt_t pasco2_set_measurement_period(uint16_t period)
+{
+    pasco2_command_t command = { .type = PASCO2_COMMAND_SET_PERIOD, .arg.period_s = period };
+
+    return pasco2_command_execute(&command_queue, &command, PASCO2_COMMAND_TIMEOUT_MS);
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_set_single_shot_mode
+ *******************************************************************************
+ * Summary:
+ *   Selects the measurement mode and waits until the sensor task has applied
+ *   it. In single-shot mode the sensor task triggers one measurement per
+ *   measurement period and the MCU may enter deep sleep in between; in
+ *   continuous mode the sensor measures on its own and deep sleep is locked.
+ *
+ * Parameters:
+ *   enable_single_shot: true for single-shot mode, false for continuous mode
+ *
+ * Return:
+ *   Result of the command, an error of the command queue or of the sensor
+ *   that could not be configured
+ ******************************************************************************/
+cy_rslt_t pasco2_set_single_shot_mode(bool enable_single_shot)
+{
+    pasco2_command_t command = { .type = PASCO2_COMMAND_SET_SINGLE_SHOT, .arg.single_shot = enable_single_shot };
+
+    return pasco2_command_execute(&command_queue, &command, PASCO2_COMMAND_TIMEOUT_MS);
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_set_adaptive_rate
+ *******************************************************************************
+ * Summary:
+ *   Lets the rate controller of the sensor task choose the measurement period
+ *   between the given bounds, or turns it off and keeps the current period.
+ *   Waits until the sensor task has applied the change.
+ *
+ * Parameters:
+ *   period_fast_s: period while the CO2 concentration changes, 0 to turn the
+ *                  controller off
+ *   period_slow_s: longest period while the CO2 concentration is stable
+ *
+ * Return:
+ *   Result of the command, an error of the command queue or of the sensor
+ *   that could not be configured
+ ******************************************************************************/
+cy_rslt_t pasco2_set_adaptive_rate(uint16_t period_fast_s, uint16_t period_slow_s)
+{
+    pasco2_command_t command = { .type = PASCO2_COMMAND_SET_ADAPTIVE };
+
+    command.arg.adaptive.period_fast_s = period_fast_s;
+    command.arg.adaptive.period_slow_s = period_slow_s;
+    return pasco2_command_execute(&command_queue, &command, PASCO2_COMMAND_TIMEOUT_MS);
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_get_adaptive_rate
+ *******************************************************************************
+ * Summary:
+ *   Returns a copy of the adaptive measurement rate controller.
+ *
+ * Parameters:
+ *   rate: destination of the controller state
+ *
+ * Return:
+ *   true if the controller chooses the measurement period
+ ******************************************************************************/
+bool pasco2_get_adaptive_rate(pasco2_rate_t *rate)
+{
+    taskENTER_CRITICAL();
+    *rate = rate_controller;
+    bool enabled = adaptive_rate;
+    taskEXIT_CRITICAL();
+
+    return enabled;
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_get_command_stats
+ *******************************************************************************
+ * Summary:
+ *   Returns the counters and the latency of the command queue of the sensor
+ *   task.
+ *
+ * Parameters:
+ *   stats: destination of the counters
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+void pasco2_get_command_stats(pasco2_command_stats_t *stats)
+{
+    pasco2_command_get_stats(&command_queue, stats);
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_get_single_shot_mode
+ *******************************************************************************
+ * Summary:
+ *   Returns the measurement mode applied by the sensor task.
+ *
+ * Parameters:
+ *   none
+ *
+ * Return:
+ *   true in single-shot mode, false in continuous mode
+ ******************************************************************************/
+bool pasco2_get_single_shot_mode(void)
+{
+    return single_shot_mode;
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_get_power_stats
+ *******************************************************************************
+ * Summary:
+ *   Returns the time budget of the sensor task since the measurement mode
+ *   was entered.
+ *
+ * Parameters:
+ *   stats: destination of the counters
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+void pasco2_get_power_stats(pasco2_power_stats_t *stats)
+{
+    taskENTER_CRITICAL();
+    *stats = power_stats;
+    stats->elapsed_ms = (uint32_t)((xTaskGetTickCount() - power_stats_start) * portTICK_PERIOD_MS);
+    taskEXIT_CRITICAL();
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_get_boot_stats
+ *******************************************************************************
+ * Summary:
+ *   Returns the times of the boot phases of the sensor task.
+ *
+ * Parameters:
+ *   stats: destination of the boot phases
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+void pasco2_get_boot_stats(pasco2_boot_stats_t *stats)
+{
+    taskENTER_CRITICAL();
+    *stats = boot_stats;
+    taskEXIT_CRITICAL();
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_get_sensor_count
+ *******************************************************************************
+ * Summary:
+ *   Returns the number of sensor nodes in the sensor table.
+ *
+ * Parameters:
+ *   none
+ *
+ * Return:
+ *   number of sensor nodes
+ ******************************************************************************/
+uint8_t pasco2_get_sensor_count(void)
+{
+    return PASCO2_SENSOR_COUNT;
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_get_bus_count
+ *******************************************************************************
+ * Summary:
+ *   Returns the number of I2C buses of the sensor nodes.
+ *
+ * Parameters:
+ *   none
+ *
+ * Return:
+ *   number of I2C buses
+ ******************************************************************************/
+uint8_t pasco2_get_bus_count(void)
+{
+    return PASCO2_BUS_COUNT;
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_get_acquisition_stats
+ *******************************************************************************
+ * Summary:
+ *   Returns a copy of the acquisition counters of a sensor node.
+ *
+ * Parameters:
+ *   sensor: index of the sensor node
+ *   stats: destination of the counters
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+void pasco2_get_acquisition_stats(uint8_t sensor, pasco2_acquisition_stats_t *stats)
+{
+    CY_ASSERT(sensor < PASCO2_SENSOR_COUNT);
+
+    taskENTER_CRITICAL();
+    *stats = sensors[sensor].stats;
+    taskEXIT_CRITICAL();
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_get_recovery_stats
+ *******************************************************************************
+ * Summary:
+ *   Returns a copy of the recovery counters of a sensor node.
+ *
+ * Parameters:
+ *   sensor: index of the sensor node
+ *   stats: destination of the counters
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+void pasco2_get_recovery_stats(uint8_t sensor, pasco2_recovery_stats_t *stats)
+{
+    CY_ASSERT(sensor < PASCO2_SENSOR_COUNT);
+
+    taskENTER_CRITICAL();
+    *stats = recovery[sensor].stats;
+    taskEXIT_CRITICAL();
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_get_baseline_stats
+ *******************************************************************************
+ * Summary:
+ *   Returns a copy of the baseline compensation counters of a sensor node.
+ *
+ * Parameters:
+ *   sensor: index of the sensor node
+ *   stats: destination of the counters
+ *
+ * Return:
+ *   false if the firmware does not compensate the baseline
+ ******************************************************************************/
+bool pasco2_get_baseline_stats(uint8_t sensor, pasco2_baseline_stats_t *stats)
+{
+    CY_ASSERT(sensor < PASCO2_SENSOR_COUNT);
+
+    if (PASCO2_BASELINE_ENABLE == 0U)
+    {
+        return false;
+    }
+
+    taskENTER_CRITICAL();
+    pasco2_baseline_get_stats(&baselines[sensor], stats);
+    taskEXIT_CRITICAL();
+
+    return true;
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_set_alarm_config
+ *******************************************************************************
+ * Summary:
+ *   Hands new alarm thresholds to the output task, which applies them to all
+ *   sensor nodes before the next value. The level of every node is set anew
+ *   by its next value.
+ *
+ * Parameters:
+ *   config: thresholds, count 0 turns the alarms off
+ *
+ * Return:
+ *   PASCO2_ALARM_RSLT_ERR_CONFIG if the thresholds do not ascend by more
+ *   than the hysteresis
+ ******************************************************************************/
+cy_rslt_t pasco2_set_alarm_config(const pasco2_alarm_config_t *config)
+{
+    if (!pasco2_alarm_config_valid(config))
+    {
+        return PASCO2_ALARM_RSLT_ERR_CONFIG;
+    }
+
+    taskENTER_CRITICAL();
+    alarm_config_next = *config;
+    alarm_config_pending = true;
+    taskEXIT_CRITICAL();
+    xTaskNotifyGive((TaskHandle_t)output_thread.handle);
+
+    return CY_RSLT_SUCCESS;
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_get_alarm
+ *******************************************************************************
+ * Summary:
+ *   Returns a copy of the CO2 alarm of a sensor node, as last published by
+ *   the output task.
+ *
+ * Parameters:
+ *   sensor: index of the sensor node
+ *   alarm: destination of the alarm state
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+void pasco2_get_alarm(uint8_t sensor, pasco2_alarm_t *alarm)
+{
+    CY_ASSERT(sensor < PASCO2_SENSOR_COUNT);
+
+    taskENTER_CRITICAL();
+    *alarm = alarm_snapshots[sensor];
+    taskEXIT_CRITICAL();
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_get_sample_ring_stats
+ *******************************************************************************
+ * Summary:
+ *   Returns the occupancy counters of the ring between the sensor task and
+ *   the output task.
+ *
+ * Parameters:
+ *   stats: destination of the counters
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+void pasco2_get_sample_ring_stats(pasco2_sample_ring_stats_t *stats)
+{
+    taskENTER_CRITICAL();
+    pasco2_sample_ring_get_stats(&sample_ring, stats);
+    taskEXIT_CRITICAL();
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_get_i2c_engine_stats
+ *******************************************************************************
+ * Summary:
+ *   Returns the counters of the asynchronous I2C engine of a bus.
+ *
+ * Parameters:
+ *   bus: index of the I2C bus
+ *   stats: destination of the counters
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+void pasco2_get_i2c_engine_stats(uint8_t bus, pasco2_i2c_engine_stats_t *stats)
+{
+    CY_ASSERT(bus < PASCO2_BUS_COUNT);
+
+    pasco2_i2c_engine_get_stats(&i2c_engines[bus], stats);
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_get_pressure_stats
+ *******************************************************************************
+ * Summary:
+ *   Returns the counters of the pressure compensation filter of a sensor
+ *   node.
+ *
+ * Parameters:
+ *   sensor: index of the sensor node
+ *   stats: destination of the counters
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+void pasco2_get_pressure_stats(uint8_t sensor, pasco2_pressure_stats_t *stats)
+{
+    CY_ASSERT(sensor < PASCO2_SENSOR_COUNT);
+
+    taskENTER_CRITICAL();
+    *stats = sensors[sensor].pressure.stats;
+    taskEXIT_CRITICAL();
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_get_dps_fifo_stats
+ *******************************************************************************
+ * Summary:
+ *   Returns the counters of the DPS3xx FIFO readout of a sensor node.
+ *
+ * Parameters:
+ *   sensor: index of the sensor node
+ *   stats: destination of the counters
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+void pasco2_get_dps_fifo_stats(uint8_t sensor, pasco2_dps_fifo_stats_t *stats)
+{
+    CY_ASSERT(sensor < PASCO2_SENSOR_COUNT);
+
+    taskENTER_CRITICAL();
+    *stats = sensors[sensor].dps.stats;
+    taskEXIT_CRITICAL();
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_get_co2_stats
+ *******************************************************************************
+ * Summary:
+ *   Returns the CO2 statistics of a sensor node over one of the windows. The
+ *   sensor task is not held up; if it updates the statistics meanwhile, the
+ *   query is repeated.
+ *
+ * Parameters:
+ *   sensor: index of the sensor node
+ *   window: statistics window
+ *   summary: destination of the statistics
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+void pasco2_get_co2_stats(uint8_t sensor, pasco2_stats_window_id_t window, pasco2_stats_summary_t *summary)
+{
+    CY_ASSERT(sensor < PASCO2_SENSOR_COUNT);
+
+    while (!pasco2_stats_query(&co2_stats[sensor], window, (uint32_t)(xTaskGetTickCount() * portTICK_PERIOD_MS),
+                               summary))
+    {
+        (void)cy_rtos_delay_milliseconds(1U);
+    }
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_get_history_stats
+ *******************************************************************************
+ * Summary:
+ *   Returns the counters of the history log in flash.
+ *
+ * Parameters:
+ *   stats: destination of the counters
+ *
+ * Return:
+ *   false if the history log is not in use
+ ******************************************************************************/
+bool pasco2_get_history_stats(pasco2_history_stats_t *stats)
+{
+    if (!history_ready)
+    {
+        return false;
+    }
+
+    taskENTER_CRITICAL();
+    pasco2_history_get_stats(&history, stats);
+    taskEXIT_CRITICAL();
+
+    return true;
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_read_history_page
+ *******************************************************************************
+ * Summary:
+ *   Reads the oldest page of the history log whose sequence number is not
+ *   below the given one. Waits while the output task updates the log.
+ *
+ * Parameters:
+ *   sequence: smallest sequence number on entry, sequence number of the page
+ *             on return
+ *   page: destination of the page
+ *
+ * Return:
+ *   CY_RSLT_SUCCESS, PASCO2_HISTORY_RSLT_ERR_END if there is no such page,
+ *   PASCO2_HISTORY_RSLT_ERR_PAGE if the page is corrupt, or an error of the
+ *   history log
+ ******************************************************************************/
+cy_rslt_t pasco2_read_history_page(uint32_t *sequence, pasco2_history_page_t *page)
+{
+    cy_rslt_t result = PASCO2_HISTORY_RSLT_ERR_END;
+
+    if (history_ready)
+    {
+        uint32_t first = *sequence;
+
+        while ((result = pasco2_history_read_next(&history, sequence, page)) == PASCO2_HISTORY_RSLT_ERR_BUSY)
+        {
+            *sequence = first;
+            (void)cy_rtos_delay_milliseconds(1U);
+        }
+    }
+
+    return result;
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_init_board
+ *******************************************************************************
+ * Summary:
+ *   Initializes the sensor interface select, the supply switches, and the
+ *   LEDs of the kit and switches on the sensors. Pins the kit does not have
+ *   are skipped at compile time. The status LED belongs to main().
+ *
+ * Parameters:
+ *   none
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+static void pasco2_init_board(void)
+{
+    cy_rslt_t result = pasco2_board_output_init(PASCO2_BOARD_PSEL, PASCO2_BOARD_PSEL_I2C);
+    if (result != CY_RSLT_SUCCESS)
+    {
+        CY_ASSERT(0);
+    }
+
+    result = pasco2_board_output_init(PASCO2_BOARD_POWER_SWITCH, PASCO2_BOARD_POWER_ON);
+    if (result != CY_RSLT_SUCCESS)
+    {
+        CY_ASSERT(0);
+    }
+
+    if (PASCO2_BOARD_LED_OK != PASCO2_BOARD_LED_STATUS)
+    {
+        result = pasco2_board_output_init(PASCO2_BOARD_LED_OK, PASCO2_BOARD_LED_OK_OFF);
+        if (result != CY_RSLT_SUCCESS)
+        {
+            CY_ASSERT(0);
+        }
+    }
+
+    result = pasco2_board_output_init(PASCO2_BOARD_LED_WARNING, PASCO2_BOARD_LED_WARNING_OFF);
+    if (result != CY_RSLT_SUCCESS)
+    {
+        CY_ASSERT(0);
+    }
+
+    result = pasco2_board_output_init(PASCO2_BOARD_LED_CO2_GOOD, PASCO2_BOARD_LED_CO2_OFF);
+    if (result != CY_RSLT_SUCCESS)
+    {
+        CY_ASSERT(0);
+    }
+
+    result = pasco2_board_output_init(PASCO2_BOARD_LED_CO2_HIGH, PASCO2_BOARD_LED_CO2_OFF);
+    if (result != CY_RSLT_SUCCESS)
+    {
+        CY_ASSERT(0);
+    }
+
+    /* The emitter supply is switched on after the logic supply */
+    result = pasco2_board_output_init(PASCO2_BOARD_EMITTER_ENABLE, false);
+    if (result != CY_RSLT_SUCCESS)
+    {
+        CY_ASSERT(0);
+    }
+    pasco2_board_write(PASCO2_BOARD_EMITTER_ENABLE, true);
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_restore_baselines
+ *******************************************************************************
+ * Summary:
+ *   Opens the baseline snapshots in the work flash and starts the
+ *   compensation of every sensor node from the latest snapshot, or from
+ *   scratch for the nodes it does not hold.
+ *
+ * Parameters:
+ *   none
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+static void pasco2_restore_baselines(void)
+{
+    pasco2_baseline_state_t states[sizeof(sensor_configs) / sizeof(sensor_configs[0])];
+    uint8_t restored = PASCO2_BASELINE_NODES;
+    cy_rslt_t result = work_flash_result;
+
+    if (result == CY_RSLT_SUCCESS)
+    {
+        result = pasco2_baseline_store_open(&baseline_store, &work_flash, PASCO2_BASELINE_ADDRESS, states, &restored);
+        baseline_store_ready = (result == CY_RSLT_SUCCESS) || (result == PASCO2_BASELINE_RSLT_ERR_EMPTY);
+    }
+    if (result != CY_RSLT_SUCCESS)
+    {
+        restored = 0U;
+    }
+
+    for (uint8_t i = 0U; i < PASCO2_SENSOR_COUNT; i++)
+    {
+        pasco2_baseline_init(&baselines[i], (i < restored) ? &states[i] : NULL);
+        if (baselines[i].stats.valid)
+        {
+            PASCO2_LOG_INFO(PASCO2_LOG_BASELINE_RESTORED, i, (uint32_t)(int32_t)baselines[i].offset);
+        }
+    }
+    baseline_snapshot_tick = xTaskGetTickCount();
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_snapshot_baselines
+ *******************************************************************************
+ * Summary:
+ *   Hands a copy of the baseline states to the output task every
+ *   PASCO2_BASELINE_SNAPSHOT_S. A snapshot the output task has not written
+ *   yet is not overwritten.
+ *
+ * Parameters:
+ *   now: current tick count
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+static void pasco2_snapshot_baselines(TickType_t now)
+{
+    if (!baseline_store_ready || baseline_snapshot_pending ||
+        ((now - baseline_snapshot_tick) < pdMS_TO_TICKS(PASCO2_BASELINE_SNAPSHOT_S * 1000U)))
+    {
+        return;
+    }
+
+    for (uint8_t i = 0U; i < PASCO2_SENSOR_COUNT; i++)
+    {
+        baseline_snapshot[i] = baselines[i].state;
+    }
+    baseline_snapshot_tick = now;
+    /* The copy is complete before the output task sees the flag */
+    __DMB();
+    baseline_snapshot_pending = true;
+    xTaskNotifyGive((TaskHandle_t)output_thread.handle);
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_alarm_show
+ *******************************************************************************
+ * Summary:
+ *   Alarm subscriber: shows the highest level over all sensor nodes on the
+ *   CO2 LEDs. The lowest level lights the good LED, the highest the high
+ *   LED, and the levels in between both. Only pins that change are written.
+ *
+ * Parameters:
+ *   callback_arg: unused
+ *   alarm: alarm that changed its level
+ *   previous: level before the change
+ *   ppm: CO2 value that caused the change
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+static void pasco2_alarm_show(void *callback_arg, const pasco2_alarm_t *alarm, uint8_t previous, uint16_t ppm)
+{
+    (void)callback_arg;
+    (void)previous;
+    (void)ppm;
+
+    uint8_t level = 0U;
+    for (uint8_t i = 0U; i < PASCO2_SENSOR_COUNT; i++)
+    {
+        if ((alarms[i].level != PASCO2_ALARM_LEVEL_UNKNOWN) && (alarms[i].level > level))
+        {
+            level = alarms[i].level;
+        }
+    }
+
+    uint8_t leds = 0U;
+    if (alarm->config.count > 0U)
+    {
+        leds |= (level < alarm->config.count) ? PASCO2_ALARM_LED_GOOD : 0U;
+        leds |= (level > 0U) ? PASCO2_ALARM_LED_HIGH : 0U;
+    }
+
+    uint8_t changed = leds ^ alarm_leds;
+    if ((changed & PASCO2_ALARM_LED_GOOD) != 0U)
+    {
+        pasco2_board_write(PASCO2_BOARD_LED_CO2_GOOD,
+                           ((leds & PASCO2_ALARM_LED_GOOD) != 0U) ? PASCO2_BOARD_LED_CO2_ON : PASCO2_BOARD_LED_CO2_OFF);
+    }
+    if ((changed & PASCO2_ALARM_LED_HIGH) != 0U)
+    {
+        pasco2_board_write(PASCO2_BOARD_LED_CO2_HIGH,
+                           ((leds & PASCO2_ALARM_LED_HIGH) != 0U) ? PASCO2_BOARD_LED_CO2_ON : PASCO2_BOARD_LED_CO2_OFF);
+    }
+    alarm_leds = leds;
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_alarm_log
+ *******************************************************************************
+ * Summary:
+ *   Alarm subscriber: logs the level changes. The first level of a node is
+ *   only logged if it is above the lowest.
+ *
+ * Parameters:
+ *   callback_arg: unused
+ *   alarm: alarm that changed its level
+ *   previous: level before the change
+ *   ppm: CO2 value that caused the change
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+static void pasco2_alarm_log(void *callback_arg, const pasco2_alarm_t *alarm, uint8_t previous, uint16_t ppm)
+{
+    (void)callback_arg;
+    (void)ppm;
+
+    if ((previous == PASCO2_ALARM_LEVEL_UNKNOWN) ? (alarm->level > 0U) : (alarm->level > previous))
+    {
+        PASCO2_LOG_WARN(PASCO2_LOG_ALARM_RAISED, alarm->sensor, alarm->level);
+    }
+    else if (previous != PASCO2_ALARM_LEVEL_UNKNOWN)
+    {
+        PASCO2_LOG_INFO(PASCO2_LOG_ALARM_LOWERED, alarm->sensor, alarm->level);
+    }
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_alarm_publish
+ *******************************************************************************
+ * Summary:
+ *   Copies the CO2 alarm of a sensor node to its snapshot. The alarm itself
+ *   is changed outside a critical section, because its update calls the
+ *   subscribers.
+ *
+ * Parameters:
+ *   sensor: index of the sensor node
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+static void pasco2_alarm_publish(uint8_t sensor)
+{
+    taskENTER_CRITICAL();
+    alarm_snapshots[sensor] = alarms[sensor];
+    taskEXIT_CRITICAL();
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_init_alarms
+ *******************************************************************************
+ * Summary:
+ *   Starts the CO2 alarm of every sensor node with the default thresholds and
+ *   subscribes the CO2 LEDs, if the kit has them, and the log.
+ *
+ * Parameters:
+ *   none
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+static void pasco2_init_alarms(void)
+{
+    pasco2_alarm_config_t config;
+
+    pasco2_alarm_default_config(&config);
+    for (uint8_t i = 0U; i < PASCO2_SENSOR_COUNT; i++)
+    {
+        pasco2_alarm_init(&alarms[i], i, &config);
+        if (PASCO2_BOARD_LED_CO2_GOOD != NC)
+        {
+            (void)pasco2_alarm_subscribe(&alarms[i], pasco2_alarm_show, NULL);
+        }
+        (void)pasco2_alarm_subscribe(&alarms[i], pasco2_alarm_log, NULL);
+        pasco2_alarm_publish(i);
+    }
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_batch_done
+ *******************************************************************************
+ * Summary:
+ *   Completion callback of the requests of an acquisition pass, counts the
+ *   completion for the waiting sensor task.
+ *
+ * Parameters:
+ *   callback_arg: unused
+ *   result: result of the request
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+static void pasco2_batch_done(void *callback_arg, cy_rslt_t result)
+{
+    (void)callback_arg;
+    (void)result;
+    (void)cy_rtos_set_semaphore(&batch_done, true);
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_drdy_pending
+ *******************************************************************************
+ * Summary:
+ *   Returns whether a sensor node that is not suspended by a fault has
+ *   signalled data ready and waits for its readout.
+ *
+ * Parameters:
+ *   none
+ *
+ * Return:
+ *   true if a data-ready readout is pending
+ ******************************************************************************/
+static bool pasco2_drdy_pending(void)
+{
+    for (uint8_t i = 0U; i < PASCO2_SENSOR_COUNT; i++)
+    {
+        if (sensor_present[i] && sensors[i].drdy && (recovery[i].state != PASCO2_RECOVERY_STATE_FAULT))
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_next_wait
+ *******************************************************************************
+ * Summary:
+ *   Returns the time until the next CO2 or pressure readout of any sensor
+ *   node, or the next recovery action of a faulty node, is due.
+ *
+ * Parameters:
+ *   now: current tick count
+ *
+ * Return:
+ *   ticks to wait, 0 if a readout is overdue or data ready is pending
+ ******************************************************************************/
+static TickType_t pasco2_next_wait(TickType_t now)
+{
+    TickType_t wait = portMAX_DELAY;
+
+    if (pasco2_drdy_pending())
+    {
+        return 0U;
+    }
+
+    for (uint8_t i = 0U; i < PASCO2_SENSOR_COUNT; i++)
+    {
+        if (!sensor_present[i])
+        {
+            continue;
+        }
+
+        int32_t remaining = (int32_t)(sensors[i].co2_due - now);
+        if (recovery[i].state == PASCO2_RECOVERY_STATE_FAULT)
+        {
+            /* Readouts are suspended until the action */
+            remaining = (int32_t)(recovery[i].due_ms - (uint32_t)(now * portTICK_PERIOD_MS)) /
+                        (int32_t)portTICK_PERIOD_MS;
+        }
+        else if (sensors[i].use_dps && ((int32_t)(sensors[i].pressure_due - now) < remaining))
+        {
+            remaining = (int32_t)(sensors[i].pressure_due - now);
+        }
+        if (remaining <= 0)
+        {
+            return 0U;
+        }
+        if ((TickType_t)remaining < wait)
+        {
+            wait = (TickType_t)remaining;
+        }
+    }
+
+    return wait;
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_log_fault
+ *******************************************************************************
+ * Summary:
+ *   Logs the entry of a node into the fault state: a new fault, or a failed
+ *   recovery action and the wait until the next one.
+ *
+ * Parameters:
+ *   sensor: index of the sensor node
+ *   now: current tick count
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+static void pasco2_log_fault(uint8_t sensor, TickType_t now)
+{
+    const pasco2_recovery_t *node = &recovery[sensor];
+
+    /* Unused when PASCO2_LOG_LEVEL removes the warnings */
+    (void)now;
+
+    if (node->action == PASCO2_RECOVERY_ACTION_NONE)
+    {
+        PASCO2_LOG_WARN(PASCO2_LOG_RECOVERY_FAULT, sensor);
+    }
+    else
+    {
+        PASCO2_LOG_WARN(PASCO2_LOG_RECOVERY_FAILED, sensor, node->due_ms - (uint32_t)(now * portTICK_PERIOD_MS));
+    }
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_node_error
+ *******************************************************************************
+ * Summary:
+ *   Records a failed readout, trigger or configuration of a node with its
+ *   fault detection.
+ *
+ * Parameters:
+ *   sensor: index of the sensor node
+ *   now: current tick count
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+static void pasco2_node_error(uint8_t sensor, TickType_t now)
+{
+    if (pasco2_recovery_error(&recovery[sensor], (uint32_t)(now * portTICK_PERIOD_MS)))
+    {
+        pasco2_log_fault(sensor, now);
+    }
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_recover_node
+ *******************************************************************************
+ * Summary:
+ *   Takes a recovery action on a faulty node and configures the node again
+ *   with the current measurement mode and period. The action blocks the
+ *   sensor task until the node is ready again, at most for
+ *   PASCO2_POWER_OFF_MS and PASCO2_READY_TIMEOUT_MS. A bus clear also
+ *   restarts pending transfers of the other nodes on the bus.
+ *
+ * Parameters:
+ *   sensor: index of the sensor node
+ *   action: action due
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+static void pasco2_recover_node(uint8_t sensor, pasco2_recovery_action_t action)
+{
+    pasco2_sensor_t *node = &sensors[sensor];
+    const pasco2_bus_config_t *bus = &bus_configs[node->config->bus];
+    uint32_t polls = 0U;
+    cy_rslt_t result;
+
+    switch (action)
+    {
+        case PASCO2_RECOVERY_ACTION_BUS_CLEAR:
+            /* A device holding the bus is released, the sensors keep their
+             * configuration */
+            PASCO2_LOG_WARN(PASCO2_LOG_RECOVERY_BUS_CLEAR, sensor);
+            result = pasco2_i2c_engine_recover(node->engine, bus->sda, bus->scl, &i2c_master_config);
+            if (result == CY_RSLT_SUCCESS)
+            {
+                result = pasco2_sensor_wait_ready(node, xTaskGetTickCount(), &polls);
+            }
+            if (result == CY_RSLT_SUCCESS)
+            {
+                result = pasco2_sensor_configure_mode(node, single_shot_mode, measurement_period);
+            }
+            break;
+
+        case PASCO2_RECOVERY_ACTION_SENSOR_RESET:
+            PASCO2_LOG_WARN(PASCO2_LOG_RECOVERY_RESET, sensor);
+            result = pasco2_sensor_reset(node);
+            if (result == CY_RSLT_SUCCESS)
+            {
+                result = pasco2_sensor_restart(node, single_shot_mode, measurement_period,
+                                               xTaskGetTickCount() + pdMS_TO_TICKS(PASCO2_READY_TIMEOUT_MS), &polls);
+            }
+            break;
+
+        case PASCO2_RECOVERY_ACTION_POWER_CYCLE:
+            if (PASCO2_BOARD_POWER_SWITCH == NC)
+            {
+                /* Not escalated to on kits without a power switch */
+                CY_ASSERT(0);
+                result = PASCO2_RSLT_ERR_NOT_READY;
+                break;
+            }
+            /* Switches all sensors of the board */
+            PASCO2_LOG_WARN(PASCO2_LOG_RECOVERY_POWER_CYCLE, sensor);
+            pasco2_board_write(PASCO2_BOARD_POWER_SWITCH, PASCO2_BOARD_POWER_OFF);
+            vTaskDelay(pdMS_TO_TICKS(PASCO2_POWER_OFF_MS));
+            pasco2_board_write(PASCO2_BOARD_POWER_SWITCH, PASCO2_BOARD_POWER_ON);
+            result = pasco2_sensor_restart(node, single_shot_mode, measurement_period,
+                                           xTaskGetTickCount() + pdMS_TO_TICKS(PASCO2_READY_TIMEOUT_MS), &polls);
+            break;
+
+        default:
+            CY_ASSERT(0);
+            result = PASCO2_RSLT_ERR_NOT_READY;
+            break;
+    }
+
+    /* The node is read again as after a mode change */
+    TickType_t now = xTaskGetTickCount();
+    node->drdy = false;
+    node->single_shot_pending = false;
+    node->reference_pending = true;
+    node->co2_due = single_shot_mode ? now : (now + pdMS_TO_TICKS(PASCO2_SINGLE_SHOT_DURATION_MS));
+    node->pressure_due = now + pdMS_TO_TICKS(PASCO2_PRESSURE_SAMPLE_PERIOD_MS);
+
+    pasco2_recovery_done(&recovery[sensor], action, result == CY_RSLT_SUCCESS, (uint32_t)(now * portTICK_PERIOD_MS),
+                         (uint32_t)measurement_period * 1000U);
+    if (result != CY_RSLT_SUCCESS)
+    {
+        pasco2_log_fault(sensor, now);
+    }
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_configure_sensors
+ *******************************************************************************
+ * Summary:
+ *   Applies the measurement period and mode to all sensors and reschedules
+ *   their readouts.
+ *
+ * Parameters:
+ *   single_shot_next: true for single-shot mode, false for continuous mode
+ *   now: current tick count
+ *
+ * Return:
+ *   CY_RSLT_SUCCESS, or the error of the last sensor that could not be
+ *   configured
+ ******************************************************************************/
+static cy_rslt_t pasco2_configure_sensors(bool single_shot_next, TickType_t now)
+{
+    cy_rslt_t result = CY_RSLT_SUCCESS;
+
+    for (uint8_t i = 0U; i < PASCO2_SENSOR_COUNT; i++)
+    {
+        pasco2_sensor_t *sensor = &sensors[i];
+        if (!sensor_present[i])
+        {
+            continue;
+        }
+
+        cy_rslt_t sensor_result = pasco2_sensor_configure_mode(sensor, single_shot_next, measurement_period);
+        if (sensor_result != CY_RSLT_SUCCESS)
+        {
+            PASCO2_LOG_ERROR(PASCO2_LOG_SENSOR_CONFIG_ERROR, i);
+            pasco2_node_error(i, now);
+            result = sensor_result;
+        }
+        pasco2_recovery_restart(&recovery[i], (uint32_t)(now * portTICK_PERIOD_MS),
+                                (uint32_t)measurement_period * 1000U);
+
+        /* Restarting continuous mode starts the first measurement, which
+         * takes as long as a single-shot one, so the readout is due then
+         * rather than one period later; a sensor without INT line would
+         * otherwise stay most of a period behind its results. The
+         * measurements restart, so the pressure reference goes with the
+         * first readout, and a data ready from before the restart is void. */
+        sensor->drdy = false;
+        sensor->single_shot_pending = false;
+        sensor->reference_pending = true;
+        sensor->co2_due = single_shot_next ? now : (now + pdMS_TO_TICKS(PASCO2_SINGLE_SHOT_DURATION_MS));
+    }
+
+    if (single_shot_next != single_shot_mode)
+    {
+        single_shot_mode = single_shot_next;
+        if (single_shot_next)
+        {
+            cyhal_syspm_unlock_deepsleep();
+        }
+        else
+        {
+            cyhal_syspm_lock_deepsleep();
+        }
+
+        taskENTER_CRITICAL();
+        power_stats = (pasco2_power_stats_t){ .samples = 0U };
+        power_stats_start = now;
+        taskEXIT_CRITICAL();
+    }
+
+    return result;
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_execute_command
+ *******************************************************************************
+ * Summary:
+ *   Executes a command of another task: applies the measurement period or
+ *   mode to all sensors, or hands the period over to the rate controller.
+ *
+ * Parameters:
+ *   command: command taken from the command queue
+ *   now: current tick count
+ *
+ * Return:
+ *   CY_RSLT_SUCCESS, or the error of the last sensor that could not be
+ *   configured
+ ******************************************************************************/
+static cy_rslt_t pasco2_execute_command(const pasco2_command_t *command, TickType_t now)
+{
+    bool single_shot_next = single_shot_mode;
+
+    switch (command->type)
+    {
+        case PASCO2_COMMAND_SET_PERIOD:
+            adaptive_rate = false;
+            measurement_period = command->arg.period_s;
+            break;
+
+        case PASCO2_COMMAND_SET_SINGLE_SHOT:
+            single_shot_next = command->arg.single_shot;
+            break;
+
+        case PASCO2_COMMAND_SET_ADAPTIVE:
+            if (command->arg.adaptive.period_fast_s == 0U)
+            {
+                /* Keep the period chosen last */
+                adaptive_rate = false;
+                return CY_RSLT_SUCCESS;
+            }
+            else
+            {
+                pasco2_rate_config_t config;
+                pasco2_rate_default_config(&config);
+                config.period_fast_s = command->arg.adaptive.period_fast_s;
+                config.period_slow_s = command->arg.adaptive.period_slow_s;
+
+                taskENTER_CRITICAL();
+                pasco2_rate_init(&rate_controller, &config);
+                adaptive_rate = true;
+                taskEXIT_CRITICAL();
+                measurement_period = rate_controller.period_s;
+            }
+            break;
+
+        default:
+            CY_ASSERT(0);
+            break;
+    }
+
+    return pasco2_configure_sensors(single_shot_next, now);
 }
 
 /*******************************************************************************
- * Function Name: pasco2_display_ppm
+ * Function Name: pasco2_update_rate
  *******************************************************************************
  * Summary:
- *   Enables serial printing of CO2 PPM value
+ *   Feeds a new CO2 value into the rate controller and applies the period it
+ *   asks for. In continuous mode the sensors are reprogrammed; in single-shot
+ *   mode the next trigger moves to one new period after the last one.
  *
  * Parameters:
- *   enable_output: enables printing of CO2 value
+ *   sample: new CO2 value of PASCO2_RATE_SENSOR
+ *   now: current tick count
  *
  * Return:
- *   system time in ms
+ *   none
  ******************************************************************************/
-void pasco2_display_ppm(bool enable_output)
+static void pasco2_update_rate(const pasco2_sample_t *sample, TickType_t now)
 {
-    display_ppm = enable_output;
+    taskENTER_CRITICAL();
+    bool changed = pasco2_rate_update(&rate_controller, sample->tick, sample->ppm, sample->pressure,
+                                      (sample->flags & PASCO2_SAMPLE_PRESSURE_VALID) != 0U);
+    taskEXIT_CRITICAL();
+    if (!changed)
+    {
+        return;
+    }
+
+    measurement_period = rate_controller.period_s;
+    switch (rate_controller.reason)
+    {
+        case PASCO2_RATE_REASON_STEP:
+            PASCO2_LOG_INFO(PASCO2_LOG_RATE_STEP, measurement_period,
+                            (rate_controller.deviation_ppm < 0) ? -rate_controller.deviation_ppm :
+                            rate_controller.deviation_ppm);
+            break;
+
+        case PASCO2_RATE_REASON_TREND:
+            PASCO2_LOG_INFO(PASCO2_LOG_RATE_TREND, measurement_period,
+                            (rate_controller.slope_ppm_min < 0) ? -rate_controller.slope_ppm_min :
+                            rate_controller.slope_ppm_min);
+            break;
+
+        default:
+            PASCO2_LOG_INFO(PASCO2_LOG_RATE_STABLE, measurement_period);
+            break;
+    }
+
+    if (!single_shot_mode)
+    {
+        (void)pasco2_configure_sensors(false, now);
+        return;
+    }
+
+    for (uint8_t i = 0U; i < PASCO2_SENSOR_COUNT; i++)
+    {
+        if (sensor_present[i] && !sensors[i].single_shot_pending)
+        {
+            sensors[i].co2_due = sensors[i].single_shot_start + pdMS_TO_TICKS((uint32_t)measurement_period * 1000U);
+        }
+    }
 }
 
 /*******************************************************************************
@@ -152,232 +1544,688 @@ void pasco2_task(cy_thread_arg_t arg)
     (void)arg;
     cy_rslt_t result;
 
-    xensiv_dps3xx_t xensiv_dps3xx;
-    bool use_dps = true;
-
-    /* I2C variables */
-    cyhal_i2c_t cyhal_i2c;
     /* initialize i2c library*/
-    cyhal_i2c_cfg_t i2c_master_config = {CYHAL_I2C_MODE_MASTER,
-                                         0 /* address is not used for master mode */,
-                                         I2C_MASTER_FREQUENCY};
+    for (uint8_t bus = 0U; bus < PASCO2_BUS_COUNT; bus++)
+    {
+        result = cyhal_i2c_init(&i2c_buses[bus], bus_configs[bus].sda, bus_configs[bus].scl, NULL);
+        if (result != CY_RSLT_SUCCESS)
+        {
+            CY_ASSERT(0);
+        }
+        result = cyhal_i2c_configure(&i2c_buses[bus], &i2c_master_config);
+        if (result != CY_RSLT_SUCCESS)
+        {
+            CY_ASSERT(0);
+        }
+        result = pasco2_i2c_engine_init(&i2c_engines[bus], &i2c_buses[bus]);
+        if (result != CY_RSLT_SUCCESS)
+        {
+            CY_ASSERT(0);
+        }
+    }
+
+    pasco2_init_board();
+
+    /* The sensors power up from here */
+    TickType_t power_tick = xTaskGetTickCount();
+    boot_stats.power_ms = (uint32_t)(power_tick * portTICK_PERIOD_MS);
 
-    result = cyhal_i2c_init(&cyhal_i2c, CYBSP_I2C_SDA, CYBSP_I2C_SCL, NULL);
+    /* Data-ready interrupts and commands of the terminal UI are signalled to
+     * this task */
+    result = cy_rtos_get_thread_handle(&pasco2_task_handle);
     if (result != CY_RSLT_SUCCESS)
     {
         CY_ASSERT(0);
     }
-    result = cyhal_i2c_configure(&cyhal_i2c, &i2c_master_config);
-    if (result != CY_RSLT_SUCCESS)
+
+    /* Bring up the pressure sensors of the nodes while the PAS CO2 sensors
+     * power up */
+    for (uint8_t i = 0U; i < PASCO2_SENSOR_COUNT; i++)
     {
-        CY_ASSERT(0);
+        const pasco2_sensor_config_t *config = &sensor_configs[i];
+
+        pasco2_stats_init(&co2_stats[i]);
+        result = pasco2_sensor_init(&sensors[i], config, &i2c_engines[config->bus], (TaskHandle_t)pasco2_task_handle);
+        sensor_present[i] = (result == CY_RSLT_SUCCESS);
     }
+    boot_stats.dps_ready_ms = (uint32_t)(xTaskGetTickCount() * portTICK_PERIOD_MS);
 
-#if defined(CYSBSYSKIT_DEV_01)
-    /* Initialize and enable PAS CO2 Wing Board I2C channel communication*/
-    result = cyhal_gpio_init(MTB_PASCO2_PSEL, CYHAL_GPIO_DIR_OUTPUT, CYHAL_GPIO_DRIVE_STRONG, MTB_PASCO2_PSEL_I2C_ENABLE);
-    if (result != CY_RSLT_SUCCESS)
+    /* Start every PAS CO2 as soon as it reports ready, nodes that do not
+     * answer are skipped */
+    uint8_t sensor_count = 0U;
+    TickType_t ready_deadline = power_tick + pdMS_TO_TICKS(PASCO2_READY_TIMEOUT_MS);
+    for (uint8_t i = 0U; i < PASCO2_SENSOR_COUNT; i++)
     {
-        CY_ASSERT(0);
+        if (sensor_present[i])
+        {
+            result = pasco2_sensor_wait_ready(&sensors[i], ready_deadline, &boot_stats.ready_polls);
+            if (result == CY_RSLT_SUCCESS)
+            {
+                boot_stats.co2_ready_ms = (uint32_t)(xTaskGetTickCount() * portTICK_PERIOD_MS);
+                result = pasco2_sensor_start(&sensors[i], single_shot_mode, measurement_period);
+            }
+            sensor_present[i] = (result == CY_RSLT_SUCCESS);
+        }
+
+        if (sensor_present[i])
+        {
+            sensor_count++;
+        }
+        else
+        {
+            printf("PAS CO2 device %u initialization error\n", (unsigned int)i);
+        }
     }
+    boot_stats.sensors_ready_ms = (uint32_t)(xTaskGetTickCount() * portTICK_PERIOD_MS);
+    PASCO2_LOG_INFO(PASCO2_LOG_BOOT_READY, boot_stats.sensors_ready_ms, boot_stats.ready_polls);
 
-    /* Initialize and enable PAS CO2 Wing Board power switch */
-    result = cyhal_gpio_init(MTB_PASCO2_POWER_SWITCH, CYHAL_GPIO_DIR_OUTPUT, CYHAL_GPIO_DRIVE_STRONG, MTB_PASCO2_POWER_ON);
-    if (result != CY_RSLT_SUCCESS)
+    if (sensor_count == 0U)
     {
-        CY_ASSERT(0);
+        printf("PAS CO2 device initialization error\n");
+        printf("Exiting pasco2_task task\n");
+        // exit current thread (suspend)
+        pasco2_rtos_exit_thread();
     }
 
-    /* Initialize the LEDs on PAS CO2 Wing Board */
-    result = cyhal_gpio_init(MTB_PASCO2_LED_OK, CYHAL_GPIO_DIR_OUTPUT, CYHAL_GPIO_DRIVE_STRONG, MTB_PASCO_LED_STATE_OFF);
+    result = pasco2_rtos_init_semaphore(&batch_done, &batch_done_storage, PASCO2_SENSOR_COUNT, 0U);
     if (result != CY_RSLT_SUCCESS)
     {
         CY_ASSERT(0);
     }
 
-    result = cyhal_gpio_init(MTB_PASCO2_LED_WARNING, CYHAL_GPIO_DIR_OUTPUT, CYHAL_GPIO_DRIVE_STRONG, MTB_PASCO_LED_STATE_OFF);
+    result = pasco2_command_queue_init(&command_queue, (TaskHandle_t)pasco2_task_handle);
     if (result != CY_RSLT_SUCCESS)
     {
         CY_ASSERT(0);
     }
-#else
-    /* Initialize the LEDs on the PSoC 62 baseboard */
-    cyhal_gpio_init(CYBSP_LED_RGB_GREEN, CYHAL_GPIO_DIR_OUTPUT,
-                                     CYHAL_GPIO_DRIVE_STRONG, CYBSP_LED_STATE_OFF);
-    cyhal_gpio_init(CYBSP_LED_RGB_RED, CYHAL_GPIO_DIR_OUTPUT,
-                                     CYHAL_GPIO_DRIVE_STRONG, CYBSP_LED_STATE_OFF);
-    cyhal_gpio_init(MTB_PASCO2_LED_WARNING, CYHAL_GPIO_DIR_OUTPUT,
-                                     CYHAL_GPIO_DRIVE_STRONG, CYBSP_LED_STATE_OFF);
-    
-    /* Initialize and enable the alternative power enable pin for PASCO2 sensor */
-    cyhal_gpio_init(PASCO2_PWR_EN_ALT, CYHAL_GPIO_DIR_OUTPUT,
-                                             CYHAL_GPIO_DRIVE_STRONG, false);
-    cyhal_gpio_write(PASCO2_PWR_EN_ALT,true);
 
-#endif
-    /* Delay 2s to wait for pasco2 sensor get ready */
-    vTaskDelay(pdMS_TO_TICKS(PASCO2_INITIALIZATION_DELAY));
+    /* The rate controller starts at its fast period, the default period of
+     * the sensors */
+    pasco2_rate_init(&rate_controller, NULL);
+    CY_ASSERT(rate_controller.period_s == measurement_period);
 
-    result = xensiv_dps3xx_mtb_init_i2c(&xensiv_dps3xx, &cyhal_i2c, XENSIV_DPS3XX_I2C_ADDR_ALT);
-    if (result != CY_RSLT_SUCCESS)
+    /* The work flash holds the history log and the baseline snapshots. The
+     * baselines are restored before the output task takes over the flash. */
+    work_flash_result = cyhal_flash_init(&work_flash);
+    if (PASCO2_BASELINE_ENABLE != 0U)
     {
-        use_dps = false;
+        pasco2_restore_baselines();
     }
 
-    /* Initialize PAS CO2 sensor with default parameter values */
-    result = xensiv_pasco2_mtb_init_i2c(&xensiv_pasco2, &cyhal_i2c);
+    /* Stop LED blinking timer, turn on LED to indicate user that turn-on phase is over and entering ready state */
+    result = cyhal_timer_stop(&led_blink_timer);
     if (result != CY_RSLT_SUCCESS)
     {
-        printf("PAS CO2 device initialization error\n");
-        printf("Exiting pasco2_task task\n");
-        // exit current thread (suspend)
-        cy_rtos_exit_thread();
+        CY_ASSERT(0);
     }
-    /* Configure PAS CO2 Wing board interrupt to enable 12V boost converter in wingboard */
-    xensiv_pasco2_interrupt_config_t int_config =
-    {
-        .b.int_func = XENSIV_PASCO2_INTERRUPT_FUNCTION_NONE,
-        .b.int_typ = (uint32_t)XENSIV_PASCO2_INTERRUPT_TYPE_LOW_ACTIVE
-    };
+    cyhal_gpio_write(PASCO2_BOARD_LED_STATUS, PASCO2_BOARD_LED_STATUS_ON);
+
+    /* Turn on the OK LED to indicate normal operation */
+    cyhal_gpio_write(PASCO2_BOARD_LED_OK, PASCO2_BOARD_LED_OK_ON);
 
-    result = xensiv_pasco2_set_interrupt_config(&xensiv_pasco2, int_config);
+    /* The terminal UI may read and set the alarms from its start */
+    pasco2_init_alarms();
+
+    /* Create PAS CO2 terminal UI task */
+    result = pasco2_rtos_create_thread(&terminal_thread,
+                                       pasco2_terminal_ui_task,
+                                       PASCO2_TERMINAL_UI_TASK_NAME,
+                                       PASCO2_TERMINAL_UI_TASK_PRIORITY,
+                                       (cy_thread_arg_t)NULL);
     if (result != CY_RSLT_SUCCESS)
     {
-        printf("PAS CO2 interrupt configuration error");
         CY_ASSERT(0);
     }
 
-    /* Stop LED blinking timer, turn on LED to indicate user that turn-on phase is over and entering ready state */
-    result = cyhal_timer_stop(&led_blink_timer);
+#if (PASCO2_PROBE_ENABLE != 0U)
+    /* Start the clock of the latency probes */
+    pasco2_probe_init();
+#endif
+
+    /* Create PAS CO2 output task, the consumer of the sample ring */
+    pasco2_sample_ring_init(&sample_ring);
+    result = pasco2_rtos_create_thread(&output_thread,
+                                       pasco2_output_task,
+                                       PASCO2_OUTPUT_TASK_NAME,
+                                       PASCO2_OUTPUT_TASK_PRIORITY,
+                                       (cy_thread_arg_t)NULL);
     if (result != CY_RSLT_SUCCESS)
     {
         CY_ASSERT(0);
     }
-#if defined(CYSBSYSKIT_DEV_01)
-    cyhal_gpio_write(CYBSP_USER_LED, false); /* USER_LED is active low */
-#else
-    cyhal_gpio_write(CYBSP_USER_LED2, false); /* USER_LED is active low */
-#endif
 
-    /* Turn on status LED on PAS CO2 Wing Board to indicate normal operation */
-    cyhal_gpio_write(MTB_PASCO2_LED_OK, MTB_PASCO_LED_STATE_ON);
+    /* The sensors start in continuous mode; deep sleep is only entered in
+     * single-shot mode, where the terminal may lose input */
+    cyhal_syspm_lock_deepsleep();
 
-    /* Create PAS CO2 terminal UI task */
-    cy_thread_t ifx_pasco2_terminal_task;
-    result = cy_rtos_create_thread(&ifx_pasco2_terminal_task,
-                                   pasco2_terminal_ui_task,
-                                   PASCO2_TERMINAL_UI_TASK_NAME,
-                                   NULL,
-                                   PASCO2_TERMINAL_UI_TASK_STACK_SIZE,
-                                   PASCO2_TERMINAL_UI_TASK_PRIORITY,
-                                   (cy_thread_arg_t)NULL);
-    if (result != CY_RSLT_SUCCESS)
+    /* Deadlines of the next pressure and CO2 readouts. Entering continuous
+     * mode starts the first measurement, which takes as long as a single-shot
+     * one. The first FIFO drain waits with the first CO2 readout until the
+     * FIFO holds results. */
+    TickType_t wake_tick = xTaskGetTickCount();
+    power_stats_start = wake_tick;
+    for (uint8_t i = 0U; i < PASCO2_SENSOR_COUNT; i++)
     {
-        CY_ASSERT(0);
+        sensors[i].co2_due = wake_tick + pdMS_TO_TICKS(PASCO2_SINGLE_SHOT_DURATION_MS);
+        sensors[i].pressure_due = sensors[i].co2_due;
+        pasco2_recovery_init(&recovery[i], PASCO2_RECOVERY_MAX_ACTION, (uint32_t)(wake_tick * portTICK_PERIOD_MS),
+                             (uint32_t)measurement_period * 1000U);
     }
 
     for (;;)
     {
-        float32_t pressure;
-        if (use_dps == true)
+        /* Sleep until a data-ready interrupt fires or the next readout is due */
+        TickType_t now = xTaskGetTickCount();
+        power_stats.awake_ms += (uint32_t)((now - wake_tick) * portTICK_PERIOD_MS);
+        (void)ulTaskNotifyTake(pdTRUE, pasco2_next_wait(now));
+        now = xTaskGetTickCount();
+        wake_tick = now;
+        power_stats.wakeups++;
+
+        /* Execute the commands of the other tasks between two passes, so they
+         * never interleave with the readouts */
+        pasco2_command_t *command = pasco2_command_take(&command_queue);
+        if (command != NULL)
         {
-            float32_t temperature;
-            /* Read pressure value from sensor */
-            result = xensiv_dps3xx_read(&xensiv_dps3xx, &pressure, &temperature);
-            if (result != CY_RSLT_SUCCESS)
+            do
             {
-                printf("Error while reading from pressure sensor\r\n");
-                CY_ASSERT(0);
+                pasco2_command_complete(&command_queue, command, pasco2_execute_command(command, now));
+            } while ((command = pasco2_command_take(&command_queue)) != NULL);
+
+            /* A data-ready interrupt may have woken the task together with
+             * the commands, so the pass runs as well */
+            now = xTaskGetTickCount();
+        }
+
+        /* Declare a fault on nodes without new values, and take the due
+         * recovery actions before the readouts */
+        for (uint8_t i = 0U; i < PASCO2_SENSOR_COUNT; i++)
+        {
+            if (!sensor_present[i])
+            {
+                continue;
+            }
+
+            uint32_t now_ms = (uint32_t)(now * portTICK_PERIOD_MS);
+            if (pasco2_recovery_check(&recovery[i], now_ms))
+            {
+                pasco2_log_fault(i, now);
+            }
+
+            pasco2_recovery_action_t action = pasco2_recovery_due(&recovery[i], now_ms);
+            if (action != PASCO2_RECOVERY_ACTION_NONE)
+            {
+                pasco2_recover_node(i, action);
+                now = xTaskGetTickCount();
             }
         }
-        else
+
+        bool single_shot = single_shot_mode;
+        bool rate_sample = false;
+        pasco2_sample_t rate_input;
+
+        /* Drain the pressure sensor FIFOs on their own schedule. A drain
+         * takes milliseconds, so the remaining drains give way to pending
+         * data-ready readouts and follow after the pass; only the first drain
+         * of a node goes ahead, as its readout needs the pressure. */
+        for (uint8_t i = 0U; i < PASCO2_SENSOR_COUNT; i++)
         {
-            pressure = DEFAULT_PRESSURE_VALUE;
+            pasco2_sensor_t *sensor = &sensors[i];
+            if (!sensor_present[i] || !sensor->use_dps || (recovery[i].state == PASCO2_RECOVERY_STATE_FAULT) ||
+                ((int32_t)(now - sensor->pressure_due) < 0))
+            {
+                continue;
+            }
+            if (sensor->pressure.filtered_valid && pasco2_drdy_pending())
+            {
+                break;
+            }
+
+            PASCO2_PROBE_BEGIN(PASCO2_PROBE_DPS_DRAIN);
+            result = pasco2_sensor_drain_pressure(sensor);
+            PASCO2_PROBE_END(PASCO2_PROBE_DPS_DRAIN);
+            if ((result != CY_RSLT_SUCCESS) && (result != PASCO2_DPS_FIFO_RSLT_ERR_EMPTY))
+            {
+                /* The last filtered pressure stays in use until the node has
+                 * recovered */
+                PASCO2_LOG_DEBUG(PASCO2_LOG_PRESSURE_ERROR, i);
+                pasco2_node_error(i, now);
+            }
+            sensor->pressure_due = now + pdMS_TO_TICKS(PASCO2_PRESSURE_SAMPLE_PERIOD_MS);
         }
 
-        /* Read CO2 value from sensor */
-        uint16_t ppm = 0;
-        result = xensiv_pasco2_mtb_read(&xensiv_pasco2, (uint16_t)pressure, &ppm);
+        /* Start the CO2 requests of all due sensors at once. Nodes on
+         * different buses are served in parallel, the engine of a bus runs
+         * the requests of its nodes back-to-back without waking up this task. */
+        PASCO2_PROBE_BEGIN(PASCO2_PROBE_CO2_PASS);
+        bool active[sizeof(sensor_configs) / sizeof(sensor_configs[0])];
+        bool triggered[sizeof(sensor_configs) / sizeof(sensor_configs[0])];
+        bool drdy[sizeof(sensor_configs) / sizeof(sensor_configs[0])];
+        uint8_t submitted = 0U;
 
-        if (result == CY_RSLT_SUCCESS)
+        for (uint8_t i = 0U; i < PASCO2_SENSOR_COUNT; i++)
         {
-            /* New CO2 value is successfully read from sensor and print it to serial console */
-            if (display_ppm)
+            pasco2_sensor_t *sensor = &sensors[i];
+
+            drdy[i] = sensor->drdy;
+            active[i] = sensor_present[i] && (recovery[i].state != PASCO2_RECOVERY_STATE_FAULT) &&
+                        (drdy[i] || ((int32_t)(now - sensor->co2_due) >= 0));
+            if (!active[i])
+            {
+                continue;
+            }
+            sensor->drdy = false;
+
+            /* The pressure reference is written when the filtered pressure
+             * has moved beyond the hysteresis, and regardless of it before a
+             * new measurement starts: with every single-shot trigger, and
+             * with the first readout after the measurements were restarted.
+             * In continuous mode it is written with the readout and applies
+             * from the next measurement on. */
+            uint16_t reference;
+            triggered[i] = single_shot && !sensor->single_shot_pending;
+            bool write_reference = (triggered[i] || !single_shot) &&
+                                   pasco2_pressure_reference_due(&sensor->pressure,
+                                                                 triggered[i] || sensor->reference_pending, &reference);
+            sensor->reference_pending = false;
+            if (triggered[i])
+            {
+                pasco2_sensor_prepare_trigger(sensor, write_reference ? &reference : NULL);
+            }
+            else
+            {
+                pasco2_sensor_prepare_read(sensor, write_reference ? &reference : NULL);
+            }
+
+            sensor->request.callback = pasco2_batch_done;
+            sensor->request.callback_arg = NULL;
+            result = pasco2_i2c_engine_submit(sensor->engine, &sensor->request);
+            if (result == CY_RSLT_SUCCESS)
+            {
+                submitted++;
+            }
+            else
             {
-                cy_time_t tval;
+                sensor->request.result = result;
+            }
+        }
 
-                result = cy_rtos_get_time(&tval);
-                if (result != CY_RSLT_SUCCESS)
+        uint8_t completed = 0U;
+        while ((completed < submitted) &&
+               (cy_rtos_get_semaphore(&batch_done, PASCO2_SENSOR_I2C_TIMEOUT_MS, false) == CY_RSLT_SUCCESS))
+        {
+            completed++;
+        }
+        if (completed < submitted)
+        {
+            /* Withdraw the requests that did not finish in time, then drop
+             * the completions that raced with the withdrawal */
+            for (uint8_t i = 0U; i < PASCO2_SENSOR_COUNT; i++)
+            {
+                if (active[i])
                 {
-                    CY_ASSERT(0);
+                    (void)pasco2_i2c_engine_cancel(sensors[i].engine, &sensors[i].request);
                 }
+            }
+            while (cy_rtos_get_semaphore(&batch_done, 0U, false) == CY_RSLT_SUCCESS)
+            {
+            }
+        }
+        if (submitted > 0U)
+        {
+            PASCO2_PROBE_END(PASCO2_PROBE_CO2_PASS);
+        }
+
+        for (uint8_t i = 0U; i < PASCO2_SENSOR_COUNT; i++)
+        {
+            pasco2_sensor_t *sensor = &sensors[i];
+            if (!active[i])
+            {
+                continue;
+            }
 
-                printf("CO2 PPM Level: %" PRIu16 "\r\n", ppm);
-#if !defined(CYSBSYSKIT_DEV_01)
-                if (ppm<=1000)
+            if (triggered[i])
+            {
+                if (sensor->request.result == CY_RSLT_SUCCESS)
                 {
-                    cyhal_gpio_write(CYBSP_LED_RGB_GREEN, CYBSP_LED_STATE_ON);
-                    cyhal_gpio_write(CYBSP_LED_RGB_RED, CYBSP_LED_STATE_OFF);
+                    /* The result is read once it is ready */
+                    sensor->single_shot_pending = true;
+                    sensor->single_shot_start = now;
+                    sensor->co2_due = now + pdMS_TO_TICKS(PASCO2_SINGLE_SHOT_DURATION_MS);
+                    if (sensor->config->int_pin != NC)
+                    {
+                        sensor->co2_due += pdMS_TO_TICKS(PASCO2_DRDY_TIMEOUT_MS);
+                    }
                 }
                 else
                 {
-                    cyhal_gpio_write(CYBSP_LED_RGB_GREEN, CYBSP_LED_STATE_OFF);
-                    cyhal_gpio_write(CYBSP_LED_RGB_RED, CYBSP_LED_STATE_ON);
+                    pasco2_pressure_reference_lost(&sensor->pressure);
+                    PASCO2_LOG_DEBUG(PASCO2_LOG_CO2_COMM_ERROR, i);
+                    sensor->co2_due = now + pdMS_TO_TICKS(PASCO2_PROCESS_DELAY);
+                    pasco2_node_error(i, now);
                 }
-#endif
+                continue;
             }
-        }
-        else
-        {
-            if (CY_RSLT_GET_CODE(result) == XENSIV_PASCO2_READ_NRDY)
+
+            PASCO2_PROBE_BEGIN(PASCO2_PROBE_CO2_RESULT);
+            pasco2_sample_t sample = { .sensor = i, .flags = 0U };
+            sample.pressure = pasco2_pressure_get(&sensor->pressure);
+            sample.temperature = sensor->temperature;
+            if (sensor->use_dps)
             {
-                /* New value is not available yet */
-                conditional_log("CO2 PPM value is not ready\r\n");
+                sample.flags |= PASCO2_SAMPLE_PRESSURE_VALID;
             }
-            else if (CY_RSLT_GET_CODE(result) == XENSIV_PASCO2_ERR_COMM)
+
+            result = pasco2_sensor_get_result(sensor, &sample);
+            sensor->stats.reads++;
+
+            if (result == CY_RSLT_SUCCESS)
             {
-                /* I2C communication error */
-                conditional_log("I2C communication error\r\n");
+                sensor->stats.samples++;
+                power_stats.samples++;
+                if (drdy[i])
+                {
+                    uint32_t latency_ms = (xTaskGetTickCount() - sensor->drdy_tick) * portTICK_PERIOD_MS;
+                    sensor->stats.last_latency_ms = latency_ms;
+                    if (latency_ms > sensor->stats.max_latency_ms)
+                    {
+                        sensor->stats.max_latency_ms = latency_ms;
+                    }
+                }
+
+                if (single_shot)
+                {
+                    /* Trigger the next measurement one period after this one */
+                    sensor->single_shot_pending = false;
+                    sensor->co2_due = sensor->single_shot_start + pdMS_TO_TICKS((uint32_t)measurement_period * 1000U);
+                }
+                else if (sensor->config->int_pin != NC)
+                {
+                    /* Fall back to polling if the interrupt does not arrive */
+                    sensor->co2_due = now + pdMS_TO_TICKS(((uint32_t)measurement_period * 1000U) + PASCO2_DRDY_TIMEOUT_MS);
+                }
+                else
+                {
+                    /* Next result is expected one measurement period after this one */
+                    sensor->co2_due = now + pdMS_TO_TICKS(((uint32_t)measurement_period * 1000U) - PASCO2_DRDY_MARGIN_MS);
+                }
             }
             else
             {
-                conditional_log("Unexpected error\r\n");
+                /* Retry shortly, the result is due or the read has failed */
+                sensor->co2_due = now + pdMS_TO_TICKS(single_shot ? PASCO2_SINGLE_SHOT_RETRY_MS : PASCO2_PROCESS_DELAY);
+
+                if (result == PASCO2_RSLT_READ_NRDY)
+                {
+                    /* New value is not available yet */
+                    sensor->stats.not_ready++;
+                    PASCO2_LOG_DEBUG(PASCO2_LOG_CO2_NOT_READY, i);
+                }
+                else
+                {
+                    /* I2C communication error, the reference may not have been written */
+                    pasco2_pressure_reference_lost(&sensor->pressure);
+                    PASCO2_LOG_DEBUG(PASCO2_LOG_CO2_COMM_ERROR, i);
+                    pasco2_node_error(i, now);
+                }
+
+                if (single_shot && ((now - sensor->single_shot_start) >= pdMS_TO_TICKS(PASCO2_SINGLE_SHOT_TIMEOUT_MS)))
+                {
+                    /* The measurement got lost, start a new one */
+                    sensor->single_shot_pending = false;
+                }
+            }
+
+            if ((sample.flags & PASCO2_SAMPLE_STATUS_VALID) != 0U)
+            {
+                if (sample.status & XENSIV_PASCO2_REG_SENS_STS_ICCER_MSK)
+                {
+                    /* Sensor detected communication problem with MCU. Unlike
+                     * the supply and temperature flags below it is a fault
+                     * of the node. */
+                    PASCO2_LOG_DEBUG(PASCO2_LOG_SENSOR_ICCER, i);
+                    pasco2_node_error(i, now);
+                }
+
+                if (sample.status & XENSIV_PASCO2_REG_SENS_STS_ORVS_MSK)
+                {
+                    /* Sensor detected over-voltage problem */
+                    PASCO2_LOG_DEBUG(PASCO2_LOG_SENSOR_ORVS, i);
+                }
+
+                if (sample.status & XENSIV_PASCO2_REG_SENS_STS_ORTMP_MSK)
+                {
+                    /* Sensor detected temperature problem */
+                    PASCO2_LOG_DEBUG(PASCO2_LOG_SENSOR_ORTMP, i);
+                }
+            }
+
+            PASCO2_PROBE_END(PASCO2_PROBE_CO2_RESULT);
+
+            sample.tick = (uint32_t)(xTaskGetTickCount() * portTICK_PERIOD_MS);
+            if ((sample.flags & PASCO2_SAMPLE_PPM_VALID) != 0U)
+            {
+                if (boot_stats.first_ppm_ms == 0U)
+                {
+                    boot_stats.first_ppm_ms = sample.tick;
+                    PASCO2_LOG_INFO(PASCO2_LOG_BOOT_FIRST_PPM, i, sample.tick);
+                }
+
+                if (PASCO2_BASELINE_ENABLE != 0U)
+                {
+                    bool learned = baselines[i].stats.valid;
+                    sample.ppm = pasco2_baseline_apply(&baselines[i], sample.tick, sample.ppm);
+                    if (!learned && baselines[i].stats.valid)
+                    {
+                        PASCO2_LOG_INFO(PASCO2_LOG_BASELINE_LEARNED, i, (uint32_t)(int32_t)baselines[i].offset);
+                    }
+                }
+
+                /* A value with a communication error does not count as
+                 * healthy */
+                if (((sample.status & XENSIV_PASCO2_REG_SENS_STS_ICCER_MSK) == 0U) &&
+                    pasco2_recovery_value(&recovery[i], sample.tick, (uint32_t)measurement_period * 1000U))
+                {
+                    PASCO2_LOG_WARN(PASCO2_LOG_RECOVERY_DONE, i, sample.tick - recovery[i].fault_ms);
+                }
+
+                PASCO2_PROBE_BEGIN(PASCO2_PROBE_STATS_ADD);
+                pasco2_stats_add(&co2_stats[i], sample.tick, sample.ppm);
+                PASCO2_PROBE_END(PASCO2_PROBE_STATS_ADD);
+
+                if (i == PASCO2_RATE_SENSOR)
+                {
+                    rate_sample = true;
+                    rate_input = sample;
+                }
             }
+
+            /* Hand the record over to the output task, it never blocks this loop */
+            PASCO2_PROBE_BEGIN(PASCO2_PROBE_RING_PUSH);
+            (void)pasco2_sample_ring_push(&sample_ring, &sample);
+            xTaskNotifyGive((TaskHandle_t)output_thread.handle);
+            PASCO2_PROBE_END(PASCO2_PROBE_RING_PUSH);
+        }
+
+        /* A new period restarts the measurements, so it is applied once all
+         * results of this pass are read */
+        if (rate_sample && adaptive_rate)
+        {
+            pasco2_update_rate(&rate_input, now);
+        }
+
+        if (PASCO2_BASELINE_ENABLE != 0U)
+        {
+            pasco2_snapshot_baselines(now);
         }
+    }
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_output_task
+ *******************************************************************************
+ * Summary:
+ *   Drains the sample ring filled by the sensor task and presents every
+ *   record: prints the CO2 value, evaluates the CO2 alarm, updates the
+ *   warning LED, and appends the value to the history log. Afterwards
+ *   formats the deferred log messages. LEDs are only written when their
+ *   state changes.
+ *
+ * Parameters:
+ *   arg: thread
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+static void pasco2_output_task(cy_thread_arg_t arg)
+{
+    (void)arg;
+    pasco2_sample_t sample;
+    pasco2_log_record_t record;
+    uint16_t sequence = 0U;
+
+    /* The warning LED shows the worst state over all sensor nodes */
+    bool error_status[sizeof(sensor_configs) / sizeof(sensor_configs[0])] = { false };
+    bool warning = false;
+
+    /* Resume the history log where the last run left it */
+    cy_rslt_t result = work_flash_result;
+    if (result == CY_RSLT_SUCCESS)
+    {
+        result = pasco2_history_open(&history, &work_flash, PASCO2_HISTORY_ADDRESS, PASCO2_HISTORY_ROWS);
+    }
+    if (result == CY_RSLT_SUCCESS)
+    {
+        history_ready = true;
+    }
+    else
+    {
+        printf("History log not available, error 0x%08" PRIx32 "\r\n", (uint32_t)result);
+    }
+
+    for (;;)
+    {
+        (void)ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
 
-        uint8_t sensor_status;
-        if (xensiv_pasco2_get_status(&xensiv_pasco2, (xensiv_pasco2_status_t *)&sensor_status) == CY_RSLT_SUCCESS)
+        /* Apply the thresholds set by the terminal UI */
+        if (alarm_config_pending)
         {
-            bool error_status = false;
-            if (sensor_status & XENSIV_PASCO2_REG_SENS_STS_ICCER_MSK)
+            pasco2_alarm_config_t config;
+
+            taskENTER_CRITICAL();
+            config = alarm_config_next;
+            alarm_config_pending = false;
+            taskEXIT_CRITICAL();
+            for (uint8_t i = 0U; i < PASCO2_SENSOR_COUNT; i++)
             {
-                /* Sensor detected communication problem with MCU */
-                conditional_log("CO2 Sensor Communication Error\r\n");
-                error_status = true;
+                pasco2_alarm_set_config(&alarms[i], &config);
+                pasco2_alarm_publish(i);
             }
+        }
 
-            if (sensor_status & XENSIV_PASCO2_REG_SENS_STS_ORVS_MSK)
+        while (pasco2_sample_ring_pop(&sample_ring, &sample))
+        {
+            if (sample.flags & PASCO2_SAMPLE_PPM_VALID)
             {
-                /* Sensor detected over-voltage problem */
-                conditional_log("CO2 Sensor Over-Voltage Error\r\n");
-                error_status = true;
+                /* New CO2 value is successfully read from sensor and print it to serial console */
+                PASCO2_PROBE_BEGIN(PASCO2_PROBE_OUTPUT_WRITE);
+                if (display_ppm && binary_telemetry)
+                {
+                    pasco2_telemetry_sample_t telemetry =
+                    {
+                        .sequence = sequence++,
+                        .sensor = sample.sensor,
+                        .tick = sample.tick,
+                        .ppm = sample.ppm,
+                        .pressure = (uint16_t)((sample.pressure + 5) / 10),
+                        .temperature = sample.temperature,
+                        .status = sample.status,
+                        .flags = sample.flags
+                    };
+                    uint8_t frame[PASCO2_TELEMETRY_ENCODED_SIZE(PASCO2_TELEMETRY_SAMPLE_SIZE)];
+                    size_t length = pasco2_telemetry_encode_sample(&telemetry, frame);
+
+                    /* Bypass stdio, it would expand LF bytes */
+                    (void)pasco2_console_write(frame, length, PASCO2_CONSOLE_POLICY);
+                }
+                else if (display_ppm && (PASCO2_SENSOR_COUNT > 1U))
+                {
+                    printf("CO2 PPM Level [%u]: %" PRIu16 "\r\n", (unsigned int)sample.sensor, sample.ppm);
+                }
+                else if (display_ppm)
+                {
+                    printf("CO2 PPM Level: %" PRIu16 "\r\n", sample.ppm);
+                }
+                PASCO2_PROBE_END(PASCO2_PROBE_OUTPUT_WRITE);
+
+                PASCO2_PROBE_BEGIN(PASCO2_PROBE_OUTPUT_LED);
+                (void)pasco2_alarm_update(&alarms[sample.sensor], sample.tick, sample.ppm);
+                pasco2_alarm_publish(sample.sensor);
+                PASCO2_PROBE_END(PASCO2_PROBE_OUTPUT_LED);
+
+                if (history_ready && (sample.sensor == PASCO2_HISTORY_SENSOR))
+                {
+                    PASCO2_PROBE_BEGIN(PASCO2_PROBE_HISTORY_ADD);
+                    result = pasco2_history_add(&history, sample.tick, sample.ppm);
+                    PASCO2_PROBE_END(PASCO2_PROBE_HISTORY_ADD);
+                    if (result != CY_RSLT_SUCCESS)
+                    {
+                        PASCO2_LOG_ERROR(PASCO2_LOG_HISTORY_WRITE_ERROR, result);
+                    }
+                }
             }
 
-            if (sensor_status & XENSIV_PASCO2_REG_SENS_STS_ORTMP_MSK)
+            if (sample.flags & PASCO2_SAMPLE_STATUS_VALID)
             {
-                /* Sensor detected temperature problem */
-                conditional_log("CO2 Sensor Temperature Error\r\n");
-                error_status = true;
+                PASCO2_PROBE_BEGIN(PASCO2_PROBE_OUTPUT_LED);
+                bool any_error = false;
+
+                error_status[sample.sensor] = (sample.status & (XENSIV_PASCO2_REG_SENS_STS_ICCER_MSK |
+                                                                XENSIV_PASCO2_REG_SENS_STS_ORVS_MSK |
+                                                                XENSIV_PASCO2_REG_SENS_STS_ORTMP_MSK)) != 0U;
+                for (uint8_t i = 0U; i < PASCO2_SENSOR_COUNT; i++)
+                {
+                    any_error = any_error || error_status[i];
+                }
+
+                /* Turn-On warning LED to indicate warning to user from sensor */
+                if (any_error != warning)
+                {
+                    cyhal_gpio_write(PASCO2_BOARD_LED_WARNING, any_error ? PASCO2_BOARD_LED_WARNING_ON : PASCO2_BOARD_LED_WARNING_OFF);
+                    warning = any_error;
+                }
+                PASCO2_PROBE_END(PASCO2_PROBE_OUTPUT_LED);
             }
+        }
 
-            /* Turn-On warning LED to indicate warning to user from sensor */
-            cyhal_gpio_write(MTB_PASCO2_LED_WARNING, error_status ? MTB_PASCO_LED_STATE_ON : MTB_PASCO_LED_STATE_OFF);
+        /* Write the baseline snapshot handed over by the sensor task */
+        if (baseline_snapshot_pending)
+        {
+            __DMB();
+            result = pasco2_baseline_store_write(&baseline_store, baseline_snapshot, PASCO2_BASELINE_NODES);
+            if (result != CY_RSLT_SUCCESS)
+            {
+                PASCO2_LOG_ERROR(PASCO2_LOG_BASELINE_WRITE_ERROR, result);
+            }
+            baseline_snapshot_pending = false;
         }
 
-        result = cy_rtos_delay_milliseconds(PASCO2_PROCESS_DELAY);
-        if (result != CY_RSLT_SUCCESS)
+        /* Format the messages recorded by the sensor task */
+        while (pasco2_log_pop(&record))
         {
-            CY_ASSERT(0);
+            PASCO2_PROBE_BEGIN(PASCO2_PROBE_LOG_FORMAT);
+            if (display_ppm && binary_telemetry)
+            {
+                uint8_t frame[PASCO2_TELEMETRY_ENCODED_SIZE(PASCO2_TELEMETRY_LOG_SIZE)];
+                size_t length = pasco2_telemetry_encode_log(&record, frame);
+
+                (void)pasco2_console_write(frame, length, PASCO2_CONSOLE_POLICY);
+            }
+            else if (display_ppm)
+            {
+                pasco2_log_print(&record);
+            }
+            PASCO2_PROBE_END(PASCO2_PROBE_LOG_FORMAT);
         }
     }
 }
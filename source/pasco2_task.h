@@ -34,6 +34,17 @@
 /* Header file for library */
 #include "xensiv_pasco2_mtb.h"
 
+/* Header file for local module */
+#include "pasco2_alarm.h"
+#include "pasco2_baseline.h"
+#include "pasco2_command.h"
+#include "pasco2_history.h"
+#include "pasco2_rate.h"
+#include "pasco2_recovery.h"
+#include "pasco2_sample_ring.h"
+#include "pasco2_sensor.h"
+#include "pasco2_stats.h"
+
 /*******************************************************************************
  * Macros
  ******************************************************************************/
@@ -44,10 +55,39 @@
 /**< Priority number for the co2 sensor task */
 #define PASCO2_TASK_PRIORITY (CY_RTOS_PRIORITY_BELOWNORMAL)
 
+/* Name of the co2 output task */
+#define PASCO2_OUTPUT_TASK_NAME "CO2 OUTPUT TASK"
+/* Stack size for the co2 output task */
+#define PASCO2_OUTPUT_TASK_STACK_SIZE (1024 * 2)
+/* Priority number for the co2 output task */
+#define PASCO2_OUTPUT_TASK_PRIORITY (CY_RTOS_PRIORITY_BELOWNORMAL)
+
+/*******************************************************************************
+ * Types
+ *******************************************************************************/
+/* Time budget of the sensor task since the last measurement mode change */
+typedef struct
+{
+    uint32_t samples;           /* New CO2 values */
+    uint32_t wakeups;           /* Sensor task wake-ups */
+    uint32_t awake_ms;          /* Time from wake-up until the sensor task sleeps again */
+    uint32_t elapsed_ms;        /* Time since the measurement mode was entered */
+} pasco2_power_stats_t;
+
+/* Boot phases of the sensor task in milliseconds since the scheduler started */
+typedef struct
+{
+    uint32_t power_ms;          /* Sensor supplies switched on, the PAS CO2 powers up */
+    uint32_t dps_ready_ms;      /* DPS3xx sensors initialized */
+    uint32_t co2_ready_ms;      /* Last PAS CO2 reported ready */
+    uint32_t sensors_ready_ms;  /* Sensor nodes configured, the acquisition starts */
+    uint32_t first_ppm_ms;      /* First valid CO2 value, 0 until then */
+    uint32_t ready_polls;       /* PAS CO2 status reads until ready */
+} pasco2_boot_stats_t;
+
 /*******************************************************************************
  * Global Variables
  *******************************************************************************/
-extern xensiv_pasco2_t xensiv_pasco2;
 extern cyhal_timer_t led_blink_timer;
 
 /*******************************************************************************
@@ -57,5 +97,28 @@ extern cyhal_timer_t led_blink_timer;
 void pasco2_task(cy_thread_arg_t arg);
 void pasco2_enable_internal_logging(bool enable_logging);
 void pasco2_display_ppm(bool enable_output);
+void pasco2_enable_binary_telemetry(bool enable_binary);
+cy_rslt_t pasco2_set_measurement_period(uint16_t period);
+cy_rslt_t pasco2_set_single_shot_mode(bool enable_single_shot);
+cy_rslt_t pasco2_set_adaptive_rate(uint16_t period_fast_s, uint16_t period_slow_s);
+bool pasco2_get_adaptive_rate(pasco2_rate_t *rate);
+bool pasco2_get_single_shot_mode(void);
+void pasco2_get_command_stats(pasco2_command_stats_t *stats);
+void pasco2_get_power_stats(pasco2_power_stats_t *stats);
+void pasco2_get_boot_stats(pasco2_boot_stats_t *stats);
+uint8_t pasco2_get_sensor_count(void);
+uint8_t pasco2_get_bus_count(void);
+void pasco2_get_acquisition_stats(uint8_t sensor, pasco2_acquisition_stats_t *stats);
+void pasco2_get_recovery_stats(uint8_t sensor, pasco2_recovery_stats_t *stats);
+bool pasco2_get_baseline_stats(uint8_t sensor, pasco2_baseline_stats_t *stats);
+cy_rslt_t pasco2_set_alarm_config(const pasco2_alarm_config_t *config);
+void pasco2_get_alarm(uint8_t sensor, pasco2_alarm_t *alarm);
+void pasco2_get_sample_ring_stats(pasco2_sample_ring_stats_t *stats);
+void pasco2_get_i2c_engine_stats(uint8_t bus, pasco2_i2c_engine_stats_t *stats);
+void pasco2_get_pressure_stats(uint8_t sensor, pasco2_pressure_stats_t *stats);
+void pasco2_get_dps_fifo_stats(uint8_t sensor, pasco2_dps_fifo_stats_t *stats);
+void pasco2_get_co2_stats(uint8_t sensor, pasco2_stats_window_id_t window, pasco2_stats_summary_t *summary);
+bool pasco2_get_history_stats(pasco2_history_stats_t *stats);
+cy_rslt_t pasco2_read_history_page(uint32_t *sequence, pasco2_history_page_t *page);
 
 /* [] END OF FILE */
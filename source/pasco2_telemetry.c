@@ -0,0 +1,611 @@
+/*****************************************************************************
+** File name: pasco2_telemetry.c
+**
+** Description: This file implements the binary telemetry stream: fixed-layout
+** sample, log and history export frames protected by a CRC-16 and delimited with
+** consistent overhead byte stuffing (COBS), so a receiver can resynchronize on any
+** zero byte.
+**
+** ===========================================================================
+** Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+** ===========================================================================
+**
+** ===========================================================================
+** Infineon Technologies AG (INFINEON) is supplying this file for use
+** exclusively with Infineon's sensor products. This file can be freely
+** distributed within development tools and software supporting such
+** products.
+**
+** THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+** OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+** MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+** INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+** WHATSOEVER.
+** ===========================================================================
+*/
+
+/* Header file from system */
+#include <string.h>
+
+/* Header file for local module */
+#include "pasco2_telemetry.h"
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+#define PASCO2_TELEMETRY_CRC_INIT (0xFFFFU)
+#define PASCO2_TELEMETRY_CRC_POLY (0x1021U)
+
+/* COBS code of a block of 254 non-zero bytes without a zero behind */
+#define PASCO2_TELEMETRY_COBS_FULL (0xFFU)
+
+/*******************************************************************************
+ * Function Name: put_u16
+ *******************************************************************************
+ * Summary:
+ *   Stores a 16-bit value in little endian order.
+ *
+ * Parameters:
+ *   dst: destination
+ *   value: value to store
+ *
+ * Return:
+ *   pointer behind the stored value
+ ******************************************************************************/
+static uint8_t *put_u16(uint8_t *dst, uint16_t value)
+{
+    dst[0] = (uint8_t)value;
+    dst[1] = (uint8_t)(value >> 8);
+    return dst + 2;
+}
+
+/*******************************************************************************
+ * Function Name: get_u16
+ *******************************************************************************
+ * Summary:
+ *   Loads a 16-bit value in little endian order.
+ *
+ * Parameters:
+ *   src: source
+ *
+ * Return:
+ *   loaded value
+ ******************************************************************************/
+static uint16_t get_u16(const uint8_t *src)
+{
+    return (uint16_t)(src[0] | ((uint16_t)src[1] << 8));
+}
+
+/*******************************************************************************
+ * Function Name: put_u32
+ *******************************************************************************
+ * Summary:
+ *   Stores a 32-bit value in little endian order.
+ *
+ * Parameters:
+ *   dst: destination
+ *   value: value to store
+ *
+ * Return:
+ *   pointer behind the stored value
+ ******************************************************************************/
+static uint8_t *put_u32(uint8_t *dst, uint32_t value)
+{
+    dst = put_u16(dst, (uint16_t)value);
+    return put_u16(dst, (uint16_t)(value >> 16));
+}
+
+/*******************************************************************************
+ * Function Name: get_u32
+ *******************************************************************************
+ * Summary:
+ *   Loads a 32-bit value in little endian order.
+ *
+ * Parameters:
+ *   src: source
+ *
+ * Return:
+ *   loaded value
+ ******************************************************************************/
+static uint32_t get_u32(const uint8_t *src)
+{
+    return (uint32_t)get_u16(src) | ((uint32_t)get_u16(&src[2]) << 16);
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_telemetry_crc16
+ *******************************************************************************
+ * Summary:
+ *   Computes the CRC-16/CCITT-FALSE of a buffer.
+ *
+ * Parameters:
+ *   data: buffer
+ *   size: number of bytes
+ *
+ * Return:
+ *   CRC value
+ ******************************************************************************/
+uint16_t pasco2_telemetry_crc16(const uint8_t *data, size_t size)
+{
+    uint16_t crc = PASCO2_TELEMETRY_CRC_INIT;
+
+    while (size-- > 0U)
+    {
+        crc ^= (uint16_t)((uint16_t)*data++ << 8);
+        for (uint8_t bit = 0U; bit < 8U; bit++)
+        {
+            crc = ((crc & 0x8000U) != 0U) ? (uint16_t)((crc << 1) ^ PASCO2_TELEMETRY_CRC_POLY)
+                                          : (uint16_t)(crc << 1);
+        }
+    }
+
+    return crc;
+}
+
+/*******************************************************************************
+ * Function Name: encode_frame
+ *******************************************************************************
+ * Summary:
+ *   Appends the CRC to a serialized frame and COBS-encodes it between two
+ *   zero delimiters. A run of 254 non-zero bytes ends a block without an
+ *   implied zero.
+ *
+ * Parameters:
+ *   raw: serialized frame with room for the CRC at its end
+ *   size: size of raw including the CRC
+ *   frame: destination of PASCO2_TELEMETRY_ENCODED_SIZE(size) bytes
+ *
+ * Return:
+ *   number of bytes written to frame
+ ******************************************************************************/
+static size_t encode_frame(uint8_t *raw, size_t size, uint8_t *frame)
+{
+    (void)put_u16(&raw[size - 2U], pasco2_telemetry_crc16(raw, size - 2U));
+
+    /* COBS: every zero is replaced by the distance to the next zero */
+    frame[0] = 0U;
+    size_t code_index = 1U;
+    size_t out = 2U;
+    uint8_t code = 1U;
+
+    for (size_t i = 0U; i < size; i++)
+    {
+        if (raw[i] == 0U)
+        {
+            frame[code_index] = code;
+            code_index = out++;
+            code = 1U;
+        }
+        else
+        {
+            frame[out++] = raw[i];
+            code++;
+            if (code == PASCO2_TELEMETRY_COBS_FULL)
+            {
+                frame[code_index] = code;
+                code_index = out++;
+                code = 1U;
+            }
+        }
+    }
+    frame[code_index] = code;
+    frame[out++] = 0U;
+
+    return out;
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_telemetry_encode_sample
+ *******************************************************************************
+ * Summary:
+ *   Encodes a sample frame.
+ *
+ * Parameters:
+ *   sample: sample to encode
+ *   frame: destination of PASCO2_TELEMETRY_ENCODED_SIZE(PASCO2_TELEMETRY_SAMPLE_SIZE) bytes
+ *
+ * Return:
+ *   number of bytes written to frame
+ ******************************************************************************/
+size_t pasco2_telemetry_encode_sample(const pasco2_telemetry_sample_t *sample, uint8_t *frame)
+{
+    uint8_t raw[PASCO2_TELEMETRY_SAMPLE_SIZE];
+    uint8_t *p = raw;
+
+    *p++ = PASCO2_TELEMETRY_TYPE_SAMPLE;
+    p = put_u16(p, sample->sequence);
+    *p++ = sample->sensor;
+    p = put_u32(p, sample->tick);
+    p = put_u16(p, sample->ppm);
+    p = put_u16(p, sample->pressure);
+    p = put_u16(p, (uint16_t)sample->temperature);
+    *p++ = sample->status;
+    *p = sample->flags;
+
+    return encode_frame(raw, sizeof(raw), frame);
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_telemetry_encode_log
+ *******************************************************************************
+ * Summary:
+ *   Encodes a log frame. The receiver formats the record from the shared
+ *   message table.
+ *
+ * Parameters:
+ *   record: log record to encode
+ *   frame: destination of PASCO2_TELEMETRY_ENCODED_SIZE(PASCO2_TELEMETRY_LOG_SIZE) bytes
+ *
+ * Return:
+ *   number of bytes written to frame
+ ******************************************************************************/
+size_t pasco2_telemetry_encode_log(const pasco2_log_record_t *record, uint8_t *frame)
+{
+    uint8_t raw[PASCO2_TELEMETRY_LOG_SIZE];
+    uint8_t *p = raw;
+
+    *p++ = PASCO2_TELEMETRY_TYPE_LOG;
+    p = put_u32(p, record->tick);
+    p = put_u16(p, record->id);
+    *p++ = record->level;
+    p = put_u32(p, record->args[0]);
+    (void)put_u32(p, record->args[1]);
+
+    return encode_frame(raw, sizeof(raw), frame);
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_telemetry_encode_history_start
+ *******************************************************************************
+ * Summary:
+ *   Encodes the start frame of a history export.
+ *
+ * Parameters:
+ *   start: contents of the frame
+ *   frame: destination of PASCO2_TELEMETRY_ENCODED_SIZE(PASCO2_TELEMETRY_HISTORY_START_SIZE) bytes
+ *
+ * Return:
+ *   number of bytes written to frame
+ ******************************************************************************/
+size_t pasco2_telemetry_encode_history_start(const pasco2_telemetry_history_start_t *start, uint8_t *frame)
+{
+    uint8_t raw[PASCO2_TELEMETRY_HISTORY_START_SIZE];
+    uint8_t *p = raw;
+
+    *p++ = PASCO2_TELEMETRY_TYPE_HISTORY_START;
+    p = put_u16(p, start->boot);
+    p = put_u32(p, start->uptime_s);
+    p = put_u32(p, start->sequence);
+    p = put_u16(p, start->from_boot);
+    p = put_u32(p, start->from_time_s);
+    p = put_u16(p, start->to_boot);
+    (void)put_u32(p, start->to_time_s);
+
+    return encode_frame(raw, sizeof(raw), frame);
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_telemetry_encode_history_page
+ *******************************************************************************
+ * Summary:
+ *   Encodes a page frame of a history export. Only the payload bytes in use
+ *   are sent.
+ *
+ * Parameters:
+ *   page: contents of the frame
+ *   frame: destination of PASCO2_TELEMETRY_ENCODED_SIZE(PASCO2_TELEMETRY_HISTORY_PAGE_SIZE(bytes))
+ *          bytes, bytes being the payload size
+ *
+ * Return:
+ *   number of bytes written to frame
+ ******************************************************************************/
+size_t pasco2_telemetry_encode_history_page(const pasco2_telemetry_history_page_t *page, uint8_t *frame)
+{
+    uint8_t raw[PASCO2_TELEMETRY_MAX_SIZE];
+    size_t bytes = (page->nibbles + 1U) / 2U;
+    uint8_t *p = raw;
+
+    if (bytes > PASCO2_TELEMETRY_HISTORY_DATA_MAX)
+    {
+        return 0U;
+    }
+
+    *p++ = PASCO2_TELEMETRY_TYPE_HISTORY_PAGE;
+    p = put_u16(p, page->index);
+    p = put_u32(p, page->sequence);
+    p = put_u16(p, page->period_s);
+    p = put_u16(p, page->samples);
+    p = put_u16(p, page->nibbles);
+    memcpy(p, page->payload, bytes);
+
+    return encode_frame(raw, PASCO2_TELEMETRY_HISTORY_PAGE_SIZE(bytes), frame);
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_telemetry_encode_history_end
+ *******************************************************************************
+ * Summary:
+ *   Encodes the end frame of a history export.
+ *
+ * Parameters:
+ *   end: contents of the frame
+ *   frame: destination of PASCO2_TELEMETRY_ENCODED_SIZE(PASCO2_TELEMETRY_HISTORY_END_SIZE) bytes
+ *
+ * Return:
+ *   number of bytes written to frame
+ ******************************************************************************/
+size_t pasco2_telemetry_encode_history_end(const pasco2_telemetry_history_end_t *end, uint8_t *frame)
+{
+    uint8_t raw[PASCO2_TELEMETRY_HISTORY_END_SIZE];
+    uint8_t *p = raw;
+
+    *p++ = PASCO2_TELEMETRY_TYPE_HISTORY_END;
+    p = put_u16(p, end->pages);
+    p = put_u32(p, end->samples);
+    p = put_u32(p, end->last_sequence);
+    p = put_u32(p, end->duration_ms);
+    *p = end->status;
+
+    return encode_frame(raw, sizeof(raw), frame);
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_telemetry_decoder_init
+ *******************************************************************************
+ * Summary:
+ *   Initializes a streaming decoder.
+ *
+ * Parameters:
+ *   decoder: decoder object
+ *   callback: called for every valid sample frame, may be NULL
+ *   log_callback: called for every valid log frame, may be NULL
+ *   callback_arg: argument passed to the callbacks
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+void pasco2_telemetry_decoder_init(pasco2_telemetry_decoder_t *decoder, pasco2_telemetry_callback_t callback,
+                                   pasco2_telemetry_log_callback_t log_callback, void *callback_arg)
+{
+    memset(decoder, 0, sizeof(*decoder));
+    decoder->callback = callback;
+    decoder->log_callback = log_callback;
+    decoder->callback_arg = callback_arg;
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_telemetry_decoder_set_history_callback
+ *******************************************************************************
+ * Summary:
+ *   Reports the history export frames to a callback. Without one, they are
+ *   only counted.
+ *
+ * Parameters:
+ *   decoder: decoder object
+ *   history_callback: called for every valid history export frame, may be NULL
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+void pasco2_telemetry_decoder_set_history_callback(pasco2_telemetry_decoder_t *decoder,
+                                                   pasco2_telemetry_history_callback_t history_callback)
+{
+    decoder->history_callback = history_callback;
+}
+
+/*******************************************************************************
+ * Function Name: decoder_history_frame
+ *******************************************************************************
+ * Summary:
+ *   Parses a history export frame whose layout and CRC were checked.
+ *
+ * Parameters:
+ *   decoder: decoder object
+ *   raw: decoded frame
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+static void decoder_history_frame(pasco2_telemetry_decoder_t *decoder, const uint8_t *raw)
+{
+    pasco2_telemetry_history_frame_t frame = { .type = raw[0] };
+
+    if (frame.type == PASCO2_TELEMETRY_TYPE_HISTORY_START)
+    {
+        frame.start = (pasco2_telemetry_history_start_t)
+        {
+            .boot = get_u16(&raw[1]),
+            .uptime_s = get_u32(&raw[3]),
+            .sequence = get_u32(&raw[7]),
+            .from_boot = get_u16(&raw[11]),
+            .from_time_s = get_u32(&raw[13]),
+            .to_boot = get_u16(&raw[17]),
+            .to_time_s = get_u32(&raw[19])
+        };
+    }
+    else if (frame.type == PASCO2_TELEMETRY_TYPE_HISTORY_PAGE)
+    {
+        frame.page = (pasco2_telemetry_history_page_t)
+        {
+            .index = get_u16(&raw[1]),
+            .sequence = get_u32(&raw[3]),
+            .period_s = get_u16(&raw[7]),
+            .samples = get_u16(&raw[9]),
+            .nibbles = get_u16(&raw[11]),
+            .payload = &raw[13]
+        };
+    }
+    else
+    {
+        frame.end = (pasco2_telemetry_history_end_t)
+        {
+            .pages = get_u16(&raw[1]),
+            .samples = get_u32(&raw[3]),
+            .last_sequence = get_u32(&raw[7]),
+            .duration_ms = get_u32(&raw[11]),
+            .status = raw[15]
+        };
+    }
+
+    decoder->stats.history_frames++;
+    if (decoder->history_callback != NULL)
+    {
+        decoder->history_callback(decoder->callback_arg, &frame);
+    }
+}
+
+/*******************************************************************************
+ * Function Name: decoder_frame
+ *******************************************************************************
+ * Summary:
+ *   Decodes one COBS frame collected between two delimiters , checks
+ *   it, and reports the sample, log record or history export frame.
+ *
+ * Parameters:
+ *   decoder: decoder object
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+static void decoder_frame(pasco2_telemetry_decoder_t *decoder)
+{
+    uint8_t raw[PASCO2_TELEMETRY_MAX_SIZE];
+    size_t in = 0U;
+    size_t out = 0U;
+
+    if (decoder->overflow)
+    {
+        decoder->stats.framing_errors++;
+        return;
+    }
+
+    while (in < decoder->length)
+    {
+        uint8_t code = decoder->buffer[in++];
+        if ((code == 0U) || ((in + code - 1U) > decoder->length) || ((out + code - 1U) > sizeof(raw)))
+        {
+            decoder->stats.framing_errors++;
+            return;
+        }
+        for (uint8_t i = 1U; i < code; i++)
+        {
+            raw[out++] = decoder->buffer[in++];
+        }
+        if ((code != PASCO2_TELEMETRY_COBS_FULL) && (in < decoder->length) && (out < sizeof(raw)))
+        {
+            raw[out++] = 0U;
+        }
+    }
+
+    bool is_sample = (out == PASCO2_TELEMETRY_SAMPLE_SIZE) && (raw[0] == PASCO2_TELEMETRY_TYPE_SAMPLE);
+    bool is_log = (out == PASCO2_TELEMETRY_LOG_SIZE) && (raw[0] == PASCO2_TELEMETRY_TYPE_LOG);
+    bool is_history =
+        ((out == PASCO2_TELEMETRY_HISTORY_START_SIZE) && (raw[0] == PASCO2_TELEMETRY_TYPE_HISTORY_START)) ||
+        ((out == PASCO2_TELEMETRY_HISTORY_END_SIZE) && (raw[0] == PASCO2_TELEMETRY_TYPE_HISTORY_END)) ||
+        ((out >= PASCO2_TELEMETRY_HISTORY_PAGE_SIZE(0U)) && (raw[0] == PASCO2_TELEMETRY_TYPE_HISTORY_PAGE) &&
+         (out == PASCO2_TELEMETRY_HISTORY_PAGE_SIZE((get_u16(&raw[11]) + 1U) / 2U)));
+    if (!is_sample && !is_log && !is_history)
+    {
+        decoder->stats.framing_errors++;
+        return;
+    }
+
+    if (pasco2_telemetry_crc16(raw, out - 2U) != get_u16(&raw[out - 2U]))
+    {
+        decoder->stats.crc_errors++;
+        return;
+    }
+
+    if (is_history)
+    {
+        decoder_history_frame(decoder, raw);
+        return;
+    }
+
+    if (is_log)
+    {
+        pasco2_log_record_t record =
+        {
+            .tick = get_u32(&raw[1]),
+            .id = get_u16(&raw[5]),
+            .level = raw[7],
+            .args = { get_u32(&raw[8]), get_u32(&raw[12]) }
+        };
+
+        decoder->stats.log_frames++;
+        if (decoder->log_callback != NULL)
+        {
+            decoder->log_callback(decoder->callback_arg, &record);
+        }
+        return;
+    }
+
+    pasco2_telemetry_sample_t sample =
+    {
+        .sequence = get_u16(&raw[1]),
+        .sensor = raw[3],
+        .tick = get_u32(&raw[4]),
+        .ppm = get_u16(&raw[8]),
+        .pressure = get_u16(&raw[10]),
+        .temperature = (int16_t)get_u16(&raw[12]),
+        .status = raw[14],
+        .flags = raw[15]
+    };
+
+    if (decoder->sequence_valid && (sample.sequence != decoder->next_sequence))
+    {
+        decoder->stats.sequence_gaps += (uint16_t)(sample.sequence - decoder->next_sequence);
+    }
+    decoder->next_sequence = (uint16_t)(sample.sequence + 1U);
+    decoder->sequence_valid = true;
+    decoder->stats.frames++;
+
+    if (decoder->callback != NULL)
+    {
+        decoder->callback(decoder->callback_arg, &sample);
+    }
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_telemetry_decoder_feed
+ *******************************************************************************
+ * Summary:
+ *   Feeds received bytes into the decoder. Bytes of other traffic on the same
+ *   line are discarded as framing errors at the next delimiter.
+ *
+ * Parameters:
+ *   decoder: decoder object
+ *   data: received bytes
+ *   size: number of bytes
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+void pasco2_telemetry_decoder_feed(pasco2_telemetry_decoder_t *decoder, const uint8_t *data, size_t size)
+{
+    for (size_t i = 0U; i < size; i++)
+    {
+        uint8_t byte = data[i];
+
+        if (byte == 0U)
+        {
+            if ((decoder->length > 0U) || decoder->overflow)
+            {
+                decoder_frame(decoder);
+            }
+            decoder->length = 0U;
+            decoder->overflow = false;
+        }
+        else if (decoder->length < sizeof(decoder->buffer))
+        {
+            decoder->buffer[decoder->length++] = byte;
+        }
+        else
+        {
+            decoder->overflow = true;
+        }
+    }
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,189 @@
+/******************************************************************************
+** File name: pasco2_telemetry.h
+**
+** Description: This file contains the frame layout and function prototypes of
+**   the binary telemetry stream and the history export. The module has no
+**   platform dependencies and is shared with the host-side decoder in
+**   tools/telemetry_decoder and the receiver in tools/history_export.
+**
+** ===========================================================================
+** Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+** ===========================================================================
+**
+** ===========================================================================
+** Infineon Technologies AG (INFINEON) is supplying this file for use
+** exclusively with Infineon's sensor products. This file can be freely
+** distributed within development tools and software supporting such
+** products.
+**
+** THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+** OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+** MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+** INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+** WHATSOEVER.
+** ===========================================================================
+*/
+
+#pragma once
+
+/* Header file from system */
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/* Header file for the log record layout */
+#include "pasco2_log.h"
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+/* Frame types */
+#define PASCO2_TELEMETRY_TYPE_SAMPLE (0x01U)
+#define PASCO2_TELEMETRY_TYPE_LOG    (0x02U)
+#define PASCO2_TELEMETRY_TYPE_HISTORY_START (0x03U)
+#define PASCO2_TELEMETRY_TYPE_HISTORY_PAGE  (0x04U)
+#define PASCO2_TELEMETRY_TYPE_HISTORY_END   (0x05U)
+
+/* Largest payload of a history page frame, the payload of a history page */
+#define PASCO2_TELEMETRY_HISTORY_DATA_MAX (492U)
+
+/* Size of the frames before COBS encoding, including the CRC */
+#define PASCO2_TELEMETRY_SAMPLE_SIZE (18U)
+#define PASCO2_TELEMETRY_LOG_SIZE    (18U)
+#define PASCO2_TELEMETRY_HISTORY_START_SIZE (25U)
+#define PASCO2_TELEMETRY_HISTORY_PAGE_SIZE(bytes) (15U + (bytes))
+#define PASCO2_TELEMETRY_HISTORY_END_SIZE   (18U)
+#define PASCO2_TELEMETRY_MAX_SIZE    (PASCO2_TELEMETRY_HISTORY_PAGE_SIZE(PASCO2_TELEMETRY_HISTORY_DATA_MAX))
+
+/* Status of an export in the history end frame */
+#define PASCO2_TELEMETRY_HISTORY_COMPLETE   (0U)
+#define PASCO2_TELEMETRY_HISTORY_READ_ERROR (1U)
+
+/* Size of an encoded frame: COBS overhead of one byte per started 254 bytes
+ * and a delimiter on both sides added. The leading delimiter flushes any text
+ * output that was interleaved on the same line since the previous frame. */
+#define PASCO2_TELEMETRY_ENCODED_SIZE(size) ((size) + 3U + ((size) / 254U))
+
+/*******************************************************************************
+ * Types
+ ******************************************************************************/
+/* Contents of a sample frame. On the wire the fields are little endian in
+ * this order, followed by a CRC-16/CCITT-FALSE over all preceding bytes:
+ *   type u8, sequence u16, sensor u8, tick u32, ppm u16, pressure u16, temperature i16,
+ *   status u8, flags u8, crc u16 */
+typedef struct
+{
+    uint16_t sequence;          /* Incremented for every frame */
+    uint8_t sensor;             /* Index of the sensor node */
+    uint32_t tick;              /* Device time in ms */
+    uint16_t ppm;               /* CO2 concentration in ppm */
+    uint16_t pressure;          /* Pressure in 0.1 hPa */
+    int16_t temperature;        /* Temperature in 0.01 degree Celsius */
+    uint8_t status;             /* PAS CO2 sensor status register */
+    uint8_t flags;              /* Sample flags of the firmware */
+} pasco2_telemetry_sample_t;
+
+/* Log frames carry a deferred log record, formatted by the receiver:
+ *   type u8, tick u32, id u16, level u8, arg0 u32, arg1 u32, crc u16 */
+
+/* History export frames. An export is a start frame, one page frame per page
+ * of the history log, oldest first, and an end frame:
+ *   start: type u8, boot u16, uptime_s u32, sequence u32, from_boot u16, from_time_s u32,
+ *          to_boot u16, to_time_s u32, crc u16
+ *   page:  type u8, index u16, sequence u32, period_s u16, samples u16, nibbles u16,
+ *          payload of (nibbles + 1) / 2 bytes, crc u16
+ *   end:   type u8, pages u16, samples u32, last_sequence u32, duration_ms u32, status u8, crc u16 */
+typedef struct
+{
+    uint16_t boot;              /* Start-up count of the device */
+    uint32_t uptime_s;          /* Time since the start-up */
+    uint32_t sequence;          /* Smallest page sequence number requested */
+    uint16_t from_boot;         /* Start of the requested time range */
+    uint32_t from_time_s;
+    uint16_t to_boot;           /* End of the requested time range */
+    uint32_t to_time_s;
+} pasco2_telemetry_history_start_t;
+
+typedef struct
+{
+    uint16_t index;             /* Page frames sent before in this export */
+    uint32_t sequence;          /* Sequence number of the page in the log */
+    uint16_t period_s;          /* Interval of the samples in seconds */
+    uint16_t samples;           /* Samples in the payload */
+    uint16_t nibbles;           /* Payload nibbles in use */
+    const uint8_t *payload;     /* Payload, (nibbles + 1) / 2 bytes */
+} pasco2_telemetry_history_page_t;
+
+typedef struct
+{
+    uint16_t pages;             /* Page frames sent */
+    uint32_t samples;           /* Samples in the page frames */
+    uint32_t last_sequence;     /* Last page sent, it may still grow */
+    uint32_t duration_ms;       /* Time from the start frame to the end frame */
+    uint8_t status;             /* PASCO2_TELEMETRY_HISTORY_COMPLETE or _READ_ERROR */
+} pasco2_telemetry_history_end_t;
+
+typedef struct
+{
+    uint8_t type;               /* PASCO2_TELEMETRY_TYPE_HISTORY_START, _PAGE or _END */
+    union
+    {
+        pasco2_telemetry_history_start_t start;
+        pasco2_telemetry_history_page_t page;
+        pasco2_telemetry_history_end_t end;
+    };
+} pasco2_telemetry_history_frame_t;
+
+/* Called by the decoder for every valid sample frame */
+typedef void (*pasco2_telemetry_callback_t)(void *callback_arg, const pasco2_telemetry_sample_t *sample);
+
+/* Called by the decoder for every valid log frame */
+typedef void (*pasco2_telemetry_log_callback_t)(void *callback_arg, const pasco2_log_record_t *record);
+
+/* Called by the decoder for every valid history export frame. The page
+ * payload is only valid during the call. */
+typedef void (*pasco2_telemetry_history_callback_t)(void *callback_arg, const pasco2_telemetry_history_frame_t *frame);
+
+/* Decoder counters */
+typedef struct
+{
+    uint32_t frames;            /* Valid sample frames */
+    uint32_t log_frames;        /* Valid log frames */
+    uint32_t history_frames;    /* Valid history export frames */
+    uint32_t crc_errors;        /* Frames with a CRC mismatch */
+    uint32_t framing_errors;    /* Frames with an invalid encoding, length or type */
+    uint32_t sequence_gaps;     /* Frames lost according to the sequence numbers */
+} pasco2_telemetry_decoder_stats_t;
+
+/* Streaming decoder object */
+typedef struct
+{
+    uint8_t buffer[PASCO2_TELEMETRY_ENCODED_SIZE(PASCO2_TELEMETRY_MAX_SIZE) - 2U];
+    size_t length;
+    bool overflow;
+    bool sequence_valid;
+    uint16_t next_sequence;
+    pasco2_telemetry_callback_t callback;
+    pasco2_telemetry_log_callback_t log_callback;
+    pasco2_telemetry_history_callback_t history_callback;
+    void *callback_arg;
+    pasco2_telemetry_decoder_stats_t stats;
+} pasco2_telemetry_decoder_t;
+
+/*******************************************************************************
+ * Functions
+ ******************************************************************************/
+uint16_t pasco2_telemetry_crc16(const uint8_t *data, size_t size);
+size_t pasco2_telemetry_encode_sample(const pasco2_telemetry_sample_t *sample, uint8_t *frame);
+size_t pasco2_telemetry_encode_log(const pasco2_log_record_t *record, uint8_t *frame);
+size_t pasco2_telemetry_encode_history_start(const pasco2_telemetry_history_start_t *start, uint8_t *frame);
+size_t pasco2_telemetry_encode_history_page(const pasco2_telemetry_history_page_t *page, uint8_t *frame);
+size_t pasco2_telemetry_encode_history_end(const pasco2_telemetry_history_end_t *end, uint8_t *frame);
+void pasco2_telemetry_decoder_init(pasco2_telemetry_decoder_t *decoder, pasco2_telemetry_callback_t callback,
+                                   pasco2_telemetry_log_callback_t log_callback, void *callback_arg);
+void pasco2_telemetry_decoder_set_history_callback(pasco2_telemetry_decoder_t *decoder,
+                                                   pasco2_telemetry_history_callback_t history_callback);
+void pasco2_telemetry_decoder_feed(pasco2_telemetry_decoder_t *decoder, const uint8_t *data, size_t size);
+
+/* [] END OF FILE */
@@ -25,15 +25,23 @@
 
 /* Header file from system */
 #include <ctype.h>
+#include <inttypes.h>
 #include <stdlib.h>
+#include <string.h>
 
 /* Header file includes */
 #include "cy_retarget_io.h"
 #include "cybsp.h"
 #include "cyhal.h"
+#include "stream_buffer.h"
 
 /* Header file for local task */
+#include "pasco2_console.h"
+#include "pasco2_log.h"
+#include "pasco2_probe.h"
+#include "pasco2_rtos.h"
 #include "pasco2_task.h"
+#include "pasco2_telemetry.h"
 #include "pasco2_terminal_ui_task.h"
 
 /*******************************************************************************
@@ -41,112 +49,1234 @@
  ******************************************************************************/
 #define IFX_PASCO2_VALUE_MAXLENGTH 256
 
+/* Priority of the terminal receive interrupt */
+#define TERMINAL_UI_RX_INTR_PRIORITY (7U)
+
+/* Size of the receive stream buffer between the interrupt and the task. Holds
+ * a pasted command line while the task is busy with an export. */
+#define TERMINAL_UI_RX_BUFFER_SIZE (128U)
+
+/* Characters moved per UART FIFO read and per stream buffer receive */
+#define TERMINAL_UI_RX_CHUNK (16U)
+
+/* Control characters of the line editor */
+#define TERMINAL_UI_KEY_CTRL_C (0x03U)
+#define TERMINAL_UI_KEY_BACKSPACE (0x08U)
+#define TERMINAL_UI_KEY_ESCAPE (0x1BU)
+#define TERMINAL_UI_KEY_DELETE (0x7FU)
+
+/*******************************************************************************
+ * Types
+ ******************************************************************************/
+/* State of a line being entered after the line editor processed a character */
+typedef enum
+{
+    TERMINAL_UI_LINE_EDITING,
+    TERMINAL_UI_LINE_DONE,
+    TERMINAL_UI_LINE_CANCELLED
+} terminal_ui_line_status_t;
+
+/* Line being entered */
+typedef struct
+{
+    char text[IFX_PASCO2_VALUE_MAXLENGTH];
+    size_t length;
+} terminal_ui_line_t;
+
+/* Terminal command. The start function runs when the key is pressed and
+ * returns true if the command reads a line, which is then passed to the
+ * finish function. */
+typedef struct
+{
+    char key;
+    const char *help;
+    bool (*start)(void);
+    void (*finish)(const char *line);
+} terminal_ui_command_t;
+
+/* State of the terminal */
+typedef struct
+{
+    const terminal_ui_command_t *active; /* Command reading a line, NULL if none */
+    terminal_ui_line_t line;
+} terminal_ui_session_t;
+
+/*******************************************************************************
+ * Global Variables
+ ******************************************************************************/
+/* Received characters dropped because the task fell behind */
+static volatile uint32_t terminal_ui_rx_dropped;
+
+/*******************************************************************************
+ * Function Name: terminal_ui_info
+ *******************************************************************************
+ * Summary:
+ *   This function prints character using which a user can see all available
+ *   parameters configurable for CO2 sensor.
+ *
+ * Parameters:
+ *   none
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+static void terminal_ui_info(void)
+{
+    printf("Press '?' to list all CO2 sensor settings\r\n");
+}
+
+/*******************************************************************************
+ * Function Name: terminal_ui_print_latency
+ *******************************************************************************
+ * Summary:
+ *   Prints the summary of every latency probe in microseconds.
+ *
+ * Parameters:
+ *   none
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+static void terminal_ui_print_latency(void)
+{
+#if (PASCO2_PROBE_ENABLE != 0U)
+    printf("%-14s %10s %12s %12s %12s %12s\r\n", "Stage [us]", "count", "min", "p50", "p99", "max");
+    for (uint32_t id = 0U; id < PASCO2_PROBE_COUNT; id++)
+    {
+        pasco2_probe_summary_t summary;
+        pasco2_probe_get_summary((pasco2_probe_id_t)id, &summary);
+
+        const uint32_t values[] = { summary.min, summary.p50, summary.p99, summary.max };
+        printf("%-14s %10" PRIu32, pasco2_probe_name((pasco2_probe_id_t)id), summary.count);
+        for (uint32_t i = 0U; i < (sizeof(values) / sizeof(values[0])); i++)
+        {
+            uint32_t ns = pasco2_probe_ticks_to_ns(values[i]);
+            printf(" %8" PRIu32 ".%03" PRIu32, ns / 1000U, ns % 1000U);
+        }
+        printf("\r\n");
+    }
+#else
+    printf("Latency probes are not compiled in, build with PASCO2_PROBE_ENABLE=1\r\n");
+#endif
+}
+
+/*******************************************************************************
+ * Function Name: terminal_ui_line_feed
+ *******************************************************************************
+ * Summary:
+ *   Line editor: processes one received character of a line being entered.
+ *   Characters are echoed, backspace and delete remove the last one, escape
+ *   and Ctrl-C abandon the line and carriage return or line feed end it.
+ *   Whitespace is echoed but not stored.
+ *
+ * Parameters:
+ *   line: line being edited
+ *   rx_value: received character
+ *
+ * Return:
+ *   terminal_ui_line_status_t: state of the line after the character
+ ******************************************************************************/
+static terminal_ui_line_status_t terminal_ui_line_feed(terminal_ui_line_t *line, uint8_t rx_value)
+{
+    switch (rx_value)
+    {
+        case '\r':
+        case '\n':
+            line->text[line->length] = '\0';
+            printf("\r\n");
+            return TERMINAL_UI_LINE_DONE;
+
+        case TERMINAL_UI_KEY_ESCAPE:
+        case TERMINAL_UI_KEY_CTRL_C:
+            printf("\r\nCancelled\r\n\r\n");
+            return TERMINAL_UI_LINE_CANCELLED;
+
+        case TERMINAL_UI_KEY_BACKSPACE:
+        case TERMINAL_UI_KEY_DELETE:
+            if (line->length > 0U)
+            {
+                line->length--;
+                printf("\b \b");
+            }
+            return TERMINAL_UI_LINE_EDITING;
+
+        default:
+            break;
+    }
+
+    if (isspace(rx_value))
+    {
+        printf("%c", (char)rx_value);
+    }
+    else if (isprint(rx_value) && (line->length < (sizeof(line->text) - 1U)))
+    {
+        line->text[line->length++] = (char)rx_value;
+        printf("%c", (char)rx_value);
+    }
+
+    return TERMINAL_UI_LINE_EDITING;
+}
+
+/*******************************************************************************
+ * Function Name: terminal_ui_parse_yes_no
+ *******************************************************************************
+ * Summary:
+ *   Parses the answer to a yes/no question and reports an invalid one.
+ *
+ * Parameters:
+ *   line: answer entered by the user
+ *   yes: destination of the answer
+ *
+ * Return:
+ *   true if the answer is valid
+ ******************************************************************************/
+static bool terminal_ui_parse_yes_no(const char *line, bool *yes)
+{
+    if ((strlen(line) != 1U) || ((line[0] != 'y') && (line[0] != 'n')))
+    {
+        printf("Input error, valid values are [y/n]\r\n\r\n");
+        return false;
+    }
+    *yes = (line[0] == 'y');
+
+    return true;
+}
+
+/*******************************************************************************
+ * Function Name: terminal_ui_write
+ *******************************************************************************
+ * Summary:
+ *   Sends binary data on the terminal UART, bypassing stdio. Waits while the
+ *   console is full, so that no page of an export is lost.
+ *
+ * Parameters:
+ *   data: data to send
+ *   size: number of bytes
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+static void terminal_ui_write(const uint8_t *data, size_t size)
+{
+    (void)pasco2_console_write(data, size, PASCO2_CONSOLE_BLOCK);
+}
+
+/*******************************************************************************
+ * Function Name: terminal_ui_parse_time
+ *******************************************************************************
+ * Summary:
+ *   Parses a history time given as start-up count and optional seconds since
+ *   that start-up, "boot[:seconds]".
+ *
+ * Parameters:
+ *   text: position in the input, advanced behind the time
+ *   default_s: seconds if only the start-up count is given
+ *   time: destination of the time
+ *
+ * Return:
+ *   true if a time was found
+ ******************************************************************************/
+static bool terminal_ui_parse_time(const char **text, uint32_t default_s, pasco2_history_record_t *time)
+{
+    char *end;
+    unsigned long boot = strtoul(*text, &end, 10);
+
+    if ((end == *text) || (boot > UINT16_MAX))
+    {
+        return false;
+    }
+    time->boot = (uint16_t)boot;
+    time->time_s = default_s;
+    *text = end;
+
+    if (**text == ':')
+    {
+        const char *seconds = *text + 1;
+        time->time_s = (uint32_t)strtoul(seconds, &end, 10);
+        if (end == seconds)
+        {
+            return false;
+        }
+        *text = end;
+    }
+
+    return true;
+}
+
+/*******************************************************************************
+ * Function Name: terminal_ui_export_history
+ *******************************************************************************
+ * Summary:
+ *   Sends the pages of the history log that overlap a time range as history
+ *   export frames, between a start and an end frame. The request is
+ *   "[from][-to][@page]": the times are "boot[:seconds]", and the export
+ *   starts at the given page sequence number to resume an interrupted
+ *   transfer. Whole pages are sent, the receiver trims them to the range.
+ *
+ * Parameters:
+ *   request: export request entered by the user
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+static void terminal_ui_export_history(const char *request)
+{
+    /* Too large for the stack of the terminal UI task */
+    static pasco2_history_page_t page;
+    static uint8_t frame[PASCO2_TELEMETRY_ENCODED_SIZE(PASCO2_TELEMETRY_MAX_SIZE)];
+
+    pasco2_history_record_t from = { .boot = 0U, .time_s = 0U };
+    pasco2_history_record_t to = { .boot = UINT16_MAX, .time_s = UINT32_MAX };
+    uint32_t sequence = 0U;
+    const char *text = request;
+    bool valid = true;
+
+    if ((*text != '\0') && (*text != '-') && (*text != '@'))
+    {
+        valid = terminal_ui_parse_time(&text, 0U, &from);
+    }
+    if (valid && (*text == '-'))
+    {
+        text++;
+        if ((*text != '\0') && (*text != '@'))
+        {
+            valid = terminal_ui_parse_time(&text, UINT32_MAX, &to);
+        }
+    }
+    if (valid && (*text == '@'))
+    {
+        char *end;
+        sequence = (uint32_t)strtoul(text + 1, &end, 10);
+        valid = (end != (text + 1));
+        text = end;
+    }
+    if (!valid || (*text != '\0'))
+    {
+        printf("Input error, valid format is [boot[:s]][-boot[:s]][@page]\r\n\r\n");
+        return;
+    }
+
+    pasco2_history_stats_t stats;
+    if (!pasco2_get_history_stats(&stats))
+    {
+        printf("History log not available\r\n\r\n");
+        return;
+    }
+
+    uint32_t start_ms = (uint32_t)(xTaskGetTickCount() * portTICK_PERIOD_MS);
+    pasco2_telemetry_history_start_t start =
+    {
+        .boot = stats.boot,
+        .uptime_s = start_ms / 1000U,
+        .sequence = sequence,
+        .from_boot = from.boot,
+        .from_time_s = from.time_s,
+        .to_boot = to.boot,
+        .to_time_s = to.time_s
+    };
+    terminal_ui_write(frame, pasco2_telemetry_encode_history_start(&start, frame));
+
+    pasco2_telemetry_history_end_t end = { .status = PASCO2_TELEMETRY_HISTORY_COMPLETE };
+    for (;;)
+    {
+        cy_rslt_t result = pasco2_read_history_page(&sequence, &page);
+        if (result == PASCO2_HISTORY_RSLT_ERR_END)
+        {
+            break;
+        }
+        if (result == PASCO2_HISTORY_RSLT_ERR_PAGE)
+        {
+            /* The receiver sees the gap in the sequence numbers */
+            sequence++;
+            continue;
+        }
+        if (result != CY_RSLT_SUCCESS)
+        {
+            end.status = PASCO2_TELEMETRY_HISTORY_READ_ERROR;
+            break;
+        }
+
+        pasco2_history_record_t first;
+        pasco2_history_record_t last;
+        if (pasco2_history_page_span(&page, &first, &last))
+        {
+            if (pasco2_history_record_compare(&first, &to) > 0)
+            {
+                break;
+            }
+            if (pasco2_history_record_compare(&last, &from) >= 0)
+            {
+                pasco2_telemetry_history_page_t chunk =
+                {
+                    .index = end.pages,
+                    .sequence = sequence,
+                    .period_s = page.header.period_s,
+                    .samples = page.header.samples,
+                    .nibbles = page.header.nibbles,
+                    .payload = page.payload
+                };
+                terminal_ui_write(frame, pasco2_telemetry_encode_history_page(&chunk, frame));
+                end.pages++;
+                end.samples += page.header.samples;
+                end.last_sequence = sequence;
+            }
+        }
+        sequence++;
+    }
+
+    /* The duration covers the pages on the wire, not only in the TX FIFO */
+    pasco2_console_flush();
+    end.duration_ms = (uint32_t)(xTaskGetTickCount() * portTICK_PERIOD_MS) - start_ms;
+    terminal_ui_write(frame, pasco2_telemetry_encode_history_end(&end, frame));
+
+    printf("\r\nHistory export: %u pages, %" PRIu32 " samples in %" PRIu32 " ms%s\r\n\r\n",
+           (unsigned int)end.pages, end.samples, end.duration_ms,
+           (end.status == PASCO2_TELEMETRY_HISTORY_COMPLETE) ? "" : ", read error");
+}
+
+/*******************************************************************************
+ * Function Name: terminal_ui_rx_isr
+ *******************************************************************************
+ * Summary:
+ *   Handler of the terminal receive interrupt. Moves the received characters
+ *   from the UART FIFO into the receive stream buffer, which wakes up the
+ *   terminal UI task. Characters that do not fit are counted and dropped.
+ *
+ * Parameters:
+ *   callback_arg: receive stream buffer
+ *   event: UART event that triggered the interrupt
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+static void terminal_ui_rx_isr(void *callback_arg, cyhal_uart_event_t event)
+{
+    (void)event;
+    BaseType_t higher_priority_task_woken = pdFALSE;
+    uint8_t rx[TERMINAL_UI_RX_CHUNK];
+    size_t length;
+
+    do
+    {
+        length = sizeof(rx);
+        if (cyhal_uart_read(&cy_retarget_io_uart_obj, rx, &length) != CY_RSLT_SUCCESS)
+        {
+            length = 0U;
+        }
+        if (length > 0U)
+        {
+            size_t sent = xStreamBufferSendFromISR((StreamBufferHandle_t)callback_arg, rx, length,
+                                                  &higher_priority_task_woken);
+            terminal_ui_rx_dropped += (uint32_t)(length - sent);
+        }
+    } while (length == sizeof(rx));
+
+    portYIELD_FROM_ISR(higher_priority_task_woken);
+}
+
+/*******************************************************************************
+ * Function Name: terminal_ui_ask_period
+ *******************************************************************************
+ * Summary:
+ *   Command 'p': asks for the measurement period.
+ *
+ * Parameters:
+ *   none
+ *
+ * Return:
+ *   true, the command reads a line
+ ******************************************************************************/
+static bool terminal_ui_ask_period(void)
+{
+    printf("Enter the measurement period [5-4095]s\r\n");
+    return true;
+}
+
+/*******************************************************************************
+ * Function Name: terminal_ui_set_period
+ *******************************************************************************
+ * Summary:
+ *   Command 'p': sets the measurement period entered.
+ *
+ * Parameters:
+ *   line: period entered by the user
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+static void terminal_ui_set_period(const char *line)
+{
+    char *end;
+    const uint16_t measurement_period = (uint16_t)strtol(line, &end, 10);
+    if (line != end)
+    {
+        if ((measurement_period < XENSIV_PASCO2_MEAS_RATE_MIN) || (measurement_period > XENSIV_PASCO2_MEAS_RATE_MAX))
+        {
+            printf("CO2 sensor measurement period configuration error, Valid range is [5-4095]s\r\n\r\n");
+        }
+        else
+        {
+            /* The sensor task programs the period into all sensors */
+            cy_rslt_t result = pasco2_set_measurement_period(measurement_period);
+            if (result == CY_RSLT_SUCCESS)
+            {
+                printf("CO2 measurement period set to: %d\r\n\r\n", measurement_period);
+            }
+            else
+            {
+                printf("CO2 measurement period configuration error 0x%08" PRIX32 "\r\n\r\n", (uint32_t)result);
+            }
+        }
+    }
+}
+
+/*******************************************************************************
+ * Function Name: terminal_ui_ask_logging
+ *******************************************************************************
+ * Summary:
+ *   Command 'i': asks whether to print diagnostic information.
+ *
+ * Parameters:
+ *   none
+ *
+ * Return:
+ *   true, the command reads a line
+ ******************************************************************************/
+static bool terminal_ui_ask_logging(void)
+{
+    printf("Display additional diagnostic information [y/n]?\r\n");
+    return true;
+}
+
+/*******************************************************************************
+ * Function Name: terminal_ui_set_logging
+ *******************************************************************************
+ * Summary:
+ *   Command 'i': enables or disables the diagnostic information.
+ *
+ * Parameters:
+ *   line: answer entered by the user
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+static void terminal_ui_set_logging(const char *line)
+{
+    bool yes;
+    if (terminal_ui_parse_yes_no(line, &yes))
+    {
+        pasco2_enable_internal_logging(yes);
+    }
+}
+
+/*******************************************************************************
+ * Function Name: terminal_ui_ask_binary
+ *******************************************************************************
+ * Summary:
+ *   Command 'b': asks whether to stream binary telemetry frames.
+ *
+ * Parameters:
+ *   none
+ *
+ * Return:
+ *   true, the command reads a line
+ ******************************************************************************/
+static bool terminal_ui_ask_binary(void)
+{
+    printf("Stream binary telemetry frames [y/n]?\r\n");
+    return true;
+}
+
+/*******************************************************************************
+ * Function Name: terminal_ui_set_binary
+ *******************************************************************************
+ * Summary:
+ *   Command 'b': switches between text output and binary telemetry frames.
+ *
+ * Parameters:
+ *   line: answer entered by the user
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+static void terminal_ui_set_binary(const char *line)
+{
+    bool yes;
+    if (terminal_ui_parse_yes_no(line, &yes))
+    {
+        pasco2_enable_binary_telemetry(yes);
+    }
+}
+
+/*******************************************************************************
+ * Function Name: terminal_ui_ask_single_shot
+ *******************************************************************************
+ * Summary:
+ *   Command 'm': asks whether to use single-shot measurements.
+ *
+ * Parameters:
+ *   none
+ *
+ * Return:
+ *   true, the command reads a line
+ ******************************************************************************/
+static bool terminal_ui_ask_single_shot(void)
+{
+    printf("Use single-shot measurements with deep sleep [y/n]?\r\n");
+    return true;
+}
+
+/*******************************************************************************
+ * Function Name: terminal_ui_set_single_shot
+ *******************************************************************************
+ * Summary:
+ *   Command 'm': switches between continuous and single-shot measurements.
+ *
+ * Parameters:
+ *   line: answer entered by the user
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+static void terminal_ui_set_single_shot(const char *line)
+{
+    bool yes;
+    if (terminal_ui_parse_yes_no(line, &yes))
+    {
+        cy_rslt_t result = pasco2_set_single_shot_mode(yes);
+        if (result != CY_RSLT_SUCCESS)
+        {
+            printf("CO2 measurement mode configuration error 0x%08" PRIX32 "\r\n\r\n", (uint32_t)result);
+        }
+    }
+}
+
+/*******************************************************************************
+ * Function Name: terminal_ui_ask_adaptive
+ *******************************************************************************
+ * Summary:
+ *   Command 'a': prints the state of the adaptive measurement rate and asks
+ *   for its period range.
+ *
+ * Parameters:
+ *   none
+ *
+ * Return:
+ *   true, the command reads a line
+ ******************************************************************************/
+static bool terminal_ui_ask_adaptive(void)
+{
+    pasco2_rate_t rate;
+    if (pasco2_get_adaptive_rate(&rate))
+    {
+        printf("Adaptive rate: period %u s in [%u-%u] s, CO2 trend %" PRId32 " ppm/min, speedups %" PRIu32 ", slowdowns %" PRIu32 "\r\n",
+               (unsigned int)rate.period_s, (unsigned int)rate.config.period_fast_s,
+               (unsigned int)rate.config.period_slow_s, rate.slope_ppm_min, rate.stats.speedups,
+               rate.stats.slowdowns);
+    }
+    else
+    {
+        printf("Adaptive rate: off\r\n");
+    }
+    printf("Enter the period range fast-slow [5-4095]s, empty for %u-%u, 'n' to turn it off\r\n",
+           (unsigned int)PASCO2_RATE_PERIOD_FAST_S, (unsigned int)PASCO2_RATE_PERIOD_SLOW_S);
+    return true;
+}
 
 /*******************************************************************************
- * Global Variables
+ * Function Name: terminal_ui_set_adaptive
+ *******************************************************************************
+ * Summary:
+ *   Command 'a': hands the measurement period over to the rate controller of
+ *   the sensor task, or turns the controller off.
+ *
+ * Parameters:
+ *   line: period range entered by the user
+ *
+ * Return:
+ *   none
  ******************************************************************************/
+static void terminal_ui_set_adaptive(const char *line)
+{
+    long fast = PASCO2_RATE_PERIOD_FAST_S;
+    long slow = PASCO2_RATE_PERIOD_SLOW_S;
+    cy_rslt_t result;
+
+    if ((line[0] == 'n') || (line[0] == 'N'))
+    {
+        result = pasco2_set_adaptive_rate(0U, 0U);
+    }
+    else
+    {
+        if (line[0] != '\0')
+        {
+            char *end;
+            fast = strtol(line, &end, 10);
+            if ((end == line) || (*end != '-'))
+            {
+                return;
+            }
+            line = end + 1;
+            slow = strtol(line, &end, 10);
+            if (end == line)
+            {
+                return;
+            }
+        }
+        if ((fast < XENSIV_PASCO2_MEAS_RATE_MIN) || (slow > XENSIV_PASCO2_MEAS_RATE_MAX) || (fast > slow))
+        {
+            printf("CO2 sensor measurement period configuration error, Valid range is [5-4095]s\r\n\r\n");
+            return;
+        }
+        result = pasco2_set_adaptive_rate((uint16_t)fast, (uint16_t)slow);
+    }
+
+    if (result != CY_RSLT_SUCCESS)
+    {
+        printf("CO2 measurement period configuration error 0x%08" PRIX32 "\r\n\r\n", (uint32_t)result);
+    }
+}
 
 /*******************************************************************************
- * Function Name: terminal_ui_menu
+ * Function Name: terminal_ui_ask_alarm
  *******************************************************************************
  * Summary:
- *   This function prints the available parameters configurable for CO2 sensor.
+ *   Command 'c': prints the CO2 alarm thresholds and the level of every
+ *   sensor node, and asks for new thresholds.
  *
  * Parameters:
  *   none
  *
  * Return:
+ *   true, the command reads a line
+ ******************************************************************************/
+static bool terminal_ui_ask_alarm(void)
+{
+    pasco2_alarm_t alarm;
+
+    pasco2_get_alarm(0U, &alarm);
+    if (alarm.config.count == 0U)
+    {
+        printf("CO2 alarm: off\r\n");
+    }
+    else
+    {
+        printf("CO2 alarm: thresholds");
+        for (uint8_t i = 0U; i < alarm.config.count; i++)
+        {
+            printf("%c%u", (i == 0U) ? ' ' : ',', (unsigned int)alarm.config.thresholds[i]);
+        }
+        printf(" ppm, hysteresis %u ppm, dwell %u s\r\n", (unsigned int)alarm.config.hysteresis_ppm,
+               (unsigned int)alarm.config.dwell_s);
+    }
+
+    for (uint8_t i = 0U; i < pasco2_get_sensor_count(); i++)
+    {
+        pasco2_get_alarm(i, &alarm);
+        if (alarm.level == PASCO2_ALARM_LEVEL_UNKNOWN)
+        {
+            printf("Sensor %u: level unknown", (unsigned int)i);
+        }
+        else
+        {
+            printf("Sensor %u: level %u since %" PRIu32 " ms", (unsigned int)i, (unsigned int)alarm.level,
+                   alarm.stats.level_tick);
+        }
+        printf(", %" PRIu32 " values, %" PRIu32 " raises, %" PRIu32 " clears, %" PRIu32 " suppressed\r\n",
+               alarm.stats.values, alarm.stats.raises, alarm.stats.clears, alarm.stats.suppressed);
+    }
+
+    printf("Enter up to %u ascending thresholds in ppm and optionally the hysteresis and dwell time,\r\n"
+           "for example 800,1000,1400/50/30; empty for %u/%u/%u, 'n' to turn the alarm off\r\n",
+           (unsigned int)PASCO2_ALARM_MAX_LEVELS, (unsigned int)PASCO2_ALARM_THRESHOLD_PPM,
+           (unsigned int)PASCO2_ALARM_HYSTERESIS_PPM, (unsigned int)PASCO2_ALARM_DWELL_S);
+    return true;
+}
+
+/*******************************************************************************
+ * Function Name: terminal_ui_set_alarm
+ *******************************************************************************
+ * Summary:
+ *   Command 'c': sets the CO2 alarm thresholds, hysteresis, and dwell time of
+ *   all sensor nodes, or turns the alarm off.
+ *
+ * Parameters:
+ *   line: thresholds entered by the user
+ *
+ * Return:
  *   none
  ******************************************************************************/
-static void terminal_ui_menu(void)
+static void terminal_ui_set_alarm(const char *line)
 {
-    // Print main menu
-    printf("Select a setting to configure\r\n");
-    printf("'p': Set the measurement period\r\n");
-    printf("'i': Print additional diagnostic information if available\r\n");
+    pasco2_alarm_config_t config;
+    char *end;
+
+    pasco2_alarm_default_config(&config);
+    if ((line[0] == 'n') || (line[0] == 'N'))
+    {
+        config.count = 0U;
+    }
+    else if (line[0] != '\0')
+    {
+        long value;
+
+        config.count = 0U;
+        do
+        {
+            value = strtol(line, &end, 10);
+            if ((end == line) || (value <= 0) || (value > UINT16_MAX) || (config.count >= PASCO2_ALARM_MAX_LEVELS))
+            {
+                printf("CO2 alarm configuration error\r\n\r\n");
+                return;
+            }
+            config.thresholds[config.count++] = (uint16_t)value;
+            line = end + 1;
+        } while (*end == ',');
+
+        for (uint8_t field = 0U; (field < 2U) && (*end == '/'); field++)
+        {
+            value = strtol(line, &end, 10);
+            if ((end == line) || (value < 0) || (value > UINT16_MAX))
+            {
+                printf("CO2 alarm configuration error\r\n\r\n");
+                return;
+            }
+            if (field == 0U)
+            {
+                config.hysteresis_ppm = (uint16_t)value;
+            }
+            else
+            {
+                config.dwell_s = (uint16_t)value;
+            }
+            line = end + 1;
+        }
+        if (*end != '\0')
+        {
+            printf("CO2 alarm configuration error\r\n\r\n");
+            return;
+        }
+    }
+
+    cy_rslt_t result = pasco2_set_alarm_config(&config);
+    if (result != CY_RSLT_SUCCESS)
+    {
+        printf("CO2 alarm configuration error 0x%08" PRIX32 ", the thresholds must ascend by more than the hysteresis\r\n\r\n",
+               (uint32_t)result);
+    }
+}
+
+/*******************************************************************************
+ * Function Name: terminal_ui_print_stats
+ *******************************************************************************
+ * Summary:
+ *   Command 's': prints the acquisition statistics.
+ *
+ * Parameters:
+ *   none
+ *
+ * Return:
+ *   false, the command reads no line
+ ******************************************************************************/
+static bool terminal_ui_print_stats(void)
+{
+    for (uint8_t sensor = 0U; sensor < pasco2_get_sensor_count(); sensor++)
+    {
+        pasco2_acquisition_stats_t stats;
+        pasco2_get_acquisition_stats(sensor, &stats);
+        printf("Sensor %u CO2 readouts: %" PRIu32 ", new values: %" PRIu32 ", not ready: %" PRIu32 "\r\n",
+               (unsigned int)sensor, stats.reads, stats.samples, stats.not_ready);
+        printf("Sensor %u data-ready latency: last %" PRIu32 " ms, max %" PRIu32 " ms\r\n",
+               (unsigned int)sensor, stats.last_latency_ms, stats.max_latency_ms);
+
+        pasco2_recovery_stats_t recovery_stats;
+        pasco2_get_recovery_stats(sensor, &recovery_stats);
+        printf("Sensor %u recovery: faults %" PRIu32 ", recovered %" PRIu32 ", bus clears %" PRIu32 ", resets %" PRIu32
+               ", power cycles %" PRIu32 ", failed %" PRIu32 ", dropped samples %" PRIu32 "\r\n",
+               (unsigned int)sensor, recovery_stats.faults, recovery_stats.recoveries,
+               recovery_stats.actions[PASCO2_RECOVERY_ACTION_BUS_CLEAR],
+               recovery_stats.actions[PASCO2_RECOVERY_ACTION_SENSOR_RESET],
+               recovery_stats.actions[PASCO2_RECOVERY_ACTION_POWER_CYCLE], recovery_stats.failed_actions,
+               recovery_stats.dropped_samples);
+        if (recovery_stats.recoveries > 0U)
+        {
+            printf("Sensor %u time to recover: mean %" PRIu32 " ms, max %" PRIu32 " ms\r\n", (unsigned int)sensor,
+                   recovery_stats.recovery_ms_total / recovery_stats.recoveries, recovery_stats.recovery_ms_max);
+        }
+
+        pasco2_baseline_stats_t baseline_stats;
+        if (pasco2_get_baseline_stats(sensor, &baseline_stats))
+        {
+            printf("Sensor %u baseline: %s, offset %d ppm%s from %u days, day %" PRIu32 " of %" PRIu32
+                   " s, compensated values %" PRIu32 ", first at %" PRIu32 " ms\r\n",
+                   (unsigned int)sensor, !baseline_stats.valid ? "learning" :
+                   baseline_stats.restored ? "restored" : "learned",
+                   (int)baseline_stats.offset, baseline_stats.limited ? " (limited)" : "",
+                   (unsigned int)baseline_stats.days, baseline_stats.day_s,
+                   (uint32_t)(PASCO2_BASELINE_DAY_MS / 1000U), baseline_stats.values, baseline_stats.accurate_ms);
+        }
+
+        pasco2_pressure_stats_t pressure_stats;
+        pasco2_get_pressure_stats(sensor, &pressure_stats);
+        printf("Sensor %u pressure: samples %" PRIu32 ", reference writes issued %" PRIu32 ", skipped %" PRIu32 "\r\n",
+               (unsigned int)sensor, pressure_stats.samples, pressure_stats.writes_issued, pressure_stats.writes_skipped);
+
+        pasco2_dps_fifo_stats_t dps_stats;
+        pasco2_get_dps_fifo_stats(sensor, &dps_stats);
+        printf("Sensor %u DPS3xx FIFO: batches %" PRIu32 ", pressure entries %" PRIu32 ", temperature entries %" PRIu32 "\r\n",
+               (unsigned int)sensor, dps_stats.batches, dps_stats.pressure_entries, dps_stats.temperature_entries);
+    }
+
+    pasco2_sample_ring_stats_t ring_stats;
+    pasco2_get_sample_ring_stats(&ring_stats);
+    printf("Sample ring: pushed %" PRIu32 ", overflows %" PRIu32 ", high-water %" PRIu32 "/%u\r\n",
+           ring_stats.pushed, ring_stats.overflows, ring_stats.high_water,
+           (unsigned int)PASCO2_SAMPLE_RING_CAPACITY);
+
+    for (uint8_t bus = 0U; bus < pasco2_get_bus_count(); bus++)
+    {
+        pasco2_i2c_engine_stats_t i2c_stats;
+        pasco2_get_i2c_engine_stats(bus, &i2c_stats);
+        printf("I2C bus %u engine: requests %" PRIu32 ", transactions %" PRIu32 ", bytes %" PRIu32 ", errors %" PRIu32 ", mux selects %" PRIu32 ", queue high-water %" PRIu32 ", bus clears %" PRIu32 "\r\n",
+               (unsigned int)bus, i2c_stats.requests, i2c_stats.transactions, i2c_stats.bytes, i2c_stats.errors,
+               i2c_stats.mux_selects, i2c_stats.queue_high_water, i2c_stats.bus_clears);
+    }
+
+    printf("Log: dropped %" PRIu32 "\r\n", pasco2_log_get_dropped());
+    printf("Terminal: received characters dropped %" PRIu32 "\r\n", terminal_ui_rx_dropped);
+
+    pasco2_console_stats_t console_stats;
+    pasco2_console_get_stats(&console_stats);
+    printf("Console: writes %" PRIu32 ", bytes %" PRIu32 ", transfers %" PRIu32 ", blocked %" PRIu32
+           ", dropped %" PRIu32 " writes of %" PRIu32 " bytes, high-water %" PRIu32 "/%u bytes\r\n",
+           console_stats.writes, console_stats.bytes, console_stats.transfers, console_stats.blocked_writes,
+           console_stats.dropped_writes, console_stats.dropped_bytes, console_stats.high_water,
+           (unsigned int)PASCO2_CONSOLE_RING_SIZE);
+
+    pasco2_command_stats_t command_stats;
+    pasco2_get_command_stats(&command_stats);
+    printf("Sensor commands: completed %" PRIu32 ", errors %" PRIu32 ", rejected %" PRIu32 ", queue high-water %" PRIu32
+           ", latency last %" PRIu32 " ms, max %" PRIu32 " ms\r\n",
+           command_stats.completed, command_stats.errors, command_stats.rejected, command_stats.queue_high_water,
+           command_stats.last_latency_ms, command_stats.max_latency_ms);
+
+    pasco2_boot_stats_t boot_stats;
+    pasco2_get_boot_stats(&boot_stats);
+    printf("Boot: power-up %" PRIu32 " ms, DPS3xx ready %" PRIu32 " ms, PAS CO2 ready %" PRIu32 " ms after %" PRIu32
+           " polls, sensors ready %" PRIu32 " ms, first CO2 value %" PRIu32 " ms\r\n",
+           boot_stats.power_ms, boot_stats.dps_ready_ms, boot_stats.co2_ready_ms, boot_stats.ready_polls,
+           boot_stats.sensors_ready_ms, boot_stats.first_ppm_ms);
+
+    pasco2_power_stats_t power_stats;
+    pasco2_get_power_stats(&power_stats);
+    printf("%s mode: samples %" PRIu32 ", wake-ups %" PRIu32 ", awake %" PRIu32 " ms of %" PRIu32 " ms\r\n",
+           pasco2_get_single_shot_mode() ? "Single-shot" : "Continuous",
+           power_stats.samples, power_stats.wakeups, power_stats.awake_ms, power_stats.elapsed_ms);
+    if (power_stats.samples > 0U)
+    {
+        uint32_t wakeups_x10 = (power_stats.wakeups * 10U) / power_stats.samples;
+        printf("Per sample: wake-ups %" PRIu32 ".%" PRIu32 ", awake %" PRIu32 " ms, interval %" PRIu32 " ms\r\n",
+               wakeups_x10 / 10U, wakeups_x10 % 10U, power_stats.awake_ms / power_stats.samples,
+               power_stats.elapsed_ms / power_stats.samples);
+    }
     printf("\r\n");
+    return false;
 }
 
 /*******************************************************************************
- * Function Name: terminal_ui_info
+ * Function Name: terminal_ui_print_co2_stats
  *******************************************************************************
  * Summary:
- *   This function prints character using which a user can see all available
- *   parameters configurable for CO2 sensor.
+ *   Command 'w': prints the CO2 statistics of every window.
+ *
+ * Parameters:
+ *   none
+ *
+ * Return:
+ *   false, the command reads no line
+ ******************************************************************************/
+static bool terminal_ui_print_co2_stats(void)
+{
+    for (uint8_t sensor = 0U; sensor < pasco2_get_sensor_count(); sensor++)
+    {
+        for (uint32_t window = 0U; window < PASCO2_STATS_WINDOW_COUNT; window++)
+        {
+            pasco2_stats_summary_t summary;
+            pasco2_get_co2_stats(sensor, (pasco2_stats_window_id_t)window, &summary);
+            printf("Sensor %u last %-5s: values %5" PRIu32, (unsigned int)sensor,
+                   pasco2_stats_window_name((pasco2_stats_window_id_t)window), summary.count);
+            if (summary.count > 0U)
+            {
+                printf(", min %5u, mean %5" PRIu32 ".%" PRIu32 ", p50 %5u, p95 %5u, max %5u ppm",
+                       (unsigned int)summary.min, summary.mean_x10 / 10U, summary.mean_x10 % 10U,
+                       (unsigned int)summary.p50, (unsigned int)summary.p95, (unsigned int)summary.max);
+            }
+            printf("\r\n");
+        }
+    }
+    printf("\r\n");
+    return false;
+}
+
+/*******************************************************************************
+ * Function Name: terminal_ui_show_latency
+ *******************************************************************************
+ * Summary:
+ *   Command 'l': prints the latency histograms and asks whether to reset them.
  *
  * Parameters:
  *   none
  *
  * Return:
+ *   true if the command reads a line
+ ******************************************************************************/
+static bool terminal_ui_show_latency(void)
+{
+    terminal_ui_print_latency();
+#if (PASCO2_PROBE_ENABLE != 0U)
+    printf("Reset the latency histograms [y/n]?\r\n");
+    return true;
+#else
+    return false;
+#endif
+}
+
+/*******************************************************************************
+ * Function Name: terminal_ui_reset_latency
+ *******************************************************************************
+ * Summary:
+ *   Command 'l': resets the latency histograms if requested.
+ *
+ * Parameters:
+ *   line: answer entered by the user
+ *
+ * Return:
  *   none
  ******************************************************************************/
-static void terminal_ui_info(void)
+static void terminal_ui_reset_latency(const char *line)
 {
-    printf("Press '?' to list all CO2 sensor settings\r\n");
+    bool yes;
+    if (!terminal_ui_parse_yes_no(line, &yes))
+    {
+        return;
+    }
+    if (yes)
+    {
+#if (PASCO2_PROBE_ENABLE != 0U)
+        pasco2_probe_reset();
+#endif
+        printf("Latency histograms cleared\r\n\r\n");
+    }
+    else
+    {
+        printf("\r\n");
+    }
+}
+
+/*******************************************************************************
+ * Function Name: terminal_ui_print_history
+ *******************************************************************************
+ * Summary:
+ *   Command 'h': prints the state of the history log.
+ *
+ * Parameters:
+ *   none
+ *
+ * Return:
+ *   false, the command reads no line
+ ******************************************************************************/
+static bool terminal_ui_print_history(void)
+{
+    pasco2_history_stats_t stats;
+    if (!pasco2_get_history_stats(&stats))
+    {
+        printf("History log not available\r\n\r\n");
+        return false;
+    }
+    printf("History: %" PRIu32 " samples of %u s in %u of %u pages, %" PRIu32 " bytes",
+           stats.samples, (unsigned int)PASCO2_HISTORY_PERIOD_S, (unsigned int)stats.pages,
+           (unsigned int)stats.rows, stats.bytes);
+    if (stats.samples > 0U)
+    {
+        uint32_t bits = (stats.bytes * 8U * 10U) / stats.samples;
+        printf(", %" PRIu32 ".%" PRIu32 " bits per sample", bits / 10U, bits % 10U);
+    }
+    printf("\r\n");
+    printf("History: start-up %u, %" PRIu32 " samples not written yet, %" PRIu32 " page writes, %" PRIu32
+           " write errors, %u rows discarded at start-up\r\n\r\n",
+           (unsigned int)stats.boot, stats.pending, stats.commits, stats.write_errors,
+           (unsigned int)stats.rejected_rows);
+    return false;
 }
 
 /*******************************************************************************
- * Function Name: terminal_ui_readline
+ * Function Name: terminal_ui_print_stacks
  *******************************************************************************
  * Summary:
- *   This function reads values entered by a user and prints it.
+ *   Command 't': prints the stack size, peak use, and smallest free stack of
+ *   the application tasks, and with static allocation the kernel heap left.
  *
  * Parameters:
- *   uart_ptr: UART object
- *   line: value to be read
- *   maxlength: maximum number of characters to be read
+ *   none
  *
  * Return:
+ *   false, the command reads no line
+ ******************************************************************************/
+static bool terminal_ui_print_stacks(void)
+{
+    pasco2_rtos_stack_stats_t stats;
+    for (uint32_t i = 0U; pasco2_rtos_get_stack_stats(i, &stats); i++)
+    {
+        printf("Stack: %-18s %5" PRIu32 " bytes, peak %5" PRIu32 ", free %5" PRIu32 "\r\n", stats.name,
+               stats.stack_size, stats.stack_size - stats.stack_free_min, stats.stack_free_min);
+    }
+#if (PASCO2_STATIC_ALLOCATION != 0U)
+    printf("Kernel heap: %u bytes free, minimum %u bytes\r\n", (unsigned int)xPortGetFreeHeapSize(),
+           (unsigned int)xPortGetMinimumEverFreeHeapSize());
+#endif
+    printf("\r\n");
+    return false;
+}
+
+/*******************************************************************************
+ * Function Name: terminal_ui_ask_export
+ *******************************************************************************
+ * Summary:
+ *   Command 'x': asks for the range of the history export.
+ *
+ * Parameters:
  *   none
+ *
+ * Return:
+ *   true, the command reads a line
+ ******************************************************************************/
+static bool terminal_ui_ask_export(void)
+{
+    printf("Enter the export range [boot[:s]][-boot[:s]][@page], empty for all\r\n");
+    return true;
+}
+
+/*******************************************************************************
+ * Commands, in menu order
  ******************************************************************************/
-static void terminal_ui_readline(void *uart_ptr, char *line, int maxlength)
+static const terminal_ui_command_t terminal_ui_commands[] =
 {
-    cy_rslt_t result = CY_RSLT_SUCCESS;
+    { 'p', "Set the measurement period", terminal_ui_ask_period, terminal_ui_set_period },
+    { 'i', "Print additional diagnostic information if available", terminal_ui_ask_logging, terminal_ui_set_logging },
+    { 's', "Print acquisition statistics", terminal_ui_print_stats, NULL },
+    { 'b', "Stream binary telemetry frames instead of text", terminal_ui_ask_binary, terminal_ui_set_binary },
+    { 'm', "Use single-shot measurements with deep sleep in between", terminal_ui_ask_single_shot,
+      terminal_ui_set_single_shot },
+    { 'a', "Adapt the measurement period to the CO2 trend", terminal_ui_ask_adaptive, terminal_ui_set_adaptive },
+    { 'c', "Set the CO2 alarm thresholds", terminal_ui_ask_alarm, terminal_ui_set_alarm },
+    { 'w', "Print CO2 statistics of the last minute, hour, and day", terminal_ui_print_co2_stats, NULL },
+    { 'l', "Print hot-path latency histograms", terminal_ui_show_latency, terminal_ui_reset_latency },
+    { 'h', "Print the state of the CO2 history log in flash", terminal_ui_print_history, NULL },
+    { 'x', "Export the CO2 history log as binary frames", terminal_ui_ask_export, terminal_ui_export_history },
+    { 't', "Print the stack usage of the tasks", terminal_ui_print_stacks, NULL },
+};
 
-    if (maxlength <= 0)
+/*******************************************************************************
+ * Function Name: terminal_ui_menu
+ *******************************************************************************
+ * Summary:
+ *   This function prints the available parameters configurable for CO2 sensor.
+ *
+ * Parameters:
+ *   none
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+static void terminal_ui_menu(void)
+{
+    // Print main menu
+    printf("Select a setting to configure\r\n");
+    for (size_t i = 0U; i < (sizeof(terminal_ui_commands) / sizeof(terminal_ui_commands[0])); i++)
     {
-        return;
+        printf("'%c': %s\r\n", terminal_ui_commands[i].key, terminal_ui_commands[i].help);
     }
-    int i = 0;
-    uint8_t rx_value = 0;
-    /* Receive character until enter has been pressed */
-    while ((rx_value != '\r') && (--maxlength > 0))
+    printf("\r\n");
+}
+
+/*******************************************************************************
+ * Function Name: terminal_ui_dispatch
+ *******************************************************************************
+ * Summary:
+ *   Processes one received character: either feeds it to the line being
+ *   entered for the active command, or looks it up in the command table and
+ *   starts the command. The CO2 display is paused while a command runs.
+ *
+ * Parameters:
+ *   session: state of the terminal
+ *   rx_value: received character
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+static void terminal_ui_dispatch(terminal_ui_session_t *session, uint8_t rx_value)
+{
+    if (session->active != NULL)
     {
-        result = cyhal_uart_getc(uart_ptr, &rx_value, 0);
-        if (result != CY_RSLT_SUCCESS)
+        terminal_ui_line_status_t status = terminal_ui_line_feed(&session->line, rx_value);
+        if (status == TERMINAL_UI_LINE_EDITING)
         {
-            CY_ASSERT(0);
+            return;
         }
-
-        result = cyhal_uart_putc(uart_ptr, rx_value);
-        if (result != CY_RSLT_SUCCESS)
+        if (status == TERMINAL_UI_LINE_DONE)
         {
-            CY_ASSERT(0);
+            session->active->finish(session->line.text);
         }
+        session->active = NULL;
+        pasco2_display_ppm(true);
+        return;
+    }
+
+    /* Line ends left over from the previous input */
+    if ((rx_value == '\r') || (rx_value == '\n'))
+    {
+        return;
+    }
 
-        if (isspace(rx_value))
+    pasco2_display_ppm(false);
+
+    const terminal_ui_command_t *command = NULL;
+    if (rx_value == '?')
+    {
+        terminal_ui_menu();
+        pasco2_display_ppm(true);
+        return;
+    }
+    for (size_t i = 0U; i < (sizeof(terminal_ui_commands) / sizeof(terminal_ui_commands[0])); i++)
+    {
+        if (terminal_ui_commands[i].key == (char)rx_value)
         {
-            continue;
+            command = &terminal_ui_commands[i];
+            break;
         }
-        line[i++] = rx_value;
     }
 
-    result = cyhal_uart_putc(uart_ptr, '\n');
-    if (result != CY_RSLT_SUCCESS)
+    if (command == NULL)
+    {
+        terminal_ui_info();
+    }
+    else if (command->start() && (command->finish != NULL))
     {
-        CY_ASSERT(0);
+        session->active = command;
+        session->line.length = 0U;
+        return;
     }
 
-    line[i] = '\0';
+    pasco2_display_ppm(true);
 }
 
 /*******************************************************************************
  * Function Name: pasco2_terminal_ui_task
  *******************************************************************************
  * Summary:
- *   Continuously checks if a key has been pressed to configure CO2 sensor
- *   parameter. Displays a status message according to the user
- *   input/selection.
+ *   Waits for characters from the terminal and dispatches them to the
+ *   commands that configure the CO2 sensor. Blocks on the receive stream
+ *   buffer, so the task uses no CPU time while the terminal is idle.
  *
  * Parameters:
  *   arg: thread
@@ -158,84 +1288,26 @@ void pasco2_terminal_ui_task(cy_thread_arg_t arg)
 {
     (void)arg;
 
+    static StaticStreamBuffer_t rx_stream_buffer;
+    static uint8_t rx_storage[TERMINAL_UI_RX_BUFFER_SIZE + 1U];
+    StreamBufferHandle_t rx_stream = xStreamBufferCreateStatic(TERMINAL_UI_RX_BUFFER_SIZE, 1U, rx_storage,
+                                                               &rx_stream_buffer);
+    /* Kept off the stack, the line buffer is the largest part of the session */
+    static terminal_ui_session_t session = { .active = NULL };
+
     terminal_ui_menu();
-    char value[IFX_PASCO2_VALUE_MAXLENGTH];
-    uint8_t rx_value = 0;
+
+    pasco2_console_register_rx(terminal_ui_rx_isr, rx_stream);
+    cyhal_uart_enable_event(&cy_retarget_io_uart_obj, CYHAL_UART_IRQ_RX_NOT_EMPTY, TERMINAL_UI_RX_INTR_PRIORITY, true);
 
     for (;;)
     {
-        /* Check if a key was pressed */
-        if (cyhal_uart_getc(&cy_retarget_io_uart_obj, &rx_value, 0) == CY_RSLT_SUCCESS)
-        {
-            pasco2_display_ppm(false);
-
-            switch ((char)rx_value)
-            {
-                // menu
-                case '?':
-                    terminal_ui_menu();
-                    break;
-                
-                // measurement period
-                case 'p':
-                {
-                    printf("Enter the measurement period [5-4095]s\r\n");
-                    terminal_ui_readline(&cy_retarget_io_uart_obj, value, IFX_PASCO2_VALUE_MAXLENGTH);
-
-                    char *end;
-                    const uint16_t measurement_period = (uint16_t)strtol(value, &end, 10);
-                    if (value != end)
-                    {
-                        if ((measurement_period < XENSIV_PASCO2_MEAS_RATE_MIN) || (measurement_period > XENSIV_PASCO2_MEAS_RATE_MAX))
-                        {
-                            printf("CO2 sensor measurement period configuration error, Valid range is [5-4095]s\r\n\r\n");
-                        }
-                        else
-                        {
-                            xensiv_pasco2_measurement_config_t meas_config = {
-                                .b.op_mode = XENSIV_PASCO2_OP_MODE_IDLE,
-                                .b.boc_cfg = XENSIV_PASCO2_BOC_CFG_AUTOMATIC
-                            };
-                            int32_t status = xensiv_pasco2_set_measurement_config(&xensiv_pasco2, meas_config);
-
-                            status |= xensiv_pasco2_set_measurement_rate(&xensiv_pasco2, measurement_period);
-
-                            meas_config = (xensiv_pasco2_measurement_config_t){
-                                .b.op_mode = XENSIV_PASCO2_OP_MODE_CONTINUOUS,
-                                .b.boc_cfg = XENSIV_PASCO2_BOC_CFG_AUTOMATIC
-                            };
-                            status |= xensiv_pasco2_set_measurement_config(&xensiv_pasco2, meas_config);
-
-                            if (status == CY_RSLT_SUCCESS)
-                            {
-                                printf("CO2 measurement period set to: %d\r\n\r\n", measurement_period);
-                            }
-                            else
-                            {
-                                printf("An unexpected error occurred while trying to change the measurement period\r\n\r\n");
-                            }
-                        }
-                    }
-                    break;
-                }
-                
-                case 'i':
-                    printf("Display additional diagnostic information [y/n]?\r\n");
-                    terminal_ui_readline(&cy_retarget_io_uart_obj, value, IFX_PASCO2_VALUE_MAXLENGTH);
-                    if (strlen(value) != 1 || (value[0] != 'y' && value[0] != 'n'))
-                    {
-                        printf("Input error, valid values are [y/n]\r\n\r\n");
-                        continue;
-                    }
-                    pasco2_enable_internal_logging(value[0] == 'y');
-                    break;
-                
-                default:
-                    terminal_ui_info();
-                    break;
-            }
+        uint8_t rx[TERMINAL_UI_RX_CHUNK];
+        size_t length = xStreamBufferReceive(rx_stream, rx, sizeof(rx), portMAX_DELAY);
 
-            pasco2_display_ppm(true);
+        for (size_t i = 0U; i < length; i++)
+        {
+            terminal_ui_dispatch(&session, rx[i]);
         }
     }
 }
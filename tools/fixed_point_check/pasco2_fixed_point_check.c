@@ -0,0 +1,537 @@
+/*****************************************************************************
+** File name: pasco2_fixed_point_check.c
+**
+** Description: Host equivalence test and benchmark of the integer pressure
+** path. Runs the DPS3xx FIFO compensation and the pressure filter of the
+** firmware next to the floating-point implementation they replaced and a
+** double-precision reference, and reports the largest differences and the
+** time per FIFO batch.
+**
+** Build (Linux):
+**   cc -O2 -DPASCO2_PROBE_ENABLE=0 -I../../source -I../../configs -I../host_sim/include \
+**      -o pasco2_fixed_point_check pasco2_fixed_point_check.c \
+**      ../../source/pasco2_dps_fifo.c ../../source/pasco2_pressure.c -lm
+**
+** ===========================================================================
+** Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+** ===========================================================================
+**
+** ===========================================================================
+** Infineon Technologies AG (INFINEON) is supplying this file for use
+** exclusively with Infineon's sensor products. This file can be freely
+** distributed within development tools and software supporting such
+** products.
+**
+** THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+** OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+** MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+** INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+** WHATSOEVER.
+** ===========================================================================
+*/
+
+/* Header file from system */
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/* Header file for the firmware modules under test */
+#include "pasco2_dps_fifo.h"
+#include "pasco2_pressure.h"
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+/* FIFO batches per test case */
+#define BATCHES                 (200000U)
+
+/* Filter updates of the pressure filter test */
+#define FILTER_UPDATES          (1000000U)
+
+/* Largest accepted differences to the double-precision reference */
+#define LIMIT_PRESSURE_PA       (0.6)
+#define LIMIT_TEMPERATURE_C     (0.011)
+
+/*******************************************************************************
+ * Constants
+ ******************************************************************************/
+static const double scale_factor[] =
+{
+    524288.0, 1572864.0, 3670016.0, 7864320.0, 253952.0, 516096.0, 1040384.0, 2088960.0
+};
+
+/*******************************************************************************
+ * Global Variables
+ ******************************************************************************/
+static uint32_t random_state = 1U;
+
+/*******************************************************************************
+ * Function Name: pasco2_sim_assert_failed
+ *******************************************************************************
+ * Summary:
+ *   Target of CY_ASSERT in the host stand-in headers.
+ *
+ * Parameters:
+ *   file: source file of the failed check
+ *   line: line of the failed check
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+void pasco2_sim_assert_failed(const char *file, int line)
+{
+    fprintf(stderr, "assertion failed at %s:%d\n", file, line);
+    abort();
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_i2c_engine_transfer
+ *******************************************************************************
+ * Summary:
+ *   Stand-in for the I2C engine. The FIFO entries are prepared by the test.
+ *
+ * Parameters:
+ *   engine: unused
+ *   request: unused
+ *   timeout_ms: unused
+ *
+ * Return:
+ *   CY_RSLT_SUCCESS
+ ******************************************************************************/
+cy_rslt_t pasco2_i2c_engine_transfer(pasco2_i2c_engine_t *engine, pasco2_i2c_request_t *request, cy_time_t timeout_ms)
+{
+    (void)engine;
+    (void)request;
+    (void)timeout_ms;
+    return CY_RSLT_SUCCESS;
+}
+
+/*******************************************************************************
+ * Function Name: uniform
+ *******************************************************************************
+ * Summary:
+ *   Returns a pseudo-random number.
+ *
+ * Parameters:
+ *   low: lower limit
+ *   high: upper limit
+ *
+ * Return:
+ *   uniformly distributed value in [low, high)
+ ******************************************************************************/
+static double uniform(double low, double high)
+{
+    random_state = (random_state * 1664525U) + 1013904223U;
+    return low + ((high - low) * (double)(random_state >> 8) / 16777216.0);
+}
+
+/*******************************************************************************
+ * Function Name: float_compensate
+ *******************************************************************************
+ * Summary:
+ *   The floating-point compensation that the integer path replaced.
+ *
+ * Parameters:
+ *   dps: FIFO readout object with coefficients and entries
+ *   pressure: receives the mean pressure in hPa
+ *   temperature: receives the mean temperature in degree Celsius
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+static void float_compensate(const pasco2_dps_fifo_t *dps, float32_t *pressure, float32_t *temperature)
+{
+    float32_t p_sum = 0.0F;
+    float32_t t_sum = 0.0F;
+    float32_t p2_sum = 0.0F;
+    float32_t p3_sum = 0.0F;
+    uint32_t p_count = 0U;
+    uint32_t t_count = 0U;
+
+    const float32_t kp = (float32_t)scale_factor[PASCO2_DPS_FIFO_PRESSURE_OVERSAMPLE];
+    const float32_t kt = (float32_t)scale_factor[0];
+
+    for (uint8_t i = 0U; i < PASCO2_DPS_FIFO_BATCH; i++)
+    {
+        uint32_t raw = ((uint32_t)dps->entries[i][0] << 16) | ((uint32_t)dps->entries[i][1] << 8) | dps->entries[i][2];
+        int32_t value = (int32_t)((raw ^ 0x800000U) - 0x800000U);
+        float32_t scaled;
+        if ((raw & 1U) != 0U)
+        {
+            scaled = (float32_t)(value & ~1) / kp;
+            p_sum += scaled;
+            p2_sum += scaled * scaled;
+            p3_sum += scaled * scaled * scaled;
+            p_count++;
+        }
+        else
+        {
+            scaled = (float32_t)value / kt;
+            t_sum += scaled;
+            t_count++;
+        }
+    }
+
+    float32_t p_mean = p_sum / (float32_t)p_count;
+    float32_t p2_mean = p2_sum / (float32_t)p_count;
+    float32_t p3_mean = p3_sum / (float32_t)p_count;
+    float32_t t_mean = t_sum / (float32_t)t_count;
+
+    float32_t pa = (float32_t)dps->c00
+                 + (p_mean * (float32_t)dps->c10)
+                 + (p2_mean * (float32_t)dps->c20)
+                 + (p3_mean * (float32_t)dps->c30)
+                 + (t_mean * (float32_t)dps->c01)
+                 + (t_mean * p_mean * (float32_t)dps->c11)
+                 + (t_mean * p2_mean * (float32_t)dps->c21);
+
+    *pressure = pa / 100.0F;
+    *temperature = ((float32_t)dps->c0 * 0.5F) + ((float32_t)dps->c1 * t_mean);
+}
+
+/*******************************************************************************
+ * Function Name: double_compensate
+ *******************************************************************************
+ * Summary:
+ *   Double-precision reference of the batch compensation: the polynomial
+ *   applied to every pressure entry, averaged over the batch.
+ *
+ * Parameters:
+ *   dps: FIFO readout object with coefficients and entries
+ *   pressure: receives the mean pressure in Pa
+ *   temperature: receives the mean temperature in degree Celsius
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+static void double_compensate(const pasco2_dps_fifo_t *dps, double *pressure, double *temperature)
+{
+    double t_sum = 0.0;
+    uint32_t t_count = 0U;
+
+    for (uint8_t i = 0U; i < PASCO2_DPS_FIFO_BATCH; i++)
+    {
+        uint32_t raw = ((uint32_t)dps->entries[i][0] << 16) | ((uint32_t)dps->entries[i][1] << 8) | dps->entries[i][2];
+        if ((raw & 1U) == 0U)
+        {
+            t_sum += (double)(int32_t)((raw ^ 0x800000U) - 0x800000U) / scale_factor[0];
+            t_count++;
+        }
+    }
+    double t = t_sum / (double)t_count;
+
+    double p_sum = 0.0;
+    uint32_t p_count = 0U;
+    for (uint8_t i = 0U; i < PASCO2_DPS_FIFO_BATCH; i++)
+    {
+        uint32_t raw = ((uint32_t)dps->entries[i][0] << 16) | ((uint32_t)dps->entries[i][1] << 8) | dps->entries[i][2];
+        if ((raw & 1U) != 0U)
+        {
+            double p = (double)((int32_t)((raw ^ 0x800000U) - 0x800000U) & ~1) /
+                       scale_factor[PASCO2_DPS_FIFO_PRESSURE_OVERSAMPLE];
+            p_sum += dps->c00 + (p * (dps->c10 + (p * (dps->c20 + (p * dps->c30))))) +
+                     (t * (dps->c01 + (p * (dps->c11 + (p * dps->c21)))));
+            p_count++;
+        }
+    }
+
+    *pressure = p_sum / (double)p_count;
+    *temperature = (dps->c0 * 0.5) + (dps->c1 * t);
+}
+
+/*******************************************************************************
+ * Function Name: fill_batch
+ *******************************************************************************
+ * Summary:
+ *   Fills the FIFO entries with alternating temperature and pressure results
+ *   around the given scaled raw values.
+ *
+ * Parameters:
+ *   dps: FIFO readout object
+ *   p: scaled raw pressure
+ *   t: scaled raw temperature
+ *   noise: noise of the scaled raw pressure
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+static void fill_batch(pasco2_dps_fifo_t *dps, double p, double t, double noise)
+{
+    for (uint8_t i = 0U; i < PASCO2_DPS_FIFO_BATCH; i++)
+    {
+        bool is_pressure = (i % 2U) != 0U;
+        double scaled = is_pressure ? ((p + uniform(-noise, noise)) * scale_factor[PASCO2_DPS_FIFO_PRESSURE_OVERSAMPLE])
+                                    : (t * scale_factor[0]);
+        int32_t raw = (int32_t)lround(fmin(fmax(scaled, -8388606.0), 8388606.0));
+
+        /* The least significant bit tells pressure from temperature */
+        raw = is_pressure ? (raw | 1) : (raw & ~1);
+        dps->entries[i][0] = (uint8_t)((uint32_t)raw >> 16);
+        dps->entries[i][1] = (uint8_t)((uint32_t)raw >> 8);
+        dps->entries[i][2] = (uint8_t)(uint32_t)raw;
+    }
+}
+
+/*******************************************************************************
+ * Function Name: check_compensation
+ *******************************************************************************
+ * Summary:
+ *   Compares the integer and float compensation with the reference.
+ *
+ * Parameters:
+ *   name: name of the test case
+ *   realistic: true for sensor-like coefficients and values, false for
+ *     random coefficients and raw values over their full range
+ *
+ * Return:
+ *   true if the integer path stays within the limits
+ ******************************************************************************/
+static bool check_compensation(const char *name, bool realistic)
+{
+    static pasco2_dps_fifo_t dps;
+    double fixed_p_error = 0.0;
+    double fixed_t_error = 0.0;
+    double float_p_error = 0.0;
+    double float_t_error = 0.0;
+    bool passed = true;
+
+    for (uint32_t batch = 0U; batch < BATCHES; batch++)
+    {
+        memset(&dps, 0, sizeof(dps));
+        double p;
+        double t;
+        if (realistic)
+        {
+            /* Coefficients of a typical part, values of 300 to 1200 hPa and
+             * -40 to 85 degree Celsius */
+            dps.c0 = (int32_t)lround(uniform(180.0, 240.0));
+            dps.c1 = (int32_t)lround(uniform(-290.0, -240.0));
+            dps.c00 = (int32_t)lround(uniform(70000.0, 90000.0));
+            dps.c10 = (int32_t)lround(uniform(-60000.0, -50000.0));
+            dps.c01 = (int32_t)lround(uniform(-2500.0, -1500.0));
+            dps.c11 = (int32_t)lround(uniform(1000.0, 1400.0));
+            dps.c20 = (int32_t)lround(uniform(-12000.0, -10000.0));
+            dps.c21 = (int32_t)lround(uniform(50.0, 110.0));
+            dps.c30 = (int32_t)lround(uniform(-1500.0, -900.0));
+            t = ((uniform(-40.0, 85.0) - (dps.c0 * 0.5)) / dps.c1);
+            p = -(uniform(30000.0, 120000.0) - dps.c00) / -dps.c10;
+        }
+        else
+        {
+            /* Any coefficient and raw value the registers can hold */
+            dps.c0 = (int32_t)lround(uniform(-2048.0, 2047.0));
+            dps.c1 = (int32_t)lround(uniform(-2048.0, 2047.0));
+            dps.c00 = (int32_t)lround(uniform(-524288.0, 524287.0));
+            dps.c10 = (int32_t)lround(uniform(-524288.0, 524287.0));
+            dps.c01 = (int32_t)lround(uniform(-32768.0, 32767.0));
+            dps.c11 = (int32_t)lround(uniform(-32768.0, 32767.0));
+            dps.c20 = (int32_t)lround(uniform(-32768.0, 32767.0));
+            dps.c21 = (int32_t)lround(uniform(-32768.0, 32767.0));
+            dps.c30 = (int32_t)lround(uniform(-32768.0, 32767.0));
+            t = uniform(-8388608.0, 8388607.0) / scale_factor[0];
+            p = uniform(-8388608.0, 8388607.0) / scale_factor[PASCO2_DPS_FIFO_PRESSURE_OVERSAMPLE];
+        }
+        fill_batch(&dps, p, t, realistic ? 2e-5 : 0.0);
+
+        double ref_pa;
+        double ref_c;
+        double_compensate(&dps, &ref_pa, &ref_c);
+
+        float32_t float_hpa;
+        float32_t float_c;
+        float_compensate(&dps, &float_hpa, &float_c);
+
+        int32_t fixed_pa;
+        int16_t fixed_centi;
+        if (pasco2_dps_fifo_drain(&dps, &fixed_pa, &fixed_centi) != CY_RSLT_SUCCESS)
+        {
+            passed = false;
+            continue;
+        }
+
+        /* Temperatures beyond the int16_t range of the firmware are not
+         * physical, skip their comparison */
+        bool t_valid = fabs(ref_c) < 300.0;
+        fixed_p_error = fmax(fixed_p_error, fabs((double)fixed_pa - ref_pa));
+        float_p_error = fmax(float_p_error, fabs(((double)float_hpa * 100.0) - ref_pa));
+        if (t_valid)
+        {
+            fixed_t_error = fmax(fixed_t_error, fabs(((double)fixed_centi / 100.0) - ref_c));
+            float_t_error = fmax(float_t_error, fabs((double)float_c - ref_c));
+        }
+    }
+
+    if (realistic)
+    {
+        passed = passed && (fixed_p_error <= LIMIT_PRESSURE_PA) && (fixed_t_error <= LIMIT_TEMPERATURE_C);
+    }
+    else
+    {
+        /* Full-range values may exceed a few Pa of rounding, but must not overflow */
+        passed = passed && (fixed_p_error <= (LIMIT_PRESSURE_PA * 10.0));
+    }
+
+    printf("%-10s pressure error: integer %.3f Pa, float %.3f Pa; temperature error: integer %.4f C, float %.4f C\n",
+           name, fixed_p_error, float_p_error, fixed_t_error, float_t_error);
+    return passed;
+}
+
+/*******************************************************************************
+ * Function Name: check_filter
+ *******************************************************************************
+ * Summary:
+ *   Runs the pressure filter of the firmware next to the float filter it
+ *   replaced on a random walk and compares the filtered pressure and the
+ *   reference writes.
+ *
+ * Parameters:
+ *   none
+ *
+ * Return:
+ *   true if the filtered pressures agree within 0.1 hPa
+ ******************************************************************************/
+static bool check_filter(void)
+{
+    pasco2_pressure_t filter;
+    float32_t float_filtered = 0.0F;
+    uint16_t float_reference = 0U;
+    bool float_reference_valid = false;
+    double pa = 101325.0;
+    double max_error = 0.0;
+    uint32_t write_mismatches = 0U;
+
+    pasco2_pressure_init(&filter);
+    for (uint32_t i = 0U; i < FILTER_UPDATES; i++)
+    {
+        pa += uniform(-20.0, 20.0);
+        pa = fmin(fmax(pa, 95000.0), 105000.0);
+        int32_t value = (int32_t)lround(pa);
+
+        pasco2_pressure_update(&filter, value);
+        float32_t hpa = (float32_t)value / 100.0F;
+        float_filtered = (i == 0U) ? hpa : (float_filtered + ((hpa - float_filtered) / 4.0F));
+
+        uint16_t reference;
+        bool fixed_write = pasco2_pressure_reference_due(&filter, false, &reference);
+        uint16_t float_value = (uint16_t)(float_filtered + 0.5F);
+        uint16_t delta = (float_value > float_reference) ? (uint16_t)(float_value - float_reference)
+                                                         : (uint16_t)(float_reference - float_value);
+        bool float_write = !float_reference_valid || (delta >= PASCO2_PRESSURE_HYSTERESIS_HPA);
+        if (float_write)
+        {
+            float_reference = float_value;
+            float_reference_valid = true;
+        }
+
+        write_mismatches += (fixed_write != float_write) ? 1U : 0U;
+        max_error = fmax(max_error, fabs(((double)pasco2_pressure_get(&filter) / 100.0) - (double)float_filtered));
+    }
+
+    printf("filter     largest difference %.3f hPa, reference write decisions differing %lu of %lu\n",
+           max_error, (unsigned long)write_mismatches, (unsigned long)FILTER_UPDATES);
+    return max_error < 0.1;
+}
+
+/*******************************************************************************
+ * Function Name: elapsed_ns
+ *******************************************************************************
+ * Summary:
+ *   Returns the time between two clock readings.
+ *
+ * Parameters:
+ *   start: first reading
+ *   end: second reading
+ *
+ * Return:
+ *   nanoseconds
+ ******************************************************************************/
+static double elapsed_ns(const struct timespec *start, const struct timespec *end)
+{
+    return ((double)(end->tv_sec - start->tv_sec) * 1e9) + (double)(end->tv_nsec - start->tv_nsec);
+}
+
+/*******************************************************************************
+ * Function Name: benchmark
+ *******************************************************************************
+ * Summary:
+ *   Measures the time per FIFO batch of both compensation paths.
+ *
+ * Parameters:
+ *   none
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+static void benchmark(void)
+{
+    static pasco2_dps_fifo_t dps;
+    struct timespec start;
+    struct timespec end;
+    volatile uint32_t fixed_sink = 0U;
+    volatile float32_t float_sink = 0.0F;
+
+    memset(&dps, 0, sizeof(dps));
+    dps.c0 = 208;
+    dps.c1 = -264;
+    dps.c00 = 80000;
+    dps.c10 = -56000;
+    dps.c01 = -2000;
+    dps.c11 = 1200;
+    dps.c20 = -11000;
+    dps.c21 = 80;
+    dps.c30 = -1200;
+    fill_batch(&dps, -0.38, 0.35, 2e-5);
+
+    (void)clock_gettime(CLOCK_MONOTONIC, &start);
+    for (uint32_t i = 0U; i < BATCHES; i++)
+    {
+        int32_t pa;
+        int16_t centi;
+        (void)pasco2_dps_fifo_drain(&dps, &pa, &centi);
+        fixed_sink += (uint32_t)pa + (uint32_t)centi;
+    }
+    (void)clock_gettime(CLOCK_MONOTONIC, &end);
+    double fixed_ns = elapsed_ns(&start, &end) / BATCHES;
+
+    (void)clock_gettime(CLOCK_MONOTONIC, &start);
+    for (uint32_t i = 0U; i < BATCHES; i++)
+    {
+        float32_t hpa;
+        float32_t celsius;
+        float_compensate(&dps, &hpa, &celsius);
+        float_sink += hpa + celsius;
+    }
+    (void)clock_gettime(CLOCK_MONOTONIC, &end);
+    double float_ns = elapsed_ns(&start, &end) / BATCHES;
+
+    printf("benchmark  %u entries per batch: integer %.1f ns, float %.1f ns\n",
+           (unsigned int)PASCO2_DPS_FIFO_BATCH, fixed_ns, float_ns);
+}
+
+/*******************************************************************************
+ * Function Name: main
+ *******************************************************************************
+ * Summary:
+ *   Runs the equivalence checks and the benchmark.
+ *
+ * Parameters:
+ *   none
+ *
+ * Return:
+ *   0 if all checks passed
+ ******************************************************************************/
+int main(void)
+{
+    bool passed = check_compensation("realistic", true);
+    passed = check_compensation("full-range", false) && passed;
+    passed = check_filter() && passed;
+    benchmark();
+
+    printf("check %s\n", passed ? "passed" : "FAILED");
+    return passed ? 0 : 1;
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,579 @@
+/*****************************************************************************
+** File name: pasco2_history_check.c
+**
+** Description: Host check of the CO2 history log on the work flash model.
+** Feeds a synthetic office CO2 series into the log of the firmware, decodes
+** it again, and reports the size per sample, the erase count distribution
+** over the rows after a long run, and recovery from writes torn by power
+** losses at random bytes.
+**
+** Build (Linux):
+**   cc -O2 -I../../source -I../host_sim -I../host_sim/include -o pasco2_history_check \
+**      pasco2_history_check.c ../../source/pasco2_history.c \
+**      ../../source/pasco2_history_cursor.c ../host_sim/pasco2_sim_flash.c -lm
+**
+** Options: -d days of the size check, -y years of the wear run, -n number
+** of power losses.
+**
+** ===========================================================================
+** Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+** ===========================================================================
+**
+** ===========================================================================
+** Infineon Technologies AG (INFINEON) is supplying this file for use
+** exclusively with Infineon's sensor products. This file can be freely
+** distributed within development tools and software supporting such
+** products.
+**
+** THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+** OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+** MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+** INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+** WHATSOEVER.
+** ===========================================================================
+*/
+
+/* Header file from system */
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Header file for the history log of the firmware */
+#include "cy_pdl.h"
+#include "pasco2_history.h"
+#include "pasco2_sim.h"
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+#define DEFAULT_DAYS            (30U)
+#define DEFAULT_YEARS           (2U)
+#define DEFAULT_TRIALS          (1000U)
+
+/* Interval of the CO2 readings in ms */
+#define READING_PERIOD_MS       (10000U)
+
+/* Longest run between two power losses in readings, two days */
+#define TRIAL_READINGS          (2U * 8640U)
+
+/* Rows of the log, the whole work flash as in the firmware */
+#define HISTORY_ROWS            ((uint16_t)(CY_EM_EEPROM_SIZE / CY_FLASH_SIZEOF_ROW))
+
+/* Erase cycles a row of the work flash is specified for */
+#define FLASH_ENDURANCE         (100000.0)
+
+/* Most samples the log can hold, every sample taking one nibble */
+#define LOG_SAMPLES             (HISTORY_ROWS * PASCO2_HISTORY_PAYLOAD_SIZE * 2U)
+
+/* Size of a sample without compression: time in seconds and value */
+#define RAW_SAMPLE_SIZE         (6U)
+
+/*******************************************************************************
+ * Types
+ ******************************************************************************/
+/* Reference of the samples the log must hold */
+typedef struct
+{
+    pasco2_history_record_t *records;
+    uint32_t count;
+    uint32_t capacity;
+    /* Interval accumulator, mirrors the firmware independently */
+    uint16_t boot;
+    bool started;
+    uint32_t index;
+    uint32_t sum;
+    uint32_t readings;
+} reference_t;
+
+/* Synthetic office room */
+typedef struct
+{
+    uint64_t ms;                /* Time since the first start-up */
+    uint64_t uptime_ms;         /* Time since the latest start-up */
+    double ppm;
+    uint32_t random;
+} room_t;
+
+/*******************************************************************************
+ * Global Variables
+ ******************************************************************************/
+static cyhal_flash_t flash;
+static pasco2_history_t history;
+static pasco2_history_page_t page;
+static uint64_t flash_busy_us;
+static pasco2_history_record_t log_records[LOG_SAMPLES];
+
+/*******************************************************************************
+ * Function Name: pasco2_sim_assert_failed
+ *******************************************************************************
+ * Summary:
+ *   Target of CY_ASSERT in the host stand-in headers.
+ *
+ * Parameters:
+ *   file: source file of the failed check
+ *   line: line of the failed check
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+void pasco2_sim_assert_failed(const char *file, int line)
+{
+    fprintf(stderr, "assertion failed at %s:%d\n", file, line);
+    abort();
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_sim_consume
+ *******************************************************************************
+ * Summary:
+ *   Adds up the time the CPU waits for the flash model.
+ *
+ * Parameters:
+ *   duration_us: busy time
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+void pasco2_sim_consume(uint64_t duration_us)
+{
+    flash_busy_us += duration_us;
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_sim_random
+ *******************************************************************************
+ * Summary:
+ *   Returns the next value of a seeded generator, as in the host simulation.
+ *
+ * Parameters:
+ *   seed: generator state
+ *
+ * Return:
+ *   pseudo-random value in the range 0 to 65535
+ ******************************************************************************/
+uint32_t pasco2_sim_random(uint32_t *seed)
+{
+    *seed = (*seed * 1664525UL) + 1013904223UL;
+
+    return *seed >> 16U;
+}
+
+/*******************************************************************************
+ * Function Name: room_reading
+ *******************************************************************************
+ * Summary:
+ *   Advances the room by one reading period and returns the reading: the
+ *   air approaches 1400 ppm during office hours on weekdays and outdoor air
+ *   otherwise, the sensor adds up to 8 ppm of noise.
+ *
+ * Parameters:
+ *   room: room state
+ *
+ * Return:
+ *   CO2 reading in ppm
+ ******************************************************************************/
+static uint16_t room_reading(room_t *room)
+{
+    uint64_t hour_of_week = (room->ms / 3600000U) % (24U * 7U);
+    bool occupied = ((hour_of_week / 24U) < 5U) && ((hour_of_week % 24U) >= 8U) && ((hour_of_week % 24U) < 18U);
+    double target = occupied ? 1400.0 : 420.0;
+    double tau_s = (target > room->ppm) ? 1800.0 : 3600.0;
+
+    room->ppm += (target - room->ppm) * (1.0 - exp(-((double)READING_PERIOD_MS / 1000.0) / tau_s));
+    room->ms += READING_PERIOD_MS;
+    room->uptime_ms += READING_PERIOD_MS;
+
+    double noise = (((double)(pasco2_sim_random(&room->random) % 2001U) / 1000.0) - 1.0) * 8.0;
+    return (uint16_t)lround(room->ppm + noise);
+}
+
+/*******************************************************************************
+ * Function Name: reference_add
+ *******************************************************************************
+ * Summary:
+ *   Accumulates a reading into the reference: the rounded mean of the
+ *   readings of every interval, in the interval after it.
+ *
+ * Parameters:
+ *   ref: reference
+ *   uptime_ms: time of the reading since start-up
+ *   ppm: reading
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+static void reference_add(reference_t *ref, uint64_t uptime_ms, uint16_t ppm)
+{
+    uint32_t index = (uint32_t)(uptime_ms / (PASCO2_HISTORY_PERIOD_S * 1000U));
+
+    if (ref->started && (index != ref->index) && (ref->readings > 0U))
+    {
+        if (ref->count == ref->capacity)
+        {
+            ref->capacity = (ref->capacity == 0U) ? 65536U : (ref->capacity * 2U);
+            ref->records = realloc(ref->records, ref->capacity * sizeof(ref->records[0]));
+            CY_ASSERT(ref->records != NULL);
+        }
+        ref->records[ref->count++] = (pasco2_history_record_t)
+        {
+            .boot = ref->boot,
+            .time_s = ref->index * PASCO2_HISTORY_PERIOD_S,
+            .ppm = (uint16_t)((ref->sum + (ref->readings / 2U)) / ref->readings)
+        };
+        ref->sum = 0U;
+        ref->readings = 0U;
+    }
+    ref->started = true;
+    ref->index = index;
+    ref->sum += ppm;
+    ref->readings++;
+}
+
+/*******************************************************************************
+ * Function Name: reference_keep
+ *******************************************************************************
+ * Summary:
+ *   Drops samples from both ends of the reference.
+ *
+ * Parameters:
+ *   ref: reference
+ *   start: first sample to keep
+ *   count: number of samples to keep
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+static void reference_keep(reference_t *ref, uint32_t start, uint32_t count)
+{
+    memmove(ref->records, &ref->records[start], count * sizeof(ref->records[0]));
+    ref->count = count;
+}
+
+/*******************************************************************************
+ * Function Name: reference_restart
+ *******************************************************************************
+ * Summary:
+ *   Continues the reference after a start-up: the interval in progress is
+ *   lost and only the samples the log kept remain.
+ *
+ * Parameters:
+ *   ref: reference
+ *   start: first sample the log holds
+ *   count: samples the log holds
+ *   boot: start-up count of the log
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+static void reference_restart(reference_t *ref, uint32_t start, uint32_t count, uint16_t boot)
+{
+    reference_keep(ref, start, count);
+    ref->boot = boot;
+    ref->started = false;
+    ref->sum = 0U;
+    ref->readings = 0U;
+}
+
+/*******************************************************************************
+ * Function Name: feed
+ *******************************************************************************
+ * Summary:
+ *   Feeds readings of the room into the log and the reference.
+ *
+ * Parameters:
+ *   room: room state
+ *   ref: reference
+ *   readings: number of readings
+ *   result: result of the first failing add, CY_RSLT_SUCCESS if none failed
+ *
+ * Return:
+ *   number of readings fed, fewer if an add failed
+ ******************************************************************************/
+static uint32_t feed(room_t *room, reference_t *ref, uint32_t readings, cy_rslt_t *result)
+{
+    *result = CY_RSLT_SUCCESS;
+
+    for (uint32_t i = 0U; i < readings; i++)
+    {
+        uint16_t ppm = room_reading(room);
+
+        reference_add(ref, room->uptime_ms, ppm);
+        *result = pasco2_history_add(&history, (uint32_t)room->uptime_ms, ppm);
+        if (*result != CY_RSLT_SUCCESS)
+        {
+            return i + 1U;
+        }
+    }
+
+    return readings;
+}
+
+/*******************************************************************************
+ * Function Name: compare_log
+ *******************************************************************************
+ * Summary:
+ *   Decodes all pages of the log and finds them in the reference. The log
+ *   must hold a contiguous run of reference samples that ends within the
+ *   given range of the reference.
+ *
+ * Parameters:
+ *   ref: reference
+ *   shortest: smallest accepted end of the run in the reference
+ *   longest: largest accepted end of the run in the reference
+ *   start: destination of the start of the run in the reference
+ *   count: destination of the length of the run
+ *
+ * Return:
+ *   true if the log matches
+ ******************************************************************************/
+static bool compare_log(const reference_t *ref, uint32_t shortest, uint32_t longest, uint32_t *start, uint32_t *count)
+{
+    uint32_t decoded = 0U;
+
+    for (uint16_t p = 0U; p < pasco2_history_page_count(&history); p++)
+    {
+        pasco2_history_cursor_t cursor;
+
+        if (pasco2_history_read_page(&history, p, &page) != CY_RSLT_SUCCESS)
+        {
+            return false;
+        }
+        pasco2_history_cursor_init(&cursor, &page);
+        while ((decoded < LOG_SAMPLES) && pasco2_history_cursor_next(&cursor, &log_records[decoded]))
+        {
+            decoded++;
+        }
+        if (cursor.position != page.header.nibbles)
+        {
+            return false;
+        }
+    }
+    if ((decoded != history.stats.samples) || (longest > ref->count))
+    {
+        return false;
+    }
+
+    for (uint32_t end = longest; (end >= shortest) && (end >= decoded); end--)
+    {
+        const pasco2_history_record_t *expected = &ref->records[end - decoded];
+        uint32_t i = 0U;
+        while ((i < decoded) && (log_records[i].boot == expected[i].boot) &&
+               (log_records[i].time_s == expected[i].time_s) && (log_records[i].ppm == expected[i].ppm))
+        {
+            i++;
+        }
+        if (i == decoded)
+        {
+            *start = end - decoded;
+            *count = decoded;
+            return true;
+        }
+        if (end == 0U)
+        {
+            break;
+        }
+    }
+
+    return false;
+}
+
+/*******************************************************************************
+ * Function Name: open_log
+ *******************************************************************************
+ * Summary:
+ *   Starts the log as the firmware does after a reset.
+ *
+ * Parameters:
+ *   none
+ *
+ * Return:
+ *   result of pasco2_history_open
+ ******************************************************************************/
+static cy_rslt_t open_log(void)
+{
+    return pasco2_history_open(&history, &flash, CY_EM_EEPROM_BASE, HISTORY_ROWS);
+}
+
+/*******************************************************************************
+ * Function Name: main
+ *******************************************************************************
+ * Summary:
+ *   Runs the checks. Options: -d days of the size check, -y years of the
+ *   wear run, -n number of power losses.
+ *
+ * Parameters:
+ *   argc: number of arguments
+ *   argv: arguments
+ *
+ * Return:
+ *   0 if all checks passed
+ ******************************************************************************/
+int main(int argc, char *argv[])
+{
+    uint32_t days = DEFAULT_DAYS;
+    uint32_t years = DEFAULT_YEARS;
+    uint32_t trials = DEFAULT_TRIALS;
+    uint32_t failures = 0U;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if ((strcmp(argv[i], "-d") == 0) && ((i + 1) < argc))
+        {
+            days = (uint32_t)strtoul(argv[++i], NULL, 10);
+        }
+        else if ((strcmp(argv[i], "-y") == 0) && ((i + 1) < argc))
+        {
+            years = (uint32_t)strtoul(argv[++i], NULL, 10);
+        }
+        else if ((strcmp(argv[i], "-n") == 0) && ((i + 1) < argc))
+        {
+            trials = (uint32_t)strtoul(argv[++i], NULL, 10);
+        }
+        else
+        {
+            fprintf(stderr, "usage: %s [-d days] [-y years] [-n power losses]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    room_t room = { .ppm = 420.0, .random = 1U };
+    reference_t ref = { .boot = 0U };
+    cy_rslt_t result;
+    uint32_t start;
+    uint32_t count;
+
+    (void)cyhal_flash_init(&flash);
+    if (open_log() != CY_RSLT_SUCCESS)
+    {
+        fprintf(stderr, "cannot open the log\n");
+        return 1;
+    }
+
+    /* Size per sample: fill the log and decode it */
+    (void)feed(&room, &ref, days * 8640U, &result);
+    if ((result != CY_RSLT_SUCCESS) || !compare_log(&ref, ref.count, ref.count, &start, &count))
+    {
+        failures++;
+        printf("size check: decoded log does not match\n");
+    }
+    pasco2_history_stats_t stats;
+    pasco2_history_get_stats(&history, &stats);
+    double bytes_per_sample = (double)stats.bytes / (double)stats.samples;
+    double page_samples = (double)(PASCO2_HISTORY_PAYLOAD_SIZE) / bytes_per_sample;
+    printf("size: %lu samples of %u s in %u pages, %.3f bytes per sample (%.1fx smaller than %u bytes)\n",
+           (unsigned long)stats.samples, (unsigned int)PASCO2_HISTORY_PERIOD_S, (unsigned int)stats.pages,
+           bytes_per_sample, (double)RAW_SAMPLE_SIZE / bytes_per_sample, (unsigned int)RAW_SAMPLE_SIZE);
+    printf("capacity: %.0f samples per page, %u rows of %u bytes hold at least %.1f days\n", page_samples,
+           (unsigned int)HISTORY_ROWS, (unsigned int)PASCO2_HISTORY_PAGE_SIZE,
+           ((HISTORY_ROWS - 1U) * page_samples * PASCO2_HISTORY_PERIOD_S) / 86400.0);
+
+    /* Wear: a long run, then the erase counts of the rows */
+    uint32_t erases_before[HISTORY_ROWS];
+    for (uint32_t row = 0U; row < HISTORY_ROWS; row++)
+    {
+        erases_before[row] = pasco2_sim_flash_erase_count(row);
+    }
+    flash_busy_us = 0U;
+    for (uint32_t day = 0U; (day < (years * 365U)) && (result == CY_RSLT_SUCCESS); day++)
+    {
+        (void)feed(&room, &ref, 8640U, &result);
+        /* The reference only needs the samples the log can hold */
+        if (ref.count > (4U * 65536U))
+        {
+            reference_keep(&ref, ref.count - 65536U, 65536U);
+        }
+    }
+    if (result != CY_RSLT_SUCCESS)
+    {
+        failures++;
+        printf("wear run: flash write failed\n");
+    }
+    uint32_t min = UINT32_MAX;
+    uint32_t max = 0U;
+    double mean = 0.0;
+    for (uint32_t row = 0U; row < HISTORY_ROWS; row++)
+    {
+        uint32_t erases = pasco2_sim_flash_erase_count(row) - erases_before[row];
+        min = (erases < min) ? erases : min;
+        max = (erases > max) ? erases : max;
+        mean += (double)erases / HISTORY_ROWS;
+    }
+    printf("wear: %lu years, erases per row min %lu mean %.0f max %lu, %.1f%% of the rated %.0f cycles after "
+           "%.0f years\n", (unsigned long)years, (unsigned long)min, mean, (unsigned long)max,
+           (years > 0U) ? (100.0 * ((double)max / years) * 10.0 / FLASH_ENDURANCE) : 0.0, FLASH_ENDURANCE, 10.0);
+    printf("flash busy: %.1f ms per day\n", (years > 0U) ? (double)flash_busy_us / 1000.0 / (years * 365.0) : 0.0);
+    if ((years > 0U) && ((double)max > (1.5 * mean)))
+    {
+        failures++;
+        printf("wear run: erases are not spread over the rows\n");
+    }
+
+    /* Power losses at random bytes of a later flash write, then a restart */
+    uint32_t random = 7U;
+    uint32_t lost_samples = 0U;
+    uint32_t torn_kept = 0U;
+    uint32_t rejected = 0U;
+    uint32_t mismatches = 0U;
+    if (!compare_log(&ref, ref.count, ref.count, &start, &count))
+    {
+        mismatches++;
+    }
+    for (uint32_t trial = 0U; trial < trials; trial++)
+    {
+        uint32_t readings = 1U + (((pasco2_sim_random(&random) << 16) | pasco2_sim_random(&random)) % TRIAL_READINGS);
+        (void)feed(&room, &ref, readings, &result);
+
+        /* The next write fails at a random byte of its erase or program phase */
+        pasco2_history_get_stats(&history, &stats);
+        uint32_t committed = ref.count - stats.pending;
+        uint16_t pages = stats.pages;
+        pasco2_sim_flash_tear(1U + (pasco2_sim_random(&random) % (2U * PASCO2_HISTORY_PAGE_SIZE)),
+                              pasco2_sim_random(&random));
+        do
+        {
+            (void)feed(&room, &ref, 1U, &result);
+        } while (result == CY_RSLT_SUCCESS);
+        (void)pasco2_sim_flash_power_up();
+
+        /* Restart: everything committed before the torn write must be there */
+        uint32_t attempted = ref.count;
+        room.uptime_ms = 0U;
+        if (open_log() != CY_RSLT_SUCCESS)
+        {
+            mismatches++;
+            break;
+        }
+        pasco2_history_get_stats(&history, &stats);
+        rejected += stats.rejected_rows;
+        if (!compare_log(&ref, committed, attempted, &start, &count) || ((stats.pages + 1U) < pages) ||
+            ((count > 0U) && (stats.boot <= ref.records[start + count - 1U].boot)))
+        {
+            mismatches++;
+            printf("power loss %lu: log does not match the committed samples\n", (unsigned long)trial);
+            break;
+        }
+        lost_samples += attempted - (start + count);
+        if ((start + count) > committed)
+        {
+            torn_kept++;
+        }
+        reference_restart(&ref, start, count, stats.boot);
+    }
+    if (mismatches > 0U)
+    {
+        failures++;
+    }
+    printf("power loss: %lu restarts, %lu mismatches, %.1f samples lost per restart, %lu torn writes completed, "
+           "%lu torn rows seen at start-up\n", (unsigned long)trials, (unsigned long)mismatches,
+           (trials > 0U) ? ((double)lost_samples / trials) : 0.0, (unsigned long)torn_kept,
+           (unsigned long)rejected);
+
+    free(ref.records);
+    printf("check %s\n", (failures == 0U) ? "passed" : "FAILED");
+
+    return (failures == 0U) ? 0 : 1;
+}
+
+/* [] END OF FILE */
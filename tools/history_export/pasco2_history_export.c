@@ -0,0 +1,718 @@
+/*****************************************************************************
+** File name: pasco2_history_export.c
+**
+** Description: Host receiver of the CO2 history export of the PAS CO2
+** application. Requests the history log over the serial device, or decodes a
+** captured stream from a file, checks every frame and page, resumes an
+** interrupted transfer where it broke off, prints the samples as CSV lines
+** and reports the effective throughput.
+**
+** Build (Linux):
+**   cc -O2 -I../../source -I../host_sim/include -o pasco2_history_export \
+**      pasco2_history_export.c ../../source/pasco2_telemetry.c ../../source/pasco2_history_cursor.c
+**
+** Usage:
+**   pasco2_history_export [-b baud] [-f boot[:s]] [-t boot[:s]] [-r page] [-n attempts] [-q] device|file
+**     -b  baud rate of the device, default 115200
+**     -f  first time to export, start-up count and seconds since that start-up
+**     -t  last time to export
+**     -r  first page sequence number, resumes an earlier export
+**     -n  attempts on a device before giving up, default 5
+**     -q  do not print samples, only the summary
+**
+** ===========================================================================
+** Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+** ===========================================================================
+**
+** ===========================================================================
+** Infineon Technologies AG (INFINEON) is supplying this file for use
+** exclusively with Infineon's sensor products. This file can be freely
+** distributed within development tools and software supporting such
+** products.
+**
+** THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+** OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+** MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+** INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+** WHATSOEVER.
+** ===========================================================================
+*/
+
+/* Header file from system */
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+
+/* Header files for the shared frame and page formats */
+#include "pasco2_history.h"
+#include "pasco2_telemetry.h"
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+#define READ_CHUNK_SIZE     (4096U)
+#define DEFAULT_BAUD        (115200UL)
+#define DEFAULT_ATTEMPTS    (5U)
+
+/* An attempt on a device ends when nothing arrived for this long */
+#define IDLE_TIMEOUT_MS     (3000)
+
+/* Time for the terminal UI to show the prompt before the request line */
+#define PROMPT_DELAY_US     (100000U)
+
+/* Bits on the wire per UART character: start, 8 data bits, stop */
+#define UART_BITS_PER_CHAR  (10U)
+
+/*******************************************************************************
+ * Types
+ ******************************************************************************/
+/* Receiver state over all attempts of an export */
+typedef struct
+{
+    /* Requested range */
+    pasco2_history_record_t from;
+    pasco2_history_record_t to;
+    /* Pages received, ascending sequence numbers */
+    pasco2_history_page_t *pages;
+    uint32_t page_count;
+    uint32_t page_capacity;
+    /* Current attempt */
+    bool started;
+    bool ended;
+    bool broken;                /* A page frame was lost or corrupt */
+    uint32_t resume;            /* First page to request in the next attempt */
+    uint16_t next_index;
+    uint16_t attempt_pages;
+    uint32_t attempt_samples;
+    pasco2_telemetry_history_start_t start;
+    pasco2_telemetry_history_end_t end;
+    struct timespec start_wall; /* Host time of the start frame */
+    /* Byte positions in the input stream */
+    unsigned long long position;
+    unsigned long long start_position;  /* Start of the start frame */
+    unsigned long long pages_position;  /* End of the latest page frame */
+    /* Totals over all attempts */
+    uint32_t attempts;
+    uint32_t lost_frames;
+    uint32_t malformed_pages;
+    uint32_t count_mismatches;
+    uint32_t read_errors;
+    unsigned long long wire_bytes;
+    unsigned long long payload_bytes;
+    unsigned long long device_ms;
+} receiver_t;
+
+/*******************************************************************************
+ * Function Name: parse_time
+ *******************************************************************************
+ * Summary:
+ *   Parses a history time "boot[:seconds]".
+ *
+ * Parameters:
+ *   text: input
+ *   default_s: seconds if only the start-up count is given
+ *   time: destination of the time
+ *
+ * Return:
+ *   true if the input is valid
+ ******************************************************************************/
+static bool parse_time(const char *text, uint32_t default_s, pasco2_history_record_t *time)
+{
+    char *end;
+    unsigned long boot = strtoul(text, &end, 10);
+
+    if ((end == text) || (boot > UINT16_MAX))
+    {
+        return false;
+    }
+    time->boot = (uint16_t)boot;
+    time->time_s = default_s;
+    if (*end == ':')
+    {
+        text = end + 1;
+        time->time_s = (uint32_t)strtoul(text, &end, 10);
+        if (end == text)
+        {
+            return false;
+        }
+    }
+
+    return *end == '\0';
+}
+
+/*******************************************************************************
+ * Function Name: store_page
+ *******************************************************************************
+ * Summary:
+ *   Keeps a received page. A page received again replaces the earlier copy
+ *   if it holds at least as many samples, the open page grows meanwhile.
+ *
+ * Parameters:
+ *   receiver: receiver state
+ *   page: received page
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+static void store_page(receiver_t *receiver, const pasco2_history_page_t *page)
+{
+    uint32_t index = 0U;
+
+    while ((index < receiver->page_count) && (receiver->pages[index].header.sequence < page->header.sequence))
+    {
+        index++;
+    }
+
+    if ((index < receiver->page_count) && (receiver->pages[index].header.sequence == page->header.sequence))
+    {
+        if (page->header.samples >= receiver->pages[index].header.samples)
+        {
+            receiver->pages[index] = *page;
+        }
+        return;
+    }
+
+    if (receiver->page_count == receiver->page_capacity)
+    {
+        receiver->page_capacity = (receiver->page_capacity == 0U) ? 64U : (receiver->page_capacity * 2U);
+        receiver->pages = realloc(receiver->pages, receiver->page_capacity * sizeof(receiver->pages[0]));
+        if (receiver->pages == NULL)
+        {
+            perror("realloc");
+            exit(2);
+        }
+    }
+    memmove(&receiver->pages[index + 1U], &receiver->pages[index],
+            (receiver->page_count - index) * sizeof(receiver->pages[0]));
+    receiver->pages[index] = *page;
+    receiver->page_count++;
+}
+
+/*******************************************************************************
+ * Function Name: on_history_frame
+ *******************************************************************************
+ * Summary:
+ *   Decoder callback for the history export frames. Checks the order of the
+ *   page frames and the page contents and keeps the pages.
+ *
+ * Parameters:
+ *   callback_arg: receiver state
+ *   frame: decoded frame
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+static void on_history_frame(void *callback_arg, const pasco2_telemetry_history_frame_t *frame)
+{
+    receiver_t *receiver = callback_arg;
+
+    if (frame->type == PASCO2_TELEMETRY_TYPE_HISTORY_START)
+    {
+        receiver->started = true;
+        receiver->ended = false;
+        receiver->broken = false;
+        receiver->next_index = 0U;
+        receiver->attempt_pages = 0U;
+        receiver->attempt_samples = 0U;
+        receiver->start = frame->start;
+        receiver->resume = frame->start.sequence;
+        receiver->start_position =
+            receiver->position - PASCO2_TELEMETRY_ENCODED_SIZE(PASCO2_TELEMETRY_HISTORY_START_SIZE);
+        receiver->pages_position = receiver->position;
+        (void)clock_gettime(CLOCK_REALTIME, &receiver->start_wall);
+        return;
+    }
+
+    if (!receiver->started || receiver->ended)
+    {
+        return;
+    }
+
+    if (frame->type == PASCO2_TELEMETRY_TYPE_HISTORY_END)
+    {
+        receiver->ended = true;
+        receiver->end = frame->end;
+        /* The device times the export up to the end frame */
+        receiver->wire_bytes += receiver->pages_position - receiver->start_position;
+        receiver->device_ms += frame->end.duration_ms;
+        if (frame->end.status != PASCO2_TELEMETRY_HISTORY_COMPLETE)
+        {
+            receiver->read_errors++;
+            receiver->broken = true;
+        }
+        else if ((frame->end.pages != receiver->next_index) ||
+                 (!receiver->broken && ((frame->end.pages != receiver->attempt_pages) ||
+                                        (frame->end.samples != receiver->attempt_samples))))
+        {
+            /* Frames lost at the end of the export */
+            receiver->count_mismatches++;
+            receiver->broken = true;
+        }
+        return;
+    }
+
+    const pasco2_telemetry_history_page_t *chunk = &frame->page;
+    pasco2_history_page_t page;
+    pasco2_history_record_t first;
+    pasco2_history_record_t last;
+
+    memset(&page, 0, sizeof(page));
+    page.header.sequence = chunk->sequence;
+    page.header.period_s = chunk->period_s;
+    page.header.samples = chunk->samples;
+    page.header.nibbles = chunk->nibbles;
+    memcpy(page.payload, chunk->payload, (chunk->nibbles + 1U) / 2U);
+
+    if (chunk->index != receiver->next_index)
+    {
+        receiver->lost_frames += (uint16_t)(chunk->index - receiver->next_index);
+        receiver->broken = true;
+    }
+    receiver->next_index = (uint16_t)(chunk->index + 1U);
+    receiver->pages_position = receiver->position;
+
+    if ((chunk->period_s == 0U) || !pasco2_history_page_span(&page, &first, &last))
+    {
+        receiver->malformed_pages++;
+        receiver->broken = true;
+        return;
+    }
+
+    /* Until the first break, the transfer is complete up to this page */
+    if (!receiver->broken)
+    {
+        receiver->resume = chunk->sequence + 1U;
+        receiver->attempt_pages++;
+        receiver->attempt_samples += chunk->samples;
+    }
+    receiver->payload_bytes += (chunk->nibbles + 1U) / 2U;
+    store_page(receiver, &page);
+}
+
+/*******************************************************************************
+ * Function Name: feed
+ *******************************************************************************
+ * Summary:
+ *   Feeds received bytes into the decoder one at a time, so that the frame
+ *   callbacks see the exact stream position.
+ *
+ * Parameters:
+ *   decoder: decoder
+ *   receiver: receiver state
+ *   data: received bytes
+ *   size: number of bytes
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+static void feed(pasco2_telemetry_decoder_t *decoder, receiver_t *receiver, const uint8_t *data, size_t size)
+{
+    for (size_t i = 0U; i < size; i++)
+    {
+        receiver->position++;
+        pasco2_telemetry_decoder_feed(decoder, &data[i], 1U);
+    }
+}
+
+/*******************************************************************************
+ * Function Name: baud_constant
+ *******************************************************************************
+ * Summary:
+ *   Maps a baud rate to its termios constant.
+ *
+ * Parameters:
+ *   baud: baud rate
+ *
+ * Return:
+ *   termios constant, B0 if the rate is not supported
+ ******************************************************************************/
+static speed_t baud_constant(unsigned long baud)
+{
+    switch (baud)
+    {
+        case 9600UL:    return B9600;
+        case 19200UL:   return B19200;
+        case 38400UL:   return B38400;
+        case 57600UL:   return B57600;
+        case 115200UL:  return B115200;
+        case 230400UL:  return B230400;
+        case 460800UL:  return B460800;
+        case 921600UL:  return B921600;
+        case 1000000UL: return B1000000;
+        default:        return B0;
+    }
+}
+
+/*******************************************************************************
+ * Function Name: open_device
+ *******************************************************************************
+ * Summary:
+ *   Opens a serial device in raw mode.
+ *
+ * Parameters:
+ *   path: device path
+ *   baud: baud rate
+ *
+ * Return:
+ *   file descriptor, -1 on errors
+ ******************************************************************************/
+static int open_device(const char *path, unsigned long baud)
+{
+    struct termios tio;
+    int fd = open(path, O_RDWR | O_NOCTTY);
+
+    if (fd < 0)
+    {
+        perror(path);
+        return -1;
+    }
+    if (tcgetattr(fd, &tio) != 0)
+    {
+        perror(path);
+        (void)close(fd);
+        return -1;
+    }
+    cfmakeraw(&tio);
+    tio.c_cflag |= CLOCAL | CREAD;
+    tio.c_cc[VMIN] = 0;
+    tio.c_cc[VTIME] = 0;
+    if ((cfsetspeed(&tio, baud_constant(baud)) != 0) || (tcsetattr(fd, TCSANOW, &tio) != 0))
+    {
+        perror(path);
+        (void)close(fd);
+        return -1;
+    }
+
+    return fd;
+}
+
+/*******************************************************************************
+ * Function Name: request_export
+ *******************************************************************************
+ * Summary:
+ *   Sends the export command and the request line to the terminal UI.
+ *
+ * Parameters:
+ *   fd: serial device
+ *   receiver: receiver state with the range and the first page
+ *
+ * Return:
+ *   true if the request was sent
+ ******************************************************************************/
+static bool request_export(int fd, const receiver_t *receiver)
+{
+    char line[96];
+    int length = snprintf(line, sizeof(line), "%u:%lu-%u:%lu@%lu\r",
+                          (unsigned int)receiver->from.boot, (unsigned long)receiver->from.time_s,
+                          (unsigned int)receiver->to.boot, (unsigned long)receiver->to.time_s,
+                          (unsigned long)receiver->resume);
+
+    (void)tcflush(fd, TCIFLUSH);
+    if (write(fd, "x", 1U) != 1)
+    {
+        return false;
+    }
+    (void)usleep(PROMPT_DELAY_US);
+
+    return write(fd, line, (size_t)length) == length;
+}
+
+/*******************************************************************************
+ * Function Name: receive_attempt
+ *******************************************************************************
+ * Summary:
+ *   Reads from the device until the end frame arrives or the line stays idle.
+ *
+ * Parameters:
+ *   fd: serial device
+ *   decoder: decoder
+ *   receiver: receiver state
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+static void receive_attempt(int fd, pasco2_telemetry_decoder_t *decoder, receiver_t *receiver)
+{
+    uint8_t chunk[READ_CHUNK_SIZE];
+    struct pollfd pfd = { .fd = fd, .events = POLLIN };
+
+    while (!receiver->ended && (poll(&pfd, 1U, IDLE_TIMEOUT_MS) > 0))
+    {
+        ssize_t size = read(fd, chunk, sizeof(chunk));
+        if (size < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            perror("read");
+            break;
+        }
+        feed(decoder, receiver, chunk, (size_t)size);
+    }
+}
+
+/*******************************************************************************
+ * Function Name: print_samples
+ *******************************************************************************
+ * Summary:
+ *   Decodes the received pages and prints the samples within the requested
+ *   range as CSV lines. Samples of the start-up the export was made in get
+ *   their host time, if it is known.
+ *
+ * Parameters:
+ *   receiver: receiver state
+ *   out: output stream, NULL to only count and check
+ *   live: true if the start frame was received live from a device
+ *   disorder: destination of the number of samples out of order
+ *
+ * Return:
+ *   number of samples within the range
+ ******************************************************************************/
+static uint32_t print_samples(const receiver_t *receiver, FILE *out, bool live, uint32_t *disorder)
+{
+    pasco2_history_record_t previous = { 0U };
+    uint32_t count = 0U;
+    bool first = true;
+
+    *disorder = 0U;
+    if (out != NULL)
+    {
+        fprintf(out, "boot,time_s,ppm,unix_time\n");
+    }
+
+    for (uint32_t p = 0U; p < receiver->page_count; p++)
+    {
+        pasco2_history_cursor_t cursor;
+        pasco2_history_record_t record;
+
+        pasco2_history_cursor_init(&cursor, &receiver->pages[p]);
+        while (pasco2_history_cursor_next(&cursor, &record))
+        {
+            if ((pasco2_history_record_compare(&record, &receiver->from) < 0) ||
+                (pasco2_history_record_compare(&record, &receiver->to) > 0))
+            {
+                continue;
+            }
+            if (!first && (pasco2_history_record_compare(&record, &previous) <= 0))
+            {
+                (*disorder)++;
+            }
+            previous = record;
+            first = false;
+            count++;
+
+            if (out == NULL)
+            {
+                continue;
+            }
+            fprintf(out, "%u,%lu,%u,", (unsigned int)record.boot, (unsigned long)record.time_s,
+                    (unsigned int)record.ppm);
+            if (live && receiver->started && (record.boot == receiver->start.boot))
+            {
+                fprintf(out, "%lld", (long long)receiver->start_wall.tv_sec - (long long)receiver->start.uptime_s +
+                                     (long long)record.time_s);
+            }
+            fputc('\n', out);
+        }
+    }
+
+    return count;
+}
+
+/*******************************************************************************
+ * Function Name: main
+ *******************************************************************************
+ * Summary:
+ *   Runs the export on a device, resuming it until it is complete, or
+ *   decodes a captured stream, and prints the samples and the summary.
+ *
+ * Parameters:
+ *   argc: number of arguments
+ *   argv: arguments
+ *
+ * Return:
+ *   0 if the export is complete and intact, 1 otherwise, 2 on usage errors
+ ******************************************************************************/
+int main(int argc, char *argv[])
+{
+    static receiver_t receiver;
+    unsigned long baud = DEFAULT_BAUD;
+    uint32_t max_attempts = DEFAULT_ATTEMPTS;
+    bool quiet = false;
+    const char *path = NULL;
+
+    receiver.from = (pasco2_history_record_t){ .boot = 0U, .time_s = 0U };
+    receiver.to = (pasco2_history_record_t){ .boot = UINT16_MAX, .time_s = UINT32_MAX };
+
+    for (int i = 1; i < argc; i++)
+    {
+        bool valid = true;
+
+        if ((strcmp(argv[i], "-b") == 0) && ((i + 1) < argc))
+        {
+            baud = strtoul(argv[++i], NULL, 10);
+            valid = baud_constant(baud) != B0;
+        }
+        else if ((strcmp(argv[i], "-f") == 0) && ((i + 1) < argc))
+        {
+            valid = parse_time(argv[++i], 0U, &receiver.from);
+        }
+        else if ((strcmp(argv[i], "-t") == 0) && ((i + 1) < argc))
+        {
+            valid = parse_time(argv[++i], UINT32_MAX, &receiver.to);
+        }
+        else if ((strcmp(argv[i], "-r") == 0) && ((i + 1) < argc))
+        {
+            receiver.resume = (uint32_t)strtoul(argv[++i], NULL, 10);
+        }
+        else if ((strcmp(argv[i], "-n") == 0) && ((i + 1) < argc))
+        {
+            max_attempts = (uint32_t)strtoul(argv[++i], NULL, 10);
+            valid = max_attempts > 0U;
+        }
+        else if (strcmp(argv[i], "-q") == 0)
+        {
+            quiet = true;
+        }
+        else if ((path == NULL) && (argv[i][0] != '-'))
+        {
+            path = argv[i];
+        }
+        else
+        {
+            valid = false;
+        }
+
+        if (!valid)
+        {
+            fprintf(stderr, "usage: %s [-b baud] [-f boot[:s]] [-t boot[:s]] [-r page] [-n attempts] [-q] "
+                    "device|file\n", argv[0]);
+            return 2;
+        }
+    }
+    if (path == NULL)
+    {
+        fprintf(stderr, "usage: %s [-b baud] [-f boot[:s]] [-t boot[:s]] [-r page] [-n attempts] [-q] "
+                "device|file\n", argv[0]);
+        return 2;
+    }
+
+    struct stat info;
+    if (stat(path, &info) != 0)
+    {
+        perror(path);
+        return 2;
+    }
+    bool live = S_ISCHR(info.st_mode);
+
+    pasco2_telemetry_decoder_t decoder;
+    pasco2_telemetry_decoder_init(&decoder, NULL, NULL, &receiver);
+    pasco2_telemetry_decoder_set_history_callback(&decoder, on_history_frame);
+
+    struct timespec begin;
+    struct timespec finish;
+    (void)clock_gettime(CLOCK_MONOTONIC, &begin);
+
+    if (live)
+    {
+        int fd = open_device(path, baud);
+        if (fd < 0)
+        {
+            return 2;
+        }
+
+        do
+        {
+            receiver.attempts++;
+            receiver.started = false;
+            receiver.ended = false;
+            if (!request_export(fd, &receiver))
+            {
+                perror(path);
+                break;
+            }
+            receive_attempt(fd, &decoder, &receiver);
+            if (receiver.attempts > 1U)
+            {
+                fprintf(stderr, "attempt %lu resumed at page %lu\n", (unsigned long)receiver.attempts,
+                        (unsigned long)receiver.start.sequence);
+            }
+        } while ((!receiver.ended || receiver.broken) && (receiver.attempts < max_attempts));
+        (void)close(fd);
+    }
+    else
+    {
+        /* A capture holds one attempt, a break is reported with its resume point */
+        FILE *in = fopen(path, "rb");
+        static uint8_t chunk[READ_CHUNK_SIZE];
+        size_t size;
+
+        if (in == NULL)
+        {
+            perror(path);
+            return 2;
+        }
+        receiver.attempts = 1U;
+        while ((size = fread(chunk, 1U, sizeof(chunk), in)) > 0U)
+        {
+            feed(&decoder, &receiver, chunk, size);
+        }
+        (void)fclose(in);
+    }
+    (void)clock_gettime(CLOCK_MONOTONIC, &finish);
+
+    uint32_t disorder;
+    uint32_t samples = print_samples(&receiver, quiet ? NULL : stdout, live, &disorder);
+    bool complete = receiver.started && receiver.ended && !receiver.broken;
+    bool intact = (receiver.malformed_pages == 0U) && (disorder == 0U);
+
+    unsigned long long sent = 0U;
+    for (uint32_t p = 0U; p < receiver.page_count; p++)
+    {
+        sent += receiver.pages[p].header.samples;
+    }
+    fprintf(stderr, "export: %lu attempts, %lu pages, %llu samples, %lu within the range\n",
+            (unsigned long)receiver.attempts, (unsigned long)receiver.page_count, sent, (unsigned long)samples);
+    fprintf(stderr, "integrity: crc errors %lu, lost page frames %lu, malformed pages %lu, count mismatches %lu, "
+            "read errors %lu, samples out of order %lu\n",
+            (unsigned long)decoder.stats.crc_errors, (unsigned long)receiver.lost_frames,
+            (unsigned long)receiver.malformed_pages, (unsigned long)receiver.count_mismatches,
+            (unsigned long)receiver.read_errors, (unsigned long)disorder);
+
+    if (receiver.device_ms > 0U)
+    {
+        double seconds = (double)receiver.device_ms / 1000.0;
+        double line_bytes = ((double)baud / UART_BITS_PER_CHAR) * seconds;
+        fprintf(stderr, "throughput: %llu bytes in %.3f s, %.0f bytes/s, %.0f samples/s, %.1f%% of the line "
+                "at %lu baud, %.1f%% payload\n",
+                receiver.wire_bytes, seconds, (double)receiver.wire_bytes / seconds, (double)sent / seconds,
+                (100.0 * (double)receiver.wire_bytes) / line_bytes, baud,
+                (100.0 * (double)receiver.payload_bytes) / (double)receiver.wire_bytes);
+    }
+    if (live)
+    {
+        double seconds = (double)(finish.tv_sec - begin.tv_sec) + ((double)(finish.tv_nsec - begin.tv_nsec) / 1e9);
+        fprintf(stderr, "host time %.3f s including the requests\n", seconds);
+    }
+
+    if (complete && intact)
+    {
+        fprintf(stderr, "export complete, last page %lu\n", (unsigned long)receiver.end.last_sequence);
+        return 0;
+    }
+    fprintf(stderr, "export %s, resume with -r %lu\n", intact ? "incomplete" : "corrupt",
+            (unsigned long)receiver.resume);
+    return 1;
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,54 @@
+/******************************************************************************
+** File name: cy_pdl.h
+**
+** Description: Host simulation stand-in for the peripheral driver library.
+**
+** ===========================================================================
+** Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+** ===========================================================================
+**
+** ===========================================================================
+** Infineon Technologies AG (INFINEON) is supplying this file for use
+** exclusively with Infineon's sensor products. This file can be freely
+** distributed within development tools and software supporting such
+** products.
+**
+** THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+** OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+** MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+** INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+** WHATSOEVER.
+** ===========================================================================
+*/
+
+#pragma once
+
+/* Header file includes */
+#include "cy_utils.h"
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+/* Interrupts are delivered by the simulation scheduler */
+#define __enable_irq()          ((void)0)
+#define __disable_irq()         ((void)0)
+
+/* Memory barriers order the host's stores as well */
+#define __DMB()                 __sync_synchronize()
+#define __DSB()                 __sync_synchronize()
+
+/* Work flash of the PSoC 62, used as emulated EEPROM */
+#define CY_EM_EEPROM_BASE       (0x14000000UL)
+#define CY_EM_EEPROM_SIZE       (0x00008000UL)
+#define CY_FLASH_SIZEOF_ROW     (512UL)
+
+/* Count leading zeros, the argument must not be zero */
+#define __CLZ(value)            ((uint8_t)__builtin_clz(value))
+
+/*******************************************************************************
+ * Global Variables
+ ******************************************************************************/
+extern uint32_t SystemCoreClock;
+
+/* [] END OF FILE */
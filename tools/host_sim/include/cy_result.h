@@ -0,0 +1,60 @@
+/******************************************************************************
+** File name: cy_result.h
+**
+** Description: Host simulation stand-in for the result codes of the ModusToolbox
+**   core library.
+**
+** ===========================================================================
+** Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+** ===========================================================================
+**
+** ===========================================================================
+** Infineon Technologies AG (INFINEON) is supplying this file for use
+** exclusively with Infineon's sensor products. This file can be freely
+** distributed within development tools and software supporting such
+** products.
+**
+** THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+** OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+** MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+** INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+** WHATSOEVER.
+** ===========================================================================
+*/
+
+#pragma once
+
+/* Header file from system */
+#include <stdint.h>
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+#define CY_RSLT_SUCCESS                     ((cy_rslt_t)0x00000000U)
+
+#define CY_RSLT_TYPE_INFO                   (0U)
+#define CY_RSLT_TYPE_WARNING                (1U)
+#define CY_RSLT_TYPE_ERROR                  (2U)
+#define CY_RSLT_TYPE_FATAL                  (3U)
+
+#define CY_RSLT_MODULE_DRIVERS_PDL_BASE     (0x0000U)
+#define CY_RSLT_MODULE_ABSTRACTION_HAL      (0x0100U)
+#define CY_RSLT_MODULE_ABSTRACTION_BSP      (0x0180U)
+#define CY_RSLT_MODULE_ABSTRACTION_OS       (0x0183U)
+#define CY_RSLT_MODULE_MIDDLEWARE_BASE      (0x0200U)
+
+#define CY_RSLT_CREATE(type, module, code) \
+    ((cy_rslt_t)((((uint32_t)(module) & 0x3FFFU) << 16) | ((uint32_t)(code) & 0xFFFFU) | \
+                 (((uint32_t)(type) & 0x3U) << 30)))
+
+#define CY_RSLT_GET_TYPE(x)                 (((x) >> 30) & 0x3U)
+#define CY_RSLT_GET_MODULE(x)               (((x) >> 16) & 0x3FFFU)
+#define CY_RSLT_GET_CODE(x)                 ((x) & 0xFFFFU)
+
+/*******************************************************************************
+ * Types
+ ******************************************************************************/
+typedef uint32_t cy_rslt_t;
+
+/* [] END OF FILE */
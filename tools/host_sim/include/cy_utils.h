@@ -0,0 +1,60 @@
+/******************************************************************************
+** File name: cy_utils.h
+**
+** Description: Host simulation stand-in for the utility macros of the
+**   ModusToolbox core library.
+**
+** ===========================================================================
+** Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+** ===========================================================================
+**
+** ===========================================================================
+** Infineon Technologies AG (INFINEON) is supplying this file for use
+** exclusively with Infineon's sensor products. This file can be freely
+** distributed within development tools and software supporting such
+** products.
+**
+** THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+** OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+** MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+** INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+** WHATSOEVER.
+** ===========================================================================
+*/
+
+#pragma once
+
+/* Header file from system */
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+/* Header file includes */
+#include "cy_result.h"
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+#define CY_UNUSED_PARAMETER(x)  ((void)(x))
+#define CY_HALT()               abort()
+
+/* Assertions stop the simulation with the location of the failed check */
+#define CY_ASSERT(x) \
+    do { if (!(x)) { pasco2_sim_assert_failed(__FILE__, __LINE__); } } while (false)
+
+#define CY_SRAM_SIZE            (0x000FF800UL)
+
+/*******************************************************************************
+ * Types
+ ******************************************************************************/
+typedef float float32_t;
+typedef double float64_t;
+
+/*******************************************************************************
+ * Functions
+ ******************************************************************************/
+void pasco2_sim_assert_failed(const char *file, int line) __attribute__((noreturn));
+
+/* [] END OF FILE */
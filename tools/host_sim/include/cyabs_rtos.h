@@ -0,0 +1,79 @@
+/******************************************************************************
+** File name: cyabs_rtos.h
+**
+** Description: Host simulation stand-in for the RTOS abstraction layer on top of
+**   the simulated FreeRTOS kernel.
+**
+** ===========================================================================
+** Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+** ===========================================================================
+**
+** ===========================================================================
+** Infineon Technologies AG (INFINEON) is supplying this file for use
+** exclusively with Infineon's sensor products. This file can be freely
+** distributed within development tools and software supporting such
+** products.
+**
+** THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+** OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+** MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+** INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+** WHATSOEVER.
+** ===========================================================================
+*/
+
+#pragma once
+
+/* Header file includes */
+#include "cy_result.h"
+#include "FreeRTOS.h"
+#include "task.h"
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+#define CY_RTOS_NEVER_TIMEOUT       ((cy_time_t)0xFFFFFFFFUL)
+
+#define CY_RTOS_NO_MEMORY           CY_RSLT_CREATE(CY_RSLT_TYPE_ERROR, CY_RSLT_MODULE_ABSTRACTION_OS, 0U)
+#define CY_RTOS_GENERAL_ERROR       CY_RSLT_CREATE(CY_RSLT_TYPE_ERROR, CY_RSLT_MODULE_ABSTRACTION_OS, 1U)
+#define CY_RTOS_BAD_PARAM           CY_RSLT_CREATE(CY_RSLT_TYPE_ERROR, CY_RSLT_MODULE_ABSTRACTION_OS, 2U)
+#define CY_RTOS_TIMEOUT             CY_RSLT_CREATE(CY_RSLT_TYPE_ERROR, CY_RSLT_MODULE_ABSTRACTION_OS, 3U)
+
+/*******************************************************************************
+ * Types
+ ******************************************************************************/
+typedef enum
+{
+    CY_RTOS_PRIORITY_MIN         = 0,
+    CY_RTOS_PRIORITY_LOW         = (configMAX_PRIORITIES * 1 / 7),
+    CY_RTOS_PRIORITY_BELOWNORMAL = (configMAX_PRIORITIES * 2 / 7),
+    CY_RTOS_PRIORITY_NORMAL      = (configMAX_PRIORITIES * 3 / 7),
+    CY_RTOS_PRIORITY_ABOVENORMAL = (configMAX_PRIORITIES * 4 / 7),
+    CY_RTOS_PRIORITY_HIGH        = (configMAX_PRIORITIES * 5 / 7),
+    CY_RTOS_PRIORITY_REALTIME    = (configMAX_PRIORITIES * 6 / 7),
+    CY_RTOS_PRIORITY_MAX         = (configMAX_PRIORITIES - 1)
+} cy_thread_priority_t;
+
+typedef TaskHandle_t cy_thread_t;
+typedef void *cy_thread_arg_t;
+typedef void (*cy_thread_entry_fn_t)(cy_thread_arg_t arg);
+typedef uint32_t cy_time_t;
+typedef struct pasco2_sim_semaphore *cy_semaphore_t;
+
+/*******************************************************************************
+ * Functions
+ ******************************************************************************/
+cy_rslt_t cy_rtos_create_thread(cy_thread_t *thread, cy_thread_entry_fn_t entry_function, const char *name,
+                                void *stack, uint32_t stack_size, cy_thread_priority_t priority,
+                                cy_thread_arg_t arg);
+cy_rslt_t cy_rtos_exit_thread(void);
+cy_rslt_t cy_rtos_get_thread_handle(cy_thread_t *thread);
+cy_rslt_t cy_rtos_delay_milliseconds(cy_time_t num_ms);
+cy_rslt_t cy_rtos_get_time(cy_time_t *tval);
+cy_rslt_t cy_rtos_init_semaphore(cy_semaphore_t *semaphore, uint32_t maxcount, uint32_t initcount);
+cy_rslt_t cy_rtos_get_semaphore(cy_semaphore_t *semaphore, cy_time_t timeout_ms, bool in_isr);
+cy_rslt_t cy_rtos_set_semaphore(cy_semaphore_t *semaphore, bool in_isr);
+cy_rslt_t cy_rtos_deinit_semaphore(cy_semaphore_t *semaphore);
+
+/* [] END OF FILE */
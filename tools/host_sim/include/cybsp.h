@@ -0,0 +1,64 @@
+/******************************************************************************
+** File name: cybsp.h
+**
+** Description: Host simulation stand-in for the board support package. Provides
+**   the pins of the CYSBSYSKIT-DEV-01 kit or, without CYSBSYSKIT_DEV_01, the
+**   CY8CKIT-062S2-43012 kit.
+**
+** ===========================================================================
+** Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+** ===========================================================================
+**
+** ===========================================================================
+** Infineon Technologies AG (INFINEON) is supplying this file for use
+** exclusively with Infineon's sensor products. This file can be freely
+** distributed within development tools and software supporting such
+** products.
+**
+** THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+** OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+** MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+** INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+** WHATSOEVER.
+** ===========================================================================
+*/
+
+#pragma once
+
+/* Header file includes */
+#include "cyhal.h"
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+#define CYBSP_LED_STATE_ON          (0U)
+#define CYBSP_LED_STATE_OFF         (1U)
+
+#define CYBSP_I2C_SCL               (P6_0)
+#define CYBSP_I2C_SDA               (P6_1)
+#define CYBSP_DEBUG_UART_RX         (CYHAL_GET_GPIO(5U, 0U))
+#define CYBSP_DEBUG_UART_TX         (CYHAL_GET_GPIO(5U, 1U))
+
+#if defined(CYSBSYSKIT_DEV_01)
+#define CYBSP_USER_LED              (P11_1)
+#define CYBSP_USER_LED2             (P11_1)
+#else
+#define CYBSP_USER_LED              (CYHAL_GET_GPIO(1U, 5U))
+#define CYBSP_USER_LED2             (P9_0)
+#endif
+
+#define CYBSP_LED_RGB_RED           (CYHAL_GET_GPIO(1U, 1U))
+#define CYBSP_LED_RGB_GREEN         (CYHAL_GET_GPIO(0U, 5U))
+#define CYBSP_LED_RGB_BLUE          (CYHAL_GET_GPIO(7U, 3U))
+
+/* Arduino header pins */
+#define CYBSP_D9                    (CYHAL_GET_GPIO(12U, 6U))
+#define CYBSP_A3                    (CYHAL_GET_GPIO(10U, 3U))
+
+/*******************************************************************************
+ * Functions
+ ******************************************************************************/
+cy_rslt_t cybsp_init(void);
+
+/* [] END OF FILE */
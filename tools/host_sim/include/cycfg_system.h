@@ -0,0 +1,37 @@
+/******************************************************************************
+** File name: cycfg_system.h
+**
+** Description: Host simulation stand-in for the generated system configuration.
+**   Mirrors the System Deep Sleep idle mode of the BSP.
+**
+** ===========================================================================
+** Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+** ===========================================================================
+**
+** ===========================================================================
+** Infineon Technologies AG (INFINEON) is supplying this file for use
+** exclusively with Infineon's sensor products. This file can be freely
+** distributed within development tools and software supporting such
+** products.
+**
+** THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+** OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+** MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+** INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+** WHATSOEVER.
+** ===========================================================================
+*/
+
+#pragma once
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+#define CY_CFG_PWR_MODE_ACTIVE          (0x04UL)
+#define CY_CFG_PWR_MODE_SLEEP           (0x08UL)
+#define CY_CFG_PWR_MODE_DEEPSLEEP       (0x10UL)
+#define CY_CFG_PWR_SYS_IDLE_MODE        CY_CFG_PWR_MODE_DEEPSLEEP
+#define CY_CFG_PWR_DEEPSLEEP_LATENCY    (0UL)
+
+/* [] END OF FILE */
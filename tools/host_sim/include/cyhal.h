@@ -0,0 +1,298 @@
+/******************************************************************************
+** File name: cyhal.h
+**
+** Description: Host simulation stand-in for the subset of the PSoC 6 hardware
+**   abstraction layer used by the application. The peripherals are modelled
+**   in pasco2_sim_hal.c on the virtual time of the simulation.
+**
+** ===========================================================================
+** Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+** ===========================================================================
+**
+** ===========================================================================
+** Infineon Technologies AG (INFINEON) is supplying this file for use
+** exclusively with Infineon's sensor products. This file can be freely
+** distributed within development tools and software supporting such
+** products.
+**
+** THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+** OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+** MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+** INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+** WHATSOEVER.
+** ===========================================================================
+*/
+
+#pragma once
+
+/* Header file from system */
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/* Header file includes */
+#include "cy_pdl.h"
+#include "cy_result.h"
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+#define CYHAL_GET_GPIO(port, pin)   ((cyhal_gpio_t)((((uint32_t)(port)) << 3U) | (uint32_t)(pin)))
+#define CYHAL_GET_PORT(pin)         ((uint8_t)((uint32_t)(pin) >> 3U))
+#define CYHAL_GET_PIN(pin)          ((uint8_t)((uint32_t)(pin) & 0x07U))
+/* Ports 0 to 15 of the PSoC 6, and ports 16 to 19 for the INT lines of the
+ * simulated sensor nodes */
+#define CYHAL_GPIO_COUNT            (160U)
+#define NC                          ((cyhal_gpio_t)0xFFU)
+
+#define CYHAL_ISR_PRIORITY_DEFAULT  (7U)
+
+/* Result codes of the simulated peripherals */
+#define CYHAL_RSLT_ERR_BAD_ARGUMENT \
+    CY_RSLT_CREATE(CY_RSLT_TYPE_ERROR, CY_RSLT_MODULE_ABSTRACTION_HAL, 0x0001U)
+#define CYHAL_I2C_RSLT_ERR_NACK \
+    CY_RSLT_CREATE(CY_RSLT_TYPE_ERROR, CY_RSLT_MODULE_ABSTRACTION_HAL, 0x0101U)
+#define CYHAL_I2C_RSLT_ERR_BUS_BUSY \
+    CY_RSLT_CREATE(CY_RSLT_TYPE_ERROR, CY_RSLT_MODULE_ABSTRACTION_HAL, 0x0102U)
+#define CYHAL_UART_RSLT_ERR_TIMEOUT \
+    CY_RSLT_CREATE(CY_RSLT_TYPE_ERROR, CY_RSLT_MODULE_ABSTRACTION_HAL, 0x0201U)
+#define CYHAL_FLASH_RSLT_ERR_ADDRESS \
+    CY_RSLT_CREATE(CY_RSLT_TYPE_ERROR, CY_RSLT_MODULE_ABSTRACTION_HAL, 0x0301U)
+#define CYHAL_FLASH_RSLT_ERR_POWER \
+    CY_RSLT_CREATE(CY_RSLT_TYPE_ERROR, CY_RSLT_MODULE_ABSTRACTION_HAL, 0x0302U)
+
+/* Pin names of the ports used by the supported kits */
+#define P5_3                        CYHAL_GET_GPIO(5U, 3U)
+#define P6_0                        CYHAL_GET_GPIO(6U, 0U)
+#define P6_1                        CYHAL_GET_GPIO(6U, 1U)
+#define P9_0                        CYHAL_GET_GPIO(9U, 0U)
+#define P9_1                        CYHAL_GET_GPIO(9U, 1U)
+#define P10_5                       CYHAL_GET_GPIO(10U, 5U)
+#define P11_1                       CYHAL_GET_GPIO(11U, 1U)
+
+/*******************************************************************************
+ * Types
+ ******************************************************************************/
+typedef uint32_t cyhal_gpio_t;
+
+/* GPIO */
+typedef enum
+{
+    CYHAL_GPIO_DIR_INPUT,
+    CYHAL_GPIO_DIR_OUTPUT,
+    CYHAL_GPIO_DIR_BIDIRECTIONAL
+} cyhal_gpio_direction_t;
+
+typedef enum
+{
+    CYHAL_GPIO_DRIVE_NONE,
+    CYHAL_GPIO_DRIVE_ANALOG,
+    CYHAL_GPIO_DRIVE_PULLUP,
+    CYHAL_GPIO_DRIVE_PULLDOWN,
+    CYHAL_GPIO_DRIVE_OPENDRAINDRIVESLOW,
+    CYHAL_GPIO_DRIVE_OPENDRAINDRIVESHIGH,
+    CYHAL_GPIO_DRIVE_STRONG,
+    CYHAL_GPIO_DRIVE_PULLUPDOWN,
+    CYHAL_GPIO_DRIVE_PULL_NONE
+} cyhal_gpio_drive_mode_t;
+
+typedef enum
+{
+    CYHAL_GPIO_IRQ_NONE = 0,
+    CYHAL_GPIO_IRQ_RISE = 1,
+    CYHAL_GPIO_IRQ_FALL = 2,
+    CYHAL_GPIO_IRQ_BOTH = 3
+} cyhal_gpio_event_t;
+
+typedef void (*cyhal_gpio_event_callback_t)(void *callback_arg, cyhal_gpio_event_t event);
+
+typedef struct cyhal_gpio_callback_data_s
+{
+    cyhal_gpio_event_callback_t callback;
+    void *callback_arg;
+    struct cyhal_gpio_callback_data_s *next;
+    cyhal_gpio_t pin;
+} cyhal_gpio_callback_data_t;
+
+/* I2C */
+typedef enum
+{
+    CYHAL_I2C_MODE_SLAVE,
+    CYHAL_I2C_MODE_MASTER
+} cyhal_i2c_mode_t;
+
+typedef struct
+{
+    cyhal_i2c_mode_t is_slave;
+    uint16_t address;
+    uint32_t frequencyhal_hz;
+} cyhal_i2c_cfg_t;
+
+typedef enum
+{
+    CYHAL_I2C_EVENT_NONE            = 0,
+    CYHAL_I2C_MASTER_WR_CMPLT_EVENT = 1 << 16,
+    CYHAL_I2C_MASTER_RD_CMPLT_EVENT = 1 << 17,
+    CYHAL_I2C_MASTER_ERR_EVENT      = 1 << 18
+} cyhal_i2c_event_t;
+
+typedef void (*cyhal_i2c_event_callback_t)(void *callback_arg, cyhal_i2c_event_t event);
+
+typedef struct
+{
+    struct pasco2_sim_i2c_bus *sim;
+} cyhal_i2c_t;
+
+/* UART */
+typedef enum
+{
+    CYHAL_UART_IRQ_NONE                 = 0,
+    CYHAL_UART_IRQ_TX_TRANSMIT_IN_FIFO  = 1 << 1,
+    CYHAL_UART_IRQ_TX_DONE              = 1 << 2,
+    CYHAL_UART_IRQ_TX_EMPTY             = 1 << 5,
+    CYHAL_UART_IRQ_TX_FIFO              = 1 << 6,
+    CYHAL_UART_IRQ_RX_NOT_EMPTY         = 1 << 8,
+    CYHAL_UART_IRQ_RX_FIFO              = 1 << 9
+} cyhal_uart_event_t;
+
+typedef void (*cyhal_uart_event_callback_t)(void *callback_arg, cyhal_uart_event_t event);
+
+typedef struct
+{
+    struct pasco2_sim_uart *sim;
+} cyhal_uart_t;
+
+/* Transfer engine of asynchronous UART writes */
+typedef enum
+{
+    CYHAL_ASYNC_SW,
+    CYHAL_ASYNC_DMA
+} cyhal_async_mode_t;
+
+#define CYHAL_DMA_PRIORITY_DEFAULT  (3U)
+
+/* Timer */
+typedef enum
+{
+    CYHAL_TIMER_DIR_UP,
+    CYHAL_TIMER_DIR_DOWN,
+    CYHAL_TIMER_DIR_UP_DOWN
+} cyhal_timer_direction_t;
+
+typedef enum
+{
+    CYHAL_TIMER_IRQ_NONE            = 0,
+    CYHAL_TIMER_IRQ_TERMINAL_COUNT  = 1 << 0,
+    CYHAL_TIMER_IRQ_CAPTURE_COMPARE = 1 << 1,
+    CYHAL_TIMER_IRQ_ALL             = (1 << 2) - 1
+} cyhal_timer_event_t;
+
+typedef struct
+{
+    bool is_continuous;
+    cyhal_timer_direction_t direction;
+    bool is_compare;
+    uint32_t period;
+    uint32_t compare_value;
+    uint32_t value;
+} cyhal_timer_cfg_t;
+
+typedef void (*cyhal_timer_event_callback_t)(void *callback_arg, cyhal_timer_event_t event);
+
+typedef struct
+{
+    struct pasco2_sim_timer *sim;
+} cyhal_timer_t;
+
+/* Flash */
+typedef struct
+{
+    uint32_t start_address;
+    uint32_t size;
+    uint32_t sector_size;
+    uint32_t page_size;
+    uint8_t erase_value;
+} cyhal_flash_block_info_t;
+
+typedef struct
+{
+    uint8_t block_count;
+    const cyhal_flash_block_info_t *blocks;
+} cyhal_flash_info_t;
+
+typedef struct
+{
+    bool initialized;
+} cyhal_flash_t;
+
+/*******************************************************************************
+ * Functions
+ ******************************************************************************/
+/* GPIO */
+cy_rslt_t cyhal_gpio_init(cyhal_gpio_t pin, cyhal_gpio_direction_t direction, cyhal_gpio_drive_mode_t drive_mode,
+                          bool init_val);
+void cyhal_gpio_free(cyhal_gpio_t pin);
+void cyhal_gpio_write(cyhal_gpio_t pin, bool value);
+bool cyhal_gpio_read(cyhal_gpio_t pin);
+void cyhal_gpio_toggle(cyhal_gpio_t pin);
+void cyhal_gpio_register_callback(cyhal_gpio_t pin, cyhal_gpio_callback_data_t *callback_data);
+void cyhal_gpio_enable_event(cyhal_gpio_t pin, cyhal_gpio_event_t event, uint8_t intr_priority, bool enable);
+
+/* I2C */
+cy_rslt_t cyhal_i2c_init(cyhal_i2c_t *obj, cyhal_gpio_t sda, cyhal_gpio_t scl, const void *clk);
+void cyhal_i2c_free(cyhal_i2c_t *obj);
+cy_rslt_t cyhal_i2c_configure(cyhal_i2c_t *obj, const cyhal_i2c_cfg_t *cfg);
+cy_rslt_t cyhal_i2c_master_write(cyhal_i2c_t *obj, uint16_t dev_addr, const uint8_t *data, uint16_t size,
+                                 uint32_t timeout, bool send_stop);
+cy_rslt_t cyhal_i2c_master_read(cyhal_i2c_t *obj, uint16_t dev_addr, uint8_t *data, uint16_t size,
+                                uint32_t timeout, bool send_stop);
+cy_rslt_t cyhal_i2c_master_mem_write(cyhal_i2c_t *obj, uint16_t address, uint16_t mem_addr, uint16_t mem_addr_size,
+                                     const uint8_t *data, uint16_t size, uint32_t timeout);
+cy_rslt_t cyhal_i2c_master_mem_read(cyhal_i2c_t *obj, uint16_t address, uint16_t mem_addr, uint16_t mem_addr_size,
+                                    uint8_t *data, uint16_t size, uint32_t timeout);
+cy_rslt_t cyhal_i2c_master_transfer_async(cyhal_i2c_t *obj, uint16_t address, const void *tx, size_t tx_size,
+                                          void *rx, size_t rx_size);
+cy_rslt_t cyhal_i2c_abort_async(cyhal_i2c_t *obj);
+void cyhal_i2c_register_callback(cyhal_i2c_t *obj, cyhal_i2c_event_callback_t callback, void *callback_arg);
+void cyhal_i2c_enable_event(cyhal_i2c_t *obj, cyhal_i2c_event_t event, uint8_t intr_priority, bool enable);
+
+/* UART */
+cy_rslt_t cyhal_uart_getc(cyhal_uart_t *obj, uint8_t *value, uint32_t timeout);
+cy_rslt_t cyhal_uart_putc(cyhal_uart_t *obj, uint32_t value);
+uint32_t cyhal_uart_readable(cyhal_uart_t *obj);
+cy_rslt_t cyhal_uart_read(cyhal_uart_t *obj, void *rx, size_t *rx_length);
+cy_rslt_t cyhal_uart_write(cyhal_uart_t *obj, void *tx, size_t *tx_length);
+cy_rslt_t cyhal_uart_set_async_mode(cyhal_uart_t *obj, cyhal_async_mode_t mode, uint8_t dma_priority);
+cy_rslt_t cyhal_uart_write_async(cyhal_uart_t *obj, void *tx, size_t length);
+bool cyhal_uart_is_tx_active(cyhal_uart_t *obj);
+void cyhal_uart_register_callback(cyhal_uart_t *obj, cyhal_uart_event_callback_t callback, void *callback_arg);
+void cyhal_uart_enable_event(cyhal_uart_t *obj, cyhal_uart_event_t event, uint8_t intr_priority, bool enable);
+
+/* Timer */
+cy_rslt_t cyhal_timer_init(cyhal_timer_t *obj, cyhal_gpio_t pin, const void *clk);
+cy_rslt_t cyhal_timer_configure(cyhal_timer_t *obj, const cyhal_timer_cfg_t *cfg);
+cy_rslt_t cyhal_timer_set_frequency(cyhal_timer_t *obj, uint32_t hz);
+void cyhal_timer_register_callback(cyhal_timer_t *obj, cyhal_timer_event_callback_t callback, void *callback_arg);
+void cyhal_timer_enable_event(cyhal_timer_t *obj, cyhal_timer_event_t event, uint8_t intr_priority, bool enable);
+cy_rslt_t cyhal_timer_start(cyhal_timer_t *obj);
+cy_rslt_t cyhal_timer_stop(cyhal_timer_t *obj);
+
+/* Flash */
+cy_rslt_t cyhal_flash_init(cyhal_flash_t *obj);
+void cyhal_flash_free(cyhal_flash_t *obj);
+void cyhal_flash_get_info(const cyhal_flash_t *obj, cyhal_flash_info_t *info);
+cy_rslt_t cyhal_flash_read(cyhal_flash_t *obj, uint32_t address, uint8_t *data, size_t size);
+cy_rslt_t cyhal_flash_erase(cyhal_flash_t *obj, uint32_t address);
+cy_rslt_t cyhal_flash_write(cyhal_flash_t *obj, uint32_t address, const uint32_t *data);
+cy_rslt_t cyhal_flash_program(cyhal_flash_t *obj, uint32_t address, const uint32_t *data);
+
+/* Power management */
+void cyhal_syspm_lock_deepsleep(void);
+void cyhal_syspm_unlock_deepsleep(void);
+
+/* System */
+cy_rslt_t cyhal_system_delay_ms(uint32_t milliseconds);
+void cyhal_system_delay_us(uint16_t microseconds);
+
+/* [] END OF FILE */
@@ -0,0 +1,55 @@
+/******************************************************************************
+** File name: semphr.h
+**
+** Description: Host simulation stand-in for the FreeRTOS semaphore API. The
+**   semaphores are the counting semaphores of pasco2_sim_kernel.c, which also
+**   back cy_semaphore_t.
+**
+** ===========================================================================
+** Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+** ===========================================================================
+**
+** ===========================================================================
+** Infineon Technologies AG (INFINEON) is supplying this file for use
+** exclusively with Infineon's sensor products. This file can be freely
+** distributed within development tools and software supporting such
+** products.
+**
+** THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+** OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+** MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+** INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+** WHATSOEVER.
+** ===========================================================================
+*/
+
+#pragma once
+
+/* Header file includes */
+#include "FreeRTOS.h"
+
+/*******************************************************************************
+ * Types
+ ******************************************************************************/
+/* Unlike in FreeRTOS, the control block is not opaque */
+struct pasco2_sim_semaphore
+{
+    uint32_t count;
+    uint32_t max_count;
+};
+
+typedef struct pasco2_sim_semaphore StaticSemaphore_t;
+typedef struct pasco2_sim_semaphore *SemaphoreHandle_t;
+
+/*******************************************************************************
+ * Functions
+ ******************************************************************************/
+SemaphoreHandle_t xSemaphoreCreateCountingStatic(UBaseType_t uxMaxCount, UBaseType_t uxInitialCount,
+                                                 StaticSemaphore_t *pxSemaphoreBuffer);
+SemaphoreHandle_t xSemaphoreCreateMutex(void);
+SemaphoreHandle_t xSemaphoreCreateMutexStatic(StaticSemaphore_t *pxMutexBuffer);
+BaseType_t xSemaphoreTake(SemaphoreHandle_t xSemaphore, TickType_t xTicksToWait);
+BaseType_t xSemaphoreGive(SemaphoreHandle_t xSemaphore);
+
+/* [] END OF FILE */
@@ -0,0 +1,59 @@
+/******************************************************************************
+** File name: stream_buffer.h
+**
+** Description: Host simulation stand-in for the FreeRTOS stream buffer API.
+**   The calls are implemented by the deterministic scheduler in
+**   pasco2_sim_kernel.c.
+**
+** ===========================================================================
+** Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+** ===========================================================================
+**
+** ===========================================================================
+** Infineon Technologies AG (INFINEON) is supplying this file for use
+** exclusively with Infineon's sensor products. This file can be freely
+** distributed within development tools and software supporting such
+** products.
+**
+** THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+** OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+** MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+** INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+** WHATSOEVER.
+** ===========================================================================
+*/
+
+#pragma once
+
+/* Header file includes */
+#include "FreeRTOS.h"
+
+/*******************************************************************************
+ * Types
+ ******************************************************************************/
+/* Unlike in FreeRTOS, the control block is not opaque */
+typedef struct
+{
+    uint8_t *storage;
+    size_t size;
+    size_t trigger;
+    size_t head;
+    size_t count;
+} StaticStreamBuffer_t;
+
+typedef StaticStreamBuffer_t *StreamBufferHandle_t;
+
+/*******************************************************************************
+ * Functions
+ ******************************************************************************/
+StreamBufferHandle_t xStreamBufferCreateStatic(size_t xBufferSizeBytes, size_t xTriggerLevelBytes,
+                                               uint8_t *pucStreamBufferStorageArea,
+                                               StaticStreamBuffer_t *pxStaticStreamBuffer);
+size_t xStreamBufferSendFromISR(StreamBufferHandle_t xStreamBuffer, const void *pvTxData, size_t xDataLengthBytes,
+                                BaseType_t *pxHigherPriorityTaskWoken);
+size_t xStreamBufferReceive(StreamBufferHandle_t xStreamBuffer, void *pvRxData, size_t xBufferLengthBytes,
+                            TickType_t xTicksToWait);
+size_t xStreamBufferBytesAvailable(StreamBufferHandle_t xStreamBuffer);
+
+/* [] END OF FILE */
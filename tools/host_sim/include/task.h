@@ -0,0 +1,85 @@
+/******************************************************************************
+** File name: task.h
+**
+** Description: Host simulation stand-in for the FreeRTOS task API. The calls are
+**   implemented by the deterministic scheduler in pasco2_sim_kernel.c.
+**
+** ===========================================================================
+** Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+** ===========================================================================
+**
+** ===========================================================================
+** Infineon Technologies AG (INFINEON) is supplying this file for use
+** exclusively with Infineon's sensor products. This file can be freely
+** distributed within development tools and software supporting such
+** products.
+**
+** THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+** OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+** MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+** INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+** WHATSOEVER.
+** ===========================================================================
+*/
+
+#pragma once
+
+/* Header file includes */
+#include "FreeRTOS.h"
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+/* Only one simulated context runs at a time, interrupts are delivered between
+ * kernel calls, so critical sections need no locking */
+#define taskENTER_CRITICAL()                ((void)0)
+#define taskEXIT_CRITICAL()                 ((void)0)
+#define taskENTER_CRITICAL_FROM_ISR()       (0U)
+#define taskEXIT_CRITICAL_FROM_ISR(x)       ((void)(x))
+#define taskDISABLE_INTERRUPTS()            ((void)0)
+#define taskENABLE_INTERRUPTS()             ((void)0)
+#define taskYIELD()                         vTaskDelay(0U)
+
+/* Scheduler states */
+#define taskSCHEDULER_SUSPENDED             ((BaseType_t)0)
+#define taskSCHEDULER_NOT_STARTED           ((BaseType_t)1)
+#define taskSCHEDULER_RUNNING               ((BaseType_t)2)
+
+/*******************************************************************************
+ * Types
+ ******************************************************************************/
+struct tskTaskControlBlock;
+typedef struct tskTaskControlBlock *TaskHandle_t;
+typedef void (*TaskFunction_t)(void *);
+
+/* Memory of a statically created task. The simulation keeps its own control
+ * block and runs the task on a host stack. */
+typedef struct
+{
+    uint8_t reserved[92];
+} StaticTask_t;
+
+/*******************************************************************************
+ * Functions
+ ******************************************************************************/
+BaseType_t xTaskCreate(TaskFunction_t pxTaskCode, const char *pcName, uint32_t usStackDepth,
+                       void *pvParameters, UBaseType_t uxPriority, TaskHandle_t *pxCreatedTask);
+TaskHandle_t xTaskCreateStatic(TaskFunction_t pxTaskCode, const char *pcName, uint32_t ulStackDepth,
+                               void *pvParameters, UBaseType_t uxPriority, StackType_t *puxStackBuffer,
+                               StaticTask_t *pxTaskBuffer);
+void vTaskDelete(TaskHandle_t xTaskToDelete);
+UBaseType_t uxTaskGetStackHighWaterMark(TaskHandle_t xTask);
+void vTaskDelay(TickType_t xTicksToDelay);
+void vTaskStartScheduler(void);
+BaseType_t xTaskGetSchedulerState(void);
+TickType_t xTaskGetTickCount(void);
+TickType_t xTaskGetTickCountFromISR(void);
+TaskHandle_t xTaskGetCurrentTaskHandle(void);
+char *pcTaskGetName(TaskHandle_t xTaskToQuery);
+UBaseType_t uxTaskPriorityGet(TaskHandle_t xTask);
+BaseType_t xTaskNotifyGive(TaskHandle_t xTaskToNotify);
+void vTaskNotifyGiveFromISR(TaskHandle_t xTaskToNotify, BaseType_t *pxHigherPriorityTaskWoken);
+uint32_t ulTaskNotifyTake(BaseType_t xClearCountOnExit, TickType_t xTicksToWait);
+
+/* [] END OF FILE */
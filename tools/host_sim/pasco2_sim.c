@@ -0,0 +1,833 @@
+/*****************************************************************************
+** File name: pasco2_sim.c
+**
+** Description: This file sets up the host simulation before the firmware's
+**   main() runs: it parses the command line, connects the sensor models to
+**   the simulated buses, routes the console, models the room the sensor
+**   hangs in, and prints the run report when the simulation ends.
+**
+** ===========================================================================
+** Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+** ===========================================================================
+**
+** ===========================================================================
+** Infineon Technologies AG (INFINEON) is supplying this file for use
+** exclusively with Infineon's sensor products. This file can be freely
+** distributed within development tools and software supporting such
+** products.
+**
+** THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+** OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+** MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+** INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+** WHATSOEVER.
+** ===========================================================================
+*/
+
+/* Header file from system */
+#define _GNU_SOURCE
+#include <inttypes.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdio_ext.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+/* Header file includes */
+#include "cybsp.h"
+#include "pasco2_baseline.h"
+#include "pasco2_board.h"
+#include "pasco2_sim.h"
+#include "pasco2_task.h"
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+/* Addresses of the sensors of a node, matching the node tables of the
+ * firmware. The bus, mux channel, and INT pin of a node follow the layout in
+ * pasco2_sim.h; the power switch pin comes from the board header. */
+#define PASCO2_SIM_PASCO2_ADDRESS       (0x28U)
+#define PASCO2_SIM_DPS3XX_ADDRESS       (0x76U)
+
+/* Most clock pulses a device holding SDA low needs to finish its byte */
+#define PASCO2_SIM_STUCK_PULSES_MAX     (9U)
+
+/* Default run length in seconds */
+#define PASCO2_SIM_DEFAULT_DURATION_S   (3600.0)
+
+/* Default hour of the day at which the run starts, Monday */
+#define PASCO2_SIM_DEFAULT_START_HOUR   (7.0)
+
+/* Office hours on weekdays, during which the room is occupied */
+#define PASCO2_SIM_OFFICE_OPEN_HOUR     (8.0)
+#define PASCO2_SIM_OFFICE_CLOSE_HOUR    (18.0)
+#define PASCO2_SIM_WORKDAYS             (5U)
+
+/* Gas concentration the room settles at when occupied and when empty */
+#define PASCO2_SIM_OCCUPIED_PPM         (1400.0)
+#define PASCO2_SIM_OUTDOOR_PPM          (420.0)
+
+/* Ambient pressure in hPa: a slow weather swing around the mean */
+#define PASCO2_SIM_PRESSURE_MEAN_HPA    (1013.25)
+#define PASCO2_SIM_PRESSURE_SWING_HPA   (6.0)
+#define PASCO2_SIM_PRESSURE_PERIOD_H    (88.0)
+
+/* Measurement period changes of the reconfiguration stress test: typed
+ * from this time on, with periods in this range */
+#define PASCO2_SIM_STRESS_START_US      (5000000U)
+#define PASCO2_SIM_STRESS_PERIOD_MIN_S  (5U)
+#define PASCO2_SIM_STRESS_PERIOD_MAX_S  (20U)
+
+/* Longest time from the end of a measurement to the read of its result in
+ * the stress test. With an INT line, the first results also wait for the
+ * first FIFO drain of every node, which takes 14.4 ms; without one, the
+ * result may be read one retry of the firmware late. */
+#define PASCO2_SIM_STRESS_LATENCY_US    (100000U + (PASCO2_SIM_NODES * 15000U))
+#define PASCO2_SIM_STRESS_POLL_LATENCY_US (1500000U)
+
+/* Room temperature in degrees Celsius: a daily swing peaking at 15 h */
+#define PASCO2_SIM_TEMPERATURE_MEAN_C   (21.5)
+#define PASCO2_SIM_TEMPERATURE_SWING_C  (1.5)
+#define PASCO2_SIM_TEMPERATURE_PEAK_H   (15.0)
+
+/* Accuracy of the PAS CO2: +-(30 ppm + 3 % of the reading) */
+#define PASCO2_SIM_ACCURACY_PPM         (30.0)
+#define PASCO2_SIM_ACCURACY_SHARE       (0.03)
+
+/* Longest console line scanned for CO2 values */
+#define PASCO2_SIM_LINE_SIZE            (80U)
+
+/*******************************************************************************
+ * Global variables
+ ******************************************************************************/
+static double start_hour = PASCO2_SIM_DEFAULT_START_HOUR;
+static struct timespec wall_start;
+static FILE *console;
+static const char *flash_image;
+
+/* Reconfiguration stress test: changes typed and the last period typed */
+static uint32_t stress_changes;
+static uint32_t stress_last_period_s;
+
+/* Fault injection: kind, "stuck" for a bus held low, and its event */
+static const char *fault_kind;
+static pasco2_sim_event_t fault_event;
+static uint32_t fault_seed;
+
+/* Baseline drift test: drift of the sensor, and the CO2 values printed by
+ * the firmware compared with the concentration they were measured at */
+static bool drift_test;
+static double drift_ppm;
+static double drift_ppm_day;
+static char console_line[PASCO2_SIM_LINE_SIZE];
+static size_t console_length;
+static uint32_t accuracy_values;
+static uint32_t accuracy_misses;
+static double accuracy_last_error;
+static uint64_t accurate_since_us = PASCO2_SIM_TIME_NEVER;
+
+static pasco2_sim_pasco2_t pasco2_models[PASCO2_SIM_NODES];
+static pasco2_sim_dps3xx_t dps3xx_models[PASCO2_SIM_NODES];
+static pasco2_sim_mux_t muxes[PASCO2_SIM_NODE_BUSES];
+
+/*******************************************************************************
+ * Function Name: hour_of_week
+ ********************************************************************************
+ * Summary:
+ *  Returns the simulated wall clock time.
+ *
+ * Parameters:
+ *  at_us: virtual time
+ *
+ * Return:
+ *  Hours since Monday 0 h
+ *******************************************************************************/
+static double hour_of_week(uint64_t at_us)
+{
+    return fmod(start_hour + (double)at_us / 3600e6, 24.0 * 7.0);
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_sim_env_co2_target
+ ********************************************************************************
+ * Summary:
+ *  Returns the concentration the room is heading for: people in the office
+ *  on weekdays, outdoor air otherwise.
+ *
+ * Parameters:
+ *  at_us: virtual time
+ *
+ * Return:
+ *  Gas concentration in ppm
+ *******************************************************************************/
+double pasco2_sim_env_co2_target(uint64_t at_us)
+{
+    double hour = hour_of_week(at_us);
+    double hour_of_day = fmod(hour, 24.0);
+    bool workday = (uint32_t)(hour / 24.0) < PASCO2_SIM_WORKDAYS;
+
+    return (workday && (hour_of_day >= PASCO2_SIM_OFFICE_OPEN_HOUR) &&
+            (hour_of_day < PASCO2_SIM_OFFICE_CLOSE_HOUR)) ? PASCO2_SIM_OCCUPIED_PPM : PASCO2_SIM_OUTDOOR_PPM;
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_sim_env_pressure
+ ********************************************************************************
+ * Summary:
+ *  Returns the ambient pressure.
+ *
+ * Parameters:
+ *  at_us: virtual time
+ *
+ * Return:
+ *  Pressure in hPa
+ *******************************************************************************/
+double pasco2_sim_env_pressure(uint64_t at_us)
+{
+    double hours = start_hour + (double)at_us / 3600e6;
+
+    return PASCO2_SIM_PRESSURE_MEAN_HPA +
+           PASCO2_SIM_PRESSURE_SWING_HPA * sin(2.0 * M_PI * hours / PASCO2_SIM_PRESSURE_PERIOD_H);
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_sim_env_temperature
+ ********************************************************************************
+ * Summary:
+ *  Returns the room temperature.
+ *
+ * Parameters:
+ *  at_us: virtual time
+ *
+ * Return:
+ *  Temperature in degrees Celsius
+ *******************************************************************************/
+double pasco2_sim_env_temperature(uint64_t at_us)
+{
+    double hours = start_hour + (double)at_us / 3600e6;
+
+    return PASCO2_SIM_TEMPERATURE_MEAN_C +
+           PASCO2_SIM_TEMPERATURE_SWING_C * cos(2.0 * M_PI * (hours - PASCO2_SIM_TEMPERATURE_PEAK_H) / 24.0);
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_sim_random
+ ********************************************************************************
+ * Summary:
+ *  Returns the next value of a seeded generator, so noise is reproducible.
+ *
+ * Parameters:
+ *  seed: generator state
+ *
+ * Return:
+ *  Pseudo-random value in the range 0 to 65535
+ *******************************************************************************/
+uint32_t pasco2_sim_random(uint32_t *seed)
+{
+    *seed = (*seed * 1664525UL) + 1013904223UL;
+
+    return *seed >> 16U;
+}
+
+/*******************************************************************************
+ * Function Name: nodes_init
+ ********************************************************************************
+ * Summary:
+ *  Creates the PAS CO2 and DPS3xx models of every node and attaches them to
+ *  their bus, behind the mux of the bus if the nodes share the buses.
+ *
+ * Parameters:
+ *  seed: seed of the sensor noise; the first node uses it unchanged
+ *
+ * Return:
+ *  None
+ *******************************************************************************/
+static void nodes_init(uint32_t seed)
+{
+    for (uint8_t bus = 0U; PASCO2_SIM_NODE_MUXED && (bus < PASCO2_SIM_NODE_BUSES); bus++)
+    {
+        pasco2_sim_mux_init(&muxes[bus], PASCO2_SIM_MUX_ADDRESS);
+        pasco2_sim_i2c_attach(bus, &muxes[bus].device);
+    }
+
+    for (uint32_t i = 0U; i < PASCO2_SIM_NODES; i++)
+    {
+        uint32_t node_seed = seed + (i * 7919U);
+        uint8_t bus = PASCO2_SIM_NODE_BUS(i);
+
+        pasco2_sim_pasco2_init(&pasco2_models[i], PASCO2_SIM_PASCO2_ADDRESS, PASCO2_SIM_NODE_INT(i), node_seed);
+        pasco2_sim_pasco2_drift(&pasco2_models[i], drift_ppm, drift_ppm_day);
+        pasco2_sim_dps3xx_init(&dps3xx_models[i], PASCO2_SIM_DPS3XX_ADDRESS, node_seed ^ 0x5A5AU);
+        if (PASCO2_SIM_NODE_MUXED)
+        {
+            pasco2_sim_mux_connect(&muxes[bus], PASCO2_SIM_NODE_CHANNEL(i), &pasco2_models[i].device);
+            pasco2_sim_mux_connect(&muxes[bus], PASCO2_SIM_NODE_CHANNEL(i), &dps3xx_models[i].device);
+        }
+        pasco2_sim_i2c_attach(bus, &pasco2_models[i].device);
+        pasco2_sim_i2c_attach(bus, &dps3xx_models[i].device);
+    }
+}
+
+/*******************************************************************************
+ * Function Name: nodes_report
+ ********************************************************************************
+ * Summary:
+ *  Prints the counters of the sensor and mux models and the time from a
+ *  new CO2 result to its readout over all nodes.
+ *
+ * Parameters:
+ *  out: report stream
+ *
+ * Return:
+ *  None
+ *******************************************************************************/
+static void nodes_report(FILE *out)
+{
+    uint64_t latency_sum_us = 0U;
+    uint64_t latency_max_us = 0U;
+    uint32_t read = 0U;
+    uint32_t lost = 0U;
+
+    for (uint8_t bus = 0U; PASCO2_SIM_NODE_MUXED && (bus < PASCO2_SIM_NODE_BUSES); bus++)
+    {
+        pasco2_sim_mux_report(&muxes[bus], bus, out);
+    }
+    for (uint32_t i = 0U; i < PASCO2_SIM_NODES; i++)
+    {
+        const pasco2_sim_pasco2_stats_t *stats = &pasco2_models[i].stats;
+
+        if (PASCO2_SIM_NODES > 1U)
+        {
+            fprintf(out, "Node %" PRIu32 ", bus %u, channel %u: ", i, (unsigned int)PASCO2_SIM_NODE_BUS(i),
+                    (unsigned int)PASCO2_SIM_NODE_CHANNEL(i));
+        }
+        pasco2_sim_pasco2_report(&pasco2_models[i], out);
+        if (PASCO2_SIM_NODES > 1U)
+        {
+            fprintf(out, "Node %" PRIu32 ", bus %u, channel %u: ", i, (unsigned int)PASCO2_SIM_NODE_BUS(i),
+                    (unsigned int)PASCO2_SIM_NODE_CHANNEL(i));
+        }
+        pasco2_sim_dps3xx_report(&dps3xx_models[i], out);
+
+        latency_sum_us += stats->latency_sum_us;
+        latency_max_us = (stats->latency_max_us > latency_max_us) ? stats->latency_max_us : latency_max_us;
+        read += stats->results_read;
+        lost += stats->results_lost;
+    }
+    fprintf(out, "Nodes: %u on %u I2C bus%s%s, %" PRIu32 " results read, %" PRIu32
+            " overwritten unread, read latency mean %.1f ms, max %.1f ms\n", (unsigned int)PASCO2_SIM_NODES,
+            (unsigned int)PASCO2_SIM_NODE_BUSES, (PASCO2_SIM_NODE_BUSES > 1U) ? "es" : "",
+            PASCO2_SIM_NODE_MUXED ? " behind muxes" : "", read, lost,
+            (read > 0U) ? ((double)latency_sum_us / (double)read / 1000.0) : 0.0, (double)latency_max_us / 1000.0);
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_sim_finish
+ ********************************************************************************
+ * Summary:
+ *  Prints the run report to stderr and ends the process.
+ *
+ * Parameters:
+ *  reason: why the run ended
+ *
+ * Return:
+ *  Never returns
+ *******************************************************************************/
+void pasco2_sim_finish(const char *reason)
+{
+    struct timespec wall_end;
+    uint64_t virtual_us = pasco2_sim_now_us();
+
+    clock_gettime(CLOCK_MONOTONIC, &wall_end);
+    double wall_s = (double)(wall_end.tv_sec - wall_start.tv_sec) +
+                    (double)(wall_end.tv_nsec - wall_start.tv_nsec) / 1e9;
+
+    fflush(stdout);
+    fflush(console);
+    fprintf(stderr, "\n=== Simulation ended: %s ===\n", reason);
+    fprintf(stderr, "Simulated %.3f s in %.3f s wall clock (%.0fx)\n", (double)virtual_us / 1e6, wall_s,
+            (wall_s > 0.0) ? ((double)virtual_us / 1e6) / wall_s : 0.0);
+    pasco2_sim_kernel_report(stderr);
+    pasco2_sim_hal_report(stderr);
+    pasco2_sim_flash_report(stderr);
+    nodes_report(stderr);
+    if ((flash_image != NULL) && !pasco2_sim_flash_save(flash_image))
+    {
+        fprintf(stderr, "Cannot write flash image %s\n", flash_image);
+    }
+
+    int status = EXIT_SUCCESS;
+    if (stress_changes > 0U)
+    {
+        uint16_t rate = pasco2_sim_pasco2_continuous_rate(&pasco2_models[0]);
+        uint32_t iccer = 0U;
+        uint32_t lost = 0U;
+        uint64_t latency_max_us = 0U;
+        uint64_t latency_limit_us = (PASCO2_BOARD_INT != NC) ? PASCO2_SIM_STRESS_LATENCY_US :
+                                    PASCO2_SIM_STRESS_POLL_LATENCY_US;
+        bool pass = true;
+
+        /* Every node has the last period, and no result was overwritten
+         * unread or read late */
+        for (uint32_t i = 0U; i < PASCO2_SIM_NODES; i++)
+        {
+            iccer += pasco2_models[i].stats.iccer;
+            lost += pasco2_models[i].stats.results_lost;
+            if (pasco2_models[i].stats.latency_max_us > latency_max_us)
+            {
+                latency_max_us = pasco2_models[i].stats.latency_max_us;
+            }
+            pass = pass && (pasco2_sim_pasco2_continuous_rate(&pasco2_models[i]) == stress_last_period_s);
+        }
+        pass = pass && (iccer == 0U) && (lost == 0U) && (latency_max_us <= latency_limit_us);
+
+        fprintf(stderr, "Stress: %" PRIu32 " measurement period changes typed, last %" PRIu32 " s, sensor at %u s, %"
+                PRIu32 " rejected writes, %" PRIu32 " overwritten unread, read latency max %.1f ms of %.1f ms: %s\n",
+                stress_changes, stress_last_period_s, (unsigned int)rate, iccer, lost,
+                (double)latency_max_us / 1000.0, (double)latency_limit_us / 1000.0, pass ? "PASS" : "FAIL");
+        status = pass ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+    if (fault_kind != NULL)
+    {
+        uint64_t injected_us = pasco2_models[0].fault_us;
+        uint64_t cleared_us = (strcmp(fault_kind, "stuck") == 0) ? pasco2_sim_i2c_released_us(0U) :
+                              pasco2_models[0].fault_cleared_us;
+        uint64_t read_us = pasco2_models[0].fault_read_us;
+        bool pass = (read_us != PASCO2_SIM_TIME_NEVER);
+
+        if (injected_us == PASCO2_SIM_TIME_NEVER)
+        {
+            fprintf(stderr, "Fault: %s not injected, the run is too short: FAIL\n", fault_kind);
+        }
+        else if (!pass)
+        {
+            fprintf(stderr, "Fault: %s at %.3f s, %s, no result read since: FAIL\n", fault_kind,
+                    (double)injected_us / 1e6, (cleared_us == PASCO2_SIM_TIME_NEVER) ? "not cleared" : "cleared");
+        }
+        else
+        {
+            fprintf(stderr, "Fault: %s at %.3f s, cleared after %.3f s, next result read after %.3f s: PASS\n",
+                    fault_kind, (double)injected_us / 1e6, (double)(cleared_us - injected_us) / 1e6,
+                    (double)(read_us - injected_us) / 1e6);
+        }
+        status = pass ? status : EXIT_FAILURE;
+    }
+    if (drift_test)
+    {
+        /* While the firmware compensates the baseline, the ABOC of the
+         * sensor must not add a correction of its own */
+        uint32_t aboc = pasco2_models[0].stats.aboc_measurements;
+        bool pass = (accurate_since_us != PASCO2_SIM_TIME_NEVER);
+
+        fprintf(stderr, "Baseline: drift %.0f ppm %+.1f ppm/day, %" PRIu32 " values, %" PRIu32
+                " outside +-(%.0f ppm + %.0f %%), last error %+.0f ppm, %" PRIu32 " measurements with ABOC, ",
+                drift_ppm, drift_ppm_day, accuracy_values, accuracy_misses, PASCO2_SIM_ACCURACY_PPM,
+                PASCO2_SIM_ACCURACY_SHARE * 100.0, accuracy_last_error, aboc);
+        if ((PASCO2_BASELINE_ENABLE != 0U) && (aboc > 0U))
+        {
+            fprintf(stderr, "ABOC of the sensor enabled: FAIL\n");
+            pass = false;
+        }
+        else if (pass)
+        {
+            fprintf(stderr, "accurate since %.3f s: PASS\n", (double)accurate_since_us / 1e6);
+        }
+        else
+        {
+            fprintf(stderr, "not accurate at the end: FAIL\n");
+        }
+        status = pass ? status : EXIT_FAILURE;
+    }
+
+    exit(status);
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_sim_console_output
+ ********************************************************************************
+ * Summary:
+ *  Scans the console output of the firmware for CO2 values of the first
+ *  node and compares each with the concentration of its latest measurement. The value is
+ *  accurate from the first one of the final run of values within the
+ *  accuracy of the sensor.
+ *
+ * Parameters:
+ *  data: characters sent
+ *  size: number of characters
+ *
+ * Return:
+ *  None
+ *******************************************************************************/
+void pasco2_sim_console_output(const void *data, size_t size)
+{
+    const char *text = data;
+
+    for (size_t i = 0U; drift_test && (i < size); i++)
+    {
+        if (text[i] != '\n')
+        {
+            if (console_length < (PASCO2_SIM_LINE_SIZE - 1U))
+            {
+                console_line[console_length++] = text[i];
+            }
+            continue;
+        }
+
+        unsigned int ppm;
+        unsigned int node = 0U;
+        console_line[console_length] = '\0';
+        console_length = 0U;
+        if ((sscanf(console_line, "CO2 PPM Level: %u", &ppm) != 1) &&
+            ((sscanf(console_line, "CO2 PPM Level [%u]: %u", &node, &ppm) != 2) || (node != 0U)))
+        {
+            continue;
+        }
+
+        double truth = pasco2_models[0].measured_ppm;
+        accuracy_last_error = (double)ppm - truth;
+        accuracy_values++;
+        if (fabs(accuracy_last_error) <= (PASCO2_SIM_ACCURACY_PPM + (PASCO2_SIM_ACCURACY_SHARE * truth)))
+        {
+            if (accurate_since_us == PASCO2_SIM_TIME_NEVER)
+            {
+                accurate_since_us = pasco2_sim_now_us();
+            }
+        }
+        else
+        {
+            accuracy_misses++;
+            accurate_since_us = PASCO2_SIM_TIME_NEVER;
+        }
+    }
+}
+
+/*******************************************************************************
+ * Function Name: console_write
+ ********************************************************************************
+ * Summary:
+ *  Passes stdout of the firmware to the stdout hook of newlib, which is
+ *  either the firmware's console or retarget-io.
+ *
+ * Parameters:
+ *  cookie: unused
+ *  buf: characters written
+ *  size: number of characters
+ *
+ * Return:
+ *  Number of characters written
+ *******************************************************************************/
+static ssize_t console_write(void *cookie, const char *buf, size_t size)
+{
+    CY_UNUSED_PARAMETER(cookie);
+
+    return (ssize_t)_write(STDOUT_FILENO, buf, (int)size);
+}
+
+/*******************************************************************************
+ * Function Name: unescape
+ ********************************************************************************
+ * Summary:
+ *  Expands \r, \n, \e, \b and \\ in scripted terminal input, in place.
+ *
+ * Parameters:
+ *  text: input text
+ *
+ * Return:
+ *  None
+ *******************************************************************************/
+static void unescape(char *text)
+{
+    char *out = text;
+
+    for (const char *in = text; *in != '\0'; in++)
+    {
+        if ((in[0] == '\\') && (in[1] != '\0'))
+        {
+            in++;
+            *out++ = (*in == 'r') ? '\r' : (*in == 'n') ? '\n' : (*in == 'e') ? '\x1b' :
+                     (*in == 'b') ? '\b' : *in;
+        }
+        else
+        {
+            *out++ = *in;
+        }
+    }
+    *out = '\0';
+}
+
+/*******************************************************************************
+ * Function Name: stress_schedule
+ ********************************************************************************
+ * Summary:
+ *  Types measurement period changes at random times spread over the run, so
+ *  that some of them arrive while the sensor task is reading the sensors.
+ *  The run report checks that the sensor ends up with the last period typed
+ *  and that it rejected no write.
+ *
+ * Parameters:
+ *  count: number of changes
+ *  duration_us: run length
+ *  seed: seed of the times and periods
+ *
+ * Return:
+ *  None
+ *******************************************************************************/
+static void stress_schedule(uint32_t count, uint64_t duration_us, uint32_t seed)
+{
+    uint64_t gap_us = (duration_us > PASCO2_SIM_STRESS_START_US) ?
+                      ((duration_us - PASCO2_SIM_STRESS_START_US) / count) : 0U;
+    uint64_t at_us = PASCO2_SIM_STRESS_START_US;
+    uint32_t state = seed ^ 0xC3C3U;
+
+    for (uint32_t i = 0U; i < count; i++)
+    {
+        /* Uniform gaps of 0 to twice the mean keep the changes in the run */
+        at_us += (2U * gap_us * pasco2_sim_random(&state)) >> 16U;
+        if (at_us >= duration_us)
+        {
+            break;
+        }
+
+        uint32_t period = PASCO2_SIM_STRESS_PERIOD_MIN_S +
+                          (pasco2_sim_random(&state) % (PASCO2_SIM_STRESS_PERIOD_MAX_S - PASCO2_SIM_STRESS_PERIOD_MIN_S + 1U));
+        char text[16];
+        (void)snprintf(text, sizeof(text), "p%" PRIu32 "\r", period);
+        pasco2_sim_uart_input(at_us, text);
+        stress_changes++;
+        stress_last_period_s = period;
+    }
+}
+
+/*******************************************************************************
+ * Function Name: fault_inject
+ ********************************************************************************
+ * Summary:
+ *  Injects the fault requested on the command line into the first node: a
+ *  device holding SDA low for a few clock pulses, a PAS CO2 that stops
+ *  measuring or one that stops acknowledging.
+ *
+ * Parameters:
+ *  arg: unused
+ *
+ * Return:
+ *  None
+ *******************************************************************************/
+static void fault_inject(void *arg)
+{
+    CY_UNUSED_PARAMETER(arg);
+
+    if (strcmp(fault_kind, "stuck") == 0)
+    {
+        pasco2_sim_pasco2_fault(&pasco2_models[0], PASCO2_SIM_PASCO2_FAULT_NONE);
+        pasco2_sim_i2c_stick(0U, (uint8_t)(1U + (pasco2_sim_random(&fault_seed) % PASCO2_SIM_STUCK_PULSES_MAX)));
+    }
+    else
+    {
+        pasco2_sim_pasco2_fault(&pasco2_models[0], (strcmp(fault_kind, "freeze") == 0) ?
+                                PASCO2_SIM_PASCO2_FAULT_FREEZE : PASCO2_SIM_PASCO2_FAULT_HANG);
+    }
+}
+
+/*******************************************************************************
+ * Function Name: power_switch
+ ********************************************************************************
+ * Summary:
+ *  Follows the sensor supply switch driven by the firmware, which feeds the
+ *  sensors of all nodes.
+ *
+ * Parameters:
+ *  arg: unused
+ *  level: new level of the switch
+ *
+ * Return:
+ *  None
+ *******************************************************************************/
+static void power_switch(void *arg, bool level)
+{
+    CY_UNUSED_PARAMETER(arg);
+
+    for (uint32_t i = 0U; i < PASCO2_SIM_NODES; i++)
+    {
+        pasco2_sim_pasco2_power(&pasco2_models[i], level);
+        pasco2_sim_dps3xx_power(&dps3xx_models[i], level);
+    }
+}
+
+/*******************************************************************************
+ * Function Name: usage
+ ********************************************************************************
+ * Summary:
+ *  Prints the command line help and exits.
+ *
+ * Parameters:
+ *  name: program name
+ *
+ * Return:
+ *  Never returns
+ *******************************************************************************/
+static void usage(const char *name)
+{
+    fprintf(stderr,
+            "Usage: %s [-t seconds] [-H hour] [-s seed] [-k ms:keys]... [-r count] [-F kind@seconds]\n"
+            "          [-D ppm[:ppm_per_day]] [-f image] [-q]\n"
+            "  -t  simulated run time, default %.0f s\n"
+            "  -H  hour of the week the run starts at, 0 is Monday 0 h, default %.0f\n"
+            "  -s  seed of the sensor noise\n"
+            "  -k  terminal input at a virtual time in ms; \\r, \\n, \\e and \\b are expanded\n"
+            "  -r  stress test: type count measurement period changes at random times\n"
+            "  -F  inject a fault at a virtual time: stuck (SDA held low), freeze (PAS CO2\n"
+            "      stops measuring) or hang (PAS CO2 stops acknowledging)\n"
+            "  -D  baseline drift of the PAS CO2 at the start and per day; the printed\n"
+            "      CO2 values are checked against the true concentration\n"
+            "  -f  work flash image, loaded at the start if it exists and saved at the end\n"
+            "  -q  discard the console output\n",
+            name, PASCO2_SIM_DEFAULT_DURATION_S, PASCO2_SIM_DEFAULT_START_HOUR);
+    exit(EXIT_FAILURE);
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_sim_setup
+ ********************************************************************************
+ * Summary:
+ *  Runs before the firmware's main(), which takes no arguments, and
+ *  receives the command line from the C library.
+ *
+ * Parameters:
+ *  argc, argv: command line
+ *
+ * Return:
+ *  None
+ *******************************************************************************/
+__attribute__((constructor)) static void pasco2_sim_setup(int argc, char **argv)
+{
+    double duration = PASCO2_SIM_DEFAULT_DURATION_S;
+    uint32_t seed = 1U;
+    uint32_t stress_count = 0U;
+    double fault_s = 0.0;
+    bool quiet = false;
+    int option;
+
+    clock_gettime(CLOCK_MONOTONIC, &wall_start);
+
+    while ((option = getopt(argc, argv, "t:H:s:k:r:F:D:f:qh")) != -1)
+    {
+        switch (option)
+        {
+            case 't':
+                duration = strtod(optarg, NULL);
+                break;
+
+            case 'H':
+                start_hour = strtod(optarg, NULL);
+                break;
+
+            case 's':
+                seed = (uint32_t)strtoul(optarg, NULL, 0);
+                break;
+
+            case 'k':
+            {
+                char *text = strchr(optarg, ':');
+                if (text == NULL)
+                {
+                    usage(argv[0]);
+                }
+                *text++ = '\0';
+                unescape(text);
+                pasco2_sim_uart_input((uint64_t)(strtod(optarg, NULL) * 1000.0), text);
+                break;
+            }
+
+            case 'r':
+                stress_count = (uint32_t)strtoul(optarg, NULL, 0);
+                break;
+
+            case 'F':
+            {
+                char *at = strchr(optarg, '@');
+                if (at == NULL)
+                {
+                    usage(argv[0]);
+                }
+                *at++ = '\0';
+                if ((strcmp(optarg, "stuck") != 0) && (strcmp(optarg, "freeze") != 0) && (strcmp(optarg, "hang") != 0))
+                {
+                    usage(argv[0]);
+                }
+                fault_kind = optarg;
+                fault_s = strtod(at, NULL);
+                break;
+            }
+
+            case 'D':
+            {
+                char *end;
+                drift_test = true;
+                drift_ppm = strtod(optarg, &end);
+                drift_ppm_day = (*end == ':') ? strtod(end + 1, NULL) : 0.0;
+                break;
+            }
+
+            case 'f':
+                flash_image = optarg;
+                break;
+
+            case 'q':
+                quiet = true;
+                break;
+
+            default:
+                usage(argv[0]);
+                break;
+        }
+    }
+    if (duration <= 0.0)
+    {
+        usage(argv[0]);
+    }
+    pasco2_sim_kernel_init((uint64_t)(duration * 1e6));
+    if (stress_count > 0U)
+    {
+        stress_schedule(stress_count, (uint64_t)(duration * 1e6), seed);
+    }
+    if (fault_kind != NULL)
+    {
+        fault_seed = seed ^ 0x3C3CU;
+        pasco2_sim_event_schedule(&fault_event, (uint64_t)(fault_s * 1e6), fault_inject, NULL);
+    }
+    if ((flash_image != NULL) && !pasco2_sim_flash_load(flash_image))
+    {
+        fprintf(stderr, "%s is not a flash image\n", flash_image);
+        exit(EXIT_FAILURE);
+    }
+
+    /* Firmware output goes through the UART model to the host stdout */
+    FILE *host = quiet ? fopen("/dev/null", "w") : stdout;
+    static const cookie_io_functions_t console_io = { .write = console_write };
+    console = host;
+    pasco2_sim_hal_init(host);
+    stdout = fopencookie(NULL, "w", console_io);
+    CY_ASSERT(stdout != NULL);
+    setvbuf(stdout, NULL, _IONBF, 0U);
+    /* Only one task runs at a time, and a task may sleep in the hook while
+     * the console is full, so the host lock must not be held across it */
+    __fsetlocking(stdout, FSETLOCKING_BYCALLER);
+
+    if (pasco2_get_sensor_count() != PASCO2_SIM_NODES)
+    {
+        fprintf(stderr, "The firmware serves %u sensor nodes, the simulation %u; build it with "
+                "-DPASCO2_NODE_TABLE='\"pasco2_sim_nodes.h\"'\n", (unsigned int)pasco2_get_sensor_count(),
+                (unsigned int)PASCO2_SIM_NODES);
+        exit(EXIT_FAILURE);
+    }
+    nodes_init(seed);
+    if (PASCO2_BOARD_POWER_SWITCH != NC)
+    {
+        pasco2_sim_gpio_watch(PASCO2_BOARD_POWER_SWITCH, power_switch, NULL);
+    }
+}
+
+/* [] END OF FILE */
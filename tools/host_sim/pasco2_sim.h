@@ -0,0 +1,258 @@
+/******************************************************************************
+** File name: pasco2_sim.h
+**
+** Description: Internal interface of the host simulation: virtual time and
+**   interrupt events of the scheduler, peripheral hooks of the HAL stand-in,
+**   the work flash model, the register-level sensor and I2C mux models, and
+**   the layout of the simulated sensor nodes.
+**
+** ===========================================================================
+** Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+** ===========================================================================
+**
+** ===========================================================================
+** Infineon Technologies AG (INFINEON) is supplying this file for use
+** exclusively with Infineon's sensor products. This file can be freely
+** distributed within development tools and software supporting such
+** products.
+**
+** THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+** OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+** MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+** INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+** WHATSOEVER.
+** ===========================================================================
+*/
+
+#pragma once
+
+/* Header file from system */
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+/* Header file includes */
+#include "cyhal.h"
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+/* Virtual time never reached */
+#define PASCO2_SIM_TIME_NEVER           (UINT64_MAX)
+
+/* Number of simulated I2C buses */
+#define PASCO2_SIM_I2C_BUS_COUNT        (4U)
+
+/* Depth of the UART hardware FIFOs */
+#define PASCO2_SIM_UART_FIFO_DEPTH      (128U)
+
+/* CPU time of one iteration of a polling loop in the HAL */
+#define PASCO2_SIM_POLL_US              (100U)
+
+/* Size of the PAS CO2 and DPS3xx register files */
+#define PASCO2_SIM_PASCO2_REG_COUNT     (0x11U)
+#define PASCO2_SIM_DPS3XX_REG_COUNT     (0x100U)
+#define PASCO2_SIM_DPS3XX_FIFO_DEPTH    (32U)
+
+/* Number of simulated sensor nodes. A firmware built with the node table of
+ * pasco2_sim_nodes.h serves the same nodes. */
+#ifndef PASCO2_SIM_NODES
+#define PASCO2_SIM_NODES                (1U)
+#endif
+
+/* Node layout: one node per bus up to the number of buses; with more nodes,
+ * every bus has a PCA9548A and the nodes are spread over its channels */
+#define PASCO2_SIM_MUX_ADDRESS          (0x70U)
+#define PASCO2_SIM_MUX_CHANNELS         (8U)
+#define PASCO2_SIM_NODE_BUSES           ((PASCO2_SIM_NODES < PASCO2_SIM_I2C_BUS_COUNT) ? \
+                                         PASCO2_SIM_NODES : PASCO2_SIM_I2C_BUS_COUNT)
+#define PASCO2_SIM_NODE_MUXED           (PASCO2_SIM_NODES > PASCO2_SIM_NODE_BUSES)
+#define PASCO2_SIM_NODE_BUS(node)       ((uint8_t)((node) % PASCO2_SIM_NODE_BUSES))
+#define PASCO2_SIM_NODE_CHANNEL(node)   ((uint8_t)((node) / PASCO2_SIM_NODE_BUSES))
+
+#if ((PASCO2_SIM_NODES < 1U) || (PASCO2_SIM_NODES > (PASCO2_SIM_I2C_BUS_COUNT * PASCO2_SIM_MUX_CHANNELS)))
+#error "PASCO2_SIM_NODES must be 1 to 32"
+#endif
+
+/* Bus 0 uses the I2C pins of the kit, the other buses pins of port 6 */
+#define PASCO2_SIM_BUS_SCL(bus)         (((bus) == 0U) ? CYBSP_I2C_SCL : CYHAL_GET_GPIO(6U, 2U * (bus)))
+#define PASCO2_SIM_BUS_SDA(bus)         (((bus) == 0U) ? CYBSP_I2C_SDA : CYHAL_GET_GPIO(6U, (2U * (bus)) + 1U))
+
+/* The INT line of node 0 is the one of the kit. The other nodes use pins of
+ * ports 16 to 19, which only the simulation has, or none if the kit has no
+ * INT line. */
+#define PASCO2_SIM_NODE_INT(node)       (((node) == 0U) ? PASCO2_BOARD_INT : \
+                                         (PASCO2_BOARD_INT == NC) ? NC : \
+                                         CYHAL_GET_GPIO(16U + (((node) - 1U) / 8U), ((node) - 1U) % 8U))
+
+/*******************************************************************************
+ * Types
+ ******************************************************************************/
+/* Interrupt source scheduled on the virtual time line. The handler runs in
+ * interrupt context between two kernel calls of the simulated tasks. */
+typedef struct pasco2_sim_event
+{
+    uint64_t at_us;
+    uint64_t sequence;
+    void (*handler)(void *arg);
+    void *arg;
+    bool pending;
+    struct pasco2_sim_event *next;
+} pasco2_sim_event_t;
+
+/* Device on a simulated I2C bus. The handlers return false to NACK. */
+typedef struct pasco2_sim_i2c_device
+{
+    uint16_t address;
+    const uint8_t *gate;        /* Control register of the mux in front of the device, NULL if none */
+    uint8_t gate_mask;          /* Channel bit of the device in the control register */
+    bool (*write)(struct pasco2_sim_i2c_device *device, const uint8_t *data, size_t size);
+    bool (*read)(struct pasco2_sim_i2c_device *device, uint8_t *data, size_t size);
+    struct pasco2_sim_i2c_device *next;
+} pasco2_sim_i2c_device_t;
+
+/* Counters of the PAS CO2 model */
+typedef struct
+{
+    uint32_t measurements;      /* Completed measurements */
+    uint32_t results_read;      /* New results read by the host */
+    uint32_t results_lost;      /* Results overwritten before they were read */
+    uint32_t reference_writes;  /* Pressure reference writes */
+    uint32_t iccer;             /* Register writes rejected outside idle mode */
+    uint32_t aboc_measurements; /* Measurements taken with the ABOC enabled */
+    uint64_t latency_sum_us;    /* Sum of the times from result to read */
+    uint64_t latency_max_us;    /* Longest time from result to read */
+} pasco2_sim_pasco2_stats_t;
+
+/* Faults of the PAS CO2 model */
+typedef enum
+{
+    PASCO2_SIM_PASCO2_FAULT_NONE,       /* Sensor intact, the fault is elsewhere on the bus */
+    PASCO2_SIM_PASCO2_FAULT_FREEZE,     /* Measurements stop until a reset */
+    PASCO2_SIM_PASCO2_FAULT_HANG        /* No acknowledge until a power cycle */
+} pasco2_sim_pasco2_fault_t;
+
+/* Register-level PAS CO2 model */
+typedef struct
+{
+    pasco2_sim_i2c_device_t device;
+    cyhal_gpio_t int_pin;
+    uint8_t regs[PASCO2_SIM_PASCO2_REG_COUNT];
+    uint8_t pointer;
+    bool powered;
+    uint64_t ready_us;
+    pasco2_sim_pasco2_fault_t fault;
+    uint64_t fault_us;          /* Time of the last injected fault, PASCO2_SIM_TIME_NEVER if none */
+    uint64_t fault_cleared_us;  /* Time a reset or power cycle removed it */
+    uint64_t fault_read_us;     /* First result read by the host after it */
+    pasco2_sim_event_t measurement;
+    double ppm;
+    uint64_t ppm_us;
+    double measured_ppm;        /* Concentration at the latest measurement */
+    uint64_t result_us;         /* Time of the latest result */
+    double drift_ppm;           /* Baseline drift at the start of the run */
+    double drift_ppm_day;       /* Baseline drift added per day */
+    double aboc_offset;         /* Correction learned by the ABOC, lost on reset */
+    double aboc_min;            /* Lowest value of the current ABOC period */
+    uint64_t aboc_start_us;     /* Start of the current ABOC period */
+    uint32_t seed;
+    pasco2_sim_pasco2_stats_t stats;
+} pasco2_sim_pasco2_t;
+
+/* Counters of the DPS3xx model */
+typedef struct
+{
+    uint32_t pressure_results;  /* Completed pressure measurements */
+    uint32_t temperature_results; /* Completed temperature measurements */
+    uint32_t fifo_reads;        /* FIFO entries read by the host */
+    uint32_t fifo_empty_reads;  /* FIFO reads that found it empty */
+    uint32_t fifo_overflows;    /* Results dropped because the FIFO was full */
+} pasco2_sim_dps3xx_stats_t;
+
+/* Register-level DPS3xx model */
+typedef struct
+{
+    pasco2_sim_i2c_device_t device;
+    uint8_t regs[PASCO2_SIM_DPS3XX_REG_COUNT];
+    uint8_t pointer;
+    bool powered;
+    uint64_t ready_us;
+    uint32_t fifo[PASCO2_SIM_DPS3XX_FIFO_DEPTH];
+    uint8_t fifo_head;
+    uint8_t fifo_count;
+    pasco2_sim_event_t pressure;
+    pasco2_sim_event_t temperature;
+    uint32_t seed;
+    pasco2_sim_dps3xx_stats_t stats;
+} pasco2_sim_dps3xx_t;
+
+/* PCA9548A I2C mux: a control register with one enable bit per channel */
+typedef struct
+{
+    pasco2_sim_i2c_device_t device;
+    uint8_t control;
+    uint32_t selects;           /* Writes of the control register */
+} pasco2_sim_mux_t;
+
+/*******************************************************************************
+ * Functions
+ ******************************************************************************/
+/* Scheduler and virtual time, pasco2_sim_kernel.c */
+void pasco2_sim_kernel_init(uint64_t end_us);
+uint64_t pasco2_sim_now_us(void);
+void pasco2_sim_event_schedule(pasco2_sim_event_t *event, uint64_t at_us, void (*handler)(void *arg), void *arg);
+void pasco2_sim_event_cancel(pasco2_sim_event_t *event);
+void pasco2_sim_consume(uint64_t duration_us);
+void pasco2_sim_charge(uint64_t duration_us);
+bool pasco2_sim_in_deepsleep(void);
+void pasco2_sim_kernel_report(FILE *out);
+uint32_t pasco2_probe_host_clock(void);
+
+/* Peripherals, pasco2_sim_hal.c */
+void pasco2_sim_hal_init(FILE *console);
+bool pasco2_sim_hal_deepsleep_locked(void);
+void pasco2_sim_i2c_attach(uint8_t bus, pasco2_sim_i2c_device_t *device);
+void pasco2_sim_gpio_drive(cyhal_gpio_t pin, bool level);
+void pasco2_sim_gpio_watch(cyhal_gpio_t pin, void (*handler)(void *arg, bool level), void *arg);
+void pasco2_sim_i2c_stick(uint8_t bus, uint8_t pulses);
+uint64_t pasco2_sim_i2c_released_us(uint8_t bus);
+void pasco2_sim_uart_input(uint64_t at_us, const char *text);
+int _write(int fd, const char *ptr, int len);
+void pasco2_sim_uart_transmit(const void *data, size_t size);
+void pasco2_sim_hal_report(FILE *out);
+
+/* Work flash, pasco2_sim_flash.c */
+void pasco2_sim_flash_tear(uint32_t after_bytes, uint32_t seed);
+bool pasco2_sim_flash_power_up(void);
+uint32_t pasco2_sim_flash_erase_count(uint32_t row);
+bool pasco2_sim_flash_load(const char *path);
+bool pasco2_sim_flash_save(const char *path);
+void pasco2_sim_flash_report(FILE *out);
+
+/* Sensor models, pasco2_sim_pasco2.c and pasco2_sim_dps3xx.c */
+void pasco2_sim_pasco2_init(pasco2_sim_pasco2_t *sensor, uint16_t address, cyhal_gpio_t int_pin, uint32_t seed);
+void pasco2_sim_pasco2_report(const pasco2_sim_pasco2_t *sensor, FILE *out);
+uint16_t pasco2_sim_pasco2_continuous_rate(const pasco2_sim_pasco2_t *sensor);
+void pasco2_sim_pasco2_fault(pasco2_sim_pasco2_t *sensor, pasco2_sim_pasco2_fault_t fault);
+void pasco2_sim_pasco2_power(pasco2_sim_pasco2_t *sensor, bool on);
+void pasco2_sim_pasco2_drift(pasco2_sim_pasco2_t *sensor, double ppm, double ppm_per_day);
+void pasco2_sim_dps3xx_init(pasco2_sim_dps3xx_t *sensor, uint16_t address, uint32_t seed);
+void pasco2_sim_dps3xx_power(pasco2_sim_dps3xx_t *sensor, bool on);
+void pasco2_sim_dps3xx_report(const pasco2_sim_dps3xx_t *sensor, FILE *out);
+
+/* I2C mux model, pasco2_sim_mux.c */
+void pasco2_sim_mux_init(pasco2_sim_mux_t *mux, uint16_t address);
+void pasco2_sim_mux_connect(pasco2_sim_mux_t *mux, uint8_t channel, pasco2_sim_i2c_device_t *device);
+void pasco2_sim_mux_report(const pasco2_sim_mux_t *mux, uint8_t bus, FILE *out);
+
+/* Environment and run control, pasco2_sim.c */
+double pasco2_sim_env_co2_target(uint64_t at_us);
+double pasco2_sim_env_pressure(uint64_t at_us);
+double pasco2_sim_env_temperature(uint64_t at_us);
+uint32_t pasco2_sim_random(uint32_t *seed);
+void pasco2_sim_console_output(const void *data, size_t size);
+void pasco2_sim_finish(const char *reason) __attribute__((noreturn));
+
+/* [] END OF FILE */
@@ -0,0 +1,620 @@
+/*****************************************************************************
+** File name: pasco2_sim_dps3xx.c
+**
+** Description: This file contains the register-level model of the XENSIV
+**   DPS3xx pressure sensor: calibration coefficients, command and background
+**   modes, oversampling times and the result FIFO. Raw results are derived
+**   from the simulated ambient pressure and temperature by inverting the
+**   compensation formulas of the datasheet.
+**
+** ===========================================================================
+** Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+** ===========================================================================
+**
+** ===========================================================================
+** Infineon Technologies AG (INFINEON) is supplying this file for use
+** exclusively with Infineon's sensor products. This file can be freely
+** distributed within development tools and software supporting such
+** products.
+**
+** THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+** OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+** MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+** INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+** WHATSOEVER.
+** ===========================================================================
+*/
+
+/* Header file from system */
+#include <inttypes.h>
+#include <math.h>
+#include <string.h>
+
+/* Header file includes */
+#include "pasco2_sim.h"
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+/* Registers */
+#define PASCO2_SIM_DPS_REG_PSR_B2       (0x00U)
+#define PASCO2_SIM_DPS_REG_TMP_B2       (0x03U)
+#define PASCO2_SIM_DPS_REG_PRS_CFG      (0x06U)
+#define PASCO2_SIM_DPS_REG_TMP_CFG      (0x07U)
+#define PASCO2_SIM_DPS_REG_MEAS_CFG     (0x08U)
+#define PASCO2_SIM_DPS_REG_CFG_REG      (0x09U)
+#define PASCO2_SIM_DPS_REG_INT_STS      (0x0AU)
+#define PASCO2_SIM_DPS_REG_FIFO_STS     (0x0BU)
+#define PASCO2_SIM_DPS_REG_RESET        (0x0CU)
+#define PASCO2_SIM_DPS_REG_PRODUCT_ID   (0x0DU)
+#define PASCO2_SIM_DPS_REG_COEF         (0x10U)
+#define PASCO2_SIM_DPS_REG_COEF_SRCE    (0x28U)
+
+/* Register fields */
+#define PASCO2_SIM_DPS_RATE_POS         (4U)
+#define PASCO2_SIM_DPS_RATE_MSK         (0x07U)
+#define PASCO2_SIM_DPS_PRC_MSK          (0x0FU)
+#define PASCO2_SIM_DPS_COEF_RDY         (0x80U)
+#define PASCO2_SIM_DPS_SENSOR_RDY       (0x40U)
+#define PASCO2_SIM_DPS_TMP_RDY          (0x20U)
+#define PASCO2_SIM_DPS_PRS_RDY          (0x10U)
+#define PASCO2_SIM_DPS_MEAS_CTRL_MSK    (0x07U)
+#define PASCO2_SIM_DPS_FIFO_EN          (0x02U)
+#define PASCO2_SIM_DPS_FIFO_FULL        (0x02U)
+#define PASCO2_SIM_DPS_FIFO_EMPTY       (0x01U)
+#define PASCO2_SIM_DPS_FIFO_FLUSH       (0x80U)
+#define PASCO2_SIM_DPS_SOFT_RST         (0x09U)
+#define PASCO2_SIM_DPS_SOFT_RST_MSK     (0x0FU)
+
+/* MEAS_CTRL values */
+#define PASCO2_SIM_DPS_CMD_PRESSURE     (1U)
+#define PASCO2_SIM_DPS_CMD_TEMPERATURE  (2U)
+#define PASCO2_SIM_DPS_BG_PRESSURE      (5U)
+#define PASCO2_SIM_DPS_BG_TEMPERATURE   (6U)
+#define PASCO2_SIM_DPS_BG_ALL           (7U)
+
+/* Result read from an empty FIFO */
+#define PASCO2_SIM_DPS_FIFO_EMPTY_VALUE (0x800000UL)
+
+/* Time from power-up or reset until the coefficients are ready */
+#define PASCO2_SIM_DPS_STARTUP_US       (40000U)
+
+/* Calibration coefficients of the simulated part */
+#define PASCO2_SIM_DPS_C0               (208)
+#define PASCO2_SIM_DPS_C1               (-264)
+#define PASCO2_SIM_DPS_C00              (80000)
+#define PASCO2_SIM_DPS_C10              (-56000)
+#define PASCO2_SIM_DPS_C01              (-2000)
+#define PASCO2_SIM_DPS_C11              (1200)
+#define PASCO2_SIM_DPS_C20              (-11000)
+#define PASCO2_SIM_DPS_C21              (80)
+#define PASCO2_SIM_DPS_C30              (-1200)
+
+/* Compensation scale factors by oversampling rate */
+static const double pasco2_sim_dps_scale[] =
+{
+    524288.0, 1572864.0, 3670016.0, 7864320.0, 253952.0, 516096.0, 1040384.0, 2088960.0
+};
+
+/* Measurement times by oversampling rate in microseconds */
+static const uint32_t pasco2_sim_dps_time_us[] =
+{
+    3600U, 5200U, 8400U, 14800U, 27600U, 53200U, 104400U, 206800U
+};
+
+/*******************************************************************************
+ * Function Name: oversampling
+ ********************************************************************************
+ * Summary:
+ *  Returns the oversampling setting of a configuration register.
+ *
+ * Parameters:
+ *  cfg: PRS_CFG or TMP_CFG value
+ *
+ * Return:
+ *  Oversampling rate index, 2^n samples
+ *******************************************************************************/
+static uint8_t oversampling(uint8_t cfg)
+{
+    uint8_t prc = cfg & PASCO2_SIM_DPS_PRC_MSK;
+
+    return (prc < 8U) ? prc : 7U;
+}
+
+/*******************************************************************************
+ * Function Name: raw_temperature
+ ********************************************************************************
+ * Summary:
+ *  Returns the scaled raw temperature that compensates to the ambient value.
+ *
+ * Parameters:
+ *  sensor: sensor model
+ *
+ * Return:
+ *  Scaled raw temperature
+ *******************************************************************************/
+static double raw_temperature(pasco2_sim_dps3xx_t *sensor)
+{
+    double noise = ((double)(pasco2_sim_random(&sensor->seed) % 201U) / 100.0 - 1.0) * 0.01;
+    double temperature = pasco2_sim_env_temperature(pasco2_sim_now_us()) + noise;
+
+    return (temperature - (PASCO2_SIM_DPS_C0 * 0.5)) / PASCO2_SIM_DPS_C1;
+}
+
+/*******************************************************************************
+ * Function Name: raw_pressure
+ ********************************************************************************
+ * Summary:
+ *  Returns the scaled raw pressure that compensates to the ambient value,
+ *  solving the compensation polynomial with Newton's method.
+ *
+ * Parameters:
+ *  sensor: sensor model
+ *  t: scaled raw temperature
+ *
+ * Return:
+ *  Scaled raw pressure
+ *******************************************************************************/
+static double raw_pressure(pasco2_sim_dps3xx_t *sensor, double t)
+{
+    double noise = ((double)(pasco2_sim_random(&sensor->seed) % 201U) / 100.0 - 1.0) * 1.0;
+    double pressure = pasco2_sim_env_pressure(pasco2_sim_now_us()) * 100.0 + noise;
+    double x = (pressure - PASCO2_SIM_DPS_C00 - t * PASCO2_SIM_DPS_C01) /
+               (PASCO2_SIM_DPS_C10 + t * PASCO2_SIM_DPS_C11);
+
+    for (uint8_t i = 0U; i < 8U; i++)
+    {
+        double f = PASCO2_SIM_DPS_C00 + x * (PASCO2_SIM_DPS_C10 + x * (PASCO2_SIM_DPS_C20 + x * PASCO2_SIM_DPS_C30)) +
+                   t * PASCO2_SIM_DPS_C01 + t * x * (PASCO2_SIM_DPS_C11 + x * PASCO2_SIM_DPS_C21) - pressure;
+        double df = PASCO2_SIM_DPS_C10 + x * (2.0 * PASCO2_SIM_DPS_C20 + x * 3.0 * PASCO2_SIM_DPS_C30) +
+                    t * (PASCO2_SIM_DPS_C11 + x * 2.0 * PASCO2_SIM_DPS_C21);
+        x -= f / df;
+    }
+
+    return x;
+}
+
+/*******************************************************************************
+ * Function Name: to_raw
+ ********************************************************************************
+ * Summary:
+ *  Converts a scaled raw value to the 24-bit register format.
+ *
+ * Parameters:
+ *  scaled: scaled raw value
+ *  cfg: PRS_CFG or TMP_CFG value
+ *
+ * Return:
+ *  24-bit two's complement raw value
+ *******************************************************************************/
+static uint32_t to_raw(double scaled, uint8_t cfg)
+{
+    double raw = round(scaled * pasco2_sim_dps_scale[oversampling(cfg)]);
+
+    raw = (raw > 8388607.0) ? 8388607.0 : (raw < -8388608.0) ? -8388608.0 : raw;
+
+    return (uint32_t)(int32_t)raw & 0xFFFFFFUL;
+}
+
+/*******************************************************************************
+ * Function Name: store_result
+ ********************************************************************************
+ * Summary:
+ *  Stores a result in the FIFO, or in the result registers with the FIFO
+ *  disabled. Pressure entries carry a set LSB.
+ *
+ * Parameters:
+ *  sensor: sensor model
+ *  raw: 24-bit raw value
+ *  pressure: true for a pressure result
+ *
+ * Return:
+ *  None
+ *******************************************************************************/
+static void store_result(pasco2_sim_dps3xx_t *sensor, uint32_t raw, bool pressure)
+{
+    uint8_t *regs = sensor->regs;
+
+    if ((regs[PASCO2_SIM_DPS_REG_CFG_REG] & PASCO2_SIM_DPS_FIFO_EN) != 0U)
+    {
+        raw = pressure ? (raw | 1U) : (raw & ~1UL);
+        if (sensor->fifo_count >= PASCO2_SIM_DPS3XX_FIFO_DEPTH)
+        {
+            sensor->stats.fifo_overflows++;
+        }
+        else
+        {
+            sensor->fifo[(sensor->fifo_head + sensor->fifo_count) % PASCO2_SIM_DPS3XX_FIFO_DEPTH] = raw;
+            sensor->fifo_count++;
+        }
+        return;
+    }
+
+    uint8_t reg = pressure ? PASCO2_SIM_DPS_REG_PSR_B2 : PASCO2_SIM_DPS_REG_TMP_B2;
+    regs[reg] = (uint8_t)(raw >> 16U);
+    regs[reg + 1U] = (uint8_t)(raw >> 8U);
+    regs[reg + 2U] = (uint8_t)raw;
+    regs[PASCO2_SIM_DPS_REG_MEAS_CFG] |= pressure ? PASCO2_SIM_DPS_PRS_RDY : PASCO2_SIM_DPS_TMP_RDY;
+}
+
+/*******************************************************************************
+ * Function Name: rate_period_us
+ ********************************************************************************
+ * Summary:
+ *  Returns the background measurement period of a configuration register.
+ *
+ * Parameters:
+ *  cfg: PRS_CFG or TMP_CFG value
+ *
+ * Return:
+ *  Period in microseconds
+ *******************************************************************************/
+static uint64_t rate_period_us(uint8_t cfg)
+{
+    return 1000000U >> ((cfg >> PASCO2_SIM_DPS_RATE_POS) & PASCO2_SIM_DPS_RATE_MSK);
+}
+
+/*******************************************************************************
+ * Function Name: pressure_done
+ ********************************************************************************
+ * Summary:
+ *  Completes a pressure measurement and schedules the next one in
+ *  background mode.
+ *
+ * Parameters:
+ *  arg: sensor model
+ *
+ * Return:
+ *  None
+ *******************************************************************************/
+static void pressure_done(void *arg)
+{
+    pasco2_sim_dps3xx_t *sensor = arg;
+    uint8_t *regs = sensor->regs;
+    uint8_t ctrl = regs[PASCO2_SIM_DPS_REG_MEAS_CFG] & PASCO2_SIM_DPS_MEAS_CTRL_MSK;
+
+    store_result(sensor, to_raw(raw_pressure(sensor, raw_temperature(sensor)), regs[PASCO2_SIM_DPS_REG_PRS_CFG]),
+                 true);
+    sensor->stats.pressure_results++;
+
+    if (ctrl == PASCO2_SIM_DPS_CMD_PRESSURE)
+    {
+        regs[PASCO2_SIM_DPS_REG_MEAS_CFG] &= (uint8_t)~PASCO2_SIM_DPS_MEAS_CTRL_MSK;
+    }
+    else
+    {
+        pasco2_sim_event_schedule(&sensor->pressure,
+                                  pasco2_sim_now_us() + rate_period_us(regs[PASCO2_SIM_DPS_REG_PRS_CFG]),
+                                  pressure_done, sensor);
+    }
+}
+
+/*******************************************************************************
+ * Function Name: temperature_done
+ ********************************************************************************
+ * Summary:
+ *  Completes a temperature measurement and schedules the next one in
+ *  background mode.
+ *
+ * Parameters:
+ *  arg: sensor model
+ *
+ * Return:
+ *  None
+ *******************************************************************************/
+static void temperature_done(void *arg)
+{
+    pasco2_sim_dps3xx_t *sensor = arg;
+    uint8_t *regs = sensor->regs;
+    uint8_t ctrl = regs[PASCO2_SIM_DPS_REG_MEAS_CFG] & PASCO2_SIM_DPS_MEAS_CTRL_MSK;
+
+    store_result(sensor, to_raw(raw_temperature(sensor), regs[PASCO2_SIM_DPS_REG_TMP_CFG]), false);
+    sensor->stats.temperature_results++;
+
+    if (ctrl == PASCO2_SIM_DPS_CMD_TEMPERATURE)
+    {
+        regs[PASCO2_SIM_DPS_REG_MEAS_CFG] &= (uint8_t)~PASCO2_SIM_DPS_MEAS_CTRL_MSK;
+    }
+    else
+    {
+        pasco2_sim_event_schedule(&sensor->temperature,
+                                  pasco2_sim_now_us() + rate_period_us(regs[PASCO2_SIM_DPS_REG_TMP_CFG]),
+                                  temperature_done, sensor);
+    }
+}
+
+/*******************************************************************************
+ * Function Name: start_measurements
+ ********************************************************************************
+ * Summary:
+ *  Starts the measurements selected by MEAS_CTRL.
+ *
+ * Parameters:
+ *  sensor: sensor model
+ *
+ * Return:
+ *  None
+ *******************************************************************************/
+static void start_measurements(pasco2_sim_dps3xx_t *sensor)
+{
+    uint8_t *regs = sensor->regs;
+    uint8_t ctrl = regs[PASCO2_SIM_DPS_REG_MEAS_CFG] & PASCO2_SIM_DPS_MEAS_CTRL_MSK;
+    uint64_t now = pasco2_sim_now_us();
+    uint32_t pressure_us = pasco2_sim_dps_time_us[oversampling(regs[PASCO2_SIM_DPS_REG_PRS_CFG])];
+    uint32_t temperature_us = pasco2_sim_dps_time_us[oversampling(regs[PASCO2_SIM_DPS_REG_TMP_CFG])];
+
+    pasco2_sim_event_cancel(&sensor->pressure);
+    pasco2_sim_event_cancel(&sensor->temperature);
+
+    if ((ctrl == PASCO2_SIM_DPS_CMD_PRESSURE) || (ctrl == PASCO2_SIM_DPS_BG_PRESSURE) ||
+        (ctrl == PASCO2_SIM_DPS_BG_ALL))
+    {
+        pasco2_sim_event_schedule(&sensor->pressure, now + pressure_us, pressure_done, sensor);
+    }
+    if ((ctrl == PASCO2_SIM_DPS_CMD_TEMPERATURE) || (ctrl == PASCO2_SIM_DPS_BG_TEMPERATURE) ||
+        (ctrl == PASCO2_SIM_DPS_BG_ALL))
+    {
+        pasco2_sim_event_schedule(&sensor->temperature, now + temperature_us, temperature_done, sensor);
+    }
+}
+
+/*******************************************************************************
+ * Function Name: reset
+ ********************************************************************************
+ * Summary:
+ *  Restores the register defaults, clears the FIFO and restarts the
+ *  coefficient load.
+ *
+ * Parameters:
+ *  sensor: sensor model
+ *
+ * Return:
+ *  None
+ *******************************************************************************/
+static void reset(pasco2_sim_dps3xx_t *sensor)
+{
+    static const int32_t coef[] =
+    {
+        PASCO2_SIM_DPS_C0, PASCO2_SIM_DPS_C1, PASCO2_SIM_DPS_C00, PASCO2_SIM_DPS_C10, PASCO2_SIM_DPS_C01,
+        PASCO2_SIM_DPS_C11, PASCO2_SIM_DPS_C20, PASCO2_SIM_DPS_C21, PASCO2_SIM_DPS_C30
+    };
+    uint8_t *c = &sensor->regs[PASCO2_SIM_DPS_REG_COEF];
+
+    pasco2_sim_event_cancel(&sensor->pressure);
+    pasco2_sim_event_cancel(&sensor->temperature);
+    memset(sensor->regs, 0, sizeof(sensor->regs));
+    sensor->regs[PASCO2_SIM_DPS_REG_PRODUCT_ID] = 0x10U;
+    sensor->regs[PASCO2_SIM_DPS_REG_COEF_SRCE] = 0x80U;
+
+    /* 12-bit c0 and c1, 20-bit c00 and c10, 16-bit c01 to c30 */
+    c[0] = (uint8_t)(coef[0] >> 4);
+    c[1] = (uint8_t)(((coef[0] & 0x0F) << 4) | ((coef[1] >> 8) & 0x0F));
+    c[2] = (uint8_t)coef[1];
+    c[3] = (uint8_t)(coef[2] >> 12);
+    c[4] = (uint8_t)(coef[2] >> 4);
+    c[5] = (uint8_t)(((coef[2] & 0x0F) << 4) | ((coef[3] >> 16) & 0x0F));
+    c[6] = (uint8_t)(coef[3] >> 8);
+    c[7] = (uint8_t)coef[3];
+    for (uint8_t i = 4U; i < 9U; i++)
+    {
+        c[8U + (i - 4U) * 2U] = (uint8_t)(coef[i] >> 8);
+        c[9U + (i - 4U) * 2U] = (uint8_t)coef[i];
+    }
+
+    sensor->fifo_head = 0U;
+    sensor->fifo_count = 0U;
+    sensor->pointer = 0U;
+    sensor->ready_us = pasco2_sim_now_us() + PASCO2_SIM_DPS_STARTUP_US;
+}
+
+/*******************************************************************************
+ * Function Name: device_write
+ ********************************************************************************
+ * Summary:
+ *  Handles an I2C write: register pointer followed by data bytes.
+ *
+ * Parameters:
+ *  device: sensor model
+ *  data: bytes written
+ *  size: number of bytes
+ *
+ * Return:
+ *  False to NACK while the sensor is off
+ *******************************************************************************/
+static bool device_write(pasco2_sim_i2c_device_t *device, const uint8_t *data, size_t size)
+{
+    pasco2_sim_dps3xx_t *sensor = (pasco2_sim_dps3xx_t *)device;
+    uint8_t *regs = sensor->regs;
+
+    if (!sensor->powered)
+    {
+        return false;
+    }
+
+    sensor->pointer = data[0];
+    for (size_t i = 1U; i < size; i++)
+    {
+        uint8_t reg = sensor->pointer++;
+        uint8_t value = data[i];
+
+        switch (reg)
+        {
+            case PASCO2_SIM_DPS_REG_MEAS_CFG:
+                regs[reg] = (uint8_t)((regs[reg] & (uint8_t)~PASCO2_SIM_DPS_MEAS_CTRL_MSK) |
+                                      (value & PASCO2_SIM_DPS_MEAS_CTRL_MSK));
+                start_measurements(sensor);
+                break;
+
+            case PASCO2_SIM_DPS_REG_RESET:
+                if ((value & PASCO2_SIM_DPS_SOFT_RST_MSK) == PASCO2_SIM_DPS_SOFT_RST)
+                {
+                    reset(sensor);
+                    return true;
+                }
+                if ((value & PASCO2_SIM_DPS_FIFO_FLUSH) != 0U)
+                {
+                    sensor->fifo_count = 0U;
+                }
+                break;
+
+            case PASCO2_SIM_DPS_REG_INT_STS:
+            case PASCO2_SIM_DPS_REG_FIFO_STS:
+            case PASCO2_SIM_DPS_REG_PRODUCT_ID:
+            case PASCO2_SIM_DPS_REG_COEF_SRCE:
+                break;
+
+            default:
+                if ((reg < PASCO2_SIM_DPS_REG_COEF) || (reg >= (PASCO2_SIM_DPS_REG_COEF + 18U)))
+                {
+                    regs[reg] = value;
+                }
+                break;
+        }
+    }
+
+    return true;
+}
+
+/*******************************************************************************
+ * Function Name: device_read
+ ********************************************************************************
+ * Summary:
+ *  Handles an I2C read from the register pointer. With the FIFO enabled a
+ *  read from PSR_B2 pops one entry into the result registers.
+ *
+ * Parameters:
+ *  device: sensor model
+ *  data: receives the bytes
+ *  size: number of bytes
+ *
+ * Return:
+ *  False to NACK while the sensor is off
+ *******************************************************************************/
+static bool device_read(pasco2_sim_i2c_device_t *device, uint8_t *data, size_t size)
+{
+    pasco2_sim_dps3xx_t *sensor = (pasco2_sim_dps3xx_t *)device;
+    uint8_t *regs = sensor->regs;
+
+    if (!sensor->powered)
+    {
+        return false;
+    }
+
+    if ((sensor->pointer == PASCO2_SIM_DPS_REG_PSR_B2) &&
+        ((regs[PASCO2_SIM_DPS_REG_CFG_REG] & PASCO2_SIM_DPS_FIFO_EN) != 0U))
+    {
+        uint32_t entry = PASCO2_SIM_DPS_FIFO_EMPTY_VALUE;
+
+        if (sensor->fifo_count > 0U)
+        {
+            entry = sensor->fifo[sensor->fifo_head];
+            sensor->fifo_head = (uint8_t)((sensor->fifo_head + 1U) % PASCO2_SIM_DPS3XX_FIFO_DEPTH);
+            sensor->fifo_count--;
+            sensor->stats.fifo_reads++;
+        }
+        else
+        {
+            sensor->stats.fifo_empty_reads++;
+        }
+        regs[PASCO2_SIM_DPS_REG_PSR_B2] = (uint8_t)(entry >> 16U);
+        regs[PASCO2_SIM_DPS_REG_PSR_B2 + 1U] = (uint8_t)(entry >> 8U);
+        regs[PASCO2_SIM_DPS_REG_PSR_B2 + 2U] = (uint8_t)entry;
+    }
+
+    regs[PASCO2_SIM_DPS_REG_FIFO_STS] = (uint8_t)(((sensor->fifo_count == 0U) ? PASCO2_SIM_DPS_FIFO_EMPTY : 0U) |
+                                                  ((sensor->fifo_count >= PASCO2_SIM_DPS3XX_FIFO_DEPTH) ?
+                                                   PASCO2_SIM_DPS_FIFO_FULL : 0U));
+    if (pasco2_sim_now_us() >= sensor->ready_us)
+    {
+        regs[PASCO2_SIM_DPS_REG_MEAS_CFG] |= PASCO2_SIM_DPS_COEF_RDY | PASCO2_SIM_DPS_SENSOR_RDY;
+    }
+
+    for (size_t i = 0U; i < size; i++)
+    {
+        uint8_t reg = sensor->pointer++;
+
+        data[i] = regs[reg];
+        if (reg == (PASCO2_SIM_DPS_REG_PSR_B2 + 2U))
+        {
+            regs[PASCO2_SIM_DPS_REG_MEAS_CFG] &= (uint8_t)~PASCO2_SIM_DPS_PRS_RDY;
+        }
+        else if (reg == (PASCO2_SIM_DPS_REG_TMP_B2 + 2U))
+        {
+            regs[PASCO2_SIM_DPS_REG_MEAS_CFG] &= (uint8_t)~PASCO2_SIM_DPS_TMP_RDY;
+        }
+    }
+
+    return true;
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_sim_dps3xx_init
+ ********************************************************************************
+ * Summary:
+ *  Powers up a DPS3xx model.
+ *
+ * Parameters:
+ *  sensor: sensor model
+ *  address: I2C address
+ *  seed: seed of the measurement noise
+ *
+ * Return:
+ *  None
+ *******************************************************************************/
+void pasco2_sim_dps3xx_init(pasco2_sim_dps3xx_t *sensor, uint16_t address, uint32_t seed)
+{
+    memset(sensor, 0, sizeof(*sensor));
+    sensor->device.address = address;
+    sensor->device.write = device_write;
+    sensor->device.read = device_read;
+    sensor->seed = seed;
+    sensor->powered = true;
+    reset(sensor);
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_sim_dps3xx_power
+ ********************************************************************************
+ * Summary:
+ *  Switches the supply of the sensor. Switching it on restores the register
+ *  defaults.
+ *
+ * Parameters:
+ *  sensor: sensor model
+ *  on: new state of the supply
+ *
+ * Return:
+ *  None
+ *******************************************************************************/
+void pasco2_sim_dps3xx_power(pasco2_sim_dps3xx_t *sensor, bool on)
+{
+    if (on && !sensor->powered)
+    {
+        reset(sensor);
+    }
+    sensor->powered = on;
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_sim_dps3xx_report
+ ********************************************************************************
+ * Summary:
+ *  Prints the counters of a DPS3xx model.
+ *
+ * Parameters:
+ *  sensor: sensor model
+ *  out: report stream
+ *
+ * Return:
+ *  None
+ *******************************************************************************/
+void pasco2_sim_dps3xx_report(const pasco2_sim_dps3xx_t *sensor, FILE *out)
+{
+    fprintf(out, "DPS3xx 0x%02X: %" PRIu32 " pressure and %" PRIu32 " temperature results, %" PRIu32
+            " FIFO reads, %" PRIu32 " empty reads, %" PRIu32 " overflows\n", sensor->device.address,
+            sensor->stats.pressure_results, sensor->stats.temperature_results, sensor->stats.fifo_reads,
+            sensor->stats.fifo_empty_reads, sensor->stats.fifo_overflows);
+}
+
+/* [] END OF FILE */
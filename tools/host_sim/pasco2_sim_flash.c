@@ -0,0 +1,491 @@
+/*****************************************************************************
+** File name: pasco2_sim_flash.c
+**
+** Description: This file contains the model of the PSoC 6 work flash behind
+**   the HAL flash driver: row erase and program times, erase counts per row,
+**   writes torn by a power loss at a chosen byte, and an image file that
+**   carries the content from one run to the next.
+**
+** ===========================================================================
+** Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+** ===========================================================================
+**
+** ===========================================================================
+** Infineon Technologies AG (INFINEON) is supplying this file for use
+** exclusively with Infineon's sensor products. This file can be freely
+** distributed within development tools and software supporting such
+** products.
+**
+** THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+** OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+** MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+** INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+** WHATSOEVER.
+** ===========================================================================
+*/
+
+/* Header file from system */
+#include <inttypes.h>
+#include <string.h>
+
+/* Header file includes */
+#include "cy_pdl.h"
+#include "pasco2_sim.h"
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+/* Row count of the work flash */
+#define PASCO2_SIM_FLASH_ROWS           (CY_EM_EEPROM_SIZE / CY_FLASH_SIZEOF_ROW)
+
+/* Value of an erased byte */
+#define PASCO2_SIM_FLASH_ERASE_VALUE    (0x00U)
+
+/* Row erase and program times of the PSoC 6 datasheet */
+#define PASCO2_SIM_FLASH_ERASE_US       (11000U)
+#define PASCO2_SIM_FLASH_PROGRAM_US     (5000U)
+
+/*******************************************************************************
+ * Global variables
+ ******************************************************************************/
+static const cyhal_flash_block_info_t flash_blocks[] =
+{
+    {
+        .start_address = CY_EM_EEPROM_BASE,
+        .size = CY_EM_EEPROM_SIZE,
+        .sector_size = CY_FLASH_SIZEOF_ROW,
+        .page_size = CY_FLASH_SIZEOF_ROW,
+        .erase_value = PASCO2_SIM_FLASH_ERASE_VALUE
+    }
+};
+
+static uint8_t flash_data[CY_EM_EEPROM_SIZE];
+static bool flash_formatted;
+static uint32_t erase_counts[PASCO2_SIM_FLASH_ROWS];
+static uint32_t flash_reads;
+static uint32_t flash_programs;
+
+/* Byte operations left until the power fails, counting the erase of a row as
+ * one operation per byte; 0 while no power loss is armed */
+static uint32_t tear_countdown;
+static uint32_t tear_seed = 1U;
+static bool powered_down;
+
+/*******************************************************************************
+ * Function Name: flash_row
+ ********************************************************************************
+ * Summary:
+ *  Returns the row of an address if it is the start of a row.
+ *
+ * Parameters:
+ *  address: flash address
+ *  row: destination of the row index
+ *
+ * Return:
+ *  true if the address is the start of a row of the work flash
+ *******************************************************************************/
+static bool flash_row(uint32_t address, uint32_t *row)
+{
+    if ((address < CY_EM_EEPROM_BASE) || (address >= (CY_EM_EEPROM_BASE + CY_EM_EEPROM_SIZE)) ||
+        (((address - CY_EM_EEPROM_BASE) % CY_FLASH_SIZEOF_ROW) != 0U))
+    {
+        return false;
+    }
+    *row = (address - CY_EM_EEPROM_BASE) / CY_FLASH_SIZEOF_ROW;
+
+    return true;
+}
+
+/*******************************************************************************
+ * Function Name: flash_format
+ ********************************************************************************
+ * Summary:
+ *  Erases the whole work flash once, as delivered.
+ *
+ * Parameters:
+ *  None
+ *
+ * Return:
+ *  None
+ *******************************************************************************/
+static void flash_format(void)
+{
+    if (!flash_formatted)
+    {
+        memset(flash_data, PASCO2_SIM_FLASH_ERASE_VALUE, sizeof(flash_data));
+        flash_formatted = true;
+    }
+}
+
+/*******************************************************************************
+ * Function Name: flash_operate
+ ********************************************************************************
+ * Summary:
+ *  Erases and programs a row byte by byte. If the power fails during the
+ *  operation, the bytes up to the failure are done, the byte at the failure
+ *  holds random bits, and the rest is untouched.
+ *
+ * Parameters:
+ *  row: row index
+ *  erase: erase the row first
+ *  data: content to program, NULL to only erase
+ *
+ * Return:
+ *  false if the power failed
+ *******************************************************************************/
+static bool flash_operate(uint32_t row, bool erase, const uint8_t *data)
+{
+    uint8_t *target = &flash_data[row * CY_FLASH_SIZEOF_ROW];
+
+    if (powered_down)
+    {
+        return false;
+    }
+
+    for (uint32_t pass = erase ? 0U : 1U; pass < ((data != NULL) ? 2U : 1U); pass++)
+    {
+        if (pass == 0U)
+        {
+            erase_counts[row]++;
+        }
+        for (uint32_t i = 0U; i < CY_FLASH_SIZEOF_ROW; i++)
+        {
+            if ((tear_countdown > 0U) && (--tear_countdown == 0U))
+            {
+                target[i] = (uint8_t)pasco2_sim_random(&tear_seed);
+                powered_down = true;
+                return false;
+            }
+            target[i] = (pass == 0U) ? PASCO2_SIM_FLASH_ERASE_VALUE : (uint8_t)(target[i] | data[i]);
+        }
+    }
+
+    return true;
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_sim_flash_tear
+ ********************************************************************************
+ * Summary:
+ *  Arms a power loss during a later erase or program operation. Afterwards
+ *  every operation fails until pasco2_sim_flash_power_up() is called.
+ *
+ * Parameters:
+ *  after_bytes: byte operations until the failure, from 1 on; an erase and a
+ *               program of a row take CY_FLASH_SIZEOF_ROW operations each
+ *  seed: seed of the random bits left at the failure
+ *
+ * Return:
+ *  None
+ *******************************************************************************/
+void pasco2_sim_flash_tear(uint32_t after_bytes, uint32_t seed)
+{
+    tear_countdown = after_bytes;
+    tear_seed = seed;
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_sim_flash_power_up
+ ********************************************************************************
+ * Summary:
+ *  Restores the power after a torn operation and disarms a pending one.
+ *
+ * Parameters:
+ *  None
+ *
+ * Return:
+ *  true if an armed power loss had happened
+ *******************************************************************************/
+bool pasco2_sim_flash_power_up(void)
+{
+    bool torn = powered_down;
+
+    powered_down = false;
+    tear_countdown = 0U;
+
+    return torn;
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_sim_flash_erase_count
+ ********************************************************************************
+ * Summary:
+ *  Returns how often a row of the work flash was erased.
+ *
+ * Parameters:
+ *  row: row index
+ *
+ * Return:
+ *  Erase count
+ *******************************************************************************/
+uint32_t pasco2_sim_flash_erase_count(uint32_t row)
+{
+    CY_ASSERT(row < PASCO2_SIM_FLASH_ROWS);
+
+    return erase_counts[row];
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_sim_flash_load
+ ********************************************************************************
+ * Summary:
+ *  Loads the work flash content from an image file. A missing file leaves
+ *  the flash erased.
+ *
+ * Parameters:
+ *  path: image file
+ *
+ * Return:
+ *  false if the file exists but is not an image of the work flash
+ *******************************************************************************/
+bool pasco2_sim_flash_load(const char *path)
+{
+    FILE *file = fopen(path, "rb");
+
+    flash_format();
+    if (file == NULL)
+    {
+        return true;
+    }
+
+    bool loaded = (fread(flash_data, 1U, sizeof(flash_data), file) == sizeof(flash_data)) &&
+                  (fread(erase_counts, 1U, sizeof(erase_counts), file) == sizeof(erase_counts));
+    fclose(file);
+
+    return loaded;
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_sim_flash_save
+ ********************************************************************************
+ * Summary:
+ *  Stores the work flash content and the erase counts in an image file.
+ *
+ * Parameters:
+ *  path: image file
+ *
+ * Return:
+ *  false if the file could not be written
+ *******************************************************************************/
+bool pasco2_sim_flash_save(const char *path)
+{
+    FILE *file = fopen(path, "wb");
+
+    if (file == NULL)
+    {
+        return false;
+    }
+
+    bool saved = (fwrite(flash_data, 1U, sizeof(flash_data), file) == sizeof(flash_data)) &&
+                 (fwrite(erase_counts, 1U, sizeof(erase_counts), file) == sizeof(erase_counts));
+
+    return (fclose(file) == 0) && saved;
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_sim_flash_report
+ ********************************************************************************
+ * Summary:
+ *  Prints the flash counters.
+ *
+ * Parameters:
+ *  out: report stream
+ *
+ * Return:
+ *  None
+ *******************************************************************************/
+void pasco2_sim_flash_report(FILE *out)
+{
+    uint32_t min = UINT32_MAX;
+    uint32_t max = 0U;
+    uint64_t total = 0U;
+
+    for (uint32_t row = 0U; row < PASCO2_SIM_FLASH_ROWS; row++)
+    {
+        min = (erase_counts[row] < min) ? erase_counts[row] : min;
+        max = (erase_counts[row] > max) ? erase_counts[row] : max;
+        total += erase_counts[row];
+    }
+    fprintf(out, "Work flash: %" PRIu32 " reads, %" PRIu32 " row programs, %" PRIu64 " row erases, per row min %"
+            PRIu32 " max %" PRIu32 "\n", flash_reads, flash_programs, total, min, max);
+}
+
+/*******************************************************************************
+ * Function Name: cyhal_flash_init
+ ********************************************************************************
+ * Summary:
+ *  Initializes the flash driver.
+ *
+ * Parameters:
+ *  obj: flash object
+ *
+ * Return:
+ *  CY_RSLT_SUCCESS
+ *******************************************************************************/
+cy_rslt_t cyhal_flash_init(cyhal_flash_t *obj)
+{
+    flash_format();
+    obj->initialized = true;
+
+    return CY_RSLT_SUCCESS;
+}
+
+/*******************************************************************************
+ * Function Name: cyhal_flash_free
+ ********************************************************************************
+ * Summary:
+ *  Releases the flash driver.
+ *
+ * Parameters:
+ *  obj: flash object
+ *
+ * Return:
+ *  None
+ *******************************************************************************/
+void cyhal_flash_free(cyhal_flash_t *obj)
+{
+    obj->initialized = false;
+}
+
+/*******************************************************************************
+ * Function Name: cyhal_flash_get_info
+ ********************************************************************************
+ * Summary:
+ *  Describes the flash blocks. Only the work flash is modelled.
+ *
+ * Parameters:
+ *  obj: flash object
+ *  info: destination of the description
+ *
+ * Return:
+ *  None
+ *******************************************************************************/
+void cyhal_flash_get_info(const cyhal_flash_t *obj, cyhal_flash_info_t *info)
+{
+    CY_UNUSED_PARAMETER(obj);
+
+    info->block_count = (uint8_t)(sizeof(flash_blocks) / sizeof(flash_blocks[0]));
+    info->blocks = flash_blocks;
+}
+
+/*******************************************************************************
+ * Function Name: cyhal_flash_read
+ ********************************************************************************
+ * Summary:
+ *  Copies flash content, which the CPU reads at memory speed.
+ *
+ * Parameters:
+ *  obj: flash object
+ *  address: start address
+ *  data: destination
+ *  size: number of bytes
+ *
+ * Return:
+ *  CY_RSLT_SUCCESS, CYHAL_FLASH_RSLT_ERR_ADDRESS outside the work flash
+ *******************************************************************************/
+cy_rslt_t cyhal_flash_read(cyhal_flash_t *obj, uint32_t address, uint8_t *data, size_t size)
+{
+    CY_ASSERT(obj->initialized);
+
+    if ((address < CY_EM_EEPROM_BASE) || ((address - CY_EM_EEPROM_BASE) > CY_EM_EEPROM_SIZE) ||
+        (size > (CY_EM_EEPROM_SIZE - (address - CY_EM_EEPROM_BASE))))
+    {
+        return CYHAL_FLASH_RSLT_ERR_ADDRESS;
+    }
+    memcpy(data, &flash_data[address - CY_EM_EEPROM_BASE], size);
+    flash_reads++;
+
+    return CY_RSLT_SUCCESS;
+}
+
+/*******************************************************************************
+ * Function Name: cyhal_flash_erase
+ ********************************************************************************
+ * Summary:
+ *  Erases a row, the CPU waits for it.
+ *
+ * Parameters:
+ *  obj: flash object
+ *  address: start of the row
+ *
+ * Return:
+ *  CY_RSLT_SUCCESS, CYHAL_FLASH_RSLT_ERR_ADDRESS if it is not a row of the
+ *  work flash, CYHAL_FLASH_RSLT_ERR_POWER after a power loss
+ *******************************************************************************/
+cy_rslt_t cyhal_flash_erase(cyhal_flash_t *obj, uint32_t address)
+{
+    uint32_t row;
+
+    CY_ASSERT(obj->initialized);
+    if (!flash_row(address, &row))
+    {
+        return CYHAL_FLASH_RSLT_ERR_ADDRESS;
+    }
+    pasco2_sim_consume(PASCO2_SIM_FLASH_ERASE_US);
+
+    return flash_operate(row, true, NULL) ? CY_RSLT_SUCCESS : CYHAL_FLASH_RSLT_ERR_POWER;
+}
+
+/*******************************************************************************
+ * Function Name: cyhal_flash_write
+ ********************************************************************************
+ * Summary:
+ *  Erases and programs a row, the CPU waits for it.
+ *
+ * Parameters:
+ *  obj: flash object
+ *  address: start of the row
+ *  data: content of the row
+ *
+ * Return:
+ *  CY_RSLT_SUCCESS, CYHAL_FLASH_RSLT_ERR_ADDRESS if it is not a row of the
+ *  work flash, CYHAL_FLASH_RSLT_ERR_POWER after a power loss
+ *******************************************************************************/
+cy_rslt_t cyhal_flash_write(cyhal_flash_t *obj, uint32_t address, const uint32_t *data)
+{
+    uint32_t row;
+
+    CY_ASSERT(obj->initialized);
+    if (!flash_row(address, &row))
+    {
+        return CYHAL_FLASH_RSLT_ERR_ADDRESS;
+    }
+    pasco2_sim_consume(PASCO2_SIM_FLASH_ERASE_US + PASCO2_SIM_FLASH_PROGRAM_US);
+    flash_programs++;
+
+    return flash_operate(row, true, (const uint8_t *)data) ? CY_RSLT_SUCCESS : CYHAL_FLASH_RSLT_ERR_POWER;
+}
+
+/*******************************************************************************
+ * Function Name: cyhal_flash_program
+ ********************************************************************************
+ * Summary:
+ *  Programs a row without erasing it first, bits only change from the
+ *  erased value.
+ *
+ * Parameters:
+ *  obj: flash object
+ *  address: start of the row
+ *  data: content of the row
+ *
+ * Return:
+ *  CY_RSLT_SUCCESS, CYHAL_FLASH_RSLT_ERR_ADDRESS if it is not a row of the
+ *  work flash, CYHAL_FLASH_RSLT_ERR_POWER after a power loss
+ *******************************************************************************/
+cy_rslt_t cyhal_flash_program(cyhal_flash_t *obj, uint32_t address, const uint32_t *data)
+{
+    uint32_t row;
+
+    CY_ASSERT(obj->initialized);
+    if (!flash_row(address, &row))
+    {
+        return CYHAL_FLASH_RSLT_ERR_ADDRESS;
+    }
+    pasco2_sim_consume(PASCO2_SIM_FLASH_PROGRAM_US);
+    flash_programs++;
+
+    return flash_operate(row, false, (const uint8_t *)data) ? CY_RSLT_SUCCESS : CYHAL_FLASH_RSLT_ERR_POWER;
+}
+
+/* [] END OF FILE */
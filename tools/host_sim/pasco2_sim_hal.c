@@ -0,0 +1,1378 @@
+/*****************************************************************************
+** File name: pasco2_sim_hal.c
+**
+** Description: This file implements the HAL, BSP and retarget-io calls of the
+**   firmware on simulated peripherals: GPIO pins with edge interrupts, I2C
+**   buses with transfer times derived from the bus clock, the debug UART with
+**   its FIFOs at the console baud rate, timers, and the deep sleep lock.
+**
+** ===========================================================================
+** Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+** ===========================================================================
+**
+** ===========================================================================
+** Infineon Technologies AG (INFINEON) is supplying this file for use
+** exclusively with Infineon's sensor products. This file can be freely
+** distributed within development tools and software supporting such
+** products.
+**
+** THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+** OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+** MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+** INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+** WHATSOEVER.
+** ===========================================================================
+*/
+
+/* Header file from system */
+#include <inttypes.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Header file includes */
+#include "cybsp.h"
+#include "cy_retarget_io.h"
+#include "pasco2_sim.h"
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+/* Fixed cost of an I2C transfer: driver setup and interrupt latency */
+#define PASCO2_SIM_I2C_OVERHEAD_US      (20U)
+
+/* Bits on the wire per I2C byte: 8 data bits and the acknowledge */
+#define PASCO2_SIM_I2C_BITS_PER_BYTE    (9U)
+
+/* Bits on the wire per UART character: start, 8 data bits, stop */
+#define PASCO2_SIM_UART_BITS_PER_CHAR   (10U)
+
+/*******************************************************************************
+ * Types
+ ******************************************************************************/
+typedef struct
+{
+    bool driven;                /* Input level set by a device model */
+    bool output;                /* Level driven by the firmware */
+    bool input;                 /* Level driven by the outside world */
+    bool held;                  /* Pulled low by a device on the bus */
+    cyhal_gpio_direction_t direction;
+    cyhal_gpio_event_t events;
+    cyhal_gpio_event_t pending;
+    cyhal_gpio_callback_data_t *callback;
+    pasco2_sim_event_t irq;
+    uint32_t transitions;
+    uint32_t writes;            /* Output writes by the firmware, including unchanged levels */
+    uint32_t changed_writes;    /* Output writes that changed the level */
+    void (*watch)(void *arg, bool level); /* Board component switched by the pin */
+    void *watch_arg;
+} pasco2_sim_gpio_t;
+
+typedef struct
+{
+    uint32_t transfers;
+    uint32_t async_transfers;
+    uint32_t bytes;
+    uint32_t nacks;
+    uint32_t busy_rejects;
+    uint32_t stuck_rejects;     /* Transfers failed while a device held SDA low */
+    uint32_t clock_pulses;      /* SCL pulses of the firmware while SDA was held */
+    uint64_t busy_us;
+} pasco2_sim_i2c_stats_t;
+
+struct pasco2_sim_i2c_bus
+{
+    uint8_t index;
+    cyhal_gpio_t sda;
+    cyhal_gpio_t scl;
+    uint32_t frequency;
+    bool busy;
+    uint8_t stuck_pulses;       /* SCL pulses until the device releases SDA, 0 if not stuck */
+    uint64_t released_us;       /* Time SDA was last released */
+    pasco2_sim_i2c_device_t *devices;
+    cyhal_i2c_event_callback_t callback;
+    void *callback_arg;
+    cyhal_i2c_event_t events;
+    pasco2_sim_event_t done;
+    uint16_t address;
+    const uint8_t *tx;
+    size_t tx_size;
+    uint8_t *rx;
+    size_t rx_size;
+    pasco2_sim_i2c_stats_t stats;
+};
+
+typedef struct pasco2_sim_uart_input
+{
+    uint64_t at_us;
+    char *text;
+    size_t position;
+    struct pasco2_sim_uart_input *next;
+} pasco2_sim_uart_input_t;
+
+struct pasco2_sim_uart
+{
+    uint32_t char_us;
+    uint8_t rx[PASCO2_SIM_UART_FIFO_DEPTH];
+    uint32_t rx_head;
+    uint32_t rx_count;
+    uint64_t tx_empty_us;       /* Time at which the TX FIFO drains */
+    bool tx_async;              /* Asynchronous write in progress */
+    pasco2_sim_event_t tx_done;
+    cyhal_uart_event_callback_t callback;
+    void *callback_arg;
+    cyhal_uart_event_t events;
+    pasco2_sim_event_t irq;
+    pasco2_sim_event_t feed;
+    pasco2_sim_uart_input_t *inputs;
+    FILE *console;
+    uint32_t rx_bytes;
+    uint32_t rx_lost;           /* Bytes that arrived during deep sleep */
+    uint32_t rx_overflows;
+    uint32_t tx_bytes;
+    uint32_t tx_async_writes;
+    uint64_t tx_blocked_us;
+};
+
+struct pasco2_sim_timer
+{
+    cyhal_timer_cfg_t cfg;
+    uint32_t frequency;
+    bool running;
+    cyhal_timer_event_callback_t callback;
+    void *callback_arg;
+    cyhal_timer_event_t events;
+    pasco2_sim_event_t irq;
+};
+
+/*******************************************************************************
+ * Global variables
+ ******************************************************************************/
+uint32_t SystemCoreClock = 150000000UL;
+cyhal_uart_t cy_retarget_io_uart_obj;
+
+static pasco2_sim_gpio_t gpios[CYHAL_GPIO_COUNT];
+static struct pasco2_sim_i2c_bus i2c_buses[PASCO2_SIM_I2C_BUS_COUNT];
+static uint8_t i2c_bus_count;
+static struct pasco2_sim_uart debug_uart;
+static uint32_t deepsleep_locks;
+
+/*******************************************************************************
+ * Function Prototypes
+ ******************************************************************************/
+static void i2c_scl_rise(cyhal_gpio_t pin);
+
+/*******************************************************************************
+ * Function Name: pasco2_sim_hal_init
+ ********************************************************************************
+ * Summary:
+ *  Sets up the simulated peripherals.
+ *
+ * Parameters:
+ *  console: host stream receiving the debug UART output
+ *
+ * Return:
+ *  None
+ *******************************************************************************/
+void pasco2_sim_hal_init(FILE *console)
+{
+    for (uint8_t i = 0U; i < PASCO2_SIM_I2C_BUS_COUNT; i++)
+    {
+        i2c_buses[i].index = i;
+        i2c_buses[i].sda = NC;
+        i2c_buses[i].scl = NC;
+        i2c_buses[i].frequency = 100000UL;
+        i2c_buses[i].released_us = PASCO2_SIM_TIME_NEVER;
+    }
+
+    debug_uart.char_us = (PASCO2_SIM_UART_BITS_PER_CHAR * 1000000UL + CY_RETARGET_IO_BAUDRATE - 1U) /
+                         CY_RETARGET_IO_BAUDRATE;
+    debug_uart.console = console;
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_sim_hal_deepsleep_locked
+ ********************************************************************************
+ * Summary:
+ *  Tells whether a driver prevents deep sleep.
+ *
+ * Parameters:
+ *  None
+ *
+ * Return:
+ *  True if the deep sleep lock is held
+ *******************************************************************************/
+bool pasco2_sim_hal_deepsleep_locked(void)
+{
+    return deepsleep_locks > 0U;
+}
+
+/*******************************************************************************
+ * Function Name: cybsp_init
+ ********************************************************************************
+ * Summary:
+ *  Initializes the simulated board.
+ *
+ * Parameters:
+ *  None
+ *
+ * Return:
+ *  cy_rslt_t: CY_RSLT_SUCCESS
+ *******************************************************************************/
+cy_rslt_t cybsp_init(void)
+{
+    return CY_RSLT_SUCCESS;
+}
+
+/*******************************************************************************
+ * Function Name: cy_retarget_io_init
+ ********************************************************************************
+ * Summary:
+ *  Connects the debug UART object to the simulated UART.
+ *
+ * Parameters:
+ *  tx: TX pin
+ *  rx: RX pin
+ *  baudrate: baud rate
+ *
+ * Return:
+ *  cy_rslt_t: CY_RSLT_SUCCESS
+ *******************************************************************************/
+cy_rslt_t cy_retarget_io_init(cyhal_gpio_t tx, cyhal_gpio_t rx, uint32_t baudrate)
+{
+    CY_UNUSED_PARAMETER(tx);
+    CY_UNUSED_PARAMETER(rx);
+
+    debug_uart.char_us = (PASCO2_SIM_UART_BITS_PER_CHAR * 1000000UL + baudrate - 1U) / baudrate;
+    cy_retarget_io_uart_obj.sim = &debug_uart;
+
+    return CY_RSLT_SUCCESS;
+}
+
+/*******************************************************************************
+ * Function Name: _write
+ ********************************************************************************
+ * Summary:
+ *  stdout hook of retarget-io, used unless the firmware replaces it. Sends
+ *  the characters and spins while the TX FIFO is full.
+ *
+ * Parameters:
+ *  fd: file descriptor
+ *  ptr: characters to write
+ *  len: number of characters
+ *
+ * Return:
+ *  Number of characters written
+ *******************************************************************************/
+__attribute__((weak)) int _write(int fd, const char *ptr, int len)
+{
+    CY_UNUSED_PARAMETER(fd);
+
+    pasco2_sim_uart_transmit(ptr, (size_t)len);
+
+    return len;
+}
+
+/*******************************************************************************
+ * Function Name: gpio_irq
+ ********************************************************************************
+ * Summary:
+ *  Delivers the pending edges of a pin to its callback.
+ *
+ * Parameters:
+ *  arg: pin state
+ *
+ * Return:
+ *  None
+ *******************************************************************************/
+static void gpio_irq(void *arg)
+{
+    pasco2_sim_gpio_t *gpio = arg;
+    cyhal_gpio_event_t event = gpio->pending;
+
+    gpio->pending = CYHAL_GPIO_IRQ_NONE;
+    if (gpio->callback != NULL)
+    {
+        gpio->callback->callback(gpio->callback->callback_arg, event);
+    }
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_sim_gpio_drive
+ ********************************************************************************
+ * Summary:
+ *  Drives a pin from outside the MCU and raises its edge interrupt.
+ *
+ * Parameters:
+ *  pin: pin to drive, NC is ignored
+ *  level: new level
+ *
+ * Return:
+ *  None
+ *******************************************************************************/
+void pasco2_sim_gpio_drive(cyhal_gpio_t pin, bool level)
+{
+    if (pin >= CYHAL_GPIO_COUNT)
+    {
+        return;
+    }
+
+    pasco2_sim_gpio_t *gpio = &gpios[pin];
+    cyhal_gpio_event_t edge = level ? CYHAL_GPIO_IRQ_RISE : CYHAL_GPIO_IRQ_FALL;
+
+    if (gpio->driven && (gpio->input == level))
+    {
+        return;
+    }
+    gpio->driven = true;
+    gpio->input = level;
+    gpio->transitions++;
+
+    if ((gpio->events & edge) != 0U)
+    {
+        gpio->pending |= edge;
+        if (!gpio->irq.pending)
+        {
+            pasco2_sim_event_schedule(&gpio->irq, pasco2_sim_now_us(), gpio_irq, gpio);
+        }
+    }
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_sim_gpio_watch
+ ********************************************************************************
+ * Summary:
+ *  Connects a board component, such as a power switch, to an output pin. The
+ *  handler is called on every level change written by the firmware.
+ *
+ * Parameters:
+ *  pin: output pin
+ *  handler: called with the new level
+ *  arg: argument of the handler
+ *
+ * Return:
+ *  None
+ *******************************************************************************/
+void pasco2_sim_gpio_watch(cyhal_gpio_t pin, void (*handler)(void *arg, bool level), void *arg)
+{
+    CY_ASSERT(pin < CYHAL_GPIO_COUNT);
+
+    gpios[pin].watch = handler;
+    gpios[pin].watch_arg = arg;
+}
+
+/* GPIO calls of the HAL, see cyhal.h */
+cy_rslt_t cyhal_gpio_init(cyhal_gpio_t pin, cyhal_gpio_direction_t direction, cyhal_gpio_drive_mode_t drive_mode,
+                          bool init_val)
+{
+    CY_UNUSED_PARAMETER(drive_mode);
+
+    if (pin >= CYHAL_GPIO_COUNT)
+    {
+        return CYHAL_RSLT_ERR_BAD_ARGUMENT;
+    }
+
+    pasco2_sim_gpio_t *gpio = &gpios[pin];
+    gpio->direction = direction;
+    gpio->output = init_val;
+    if (!gpio->driven)
+    {
+        gpio->input = init_val;
+    }
+
+    return CY_RSLT_SUCCESS;
+}
+
+void cyhal_gpio_free(cyhal_gpio_t pin)
+{
+    if (pin < CYHAL_GPIO_COUNT)
+    {
+        gpios[pin].events = CYHAL_GPIO_IRQ_NONE;
+        gpios[pin].callback = NULL;
+    }
+}
+
+void cyhal_gpio_write(cyhal_gpio_t pin, bool value)
+{
+    CY_ASSERT(pin < CYHAL_GPIO_COUNT);
+
+    gpios[pin].writes++;
+    if (gpios[pin].output == value)
+    {
+        return;
+    }
+    gpios[pin].transitions++;
+    gpios[pin].changed_writes++;
+    gpios[pin].output = value;
+
+    if (value)
+    {
+        i2c_scl_rise(pin);
+    }
+    if (gpios[pin].watch != NULL)
+    {
+        gpios[pin].watch(gpios[pin].watch_arg, value);
+    }
+}
+
+bool cyhal_gpio_read(cyhal_gpio_t pin)
+{
+    CY_ASSERT(pin < CYHAL_GPIO_COUNT);
+
+    if (gpios[pin].held)
+    {
+        return false;
+    }
+
+    return (gpios[pin].direction == CYHAL_GPIO_DIR_INPUT) ? gpios[pin].input : gpios[pin].output;
+}
+
+void cyhal_gpio_toggle(cyhal_gpio_t pin)
+{
+    cyhal_gpio_write(pin, !cyhal_gpio_read(pin));
+}
+
+void cyhal_gpio_register_callback(cyhal_gpio_t pin, cyhal_gpio_callback_data_t *callback_data)
+{
+    CY_ASSERT(pin < CYHAL_GPIO_COUNT);
+
+    if (callback_data != NULL)
+    {
+        callback_data->pin = pin;
+    }
+    gpios[pin].callback = callback_data;
+}
+
+void cyhal_gpio_enable_event(cyhal_gpio_t pin, cyhal_gpio_event_t event, uint8_t intr_priority, bool enable)
+{
+    CY_ASSERT(pin < CYHAL_GPIO_COUNT);
+    CY_UNUSED_PARAMETER(intr_priority);
+
+    if (enable)
+    {
+        gpios[pin].events |= event;
+    }
+    else
+    {
+        gpios[pin].events &= ~event;
+    }
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_sim_i2c_attach
+ ********************************************************************************
+ * Summary:
+ *  Connects a device model to a bus. Buses are numbered in the order the
+ *  firmware initializes them.
+ *
+ * Parameters:
+ *  bus: bus index
+ *  device: device model
+ *
+ * Return:
+ *  None
+ *******************************************************************************/
+void pasco2_sim_i2c_attach(uint8_t bus, pasco2_sim_i2c_device_t *device)
+{
+    CY_ASSERT(bus < PASCO2_SIM_I2C_BUS_COUNT);
+
+    device->next = i2c_buses[bus].devices;
+    i2c_buses[bus].devices = device;
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_sim_i2c_stick
+ ********************************************************************************
+ * Summary:
+ *  Lets a device hold SDA low in the middle of a byte, as after a transfer
+ *  interrupted by a reset of the master. All transfers fail until the
+ *  firmware has pulsed SCL often enough for the device to release SDA.
+ *
+ * Parameters:
+ *  bus: bus index
+ *  pulses: SCL pulses until SDA is released, 1 to 9
+ *
+ * Return:
+ *  None
+ *******************************************************************************/
+void pasco2_sim_i2c_stick(uint8_t bus, uint8_t pulses)
+{
+    CY_ASSERT(bus < PASCO2_SIM_I2C_BUS_COUNT);
+    CY_ASSERT((pulses > 0U) && (i2c_buses[bus].sda != NC));
+
+    i2c_buses[bus].stuck_pulses = pulses;
+    i2c_buses[bus].released_us = PASCO2_SIM_TIME_NEVER;
+    gpios[i2c_buses[bus].sda].held = true;
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_sim_i2c_released_us
+ ********************************************************************************
+ * Summary:
+ *  Returns the time a device last released SDA.
+ *
+ * Parameters:
+ *  bus: bus index
+ *
+ * Return:
+ *  Virtual time, PASCO2_SIM_TIME_NEVER if SDA is held or was never held
+ *******************************************************************************/
+uint64_t pasco2_sim_i2c_released_us(uint8_t bus)
+{
+    CY_ASSERT(bus < PASCO2_SIM_I2C_BUS_COUNT);
+
+    return i2c_buses[bus].released_us;
+}
+
+/*******************************************************************************
+ * Function Name: i2c_scl_rise
+ ********************************************************************************
+ * Summary:
+ *  Clocks the device holding SDA on a bus whose SCL pin the firmware drives
+ *  as a GPIO.
+ *
+ * Parameters:
+ *  pin: pin driven high
+ *
+ * Return:
+ *  None
+ *******************************************************************************/
+static void i2c_scl_rise(cyhal_gpio_t pin)
+{
+    for (uint8_t i = 0U; i < i2c_bus_count; i++)
+    {
+        struct pasco2_sim_i2c_bus *bus = &i2c_buses[i];
+        if ((bus->scl != pin) || (bus->stuck_pulses == 0U))
+        {
+            continue;
+        }
+
+        bus->stats.clock_pulses++;
+        bus->stuck_pulses--;
+        if (bus->stuck_pulses == 0U)
+        {
+            gpios[bus->sda].held = false;
+            bus->released_us = pasco2_sim_now_us();
+        }
+    }
+}
+
+/*******************************************************************************
+ * Function Name: i2c_find
+ ********************************************************************************
+ * Summary:
+ *  Returns the device answering an address. A device behind a mux answers
+ *  only while its channel is enabled.
+ *
+ * Parameters:
+ *  bus: bus
+ *  address: 7-bit address
+ *
+ * Return:
+ *  Device, NULL if the address is not acknowledged
+ *******************************************************************************/
+static pasco2_sim_i2c_device_t *i2c_find(struct pasco2_sim_i2c_bus *bus, uint16_t address)
+{
+    for (pasco2_sim_i2c_device_t *device = bus->devices; device != NULL; device = device->next)
+    {
+        if ((device->address == address) &&
+            ((device->gate == NULL) || ((*device->gate & device->gate_mask) != 0U)))
+        {
+            return device;
+        }
+    }
+
+    return NULL;
+}
+
+/*******************************************************************************
+ * Function Name: i2c_duration_us
+ ********************************************************************************
+ * Summary:
+ *  Returns the time a transfer occupies the bus: the address and data bytes
+ *  of each phase at the bus clock plus a fixed driver overhead.
+ *
+ * Parameters:
+ *  bus: bus
+ *  tx_size: bytes written
+ *  rx_size: bytes read
+ *
+ * Return:
+ *  Duration in microseconds
+ *******************************************************************************/
+static uint64_t i2c_duration_us(const struct pasco2_sim_i2c_bus *bus, size_t tx_size, size_t rx_size)
+{
+    uint64_t bits = 1U;
+
+    if (tx_size > 0U)
+    {
+        bits += 1U + (tx_size + 1U) * PASCO2_SIM_I2C_BITS_PER_BYTE;
+    }
+    if (rx_size > 0U)
+    {
+        bits += 1U + (rx_size + 1U) * PASCO2_SIM_I2C_BITS_PER_BYTE;
+    }
+
+    return PASCO2_SIM_I2C_OVERHEAD_US + ((bits * 1000000U) + bus->frequency - 1U) / bus->frequency;
+}
+
+/*******************************************************************************
+ * Function Name: i2c_execute
+ ********************************************************************************
+ * Summary:
+ *  Performs the write and read phases of a transfer on the device models.
+ *
+ * Parameters:
+ *  bus: bus
+ *  address: 7-bit address
+ *  tx, tx_size: bytes written, skipped if empty
+ *  rx, rx_size: bytes read, skipped if empty
+ *
+ * Return:
+ *  False if the device did not acknowledge
+ *******************************************************************************/
+static bool i2c_execute(struct pasco2_sim_i2c_bus *bus, uint16_t address, const uint8_t *tx, size_t tx_size,
+                        uint8_t *rx, size_t rx_size)
+{
+    pasco2_sim_i2c_device_t *device = i2c_find(bus, address);
+    bool ack = (device != NULL) && (bus->stuck_pulses == 0U);
+
+    if (bus->stuck_pulses > 0U)
+    {
+        bus->stats.stuck_rejects++;
+    }
+    if (ack && (tx_size > 0U))
+    {
+        ack = device->write(device, tx, tx_size);
+    }
+    if (ack && (rx_size > 0U))
+    {
+        ack = device->read(device, rx, rx_size);
+    }
+
+    bus->stats.transfers++;
+    bus->stats.bytes += (uint32_t)(tx_size + rx_size);
+    bus->stats.busy_us += i2c_duration_us(bus, tx_size, rx_size);
+    if (!ack)
+    {
+        bus->stats.nacks++;
+    }
+
+    return ack;
+}
+
+/*******************************************************************************
+ * Function Name: i2c_blocking
+ ********************************************************************************
+ * Summary:
+ *  Runs a blocking transfer: the calling task holds the bus and spins for the
+ *  transfer time.
+ *
+ * Parameters:
+ *  bus: bus
+ *  address: 7-bit address
+ *  tx, tx_size: bytes written
+ *  rx, rx_size: bytes read
+ *
+ * Return:
+ *  cy_rslt_t: CY_RSLT_SUCCESS, CYHAL_I2C_RSLT_ERR_NACK,
+ *  CYHAL_I2C_RSLT_ERR_BUS_BUSY
+ *******************************************************************************/
+static cy_rslt_t i2c_blocking(struct pasco2_sim_i2c_bus *bus, uint16_t address, const uint8_t *tx, size_t tx_size,
+                              uint8_t *rx, size_t rx_size)
+{
+    if (bus->busy)
+    {
+        bus->stats.busy_rejects++;
+        return CYHAL_I2C_RSLT_ERR_BUS_BUSY;
+    }
+
+    bool ack = i2c_execute(bus, address, tx, tx_size, rx, rx_size);
+
+    bus->busy = true;
+    pasco2_sim_consume(i2c_duration_us(bus, tx_size, rx_size));
+    bus->busy = false;
+
+    return ack ? CY_RSLT_SUCCESS : CYHAL_I2C_RSLT_ERR_NACK;
+}
+
+/* I2C calls of the HAL, see cyhal.h */
+cy_rslt_t cyhal_i2c_init(cyhal_i2c_t *obj, cyhal_gpio_t sda, cyhal_gpio_t scl, const void *clk)
+{
+    CY_UNUSED_PARAMETER(clk);
+
+    /* A master initialized again on its pins gets its bus back */
+    for (uint8_t i = 0U; i < i2c_bus_count; i++)
+    {
+        if ((i2c_buses[i].sda == sda) && (i2c_buses[i].scl == scl))
+        {
+            obj->sim = &i2c_buses[i];
+            return CY_RSLT_SUCCESS;
+        }
+    }
+
+    if (i2c_bus_count >= PASCO2_SIM_I2C_BUS_COUNT)
+    {
+        return CYHAL_RSLT_ERR_BAD_ARGUMENT;
+    }
+    obj->sim = &i2c_buses[i2c_bus_count++];
+    obj->sim->sda = sda;
+    obj->sim->scl = scl;
+
+    return CY_RSLT_SUCCESS;
+}
+
+void cyhal_i2c_free(cyhal_i2c_t *obj)
+{
+    (void)cyhal_i2c_abort_async(obj);
+}
+
+cy_rslt_t cyhal_i2c_configure(cyhal_i2c_t *obj, const cyhal_i2c_cfg_t *cfg)
+{
+    if ((cfg->is_slave != CYHAL_I2C_MODE_SLAVE) && (cfg->frequencyhal_hz == 0U))
+    {
+        return CYHAL_RSLT_ERR_BAD_ARGUMENT;
+    }
+    obj->sim->frequency = cfg->frequencyhal_hz;
+
+    return CY_RSLT_SUCCESS;
+}
+
+cy_rslt_t cyhal_i2c_master_write(cyhal_i2c_t *obj, uint16_t dev_addr, const uint8_t *data, uint16_t size,
+                                 uint32_t timeout, bool send_stop)
+{
+    CY_UNUSED_PARAMETER(timeout);
+    CY_UNUSED_PARAMETER(send_stop);
+
+    return i2c_blocking(obj->sim, dev_addr, data, size, NULL, 0U);
+}
+
+cy_rslt_t cyhal_i2c_master_read(cyhal_i2c_t *obj, uint16_t dev_addr, uint8_t *data, uint16_t size,
+                                uint32_t timeout, bool send_stop)
+{
+    CY_UNUSED_PARAMETER(timeout);
+    CY_UNUSED_PARAMETER(send_stop);
+
+    return i2c_blocking(obj->sim, dev_addr, NULL, 0U, data, size);
+}
+
+cy_rslt_t cyhal_i2c_master_mem_write(cyhal_i2c_t *obj, uint16_t address, uint16_t mem_addr, uint16_t mem_addr_size,
+                                     const uint8_t *data, uint16_t size, uint32_t timeout)
+{
+    uint8_t buffer[2U + UINT8_MAX];
+
+    CY_UNUSED_PARAMETER(timeout);
+
+    if ((mem_addr_size < 1U) || (mem_addr_size > 2U) || (size > UINT8_MAX))
+    {
+        return CYHAL_RSLT_ERR_BAD_ARGUMENT;
+    }
+    if (mem_addr_size == 2U)
+    {
+        buffer[0] = (uint8_t)(mem_addr >> 8U);
+    }
+    buffer[mem_addr_size - 1U] = (uint8_t)mem_addr;
+    memcpy(&buffer[mem_addr_size], data, size);
+
+    return i2c_blocking(obj->sim, address, buffer, (size_t)mem_addr_size + size, NULL, 0U);
+}
+
+cy_rslt_t cyhal_i2c_master_mem_read(cyhal_i2c_t *obj, uint16_t address, uint16_t mem_addr, uint16_t mem_addr_size,
+                                    uint8_t *data, uint16_t size, uint32_t timeout)
+{
+    uint8_t buffer[2];
+
+    CY_UNUSED_PARAMETER(timeout);
+
+    if ((mem_addr_size < 1U) || (mem_addr_size > 2U))
+    {
+        return CYHAL_RSLT_ERR_BAD_ARGUMENT;
+    }
+    if (mem_addr_size == 2U)
+    {
+        buffer[0] = (uint8_t)(mem_addr >> 8U);
+    }
+    buffer[mem_addr_size - 1U] = (uint8_t)mem_addr;
+
+    return i2c_blocking(obj->sim, address, buffer, mem_addr_size, data, size);
+}
+
+/*******************************************************************************
+ * Function Name: i2c_async_done
+ ********************************************************************************
+ * Summary:
+ *  Completes an asynchronous transfer and raises the enabled I2C events.
+ *
+ * Parameters:
+ *  arg: bus
+ *
+ * Return:
+ *  None
+ *******************************************************************************/
+static void i2c_async_done(void *arg)
+{
+    struct pasco2_sim_i2c_bus *bus = arg;
+    bool ack = i2c_execute(bus, bus->address, bus->tx, bus->tx_size, bus->rx, bus->rx_size);
+    cyhal_i2c_event_t event;
+
+    bus->busy = false;
+    if (ack)
+    {
+        event = (cyhal_i2c_event_t)(((bus->tx_size > 0U) ? CYHAL_I2C_MASTER_WR_CMPLT_EVENT : 0) |
+                                    ((bus->rx_size > 0U) ? CYHAL_I2C_MASTER_RD_CMPLT_EVENT : 0));
+    }
+    else
+    {
+        event = CYHAL_I2C_MASTER_ERR_EVENT;
+    }
+
+    event &= bus->events;
+    if ((event != CYHAL_I2C_EVENT_NONE) && (bus->callback != NULL))
+    {
+        bus->callback(bus->callback_arg, event);
+    }
+}
+
+cy_rslt_t cyhal_i2c_master_transfer_async(cyhal_i2c_t *obj, uint16_t address, const void *tx, size_t tx_size,
+                                          void *rx, size_t rx_size)
+{
+    struct pasco2_sim_i2c_bus *bus = obj->sim;
+
+    if (bus->busy)
+    {
+        bus->stats.busy_rejects++;
+        return CYHAL_I2C_RSLT_ERR_BUS_BUSY;
+    }
+
+    bus->busy = true;
+    bus->address = address;
+    bus->tx = tx;
+    bus->tx_size = tx_size;
+    bus->rx = rx;
+    bus->rx_size = rx_size;
+    bus->stats.async_transfers++;
+    pasco2_sim_event_schedule(&bus->done, pasco2_sim_now_us() + i2c_duration_us(bus, tx_size, rx_size),
+                              i2c_async_done, bus);
+
+    return CY_RSLT_SUCCESS;
+}
+
+cy_rslt_t cyhal_i2c_abort_async(cyhal_i2c_t *obj)
+{
+    pasco2_sim_event_cancel(&obj->sim->done);
+    obj->sim->busy = false;
+
+    return CY_RSLT_SUCCESS;
+}
+
+void cyhal_i2c_register_callback(cyhal_i2c_t *obj, cyhal_i2c_event_callback_t callback, void *callback_arg)
+{
+    obj->sim->callback = callback;
+    obj->sim->callback_arg = callback_arg;
+}
+
+void cyhal_i2c_enable_event(cyhal_i2c_t *obj, cyhal_i2c_event_t event, uint8_t intr_priority, bool enable)
+{
+    CY_UNUSED_PARAMETER(intr_priority);
+
+    if (enable)
+    {
+        obj->sim->events |= event;
+    }
+    else
+    {
+        obj->sim->events &= ~event;
+    }
+}
+
+/*******************************************************************************
+ * Function Name: uart_irq
+ ********************************************************************************
+ * Summary:
+ *  Raises the RX interrupt of the debug UART while its FIFO holds data.
+ *
+ * Parameters:
+ *  arg: UART
+ *
+ * Return:
+ *  None
+ *******************************************************************************/
+static void uart_irq(void *arg)
+{
+    struct pasco2_sim_uart *uart = arg;
+
+    if ((uart->rx_count > 0U) && ((uart->events & CYHAL_UART_IRQ_RX_NOT_EMPTY) != 0U) &&
+        (uart->callback != NULL))
+    {
+        uart->callback(uart->callback_arg, CYHAL_UART_IRQ_RX_NOT_EMPTY);
+    }
+}
+
+/*******************************************************************************
+ * Function Name: uart_tx_done
+ ********************************************************************************
+ * Summary:
+ *  Ends an asynchronous write once its last character has been sent and
+ *  raises the TX done interrupt.
+ *
+ * Parameters:
+ *  arg: UART
+ *
+ * Return:
+ *  None
+ *******************************************************************************/
+static void uart_tx_done(void *arg)
+{
+    struct pasco2_sim_uart *uart = arg;
+
+    uart->tx_async = false;
+    cyhal_syspm_unlock_deepsleep();
+    if (((uart->events & CYHAL_UART_IRQ_TX_DONE) != 0U) && (uart->callback != NULL))
+    {
+        uart->callback(uart->callback_arg, CYHAL_UART_IRQ_TX_DONE);
+    }
+}
+
+/*******************************************************************************
+ * Function Name: uart_feed
+ ********************************************************************************
+ * Summary:
+ *  Receives the next character of the scripted terminal input, one character
+ *  time after the previous one. Characters arriving in deep sleep are lost.
+ *
+ * Parameters:
+ *  arg: UART
+ *
+ * Return:
+ *  None
+ *******************************************************************************/
+static void uart_feed(void *arg)
+{
+    struct pasco2_sim_uart *uart = arg;
+    pasco2_sim_uart_input_t *input = uart->inputs;
+    uint8_t value = (uint8_t)input->text[input->position++];
+
+    if (pasco2_sim_in_deepsleep())
+    {
+        uart->rx_lost++;
+    }
+    else if (uart->rx_count >= PASCO2_SIM_UART_FIFO_DEPTH)
+    {
+        uart->rx_overflows++;
+    }
+    else
+    {
+        uart->rx[(uart->rx_head + uart->rx_count) % PASCO2_SIM_UART_FIFO_DEPTH] = value;
+        uart->rx_count++;
+        uart->rx_bytes++;
+        uart_irq(uart);
+    }
+
+    uint64_t next = pasco2_sim_now_us() + uart->char_us;
+    if (input->text[input->position] == '\0')
+    {
+        uart->inputs = input->next;
+        free(input->text);
+        free(input);
+        if (uart->inputs == NULL)
+        {
+            return;
+        }
+        next = (uart->inputs->at_us > next) ? uart->inputs->at_us : next;
+    }
+    pasco2_sim_event_schedule(&uart->feed, next, uart_feed, uart);
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_sim_uart_input
+ ********************************************************************************
+ * Summary:
+ *  Scripts terminal input on the debug UART.
+ *
+ * Parameters:
+ *  at_us: virtual time of the first character
+ *  text: characters to send
+ *
+ * Return:
+ *  None
+ *******************************************************************************/
+void pasco2_sim_uart_input(uint64_t at_us, const char *text)
+{
+    struct pasco2_sim_uart *uart = &debug_uart;
+    pasco2_sim_uart_input_t *input = calloc(1U, sizeof(*input));
+
+    if ((input == NULL) || (text[0] == '\0'))
+    {
+        free(input);
+        return;
+    }
+    input->at_us = at_us;
+    input->text = strdup(text);
+
+    pasco2_sim_uart_input_t **link = &uart->inputs;
+    while ((*link != NULL) && ((*link)->at_us <= at_us))
+    {
+        link = &(*link)->next;
+    }
+    input->next = *link;
+    *link = input;
+
+    if (uart->inputs == input)
+    {
+        pasco2_sim_event_schedule(&uart->feed, at_us, uart_feed, uart);
+    }
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_sim_uart_transmit
+ ********************************************************************************
+ * Summary:
+ *  Sends characters on the debug UART. The sender spins while the TX FIFO is
+ *  full, as the blocking retarget-io driver does. The time is charged rather
+ *  than consumed because this runs inside the C library's stdio locks.
+ *
+ * Parameters:
+ *  data: characters to send
+ *  size: number of characters
+ *
+ * Return:
+ *  None
+ *******************************************************************************/
+void pasco2_sim_uart_transmit(const void *data, size_t size)
+{
+    struct pasco2_sim_uart *uart = &debug_uart;
+    uint64_t now = pasco2_sim_now_us();
+    uint64_t start = (uart->tx_empty_us > now) ? uart->tx_empty_us : now;
+    uint64_t fifo_us = (uint64_t)PASCO2_SIM_UART_FIFO_DEPTH * uart->char_us;
+
+    uart->tx_empty_us = start + (uint64_t)size * uart->char_us;
+    if ((uart->tx_empty_us - now) > fifo_us)
+    {
+        uint64_t blocked = uart->tx_empty_us - now - fifo_us;
+        uart->tx_blocked_us += blocked;
+        pasco2_sim_charge(blocked);
+    }
+
+    uart->tx_bytes += (uint32_t)size;
+    (void)fwrite(data, 1U, size, uart->console);
+    pasco2_sim_console_output(data, size);
+}
+
+/* UART calls of the HAL, see cyhal.h */
+cy_rslt_t cyhal_uart_getc(cyhal_uart_t *obj, uint8_t *value, uint32_t timeout)
+{
+    struct pasco2_sim_uart *uart = obj->sim;
+    uint64_t deadline = pasco2_sim_now_us() + (uint64_t)timeout * 1000U;
+
+    while (uart->rx_count == 0U)
+    {
+        if ((timeout != 0U) && (pasco2_sim_now_us() >= deadline))
+        {
+            return CYHAL_UART_RSLT_ERR_TIMEOUT;
+        }
+        pasco2_sim_consume(PASCO2_SIM_POLL_US);
+    }
+
+    *value = uart->rx[uart->rx_head];
+    uart->rx_head = (uart->rx_head + 1U) % PASCO2_SIM_UART_FIFO_DEPTH;
+    uart->rx_count--;
+
+    return CY_RSLT_SUCCESS;
+}
+
+cy_rslt_t cyhal_uart_putc(cyhal_uart_t *obj, uint32_t value)
+{
+    uint8_t character = (uint8_t)value;
+
+    CY_UNUSED_PARAMETER(obj);
+
+    pasco2_sim_uart_transmit(&character, 1U);
+    pasco2_sim_consume(0U);
+
+    return CY_RSLT_SUCCESS;
+}
+
+uint32_t cyhal_uart_readable(cyhal_uart_t *obj)
+{
+    return obj->sim->rx_count;
+}
+
+cy_rslt_t cyhal_uart_read(cyhal_uart_t *obj, void *rx, size_t *rx_length)
+{
+    struct pasco2_sim_uart *uart = obj->sim;
+    uint8_t *data = rx;
+    size_t count = 0U;
+
+    while ((count < *rx_length) && (uart->rx_count > 0U))
+    {
+        data[count++] = uart->rx[uart->rx_head];
+        uart->rx_head = (uart->rx_head + 1U) % PASCO2_SIM_UART_FIFO_DEPTH;
+        uart->rx_count--;
+    }
+    *rx_length = count;
+
+    return CY_RSLT_SUCCESS;
+}
+
+bool cyhal_uart_is_tx_active(cyhal_uart_t *obj)
+{
+    return obj->sim->tx_empty_us > pasco2_sim_now_us();
+}
+
+cy_rslt_t cyhal_uart_write(cyhal_uart_t *obj, void *tx, size_t *tx_length)
+{
+    CY_UNUSED_PARAMETER(obj);
+
+    pasco2_sim_uart_transmit(tx, *tx_length);
+    pasco2_sim_consume(0U);
+
+    return CY_RSLT_SUCCESS;
+}
+
+cy_rslt_t cyhal_uart_set_async_mode(cyhal_uart_t *obj, cyhal_async_mode_t mode, uint8_t dma_priority)
+{
+    CY_UNUSED_PARAMETER(obj);
+    CY_UNUSED_PARAMETER(mode);
+    CY_UNUSED_PARAMETER(dma_priority);
+
+    return CY_RSLT_SUCCESS;
+}
+
+/* The characters are queued behind the TX FIFO without charging the caller.
+ * Deep sleep is refused until the write completes, as the HAL does. */
+cy_rslt_t cyhal_uart_write_async(cyhal_uart_t *obj, void *tx, size_t length)
+{
+    struct pasco2_sim_uart *uart = obj->sim;
+    uint64_t now = pasco2_sim_now_us();
+    uint64_t start = (uart->tx_empty_us > now) ? uart->tx_empty_us : now;
+
+    CY_ASSERT(!uart->tx_async);
+
+    uart->tx_async = true;
+    uart->tx_async_writes++;
+    uart->tx_empty_us = start + (uint64_t)length * uart->char_us;
+    uart->tx_bytes += (uint32_t)length;
+    (void)fwrite(tx, 1U, length, uart->console);
+    pasco2_sim_console_output(tx, length);
+    cyhal_syspm_lock_deepsleep();
+    pasco2_sim_event_schedule(&uart->tx_done, uart->tx_empty_us, uart_tx_done, uart);
+
+    return CY_RSLT_SUCCESS;
+}
+
+void cyhal_uart_register_callback(cyhal_uart_t *obj, cyhal_uart_event_callback_t callback, void *callback_arg)
+{
+    obj->sim->callback = callback;
+    obj->sim->callback_arg = callback_arg;
+}
+
+void cyhal_uart_enable_event(cyhal_uart_t *obj, cyhal_uart_event_t event, uint8_t intr_priority, bool enable)
+{
+    struct pasco2_sim_uart *uart = obj->sim;
+
+    CY_UNUSED_PARAMETER(intr_priority);
+
+    if (enable)
+    {
+        uart->events |= event;
+        if (((event & CYHAL_UART_IRQ_RX_NOT_EMPTY) != 0U) && (uart->rx_count > 0U))
+        {
+            pasco2_sim_event_schedule(&uart->irq, pasco2_sim_now_us(), uart_irq, uart);
+        }
+    }
+    else
+    {
+        uart->events &= ~event;
+    }
+}
+
+/*******************************************************************************
+ * Function Name: timer_period_us
+ ********************************************************************************
+ * Summary:
+ *  Returns the time between two terminal counts of a timer.
+ *
+ * Parameters:
+ *  timer: timer
+ *
+ * Return:
+ *  Period in microseconds
+ *******************************************************************************/
+static uint64_t timer_period_us(const struct pasco2_sim_timer *timer)
+{
+    return (((uint64_t)timer->cfg.period + 1U) * 1000000U) / timer->frequency;
+}
+
+/*******************************************************************************
+ * Function Name: timer_irq
+ ********************************************************************************
+ * Summary:
+ *  Raises the terminal count interrupt and restarts a continuous timer.
+ *
+ * Parameters:
+ *  arg: timer
+ *
+ * Return:
+ *  None
+ *******************************************************************************/
+static void timer_irq(void *arg)
+{
+    struct pasco2_sim_timer *timer = arg;
+
+    if (timer->cfg.is_continuous)
+    {
+        pasco2_sim_event_schedule(&timer->irq, pasco2_sim_now_us() + timer_period_us(timer), timer_irq, timer);
+    }
+    else
+    {
+        timer->running = false;
+    }
+
+    if (((timer->events & CYHAL_TIMER_IRQ_TERMINAL_COUNT) != 0U) && (timer->callback != NULL))
+    {
+        timer->callback(timer->callback_arg, CYHAL_TIMER_IRQ_TERMINAL_COUNT);
+    }
+}
+
+/* Timer calls of the HAL, see cyhal.h */
+cy_rslt_t cyhal_timer_init(cyhal_timer_t *obj, cyhal_gpio_t pin, const void *clk)
+{
+    CY_UNUSED_PARAMETER(pin);
+    CY_UNUSED_PARAMETER(clk);
+
+    obj->sim = calloc(1U, sizeof(*obj->sim));
+    if (obj->sim == NULL)
+    {
+        return CYHAL_RSLT_ERR_BAD_ARGUMENT;
+    }
+    obj->sim->frequency = 1000000UL;
+
+    return CY_RSLT_SUCCESS;
+}
+
+cy_rslt_t cyhal_timer_configure(cyhal_timer_t *obj, const cyhal_timer_cfg_t *cfg)
+{
+    obj->sim->cfg = *cfg;
+
+    return CY_RSLT_SUCCESS;
+}
+
+cy_rslt_t cyhal_timer_set_frequency(cyhal_timer_t *obj, uint32_t hz)
+{
+    if (hz == 0U)
+    {
+        return CYHAL_RSLT_ERR_BAD_ARGUMENT;
+    }
+    obj->sim->frequency = hz;
+
+    return CY_RSLT_SUCCESS;
+}
+
+void cyhal_timer_register_callback(cyhal_timer_t *obj, cyhal_timer_event_callback_t callback, void *callback_arg)
+{
+    obj->sim->callback = callback;
+    obj->sim->callback_arg = callback_arg;
+}
+
+void cyhal_timer_enable_event(cyhal_timer_t *obj, cyhal_timer_event_t event, uint8_t intr_priority, bool enable)
+{
+    CY_UNUSED_PARAMETER(intr_priority);
+
+    if (enable)
+    {
+        obj->sim->events |= event;
+    }
+    else
+    {
+        obj->sim->events &= ~event;
+    }
+}
+
+cy_rslt_t cyhal_timer_start(cyhal_timer_t *obj)
+{
+    struct pasco2_sim_timer *timer = obj->sim;
+
+    timer->running = true;
+    pasco2_sim_event_schedule(&timer->irq, pasco2_sim_now_us() + timer_period_us(timer), timer_irq, timer);
+
+    return CY_RSLT_SUCCESS;
+}
+
+cy_rslt_t cyhal_timer_stop(cyhal_timer_t *obj)
+{
+    obj->sim->running = false;
+    pasco2_sim_event_cancel(&obj->sim->irq);
+
+    return CY_RSLT_SUCCESS;
+}
+
+/* Power management and system calls of the HAL, see cyhal.h */
+void cyhal_syspm_lock_deepsleep(void)
+{
+    deepsleep_locks++;
+}
+
+void cyhal_syspm_unlock_deepsleep(void)
+{
+    CY_ASSERT(deepsleep_locks > 0U);
+
+    deepsleep_locks--;
+}
+
+cy_rslt_t cyhal_system_delay_ms(uint32_t milliseconds)
+{
+    pasco2_sim_consume((uint64_t)milliseconds * 1000U);
+
+    return CY_RSLT_SUCCESS;
+}
+
+void cyhal_system_delay_us(uint16_t microseconds)
+{
+    pasco2_sim_consume(microseconds);
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_sim_hal_report
+ ********************************************************************************
+ * Summary:
+ *  Prints the bus, UART and GPIO counters.
+ *
+ * Parameters:
+ *  out: report stream
+ *
+ * Return:
+ *  None
+ *******************************************************************************/
+void pasco2_sim_hal_report(FILE *out)
+{
+    double total = (pasco2_sim_now_us() > 0U) ? (double)pasco2_sim_now_us() : 1.0;
+
+    for (uint8_t i = 0U; i < i2c_bus_count; i++)
+    {
+        const struct pasco2_sim_i2c_bus *bus = &i2c_buses[i];
+        fprintf(out, "I2C bus %u: %" PRIu32 " transfers (%" PRIu32 " async), %" PRIu32 " bytes, %" PRIu32
+                " NACKs, %" PRIu32 " busy rejects, utilization %.4f %%\n", i, bus->stats.transfers,
+                bus->stats.async_transfers, bus->stats.bytes, bus->stats.nacks, bus->stats.busy_rejects,
+                100.0 * (double)bus->stats.busy_us / total);
+        if ((bus->stats.stuck_rejects > 0U) || (bus->stats.clock_pulses > 0U))
+        {
+            fprintf(out, "I2C bus %u: %" PRIu32 " transfers failed with SDA held low, %" PRIu32
+                    " SCL pulses to release it\n", i, bus->stats.stuck_rejects, bus->stats.clock_pulses);
+        }
+    }
+    fprintf(out, "UART: %" PRIu32 " bytes sent, %" PRIu32 " asynchronous writes, TX blocked %.3f ms, %" PRIu32
+            " bytes received, %" PRIu32 " lost in deep sleep, %" PRIu32 " overflows\n", debug_uart.tx_bytes,
+            debug_uart.tx_async_writes, (double)debug_uart.tx_blocked_us / 1000.0, debug_uart.rx_bytes, debug_uart.rx_lost,
+            debug_uart.rx_overflows);
+
+    uint32_t writes = 0U;
+    uint32_t changes = 0U;
+    for (uint32_t pin = 0U; pin < CYHAL_GPIO_COUNT; pin++)
+    {
+        writes += gpios[pin].writes;
+        changes += gpios[pin].changed_writes;
+    }
+    fprintf(out, "GPIO: %" PRIu32 " output writes, %" PRIu32 " of them changed the level\n", writes, changes);
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,1674 @@
+/*****************************************************************************
+** File name: pasco2_sim_kernel.c
+**
+** Description: This file implements the FreeRTOS and abstraction-rtos calls
+**   of the firmware on a deterministic discrete-event scheduler. Each task
+**   runs on its own host thread, but only the context holding the baton
+**   executes, so the run is reproducible and virtual time advances only
+**   through modelled bus transfers, busy waits and timeouts.
+**
+** ===========================================================================
+** Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+** ===========================================================================
+**
+** ===========================================================================
+** Infineon Technologies AG (INFINEON) is supplying this file for use
+** exclusively with Infineon's sensor products. This file can be freely
+** distributed within development tools and software supporting such
+** products.
+**
+** THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+** OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+** MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+** INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+** WHATSOEVER.
+** ===========================================================================
+*/
+
+/* Header file from system */
+#include <inttypes.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Header file includes */
+#include "cyabs_rtos.h"
+#include "pasco2_sim.h"
+#include "semphr.h"
+#include "stream_buffer.h"
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+/* Length of one tick in virtual microseconds */
+#define PASCO2_SIM_TICK_US              (1000000U / configTICK_RATE_HZ)
+
+/* Host stack of a task, filled with a known value to find the deepest use.
+ * Host code takes more stack than the Cortex-M4 build, so the high-water
+ * marks of the simulation are an upper bound. */
+#define PASCO2_SIM_HOST_STACK_SIZE      (256U * 1024U)
+#define PASCO2_SIM_STACK_FILL           (0xA5U)
+
+/* Heap taken by a dynamically created semaphore on the target */
+#define PASCO2_SIM_SEMAPHORE_HEAP_SIZE  (80U)
+
+/*******************************************************************************
+ * Types
+ ******************************************************************************/
+typedef enum
+{
+    PASCO2_SIM_TASK_READY,
+    PASCO2_SIM_TASK_BLOCKED,
+    PASCO2_SIM_TASK_DELETED
+} pasco2_sim_task_state_t;
+
+struct tskTaskControlBlock
+{
+    char name[configMAX_TASK_NAME_LEN];
+    TaskFunction_t entry;
+    void *arg;
+    UBaseType_t priority;
+    pthread_t thread;
+    pthread_cond_t cond;
+    pasco2_sim_task_state_t state;
+    uint64_t ready_sequence;    /* Round-robin order among equal priorities */
+    uint64_t wake_us;           /* Timeout of a blocked task */
+    const void *wait_object;    /* Semaphore or notification waited for */
+    bool timed_out;
+    uint32_t notify_value;
+    uint64_t consume_us;        /* CPU time still to be spent */
+    uint64_t debt_us;           /* CPU time charged outside the kernel */
+    uint64_t busy_us;           /* CPU time spent */
+    uint32_t switches;          /* Times the task was switched in */
+    uint32_t stack_depth;       /* Stack size of the task in words */
+    uint8_t *host_stack;
+    struct tskTaskControlBlock *next;
+};
+
+/*******************************************************************************
+ * Global variables
+ ******************************************************************************/
+/* Held by whichever context currently executes */
+static pthread_mutex_t kernel_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t scheduler_cond = PTHREAD_COND_INITIALIZER;
+
+static struct tskTaskControlBlock *tasks;
+static struct tskTaskControlBlock *running;
+static pasco2_sim_event_t *events;
+static bool scheduler_started;
+static bool in_isr;
+static bool idle;
+
+static uint64_t now_us;
+static uint64_t end_us = PASCO2_SIM_TIME_NEVER;
+static uint64_t ready_counter;
+static uint64_t event_counter;
+static uint64_t idle_us;
+static uint64_t deepsleep_us;
+static uint64_t isr_count;
+
+/* Kernel objects created on the FreeRTOS heap and the heap they would take */
+static uint32_t heap_objects;
+static size_t heap_bytes;
+
+/*******************************************************************************
+ * Function Name: pasco2_sim_kernel_init
+ ********************************************************************************
+ * Summary:
+ *  Takes the baton for the startup code and sets the end of the run.
+ *
+ * Parameters:
+ *  end_us: virtual time at which the simulation stops
+ *
+ * Return:
+ *  None
+ *******************************************************************************/
+void pasco2_sim_kernel_init(uint64_t end_us_in)
+{
+    pthread_mutex_lock(&kernel_lock);
+    end_us = end_us_in;
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_sim_now_us
+ ********************************************************************************
+ * Summary:
+ *  Returns the virtual time.
+ *
+ * Parameters:
+ *  None
+ *
+ * Return:
+ *  Microseconds since the start of the simulation
+ *******************************************************************************/
+uint64_t pasco2_sim_now_us(void)
+{
+    return now_us;
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_sim_event_schedule
+ ********************************************************************************
+ * Summary:
+ *  Schedules an interrupt event, replacing a pending schedule of the same
+ *  event. Events due at the same time run in the order they were scheduled.
+ *
+ * Parameters:
+ *  event: event object owned by the caller
+ *  at_us: virtual time of the interrupt
+ *  handler: interrupt handler
+ *  arg: handler argument
+ *
+ * Return:
+ *  None
+ *******************************************************************************/
+void pasco2_sim_event_schedule(pasco2_sim_event_t *event, uint64_t at_us, void (*handler)(void *arg), void *arg)
+{
+    pasco2_sim_event_cancel(event);
+
+    event->at_us = (at_us < now_us) ? now_us : at_us;
+    event->sequence = ++event_counter;
+    event->handler = handler;
+    event->arg = arg;
+    event->pending = true;
+
+    pasco2_sim_event_t **link = &events;
+    while ((*link != NULL) && ((*link)->at_us <= event->at_us))
+    {
+        link = &(*link)->next;
+    }
+    event->next = *link;
+    *link = event;
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_sim_event_cancel
+ ********************************************************************************
+ * Summary:
+ *  Removes a pending event.
+ *
+ * Parameters:
+ *  event: event to cancel
+ *
+ * Return:
+ *  None
+ *******************************************************************************/
+void pasco2_sim_event_cancel(pasco2_sim_event_t *event)
+{
+    if (!event->pending)
+    {
+        return;
+    }
+
+    for (pasco2_sim_event_t **link = &events; *link != NULL; link = &(*link)->next)
+    {
+        if (*link == event)
+        {
+            *link = event->next;
+            break;
+        }
+    }
+    event->pending = false;
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_sim_in_deepsleep
+ ********************************************************************************
+ * Summary:
+ *  Tells whether the system was in deep sleep when the current interrupt
+ *  arrived. Peripherals that are not clocked in deep sleep lose their input.
+ *
+ * Parameters:
+ *  None
+ *
+ * Return:
+ *  True while all tasks are blocked and no driver holds the deep sleep lock
+ *******************************************************************************/
+bool pasco2_sim_in_deepsleep(void)
+{
+    return idle && !pasco2_sim_hal_deepsleep_locked();
+}
+
+/*******************************************************************************
+ * Function Name: task_ready
+ ********************************************************************************
+ * Summary:
+ *  Makes a task ready, behind the ready tasks of the same priority.
+ *
+ * Parameters:
+ *  task: task to make ready
+ *
+ * Return:
+ *  None
+ *******************************************************************************/
+static void task_ready(struct tskTaskControlBlock *task)
+{
+    task->state = PASCO2_SIM_TASK_READY;
+    task->wake_us = PASCO2_SIM_TIME_NEVER;
+    task->wait_object = NULL;
+    task->ready_sequence = ++ready_counter;
+}
+
+/*******************************************************************************
+ * Function Name: pick_ready
+ ********************************************************************************
+ * Summary:
+ *  Selects the task the FreeRTOS scheduler would run.
+ *
+ * Parameters:
+ *  None
+ *
+ * Return:
+ *  Highest priority ready task, longest waiting first, or NULL
+ *******************************************************************************/
+static struct tskTaskControlBlock *pick_ready(void)
+{
+    struct tskTaskControlBlock *best = NULL;
+
+    for (struct tskTaskControlBlock *task = tasks; task != NULL; task = task->next)
+    {
+        if ((task->state == PASCO2_SIM_TASK_READY) &&
+            ((best == NULL) || (task->priority > best->priority) ||
+             ((task->priority == best->priority) && (task->ready_sequence < best->ready_sequence))))
+        {
+            best = task;
+        }
+    }
+
+    return best;
+}
+
+/*******************************************************************************
+ * Function Name: has_peer
+ ********************************************************************************
+ * Summary:
+ *  Tells whether another ready task shares the priority of a task, in which
+ *  case the two are time sliced at tick boundaries.
+ *
+ * Parameters:
+ *  task: running task
+ *
+ * Return:
+ *  True if time slicing applies
+ *******************************************************************************/
+static bool has_peer(const struct tskTaskControlBlock *task)
+{
+    for (const struct tskTaskControlBlock *other = tasks; other != NULL; other = other->next)
+    {
+        if ((other != task) && (other->state == PASCO2_SIM_TASK_READY) && (other->priority == task->priority))
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/*******************************************************************************
+ * Function Name: next_deadline
+ ********************************************************************************
+ * Summary:
+ *  Returns the time of the next interrupt event or task timeout.
+ *
+ * Parameters:
+ *  None
+ *
+ * Return:
+ *  Virtual time, PASCO2_SIM_TIME_NEVER if nothing is pending
+ *******************************************************************************/
+static uint64_t next_deadline(void)
+{
+    uint64_t next = (events != NULL) ? events->at_us : PASCO2_SIM_TIME_NEVER;
+
+    for (const struct tskTaskControlBlock *task = tasks; task != NULL; task = task->next)
+    {
+        if ((task->state == PASCO2_SIM_TASK_BLOCKED) && (task->wake_us < next))
+        {
+            next = task->wake_us;
+        }
+    }
+
+    return next;
+}
+
+/*******************************************************************************
+ * Function Name: run_due
+ ********************************************************************************
+ * Summary:
+ *  Runs the interrupt handlers that are due and readies timed out tasks.
+ *
+ * Parameters:
+ *  None
+ *
+ * Return:
+ *  None
+ *******************************************************************************/
+static void run_due(void)
+{
+    while ((events != NULL) && (events->at_us <= now_us))
+    {
+        pasco2_sim_event_t *event = events;
+        events = event->next;
+        event->pending = false;
+
+        in_isr = true;
+        event->handler(event->arg);
+        in_isr = false;
+        isr_count++;
+    }
+
+    for (struct tskTaskControlBlock *task = tasks; task != NULL; task = task->next)
+    {
+        if ((task->state == PASCO2_SIM_TASK_BLOCKED) && (task->wake_us <= now_us))
+        {
+            task->timed_out = true;
+            task_ready(task);
+        }
+    }
+}
+
+/*******************************************************************************
+ * Function Name: switch_out
+ ********************************************************************************
+ * Summary:
+ *  Hands the baton from the running task back to the scheduler and waits
+ *  until the scheduler selects the task again.
+ *
+ * Parameters:
+ *  None
+ *
+ * Return:
+ *  None
+ *******************************************************************************/
+static void switch_out(void)
+{
+    struct tskTaskControlBlock *self = running;
+
+    running = NULL;
+    pthread_cond_signal(&scheduler_cond);
+    while (running != self)
+    {
+        pthread_cond_wait(&self->cond, &kernel_lock);
+    }
+}
+
+/*******************************************************************************
+ * Function Name: settle
+ ********************************************************************************
+ * Summary:
+ *  Spends the CPU time the running task was charged outside the kernel, for
+ *  example by console output. Called on entry of every kernel service.
+ *
+ * Parameters:
+ *  None
+ *
+ * Return:
+ *  None
+ *******************************************************************************/
+static void settle(void)
+{
+    if ((running != NULL) && !in_isr && (running->debt_us > 0U))
+    {
+        running->consume_us += running->debt_us;
+        running->debt_us = 0U;
+        switch_out();
+    }
+}
+
+/*******************************************************************************
+ * Function Name: preempt
+ ********************************************************************************
+ * Summary:
+ *  Switches away from the running task if a higher priority task is ready.
+ *
+ * Parameters:
+ *  None
+ *
+ * Return:
+ *  None
+ *******************************************************************************/
+static void preempt(void)
+{
+    if ((running == NULL) || in_isr)
+    {
+        return;
+    }
+
+    for (const struct tskTaskControlBlock *task = tasks; task != NULL; task = task->next)
+    {
+        if ((task->state == PASCO2_SIM_TASK_READY) && (task->priority > running->priority))
+        {
+            switch_out();
+            return;
+        }
+    }
+}
+
+/*******************************************************************************
+ * Function Name: block
+ ********************************************************************************
+ * Summary:
+ *  Blocks the running task on an object until it is readied or times out.
+ *
+ * Parameters:
+ *  object: object waited for
+ *  wake_us: timeout, PASCO2_SIM_TIME_NEVER to wait forever
+ *
+ * Return:
+ *  False if the wait timed out
+ *******************************************************************************/
+static bool block(const void *object, uint64_t wake_us)
+{
+    struct tskTaskControlBlock *self = running;
+
+    CY_ASSERT((self != NULL) && !in_isr);
+
+    self->state = PASCO2_SIM_TASK_BLOCKED;
+    self->wait_object = object;
+    self->wake_us = wake_us;
+    self->timed_out = false;
+    switch_out();
+
+    return !self->timed_out;
+}
+
+/*******************************************************************************
+ * Function Name: ticks_to_deadline
+ ********************************************************************************
+ * Summary:
+ *  Converts a timeout in ticks to the tick boundary it expires at.
+ *
+ * Parameters:
+ *  ticks: timeout in ticks, portMAX_DELAY to wait forever
+ *
+ * Return:
+ *  Virtual time of the deadline
+ *******************************************************************************/
+static uint64_t ticks_to_deadline(TickType_t ticks)
+{
+    if (ticks == portMAX_DELAY)
+    {
+        return PASCO2_SIM_TIME_NEVER;
+    }
+
+    return ((now_us / PASCO2_SIM_TICK_US) + (uint64_t)ticks) * PASCO2_SIM_TICK_US;
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_sim_consume
+ ********************************************************************************
+ * Summary:
+ *  Spends CPU time in the running task. Interrupts and higher priority tasks
+ *  preempt it meanwhile. Before the scheduler starts the time just passes.
+ *
+ * Parameters:
+ *  duration_us: CPU time to spend
+ *
+ * Return:
+ *  None
+ *******************************************************************************/
+void pasco2_sim_consume(uint64_t duration_us)
+{
+    if (!scheduler_started)
+    {
+        now_us += duration_us;
+        run_due();
+    }
+    else if ((running != NULL) && !in_isr && ((duration_us + running->debt_us) > 0U))
+    {
+        running->consume_us += running->debt_us + duration_us;
+        running->debt_us = 0U;
+        switch_out();
+    }
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_sim_charge
+ ********************************************************************************
+ * Summary:
+ *  Charges CPU time to the running task without switching. The time is spent
+ *  on its next kernel call. Used where switching is not safe, such as inside
+ *  the C library's stdio locks.
+ *
+ * Parameters:
+ *  duration_us: CPU time to charge
+ *
+ * Return:
+ *  None
+ *******************************************************************************/
+void pasco2_sim_charge(uint64_t duration_us)
+{
+    if ((running != NULL) && !in_isr)
+    {
+        running->debt_us += duration_us;
+    }
+}
+
+/*******************************************************************************
+ * Function Name: task_thread
+ ********************************************************************************
+ * Summary:
+ *  Host thread of a task. Waits for the baton, runs the task function and
+ *  deletes the task if the function returns.
+ *
+ * Parameters:
+ *  arg: task control block
+ *
+ * Return:
+ *  Never returns
+ *******************************************************************************/
+static void *task_thread(void *arg)
+{
+    struct tskTaskControlBlock *self = arg;
+
+    pthread_mutex_lock(&kernel_lock);
+    while (running != self)
+    {
+        pthread_cond_wait(&self->cond, &kernel_lock);
+    }
+
+    self->entry(self->arg);
+    vTaskDelete(NULL);
+
+    return NULL;
+}
+
+/*******************************************************************************
+ * Function Name: create_task
+ ********************************************************************************
+ * Summary:
+ *  Creates a task on its own host thread and host stack.
+ *
+ * Parameters:
+ *  pxTaskCode: task function
+ *  pcName: task name
+ *  ulStackDepth: stack size of the task on the target in words
+ *  pvParameters: argument of the task function
+ *  uxPriority: task priority
+ *
+ * Return:
+ *  Task handle
+ *******************************************************************************/
+static TaskHandle_t create_task(TaskFunction_t pxTaskCode, const char *pcName, uint32_t ulStackDepth,
+                                void *pvParameters, UBaseType_t uxPriority)
+{
+    struct tskTaskControlBlock *task = calloc(1U, sizeof(*task));
+    pthread_attr_t attr;
+
+    CY_ASSERT(task != NULL);
+
+    settle();
+
+    strncpy(task->name, (pcName != NULL) ? pcName : "", sizeof(task->name) - 1U);
+    task->entry = pxTaskCode;
+    task->arg = pvParameters;
+    task->priority = (uxPriority < configMAX_PRIORITIES) ? uxPriority : (configMAX_PRIORITIES - 1U);
+    task->stack_depth = ulStackDepth;
+    pthread_cond_init(&task->cond, NULL);
+    task_ready(task);
+
+    struct tskTaskControlBlock **link = &tasks;
+    while (*link != NULL)
+    {
+        link = &(*link)->next;
+    }
+    *link = task;
+
+    if (posix_memalign((void **)&task->host_stack, 4096U, PASCO2_SIM_HOST_STACK_SIZE) != 0)
+    {
+        CY_ASSERT(0);
+    }
+    memset(task->host_stack, PASCO2_SIM_STACK_FILL, PASCO2_SIM_HOST_STACK_SIZE);
+    pthread_attr_init(&attr);
+    pthread_attr_setstack(&attr, task->host_stack, PASCO2_SIM_HOST_STACK_SIZE);
+    if (pthread_create(&task->thread, &attr, task_thread, task) != 0)
+    {
+        CY_ASSERT(0);
+    }
+    pthread_attr_destroy(&attr);
+
+    return task;
+}
+
+/*******************************************************************************
+ * Function Name: xTaskCreate
+ ********************************************************************************
+ * Summary:
+ *  Creates a task whose stack and control block come from the heap.
+ *
+ * Parameters:
+ *  See FreeRTOS
+ *
+ * Return:
+ *  pdPASS
+ *******************************************************************************/
+BaseType_t xTaskCreate(TaskFunction_t pxTaskCode, const char *pcName, uint32_t usStackDepth,
+                       void *pvParameters, UBaseType_t uxPriority, TaskHandle_t *pxCreatedTask)
+{
+    heap_objects++;
+    heap_bytes += ((size_t)usStackDepth * sizeof(StackType_t)) + sizeof(StaticTask_t);
+
+    TaskHandle_t task = create_task(pxTaskCode, pcName, usStackDepth, pvParameters, uxPriority);
+    if (pxCreatedTask != NULL)
+    {
+        *pxCreatedTask = task;
+    }
+
+    preempt();
+
+    return pdPASS;
+}
+
+/*******************************************************************************
+ * Function Name: xTaskCreateStatic
+ ********************************************************************************
+ * Summary:
+ *  Creates a task in memory provided by the caller. The task runs on a host
+ *  stack; the stack buffer only sets the stack size.
+ *
+ * Parameters:
+ *  See FreeRTOS
+ *
+ * Return:
+ *  Task handle
+ *******************************************************************************/
+TaskHandle_t xTaskCreateStatic(TaskFunction_t pxTaskCode, const char *pcName, uint32_t ulStackDepth,
+                               void *pvParameters, UBaseType_t uxPriority, StackType_t *puxStackBuffer,
+                               StaticTask_t *pxTaskBuffer)
+{
+    CY_ASSERT((puxStackBuffer != NULL) && (pxTaskBuffer != NULL));
+
+    TaskHandle_t task = create_task(pxTaskCode, pcName, ulStackDepth, pvParameters, uxPriority);
+
+    preempt();
+
+    return task;
+}
+
+/*******************************************************************************
+ * Function Name: task_stack_used
+ ********************************************************************************
+ * Summary:
+ *  Returns the deepest use of the host stack of a task so far.
+ *
+ * Parameters:
+ *  task: task to check
+ *
+ * Return:
+ *  Bytes of the host stack that were written
+ *******************************************************************************/
+static size_t task_stack_used(const struct tskTaskControlBlock *task)
+{
+    size_t untouched = 0U;
+
+    while ((untouched < PASCO2_SIM_HOST_STACK_SIZE) && (task->host_stack[untouched] == PASCO2_SIM_STACK_FILL))
+    {
+        untouched++;
+    }
+
+    return PASCO2_SIM_HOST_STACK_SIZE - untouched;
+}
+
+/*******************************************************************************
+ * Function Name: uxTaskGetStackHighWaterMark
+ ********************************************************************************
+ * Summary:
+ *  Returns the smallest free stack of a task so far, measured on its host
+ *  stack against the stack size of the task.
+ *
+ * Parameters:
+ *  xTask: task to check, NULL for the calling task
+ *
+ * Return:
+ *  Free stack in words, 0 if the host code used more than the stack size
+ *******************************************************************************/
+UBaseType_t uxTaskGetStackHighWaterMark(TaskHandle_t xTask)
+{
+    const struct tskTaskControlBlock *task = (xTask != NULL) ? xTask : running;
+    size_t size = (size_t)task->stack_depth * sizeof(StackType_t);
+    size_t used = task_stack_used(task);
+
+    return (used < size) ? (UBaseType_t)((size - used) / sizeof(StackType_t)) : 0U;
+}
+
+/*******************************************************************************
+ * Function Name: vTaskDelete
+ ********************************************************************************
+ * Summary:
+ *  Deletes a task. A deleted task's host thread stays parked.
+ *
+ * Parameters:
+ *  xTaskToDelete: task to delete, NULL for the calling task
+ *
+ * Return:
+ *  None
+ *******************************************************************************/
+void vTaskDelete(TaskHandle_t xTaskToDelete)
+{
+    struct tskTaskControlBlock *task = (xTaskToDelete != NULL) ? xTaskToDelete : running;
+
+    task->state = PASCO2_SIM_TASK_DELETED;
+    if (task == running)
+    {
+        switch_out();
+    }
+}
+
+/*******************************************************************************
+ * Function Name: vTaskDelay
+ ********************************************************************************
+ * Summary:
+ *  Blocks the calling task until a tick boundary. A zero delay yields to the
+ *  other ready tasks of the same priority.
+ *
+ * Parameters:
+ *  xTicksToDelay: delay in ticks
+ *
+ * Return:
+ *  None
+ *******************************************************************************/
+void vTaskDelay(TickType_t xTicksToDelay)
+{
+    settle();
+
+    if (xTicksToDelay == 0U)
+    {
+        running->ready_sequence = ++ready_counter;
+        switch_out();
+    }
+    else
+    {
+        (void)block(&running->wake_us, ticks_to_deadline(xTicksToDelay));
+    }
+}
+
+/*******************************************************************************
+ * Function Name: xTaskGetSchedulerState
+ ********************************************************************************
+ * Summary:
+ *  Tells whether the scheduler runs.
+ *
+ * Parameters:
+ *  None
+ *
+ * Return:
+ *  taskSCHEDULER_RUNNING or taskSCHEDULER_NOT_STARTED
+ *******************************************************************************/
+BaseType_t xTaskGetSchedulerState(void)
+{
+    return scheduler_started ? taskSCHEDULER_RUNNING : taskSCHEDULER_NOT_STARTED;
+}
+
+/*******************************************************************************
+ * Function Name: vTaskStartScheduler
+ ********************************************************************************
+ * Summary:
+ *  Runs the simulation: switches to the selected task, spends its CPU time
+ *  up to the next interrupt, tick or timeout, and skips idle periods. Ends
+ *  the run when the end time is reached or nothing is left to happen.
+ *
+ * Parameters:
+ *  None
+ *
+ * Return:
+ *  Never returns
+ *******************************************************************************/
+void vTaskStartScheduler(void)
+{
+    scheduler_started = true;
+
+    for (;;)
+    {
+        run_due();
+
+        if (now_us >= end_us)
+        {
+            pasco2_sim_finish("end of simulated time");
+        }
+
+        struct tskTaskControlBlock *task = pick_ready();
+
+        if (task == NULL)
+        {
+            uint64_t next = next_deadline();
+
+            if (next == PASCO2_SIM_TIME_NEVER)
+            {
+                pasco2_sim_finish("all tasks blocked forever");
+            }
+            next = (next < end_us) ? next : end_us;
+
+            idle_us += next - now_us;
+            if (!pasco2_sim_hal_deepsleep_locked())
+            {
+                deepsleep_us += next - now_us;
+            }
+            now_us = next;
+
+            idle = true;
+            run_due();
+            idle = false;
+        }
+        else if (task->consume_us > 0U)
+        {
+            uint64_t step = task->consume_us;
+            uint64_t next = next_deadline();
+            bool sliced = has_peer(task);
+
+            if ((next > now_us) && ((next - now_us) < step))
+            {
+                step = next - now_us;
+            }
+            if (sliced)
+            {
+                uint64_t boundary = ((now_us / PASCO2_SIM_TICK_US) + 1U) * PASCO2_SIM_TICK_US;
+                step = ((boundary - now_us) < step) ? (boundary - now_us) : step;
+            }
+            step = ((end_us - now_us) < step) ? (end_us - now_us) : step;
+
+            now_us += step;
+            task->consume_us -= step;
+            task->busy_us += step;
+
+            if (sliced && ((now_us % PASCO2_SIM_TICK_US) == 0U))
+            {
+                task->ready_sequence = ++ready_counter;
+            }
+        }
+        else
+        {
+            running = task;
+            task->switches++;
+            pthread_cond_signal(&task->cond);
+            while (running != NULL)
+            {
+                pthread_cond_wait(&scheduler_cond, &kernel_lock);
+            }
+        }
+    }
+}
+
+/*******************************************************************************
+ * Function Name: xTaskGetTickCount
+ ********************************************************************************
+ * Summary:
+ *  Returns the tick count.
+ *
+ * Parameters:
+ *  None
+ *
+ * Return:
+ *  Ticks since the start of the simulation
+ *******************************************************************************/
+TickType_t xTaskGetTickCount(void)
+{
+    settle();
+
+    return (TickType_t)(now_us / PASCO2_SIM_TICK_US);
+}
+
+/*******************************************************************************
+ * Function Name: xTaskGetTickCountFromISR
+ ********************************************************************************
+ * Summary:
+ *  Returns the tick count from an interrupt handler.
+ *
+ * Parameters:
+ *  None
+ *
+ * Return:
+ *  Ticks since the start of the simulation
+ *******************************************************************************/
+TickType_t xTaskGetTickCountFromISR(void)
+{
+    return (TickType_t)(now_us / PASCO2_SIM_TICK_US);
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_probe_host_clock
+ ********************************************************************************
+ * Summary:
+ *  Clock of the firmware latency probes. Charged time is spent first, so
+ *  that probes see console output like on target.
+ *
+ * Parameters:
+ *  None
+ *
+ * Return:
+ *  Virtual time in nanoseconds, wrapping at 32 bits
+ *******************************************************************************/
+uint32_t pasco2_probe_host_clock(void)
+{
+    settle();
+
+    return (uint32_t)(now_us * 1000U);
+}
+
+/*******************************************************************************
+ * Function Name: xTaskGetCurrentTaskHandle
+ ********************************************************************************
+ * Summary:
+ *  Returns the running task.
+ *
+ * Parameters:
+ *  None
+ *
+ * Return:
+ *  Task handle, NULL in interrupt context
+ *******************************************************************************/
+TaskHandle_t xTaskGetCurrentTaskHandle(void)
+{
+    return in_isr ? NULL : running;
+}
+
+/*******************************************************************************
+ * Function Name: pcTaskGetName
+ ********************************************************************************
+ * Summary:
+ *  Returns the name of a task.
+ *
+ * Parameters:
+ *  xTaskToQuery: task, NULL for the calling task
+ *
+ * Return:
+ *  Task name
+ *******************************************************************************/
+char *pcTaskGetName(TaskHandle_t xTaskToQuery)
+{
+    return ((xTaskToQuery != NULL) ? xTaskToQuery : running)->name;
+}
+
+/*******************************************************************************
+ * Function Name: uxTaskPriorityGet
+ ********************************************************************************
+ * Summary:
+ *  Returns the priority of a task.
+ *
+ * Parameters:
+ *  xTask: task, NULL for the calling task
+ *
+ * Return:
+ *  Task priority
+ *******************************************************************************/
+UBaseType_t uxTaskPriorityGet(TaskHandle_t xTask)
+{
+    return ((xTask != NULL) ? xTask : running)->priority;
+}
+
+/*******************************************************************************
+ * Function Name: notify
+ ********************************************************************************
+ * Summary:
+ *  Increments the notification value of a task and readies it if it waits
+ *  for a notification.
+ *
+ * Parameters:
+ *  task: task to notify
+ *
+ * Return:
+ *  True if a task of higher priority than the running one was readied
+ *******************************************************************************/
+static bool notify(struct tskTaskControlBlock *task)
+{
+    task->notify_value++;
+    if ((task->state == PASCO2_SIM_TASK_BLOCKED) && (task->wait_object == &task->notify_value))
+    {
+        task_ready(task);
+        return (running == NULL) || (task->priority > running->priority);
+    }
+
+    return false;
+}
+
+/*******************************************************************************
+ * Function Name: xTaskNotifyGive
+ ********************************************************************************
+ * Summary:
+ *  Gives a direct-to-task notification.
+ *
+ * Parameters:
+ *  xTaskToNotify: task to notify
+ *
+ * Return:
+ *  pdPASS
+ *******************************************************************************/
+BaseType_t xTaskNotifyGive(TaskHandle_t xTaskToNotify)
+{
+    settle();
+    (void)notify(xTaskToNotify);
+    preempt();
+
+    return pdPASS;
+}
+
+/*******************************************************************************
+ * Function Name: vTaskNotifyGiveFromISR
+ ********************************************************************************
+ * Summary:
+ *  Gives a direct-to-task notification from an interrupt handler. The
+ *  scheduler switches tasks after every handler.
+ *
+ * Parameters:
+ *  xTaskToNotify: task to notify
+ *  pxHigherPriorityTaskWoken: set if a higher priority task was readied
+ *
+ * Return:
+ *  None
+ *******************************************************************************/
+void vTaskNotifyGiveFromISR(TaskHandle_t xTaskToNotify, BaseType_t *pxHigherPriorityTaskWoken)
+{
+    if (notify(xTaskToNotify) && (pxHigherPriorityTaskWoken != NULL))
+    {
+        *pxHigherPriorityTaskWoken = pdTRUE;
+    }
+}
+
+/*******************************************************************************
+ * Function Name: ulTaskNotifyTake
+ ********************************************************************************
+ * Summary:
+ *  Waits for a direct-to-task notification.
+ *
+ * Parameters:
+ *  xClearCountOnExit: clear the value instead of decrementing it
+ *  xTicksToWait: timeout in ticks
+ *
+ * Return:
+ *  Notification value before it was cleared or decremented
+ *******************************************************************************/
+uint32_t ulTaskNotifyTake(BaseType_t xClearCountOnExit, TickType_t xTicksToWait)
+{
+    struct tskTaskControlBlock *self = running;
+
+    settle();
+
+    if ((self->notify_value == 0U) && (xTicksToWait > 0U))
+    {
+        (void)block(&self->notify_value, ticks_to_deadline(xTicksToWait));
+    }
+
+    uint32_t value = self->notify_value;
+    if (value > 0U)
+    {
+        self->notify_value = (xClearCountOnExit != pdFALSE) ? 0U : (value - 1U);
+    }
+
+    return value;
+}
+
+/*******************************************************************************
+ * Function Name: xStreamBufferCreateStatic
+ ********************************************************************************
+ * Summary:
+ *  Creates a stream buffer in caller-provided memory.
+ *
+ * Parameters:
+ *  See FreeRTOS
+ *
+ * Return:
+ *  Stream buffer handle
+ *******************************************************************************/
+StreamBufferHandle_t xStreamBufferCreateStatic(size_t xBufferSizeBytes, size_t xTriggerLevelBytes,
+                                               uint8_t *pucStreamBufferStorageArea,
+                                               StaticStreamBuffer_t *pxStaticStreamBuffer)
+{
+    CY_ASSERT((pucStreamBufferStorageArea != NULL) && (pxStaticStreamBuffer != NULL) && (xBufferSizeBytes > 0U));
+
+    pxStaticStreamBuffer->storage = pucStreamBufferStorageArea;
+    pxStaticStreamBuffer->size = xBufferSizeBytes;
+    pxStaticStreamBuffer->trigger = (xTriggerLevelBytes > 0U) ? xTriggerLevelBytes : 1U;
+    pxStaticStreamBuffer->head = 0U;
+    pxStaticStreamBuffer->count = 0U;
+
+    return pxStaticStreamBuffer;
+}
+
+/*******************************************************************************
+ * Function Name: xStreamBufferSendFromISR
+ ********************************************************************************
+ * Summary:
+ *  Writes as many bytes as fit into a stream buffer from an interrupt
+ *  handler and readies the highest priority task waiting for the trigger
+ *  level.
+ *
+ * Parameters:
+ *  xStreamBuffer: stream buffer to write
+ *  pvTxData: bytes to write
+ *  xDataLengthBytes: number of bytes to write
+ *  pxHigherPriorityTaskWoken: set if a higher priority task was readied
+ *
+ * Return:
+ *  Number of bytes written
+ *******************************************************************************/
+size_t xStreamBufferSendFromISR(StreamBufferHandle_t xStreamBuffer, const void *pvTxData, size_t xDataLengthBytes,
+                                BaseType_t *pxHigherPriorityTaskWoken)
+{
+    StaticStreamBuffer_t *sb = xStreamBuffer;
+    const uint8_t *data = pvTxData;
+    size_t written = 0U;
+
+    while ((written < xDataLengthBytes) && (sb->count < sb->size))
+    {
+        sb->storage[(sb->head + sb->count) % sb->size] = data[written];
+        sb->count++;
+        written++;
+    }
+
+    if (sb->count < sb->trigger)
+    {
+        return written;
+    }
+
+    struct tskTaskControlBlock *waiter = NULL;
+    for (struct tskTaskControlBlock *task = tasks; task != NULL; task = task->next)
+    {
+        if ((task->state == PASCO2_SIM_TASK_BLOCKED) && (task->wait_object == sb) &&
+            ((waiter == NULL) || (task->priority > waiter->priority)))
+        {
+            waiter = task;
+        }
+    }
+    if (waiter != NULL)
+    {
+        task_ready(waiter);
+        if (((running == NULL) || (waiter->priority > running->priority)) && (pxHigherPriorityTaskWoken != NULL))
+        {
+            *pxHigherPriorityTaskWoken = pdTRUE;
+        }
+    }
+
+    return written;
+}
+
+/*******************************************************************************
+ * Function Name: xStreamBufferReceive
+ ********************************************************************************
+ * Summary:
+ *  Reads bytes from a stream buffer, waiting up to the timeout for the
+ *  trigger level to be reached.
+ *
+ * Parameters:
+ *  xStreamBuffer: stream buffer to read
+ *  pvRxData: receives the bytes
+ *  xBufferLengthBytes: maximum number of bytes to read
+ *  xTicksToWait: timeout in ticks
+ *
+ * Return:
+ *  Number of bytes read, 0 on timeout
+ *******************************************************************************/
+size_t xStreamBufferReceive(StreamBufferHandle_t xStreamBuffer, void *pvRxData, size_t xBufferLengthBytes,
+                            TickType_t xTicksToWait)
+{
+    StaticStreamBuffer_t *sb = xStreamBuffer;
+    uint8_t *data = pvRxData;
+    size_t read = 0U;
+
+    settle();
+
+    uint64_t deadline = ticks_to_deadline(xTicksToWait);
+
+    while (sb->count < sb->trigger)
+    {
+        if ((xTicksToWait == 0U) || !block(sb, deadline))
+        {
+            break;
+        }
+    }
+
+    while ((read < xBufferLengthBytes) && (sb->count > 0U))
+    {
+        data[read] = sb->storage[sb->head];
+        sb->head = (sb->head + 1U) % sb->size;
+        sb->count--;
+        read++;
+    }
+
+    return read;
+}
+
+/*******************************************************************************
+ * Function Name: xStreamBufferBytesAvailable
+ ********************************************************************************
+ * Summary:
+ *  Returns the number of bytes waiting in a stream buffer.
+ *
+ * Parameters:
+ *  xStreamBuffer: stream buffer to query
+ *
+ * Return:
+ *  Number of bytes that can be read
+ *******************************************************************************/
+size_t xStreamBufferBytesAvailable(StreamBufferHandle_t xStreamBuffer)
+{
+    return xStreamBuffer->count;
+}
+
+/*******************************************************************************
+ * Function Name: cy_rtos_create_thread
+ ********************************************************************************
+ * Summary:
+ *  Creates a thread. The stack is provided by the host.
+ *
+ * Parameters:
+ *  See abstraction-rtos
+ *
+ * Return:
+ *  cy_rslt_t: CY_RSLT_SUCCESS
+ *******************************************************************************/
+cy_rslt_t cy_rtos_create_thread(cy_thread_t *thread, cy_thread_entry_fn_t entry_function, const char *name,
+                                void *stack, uint32_t stack_size, cy_thread_priority_t priority,
+                                cy_thread_arg_t arg)
+{
+    CY_UNUSED_PARAMETER(stack);
+
+    (void)xTaskCreate(entry_function, name, stack_size / sizeof(StackType_t), arg, (UBaseType_t)priority, thread);
+
+    return CY_RSLT_SUCCESS;
+}
+
+/*******************************************************************************
+ * Function Name: cy_rtos_exit_thread
+ ********************************************************************************
+ * Summary:
+ *  Deletes the calling thread.
+ *
+ * Parameters:
+ *  None
+ *
+ * Return:
+ *  Never returns to the caller
+ *******************************************************************************/
+cy_rslt_t cy_rtos_exit_thread(void)
+{
+    vTaskDelete(NULL);
+
+    return CY_RSLT_SUCCESS;
+}
+
+/*******************************************************************************
+ * Function Name: cy_rtos_get_thread_handle
+ ********************************************************************************
+ * Summary:
+ *  Returns the calling thread.
+ *
+ * Parameters:
+ *  thread: receives the handle
+ *
+ * Return:
+ *  cy_rslt_t: CY_RSLT_SUCCESS
+ *******************************************************************************/
+cy_rslt_t cy_rtos_get_thread_handle(cy_thread_t *thread)
+{
+    *thread = xTaskGetCurrentTaskHandle();
+
+    return CY_RSLT_SUCCESS;
+}
+
+/*******************************************************************************
+ * Function Name: cy_rtos_delay_milliseconds
+ ********************************************************************************
+ * Summary:
+ *  Blocks the calling thread.
+ *
+ * Parameters:
+ *  num_ms: delay in milliseconds
+ *
+ * Return:
+ *  cy_rslt_t: CY_RSLT_SUCCESS
+ *******************************************************************************/
+cy_rslt_t cy_rtos_delay_milliseconds(cy_time_t num_ms)
+{
+    vTaskDelay(pdMS_TO_TICKS(num_ms));
+
+    return CY_RSLT_SUCCESS;
+}
+
+/*******************************************************************************
+ * Function Name: cy_rtos_get_time
+ ********************************************************************************
+ * Summary:
+ *  Returns the time since the start of the scheduler.
+ *
+ * Parameters:
+ *  tval: receives the time in milliseconds
+ *
+ * Return:
+ *  cy_rslt_t: CY_RSLT_SUCCESS
+ *******************************************************************************/
+cy_rslt_t cy_rtos_get_time(cy_time_t *tval)
+{
+    *tval = (cy_time_t)(xTaskGetTickCount() * portTICK_PERIOD_MS);
+
+    return CY_RSLT_SUCCESS;
+}
+
+/*******************************************************************************
+ * Function Name: cy_rtos_init_semaphore
+ ********************************************************************************
+ * Summary:
+ *  Creates a counting semaphore.
+ *
+ * Parameters:
+ *  semaphore: receives the semaphore
+ *  maxcount: maximum count
+ *  initcount: initial count
+ *
+ * Return:
+ *  cy_rslt_t: CY_RSLT_SUCCESS, CY_RTOS_NO_MEMORY
+ *******************************************************************************/
+cy_rslt_t cy_rtos_init_semaphore(cy_semaphore_t *semaphore, uint32_t maxcount, uint32_t initcount)
+{
+    if ((semaphore == NULL) || (maxcount == 0U) || (initcount > maxcount))
+    {
+        return CY_RTOS_BAD_PARAM;
+    }
+
+    *semaphore = calloc(1U, sizeof(**semaphore));
+    if (*semaphore == NULL)
+    {
+        return CY_RTOS_NO_MEMORY;
+    }
+    (*semaphore)->count = initcount;
+    (*semaphore)->max_count = maxcount;
+    heap_objects++;
+    heap_bytes += PASCO2_SIM_SEMAPHORE_HEAP_SIZE;
+
+    return CY_RSLT_SUCCESS;
+}
+
+/*******************************************************************************
+ * Function Name: xSemaphoreCreateCountingStatic
+ ********************************************************************************
+ * Summary:
+ *  Creates a counting semaphore in memory provided by the caller.
+ *
+ * Parameters:
+ *  See FreeRTOS
+ *
+ * Return:
+ *  Semaphore handle, NULL for invalid counts
+ *******************************************************************************/
+SemaphoreHandle_t xSemaphoreCreateCountingStatic(UBaseType_t uxMaxCount, UBaseType_t uxInitialCount,
+                                                 StaticSemaphore_t *pxSemaphoreBuffer)
+{
+    if ((uxMaxCount == 0U) || (uxInitialCount > uxMaxCount) || (pxSemaphoreBuffer == NULL))
+    {
+        return NULL;
+    }
+
+    pxSemaphoreBuffer->count = (uint32_t)uxInitialCount;
+    pxSemaphoreBuffer->max_count = (uint32_t)uxMaxCount;
+
+    return pxSemaphoreBuffer;
+}
+
+/*******************************************************************************
+ * Function Name: xSemaphoreCreateMutex
+ ********************************************************************************
+ * Summary:
+ *  Creates a mutex on the heap. The simulation has no priority inheritance,
+ *  so the mutex is a binary semaphore that starts free.
+ *
+ * Parameters:
+ *  None
+ *
+ * Return:
+ *  Mutex handle, NULL without memory
+ *******************************************************************************/
+SemaphoreHandle_t xSemaphoreCreateMutex(void)
+{
+    cy_semaphore_t mutex;
+
+    return (cy_rtos_init_semaphore(&mutex, 1U, 1U) == CY_RSLT_SUCCESS) ? mutex : NULL;
+}
+
+/*******************************************************************************
+ * Function Name: xSemaphoreCreateMutexStatic
+ ********************************************************************************
+ * Summary:
+ *  Creates a mutex in memory provided by the caller.
+ *
+ * Parameters:
+ *  See FreeRTOS
+ *
+ * Return:
+ *  Mutex handle, NULL without memory
+ *******************************************************************************/
+SemaphoreHandle_t xSemaphoreCreateMutexStatic(StaticSemaphore_t *pxMutexBuffer)
+{
+    return xSemaphoreCreateCountingStatic(1U, 1U, pxMutexBuffer);
+}
+
+/*******************************************************************************
+ * Function Name: xPortGetFreeHeapSize
+ ********************************************************************************
+ * Summary:
+ *  Returns the FreeRTOS heap left after the dynamically created kernel
+ *  objects, with their sizes on the target.
+ *
+ * Parameters:
+ *  None
+ *
+ * Return:
+ *  Free heap in bytes
+ *******************************************************************************/
+size_t xPortGetFreeHeapSize(void)
+{
+    return (heap_bytes < configTOTAL_HEAP_SIZE) ? (configTOTAL_HEAP_SIZE - heap_bytes) : 0U;
+}
+
+/*******************************************************************************
+ * Function Name: xPortGetMinimumEverFreeHeapSize
+ ********************************************************************************
+ * Summary:
+ *  Returns the smallest free FreeRTOS heap so far. Kernel objects are never
+ *  deleted by the firmware, so this is the current free heap.
+ *
+ * Parameters:
+ *  None
+ *
+ * Return:
+ *  Free heap in bytes
+ *******************************************************************************/
+size_t xPortGetMinimumEverFreeHeapSize(void)
+{
+    return xPortGetFreeHeapSize();
+}
+
+/*******************************************************************************
+ * Function Name: cy_rtos_get_semaphore
+ ********************************************************************************
+ * Summary:
+ *  Takes a semaphore, waiting up to the timeout.
+ *
+ * Parameters:
+ *  semaphore: semaphore to take
+ *  timeout_ms: timeout in milliseconds, CY_RTOS_NEVER_TIMEOUT to wait forever
+ *  in_isr: true when called from an interrupt handler, which never waits
+ *
+ * Return:
+ *  cy_rslt_t: CY_RSLT_SUCCESS, CY_RTOS_TIMEOUT
+ *******************************************************************************/
+cy_rslt_t cy_rtos_get_semaphore(cy_semaphore_t *semaphore, cy_time_t timeout_ms, bool in_isr_arg)
+{
+    struct pasco2_sim_semaphore *sem = *semaphore;
+
+    if (!in_isr_arg)
+    {
+        settle();
+    }
+
+    uint64_t deadline = (timeout_ms == CY_RTOS_NEVER_TIMEOUT) ?
+                        PASCO2_SIM_TIME_NEVER : ticks_to_deadline(pdMS_TO_TICKS(timeout_ms));
+
+    while (sem->count == 0U)
+    {
+        if (in_isr_arg || (timeout_ms == 0U) || !block(sem, deadline))
+        {
+            return CY_RTOS_TIMEOUT;
+        }
+    }
+    sem->count--;
+
+    return CY_RSLT_SUCCESS;
+}
+
+/*******************************************************************************
+ * Function Name: cy_rtos_set_semaphore
+ ********************************************************************************
+ * Summary:
+ *  Gives a semaphore and readies the highest priority task waiting for it.
+ *
+ * Parameters:
+ *  semaphore: semaphore to give
+ *  in_isr: true when called from an interrupt handler
+ *
+ * Return:
+ *  cy_rslt_t: CY_RSLT_SUCCESS, CY_RTOS_GENERAL_ERROR if the count is at its
+ *  maximum
+ *******************************************************************************/
+cy_rslt_t cy_rtos_set_semaphore(cy_semaphore_t *semaphore, bool in_isr_arg)
+{
+    struct pasco2_sim_semaphore *sem = *semaphore;
+
+    if (!in_isr_arg)
+    {
+        settle();
+    }
+
+    if (sem->count >= sem->max_count)
+    {
+        return CY_RTOS_GENERAL_ERROR;
+    }
+    sem->count++;
+
+    struct tskTaskControlBlock *waiter = NULL;
+    for (struct tskTaskControlBlock *task = tasks; task != NULL; task = task->next)
+    {
+        if ((task->state == PASCO2_SIM_TASK_BLOCKED) && (task->wait_object == sem) &&
+            ((waiter == NULL) || (task->priority > waiter->priority)))
+        {
+            waiter = task;
+        }
+    }
+    if (waiter != NULL)
+    {
+        task_ready(waiter);
+    }
+
+    if (!in_isr_arg)
+    {
+        preempt();
+    }
+
+    return CY_RSLT_SUCCESS;
+}
+
+/*******************************************************************************
+ * Function Name: xSemaphoreTake
+ ********************************************************************************
+ * Summary:
+ *  Takes a semaphore or mutex from a task, waiting up to the timeout.
+ *
+ * Parameters:
+ *  See FreeRTOS
+ *
+ * Return:
+ *  pdPASS, pdFAIL on timeout
+ *******************************************************************************/
+BaseType_t xSemaphoreTake(SemaphoreHandle_t xSemaphore, TickType_t xTicksToWait)
+{
+    cy_time_t timeout_ms = (xTicksToWait == portMAX_DELAY) ?
+                           CY_RTOS_NEVER_TIMEOUT : (cy_time_t)(xTicksToWait * portTICK_PERIOD_MS);
+
+    return (cy_rtos_get_semaphore(&xSemaphore, timeout_ms, false) == CY_RSLT_SUCCESS) ? pdPASS : pdFAIL;
+}
+
+/*******************************************************************************
+ * Function Name: xSemaphoreGive
+ ********************************************************************************
+ * Summary:
+ *  Gives a semaphore or mutex from a task.
+ *
+ * Parameters:
+ *  See FreeRTOS
+ *
+ * Return:
+ *  pdPASS, pdFAIL if the count is at its maximum
+ *******************************************************************************/
+BaseType_t xSemaphoreGive(SemaphoreHandle_t xSemaphore)
+{
+    return (cy_rtos_set_semaphore(&xSemaphore, false) == CY_RSLT_SUCCESS) ? pdPASS : pdFAIL;
+}
+
+/*******************************************************************************
+ * Function Name: cy_rtos_deinit_semaphore
+ ********************************************************************************
+ * Summary:
+ *  Deletes a semaphore.
+ *
+ * Parameters:
+ *  semaphore: semaphore to delete
+ *
+ * Return:
+ *  cy_rslt_t: CY_RSLT_SUCCESS
+ *******************************************************************************/
+cy_rslt_t cy_rtos_deinit_semaphore(cy_semaphore_t *semaphore)
+{
+    free(*semaphore);
+    *semaphore = NULL;
+
+    return CY_RSLT_SUCCESS;
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_sim_kernel_report
+ ********************************************************************************
+ * Summary:
+ *  Prints the CPU time of every task and the idle and deep sleep shares.
+ *
+ * Parameters:
+ *  out: report stream
+ *
+ * Return:
+ *  None
+ *******************************************************************************/
+void pasco2_sim_kernel_report(FILE *out)
+{
+    double total = (now_us > 0U) ? (double)now_us : 1.0;
+
+    fprintf(out, "Tasks:\n");
+    for (const struct tskTaskControlBlock *task = tasks; task != NULL; task = task->next)
+    {
+        fprintf(out, "  %-18s prio %lu  cpu %10.3f ms (%6.3f %%)  switches %" PRIu32 "  stack %zu of %zu bytes\n",
+                task->name, task->priority, (double)task->busy_us / 1000.0, 100.0 * (double)task->busy_us / total,
+                task->switches, task_stack_used(task), (size_t)task->stack_depth * sizeof(StackType_t));
+    }
+    fprintf(out, "  kernel objects on the heap %" PRIu32 ", %zu bytes\n", heap_objects, heap_bytes);
+    fprintf(out, "  idle %.3f s (%.3f %%), deep sleep %.3f s (%.3f %%), interrupts %" PRIu64 "\n",
+            (double)idle_us / 1e6, 100.0 * (double)idle_us / total, (double)deepsleep_us / 1e6,
+            100.0 * (double)deepsleep_us / total, isr_count);
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_sim_assert_failed
+ ********************************************************************************
+ * Summary:
+ *  Ends the run when the firmware hits CY_ASSERT.
+ *
+ * Parameters:
+ *  file: source file of the assertion
+ *  line: source line of the assertion
+ *
+ * Return:
+ *  Never returns
+ *******************************************************************************/
+void pasco2_sim_assert_failed(const char *file, int line)
+{
+    fflush(stdout);
+    fprintf(stderr, "Assertion failed at %s:%d, t=%.6f s\n", file, line, (double)now_us / 1e6);
+    exit(EXIT_FAILURE);
+}
+
+/* [] END OF FILE */
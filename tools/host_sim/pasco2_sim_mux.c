@@ -0,0 +1,151 @@
+/*****************************************************************************
+** File name: pasco2_sim_mux.c
+**
+** Description: This file contains the model of the PCA9548A I2C mux: one
+**   control register whose bits connect the devices behind the channels to
+**   the bus.
+**
+** ===========================================================================
+** Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+** ===========================================================================
+**
+** ===========================================================================
+** Infineon Technologies AG (INFINEON) is supplying this file for use
+** exclusively with Infineon's sensor products. This file can be freely
+** distributed within development tools and software supporting such
+** products.
+**
+** THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+** OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+** MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+** INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+** WHATSOEVER.
+** ===========================================================================
+*/
+
+/* Header file from system */
+#include <inttypes.h>
+#include <string.h>
+
+/* Header file includes */
+#include "pasco2_sim.h"
+
+/*******************************************************************************
+ * Function Name: device_write
+ ********************************************************************************
+ * Summary:
+ *  Handles an I2C write: the last byte becomes the control register, whose
+ *  bits enable the channels.
+ *
+ * Parameters:
+ *  device: mux model
+ *  data: bytes written
+ *  size: number of bytes
+ *
+ * Return:
+ *  True, the mux always acknowledges
+ *******************************************************************************/
+static bool device_write(pasco2_sim_i2c_device_t *device, const uint8_t *data, size_t size)
+{
+    pasco2_sim_mux_t *mux = (pasco2_sim_mux_t *)device;
+
+    if (size > 0U)
+    {
+        mux->control = data[size - 1U];
+        mux->selects++;
+    }
+
+    return true;
+}
+
+/*******************************************************************************
+ * Function Name: device_read
+ ********************************************************************************
+ * Summary:
+ *  Handles an I2C read: every byte returns the control register.
+ *
+ * Parameters:
+ *  device: mux model
+ *  data: receives the bytes
+ *  size: number of bytes
+ *
+ * Return:
+ *  True, the mux always acknowledges
+ *******************************************************************************/
+static bool device_read(pasco2_sim_i2c_device_t *device, uint8_t *data, size_t size)
+{
+    pasco2_sim_mux_t *mux = (pasco2_sim_mux_t *)device;
+
+    memset(data, mux->control, size);
+
+    return true;
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_sim_mux_init
+ ********************************************************************************
+ * Summary:
+ *  Powers up a mux model with all channels disabled. The mux is supplied by
+ *  the kit, so the sensor supply switch does not reset it.
+ *
+ * Parameters:
+ *  mux: mux model
+ *  address: I2C address
+ *
+ * Return:
+ *  None
+ *******************************************************************************/
+void pasco2_sim_mux_init(pasco2_sim_mux_t *mux, uint16_t address)
+{
+    memset(mux, 0, sizeof(*mux));
+    mux->device.address = address;
+    mux->device.write = device_write;
+    mux->device.read = device_read;
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_sim_mux_connect
+ ********************************************************************************
+ * Summary:
+ *  Places a device behind a channel of the mux. The device must also be
+ *  attached to the bus of the mux; it answers only while its channel is
+ *  enabled.
+ *
+ * Parameters:
+ *  mux: mux model
+ *  channel: channel of the device
+ *  device: device model
+ *
+ * Return:
+ *  None
+ *******************************************************************************/
+void pasco2_sim_mux_connect(pasco2_sim_mux_t *mux, uint8_t channel, pasco2_sim_i2c_device_t *device)
+{
+    CY_ASSERT(channel < PASCO2_SIM_MUX_CHANNELS);
+
+    device->gate = &mux->control;
+    device->gate_mask = (uint8_t)(1U << channel);
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_sim_mux_report
+ ********************************************************************************
+ * Summary:
+ *  Prints the counters of a mux model.
+ *
+ * Parameters:
+ *  mux: mux model
+ *  bus: index of the bus of the mux
+ *  out: report stream
+ *
+ * Return:
+ *  None
+ *******************************************************************************/
+void pasco2_sim_mux_report(const pasco2_sim_mux_t *mux, uint8_t bus, FILE *out)
+{
+    fprintf(out, "I2C mux 0x%02X on bus %u: %" PRIu32 " channel selects\n", mux->device.address, (unsigned int)bus,
+            mux->selects);
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,164 @@
+/******************************************************************************
+** File name: pasco2_sim_nodes.h
+**
+** Description: Bus and sensor node tables of the firmware for the host
+**   simulation with PASCO2_SIM_NODES nodes, laid out as in pasco2_sim.h.
+**   pasco2_task.c includes this file in place of its own tables when it is
+**   built with -DPASCO2_NODE_TABLE='"pasco2_sim_nodes.h"'.
+**
+** ===========================================================================
+** Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+** ===========================================================================
+**
+** ===========================================================================
+** Infineon Technologies AG (INFINEON) is supplying this file for use
+** exclusively with Infineon's sensor products. This file can be freely
+** distributed within development tools and software supporting such
+** products.
+**
+** THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+** OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+** MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+** INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+** WHATSOEVER.
+** ===========================================================================
+*/
+
+#pragma once
+
+/* Header file includes */
+#include "pasco2_sim.h"
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+#define PASCO2_SIM_BUS_CONFIG(bus) { PASCO2_SIM_BUS_SDA(bus), PASCO2_SIM_BUS_SCL(bus) },
+
+#define PASCO2_SIM_SENSOR_CONFIG(node)                                              \
+    {                                                                               \
+        .bus = PASCO2_SIM_NODE_BUS(node),                                           \
+        .route = { PASCO2_SIM_NODE_MUXED ? PASCO2_SIM_MUX_ADDRESS : 0U,             \
+                   PASCO2_SIM_NODE_MUXED ? PASCO2_SIM_NODE_CHANNEL(node) : 0U },    \
+        .dps_address = (uint16_t)XENSIV_DPS3XX_I2C_ADDR_ALT,                        \
+        .int_pin = PASCO2_SIM_NODE_INT(node)                                        \
+    },
+
+/*******************************************************************************
+ * Constants
+ ******************************************************************************/
+/* I2C buses of the sensor nodes */
+static const pasco2_bus_config_t bus_configs[] =
+{
+    PASCO2_SIM_BUS_CONFIG(0U)
+#if (PASCO2_SIM_NODE_BUSES > 1U)
+    PASCO2_SIM_BUS_CONFIG(1U)
+#endif
+#if (PASCO2_SIM_NODE_BUSES > 2U)
+    PASCO2_SIM_BUS_CONFIG(2U)
+#endif
+#if (PASCO2_SIM_NODE_BUSES > 3U)
+    PASCO2_SIM_BUS_CONFIG(3U)
+#endif
+};
+
+/* Sensor nodes */
+static const pasco2_sensor_config_t sensor_configs[] =
+{
+    PASCO2_SIM_SENSOR_CONFIG(0U)
+#if (PASCO2_SIM_NODES > 1U)
+    PASCO2_SIM_SENSOR_CONFIG(1U)
+#endif
+#if (PASCO2_SIM_NODES > 2U)
+    PASCO2_SIM_SENSOR_CONFIG(2U)
+#endif
+#if (PASCO2_SIM_NODES > 3U)
+    PASCO2_SIM_SENSOR_CONFIG(3U)
+#endif
+#if (PASCO2_SIM_NODES > 4U)
+    PASCO2_SIM_SENSOR_CONFIG(4U)
+#endif
+#if (PASCO2_SIM_NODES > 5U)
+    PASCO2_SIM_SENSOR_CONFIG(5U)
+#endif
+#if (PASCO2_SIM_NODES > 6U)
+    PASCO2_SIM_SENSOR_CONFIG(6U)
+#endif
+#if (PASCO2_SIM_NODES > 7U)
+    PASCO2_SIM_SENSOR_CONFIG(7U)
+#endif
+#if (PASCO2_SIM_NODES > 8U)
+    PASCO2_SIM_SENSOR_CONFIG(8U)
+#endif
+#if (PASCO2_SIM_NODES > 9U)
+    PASCO2_SIM_SENSOR_CONFIG(9U)
+#endif
+#if (PASCO2_SIM_NODES > 10U)
+    PASCO2_SIM_SENSOR_CONFIG(10U)
+#endif
+#if (PASCO2_SIM_NODES > 11U)
+    PASCO2_SIM_SENSOR_CONFIG(11U)
+#endif
+#if (PASCO2_SIM_NODES > 12U)
+    PASCO2_SIM_SENSOR_CONFIG(12U)
+#endif
+#if (PASCO2_SIM_NODES > 13U)
+    PASCO2_SIM_SENSOR_CONFIG(13U)
+#endif
+#if (PASCO2_SIM_NODES > 14U)
+    PASCO2_SIM_SENSOR_CONFIG(14U)
+#endif
+#if (PASCO2_SIM_NODES > 15U)
+    PASCO2_SIM_SENSOR_CONFIG(15U)
+#endif
+#if (PASCO2_SIM_NODES > 16U)
+    PASCO2_SIM_SENSOR_CONFIG(16U)
+#endif
+#if (PASCO2_SIM_NODES > 17U)
+    PASCO2_SIM_SENSOR_CONFIG(17U)
+#endif
+#if (PASCO2_SIM_NODES > 18U)
+    PASCO2_SIM_SENSOR_CONFIG(18U)
+#endif
+#if (PASCO2_SIM_NODES > 19U)
+    PASCO2_SIM_SENSOR_CONFIG(19U)
+#endif
+#if (PASCO2_SIM_NODES > 20U)
+    PASCO2_SIM_SENSOR_CONFIG(20U)
+#endif
+#if (PASCO2_SIM_NODES > 21U)
+    PASCO2_SIM_SENSOR_CONFIG(21U)
+#endif
+#if (PASCO2_SIM_NODES > 22U)
+    PASCO2_SIM_SENSOR_CONFIG(22U)
+#endif
+#if (PASCO2_SIM_NODES > 23U)
+    PASCO2_SIM_SENSOR_CONFIG(23U)
+#endif
+#if (PASCO2_SIM_NODES > 24U)
+    PASCO2_SIM_SENSOR_CONFIG(24U)
+#endif
+#if (PASCO2_SIM_NODES > 25U)
+    PASCO2_SIM_SENSOR_CONFIG(25U)
+#endif
+#if (PASCO2_SIM_NODES > 26U)
+    PASCO2_SIM_SENSOR_CONFIG(26U)
+#endif
+#if (PASCO2_SIM_NODES > 27U)
+    PASCO2_SIM_SENSOR_CONFIG(27U)
+#endif
+#if (PASCO2_SIM_NODES > 28U)
+    PASCO2_SIM_SENSOR_CONFIG(28U)
+#endif
+#if (PASCO2_SIM_NODES > 29U)
+    PASCO2_SIM_SENSOR_CONFIG(29U)
+#endif
+#if (PASCO2_SIM_NODES > 30U)
+    PASCO2_SIM_SENSOR_CONFIG(30U)
+#endif
+#if (PASCO2_SIM_NODES > 31U)
+    PASCO2_SIM_SENSOR_CONFIG(31U)
+#endif
+};
+
+/* [] END OF FILE */
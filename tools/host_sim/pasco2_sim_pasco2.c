@@ -0,0 +1,647 @@
+/*****************************************************************************
+** File name: pasco2_sim_pasco2.c
+**
+** Description: This file contains the register-level model of the XENSIV PAS
+**   CO2 sensor: power-up delay, idle, single and continuous modes, the
+**   status and data ready flags, the INT pin and the pressure reference.
+**   The gas concentration follows the occupancy of the simulated room.
+**
+** ===========================================================================
+** Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+** ===========================================================================
+**
+** ===========================================================================
+** Infineon Technologies AG (INFINEON) is supplying this file for use
+** exclusively with Infineon's sensor products. This file can be freely
+** distributed within development tools and software supporting such
+** products.
+**
+** THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+** OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+** MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+** INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+** WHATSOEVER.
+** ===========================================================================
+*/
+
+/* Header file from system */
+#include <inttypes.h>
+#include <math.h>
+#include <string.h>
+
+/* Header file includes */
+#include "pasco2_sim.h"
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+/* Registers */
+#define PASCO2_SIM_REG_PROD_ID          (0x00U)
+#define PASCO2_SIM_REG_SENS_STS         (0x01U)
+#define PASCO2_SIM_REG_MEAS_RATE_H      (0x02U)
+#define PASCO2_SIM_REG_MEAS_RATE_L      (0x03U)
+#define PASCO2_SIM_REG_MEAS_CFG         (0x04U)
+#define PASCO2_SIM_REG_CO2PPM_H         (0x05U)
+#define PASCO2_SIM_REG_CO2PPM_L         (0x06U)
+#define PASCO2_SIM_REG_MEAS_STS         (0x07U)
+#define PASCO2_SIM_REG_INT_CFG          (0x08U)
+#define PASCO2_SIM_REG_PRESS_REF_H      (0x0BU)
+#define PASCO2_SIM_REG_PRESS_REF_L      (0x0CU)
+#define PASCO2_SIM_REG_CALIB_REF_H      (0x0DU)
+#define PASCO2_SIM_REG_CALIB_REF_L      (0x0EU)
+#define PASCO2_SIM_REG_SENS_RST         (0x10U)
+
+/* Register fields */
+#define PASCO2_SIM_SENS_STS_SEN_RDY     (0x80U)
+#define PASCO2_SIM_SENS_STS_ICCER       (0x08U)
+#define PASCO2_SIM_SENS_STS_CLR_MSK     (0x07U)
+#define PASCO2_SIM_SENS_STS_CLR_POS     (3U)
+#define PASCO2_SIM_MEAS_CFG_OP_MODE_MSK (0x03U)
+#define PASCO2_SIM_MEAS_CFG_BOC_MSK     (0x0CU)
+#define PASCO2_SIM_BOC_AUTOMATIC        (0x04U)
+#define PASCO2_SIM_OP_MODE_IDLE         (0U)
+#define PASCO2_SIM_OP_MODE_SINGLE       (1U)
+#define PASCO2_SIM_OP_MODE_CONTINUOUS   (2U)
+#define PASCO2_SIM_MEAS_STS_DRDY        (0x10U)
+#define PASCO2_SIM_MEAS_STS_INT_STS     (0x08U)
+#define PASCO2_SIM_MEAS_STS_ALARM       (0x04U)
+#define PASCO2_SIM_MEAS_STS_INT_STS_CLR (0x02U)
+#define PASCO2_SIM_MEAS_STS_ALARM_CLR   (0x01U)
+#define PASCO2_SIM_INT_CFG_INT_TYP      (0x10U)
+#define PASCO2_SIM_INT_CFG_FUNC_MSK     (0x0EU)
+#define PASCO2_SIM_INT_CFG_FUNC_DRDY    (0x04U)
+#define PASCO2_SIM_CMD_SOFT_RESET       (0xA3U)
+
+/* Measurement rate limits in seconds */
+#define PASCO2_SIM_MEAS_RATE_MIN        (5U)
+#define PASCO2_SIM_MEAS_RATE_MAX        (4095U)
+
+/* Time from power-up or reset until the sensor answers */
+#define PASCO2_SIM_STARTUP_US           (1000000U)
+
+/* Time from the start of a measurement until its result is ready */
+#define PASCO2_SIM_MEASUREMENT_US       (1150000U)
+
+/* Integration step of the room model */
+#define PASCO2_SIM_ROOM_STEP_US         (60000000U)
+
+/* Time constants of the room filling up and airing out */
+#define PASCO2_SIM_ROOM_RISE_S          (3600.0)
+#define PASCO2_SIM_ROOM_DECAY_S         (7200.0)
+
+/* Measurement noise amplitude in ppm */
+#define PASCO2_SIM_NOISE_PPM            (8.0)
+
+/* Period after which the ABOC takes the lowest value for the calibration
+ * reference */
+#define PASCO2_SIM_ABOC_PERIOD_US       (7U * 86400000000ULL)
+
+/* Register values after reset */
+static const uint8_t pasco2_sim_reg_defaults[PASCO2_SIM_PASCO2_REG_COUNT] =
+{
+    [PASCO2_SIM_REG_PROD_ID] = 0x42U,
+    [PASCO2_SIM_REG_SENS_STS] = PASCO2_SIM_SENS_STS_SEN_RDY,
+    [PASCO2_SIM_REG_MEAS_RATE_H] = 0x00U,
+    [PASCO2_SIM_REG_MEAS_RATE_L] = 0x3CU,
+    /* Idle, ABOC enabled, as the sensor comes out of reset */
+    [PASCO2_SIM_REG_MEAS_CFG] = 0x24U,
+    [PASCO2_SIM_REG_INT_CFG] = 0x11U,
+    [PASCO2_SIM_REG_PRESS_REF_H] = 0x03U,
+    [PASCO2_SIM_REG_PRESS_REF_L] = 0xF7U,
+    [PASCO2_SIM_REG_CALIB_REF_H] = 0x01U,
+    [PASCO2_SIM_REG_CALIB_REF_L] = 0x90U
+};
+
+/*******************************************************************************
+ * Function Name: room_update
+ ********************************************************************************
+ * Summary:
+ *  Advances the true gas concentration of the room to the current time.
+ *
+ * Parameters:
+ *  sensor: sensor model
+ *
+ * Return:
+ *  None
+ *******************************************************************************/
+static void room_update(pasco2_sim_pasco2_t *sensor)
+{
+    uint64_t now = pasco2_sim_now_us();
+
+    while (sensor->ppm_us < now)
+    {
+        uint64_t step = now - sensor->ppm_us;
+        step = (step > PASCO2_SIM_ROOM_STEP_US) ? PASCO2_SIM_ROOM_STEP_US : step;
+
+        double target = pasco2_sim_env_co2_target(sensor->ppm_us);
+        double tau = (target > sensor->ppm) ? PASCO2_SIM_ROOM_RISE_S : PASCO2_SIM_ROOM_DECAY_S;
+        sensor->ppm += (target - sensor->ppm) * (1.0 - exp(-((double)step / 1e6) / tau));
+        sensor->ppm_us += step;
+    }
+}
+
+/*******************************************************************************
+ * Function Name: update_int
+ ********************************************************************************
+ * Summary:
+ *  Drives the INT pin from the data ready flag and the interrupt config.
+ *
+ * Parameters:
+ *  sensor: sensor model
+ *
+ * Return:
+ *  None
+ *******************************************************************************/
+static void update_int(pasco2_sim_pasco2_t *sensor)
+{
+    uint8_t int_cfg = sensor->regs[PASCO2_SIM_REG_INT_CFG];
+    bool active = ((int_cfg & PASCO2_SIM_INT_CFG_FUNC_MSK) == PASCO2_SIM_INT_CFG_FUNC_DRDY) &&
+                  ((sensor->regs[PASCO2_SIM_REG_MEAS_STS] & PASCO2_SIM_MEAS_STS_DRDY) != 0U);
+    bool high_active = (int_cfg & PASCO2_SIM_INT_CFG_INT_TYP) != 0U;
+
+    pasco2_sim_gpio_drive(sensor->int_pin, active == high_active);
+}
+
+/*******************************************************************************
+ * Function Name: aboc_update
+ ********************************************************************************
+ * Summary:
+ *  Models the automatic baseline offset compensation: the lowest value of
+ *  every ABOC period is taken for the calibration reference from then on.
+ *  The learned correction is lost on reset and power-up.
+ *
+ * Parameters:
+ *  sensor: sensor model
+ *  ppm: measured value before the correction
+ *
+ * Return:
+ *  Corrected value
+ *******************************************************************************/
+static double aboc_update(pasco2_sim_pasco2_t *sensor, double ppm)
+{
+    uint64_t now = pasco2_sim_now_us();
+    uint16_t reference = (uint16_t)((sensor->regs[PASCO2_SIM_REG_CALIB_REF_H] << 8U) |
+                                    sensor->regs[PASCO2_SIM_REG_CALIB_REF_L]);
+
+    sensor->aboc_min = fmin(sensor->aboc_min, ppm);
+    if ((now - sensor->aboc_start_us) >= PASCO2_SIM_ABOC_PERIOD_US)
+    {
+        sensor->aboc_offset = (double)reference - sensor->aboc_min;
+        sensor->aboc_min = INFINITY;
+        sensor->aboc_start_us = now;
+    }
+
+    return ppm + sensor->aboc_offset;
+}
+
+/*******************************************************************************
+ * Function Name: measurement_done
+ ********************************************************************************
+ * Summary:
+ *  Stores a new result. The sensor measures the gas density, so the result
+ *  is off by the ratio of the ambient pressure to the pressure reference.
+ *
+ * Parameters:
+ *  arg: sensor model
+ *
+ * Return:
+ *  None
+ *******************************************************************************/
+static void measurement_done(void *arg)
+{
+    pasco2_sim_pasco2_t *sensor = arg;
+    uint8_t *regs = sensor->regs;
+    uint64_t now = pasco2_sim_now_us();
+
+    room_update(sensor);
+    if (sensor->fault == PASCO2_SIM_PASCO2_FAULT_FREEZE)
+    {
+        /* The measurement never completes */
+        return;
+    }
+
+    uint16_t press_ref = (uint16_t)((regs[PASCO2_SIM_REG_PRESS_REF_H] << 8U) | regs[PASCO2_SIM_REG_PRESS_REF_L]);
+    double noise = ((double)(pasco2_sim_random(&sensor->seed) % 2001U) / 1000.0 - 1.0) * PASCO2_SIM_NOISE_PPM;
+    double drift = sensor->drift_ppm + sensor->drift_ppm_day * ((double)now / 86400e6);
+    double ppm = sensor->ppm * pasco2_sim_env_pressure(now) / (double)((press_ref > 0U) ? press_ref : 1U) +
+                 drift + noise;
+    if ((regs[PASCO2_SIM_REG_MEAS_CFG] & PASCO2_SIM_MEAS_CFG_BOC_MSK) == PASCO2_SIM_BOC_AUTOMATIC)
+    {
+        ppm = aboc_update(sensor, ppm);
+        sensor->stats.aboc_measurements++;
+    }
+    sensor->measured_ppm = sensor->ppm;
+    uint16_t value = (ppm < 0.0) ? 0U : (ppm > 32767.0) ? 32767U : (uint16_t)lround(ppm);
+
+    if ((regs[PASCO2_SIM_REG_MEAS_STS] & PASCO2_SIM_MEAS_STS_DRDY) != 0U)
+    {
+        sensor->stats.results_lost++;
+    }
+    regs[PASCO2_SIM_REG_CO2PPM_H] = (uint8_t)(value >> 8U);
+    regs[PASCO2_SIM_REG_CO2PPM_L] = (uint8_t)value;
+    regs[PASCO2_SIM_REG_MEAS_STS] |= PASCO2_SIM_MEAS_STS_DRDY | PASCO2_SIM_MEAS_STS_INT_STS;
+    sensor->result_us = now;
+    sensor->stats.measurements++;
+
+    if ((regs[PASCO2_SIM_REG_MEAS_CFG] & PASCO2_SIM_MEAS_CFG_OP_MODE_MSK) == PASCO2_SIM_OP_MODE_CONTINUOUS)
+    {
+        uint16_t rate = (uint16_t)((regs[PASCO2_SIM_REG_MEAS_RATE_H] << 8U) | regs[PASCO2_SIM_REG_MEAS_RATE_L]);
+        pasco2_sim_event_schedule(&sensor->measurement, now + (uint64_t)rate * 1000000U, measurement_done, sensor);
+    }
+    else
+    {
+        regs[PASCO2_SIM_REG_MEAS_CFG] &= (uint8_t)~PASCO2_SIM_MEAS_CFG_OP_MODE_MSK;
+    }
+
+    update_int(sensor);
+}
+
+/*******************************************************************************
+ * Function Name: reset
+ ********************************************************************************
+ * Summary:
+ *  Restores the register defaults and restarts the power-up delay. A frozen
+ *  measurement and the ABOC correction are cleared.
+ *
+ * Parameters:
+ *  sensor: sensor model
+ *
+ * Return:
+ *  None
+ *******************************************************************************/
+static void reset(pasco2_sim_pasco2_t *sensor)
+{
+    pasco2_sim_event_cancel(&sensor->measurement);
+    memcpy(sensor->regs, pasco2_sim_reg_defaults, sizeof(sensor->regs));
+    sensor->pointer = 0U;
+    sensor->ready_us = pasco2_sim_now_us() + PASCO2_SIM_STARTUP_US;
+    sensor->aboc_offset = 0.0;
+    sensor->aboc_min = INFINITY;
+    sensor->aboc_start_us = pasco2_sim_now_us();
+    if (sensor->fault == PASCO2_SIM_PASCO2_FAULT_FREEZE)
+    {
+        sensor->fault = PASCO2_SIM_PASCO2_FAULT_NONE;
+        sensor->fault_cleared_us = pasco2_sim_now_us();
+    }
+    update_int(sensor);
+}
+
+/*******************************************************************************
+ * Function Name: write_reg
+ ********************************************************************************
+ * Summary:
+ *  Applies a register write. Mode and rate changes outside idle mode are
+ *  rejected with the ICCER flag, as on the device.
+ *
+ * Parameters:
+ *  sensor: sensor model
+ *  reg: register address
+ *  value: value written
+ *
+ * Return:
+ *  None
+ *******************************************************************************/
+static void write_reg(pasco2_sim_pasco2_t *sensor, uint8_t reg, uint8_t value)
+{
+    uint8_t *regs = sensor->regs;
+    uint8_t op_mode = regs[PASCO2_SIM_REG_MEAS_CFG] & PASCO2_SIM_MEAS_CFG_OP_MODE_MSK;
+
+    switch (reg)
+    {
+        case PASCO2_SIM_REG_SENS_STS:
+            regs[reg] &= (uint8_t)~((value & PASCO2_SIM_SENS_STS_CLR_MSK) << PASCO2_SIM_SENS_STS_CLR_POS);
+            break;
+
+        case PASCO2_SIM_REG_MEAS_RATE_H:
+        case PASCO2_SIM_REG_MEAS_RATE_L:
+            if (op_mode != PASCO2_SIM_OP_MODE_IDLE)
+            {
+                regs[PASCO2_SIM_REG_SENS_STS] |= PASCO2_SIM_SENS_STS_ICCER;
+                sensor->stats.iccer++;
+            }
+            else
+            {
+                regs[reg] = value;
+            }
+            break;
+
+        case PASCO2_SIM_REG_MEAS_CFG:
+        {
+            uint8_t new_mode = value & PASCO2_SIM_MEAS_CFG_OP_MODE_MSK;
+            uint16_t rate = (uint16_t)((regs[PASCO2_SIM_REG_MEAS_RATE_H] << 8U) | regs[PASCO2_SIM_REG_MEAS_RATE_L]);
+
+            if ((new_mode != PASCO2_SIM_OP_MODE_IDLE) &&
+                ((op_mode != PASCO2_SIM_OP_MODE_IDLE) ||
+                 ((new_mode == PASCO2_SIM_OP_MODE_CONTINUOUS) &&
+                  ((rate < PASCO2_SIM_MEAS_RATE_MIN) || (rate > PASCO2_SIM_MEAS_RATE_MAX)))))
+            {
+                regs[PASCO2_SIM_REG_SENS_STS] |= PASCO2_SIM_SENS_STS_ICCER;
+                sensor->stats.iccer++;
+                break;
+            }
+
+            regs[reg] = value & 0x3FU;
+            if (new_mode == PASCO2_SIM_OP_MODE_IDLE)
+            {
+                pasco2_sim_event_cancel(&sensor->measurement);
+            }
+            else
+            {
+                pasco2_sim_event_schedule(&sensor->measurement, pasco2_sim_now_us() + PASCO2_SIM_MEASUREMENT_US,
+                                          measurement_done, sensor);
+            }
+            break;
+        }
+
+        case PASCO2_SIM_REG_MEAS_STS:
+            if ((value & PASCO2_SIM_MEAS_STS_INT_STS_CLR) != 0U)
+            {
+                regs[reg] &= (uint8_t)~PASCO2_SIM_MEAS_STS_INT_STS;
+            }
+            if ((value & PASCO2_SIM_MEAS_STS_ALARM_CLR) != 0U)
+            {
+                regs[reg] &= (uint8_t)~PASCO2_SIM_MEAS_STS_ALARM;
+            }
+            break;
+
+        case PASCO2_SIM_REG_INT_CFG:
+            regs[reg] = value & 0x1FU;
+            update_int(sensor);
+            break;
+
+        case PASCO2_SIM_REG_PRESS_REF_L:
+            sensor->stats.reference_writes++;
+            regs[reg] = value;
+            break;
+
+        case PASCO2_SIM_REG_SENS_RST:
+            if (value == PASCO2_SIM_CMD_SOFT_RESET)
+            {
+                reset(sensor);
+            }
+            break;
+
+        case PASCO2_SIM_REG_PROD_ID:
+        case PASCO2_SIM_REG_CO2PPM_H:
+        case PASCO2_SIM_REG_CO2PPM_L:
+            break;
+
+        default:
+            regs[reg] = value;
+            break;
+    }
+}
+
+/*******************************************************************************
+ * Function Name: device_write
+ ********************************************************************************
+ * Summary:
+ *  Handles an I2C write: register pointer followed by data bytes.
+ *
+ * Parameters:
+ *  device: sensor model
+ *  data: bytes written
+ *  size: number of bytes
+ *
+ * Return:
+ *  False to NACK while the sensor is off, hangs or powers up
+ *******************************************************************************/
+static bool device_write(pasco2_sim_i2c_device_t *device, const uint8_t *data, size_t size)
+{
+    pasco2_sim_pasco2_t *sensor = (pasco2_sim_pasco2_t *)device;
+
+    if (!sensor->powered || (sensor->fault == PASCO2_SIM_PASCO2_FAULT_HANG) ||
+        (pasco2_sim_now_us() < sensor->ready_us))
+    {
+        return false;
+    }
+
+    sensor->pointer = data[0];
+    for (size_t i = 1U; i < size; i++)
+    {
+        if (sensor->pointer < PASCO2_SIM_PASCO2_REG_COUNT)
+        {
+            write_reg(sensor, sensor->pointer, data[i]);
+        }
+        sensor->pointer++;
+    }
+
+    return true;
+}
+
+/*******************************************************************************
+ * Function Name: device_read
+ ********************************************************************************
+ * Summary:
+ *  Handles an I2C read from the register pointer. Reading the low byte of
+ *  the result clears the data ready flag, releases the INT pin, and counts
+ *  the time since the result was stored.
+ *
+ * Parameters:
+ *  device: sensor model
+ *  data: receives the bytes
+ *  size: number of bytes
+ *
+ * Return:
+ *  False to NACK while the sensor is off, hangs or powers up
+ *******************************************************************************/
+static bool device_read(pasco2_sim_i2c_device_t *device, uint8_t *data, size_t size)
+{
+    pasco2_sim_pasco2_t *sensor = (pasco2_sim_pasco2_t *)device;
+
+    if (!sensor->powered || (sensor->fault == PASCO2_SIM_PASCO2_FAULT_HANG) ||
+        (pasco2_sim_now_us() < sensor->ready_us))
+    {
+        return false;
+    }
+
+    for (size_t i = 0U; i < size; i++)
+    {
+        uint8_t reg = sensor->pointer++;
+
+        data[i] = (reg < PASCO2_SIM_PASCO2_REG_COUNT) ? sensor->regs[reg] : 0U;
+        if ((reg == PASCO2_SIM_REG_CO2PPM_L) &&
+            ((sensor->regs[PASCO2_SIM_REG_MEAS_STS] & PASCO2_SIM_MEAS_STS_DRDY) != 0U))
+        {
+            uint64_t latency_us = pasco2_sim_now_us() - sensor->result_us;
+            sensor->regs[PASCO2_SIM_REG_MEAS_STS] &= (uint8_t)~PASCO2_SIM_MEAS_STS_DRDY;
+            sensor->stats.results_read++;
+            sensor->stats.latency_sum_us += latency_us;
+            if (latency_us > sensor->stats.latency_max_us)
+            {
+                sensor->stats.latency_max_us = latency_us;
+            }
+            if ((sensor->fault_us != PASCO2_SIM_TIME_NEVER) && (sensor->fault == PASCO2_SIM_PASCO2_FAULT_NONE) &&
+                (sensor->fault_read_us == PASCO2_SIM_TIME_NEVER))
+            {
+                sensor->fault_read_us = pasco2_sim_now_us();
+            }
+            update_int(sensor);
+        }
+    }
+
+    return true;
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_sim_pasco2_init
+ ********************************************************************************
+ * Summary:
+ *  Powers up a PAS CO2 model.
+ *
+ * Parameters:
+ *  sensor: sensor model
+ *  address: I2C address
+ *  int_pin: MCU pin the INT line is routed to, NC if none
+ *  seed: seed of the measurement noise
+ *
+ * Return:
+ *  None
+ *******************************************************************************/
+void pasco2_sim_pasco2_init(pasco2_sim_pasco2_t *sensor, uint16_t address, cyhal_gpio_t int_pin, uint32_t seed)
+{
+    memset(sensor, 0, sizeof(*sensor));
+    sensor->device.address = address;
+    sensor->device.write = device_write;
+    sensor->device.read = device_read;
+    sensor->int_pin = int_pin;
+    sensor->seed = seed;
+    sensor->powered = true;
+    sensor->fault_us = PASCO2_SIM_TIME_NEVER;
+    sensor->ppm = pasco2_sim_env_co2_target(0U);
+    reset(sensor);
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_sim_pasco2_report
+ ********************************************************************************
+ * Summary:
+ *  Prints the counters of a PAS CO2 model.
+ *
+ * Parameters:
+ *  sensor: sensor model
+ *  out: report stream
+ *
+ * Return:
+ *  None
+ *******************************************************************************/
+void pasco2_sim_pasco2_report(const pasco2_sim_pasco2_t *sensor, FILE *out)
+{
+    uint32_t read = sensor->stats.results_read;
+
+    fprintf(out, "PAS CO2 0x%02X: %" PRIu32 " measurements, %" PRIu32 " with ABOC, %" PRIu32 " read, %" PRIu32
+            " overwritten unread, %" PRIu32 " pressure references, %" PRIu32
+            " rejected writes, read latency mean %.1f ms, max %.1f ms\n",
+            sensor->device.address, sensor->stats.measurements, sensor->stats.aboc_measurements, read,
+            sensor->stats.results_lost, sensor->stats.reference_writes, sensor->stats.iccer,
+            (read > 0U) ? ((double)sensor->stats.latency_sum_us / (double)read / 1000.0) : 0.0,
+            (double)sensor->stats.latency_max_us / 1000.0);
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_sim_pasco2_continuous_rate
+ ********************************************************************************
+ * Summary:
+ *  Returns the measurement rate of a PAS CO2 model in continuous mode.
+ *
+ * Parameters:
+ *  sensor: sensor model
+ *
+ * Return:
+ *  Measurement rate in seconds, 0 if the sensor is not in continuous mode
+ *******************************************************************************/
+uint16_t pasco2_sim_pasco2_continuous_rate(const pasco2_sim_pasco2_t *sensor)
+{
+    const uint8_t *regs = sensor->regs;
+
+    if ((regs[PASCO2_SIM_REG_MEAS_CFG] & PASCO2_SIM_MEAS_CFG_OP_MODE_MSK) != PASCO2_SIM_OP_MODE_CONTINUOUS)
+    {
+        return 0U;
+    }
+
+    return (uint16_t)((regs[PASCO2_SIM_REG_MEAS_RATE_H] << 8U) | regs[PASCO2_SIM_REG_MEAS_RATE_L]);
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_sim_pasco2_fault
+ ********************************************************************************
+ * Summary:
+ *  Injects a fault and starts measuring the time until the host reads a
+ *  result again. A frozen sensor stops measuring until it is reset, a hung
+ *  sensor stops acknowledging until its supply is switched off.
+ *
+ * Parameters:
+ *  sensor: sensor model
+ *  fault: fault to inject, PASCO2_SIM_PASCO2_FAULT_NONE only starts the
+ *    measurement for a fault elsewhere on the bus
+ *
+ * Return:
+ *  None
+ *******************************************************************************/
+void pasco2_sim_pasco2_fault(pasco2_sim_pasco2_t *sensor, pasco2_sim_pasco2_fault_t fault)
+{
+    sensor->fault = fault;
+    sensor->fault_us = pasco2_sim_now_us();
+    sensor->fault_cleared_us = PASCO2_SIM_TIME_NEVER;
+    sensor->fault_read_us = PASCO2_SIM_TIME_NEVER;
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_sim_pasco2_power
+ ********************************************************************************
+ * Summary:
+ *  Switches the supply of the sensor. Switching it on clears any fault and
+ *  starts the power-up delay.
+ *
+ * Parameters:
+ *  sensor: sensor model
+ *  on: new state of the supply
+ *
+ * Return:
+ *  None
+ *******************************************************************************/
+void pasco2_sim_pasco2_power(pasco2_sim_pasco2_t *sensor, bool on)
+{
+    if (on == sensor->powered)
+    {
+        return;
+    }
+
+    sensor->powered = on;
+    if (!on)
+    {
+        pasco2_sim_event_cancel(&sensor->measurement);
+        return;
+    }
+
+    if (sensor->fault != PASCO2_SIM_PASCO2_FAULT_NONE)
+    {
+        sensor->fault = PASCO2_SIM_PASCO2_FAULT_NONE;
+        sensor->fault_cleared_us = pasco2_sim_now_us();
+    }
+    reset(sensor);
+}
+
+/*******************************************************************************
+ * Function Name: pasco2_sim_pasco2_drift
+ ********************************************************************************
+ * Summary:
+ *  Sets the baseline drift of the sensor: an offset that every result
+ *  carries and that grows over the run, as the sensor ages.
+ *
+ * Parameters:
+ *  sensor: sensor model
+ *  ppm: offset at the start of the run
+ *  ppm_per_day: growth of the offset per day
+ *
+ * Return:
+ *  None
+ *******************************************************************************/
+void pasco2_sim_pasco2_drift(pasco2_sim_pasco2_t *sensor, double ppm, double ppm_per_day)
+{
+    sensor->drift_ppm = ppm;
+    sensor->drift_ppm_day = ppm_per_day;
+}
+
+/* [] END OF FILE */
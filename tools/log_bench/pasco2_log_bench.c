@@ -0,0 +1,328 @@
+/*****************************************************************************
+** File name: pasco2_log_bench.c
+**
+** Description: Host benchmark of the deferred logger. Times the recording
+** of every message of the log table against formatting the same message
+** with snprintf and printing it with fprintf, and checks that the recorded
+** messages come out of the buffer unchanged.
+**
+** Build (Linux):
+**   cc -O2 -I../../source -I../../configs -I../host_sim/include -o pasco2_log_bench \
+**      pasco2_log_bench.c ../../source/pasco2_log.c
+**
+** ===========================================================================
+** Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+** ===========================================================================
+**
+** ===========================================================================
+** Infineon Technologies AG (INFINEON) is supplying this file for use
+** exclusively with Infineon's sensor products. This file can be freely
+** distributed within development tools and software supporting such
+** products.
+**
+** THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+** OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+** MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+** INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+** WHATSOEVER.
+** ===========================================================================
+*/
+
+/* Header file from system */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/* Header file includes */
+#include "cyabs_rtos.h"
+
+/* Header file for the logger of the firmware */
+#include "pasco2_log.h"
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+#define DEFAULT_CALLS           (1000000U)
+
+/* Longest formatted message */
+#define MESSAGE_LENGTH          (96U)
+
+/*******************************************************************************
+ * Global Variables
+ ******************************************************************************/
+#define LOG_FORMAT(id, format) format,
+static const char *const log_formats[PASCO2_LOG_MESSAGE_COUNT] =
+{
+    PASCO2_LOG_MESSAGES(LOG_FORMAT)
+};
+#undef LOG_FORMAT
+
+static TickType_t tick_count;
+
+/* Keeps the compiler from removing the formatting */
+static volatile uint32_t sink;
+
+/*******************************************************************************
+ * Function Name: pasco2_sim_assert_failed
+ *******************************************************************************
+ * Summary:
+ *   Target of CY_ASSERT in the host stand-in headers.
+ *
+ * Parameters:
+ *   file: source file of the failed check
+ *   line: line of the failed check
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+void pasco2_sim_assert_failed(const char *file, int line)
+{
+    fprintf(stderr, "assertion failed at %s:%d\n", file, line);
+    abort();
+}
+
+/*******************************************************************************
+ * Function Name: xTaskGetTickCount
+ *******************************************************************************
+ * Summary:
+ *   Stand-in for the RTOS tick of the logger, advances by one per call.
+ *
+ * Parameters:
+ *   none
+ *
+ * Return:
+ *   tick count
+ ******************************************************************************/
+TickType_t xTaskGetTickCount(void)
+{
+    return tick_count++;
+}
+
+/*******************************************************************************
+ * Function Name: message_args
+ *******************************************************************************
+ * Summary:
+ *   Returns the message and the arguments of a call: the messages of the
+ *   table in turn, a sensor index, and a value of three to five digits.
+ *
+ * Parameters:
+ *   call: number of the call
+ *   args: destination of the two arguments
+ *
+ * Return:
+ *   message identifier
+ ******************************************************************************/
+static uint16_t message_args(uint32_t call, uint32_t args[2])
+{
+    args[0] = call % 4U;
+    args[1] = 400U + ((call * 2654435761U) >> 17);
+    return (uint16_t)(call % (uint32_t)PASCO2_LOG_MESSAGE_COUNT);
+}
+
+/*******************************************************************************
+ * Function Name: elapsed_ns
+ *******************************************************************************
+ * Summary:
+ *   Returns the time between two clock readings.
+ *
+ * Parameters:
+ *   start: first reading
+ *   end: second reading
+ *
+ * Return:
+ *   nanoseconds
+ ******************************************************************************/
+static double elapsed_ns(const struct timespec *start, const struct timespec *end)
+{
+    return ((double)(end->tv_sec - start->tv_sec) * 1e9) + (double)(end->tv_nsec - start->tv_nsec);
+}
+
+/*******************************************************************************
+ * Function Name: bench_record
+ *******************************************************************************
+ * Summary:
+ *   Times pasco2_log_record in batches that fill the buffer. The buffer is
+ *   drained between the batches outside the timing, and every record is
+ *   compared with the arguments of its call.
+ *
+ * Parameters:
+ *   calls: number of calls
+ *   level: level of the calls
+ *   recorded: false if the level is above the runtime level and the calls
+ *             must not store a record
+ *   mismatches: number of records that differ from their call, updated
+ *
+ * Return:
+ *   nanoseconds per call
+ ******************************************************************************/
+static double bench_record(uint32_t calls, uint8_t level, bool recorded, uint32_t *mismatches)
+{
+    struct timespec start;
+    struct timespec end;
+    double total_ns = 0.0;
+    uint32_t args[PASCO2_LOG_BUFFER_LENGTH][2];
+    uint16_t ids[PASCO2_LOG_BUFFER_LENGTH];
+
+    for (uint32_t call = 0U; call < calls; call += PASCO2_LOG_BUFFER_LENGTH)
+    {
+        uint32_t batch = ((calls - call) < PASCO2_LOG_BUFFER_LENGTH) ? (calls - call) : PASCO2_LOG_BUFFER_LENGTH;
+        for (uint32_t i = 0U; i < batch; i++)
+        {
+            ids[i] = message_args(call + i, args[i]);
+        }
+
+        (void)clock_gettime(CLOCK_MONOTONIC, &start);
+        for (uint32_t i = 0U; i < batch; i++)
+        {
+            pasco2_log_record(level, ids[i], args[i][0], args[i][1]);
+        }
+        (void)clock_gettime(CLOCK_MONOTONIC, &end);
+        total_ns += elapsed_ns(&start, &end);
+
+        pasco2_log_record_t record;
+        uint32_t popped = 0U;
+        while (pasco2_log_pop(&record))
+        {
+            if ((popped >= batch) || (record.id != ids[popped]) || (record.level != level) ||
+                (record.args[0] != args[popped][0]) || (record.args[1] != args[popped][1]))
+            {
+                (*mismatches)++;
+            }
+            popped++;
+        }
+        if (popped != (recorded ? batch : 0U))
+        {
+            (*mismatches)++;
+        }
+    }
+
+    return total_ns / calls;
+}
+
+/*******************************************************************************
+ * Function Name: bench_snprintf
+ *******************************************************************************
+ * Summary:
+ *   Times formatting the messages of bench_record into a buffer.
+ *
+ * Parameters:
+ *   calls: number of calls
+ *
+ * Return:
+ *   nanoseconds per call
+ ******************************************************************************/
+static double bench_snprintf(uint32_t calls)
+{
+    struct timespec start;
+    struct timespec end;
+    char text[MESSAGE_LENGTH];
+    uint32_t args[2];
+    uint32_t length = 0U;
+
+    (void)clock_gettime(CLOCK_MONOTONIC, &start);
+    for (uint32_t call = 0U; call < calls; call++)
+    {
+        uint16_t id = message_args(call, args);
+        length += (uint32_t)snprintf(text, sizeof(text), log_formats[id], args[0], args[1]);
+    }
+    (void)clock_gettime(CLOCK_MONOTONIC, &end);
+    sink = length;
+
+    return elapsed_ns(&start, &end) / calls;
+}
+
+/*******************************************************************************
+ * Function Name: bench_fprintf
+ *******************************************************************************
+ * Summary:
+ *   Times printing the messages of bench_record with their line end to a
+ *   buffered stream, which stands in for printf to the console.
+ *
+ * Parameters:
+ *   calls: number of calls
+ *   stream: destination stream
+ *
+ * Return:
+ *   nanoseconds per call
+ ******************************************************************************/
+static double bench_fprintf(uint32_t calls, FILE *stream)
+{
+    struct timespec start;
+    struct timespec end;
+    uint32_t args[2];
+
+    (void)clock_gettime(CLOCK_MONOTONIC, &start);
+    for (uint32_t call = 0U; call < calls; call++)
+    {
+        uint16_t id = message_args(call, args);
+        (void)fprintf(stream, log_formats[id], args[0], args[1]);
+        (void)fputs("\r\n", stream);
+    }
+    (void)fflush(stream);
+    (void)clock_gettime(CLOCK_MONOTONIC, &end);
+
+    return elapsed_ns(&start, &end) / calls;
+}
+
+/*******************************************************************************
+ * Function Name: main
+ *******************************************************************************
+ * Summary:
+ *   Runs the benchmark. Options: -n number of calls per method.
+ *
+ * Parameters:
+ *   argc: number of arguments
+ *   argv: arguments
+ *
+ * Return:
+ *   0 if all checks passed
+ ******************************************************************************/
+int main(int argc, char *argv[])
+{
+    uint32_t calls = DEFAULT_CALLS;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if ((strcmp(argv[i], "-n") == 0) && ((i + 1) < argc))
+        {
+            calls = (uint32_t)strtoul(argv[++i], NULL, 10);
+        }
+        else
+        {
+            fprintf(stderr, "usage: %s [-n calls]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    FILE *null_stream = fopen("/dev/null", "w");
+    if ((calls == 0U) || (null_stream == NULL))
+    {
+        fprintf(stderr, "need at least one call and /dev/null\n");
+        return 2;
+    }
+
+    uint32_t mismatches = 0U;
+    pasco2_log_set_level(PASCO2_LOG_LEVEL_INFO);
+    double record_ns = bench_record(calls, PASCO2_LOG_LEVEL_INFO, true, &mismatches);
+    double filtered_ns = bench_record(calls, PASCO2_LOG_LEVEL_DEBUG, false, &mismatches);
+    double snprintf_ns = bench_snprintf(calls);
+    double fprintf_ns = bench_fprintf(calls, null_stream);
+    (void)fclose(null_stream);
+
+    uint32_t dropped = pasco2_log_get_dropped();
+
+    printf("calls %lu per method over %u messages, buffer of %u records\n", (unsigned long)calls,
+           (unsigned int)PASCO2_LOG_MESSAGE_COUNT, PASCO2_LOG_BUFFER_LENGTH);
+    printf("pasco2_log_record        %7.1f ns per call\n", record_ns);
+    printf("pasco2_log_record, off   %7.1f ns per call (level above the runtime level)\n", filtered_ns);
+    printf("snprintf                 %7.1f ns per call, %.1fx the record\n", snprintf_ns, snprintf_ns / record_ns);
+    printf("fprintf to /dev/null     %7.1f ns per call, %.1fx the record\n", fprintf_ns, fprintf_ns / record_ns);
+    printf("check %s, %lu mismatches, %lu dropped\n", ((mismatches == 0U) && (dropped == 0U)) ? "passed" : "FAILED",
+           (unsigned long)mismatches, (unsigned long)dropped);
+
+    return ((mismatches == 0U) && (dropped == 0U)) ? 0 : 1;
+}
+
+/* [] END OF FILE */
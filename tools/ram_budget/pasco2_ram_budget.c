@@ -0,0 +1,535 @@
+/*****************************************************************************
+** File name: pasco2_ram_budget.c
+**
+** Description: RAM budget check on the GNU linker map of the firmware. Sums
+** the output sections placed in the RAM region, reports the newlib heap and
+** the main stack reservation apart from the static data, lists the largest
+** variables and the RAM per object file, and fails if the static RAM and the
+** main stack exceed the budget.
+**
+** Build (Linux):
+**   cc -O2 -o pasco2_ram_budget pasco2_ram_budget.c
+**
+** Usage:
+**   pasco2_ram_budget [-b bytes] [-n top] file.map
+**     -b  budget in bytes, default the length of the RAM region
+**     -n  number of variables and object files listed, default 15
+**   The map is written by the build, build/<target>/<config>/<app>.map. Maps
+**   without a RAM region, such as the one of the host simulation, fall back to
+**   the .data, .bss, and .noinit output sections.
+**
+** ===========================================================================
+** Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+** ===========================================================================
+**
+** ===========================================================================
+** Infineon Technologies AG (INFINEON) is supplying this file for use
+** exclusively with Infineon's sensor products. This file can be freely
+** distributed within development tools and software supporting such
+** products.
+**
+** THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+** OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+** MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+** INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+** WHATSOEVER.
+** ===========================================================================
+*/
+
+/* Header file from system */
+#include <ctype.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+#define DEFAULT_TOP             (15U)
+#define LINE_LENGTH             (1024U)
+#define NAME_LENGTH             (128U)
+
+/* Output sections of the PSoC 6 linker scripts reserving the newlib heap and
+ * the main stack. The heap takes the RAM left over by the other sections. */
+#define HEAP_SECTION            ".heap"
+#define STACK_SECTION           ".stack_dummy"
+
+/*******************************************************************************
+ * Types
+ ******************************************************************************/
+/* RAM taken by a variable or an object file */
+typedef struct
+{
+    char name[NAME_LENGTH];
+    unsigned long long size;
+} entry_t;
+
+/* Growable list of entries */
+typedef struct
+{
+    entry_t *entries;
+    size_t count;
+    size_t capacity;
+} entry_list_t;
+
+/* Result of reading the map */
+typedef struct
+{
+    bool has_ram_region;
+    unsigned long long ram_origin;
+    unsigned long long ram_length;
+    unsigned long long static_size;  /* RAM output sections without heap and stack */
+    unsigned long long heap_size;
+    unsigned long long stack_size;
+    unsigned long long fill_size;    /* Alignment padding within the static sections */
+    entry_list_t variables;
+    entry_list_t objects;
+} ram_map_t;
+
+/* Where the reader is in the map */
+typedef enum
+{
+    MAP_PREAMBLE,
+    MAP_MEMORY,
+    MAP_SECTIONS,
+} map_part_t;
+
+/*******************************************************************************
+ * Function Name: list_add
+ *******************************************************************************
+ * Summary:
+ *   Adds a size to the entry of a name, creating the entry if needed.
+ *
+ * Parameters:
+ *   list: list to update
+ *   name: name of the entry
+ *   size: bytes to add
+ *
+ * Return:
+ *   false if out of memory
+ ******************************************************************************/
+static bool list_add(entry_list_t *list, const char *name, unsigned long long size)
+{
+    for (size_t i = 0U; i < list->count; i++)
+    {
+        if (strcmp(list->entries[i].name, name) == 0)
+        {
+            list->entries[i].size += size;
+            return true;
+        }
+    }
+
+    if (list->count == list->capacity)
+    {
+        size_t capacity = (list->capacity == 0U) ? 256U : (list->capacity * 2U);
+        entry_t *entries = realloc(list->entries, capacity * sizeof(*entries));
+        if (entries == NULL)
+        {
+            return false;
+        }
+        list->entries = entries;
+        list->capacity = capacity;
+    }
+
+    entry_t *entry = &list->entries[list->count++];
+    (void)snprintf(entry->name, sizeof(entry->name), "%s", name);
+    entry->size = size;
+    return true;
+}
+
+/*******************************************************************************
+ * Function Name: entry_compare
+ *******************************************************************************
+ * Summary:
+ *   qsort comparison, largest entry first.
+ *
+ * Parameters:
+ *   a: first entry
+ *   b: second entry
+ *
+ * Return:
+ *   order of the entries
+ ******************************************************************************/
+static int entry_compare(const void *a, const void *b)
+{
+    const entry_t *first = a;
+    const entry_t *second = b;
+
+    if (first->size != second->size)
+    {
+        return (first->size < second->size) ? 1 : -1;
+    }
+    return strcmp(first->name, second->name);
+}
+
+/*******************************************************************************
+ * Function Name: is_ram_output_section
+ *******************************************************************************
+ * Summary:
+ *   Tells whether an output section occupies RAM: by its address when the map
+ *   has a RAM region, otherwise by its name.
+ *
+ * Parameters:
+ *   map: map read so far
+ *   name: output section name
+ *   address: output section address
+ *
+ * Return:
+ *   true for a RAM section
+ ******************************************************************************/
+static bool is_ram_output_section(const ram_map_t *map, const char *name, unsigned long long address)
+{
+    if (map->has_ram_region)
+    {
+        return (address >= map->ram_origin) && (address < (map->ram_origin + map->ram_length));
+    }
+
+    return (strcmp(name, ".data") == 0) || (strcmp(name, ".bss") == 0) || (strcmp(name, ".noinit") == 0);
+}
+
+/*******************************************************************************
+ * Function Name: variable_name
+ *******************************************************************************
+ * Summary:
+ *   Derives the variable name from an input section name, which is
+ *   .bss.<name> or .data.<name> with -fdata-sections. GCC appends .<n> to
+ *   function-local statics.
+ *
+ * Parameters:
+ *   section: input section name
+ *   name: destination, NAME_LENGTH bytes
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+static void variable_name(const char *section, char *name)
+{
+    static const char *const prefixes[] = { ".bss.", ".data.", ".noinit.", ".sbss.", ".sdata." };
+
+    for (size_t i = 0U; i < (sizeof(prefixes) / sizeof(prefixes[0])); i++)
+    {
+        size_t length = strlen(prefixes[i]);
+        if ((strncmp(section, prefixes[i], length) == 0) && (section[length] != '\0'))
+        {
+            section += length;
+            break;
+        }
+    }
+    (void)snprintf(name, NAME_LENGTH, "%s", section);
+}
+
+/*******************************************************************************
+ * Function Name: object_name
+ *******************************************************************************
+ * Summary:
+ *   Shortens an object path of the map to its file name, keeping the archive
+ *   member of library objects, libfoo.a(bar.o).
+ *
+ * Parameters:
+ *   path: object path
+ *   name: destination, NAME_LENGTH bytes
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+static void object_name(const char *path, char *name)
+{
+    const char *member = strchr(path, '(');
+    const char *end = (member != NULL) ? member : (path + strlen(path));
+    const char *start = path;
+
+    for (const char *c = path; c < end; c++)
+    {
+        if ((*c == '/') || (*c == '\\'))
+        {
+            start = c + 1;
+        }
+    }
+    (void)snprintf(name, NAME_LENGTH, "%s", start);
+}
+
+/*******************************************************************************
+ * Function Name: map_read
+ *******************************************************************************
+ * Summary:
+ *   Reads a GNU ld map. The memory configuration gives the RAM region; in the
+ *   memory map, output sections start in the first column and input sections
+ *   in the second. The linker moves the address and size of a long section
+ *   name to the next line.
+ *
+ * Parameters:
+ *   in: map stream
+ *   map: destination
+ *
+ * Return:
+ *   false if the map has no memory map or memory runs out
+ ******************************************************************************/
+static bool map_read(FILE *in, ram_map_t *map)
+{
+    char line[LINE_LENGTH];
+    char pending[NAME_LENGTH] = "";
+    bool pending_output = false;
+    bool in_ram = false;
+    bool in_reserve = false;
+    map_part_t part = MAP_PREAMBLE;
+
+    while (fgets(line, sizeof(line), in) != NULL)
+    {
+        line[strcspn(line, "\r\n")] = '\0';
+
+        if (strncmp(line, "Memory Configuration", 20U) == 0)
+        {
+            part = MAP_MEMORY;
+            continue;
+        }
+        if (strncmp(line, "Linker script and memory map", 28U) == 0)
+        {
+            part = MAP_SECTIONS;
+            continue;
+        }
+
+        if (part == MAP_MEMORY)
+        {
+            char name[NAME_LENGTH];
+            unsigned long long origin;
+            unsigned long long length;
+            if ((sscanf(line, "%127s 0x%llx 0x%llx", name, &origin, &length) == 3) && !map->has_ram_region)
+            {
+                for (char *c = name; *c != '\0'; c++)
+                {
+                    *c = (char)tolower((unsigned char)*c);
+                }
+                if (strstr(name, "ram") != NULL)
+                {
+                    map->has_ram_region = true;
+                    map->ram_origin = origin;
+                    map->ram_length = length;
+                }
+            }
+            continue;
+        }
+        if ((part != MAP_SECTIONS) || (line[0] == '\0'))
+        {
+            continue;
+        }
+
+        /* Section name, possibly with its address and size on the next line */
+        char name[NAME_LENGTH];
+        char object[LINE_LENGTH];
+        unsigned long long address;
+        unsigned long long size;
+        bool output;
+        int fields;
+
+        if (pending[0] != '\0')
+        {
+            object[0] = '\0';
+            fields = sscanf(line, " 0x%llx 0x%llx %1023[^\n]", &address, &size, object);
+            (void)snprintf(name, sizeof(name), "%s", pending);
+            output = pending_output;
+            pending[0] = '\0';
+            if (fields < 2)
+            {
+                continue;
+            }
+        }
+        else if ((line[0] == '.') || ((line[0] == ' ') && (line[1] != ' ') && (line[1] != '*')))
+        {
+            output = line[0] != ' ';
+            object[0] = '\0';
+            fields = sscanf(line, " %127s 0x%llx 0x%llx %1023[^\n]", name, &address, &size, object);
+            if (fields == 1)
+            {
+                (void)snprintf(pending, sizeof(pending), "%s", name);
+                pending_output = output;
+                continue;
+            }
+            if (fields < 3)
+            {
+                continue;
+            }
+        }
+        else if (strncmp(line, " *fill*", 7U) == 0)
+        {
+            if (in_ram && !in_reserve && (sscanf(line, " *fill* 0x%llx 0x%llx", &address, &size) == 2))
+            {
+                map->fill_size += size;
+            }
+            continue;
+        }
+        else
+        {
+            /* Symbol assignments and input section patterns */
+            continue;
+        }
+
+        if (output)
+        {
+            in_ram = is_ram_output_section(map, name, address);
+            in_reserve = false;
+            if (!in_ram)
+            {
+                continue;
+            }
+            if (strcmp(name, HEAP_SECTION) == 0)
+            {
+                map->heap_size += size;
+                in_reserve = true;
+            }
+            else if (strcmp(name, STACK_SECTION) == 0)
+            {
+                map->stack_size += size;
+                in_reserve = true;
+            }
+            else
+            {
+                map->static_size += size;
+            }
+        }
+        else if (in_ram && !in_reserve && (size > 0U))
+        {
+            char variable[NAME_LENGTH];
+            char file[NAME_LENGTH];
+            variable_name(name, variable);
+            object_name((object[0] != '\0') ? object : "?", file);
+            if (!list_add(&map->variables, variable, size) || !list_add(&map->objects, file, size))
+            {
+                return false;
+            }
+        }
+    }
+
+    return part == MAP_SECTIONS;
+}
+
+/*******************************************************************************
+ * Function Name: print_top
+ *******************************************************************************
+ * Summary:
+ *   Prints the largest entries of a list.
+ *
+ * Parameters:
+ *   title: heading of the list
+ *   list: entries, sorted in place
+ *   top: number of entries printed
+ *   total: bytes the shares refer to
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+static void print_top(const char *title, entry_list_t *list, size_t top, unsigned long long total)
+{
+    qsort(list->entries, list->count, sizeof(list->entries[0]), entry_compare);
+
+    printf("\n%s:\n", title);
+    for (size_t i = 0U; (i < top) && (i < list->count); i++)
+    {
+        printf("  %8llu  %5.1f%%  %s\n", list->entries[i].size,
+               (total > 0U) ? ((100.0 * (double)list->entries[i].size) / (double)total) : 0.0,
+               list->entries[i].name);
+    }
+}
+
+/*******************************************************************************
+ * Function Name: main
+ *******************************************************************************
+ * Summary:
+ *   Reads the map, prints the RAM use, and checks it against the budget.
+ *
+ * Parameters:
+ *   argc: number of arguments
+ *   argv: arguments
+ *
+ * Return:
+ *   0 within the budget, 1 over the budget or if the map cannot be read,
+ *   2 on usage errors
+ ******************************************************************************/
+int main(int argc, char *argv[])
+{
+    unsigned long long budget = 0U;
+    size_t top = DEFAULT_TOP;
+    const char *path = NULL;
+    bool usage_error = false;
+
+    for (int i = 1; i < argc; i++)
+    {
+        bool has_value = (i + 1) < argc;
+
+        if ((strcmp(argv[i], "-b") == 0) && has_value)
+        {
+            budget = strtoull(argv[++i], NULL, 0);
+            usage_error = usage_error || (budget == 0U);
+        }
+        else if ((strcmp(argv[i], "-n") == 0) && has_value)
+        {
+            top = (size_t)strtoul(argv[++i], NULL, 10);
+        }
+        else if ((path == NULL) && (argv[i][0] != '-'))
+        {
+            path = argv[i];
+        }
+        else
+        {
+            usage_error = true;
+        }
+    }
+    if (usage_error || (path == NULL))
+    {
+        fprintf(stderr, "usage: %s [-b bytes] [-n top] file.map\n", argv[0]);
+        return 2;
+    }
+
+    FILE *in = fopen(path, "r");
+    if (in == NULL)
+    {
+        perror(path);
+        return 2;
+    }
+
+    ram_map_t map = { .has_ram_region = false };
+    bool read_ok = map_read(in, &map);
+    (void)fclose(in);
+    if (!read_ok)
+    {
+        fprintf(stderr, "%s: not a GNU ld map, link with -Wl,-Map=<file>\n", path);
+        free(map.variables.entries);
+        free(map.objects.entries);
+        return 1;
+    }
+
+    if (budget == 0U)
+    {
+        budget = map.ram_length;
+    }
+    if (map.has_ram_region)
+    {
+        printf("RAM region:   0x%08llx, %llu bytes\n", map.ram_origin, map.ram_length);
+    }
+    else
+    {
+        printf("RAM region:   none in the map, counting .data, .bss, and .noinit\n");
+    }
+
+    unsigned long long used = map.static_size + map.stack_size;
+    printf("Static data:  %8llu bytes (%llu alignment padding)\n", map.static_size, map.fill_size);
+    printf("Main stack:   %8llu bytes\n", map.stack_size);
+    printf("Newlib heap:  %8llu bytes\n", map.heap_size);
+    print_top("Largest variables", &map.variables, top, map.static_size);
+    print_top("RAM per object file", &map.objects, top, map.static_size);
+
+    int status = 0;
+    if (budget > 0U)
+    {
+        printf("\nStatic data and main stack: %llu of %llu bytes (%.1f%%), %s\n", used, budget,
+               (100.0 * (double)used) / (double)budget, (used <= budget) ? "within the budget" : "OVER BUDGET");
+        status = (used <= budget) ? 0 : 1;
+    }
+
+    free(map.variables.entries);
+    free(map.objects.entries);
+    return status;
+}
+
+/* [] END OF FILE */
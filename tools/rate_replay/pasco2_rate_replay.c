@@ -0,0 +1,482 @@
+/*****************************************************************************
+** File name: pasco2_rate_replay.c
+**
+** Description: Host replay of the adaptive measurement rate controller.
+** Reads a recorded CO2 trace, lets the controller of the firmware choose when
+** to measure, and compares the measurements taken and the error of the
+** sample-and-hold reconstruction with fixed fast and slow periods.
+**
+** Build (Linux):
+**   cc -O2 -I../../source -I../host_sim/include -o pasco2_rate_replay \
+**      pasco2_rate_replay.c ../../source/pasco2_rate.c
+**
+** Usage:
+**   pasco2_rate_replay [-f fast] [-s slow] [-n sensor] [-e ppm] [-v] [file]
+**     -f  fast period in seconds, default PASCO2_RATE_PERIOD_FAST_S
+**     -s  slow period in seconds, default PASCO2_RATE_PERIOD_SLOW_S
+**     -n  sensor node of a telemetry trace, default 0
+**     -e  error counted as a miss in ppm, default 30, the sensor accuracy
+**     -v  print the decisions of the controller
+**   The trace is the CSV output of pasco2_telemetry_decoder, ideally recorded
+**   at the shortest period, or of pasco2_history_export.
+**
+**
+** ===========================================================================
+** Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+** ===========================================================================
+**
+** ===========================================================================
+** Infineon Technologies AG (INFINEON) is supplying this file for use
+** exclusively with Infineon's sensor products. This file can be freely
+** distributed within development tools and software supporting such
+** products.
+**
+** THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+** OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+** MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+** INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+** WHATSOEVER.
+** ===========================================================================
+*/
+
+/* Header file from system */
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Header file for the controller of the firmware */
+#include "pasco2_rate.h"
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+#define DEFAULT_SENSOR          (0U)
+#define DEFAULT_ERROR_PPM       (30U)
+
+/* Flags of a telemetry sample */
+#define SAMPLE_PPM_VALID        (1U << 0)
+#define SAMPLE_PRESSURE_VALID   (1U << 1)
+
+/*******************************************************************************
+ * Types
+ ******************************************************************************/
+/* Value of the recorded trace */
+typedef struct
+{
+    unsigned long long time_ms;
+    long pressure;              /* Pa */
+    unsigned int ppm;
+    bool pressure_valid;
+} trace_point_t;
+
+/* Recorded trace */
+typedef struct
+{
+    trace_point_t *points;
+    size_t count;
+    size_t capacity;
+} trace_t;
+
+/* Outcome of one replay */
+typedef struct
+{
+    unsigned long measurements;
+    unsigned long changes;      /* Period changes */
+    unsigned long misses;       /* Trace values off the held measurement by more than the limit */
+    unsigned int max_error;
+    double error_sum;
+} replay_result_t;
+
+/*******************************************************************************
+ * Function Name: pasco2_sim_assert_failed
+ *******************************************************************************
+ * Summary:
+ *   Target of CY_ASSERT in the host stand-in headers.
+ *
+ * Parameters:
+ *   file: source file of the failed check
+ *   line: line of the failed check
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+void pasco2_sim_assert_failed(const char *file, int line)
+{
+    fprintf(stderr, "assertion failed at %s:%d\n", file, line);
+    abort();
+}
+
+/*******************************************************************************
+ * Function Name: trace_append
+ *******************************************************************************
+ * Summary:
+ *   Appends a value to the trace. Values that do not advance the time are
+ *   dropped.
+ *
+ * Parameters:
+ *   trace: trace to extend
+ *   point: value to append
+ *
+ * Return:
+ *   false if out of memory
+ ******************************************************************************/
+static bool trace_append(trace_t *trace, const trace_point_t *point)
+{
+    if ((trace->count > 0U) && (point->time_ms <= trace->points[trace->count - 1U].time_ms))
+    {
+        return true;
+    }
+
+    if (trace->count == trace->capacity)
+    {
+        size_t capacity = (trace->capacity == 0U) ? 1024U : (trace->capacity * 2U);
+        trace_point_t *points = realloc(trace->points, capacity * sizeof(*points));
+        if (points == NULL)
+        {
+            return false;
+        }
+        trace->points = points;
+        trace->capacity = capacity;
+    }
+
+    trace->points[trace->count++] = *point;
+    return true;
+}
+
+/*******************************************************************************
+ * Function Name: trace_read
+ *******************************************************************************
+ * Summary:
+ *   Reads a trace in one of the two CSV formats, told apart by the header
+ *   line. The start-ups of a history export are joined into one time line.
+ *
+ * Parameters:
+ *   in: input stream
+ *   sensor: sensor node to take from a telemetry trace
+ *   trace: destination
+ *
+ * Return:
+ *   false if the format is unknown or memory runs out
+ ******************************************************************************/
+static bool trace_read(FILE *in, unsigned int sensor, trace_t *trace)
+{
+    char line[256];
+    bool history;
+
+    if (fgets(line, sizeof(line), in) == NULL)
+    {
+        return false;
+    }
+    if (strncmp(line, "sequence,sensor,tick_ms,ppm,pressure_hpa", 40U) == 0)
+    {
+        history = false;
+    }
+    else if (strncmp(line, "boot,time_s,ppm", 15U) == 0)
+    {
+        history = true;
+    }
+    else
+    {
+        return false;
+    }
+
+    unsigned int last_boot = 0U;
+    unsigned long long offset_ms = 0U;
+    while (fgets(line, sizeof(line), in) != NULL)
+    {
+        trace_point_t point = { .pressure_valid = false };
+
+        if (history)
+        {
+            unsigned int boot;
+            unsigned long time_s;
+            if (sscanf(line, "%u,%lu,%u", &boot, &time_s, &point.ppm) != 3)
+            {
+                continue;
+            }
+            if ((trace->count > 0U) && (boot != last_boot))
+            {
+                /* Continue the time line one history interval after the
+                 * last value of the previous start-up */
+                offset_ms = trace->points[trace->count - 1U].time_ms + (PASCO2_RATE_PERIOD_SLOW_S * 1000U);
+            }
+            last_boot = boot;
+            point.time_ms = offset_ms + ((unsigned long long)time_s * 1000U);
+        }
+        else
+        {
+            unsigned int sequence;
+            unsigned int node;
+            unsigned long tick;
+            unsigned int hpa;
+            unsigned int hpa_tenth;
+            double temperature;
+            unsigned int status;
+            unsigned int flags;
+            if ((sscanf(line, "%u,%u,%lu,%u,%u.%u,%lf,0x%x,0x%x", &sequence, &node, &tick, &point.ppm, &hpa,
+                        &hpa_tenth, &temperature, &status, &flags) != 9) ||
+                (node != sensor) || ((flags & SAMPLE_PPM_VALID) == 0U))
+            {
+                continue;
+            }
+            point.time_ms = tick;
+            point.pressure = ((long)hpa * 100L) + ((long)hpa_tenth * 10L);
+            point.pressure_valid = (flags & SAMPLE_PRESSURE_VALID) != 0U;
+        }
+
+        if (!trace_append(trace, &point))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/*******************************************************************************
+ * Function Name: trace_at
+ *******************************************************************************
+ * Summary:
+ *   Interpolates the trace linearly at a time.
+ *
+ * Parameters:
+ *   trace: trace with at least one value
+ *   time_ms: time within the trace
+ *   cursor: index of the value at or before the previous time, advanced
+ *   point: interpolated value
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+static void trace_at(const trace_t *trace, unsigned long long time_ms, size_t *cursor, trace_point_t *point)
+{
+    while (((*cursor + 1U) < trace->count) && (trace->points[*cursor + 1U].time_ms <= time_ms))
+    {
+        (*cursor)++;
+    }
+
+    const trace_point_t *before = &trace->points[*cursor];
+    *point = *before;
+    point->time_ms = time_ms;
+    if ((*cursor + 1U) < trace->count)
+    {
+        const trace_point_t *after = &trace->points[*cursor + 1U];
+        double weight = (double)(time_ms - before->time_ms) / (double)(after->time_ms - before->time_ms);
+        point->ppm = (unsigned int)(((double)before->ppm + (weight * ((double)after->ppm - (double)before->ppm))) + 0.5);
+        point->pressure = (long)((double)before->pressure + (weight * (double)(after->pressure - before->pressure)));
+    }
+}
+
+/*******************************************************************************
+ * Function Name: replay
+ *******************************************************************************
+ * Summary:
+ *   Measures the trace at the times chosen by the controller, or at a fixed
+ *   period, and compares every trace value with the last measurement taken.
+ *
+ * Parameters:
+ *   trace: recorded trace
+ *   config: controller configuration, NULL for a fixed period
+ *   fixed_period_s: period without controller
+ *   error_limit: error in ppm counted as a miss
+ *   verbose: print the decisions of the controller
+ *   result: outcome of the replay
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+static void replay(const trace_t *trace, const pasco2_rate_config_t *config, unsigned int fixed_period_s,
+                   unsigned int error_limit, bool verbose, replay_result_t *result)
+{
+    static const char *const reasons[] = { "none", "step", "trend", "stable" };
+    static pasco2_rate_t rate;
+    unsigned long long start_ms = trace->points[0].time_ms;
+    unsigned long long next_ms = start_ms;
+    unsigned int held = 0U;
+    size_t measure_cursor = 0U;
+
+    memset(result, 0, sizeof(*result));
+    if (config != NULL)
+    {
+        pasco2_rate_init(&rate, config);
+    }
+
+    for (size_t i = 0U; i < trace->count; i++)
+    {
+        const trace_point_t *reference = &trace->points[i];
+
+        /* Take the measurements due up to this trace value */
+        while (next_ms <= reference->time_ms)
+        {
+            trace_point_t value;
+            trace_at(trace, next_ms, &measure_cursor, &value);
+            held = value.ppm;
+            result->measurements++;
+
+            unsigned int period_s = fixed_period_s;
+            if (config != NULL)
+            {
+                if (pasco2_rate_update(&rate, (uint32_t)(next_ms - start_ms), (uint16_t)value.ppm,
+                                       (int32_t)value.pressure, value.pressure_valid))
+                {
+                    result->changes++;
+                    if (verbose)
+                    {
+                        printf("%10.1f s  %4u ppm  period %4u s  %-6s  trend %4ld ppm/min  step %4ld ppm\n",
+                               (double)(next_ms - start_ms) / 1000.0, value.ppm, (unsigned int)rate.period_s,
+                               reasons[rate.reason], (long)rate.slope_ppm_min, (long)rate.deviation_ppm);
+                    }
+                }
+                period_s = rate.period_s;
+            }
+            next_ms += (unsigned long long)period_s * 1000U;
+        }
+
+        unsigned int error = (reference->ppm > held) ? (reference->ppm - held) : (held - reference->ppm);
+        result->error_sum += (double)error;
+        if (error > result->max_error)
+        {
+            result->max_error = error;
+        }
+        if (error > error_limit)
+        {
+            result->misses++;
+        }
+    }
+}
+
+/*******************************************************************************
+ * Function Name: print_result
+ *******************************************************************************
+ * Summary:
+ *   Prints the outcome of a replay.
+ *
+ * Parameters:
+ *   name: name of the strategy
+ *   trace: recorded trace
+ *   error_limit: error in ppm counted as a miss
+ *   result: outcome of the replay
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+static void print_result(const char *name, const trace_t *trace, unsigned int error_limit,
+                         const replay_result_t *result)
+{
+    double hours = (double)(trace->points[trace->count - 1U].time_ms - trace->points[0].time_ms) / 3600000.0;
+
+    printf("%-14s measurements %7lu (%6.1f/h), period changes %5lu, error mean %5.1f ppm, max %4u ppm, "
+           "over %u ppm %5.2f%%\n",
+           name, result->measurements, (hours > 0.0) ? ((double)result->measurements / hours) : 0.0,
+           result->changes, result->error_sum / (double)trace->count, result->max_error, error_limit,
+           (100.0 * (double)result->misses) / (double)trace->count);
+}
+
+/*******************************************************************************
+ * Function Name: main
+ *******************************************************************************
+ * Summary:
+ *   Reads the trace and replays it with the controller and with the fixed
+ *   fast and slow periods.
+ *
+ * Parameters:
+ *   argc: number of arguments
+ *   argv: arguments
+ *
+ * Return:
+ *   0 on success, 1 if the trace cannot be read, 2 on usage errors
+ ******************************************************************************/
+int main(int argc, char *argv[])
+{
+    pasco2_rate_config_t config;
+    unsigned int sensor = DEFAULT_SENSOR;
+    unsigned int error_limit = DEFAULT_ERROR_PPM;
+    bool verbose = false;
+    const char *path = NULL;
+
+    pasco2_rate_default_config(&config);
+    for (int i = 1; i < argc; i++)
+    {
+        bool has_value = (i + 1) < argc;
+
+        if ((strcmp(argv[i], "-f") == 0) && has_value)
+        {
+            config.period_fast_s = (uint16_t)strtoul(argv[++i], NULL, 10);
+        }
+        else if ((strcmp(argv[i], "-s") == 0) && has_value)
+        {
+            config.period_slow_s = (uint16_t)strtoul(argv[++i], NULL, 10);
+        }
+        else if ((strcmp(argv[i], "-n") == 0) && has_value)
+        {
+            sensor = (unsigned int)strtoul(argv[++i], NULL, 10);
+        }
+        else if ((strcmp(argv[i], "-e") == 0) && has_value)
+        {
+            error_limit = (unsigned int)strtoul(argv[++i], NULL, 10);
+        }
+        else if (strcmp(argv[i], "-v") == 0)
+        {
+            verbose = true;
+        }
+        else if ((path == NULL) && (argv[i][0] != '-'))
+        {
+            path = argv[i];
+        }
+        else
+        {
+            path = NULL;
+            config.period_fast_s = 0U;
+            break;
+        }
+    }
+    if ((config.period_fast_s == 0U) || (config.period_fast_s > config.period_slow_s))
+    {
+        fprintf(stderr, "usage: %s [-f fast] [-s slow] [-n sensor] [-e ppm] [-v] [file]\n", argv[0]);
+        return 2;
+    }
+
+    FILE *in = (path != NULL) ? fopen(path, "r") : stdin;
+    if (in == NULL)
+    {
+        perror(path);
+        return 2;
+    }
+
+    trace_t trace = { .points = NULL };
+    bool read_ok = trace_read(in, sensor, &trace);
+    if (in != stdin)
+    {
+        (void)fclose(in);
+    }
+    if (!read_ok || (trace.count < 2U))
+    {
+        fprintf(stderr, "no trace: expected the CSV output of pasco2_telemetry_decoder or pasco2_history_export\n");
+        free(trace.points);
+        return 1;
+    }
+
+    unsigned long long span_ms = trace.points[trace.count - 1U].time_ms - trace.points[0].time_ms;
+    printf("trace: %lu values over %.1f h, mean interval %.1f s\n", (unsigned long)trace.count,
+           (double)span_ms / 3600000.0, ((double)span_ms / 1000.0) / (double)(trace.count - 1U));
+
+    replay_result_t result;
+    replay(&trace, &config, 0U, error_limit, verbose, &result);
+    print_result("adaptive", &trace, error_limit, &result);
+
+    char name[32];
+    (void)snprintf(name, sizeof(name), "fixed %u s", (unsigned int)config.period_fast_s);
+    replay(&trace, NULL, config.period_fast_s, error_limit, false, &result);
+    print_result(name, &trace, error_limit, &result);
+
+    (void)snprintf(name, sizeof(name), "fixed %u s", (unsigned int)config.period_slow_s);
+    replay(&trace, NULL, config.period_slow_s, error_limit, false, &result);
+    print_result(name, &trace, error_limit, &result);
+
+    free(trace.points);
+    return 0;
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,365 @@
+/*****************************************************************************
+** File name: pasco2_sample_ring_stress.c
+**
+** Description: Host stress test of the sample ring. A producer thread and a
+** consumer thread move numbered records through the ring of the firmware;
+** the consumer stalls now and then so that the ring fills up. The test
+** checks that every accepted record arrives once, in order, and unchanged,
+** and that the overflow, pushed, and high-water counters match.
+**
+** Build (Linux):
+**   cc -O2 -pthread -I../../source -I../host_sim/include \
+**      -o pasco2_sample_ring_stress pasco2_sample_ring_stress.c \
+**      ../../source/pasco2_sample_ring.c
+**
+** ===========================================================================
+** Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+** ===========================================================================
+**
+** ===========================================================================
+** Infineon Technologies AG (INFINEON) is supplying this file for use
+** exclusively with Infineon's sensor products. This file can be freely
+** distributed within development tools and software supporting such
+** products.
+**
+** THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+** OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+** MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+** INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+** WHATSOEVER.
+** ===========================================================================
+*/
+
+/* Header file from system */
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/* Header file for the sample ring of the firmware */
+#include "pasco2_sample_ring.h"
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+#define DEFAULT_RECORDS         (10000000U)
+
+/* The consumer stalls after this many records by default */
+#define DEFAULT_STALL_EVERY     (100000U)
+#define STALL_NS                (20000L)
+
+/*******************************************************************************
+ * Types
+ ******************************************************************************/
+/* Results of one thread, read by main after the join */
+typedef struct
+{
+    uint32_t records;           /* Records pushed or popped */
+    uint32_t failures;          /* Failed pushes or empty pops */
+    uint32_t max_count;         /* Largest ring count seen by the thread */
+} thread_result_t;
+
+/*******************************************************************************
+ * Global Variables
+ ******************************************************************************/
+static pasco2_sample_ring_t ring;
+static uint32_t record_count = DEFAULT_RECORDS;
+static uint32_t stall_every = DEFAULT_STALL_EVERY;
+
+/* One byte per sequence number: set by the producer when the ring accepted
+ * the record, and by the consumer when the record arrived */
+static uint8_t *accepted;
+static uint8_t *received;
+
+static volatile bool producer_done;
+
+static uint32_t out_of_order;
+static uint32_t corrupted;
+
+/*******************************************************************************
+ * Function Name: pasco2_sim_assert_failed
+ *******************************************************************************
+ * Summary:
+ *   Target of CY_ASSERT in the host stand-in headers.
+ *
+ * Parameters:
+ *   file: source file of the failed check
+ *   line: line of the failed check
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+void pasco2_sim_assert_failed(const char *file, int line)
+{
+    fprintf(stderr, "assertion failed at %s:%d\n", file, line);
+    abort();
+}
+
+/*******************************************************************************
+ * Function Name: make_sample
+ *******************************************************************************
+ * Summary:
+ *   Fills a record whose fields are all derived from its sequence number, so
+ *   that the consumer can detect a torn or stale record.
+ *
+ * Parameters:
+ *   sequence: sequence number
+ *   sample: record to fill
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+static void make_sample(uint32_t sequence, pasco2_sample_t *sample)
+{
+    sample->tick = sequence;
+    sample->pressure = (int32_t)~sequence;
+    sample->temperature = (int16_t)(sequence * 7U);
+    sample->ppm = (uint16_t)(sequence >> 3);
+    sample->status = (uint8_t)(sequence >> 11);
+    sample->flags = (uint8_t)(sequence >> 19);
+    sample->sensor = (uint8_t)(sequence >> 24);
+}
+
+/*******************************************************************************
+ * Function Name: elapsed_ns
+ *******************************************************************************
+ * Summary:
+ *   Returns the time between two clock readings.
+ *
+ * Parameters:
+ *   start: first reading
+ *   end: second reading
+ *
+ * Return:
+ *   nanoseconds
+ ******************************************************************************/
+static double elapsed_ns(const struct timespec *start, const struct timespec *end)
+{
+    return ((double)(end->tv_sec - start->tv_sec) * 1e9) + (double)(end->tv_nsec - start->tv_nsec);
+}
+
+/*******************************************************************************
+ * Function Name: producer
+ *******************************************************************************
+ * Summary:
+ *   Pushes the records in sequence and notes which ones the ring accepted.
+ *   After an overflow it waits until the consumer has made room.
+ *
+ * Parameters:
+ *   arg: thread_result_t of the producer
+ *
+ * Return:
+ *   NULL
+ ******************************************************************************/
+static void *producer(void *arg)
+{
+    thread_result_t *result = arg;
+    pasco2_sample_t sample;
+
+    for (uint32_t sequence = 0U; sequence < record_count; sequence++)
+    {
+        make_sample(sequence, &sample);
+        if (pasco2_sample_ring_push(&ring, &sample))
+        {
+            accepted[sequence] = 1U;
+            result->records++;
+        }
+        else
+        {
+            /* Drop the record like the sensor task does, then wait for room
+             * so that the run is not only overflows */
+            result->failures++;
+            while (pasco2_sample_ring_count(&ring) >= PASCO2_SAMPLE_RING_CAPACITY)
+            {
+                (void)sched_yield();
+            }
+        }
+
+        uint32_t count = pasco2_sample_ring_count(&ring);
+        result->max_count = (count > result->max_count) ? count : result->max_count;
+    }
+
+    /* The last record must be visible before the consumer sees the flag */
+    __DMB();
+    producer_done = true;
+    return NULL;
+}
+
+/*******************************************************************************
+ * Function Name: consumer
+ *******************************************************************************
+ * Summary:
+ *   Pops records until the producer has finished and the ring is empty, and
+ *   checks their order and contents. Stalls every stall_every records.
+ *
+ * Parameters:
+ *   arg: thread_result_t of the consumer
+ *
+ * Return:
+ *   NULL
+ ******************************************************************************/
+static void *consumer(void *arg)
+{
+    thread_result_t *result = arg;
+    pasco2_sample_t sample;
+    pasco2_sample_t expected;
+    uint32_t next = 0U;
+
+    for (;;)
+    {
+        /* Read the flag before the ring, so that no record pushed before it
+         * was set is missed */
+        bool done = producer_done;
+        __DMB();
+
+        uint32_t count = pasco2_sample_ring_count(&ring);
+        result->max_count = (count > result->max_count) ? count : result->max_count;
+
+        if (!pasco2_sample_ring_pop(&ring, &sample))
+        {
+            if (done)
+            {
+                break;
+            }
+            result->failures++;
+            (void)sched_yield();
+            continue;
+        }
+
+        /* Sequence numbers only increase; the gaps are the dropped records */
+        if ((sample.tick < next) || (sample.tick >= record_count))
+        {
+            out_of_order++;
+        }
+        else
+        {
+            received[sample.tick] = 1U;
+            next = sample.tick + 1U;
+        }
+
+        make_sample(sample.tick, &expected);
+        if (memcmp(&sample, &expected, sizeof(sample)) != 0)
+        {
+            corrupted++;
+        }
+
+        result->records++;
+        if ((stall_every != 0U) && ((result->records % stall_every) == 0U))
+        {
+            const struct timespec stall = { 0, STALL_NS };
+            (void)nanosleep(&stall, NULL);
+        }
+    }
+
+    return NULL;
+}
+
+/*******************************************************************************
+ * Function Name: main
+ *******************************************************************************
+ * Summary:
+ *   Runs the stress test. Options: -n number of records, -s records between
+ *   two stalls of the consumer, 0 for none.
+ *
+ * Parameters:
+ *   argc: number of arguments
+ *   argv: arguments
+ *
+ * Return:
+ *   0 if all checks passed
+ ******************************************************************************/
+int main(int argc, char *argv[])
+{
+    for (int i = 1; i < argc; i++)
+    {
+        if ((strcmp(argv[i], "-n") == 0) && ((i + 1) < argc))
+        {
+            record_count = (uint32_t)strtoul(argv[++i], NULL, 10);
+        }
+        else if ((strcmp(argv[i], "-s") == 0) && ((i + 1) < argc))
+        {
+            stall_every = (uint32_t)strtoul(argv[++i], NULL, 10);
+        }
+        else
+        {
+            fprintf(stderr, "usage: %s [-n records] [-s stall_every]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    accepted = calloc(record_count, 1U);
+    received = calloc(record_count, 1U);
+    if ((record_count == 0U) || (accepted == NULL) || (received == NULL))
+    {
+        fprintf(stderr, "cannot allocate %lu records\n", (unsigned long)record_count);
+        return 2;
+    }
+
+    thread_result_t produced = { 0U };
+    thread_result_t consumed = { 0U };
+    pthread_t producer_thread;
+    pthread_t consumer_thread;
+    struct timespec start;
+    struct timespec end;
+
+    pasco2_sample_ring_init(&ring);
+    (void)clock_gettime(CLOCK_MONOTONIC, &start);
+    if ((pthread_create(&consumer_thread, NULL, consumer, &consumed) != 0) ||
+        (pthread_create(&producer_thread, NULL, producer, &produced) != 0))
+    {
+        fprintf(stderr, "cannot start the threads\n");
+        return 2;
+    }
+    (void)pthread_join(producer_thread, NULL);
+    (void)pthread_join(consumer_thread, NULL);
+    (void)clock_gettime(CLOCK_MONOTONIC, &end);
+
+    /* Every accepted record must have arrived, and no other */
+    uint32_t lost = 0U;
+    uint32_t unexpected = 0U;
+    for (uint32_t i = 0U; i < record_count; i++)
+    {
+        lost += (accepted[i] && !received[i]) ? 1U : 0U;
+        unexpected += (!accepted[i] && received[i]) ? 1U : 0U;
+    }
+    free(accepted);
+    free(received);
+
+    pasco2_sample_ring_stats_t stats;
+    pasco2_sample_ring_get_stats(&ring, &stats);
+
+    uint32_t failures = 0U;
+    failures += (lost != 0U) ? 1U : 0U;
+    failures += (unexpected != 0U) ? 1U : 0U;
+    failures += (out_of_order != 0U) ? 1U : 0U;
+    failures += (corrupted != 0U) ? 1U : 0U;
+    failures += ((stats.pushed + stats.overflows) != record_count) ? 1U : 0U;
+    failures += (stats.pushed != produced.records) ? 1U : 0U;
+    failures += (stats.overflows != produced.failures) ? 1U : 0U;
+    failures += (consumed.records != stats.pushed) ? 1U : 0U;
+    failures += (stats.high_water > PASCO2_SAMPLE_RING_CAPACITY) ? 1U : 0U;
+    failures += ((stats.overflows != 0U) && (stats.high_water != PASCO2_SAMPLE_RING_CAPACITY)) ? 1U : 0U;
+    failures += (produced.max_count > stats.high_water) ? 1U : 0U;
+    failures += (consumed.max_count > PASCO2_SAMPLE_RING_CAPACITY) ? 1U : 0U;
+    failures += (pasco2_sample_ring_count(&ring) != 0U) ? 1U : 0U;
+
+    printf("records %lu, ring capacity %u, consumer stall %ld ns every %lu records\n",
+           (unsigned long)record_count, PASCO2_SAMPLE_RING_CAPACITY, STALL_NS, (unsigned long)stall_every);
+    printf("producer: %lu pushed, %lu overflows, largest count %lu\n", (unsigned long)produced.records,
+           (unsigned long)produced.failures, (unsigned long)produced.max_count);
+    printf("consumer: %lu popped, %lu empty polls, largest count %lu\n", (unsigned long)consumed.records,
+           (unsigned long)consumed.failures, (unsigned long)consumed.max_count);
+    printf("ring: %lu pushed, %lu overflows, high water %lu\n", (unsigned long)stats.pushed,
+           (unsigned long)stats.overflows, (unsigned long)stats.high_water);
+    printf("order: %lu lost, %lu unexpected, %lu out of order, %lu corrupted\n", (unsigned long)lost,
+           (unsigned long)unexpected, (unsigned long)out_of_order, (unsigned long)corrupted);
+    printf("throughput %.1f ns per record\n", elapsed_ns(&start, &end) / record_count);
+    printf("check %s, %lu mismatches\n", (failures == 0U) ? "passed" : "FAILED", (unsigned long)failures);
+
+    return (failures == 0U) ? 0 : 1;
+}
+
+/* [] END OF FILE */
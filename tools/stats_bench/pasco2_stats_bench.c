@@ -0,0 +1,333 @@
+/*****************************************************************************
+** File name: pasco2_stats_bench.c
+**
+** Description: Host benchmark of the windowed CO2 statistics. Feeds a
+** synthetic CO2 series into the statistics of the firmware, reports the
+** update and query cost and the RAM footprint, and checks the windows
+** against a brute-force recomputation.
+**
+** Build (Linux):
+**   cc -O2 -I../../source -I../host_sim/include -o pasco2_stats_bench \
+**      pasco2_stats_bench.c ../../source/pasco2_stats.c
+**
+** ===========================================================================
+** Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+** ===========================================================================
+**
+** ===========================================================================
+** Infineon Technologies AG (INFINEON) is supplying this file for use
+** exclusively with Infineon's sensor products. This file can be freely
+** distributed within development tools and software supporting such
+** products.
+**
+** THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+** OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+** MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+** INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+** WHATSOEVER.
+** ===========================================================================
+*/
+
+/* Header file from system */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/* Header file for the statistics of the firmware */
+#include "pasco2_stats.h"
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+#define DEFAULT_DAYS            (30U)
+#define DEFAULT_PERIOD_MS       (5000U)
+
+/* Number of queries compared with the brute-force recomputation */
+#define CHECK_POINTS            (500U)
+
+/*******************************************************************************
+ * Global Variables
+ ******************************************************************************/
+#define WINDOW_LENGTH(id, name, length_s, count) (length_s),
+static const uint32_t window_lengths[PASCO2_STATS_WINDOW_COUNT] =
+{
+    PASCO2_STATS_WINDOWS(WINDOW_LENGTH)
+};
+#undef WINDOW_LENGTH
+
+#define WINDOW_SLOTS(id, name, length_s, count) (count),
+static const uint32_t window_slots[PASCO2_STATS_WINDOW_COUNT] =
+{
+    PASCO2_STATS_WINDOWS(WINDOW_SLOTS)
+};
+#undef WINDOW_SLOTS
+
+static pasco2_stats_t stats;
+
+/*******************************************************************************
+ * Function Name: pasco2_sim_assert_failed
+ *******************************************************************************
+ * Summary:
+ *   Target of CY_ASSERT in the host stand-in headers.
+ *
+ * Parameters:
+ *   file: source file of the failed check
+ *   line: line of the failed check
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+void pasco2_sim_assert_failed(const char *file, int line)
+{
+    fprintf(stderr, "assertion failed at %s:%d\n", file, line);
+    abort();
+}
+
+/*******************************************************************************
+ * Function Name: synthetic_ppm
+ *******************************************************************************
+ * Summary:
+ *   Returns a CO2 value of an office: outdoor level at night, a ramp during
+ *   the working hours, measurement noise and occasional spikes.
+ *
+ * Parameters:
+ *   tick: time in ms
+ *   random: state of the noise generator
+ *
+ * Return:
+ *   CO2 value in ppm
+ ******************************************************************************/
+static uint16_t synthetic_ppm(uint32_t tick, uint32_t *random)
+{
+    uint32_t second_of_day = (tick / 1000U) % 86400U;
+    int32_t ppm = 420;
+
+    if ((second_of_day >= (8U * 3600U)) && (second_of_day < (18U * 3600U)))
+    {
+        ppm += (int32_t)((second_of_day - (8U * 3600U)) / 30U);
+    }
+
+    *random = (*random * 1664525U) + 1013904223U;
+    ppm += (int32_t)((*random >> 24) % 41U) - 20;
+    if (((*random >> 8) & 0xFFFU) == 0U)
+    {
+        ppm += 3000;
+    }
+    return (uint16_t)ppm;
+}
+
+/*******************************************************************************
+ * Function Name: elapsed_ns
+ *******************************************************************************
+ * Summary:
+ *   Returns the time between two clock readings.
+ *
+ * Parameters:
+ *   start: first reading
+ *   end: second reading
+ *
+ * Return:
+ *   nanoseconds
+ ******************************************************************************/
+static double elapsed_ns(const struct timespec *start, const struct timespec *end)
+{
+    return ((double)(end->tv_sec - start->tv_sec) * 1e9) + (double)(end->tv_nsec - start->tv_nsec);
+}
+
+/*******************************************************************************
+ * Function Name: compare_ppm
+ *******************************************************************************
+ * Summary:
+ *   Sort order of CO2 values.
+ *
+ * Parameters:
+ *   a: first value
+ *   b: second value
+ *
+ * Return:
+ *   negative, zero, or positive like strcmp
+ ******************************************************************************/
+static int compare_ppm(const void *a, const void *b)
+{
+    return (int)*(const uint16_t *)a - (int)*(const uint16_t *)b;
+}
+
+/*******************************************************************************
+ * Function Name: check_window
+ *******************************************************************************
+ * Summary:
+ *   Recomputes a window from the raw values and compares it with the query.
+ *
+ * Parameters:
+ *   window: window to check
+ *   values: all values fed so far
+ *   count: number of values fed so far
+ *   period_ms: time between two values
+ *   max_error: largest percentile error in ppm seen so far, updated
+ *
+ * Return:
+ *   true if count, minimum, maximum, and mean match
+ ******************************************************************************/
+static bool check_window(pasco2_stats_window_id_t window, const uint16_t *values, uint32_t count,
+                         uint32_t period_ms, uint32_t *max_error)
+{
+    pasco2_stats_summary_t summary;
+    if (!pasco2_stats_query(&stats, window, (count - 1U) * period_ms, &summary))
+    {
+        return false;
+    }
+
+    /* The window holds the values of its last slots, the first value starts
+     * the first slot */
+    uint32_t slot_ms = (window_lengths[window] * 1000U) / window_slots[window];
+    uint32_t last_slot = ((count - 1U) * period_ms) / slot_ms;
+    uint32_t first = count;
+    while ((first > 0U) && ((((first - 1U) * period_ms) / slot_ms) + window_slots[window] > last_slot))
+    {
+        first--;
+    }
+
+    uint32_t n = count - first;
+    uint64_t sum = 0U;
+    uint16_t min = UINT16_MAX;
+    uint16_t max = 0U;
+    uint16_t *sorted = malloc(n * sizeof(*sorted));
+    for (uint32_t i = first; i < count; i++)
+    {
+        sum += values[i];
+        min = (values[i] < min) ? values[i] : min;
+        max = (values[i] > max) ? values[i] : max;
+        sorted[i - first] = values[i];
+    }
+
+    /* Exact percentiles for comparison with the sketch */
+    qsort(sorted, n, sizeof(*sorted), compare_ppm);
+    const uint16_t exact[] = { sorted[((n * 50U) + 99U) / 100U - 1U], sorted[((n * 95U) + 99U) / 100U - 1U] };
+    const uint16_t sketch[] = { summary.p50, summary.p95 };
+    for (uint32_t i = 0U; i < 2U; i++)
+    {
+        uint32_t error = (uint32_t)abs((int)exact[i] - (int)sketch[i]);
+        *max_error = (error > *max_error) ? error : *max_error;
+    }
+    free(sorted);
+
+    return (summary.count == n) && (summary.min == min) && (summary.max == max) &&
+           (summary.mean_x10 == (uint32_t)(((sum * 10U) + (n / 2U)) / n));
+}
+
+/*******************************************************************************
+ * Function Name: main
+ *******************************************************************************
+ * Summary:
+ *   Runs the benchmark. Options: -d days of data, -p measurement period in
+ *   seconds.
+ *
+ * Parameters:
+ *   argc: number of arguments
+ *   argv: arguments
+ *
+ * Return:
+ *   0 if all checks passed
+ ******************************************************************************/
+int main(int argc, char *argv[])
+{
+    uint32_t days = DEFAULT_DAYS;
+    uint32_t period_ms = DEFAULT_PERIOD_MS;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if ((strcmp(argv[i], "-d") == 0) && ((i + 1) < argc))
+        {
+            days = (uint32_t)strtoul(argv[++i], NULL, 10);
+        }
+        else if ((strcmp(argv[i], "-p") == 0) && ((i + 1) < argc))
+        {
+            period_ms = (uint32_t)strtoul(argv[++i], NULL, 10) * 1000U;
+        }
+        else
+        {
+            fprintf(stderr, "usage: %s [-d days] [-p period_s]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    uint32_t count = (uint32_t)(((uint64_t)days * 86400000U) / period_ms);
+    if ((count == 0U) || (period_ms == 0U) || (((uint64_t)count * period_ms) > UINT32_MAX))
+    {
+        fprintf(stderr, "the series must hold at least one value and end within 49 days\n");
+        return 2;
+    }
+
+    uint16_t *values = malloc(count * sizeof(*values));
+    uint32_t random = 1U;
+    for (uint32_t i = 0U; i < count; i++)
+    {
+        values[i] = synthetic_ppm(i * period_ms, &random);
+    }
+
+    /* Update cost */
+    struct timespec start;
+    struct timespec end;
+    pasco2_stats_init(&stats);
+    (void)clock_gettime(CLOCK_MONOTONIC, &start);
+    for (uint32_t i = 0U; i < count; i++)
+    {
+        pasco2_stats_add(&stats, i * period_ms, values[i]);
+    }
+    (void)clock_gettime(CLOCK_MONOTONIC, &end);
+    double add_ns = elapsed_ns(&start, &end) / count;
+
+    /* Query cost of every window */
+    pasco2_stats_summary_t summary;
+    double query_ns[PASCO2_STATS_WINDOW_COUNT];
+    for (uint32_t w = 0U; w < PASCO2_STATS_WINDOW_COUNT; w++)
+    {
+        const uint32_t queries = 100000U;
+        (void)clock_gettime(CLOCK_MONOTONIC, &start);
+        for (uint32_t i = 0U; i < queries; i++)
+        {
+            (void)pasco2_stats_query(&stats, (pasco2_stats_window_id_t)w, i, &summary);
+        }
+        (void)clock_gettime(CLOCK_MONOTONIC, &end);
+        query_ns[w] = elapsed_ns(&start, &end) / queries;
+    }
+
+    /* Compare with the recomputation at evenly spread points */
+    uint32_t mismatches = 0U;
+    uint32_t max_error[PASCO2_STATS_WINDOW_COUNT] = { 0U };
+    uint32_t step = (count > CHECK_POINTS) ? (count / CHECK_POINTS) : 1U;
+    pasco2_stats_init(&stats);
+    for (uint32_t i = 0U; i < count; i++)
+    {
+        pasco2_stats_add(&stats, i * period_ms, values[i]);
+        if (((i % step) == (step - 1U)) || (i == (count - 1U)))
+        {
+            for (uint32_t w = 0U; w < PASCO2_STATS_WINDOW_COUNT; w++)
+            {
+                if (!check_window((pasco2_stats_window_id_t)w, values, i + 1U, period_ms, &max_error[w]))
+                {
+                    mismatches++;
+                }
+            }
+        }
+    }
+    free(values);
+
+    printf("values %lu, period %lu ms\n", (unsigned long)count, (unsigned long)period_ms);
+    printf("update %.1f ns per value\n", add_ns);
+    for (uint32_t w = 0U; w < PASCO2_STATS_WINDOW_COUNT; w++)
+    {
+        printf("window %-5s: %2lu slots of %6lu s, query %.1f ns, largest percentile error %lu ppm\n",
+               pasco2_stats_window_name((pasco2_stats_window_id_t)w), (unsigned long)window_slots[w],
+               (unsigned long)(window_lengths[w] / window_slots[w]), query_ns[w], (unsigned long)max_error[w]);
+    }
+    printf("RAM %lu bytes per sensor node, %lu bytes per slot\n",
+           (unsigned long)sizeof(pasco2_stats_t), (unsigned long)sizeof(pasco2_stats_slot_t));
+    printf("check %s, %lu mismatches\n", (mismatches == 0U) ? "passed" : "FAILED", (unsigned long)mismatches);
+
+    return (mismatches == 0U) ? 0 : 1;
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,204 @@
+/*****************************************************************************
+** File name: pasco2_telemetry_decoder.c
+**
+** Description: Host command line decoder for the binary telemetry stream of
+** the PAS CO2 application. Reads a captured stream from a file, a serial
+** device or stdin, prints one CSV line per sample and reports the decoder
+** counters and throughput.
+**
+** Build (Linux):
+**   cc -O2 -I../../source -o pasco2_telemetry_decoder \
+**      pasco2_telemetry_decoder.c ../../source/pasco2_telemetry.c
+**
+** Usage:
+**   pasco2_telemetry_decoder [-q] [file|device]
+**     -q  do not print samples, only the summary
+**
+** ===========================================================================
+** Copyright (C) 2021 Infineon Technologies AG. All rights reserved.
+** ===========================================================================
+**
+** ===========================================================================
+** Infineon Technologies AG (INFINEON) is supplying this file for use
+** exclusively with Infineon's sensor products. This file can be freely
+** distributed within development tools and software supporting such
+** products.
+**
+** THIS SOFTWARE IS PROVIDED "AS IS".  NO WARRANTIES, WHETHER EXPRESS, IMPLIED
+** OR STATUTORY, INCLUDING, BUT NOT LIMITED TO, IMPLIED WARRANTIES OF
+** MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE APPLY TO THIS SOFTWARE.
+** INFINEON SHALL NOT, IN ANY CIRCUMSTANCES, BE LIABLE FOR DIRECT, INDIRECT,
+** INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES, FOR ANY REASON
+** WHATSOEVER.
+** ===========================================================================
+*/
+
+/* Header file from system */
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+/* Header file for the shared frame format */
+#include "pasco2_telemetry.h"
+
+/*******************************************************************************
+ * Macros
+ ******************************************************************************/
+#define READ_CHUNK_SIZE (64U * 1024U)
+
+/*******************************************************************************
+ * Global Variables
+ ******************************************************************************/
+#define LOG_FORMAT(id, format) format,
+static const char *const log_formats[PASCO2_LOG_MESSAGE_COUNT] =
+{
+    PASCO2_LOG_MESSAGES(LOG_FORMAT)
+};
+#undef LOG_FORMAT
+
+/*******************************************************************************
+ * Function Name: print_sample
+ *******************************************************************************
+ * Summary:
+ *   Decoder callback, prints a sample as CSV line.
+ *
+ * Parameters:
+ *   callback_arg: output stream, NULL to suppress the output
+ *   sample: decoded sample
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+static void print_sample(void *callback_arg, const pasco2_telemetry_sample_t *sample)
+{
+    FILE *out = (FILE *)callback_arg;
+
+    if (out != NULL)
+    {
+        fprintf(out, "%u,%u,%lu,%u,%u.%u,%.2f,0x%02x,0x%02x\n",
+                (unsigned int)sample->sequence, (unsigned int)sample->sensor, (unsigned long)sample->tick,
+                (unsigned int)sample->ppm,
+                (unsigned int)(sample->pressure / 10U), (unsigned int)(sample->pressure % 10U),
+                (double)sample->temperature / 100.0,
+                (unsigned int)sample->status, (unsigned int)sample->flags);
+    }
+}
+
+/*******************************************************************************
+ * Function Name: print_log
+ *******************************************************************************
+ * Summary:
+ *   Decoder callback, formats a log record with the message table of the
+ *   firmware and prints it to stderr, keeping the CSV output clean.
+ *
+ * Parameters:
+ *   callback_arg: output stream of the samples, NULL to suppress the output
+ *   record: decoded log record
+ *
+ * Return:
+ *   none
+ ******************************************************************************/
+static void print_log(void *callback_arg, const pasco2_log_record_t *record)
+{
+    if (callback_arg == NULL)
+    {
+        return;
+    }
+
+    fprintf(stderr, "[%lu] ", (unsigned long)record->tick);
+    if (record->id < PASCO2_LOG_MESSAGE_COUNT)
+    {
+        fprintf(stderr, log_formats[record->id], record->args[0], record->args[1]);
+    }
+    else
+    {
+        fprintf(stderr, "Unknown message %u", (unsigned int)record->id);
+    }
+    fputc('\n', stderr);
+}
+
+/*******************************************************************************
+ * Function Name: main
+ *******************************************************************************
+ * Summary:
+ *   Decodes the input stream until end of file and prints the summary.
+ *
+ * Parameters:
+ *   argc: number of arguments
+ *   argv: arguments
+ *
+ * Return:
+ *   0 if no corrupted frames were seen, 1 otherwise, 2 on usage errors
+ ******************************************************************************/
+int main(int argc, char *argv[])
+{
+    bool quiet = false;
+    const char *path = NULL;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "-q") == 0)
+        {
+            quiet = true;
+        }
+        else if (path == NULL)
+        {
+            path = argv[i];
+        }
+        else
+        {
+            fprintf(stderr, "usage: %s [-q] [file|device]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    FILE *in = (path != NULL) ? fopen(path, "rb") : stdin;
+    if (in == NULL)
+    {
+        perror(path);
+        return 2;
+    }
+
+    static uint8_t chunk[READ_CHUNK_SIZE];
+    pasco2_telemetry_decoder_t decoder;
+    pasco2_telemetry_decoder_init(&decoder, print_sample, print_log, quiet ? NULL : stdout);
+
+    if (!quiet)
+    {
+        printf("sequence,sensor,tick_ms,ppm,pressure_hpa,temperature_c,status,flags\n");
+    }
+
+    struct timespec start;
+    struct timespec end;
+    unsigned long long total = 0U;
+    size_t size;
+
+    (void)clock_gettime(CLOCK_MONOTONIC, &start);
+    while ((size = fread(chunk, 1U, sizeof(chunk), in)) > 0U)
+    {
+        pasco2_telemetry_decoder_feed(&decoder, chunk, size);
+        total += size;
+    }
+    (void)clock_gettime(CLOCK_MONOTONIC, &end);
+
+    if (in != stdin)
+    {
+        (void)fclose(in);
+    }
+
+    double seconds = (double)(end.tv_sec - start.tv_sec) + ((double)(end.tv_nsec - start.tv_nsec) / 1e9);
+    fprintf(stderr, "bytes %llu, frames %lu, log frames %lu, crc errors %lu, framing errors %lu, sequence gaps %lu\n",
+            total, (unsigned long)decoder.stats.frames, (unsigned long)decoder.stats.log_frames,
+            (unsigned long)decoder.stats.crc_errors,
+            (unsigned long)decoder.stats.framing_errors, (unsigned long)decoder.stats.sequence_gaps);
+    if (seconds > 0.0)
+    {
+        fprintf(stderr, "decode time %.3f s, %.1f MB/s, %.0f frames/s\n",
+                seconds, ((double)total / 1e6) / seconds, (double)decoder.stats.frames / seconds);
+    }
+
+    return (decoder.stats.crc_errors == 0U) ? 0 : 1;
+}
+
+/* [] END OF FILE */